@@ -38,6 +38,7 @@
 
 #include "bboxcomputer.h"
 #include "discretizer.h"
+#include "meshkernels.h"
 #include <plantgl/scenegraph/geometry/boundingbox.h>
 #include <plantgl/pgl_scene.h>
 #include <plantgl/pgl_geometry.h>
@@ -80,6 +81,17 @@ using namespace std;
 	__bbox = BoundingBoxPtr(new BoundingBox(bbox)); \
   } \
 
+/* The bounds of the transformed points of an explicit model are tighter
+   and as fast to compute as the transformed bounding box. */
+#define GEOM_BBOXCOMPUTER_TRANSFORM_EXPLICIT(geom,matrix) \
+  ExplicitModelPtr _explicitChild = dynamic_pointer_cast<ExplicitModel>(geom->getGeometry()); \
+  if (_explicitChild && _explicitChild->getPointList()) { \
+    pair<Vector3,Vector3> _bounds = transformed_points_bounds(_explicitChild->getPointList(),matrix); \
+    __bbox = BoundingBoxPtr(new BoundingBox(_bounds.first,_bounds.second)); \
+    GEOM_BBOXCOMPUTER_UPDATE_CACHE(geom); \
+    return true; \
+  } \
+
 #define GEOM_BBOXCOMPUTER_DISCRETIZE(geom) \
   GEOM_ASSERT(geom); \
   GEOM_BBOXCOMPUTER_CHECK_CACHE(geom); \
@@ -129,6 +141,11 @@ void BBoxComputer::clear( ) {
   __cache.clear();
 }
 
+void BBoxComputer::retain( const pgl_hash_set_size_t& ids ) {
+  __bbox = BoundingBoxPtr();
+  __cache.retain(ids);
+}
+
 BBoxComputer::~BBoxComputer( ) {
 }
 
@@ -177,7 +194,7 @@ bool BBoxComputer::process( AmapSymbol * amapSymbol ) {
   GEOM_BBOXCOMPUTER_CHECK_CACHE(amapSymbol);
 
   const Point3ArrayPtr& _pointList = amapSymbol->getPointList();
-  std::pair<Vector3,Vector3> _bounds = _pointList->getBounds();
+  std::pair<Vector3,Vector3> _bounds = points_bounds(_pointList);
   __bbox = BoundingBoxPtr(new BoundingBox(_bounds.first,_bounds.second));
   GEOM_ASSERT(__bbox);
 
@@ -240,15 +257,17 @@ bool BBoxComputer::process( AxisRotated * axisRotated ) {
 
   GEOM_BBOXCOMPUTER_CHECK_CACHE(axisRotated);
 
-  // We compute the bounding box of the children Geometry
-  axisRotated->getGeometry()->apply(*this);
-  if(!__bbox) return false;
-
   // We retrieve the matrix transformation attached to axisRotated
   OrthonormalBasis3DPtr _transformation =  axisRotated->getOrthonormalBasis();
   GEOM_ASSERT(_transformation);
   Matrix3 _matrix = _transformation->getMatrix3();
 
+  GEOM_BBOXCOMPUTER_TRANSFORM_EXPLICIT(axisRotated,_matrix);
+
+  // We compute the bounding box of the children Geometry
+  axisRotated->getGeometry()->apply(*this);
+  if(!__bbox) return false;
+
   // We transform the computed bounding box
   GEOM_BBOXCOMPUTER_TRANSFORM_BBOX(_matrix);
 
@@ -360,15 +379,17 @@ bool BBoxComputer::process( EulerRotated * eulerRotated ) {
 
   GEOM_BBOXCOMPUTER_CHECK_CACHE(eulerRotated);
 
-  // We compute the bounding box of the children Geometry
-  eulerRotated->getGeometry()->apply(*this);
-  if(!__bbox)return false;
-
   // We retrieve the matrix transformation attached to axisRotated
   OrthonormalBasis3DPtr _transformation =  eulerRotated->getOrthonormalBasis();
   GEOM_ASSERT(_transformation);
   Matrix3 _matrix = _transformation->getMatrix3();
 
+  GEOM_BBOXCOMPUTER_TRANSFORM_EXPLICIT(eulerRotated,_matrix);
+
+  // We compute the bounding box of the children Geometry
+  eulerRotated->getGeometry()->apply(*this);
+  if(!__bbox)return false;
+
   // We transform the computed bounding box
   GEOM_BBOXCOMPUTER_TRANSFORM_BBOX(_matrix);
 
@@ -395,7 +416,7 @@ bool BBoxComputer::process( FaceSet * faceSet ) {
   GEOM_BBOXCOMPUTER_CHECK_CACHE(faceSet);
 
   const Point3ArrayPtr& _pointList = faceSet->getPointList();
-  pair<Vector3,Vector3> _bounds = _pointList->getBounds();
+  pair<Vector3,Vector3> _bounds = points_bounds(_pointList);
   __bbox = BoundingBoxPtr(new BoundingBox(_bounds.first,_bounds.second));
   GEOM_ASSERT(__bbox);
 
@@ -538,15 +559,17 @@ bool BBoxComputer::process( Oriented * oriented ) {
 
   GEOM_BBOXCOMPUTER_CHECK_CACHE(oriented);
 
-  // We compute the bounding box of the children Geometry
-  oriented->getGeometry()->apply(*this);
-  if(!__bbox) return false;
-	
   // We retrieve the matrix transformation attached to axisRotated
   Matrix4TransformationPtr _transformation = dynamic_pointer_cast<Matrix4Transformation>(oriented->getTransformation());
   GEOM_ASSERT(_transformation);
   Matrix4 _matrix = _transformation->getMatrix();
 
+  GEOM_BBOXCOMPUTER_TRANSFORM_EXPLICIT(oriented,_matrix);
+
+  // We compute the bounding box of the children Geometry
+  oriented->getGeometry()->apply(*this);
+  if(!__bbox) return false;
+	
   // We transform the computed bounding box
   GEOM_BBOXCOMPUTER_TRANSFORM_BBOX(_matrix);
 
@@ -586,7 +609,7 @@ bool BBoxComputer::process( PointSet * pointSet ) {
 
   const Point3ArrayPtr& _pointList = pointSet->getPointList();
   if (!_pointList) return false;
-  pair<Vector3,Vector3> _bounds = _pointList->getBounds();
+  pair<Vector3,Vector3> _bounds = points_bounds(_pointList);
   __bbox = BoundingBoxPtr(new BoundingBox(_bounds.first,_bounds.second));
   GEOM_ASSERT(__bbox);
 
@@ -605,7 +628,7 @@ bool BBoxComputer::process( Polyline * polyline ) {
   GEOM_BBOXCOMPUTER_CHECK_CACHE(polyline);
 
   const Point3ArrayPtr& _pointList = polyline->getPointList();
-  pair<Vector3,Vector3> _bounds = _pointList->getBounds();
+  pair<Vector3,Vector3> _bounds = points_bounds(_pointList);
   __bbox = BoundingBoxPtr(new BoundingBox(_bounds.first,_bounds.second));
   GEOM_ASSERT(__bbox);
 
@@ -706,7 +729,7 @@ bool BBoxComputer::process( QuadSet * quadSet ) {
   GEOM_BBOXCOMPUTER_CHECK_CACHE(quadSet);
 
   const Point3ArrayPtr& _pointList = quadSet->getPointList();
-  pair<Vector3,Vector3> _bounds = _pointList->getBounds();
+  pair<Vector3,Vector3> _bounds = points_bounds(_pointList);
   __bbox = BoundingBoxPtr(new BoundingBox(_bounds.first,_bounds.second));
   GEOM_ASSERT(__bbox);
 
@@ -790,7 +813,7 @@ bool BBoxComputer::process( Tapered * tapered ) {
   // We transform the points of the discretization
   Point3ArrayPtr _tPointList = _taper->transform(_explicit->getPointList());
 
-  pair<Vector3,Vector3> _bounds = _tPointList->getBounds();
+  pair<Vector3,Vector3> _bounds = points_bounds(_tPointList);
   __bbox = BoundingBoxPtr(new BoundingBox(_bounds.first,_bounds.second));
   GEOM_ASSERT(__bbox);
 
@@ -832,7 +855,7 @@ bool BBoxComputer::process( TriangleSet * triangleSet ) {
   GEOM_BBOXCOMPUTER_CHECK_CACHE(triangleSet);
 
   const Point3ArrayPtr& _pointList = triangleSet->getPointList();
-  pair<Vector3,Vector3> _bounds = _pointList->getBounds();
+  pair<Vector3,Vector3> _bounds = points_bounds(_pointList);
   __bbox = BoundingBoxPtr(new BoundingBox(_bounds.first,_bounds.second));
   GEOM_ASSERT(__bbox);
 
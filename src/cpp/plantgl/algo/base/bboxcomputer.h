@@ -45,6 +45,7 @@
 #include <plantgl/scenegraph/core/action.h>
 #include <plantgl/tool/rcobject.h>
 #include <plantgl/tool/util_cache.h>
+#include <plantgl/tool/util_hashset.h>
 #ifndef GEOM_FWDEF
 #include <plantgl/scenegraph/scene/scene.h>
 #include <plantgl/scenegraph/geometry/boundingbox.h>
@@ -86,6 +87,9 @@ public:
   /// Clears \e self.
   void clear( );
 
+  /// Removes from the cache the results of the objects whose id is not in \e ids.
+  void retain( const pgl_hash_set_size_t& ids );
+
   /** Returns the resulting bounding box when applying \e self for the
       last time. */
   BoundingBoxPtr getBoundingBox( );
@@ -137,6 +137,11 @@ void Discretizer::clear( ) {
   __cache.clear();
 }
 
+void Discretizer::retain( const pgl_hash_set_size_t& ids ) {
+  __discretization = ExplicitModelPtr();
+  __cache.retain(ids);
+}
+
 /* ----------------------------------------------------------------------- */
 
 bool Discretizer::process(Shape * Shape){
@@ -47,6 +47,7 @@
 #include <plantgl/scenegraph/geometry/explicitmodel.h>
 #include <plantgl/tool/rcobject.h>
 #include <plantgl/tool/util_cache.h>
+#include <plantgl/tool/util_hashset.h>
 
 #ifndef GEOM_FWDEF
 #include <plantgl/scenegraph/container/pointarray.h>
@@ -87,6 +88,9 @@ public:
   /// Clears \e self.
   void clear( );
 
+  /// Removes from the cache the results of the objects whose id is not in \e ids.
+  void retain( const pgl_hash_set_size_t& ids );
+
   /// Returns the last computed discretized  geomety when applying \e self.
   inline const ExplicitModelPtr& getDiscretization( ) const { return __discretization; }
 
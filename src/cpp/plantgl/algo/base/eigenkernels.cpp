@@ -0,0 +1,368 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *  ----------------------------------------------------------------------------
+ */
+
+#include "eigenkernels.h"
+#include <plantgl/tool/util_parallel.h>
+#include <plantgl/math/util_math.h>
+#include <algorithm>
+#include <cmath>
+
+PGL_USING_NAMESPACE
+TOOLS_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+// Number of matrices whose eigenvalues are computed at once.
+#define BLOCK_SIZE 64
+
+// Minimal number of matrices or groups processed by a thread.
+#define PARALLEL_GRAIN 256
+
+/* ----------------------------------------------------------------------- */
+
+struct DVector3 {
+    double x, y, z;
+    DVector3(double _x = 0, double _y = 0, double _z = 0) : x(_x), y(_y), z(_z) { }
+};
+
+inline double dot(const DVector3& a, const DVector3& b) { return a.x*b.x + a.y*b.y + a.z*b.z; }
+
+inline DVector3 cross(const DVector3& a, const DVector3& b) 
+{ return DVector3(a.y*b.z - a.z*b.y, a.z*b.x - a.x*b.z, a.x*b.y - a.y*b.x); }
+
+inline DVector3 scaled(const DVector3& a, double s) { return DVector3(a.x*s, a.y*s, a.z*s); }
+
+inline DVector3 product(const SymmetricMatrix3& m, const DVector3& v) 
+{ return DVector3(m.xx*v.x + m.xy*v.y + m.xz*v.z, m.xy*v.x + m.yy*v.y + m.yz*v.z, m.xz*v.x + m.yz*v.y + m.zz*v.z); }
+
+inline Vector3 toVector3(const DVector3& v) { return Vector3(real_t(v.x),real_t(v.y),real_t(v.z)); }
+
+/* ----------------------------------------------------------------------- */
+
+/*
+   Eigenvalues of a block of matrices in SoA form.
+   Matrices are scaled by their largest coefficient, and the eigenvalues 
+   e0 <= e1 <= e2 of the scaled matrices are given by 
+   q + 2 p cos(acos(det(B)/2)/3 + 2 k pi / 3) with B = (A - q I) / p.
+*/
+struct EigenBlock {
+    double xx[BLOCK_SIZE], xy[BLOCK_SIZE], xz[BLOCK_SIZE], yy[BLOCK_SIZE], yz[BLOCK_SIZE], zz[BLOCK_SIZE];
+    double scale[BLOCK_SIZE];
+    double halfdet[BLOCK_SIZE];
+    double e0[BLOCK_SIZE], e1[BLOCK_SIZE], e2[BLOCK_SIZE];
+
+    void load(const SymmetricMatrix3 * m, size_t n) {
+        for(size_t i = 0; i < n; ++i){
+            xx[i] = m[i].xx; xy[i] = m[i].xy; xz[i] = m[i].xz;
+            yy[i] = m[i].yy; yz[i] = m[i].yz; zz[i] = m[i].zz;
+        }
+    }
+
+    void eigenvalues(size_t n) {
+        const double twothirdpi = 2.0943951023931954923;
+        for(size_t i = 0; i < n; ++i){
+            double maxabs = std::max(std::max(std::max(fabs(xx[i]),fabs(xy[i])),std::max(fabs(xz[i]),fabs(yy[i]))),
+                                     std::max(fabs(yz[i]),fabs(zz[i])));
+            double inv = (maxabs > 0 ? 1 / maxabs : 0);
+            double a00 = xx[i]*inv, a01 = xy[i]*inv, a02 = xz[i]*inv;
+            double a11 = yy[i]*inv, a12 = yz[i]*inv, a22 = zz[i]*inv;
+            double q = (a00 + a11 + a22) / 3;
+            double b00 = a00 - q, b11 = a11 - q, b22 = a22 - q;
+            double p = sqrt((b00*b00 + b11*b11 + b22*b22 + 2*(a01*a01 + a02*a02 + a12*a12)) / 6);
+            double invp = (p > 0 ? 1 / p : 0);
+            b00 *= invp; b11 *= invp; b22 *= invp;
+            double b01 = a01*invp, b02 = a02*invp, b12 = a12*invp;
+            double hd = (b00*(b11*b22 - b12*b12) - b01*(b01*b22 - b12*b02) + b02*(b01*b12 - b11*b02)) / 2;
+            hd = std::min(std::max(hd,-1.0),1.0);
+            double angle = acos(hd) / 3;
+            double beta2 = 2 * cos(angle);
+            double beta0 = 2 * cos(angle + twothirdpi);
+            double beta1 = -(beta0 + beta2);
+            e0[i] = q + p * beta0;
+            e1[i] = q + p * beta1;
+            e2[i] = q + p * beta2;
+            scale[i] = maxabs;
+            halfdet[i] = hd;
+        }
+    }
+};
+
+/* ----------------------------------------------------------------------- */
+
+// Eigenvector of the eigenvalue \e e of multiplicity 1, from the largest cross product of the rows of m - e I.
+static DVector3 eigenvector0(const SymmetricMatrix3& m, double e)
+{
+    DVector3 r0(m.xx - e, m.xy, m.xz), r1(m.xy, m.yy - e, m.yz), r2(m.xz, m.yz, m.zz - e);
+    DVector3 c01 = cross(r0,r1), c02 = cross(r0,r2), c12 = cross(r1,r2);
+    double d01 = dot(c01,c01), d02 = dot(c02,c02), d12 = dot(c12,c12);
+    if (d01 >= d02 && d01 >= d12) { if (d01 > 0) return scaled(c01, 1 / sqrt(d01)); }
+    else if (d02 >= d12) return scaled(c02, 1 / sqrt(d02));
+    else return scaled(c12, 1 / sqrt(d12));
+    return DVector3(1,0,0);
+}
+
+// Unit vectors u and v such that (u, v, w) is an orthonormal basis.
+static void orthogonal_complement(const DVector3& w, DVector3& u, DVector3& v)
+{
+    if (fabs(w.x) > fabs(w.y)) {
+        double inv = 1 / sqrt(w.x*w.x + w.z*w.z);
+        u = DVector3(-w.z*inv, 0, w.x*inv);
+    }
+    else {
+        double inv = 1 / sqrt(w.y*w.y + w.z*w.z);
+        u = DVector3(0, w.z*inv, -w.y*inv);
+    }
+    v = cross(w,u);
+}
+
+// Eigenvector of the eigenvalue \e e in the plane orthogonal to the eigenvector \e w.
+static DVector3 eigenvector1(const SymmetricMatrix3& m, const DVector3& w, double e)
+{
+    DVector3 u, v;
+    orthogonal_complement(w,u,v);
+    DVector3 mu = product(m,u), mv = product(m,v);
+    double m00 = dot(u,mu) - e, m01 = dot(u,mv), m11 = dot(v,mv) - e;
+    double a00 = fabs(m00), a01 = fabs(m01), a11 = fabs(m11);
+    if (a00 >= a11) {
+        if (std::max(a00,a01) > 0) {
+            if (a00 >= a01) { m01 /= m00; m00 = 1 / sqrt(1 + m01*m01); m01 *= m00; }
+            else { m00 /= m01; m01 = 1 / sqrt(1 + m00*m00); m00 *= m01; }
+            return DVector3(m01*u.x - m00*v.x, m01*u.y - m00*v.y, m01*u.z - m00*v.z);
+        }
+    }
+    else {
+        if (std::max(a11,a01) > 0) {
+            if (a11 >= a01) { m01 /= m11; m11 = 1 / sqrt(1 + m01*m01); m01 *= m11; }
+            else { m11 /= m01; m01 = 1 / sqrt(1 + m11*m11); m11 *= m01; }
+            return DVector3(m11*u.x - m01*v.x, m11*u.y - m01*v.y, m11*u.z - m01*v.z);
+        }
+    }
+    return u;
+}
+
+/* Eigenvectors of the matrix \e i of \e block, in decreasing order of the eigenvalues.
+   \e values receives the corresponding eigenvalues of the scaled matrix. */
+static void eigenvectors(const EigenBlock& block, size_t i, double * values, Vector3 * vectors)
+{
+    double inv = (block.scale[i] > 0 ? 1 / block.scale[i] : 0);
+    SymmetricMatrix3 m = { block.xx[i]*inv, block.xy[i]*inv, block.xz[i]*inv, 
+                           block.yy[i]*inv, block.yz[i]*inv, block.zz[i]*inv };
+    if (m.xy == 0 && m.xz == 0 && m.yz == 0) {
+        // Diagonal matrix: the axes sorted by decreasing values.
+        double d[3] = { m.xx, m.yy, m.zz };
+        int order[3] = { 0, 1, 2 };
+        if (d[order[0]] < d[order[1]]) std::swap(order[0],order[1]);
+        if (d[order[1]] < d[order[2]]) std::swap(order[1],order[2]);
+        if (d[order[0]] < d[order[1]]) std::swap(order[0],order[1]);
+        for(int j = 0; j < 3; ++j){
+            values[j] = d[order[j]];
+            vectors[j] = Vector3(0,0,0);
+            vectors[j][order[j]] = 1;
+        }
+        return;
+    }
+    DVector3 v0, v1, v2;
+    if (block.halfdet[i] >= 0) {
+        // The largest eigenvalue is the most isolated one.
+        v2 = eigenvector0(m,block.e2[i]);
+        v1 = eigenvector1(m,v2,block.e1[i]);
+        v0 = cross(v1,v2);
+    }
+    else {
+        v0 = eigenvector0(m,block.e0[i]);
+        v1 = eigenvector1(m,v0,block.e1[i]);
+        v2 = cross(v0,v1);
+    }
+    // Rayleigh quotients are more accurate than the trigonometric solution near repeated eigenvalues.
+    DVector3 v[3] = { v2, v1, v0 };
+    for(int j = 0; j < 3; ++j) values[j] = dot(v[j],product(m,v[j]));
+    if (values[0] < values[1]) { std::swap(values[0],values[1]); std::swap(v[0],v[1]); }
+    if (values[1] < values[2]) { std::swap(values[1],values[2]); std::swap(v[1],v[2]); }
+    if (values[0] < values[1]) { std::swap(values[0],values[1]); std::swap(v[0],v[1]); }
+    for(int j = 0; j < 3; ++j) vectors[j] = toVector3(v[j]);
+}
+
+// Eigen decomposition of \e n <= BLOCK_SIZE matrices.
+static void eigen_block(EigenBlock& block, size_t n, const SymmetricMatrix3 * m, double * values, Vector3 * vectors)
+{
+    block.load(m,n);
+    block.eigenvalues(n);
+    for(size_t i = 0; i < n; ++i){
+        double * v = values + 3*i;
+        if (vectors) eigenvectors(block,i,v,vectors+3*i);
+        else { v[0] = block.e2[i]; v[1] = block.e1[i]; v[2] = block.e0[i]; }
+        v[0] *= block.scale[i]; v[1] *= block.scale[i]; v[2] *= block.scale[i];
+    }
+}
+
+/* ----------------------------------------------------------------------- */
+
+void PGL(symmetric_eigen)(const SymmetricMatrix3& m, double * values, Vector3 * vectors)
+{
+    EigenBlock block;
+    eigen_block(block,1,&m,values,vectors);
+}
+
+void PGL(symmetric_eigen)(const Matrix3& m, Vector3& values, Vector3& v1, Vector3& v2, Vector3& v3)
+{
+    SymmetricMatrix3 sm = { m(0,0), (m(0,1)+m(1,0))/2, (m(0,2)+m(2,0))/2,
+                            m(1,1), (m(1,2)+m(2,1))/2, m(2,2) };
+    double dvalues[3];
+    Vector3 vectors[3];
+    symmetric_eigen(sm,dvalues,vectors);
+    values = Vector3(real_t(dvalues[0]),real_t(dvalues[1]),real_t(dvalues[2]));
+    v1 = vectors[0]; v2 = vectors[1]; v3 = vectors[2];
+}
+
+struct EigenBatchFunctor {
+    const SymmetricMatrix3 * m;
+    double * values;
+    Vector3 * vectors;
+
+    void operator()(size_t begin, size_t end, size_t) {
+        EigenBlock block;
+        for(size_t i = begin; i < end; i += BLOCK_SIZE){
+            size_t n = std::min<size_t>(BLOCK_SIZE, end - i);
+            eigen_block(block, n, m + i, values + 3*i, vectors ? vectors + 3*i : NULL);
+        }
+    }
+};
+
+void PGL(symmetric_eigen_batch)(size_t nb, const SymmetricMatrix3 * m, double * values, Vector3 * vectors)
+{
+    EigenBatchFunctor functor;
+    functor.m = m; functor.values = values; functor.vectors = vectors;
+    parallel_for(nb, functor, PARALLEL_GRAIN);
+}
+
+/* ----------------------------------------------------------------------- */
+
+static SymmetricMatrix3 centered_covariance(const Point3Array& points, const Index& group)
+{
+    SymmetricMatrix3 result = { 0, 0, 0, 0, 0, 0 };
+    if (group.empty()) return result;
+    double cx = 0, cy = 0, cz = 0;
+    for(Index::const_iterator it = group.begin(); it != group.end(); ++it){
+        const Vector3& p = points.getAt(*it);
+        cx += p.x(); cy += p.y(); cz += p.z();
+    }
+    double inv = 1.0 / group.size();
+    cx *= inv; cy *= inv; cz *= inv;
+    for(Index::const_iterator it = group.begin(); it != group.end(); ++it){
+        const Vector3& p = points.getAt(*it);
+        double dx = p.x() - cx, dy = p.y() - cy, dz = p.z() - cz;
+        result.xx += dx*dx; result.xy += dx*dy; result.xz += dx*dz;
+        result.yy += dy*dy; result.yz += dy*dz; result.zz += dz*dz;
+    }
+    result.xx *= inv; result.xy *= inv; result.xz *= inv;
+    result.yy *= inv; result.yz *= inv; result.zz *= inv;
+    return result;
+}
+
+SymmetricMatrix3 PGL(pointset_centered_covariance)(const Point3ArrayPtr& points, const Index& group)
+{
+    return centered_covariance(*points,group);
+}
+
+Vector3 PGL(covariance_features)(const double * values)
+{
+    double l1 = std::max(values[0],0.0), l2 = std::max(values[1],0.0), l3 = std::max(values[2],0.0);
+    if (l1 <= 0) return Vector3(0,0,0);
+    return Vector3(real_t((l1-l2)/l1), real_t((l2-l3)/l1), real_t(l3/l1));
+}
+
+/* ----------------------------------------------------------------------- */
+
+struct PrincipalAxesFunctor {
+    const Point3Array * points;
+    const IndexArray * groups;
+    size_t offset;
+    Point3Array * eigenvalues;
+    Point3Array * majoraxes;
+    Point3Array * minoraxes;
+    Point3Array * features;
+
+    void operator()(size_t begin, size_t end, size_t) {
+        EigenBlock block;
+        SymmetricMatrix3 m[BLOCK_SIZE];
+        double values[3*BLOCK_SIZE];
+        Vector3 vectors[3*BLOCK_SIZE];
+        bool withvectors = majoraxes || minoraxes;
+        begin += offset; end += offset;
+        for(size_t i = begin; i < end; i += BLOCK_SIZE){
+            size_t n = std::min<size_t>(BLOCK_SIZE, end - i);
+            for(size_t j = 0; j < n; ++j)
+                m[j] = centered_covariance(*points, groups->getAt(i+j));
+            eigen_block(block, n, m, values, withvectors ? vectors : NULL);
+            for(size_t j = 0; j < n; ++j){
+                if (groups->getAt(i+j).empty()) continue; // Outputs are left null.
+                if (eigenvalues) eigenvalues->setAt(i+j,Vector3(real_t(values[3*j]),real_t(values[3*j+1]),real_t(values[3*j+2])));
+                if (majoraxes) majoraxes->setAt(i+j,vectors[3*j]);
+                if (minoraxes) minoraxes->setAt(i+j,vectors[3*j+2]);
+                if (features) features->setAt(i+j,covariance_features(values+3*j));
+            }
+        }
+    }
+};
+
+void PGL(pointsets_principal_axes)(const Point3ArrayPtr& points, const IndexArrayPtr& groups,
+                                   Point3ArrayPtr * eigenvalues, Point3ArrayPtr * majoraxes, 
+                                   Point3ArrayPtr * minoraxes, Point3ArrayPtr * features)
+{
+    size_t nbgroups = groups->size();
+    if (eigenvalues) *eigenvalues = Point3ArrayPtr(new Point3Array(nbgroups));
+    if (majoraxes) *majoraxes = Point3ArrayPtr(new Point3Array(nbgroups));
+    if (minoraxes) *minoraxes = Point3ArrayPtr(new Point3Array(nbgroups));
+    if (features) *features = Point3ArrayPtr(new Point3Array(nbgroups));
+    pointsets_principal_axes(points, groups, 0, nbgroups,
+                             eigenvalues ? eigenvalues->get() : NULL, majoraxes ? majoraxes->get() : NULL,
+                             minoraxes ? minoraxes->get() : NULL, features ? features->get() : NULL);
+}
+
+void PGL(pointsets_principal_axes)(const Point3ArrayPtr& points, const IndexArrayPtr& groups,
+                                   size_t begin, size_t end,
+                                   Point3Array * eigenvalues, Point3Array * majoraxes, 
+                                   Point3Array * minoraxes, Point3Array * features)
+{
+    if (end <= begin) return;
+    PrincipalAxesFunctor functor;
+    functor.points = points.get();
+    functor.groups = groups.get();
+    functor.offset = begin;
+    functor.eigenvalues = eigenvalues;
+    functor.majoraxes = majoraxes;
+    functor.minoraxes = minoraxes;
+    functor.features = features;
+    parallel_for(end - begin, functor, PARALLEL_GRAIN);
+}
+
+/* ----------------------------------------------------------------------- */
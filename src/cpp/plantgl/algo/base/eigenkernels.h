@@ -0,0 +1,95 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *  ----------------------------------------------------------------------------
+ */
+
+/*! \file eigenkernels.h
+    \brief Eigen decomposition of symmetric 3x3 matrices, by batches, and its use on point neighborhoods.
+
+    Eigenvalues are given by the trigonometric solution of the characteristic
+    polynomial, computed without branches on blocks of matrices stored in SoA form.
+    Eigenvectors are then derived from the rows of A - lambda I with the
+    non-iterative scheme of D. Eberly, which remains robust for repeated eigenvalues.
+*/
+
+#ifndef __eigenkernels_h__
+#define __eigenkernels_h__
+
+#include "../algo_config.h"
+#include <plantgl/scenegraph/container/pointarray.h>
+#include <plantgl/scenegraph/container/indexarray.h>
+#include <plantgl/math/util_vector.h>
+#include <plantgl/math/util_matrix.h>
+
+PGL_BEGIN_NAMESPACE
+
+/// A symmetric 3x3 matrix given by its upper coefficients.
+struct ALGO_API SymmetricMatrix3 {
+    double xx, xy, xz, yy, yz, zz;
+};
+
+/** Compute the eigenvalues of \e m in decreasing order and, if \e vectors is not null,
+    the corresponding unit eigenvectors. */
+ALGO_API void symmetric_eigen(const SymmetricMatrix3& m, double * values, TOOLS(Vector3) * vectors = NULL);
+
+/// Compute the eigen decomposition of the symmetric part of \e m. Eigenvalues are sorted in decreasing order.
+ALGO_API void symmetric_eigen(const TOOLS(Matrix3)& m, TOOLS(Vector3)& values, 
+                              TOOLS(Vector3)& v1, TOOLS(Vector3)& v2, TOOLS(Vector3)& v3);
+
+/** Compute the eigen decomposition of the \e nb matrices \e m. \e values receives 3 eigenvalues
+    per matrix in decreasing order and \e vectors, if not null, the 3 corresponding eigenvectors. */
+ALGO_API void symmetric_eigen_batch(size_t nb, const SymmetricMatrix3 * m, double * values, TOOLS(Vector3) * vectors = NULL);
+
+/// Compute the covariance of the points \e group of \e points around their centroid.
+ALGO_API SymmetricMatrix3 pointset_centered_covariance(const Point3ArrayPtr& points, const Index& group);
+
+/** Compute the shape features (linearity, planarity, sphericity) of a neighborhood 
+    from the eigenvalues l1 >= l2 >= l3 of its covariance, i.e. 
+    ((l1-l2)/l1, (l2-l3)/l1, l3/l1). They are null if l1 is null. */
+ALGO_API TOOLS(Vector3) covariance_features(const double * values);
+
+/** Compute in parallel the eigen decomposition of the centered covariance of each of the \e groups of \e points.
+    For each group, \e eigenvalues receives the eigenvalues in decreasing order, \e majoraxes and \e minoraxes
+    the eigenvectors of the largest and smallest eigenvalues, and \e features the shape features.
+    Any of the outputs may be null. */
+ALGO_API void pointsets_principal_axes(const Point3ArrayPtr& points, const IndexArrayPtr& groups,
+                                       Point3ArrayPtr * eigenvalues, Point3ArrayPtr * majoraxes, 
+                                       Point3ArrayPtr * minoraxes, Point3ArrayPtr * features = NULL);
+
+/** Same as above for the groups [\e begin, \e end[ only. The outputs which are not null
+    must already have an entry for each group. */
+ALGO_API void pointsets_principal_axes(const Point3ArrayPtr& points, const IndexArrayPtr& groups,
+                                       size_t begin, size_t end,
+                                       Point3Array * eigenvalues, Point3Array * majoraxes, 
+                                       Point3Array * minoraxes, Point3Array * features = NULL);
+
+PGL_END_NAMESPACE
+
+#endif
@@ -0,0 +1,367 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *  ----------------------------------------------------------------------------
+ */
+
+#include "kmeansclustering.h"
+#include "pointkdtree.h"
+#include <plantgl/tool/util_parallel.h>
+#include <plantgl/tool/errormsg.h>
+
+PGL_USING_NAMESPACE
+TOOLS_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+// Minimal number of points processed by a thread.
+#define PARALLEL_GRAIN 1024
+
+// Up to this number of centroids, they are searched without kd-tree.
+#define BRUTE_FORCE_SIZE 32
+
+/* ----------------------------------------------------------------------- */
+
+// Find the closest centroid c of p and the distances d1 to it and d2 to the second closest one.
+static void two_closest_centroids(const Point3Array& centroids, const PointKDTree * index, const Vector3& p,
+                                  std::vector<DistancePoint>& heap, uint32_t& c, real_t& d1, real_t& d2)
+{
+    if (index) {
+        index->k_closest(p, 2, AllPointFilter(), heap);
+        c = heap[0].second;
+        d1 = sqrt(heap[0].first);
+        d2 = (heap.size() > 1 ? sqrt(heap[1].first) : REAL_MAX);
+        return;
+    }
+    real_t best = REAL_MAX, second = REAL_MAX;
+    c = 0;
+    uint32_t cid = 0;
+    for (Point3Array::const_iterator it = centroids.begin(); it != centroids.end(); ++it, ++cid){
+        real_t d = squared_distance(*it, p);
+        if (d < best) { second = best; best = d; c = cid; }
+        else if (d < second) second = d;
+    }
+    d1 = sqrt(best);
+    d2 = (second == REAL_MAX ? REAL_MAX : sqrt(second));
+}
+
+struct SeparationFunctor {
+    const Point3Array * centroids;
+    const PointKDTree * index;
+    real_t * separations;
+
+    void operator()(size_t begin, size_t end, size_t) {
+        std::vector<DistancePoint> heap;
+        OtherPointFilter filter;
+        for (size_t cid = begin; cid < end; ++cid){
+            filter.pid = cid;
+            index->k_closest(centroids->getAt(cid), 1, filter, heap);
+            separations[cid] = (heap.empty() ? REAL_MAX : sqrt(heap[0].first) / 2);
+        }
+    }
+};
+
+struct AssignFunctor {
+    const Point3Array * points;
+    const Point3Array * centroids;
+    const PointKDTree * index;
+    const real_t * separations;
+    const real_t * moves;
+    real_t maxmove;
+    real_t secondmove;
+    uint32_t maxmoved;
+    bool bounded;
+    uint32_t * assignments;
+    real_t * upper;
+    real_t * lower;
+    std::vector<std::vector<std::pair<uint32_t,uint32_t> > > * changes;
+
+    void operator()(size_t begin, size_t end, size_t chunk) {
+        std::vector<DistancePoint> heap;
+        heap.reserve(2);
+        std::vector<std::pair<uint32_t,uint32_t> >& chunkchanges = (*changes)[chunk];
+        chunkchanges.clear();
+        uint32_t c;
+        real_t d1, d2;
+        for (size_t pid = begin; pid < end; ++pid){
+            const Vector3& p = points->getAt(pid);
+            if (!bounded) {
+                two_closest_centroids(*centroids, index, p, heap, c, d1, d2);
+                assignments[pid] = c;
+                upper[pid] = d1;
+                lower[pid] = d2;
+                continue;
+            }
+            uint32_t a = assignments[pid];
+            real_t u = upper[pid] + moves[a];
+            real_t l = lower[pid] - (a == maxmoved ? secondmove : maxmove);
+            real_t m = std::max(separations[a], l);
+            if (u > m) {
+                // tighten the upper bound before searching
+                u = sqrt(squared_distance(centroids->getAt(a), p));
+                if (u > m) {
+                    two_closest_centroids(*centroids, index, p, heap, c, d1, d2);
+                    if (c != a && d1 < u) {
+                        chunkchanges.push_back(std::pair<uint32_t,uint32_t>(pid, a));
+                        assignments[pid] = c;
+                        u = d1;
+                        l = d2;
+                    }
+                    else l = (c == a ? d2 : d1);
+                }
+            }
+            upper[pid] = u;
+            lower[pid] = l;
+        }
+    }
+};
+
+/* ----------------------------------------------------------------------- */
+
+KMeansClustering::KMeansClustering(uint32_t maxIterations, real_t tolerance):
+    __maxIterations(maxIterations),
+    __tolerance(tolerance),
+    __index(NULL),
+    __iterations(0),
+    __changed(0)
+{ }
+
+KMeansClustering::~KMeansClustering()
+{
+    clear();
+}
+
+void KMeansClustering::clear()
+{
+    if (__index) { delete __index; __index = NULL; }
+    __points = Point3ArrayPtr();
+    __centroids = Point3ArrayPtr();
+    std::vector<uint32_t>().swap(__assignments);
+    std::vector<real_t>().swap(__upper);
+    std::vector<real_t>().swap(__lower);
+    std::vector<std::vector<std::pair<uint32_t,uint32_t> > >().swap(__changes);
+    std::vector<double>().swap(__sums);
+    std::vector<uint32_t>().swap(__counts);
+    std::vector<real_t>().swap(__separations);
+    std::vector<real_t>().swap(__moves);
+    __iterations = 0;
+    __changed = 0;
+}
+
+bool KMeansClustering::assign(const Point3ArrayPtr& points, const Point3ArrayPtr& centroids)
+{
+    if (!centroids || centroids->empty()) {
+        pglError("KMeansClustering : no centroid given.");
+        return false;
+    }
+    // the centroids are copied in the same array from one call to the other to reuse the index over them
+    if (!__centroids) __centroids = Point3ArrayPtr(new Point3Array(*centroids));
+    else *__centroids = *centroids;
+    __points = (points ? points : Point3ArrayPtr(new Point3Array()));
+
+    size_t nbpoints = __points->size();
+    size_t nbcentroids = __centroids->size();
+    __assignments.resize(nbpoints);
+    __upper.resize(nbpoints);
+    __lower.resize(nbpoints);
+    __moves.assign(nbcentroids, 0);
+
+    updateIndex(false);
+    assignPoints(false);
+    computeSums();
+    __iterations = 1;
+    __changed = nbpoints;
+    return true;
+}
+
+bool KMeansClustering::process(const Point3ArrayPtr& points, const Point3ArrayPtr& centroids)
+{
+    if (!assign(points, centroids)) return false;
+    while (__iterations < __maxIterations && __changed > 0) {
+        real_t maxmove = updateCentroids();
+        updateIndex(true);
+        assignPoints(true);
+        applyChanges();
+        ++__iterations;
+        if (maxmove <= __tolerance) break;
+    }
+    return true;
+}
+
+uint32_t KMeansClustering::iterate()
+{
+    if (!__centroids || !__points) return 0;
+    updateCentroids();
+    updateIndex(true);
+    assignPoints(true);
+    applyChanges();
+    ++__iterations;
+    return __changed;
+}
+
+/* ----------------------------------------------------------------------- */
+
+void KMeansClustering::updateIndex(bool separations)
+{
+    size_t nbcentroids = __centroids->size();
+    if (nbcentroids > BRUTE_FORCE_SIZE) {
+        // the tree refers to the centroids, which are modified in place
+        if (__index) __index->rebuild();
+        else __index = new PointKDTree(*__centroids);
+    }
+    if (!separations) return;
+
+    __separations.resize(nbcentroids);
+    if (__index) {
+        SeparationFunctor functor;
+        functor.centroids = __centroids.get();
+        functor.index = __index;
+        functor.separations = &__separations[0];
+        parallel_for(nbcentroids, functor, PARALLEL_GRAIN / 8);
+    }
+    else {
+        std::fill(__separations.begin(), __separations.end(), REAL_MAX);
+        for (size_t i = 0; i < nbcentroids; ++i)
+            for (size_t j = i + 1; j < nbcentroids; ++j){
+                real_t d = norm(__centroids->getAt(i) - __centroids->getAt(j)) / 2;
+                if (d < __separations[i]) __separations[i] = d;
+                if (d < __separations[j]) __separations[j] = d;
+            }
+    }
+}
+
+void KMeansClustering::assignPoints(bool bounded)
+{
+    size_t nbpoints = __points->size();
+    if (nbpoints == 0) { __changed = 0; return; }
+
+    AssignFunctor functor;
+    functor.points = __points.get();
+    functor.centroids = __centroids.get();
+    functor.index = __index;
+    functor.bounded = bounded;
+    functor.assignments = &__assignments[0];
+    functor.upper = &__upper[0];
+    functor.lower = &__lower[0];
+    functor.changes = &__changes;
+    __changes.resize(parallel_chunk_count(nbpoints, PARALLEL_GRAIN));
+
+    if (bounded) {
+        // the lower bounds decrease of the largest move of the other centroids
+        functor.separations = &__separations[0];
+        functor.moves = &__moves[0];
+        functor.maxmove = functor.secondmove = 0;
+        functor.maxmoved = UINT32_MAX;
+        for (uint32_t cid = 0; cid < __moves.size(); ++cid){
+            if (__moves[cid] > functor.maxmove) {
+                functor.secondmove = functor.maxmove;
+                functor.maxmove = __moves[cid];
+                functor.maxmoved = cid;
+            }
+            else if (__moves[cid] > functor.secondmove) functor.secondmove = __moves[cid];
+        }
+    }
+    parallel_for(nbpoints, functor, PARALLEL_GRAIN);
+}
+
+void KMeansClustering::computeSums()
+{
+    size_t nbcentroids = __centroids->size();
+    __sums.assign(3 * nbcentroids, 0);
+    __counts.assign(nbcentroids, 0);
+    uint32_t pid = 0;
+    for (Point3Array::const_iterator it = __points->begin(); it != __points->end(); ++it, ++pid){
+        uint32_t cid = __assignments[pid];
+        double * sum = &__sums[3 * cid];
+        sum[0] += it->x(); sum[1] += it->y(); sum[2] += it->z();
+        ++__counts[cid];
+    }
+}
+
+// Move the points that changed of cluster in the sums, in the order of the points.
+void KMeansClustering::applyChanges()
+{
+    __changed = 0;
+    for (size_t chunk = 0; chunk < __changes.size(); ++chunk){
+        const std::vector<std::pair<uint32_t,uint32_t> >& chunkchanges = __changes[chunk];
+        for (std::vector<std::pair<uint32_t,uint32_t> >::const_iterator it = chunkchanges.begin(); it != chunkchanges.end(); ++it){
+            const Vector3& p = __points->getAt(it->first);
+            double * previous = &__sums[3 * it->second];
+            double * next = &__sums[3 * __assignments[it->first]];
+            previous[0] -= p.x(); previous[1] -= p.y(); previous[2] -= p.z();
+            next[0] += p.x(); next[1] += p.y(); next[2] += p.z();
+            --__counts[it->second];
+            ++__counts[__assignments[it->first]];
+        }
+        __changed += chunkchanges.size();
+    }
+}
+
+// Move the centroids to the mean of their points and return the largest move.
+real_t KMeansClustering::updateCentroids()
+{
+    real_t maxmove = 0;
+    for (uint32_t cid = 0; cid < __centroids->size(); ++cid){
+        if (__counts[cid] == 0) { __moves[cid] = 0; continue; }
+        const double * sum = &__sums[3 * cid];
+        Vector3 centroid(sum[0] / __counts[cid], sum[1] / __counts[cid], sum[2] / __counts[cid]);
+        __moves[cid] = norm(centroid - __centroids->getAt(cid));
+        if (__moves[cid] > maxmove) maxmove = __moves[cid];
+        __centroids->setAt(cid, centroid);
+    }
+    return maxmove;
+}
+
+/* ----------------------------------------------------------------------- */
+
+Point3ArrayPtr KMeansClustering::getCentroids() const
+{
+    return Point3ArrayPtr(__centroids ? new Point3Array(*__centroids) : new Point3Array());
+}
+
+Uint32Array1Ptr KMeansClustering::getAssignments() const
+{
+    return Uint32Array1Ptr(new Uint32Array1(__assignments.begin(), __assignments.end()));
+}
+
+IndexArrayPtr KMeansClustering::getClusters() const
+{
+    size_t nbcentroids = (__centroids ? __centroids->size() : 0);
+    IndexArrayPtr result(new IndexArray(nbcentroids));
+    for (uint32_t cid = 0; cid < nbcentroids; ++cid) result->getAt(cid).reserve(__counts[cid]);
+    for (uint32_t pid = 0; pid < __assignments.size(); ++pid) result->getAt(__assignments[pid]).push_back(pid);
+    return result;
+}
+
+Uint32Array1Ptr KMeansClustering::getClusterSizes() const
+{
+    return Uint32Array1Ptr(new Uint32Array1(__counts.begin(), __counts.end()));
+}
+
+/* ----------------------------------------------------------------------- */
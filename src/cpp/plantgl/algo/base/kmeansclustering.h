@@ -0,0 +1,151 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *  ----------------------------------------------------------------------------
+ */
+
+/*! \file kmeansclustering.h
+    \brief Clustering of points by k-means with bounds on the distances to the centroids.
+*/
+
+#ifndef __kmeansclustering_h__
+#define __kmeansclustering_h__
+
+#include "../algo_config.h"
+#include <plantgl/scenegraph/container/pointarray.h>
+#include <plantgl/scenegraph/container/indexarray.h>
+#include <plantgl/tool/util_array.h>
+#include <vector>
+
+PGL_BEGIN_NAMESPACE
+
+struct PointKDTree;
+
+/* ----------------------------------------------------------------------- */
+
+/**
+    \class KMeansClustering
+    \brief Assign points to their closest centroid and iterate the k-means (Lloyd) algorithm.
+
+    Each point keeps an upper bound of the distance to its centroid and a lower bound of
+    the distance to the other ones (Hamerly 10). The bounds are updated with the moves of
+    the centroids, and a point is searched again only when they overlap or when they are
+    closer than half the distance of its centroid to the closest other one (Elkan 03).
+    Searches use a kd-tree over the centroids, rebuilt in place at each iteration.
+    Points are processed in parallel and the sums of the clusters are updated from the
+    points that changed of cluster during the assignment.
+*/
+class ALGO_API KMeansClustering {
+public:
+
+    /// Constructor.
+    KMeansClustering(uint32_t maxIterations = 100, real_t tolerance = 0);
+
+    ~KMeansClustering();
+
+    /** Assign each point of \e points to its closest centroid of \e centroids. 
+        The centroids are not modified. Returns false if there is no centroid. */
+    bool assign(const Point3ArrayPtr& points, const Point3ArrayPtr& centroids);
+
+    /** Cluster \e points with the k-means algorithm from the initial \e centroids, which are not modified.
+        Iterations stop when no point changes of cluster, when the centroids move less than the 
+        tolerance or after the maximum number of iterations. Returns false if there is no centroid. */
+    bool process(const Point3ArrayPtr& points, const Point3ArrayPtr& centroids);
+
+    /** Do one more iteration of k-means from the current clustering.
+        Returns the number of points that changed of cluster. */
+    uint32_t iterate();
+
+    /// Free the buffers and the results.
+    void clear();
+
+    /// A copy of the centroids of the clusters. Empty clusters keep their previous centroid.
+    Point3ArrayPtr getCentroids() const;
+
+    /// The cluster of each point.
+    TOOLS(Uint32Array1Ptr) getAssignments() const;
+
+    /// The points of each cluster.
+    IndexArrayPtr getClusters() const;
+
+    /// The number of points of each cluster.
+    TOOLS(Uint32Array1Ptr) getClusterSizes() const;
+
+    /// The number of assignment passes done by the last process, including the first one.
+    inline uint32_t getIterationCount() const { return __iterations; }
+
+    /// The number of points that changed of cluster in the last pass.
+    inline uint32_t getChangedCount() const { return __changed; }
+
+    inline uint32_t getMaxIterations() const { return __maxIterations; }
+    inline void setMaxIterations(uint32_t value) { __maxIterations = value; }
+
+    inline real_t getTolerance() const { return __tolerance; }
+    inline void setTolerance(real_t value) { __tolerance = value; }
+
+protected:
+    void updateIndex(bool separations);
+    void assignPoints(bool bounded);
+    void computeSums();
+    void applyChanges();
+    real_t updateCentroids();
+
+    uint32_t __maxIterations;
+    real_t   __tolerance;
+
+    Point3ArrayPtr __points;
+    Point3ArrayPtr __centroids;
+
+    // cluster of each point, and bounds of its distances to its centroid and to the other ones
+    std::vector<uint32_t> __assignments;
+    std::vector<real_t> __upper;
+    std::vector<real_t> __lower;
+
+    // points that changed of cluster in the last pass, with their previous cluster, for each range of points
+    std::vector<std::vector<std::pair<uint32_t,uint32_t> > > __changes;
+
+    // coordinates sums and number of points of each cluster
+    std::vector<double> __sums;
+    std::vector<uint32_t> __counts;
+
+    // half distance of each centroid to the closest other one, and its last move
+    std::vector<real_t> __separations;
+    std::vector<real_t> __moves;
+
+    PointKDTree * __index;
+
+    uint32_t __iterations;
+    uint32_t __changed;
+};
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+#endif
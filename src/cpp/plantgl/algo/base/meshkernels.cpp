@@ -0,0 +1,295 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+#include "meshkernels.h"
+#include <plantgl/tool/util_simd.h>
+#include <cmath>
+
+PGL_USING_NAMESPACE
+TOOLS_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+// Number of elements gathered at once. Must be a multiple of PGL_PACK_SIZE.
+#define BLOCK_SIZE 256
+
+/* ----------------------------------------------------------------------- */
+
+const char * PGL(mesh_kernels_instruction_set)() { return PGL_SIMD_INSTRUCTION_SET; }
+
+/* ----------------------------------------------------------------------- */
+
+/*
+   Coordinates of a block of points in SoA form.
+*/
+struct PointBlock {
+    double x[BLOCK_SIZE];
+    double y[BLOCK_SIZE];
+    double z[BLOCK_SIZE];
+
+    // Gather points [first,last[ and pad the block up to a multiple of PGL_PACK_SIZE by repeating the first point.
+    size_t gather(Point3Array::const_iterator first, Point3Array::const_iterator last) {
+        size_t n = 0;
+        for(; first != last; ++first, ++n){
+            x[n] = first->x(); y[n] = first->y(); z[n] = first->z();
+        }
+        size_t padded = n;
+        for(; padded % PGL_PACK_SIZE != 0; ++padded){
+            x[padded] = x[0]; y[padded] = y[0]; z[padded] = z[0];
+        }
+        return padded;
+    }
+};
+
+/*
+   Accumulator of min and max values.
+*/
+struct BoundsAccumulator {
+    dpack minx, miny, minz, maxx, maxy, maxz;
+    bool initialized;
+
+    BoundsAccumulator() : initialized(false) { }
+
+    void add(const double * x, const double * y, const double * z, size_t n) {
+        size_t i = 0;
+        if(!initialized){
+            minx = maxx = pk_load(x); miny = maxy = pk_load(y); minz = maxz = pk_load(z);
+            initialized = true;
+            i += PGL_PACK_SIZE;
+        }
+        for(; i < n; i += PGL_PACK_SIZE){
+            dpack px = pk_load(x+i), py = pk_load(y+i), pz = pk_load(z+i);
+            minx = pk_min(minx,px); maxx = pk_max(maxx,px);
+            miny = pk_min(miny,py); maxy = pk_max(maxy,py);
+            minz = pk_min(minz,pz); maxz = pk_max(maxz,pz);
+        }
+    }
+
+    std::pair<Vector3,Vector3> result() const {
+        if (!initialized) return std::pair<Vector3,Vector3>(Vector3::ORIGIN,Vector3::ORIGIN);
+        return std::pair<Vector3,Vector3>(Vector3(pk_hmin(minx),pk_hmin(miny),pk_hmin(minz)),
+                                          Vector3(pk_hmax(maxx),pk_hmax(maxy),pk_hmax(maxz)));
+    }
+};
+
+std::pair<Vector3,Vector3> PGL(points_bounds)(const Point3ArrayPtr& points)
+{
+    BoundsAccumulator bounds;
+    if (!points) return bounds.result();
+    PointBlock block;
+    for(Point3Array::const_iterator it = points->begin(); it != points->end(); ){
+        Point3Array::const_iterator last = it + std::min<size_t>(BLOCK_SIZE, points->end() - it);
+        size_t n = block.gather(it,last);
+        bounds.add(block.x,block.y,block.z,n);
+        it = last;
+    }
+    return bounds.result();
+}
+
+/* ----------------------------------------------------------------------- */
+
+/*
+   Bounds of points transformed by an affine transformation given as a 3x4 row-major matrix.
+*/
+std::pair<Vector3,Vector3> affine_points_bounds(const Point3ArrayPtr& points, const double m[3][4])
+{
+    BoundsAccumulator bounds;
+    if (!points) return bounds.result();
+    PointBlock block, tblock;
+    dpack m00 = pk_set1(m[0][0]), m01 = pk_set1(m[0][1]), m02 = pk_set1(m[0][2]), m03 = pk_set1(m[0][3]);
+    dpack m10 = pk_set1(m[1][0]), m11 = pk_set1(m[1][1]), m12 = pk_set1(m[1][2]), m13 = pk_set1(m[1][3]);
+    dpack m20 = pk_set1(m[2][0]), m21 = pk_set1(m[2][1]), m22 = pk_set1(m[2][2]), m23 = pk_set1(m[2][3]);
+    for(Point3Array::const_iterator it = points->begin(); it != points->end(); ){
+        Point3Array::const_iterator last = it + std::min<size_t>(BLOCK_SIZE, points->end() - it);
+        size_t n = block.gather(it,last);
+        for(size_t i = 0; i < n; i += PGL_PACK_SIZE){
+            dpack px = pk_load(block.x+i), py = pk_load(block.y+i), pz = pk_load(block.z+i);
+            pk_store(tblock.x+i, pk_add(pk_add(pk_mul(m00,px),pk_mul(m01,py)),pk_add(pk_mul(m02,pz),m03)));
+            pk_store(tblock.y+i, pk_add(pk_add(pk_mul(m10,px),pk_mul(m11,py)),pk_add(pk_mul(m12,pz),m13)));
+            pk_store(tblock.z+i, pk_add(pk_add(pk_mul(m20,px),pk_mul(m21,py)),pk_add(pk_mul(m22,pz),m23)));
+        }
+        bounds.add(tblock.x,tblock.y,tblock.z,n);
+        it = last;
+    }
+    return bounds.result();
+}
+
+std::pair<Vector3,Vector3> PGL(transformed_points_bounds)(const Point3ArrayPtr& points, const Matrix3& matrix)
+{
+    double m[3][4];
+    for(uchar_t i = 0; i < 3; ++i){
+        for(uchar_t j = 0; j < 3; ++j) m[i][j] = matrix(i,j);
+        m[i][3] = 0;
+    }
+    return affine_points_bounds(points,m);
+}
+
+std::pair<Vector3,Vector3> PGL(transformed_points_bounds)(const Point3ArrayPtr& points, const Matrix4& matrix)
+{
+    double m[3][4];
+    for(uchar_t i = 0; i < 3; ++i)
+        for(uchar_t j = 0; j < 4; ++j) m[i][j] = matrix(i,j);
+    return affine_points_bounds(points,m);
+}
+
+/* ----------------------------------------------------------------------- */
+
+/*
+   Accumulate the area of triangles or the volume of the tetrahedra they form with a center.
+   Triangles are pushed one by one and the computation is made by blocks.
+*/
+class TriangleAccumulator {
+public:
+    TriangleAccumulator() : 
+        __volume(false), __absolute(false), __size(0), __sum(0) { }
+
+    TriangleAccumulator(const Vector3& center, bool absolute) : 
+        __volume(true), __absolute(absolute), __center(center), __size(0), __sum(0) { }
+
+    inline void push(const Vector3& a, const Vector3& b, const Vector3& c) {
+        ax[__size] = a.x(); ay[__size] = a.y(); az[__size] = a.z();
+        bx[__size] = b.x(); by[__size] = b.y(); bz[__size] = b.z();
+        cx[__size] = c.x(); cy[__size] = c.y(); cz[__size] = c.z();
+        if (++__size == BLOCK_SIZE) flush();
+    }
+
+    double result() {
+        flush();
+        return (__volume ? __sum / 6 : __sum / 2);
+    }
+
+protected:
+    void flush() {
+        if (__size == 0) return;
+        // degenerated triangles located on the center add neither area nor volume.
+        for(; __size % PGL_PACK_SIZE != 0; ++__size){
+            ax[__size] = bx[__size] = cx[__size] = __center.x();
+            ay[__size] = by[__size] = cy[__size] = __center.y();
+            az[__size] = bz[__size] = cz[__size] = __center.z();
+        }
+        dpack acc = pk_set1(0);
+        dpack ox = pk_set1(__center.x()), oy = pk_set1(__center.y()), oz = pk_set1(__center.z());
+        for(size_t i = 0; i < __size; i += PGL_PACK_SIZE){
+            dpack pax = pk_load(ax+i), pay = pk_load(ay+i), paz = pk_load(az+i);
+            dpack e1x = pk_sub(pk_load(bx+i),pax), e1y = pk_sub(pk_load(by+i),pay), e1z = pk_sub(pk_load(bz+i),paz);
+            dpack e2x = pk_sub(pk_load(cx+i),pax), e2y = pk_sub(pk_load(cy+i),pay), e2z = pk_sub(pk_load(cz+i),paz);
+            dpack nx = pk_sub(pk_mul(e1y,e2z),pk_mul(e1z,e2y));
+            dpack ny = pk_sub(pk_mul(e1z,e2x),pk_mul(e1x,e2z));
+            dpack nz = pk_sub(pk_mul(e1x,e2y),pk_mul(e1y,e2x));
+            if (__volume) {
+                dpack v = pk_add(pk_add(pk_mul(pk_sub(ox,pax),nx),pk_mul(pk_sub(oy,pay),ny)),pk_mul(pk_sub(oz,paz),nz));
+                acc = pk_add(acc, __absolute ? pk_abs(v) : v);
+            }
+            else acc = pk_add(acc, pk_sqrt(pk_add(pk_add(pk_mul(nx,nx),pk_mul(ny,ny)),pk_mul(nz,nz))));
+        }
+        __sum += pk_hsum(acc);
+        __size = 0;
+    }
+
+    bool __volume;
+    bool __absolute;
+    Vector3 __center;
+    size_t __size;
+    double __sum;
+
+    double ax[BLOCK_SIZE], ay[BLOCK_SIZE], az[BLOCK_SIZE];
+    double bx[BLOCK_SIZE], by[BLOCK_SIZE], bz[BLOCK_SIZE];
+    double cx[BLOCK_SIZE], cy[BLOCK_SIZE], cz[BLOCK_SIZE];
+};
+
+inline void push_triangles(TriangleAccumulator& acc, const Point3Array& points, const Index3Array& indices)
+{
+    for(Index3Array::const_iterator it = indices.begin(); it != indices.end(); ++it)
+        acc.push(points.getAt(it->getAt(0)),points.getAt(it->getAt(1)),points.getAt(it->getAt(2)));
+}
+
+inline void push_triangles(TriangleAccumulator& acc, const Point3Array& points, const Index4Array& indices)
+{
+    for(Index4Array::const_iterator it = indices.begin(); it != indices.end(); ++it){
+        const Vector3& p0 = points.getAt(it->getAt(0));
+        const Vector3& p2 = points.getAt(it->getAt(2));
+        acc.push(p0,points.getAt(it->getAt(1)),p2);
+        acc.push(p0,p2,points.getAt(it->getAt(3)));
+    }
+}
+
+inline void push_triangles(TriangleAccumulator& acc, const Point3Array& points, const IndexArray& indices)
+{
+    for(IndexArray::const_iterator it = indices.begin(); it != indices.end(); ++it){
+        size_t nbpoints = it->size();
+        if (nbpoints < 3) continue;
+        const Vector3& p0 = points.getAt(it->getAt(0));
+        for(size_t j = 1; j < nbpoints - 1; ++j)
+            acc.push(p0,points.getAt(it->getAt(j)),points.getAt(it->getAt(j+1)));
+    }
+}
+
+template<class IndexArrayPtrType>
+real_t mesh_surface(const Point3ArrayPtr& points, const IndexArrayPtrType& indices)
+{
+    if (!points || !indices) return 0;
+    TriangleAccumulator acc;
+    push_triangles(acc,*points,*indices);
+    return acc.result();
+}
+
+template<class IndexArrayPtrType>
+real_t mesh_volume(const Point3ArrayPtr& points, const IndexArrayPtrType& indices, const Vector3& center, bool absolute)
+{
+    if (!points || !indices) return 0;
+    TriangleAccumulator acc(center,absolute);
+    push_triangles(acc,*points,*indices);
+    return acc.result();
+}
+
+/* ----------------------------------------------------------------------- */
+
+real_t PGL(triangles_surface)(const Point3ArrayPtr& points, const Index3ArrayPtr& indices)
+{ return mesh_surface(points,indices); }
+
+real_t PGL(quads_surface)(const Point3ArrayPtr& points, const Index4ArrayPtr& indices)
+{ return mesh_surface(points,indices); }
+
+real_t PGL(polygons_surface)(const Point3ArrayPtr& points, const IndexArrayPtr& indices)
+{ return mesh_surface(points,indices); }
+
+real_t PGL(triangles_volume)(const Point3ArrayPtr& points, const Index3ArrayPtr& indices, const Vector3& center, bool absolute)
+{ return mesh_volume(points,indices,center,absolute); }
+
+real_t PGL(quads_volume)(const Point3ArrayPtr& points, const Index4ArrayPtr& indices, const Vector3& center, bool absolute)
+{ return mesh_volume(points,indices,center,absolute); }
+
+real_t PGL(polygons_volume)(const Point3ArrayPtr& points, const IndexArrayPtr& indices, const Vector3& center, bool absolute)
+{ return mesh_volume(points,indices,center,absolute); }
+
+/* ----------------------------------------------------------------------- */
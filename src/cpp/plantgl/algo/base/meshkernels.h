@@ -0,0 +1,89 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+/*! \file meshkernels.h
+    \brief Vectorized computation kernels for bounds, surface and volume of explicit meshes.
+
+    Points are gathered by blocks into coordinate arrays (SoA) on which the
+    computations are made with AVX or SSE2 instructions when available, or
+    with a scalar loop otherwise. Sums are accumulated in double precision.
+*/
+
+#ifndef __meshkernels_h__
+#define __meshkernels_h__
+
+#include "../algo_config.h"
+#include <plantgl/scenegraph/container/pointarray.h>
+#include <plantgl/scenegraph/container/indexarray.h>
+#include <plantgl/math/util_vector.h>
+#include <plantgl/math/util_matrix.h>
+
+PGL_BEGIN_NAMESPACE
+
+/// Returns the name of the instruction set used by the kernels ("avx", "sse2" or "scalar").
+ALGO_API const char * mesh_kernels_instruction_set();
+
+/// Compute the bounds of \e points.
+ALGO_API std::pair<TOOLS(Vector3),TOOLS(Vector3)> points_bounds(const Point3ArrayPtr& points);
+
+/// Compute the bounds of \e points transformed by \e matrix.
+ALGO_API std::pair<TOOLS(Vector3),TOOLS(Vector3)> transformed_points_bounds(const Point3ArrayPtr& points, const TOOLS(Matrix3)& matrix);
+
+/// Compute the bounds of \e points transformed by the affine transformation \e matrix.
+ALGO_API std::pair<TOOLS(Vector3),TOOLS(Vector3)> transformed_points_bounds(const Point3ArrayPtr& points, const TOOLS(Matrix4)& matrix);
+
+/// Compute the total area of the triangles \e indices of \e points.
+ALGO_API real_t triangles_surface(const Point3ArrayPtr& points, const Index3ArrayPtr& indices);
+
+/// Compute the total area of the quads \e indices of \e points.
+ALGO_API real_t quads_surface(const Point3ArrayPtr& points, const Index4ArrayPtr& indices);
+
+/// Compute the total area of the polygons \e indices of \e points. Polygons are triangulated as fans.
+ALGO_API real_t polygons_surface(const Point3ArrayPtr& points, const IndexArrayPtr& indices);
+
+/** Compute the sum of the volumes of the tetrahedra formed by \e center and each triangle of \e indices.
+    If \e absolute is set, unsigned volumes are summed. */
+ALGO_API real_t triangles_volume(const Point3ArrayPtr& points, const Index3ArrayPtr& indices, 
+                                 const TOOLS(Vector3)& center, bool absolute = true);
+
+/// Compute the sum of the volumes of the tetrahedra formed by \e center and each quad of \e indices.
+ALGO_API real_t quads_volume(const Point3ArrayPtr& points, const Index4ArrayPtr& indices, 
+                             const TOOLS(Vector3)& center, bool absolute = true);
+
+/// Compute the sum of the volumes of the tetrahedra formed by \e center and each polygon of \e indices.
+ALGO_API real_t polygons_volume(const Point3ArrayPtr& points, const IndexArrayPtr& indices, 
+                                const TOOLS(Vector3)& center, bool absolute = true);
+
+PGL_END_NAMESPACE
+
+#endif
@@ -0,0 +1,535 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+#include "meshwelder.h"
+#include "meshkernels.h"
+#include <plantgl/tool/util_parallel.h>
+#include <plantgl/tool/errormsg.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+PGL_USING_NAMESPACE
+TOOLS_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+MeshWeldStatistics::MeshWeldStatistics():
+  inputPoints(0), outputPoints(0), inputFaces(0), outputFaces(0) {}
+
+/* ----------------------------------------------------------------------- */
+
+/* Cells coordinates are packed on 21 bits each into a 64 bits key.
+   Coordinates of far cells may wrap and share a key, which only costs some more distance tests. */
+#define WELD_CELL_BITS 21
+#define WELD_CELL_MASK ((uint64_t(1) << WELD_CELL_BITS) - 1)
+
+typedef std::pair<uint64_t,uint_t> WeldEntry;
+
+static inline uint64_t weld_hash(uint64_t key) {
+    key ^= key >> 33; key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33; key *= 0xc4ceb9fe1a85ec53ULL;
+    return key ^ (key >> 33);
+}
+
+/* Spatial hash of the points. 
+   Cells have a size of twice the tolerance so that only the 8 cells around the closest
+   cell corner of a point have to be searched. With a null tolerance, the key of a point is 
+   made from its coordinates and only points with the same key are compared. */
+struct WeldGrid {
+    const Point3Array& points;
+    Vector3 origin;
+    real_t cellSize;
+    real_t tolerance2;
+    bool exact;
+
+    // Points sorted by cell key then by index, and first entry of each cell.
+    std::vector<WeldEntry> entries;
+    std::vector<uint64_t> cellKeys;
+    std::vector<size_t> cellStarts;
+
+    // Open addressing table from keys to cells, storing cell index + 1.
+    std::vector<uint_t> table;
+    uint64_t tableMask;
+
+    WeldGrid(const Point3ArrayPtr& _points, real_t tolerance) :
+        points(*_points), cellSize(2*tolerance), tolerance2(tolerance*tolerance), exact(tolerance <= 0)
+    {
+        if (!exact) origin = points_bounds(_points).first;
+        else tolerance2 = 0;
+    }
+
+    inline real_t cellCoord(real_t v, real_t o) const {
+        real_t c = floor((v - o) / cellSize);
+        return (c < 0 ? 0 : (c > 1e18 ? 1e18 : c));
+    }
+
+    inline uint64_t cellKey(uint64_t cx, uint64_t cy, uint64_t cz) const {
+        return ((cx & WELD_CELL_MASK) << (2*WELD_CELL_BITS)) | ((cy & WELD_CELL_MASK) << WELD_CELL_BITS) | (cz & WELD_CELL_MASK);
+    }
+
+    inline uint64_t exactKey(const Vector3& p) const {
+        uint64_t key = 0;
+        for(int k = 0; k < 3; ++k){
+            double v = p[k] + 0.0; // -0 and +0 have the same key.
+            uint64_t bits = 0;
+            memcpy(&bits,&v,sizeof(double));
+            key = weld_hash(key ^ bits);
+        }
+        return key;
+    }
+
+    inline uint64_t pointKey(const Vector3& p) const {
+        if (exact) return exactKey(p);
+        return cellKey(uint64_t(cellCoord(p.x(),origin.x())),uint64_t(cellCoord(p.y(),origin.y())),uint64_t(cellCoord(p.z(),origin.z())));
+    }
+
+    /* Computes the keys of the points [begin,end[ and sorts them. */
+    void operator()(size_t begin, size_t end, size_t) {
+        for(size_t i = begin; i < end; ++i) entries[i] = WeldEntry(pointKey(points.getAt(i)),i);
+        std::sort(entries.begin()+begin,entries.begin()+end);
+    }
+
+    void build() {
+        size_t nbpoints = points.size();
+        entries.resize(nbpoints);
+        parallel_for(nbpoints,*this,4096);
+
+        // Merge the ranges sorted in parallel.
+        size_t nbchunks = parallel_chunk_count(nbpoints,4096);
+        std::vector<size_t> bounds(nbchunks+1);
+        for(size_t c = 0; c < nbchunks; ++c) bounds[c] = parallel_chunk_begin(nbpoints,c,nbchunks);
+        bounds[nbchunks] = nbpoints;
+        for(size_t width = 1; width < nbchunks; width *= 2)
+            for(size_t c = 0; c + width < nbchunks; c += 2 * width)
+                std::inplace_merge(entries.begin()+bounds[c],entries.begin()+bounds[c+width],
+                                   entries.begin()+bounds[std::min(c+2*width,nbchunks)]);
+
+        for(size_t i = 0; i < nbpoints; ++i){
+            if (i == 0 || entries[i].first != entries[i-1].first) {
+                cellKeys.push_back(entries[i].first);
+                cellStarts.push_back(i);
+            }
+        }
+        cellStarts.push_back(nbpoints);
+
+        size_t tableSize = 16;
+        while (tableSize < 2 * cellKeys.size()) tableSize *= 2;
+        tableMask = tableSize - 1;
+        table.assign(tableSize,0);
+        for(size_t cell = 0; cell < cellKeys.size(); ++cell){
+            uint64_t slot = weld_hash(cellKeys[cell]) & tableMask;
+            while (table[slot] != 0) slot = (slot + 1) & tableMask;
+            table[slot] = cell + 1;
+        }
+    }
+
+    /* Returns the cell of key \e key or -1 if no point has this key. */
+    inline size_t findCell(uint64_t key) const {
+        uint64_t slot = weld_hash(key) & tableMask;
+        while (table[slot] != 0) {
+            if (cellKeys[table[slot]-1] == key) return table[slot]-1;
+            slot = (slot + 1) & tableMask;
+        }
+        return size_t(-1);
+    }
+
+    /* Updates \e best with the point of lowest index of the cell \e key within the tolerance of \e p. */
+    inline void searchCell(uint64_t key, const Vector3& p, uint_t& best) const {
+        size_t cell = findCell(key);
+        if (cell == size_t(-1)) return;
+        // Entries of a cell are sorted by index.
+        for(size_t e = cellStarts[cell]; e < cellStarts[cell+1] && entries[e].second < best; ++e){
+            if (normSquared(points.getAt(entries[e].second) - p) <= tolerance2)
+                best = entries[e].second;
+        }
+    }
+
+    /* Returns the point of lowest index within the tolerance of the point \e pid. */
+    uint_t representative(uint_t pid) const {
+        const Vector3& p = points.getAt(pid);
+        uint_t best = pid;
+        if (exact) {
+            searchCell(exactKey(p),p,best);
+            return best;
+        }
+        // Search the cells sharing the cell corner closest to p.
+        uint64_t c[3], n[3];
+        for(int k = 0; k < 3; ++k){
+            real_t v = cellCoord(p[k],origin[k]);
+            c[k] = uint64_t(v);
+            n[k] = ((p[k] - origin[k]) / cellSize - v < 0.5 ? c[k] - 1 : c[k] + 1);
+        }
+        for(int i = 0; i < 8; ++i)
+            searchCell(cellKey(i & 1 ? n[0] : c[0], i & 2 ? n[1] : c[1], i & 4 ? n[2] : c[2]),p,best);
+        return best;
+    }
+};
+
+/* Computes the representative of each point, traversed in the order of the cells for locality. */
+struct WeldRepresentatives {
+    const WeldGrid& grid;
+    std::vector<uint_t>& roots;
+
+    WeldRepresentatives(const WeldGrid& _grid, std::vector<uint_t>& _roots) : grid(_grid), roots(_roots) {}
+
+    void operator()(size_t begin, size_t end, size_t) {
+        for(size_t e = begin; e < end; ++e){
+            uint_t pid = grid.entries[e].second;
+            roots[pid] = grid.representative(pid);
+        }
+    }
+};
+
+/* Computes for each point the index of the point it is merged with.
+   Representatives have a lower index, so chains are resolved by an ascending pass. */
+static void weld_roots(const Point3ArrayPtr& points, real_t tolerance, std::vector<uint_t>& roots)
+{
+    size_t nbpoints = points->size();
+    roots.resize(nbpoints);
+    if (nbpoints == 0) return;
+    WeldGrid grid(points,tolerance);
+    grid.build();
+    WeldRepresentatives representatives(grid,roots);
+    parallel_for(nbpoints,representatives,1024);
+    for(size_t i = 0; i < nbpoints; ++i) roots[i] = roots[roots[i]];
+}
+
+/* ----------------------------------------------------------------------- */
+
+Point3ArrayPtr PGL(weld_points)(const Point3ArrayPtr& points, real_t tolerance, Index& remap)
+{
+    std::vector<uint_t> roots;
+    weld_roots(points,tolerance,roots);
+    size_t nbpoints = points->size();
+    remap = Index(nbpoints);
+    Point3ArrayPtr result(new Point3Array());
+    for(size_t i = 0; i < nbpoints; ++i){
+        if (roots[i] == i) {
+            remap[i] = result->size();
+            result->push_back(points->getAt(i));
+        }
+        else remap[i] = remap[roots[i]];
+    }
+    return result;
+}
+
+/* ----------------------------------------------------------------------- */
+
+/* Construction of faces of the different index types. */
+template<class IndexType>
+struct WeldFace {
+    static const bool fixedSize = true;
+    static IndexType make(const std::vector<uint_t>& values) {
+        IndexType res;
+        for(uint_t j = 0; j < IndexType::size(); ++j) res.getAt(j) = values[j];
+        return res;
+    }
+};
+
+template<>
+struct WeldFace<Index> {
+    static const bool fixedSize = false;
+    static Index make(const std::vector<uint_t>& values) {
+        Index res;
+        for(std::vector<uint_t>::const_iterator it = values.begin(); it != values.end(); ++it) res.push_back(*it);
+        return res;
+    }
+};
+
+/* Welds the vertices of a TriangleSet, a QuadSet or a FaceSet. */
+template<class MeshType>
+class MeshWelder {
+public:
+    typedef typename MeshType::IndexArray IndexArray;
+    typedef typename MeshType::IndexArrayPtr IndexArrayPtr;
+    typedef typename MeshType::IndexType IndexType;
+    typedef WeldFace<IndexType> Face;
+
+    MeshWelder(const MeshType& mesh, real_t tolerance) :
+        __mesh(mesh), __tolerance(tolerance),
+        __keepTexCoordSeams(false) {}
+
+    /* Positions of the corners of the face kept after welding.
+       Fixed size faces are kept entirely or removed. For polygons, consecutive merged corners are collapsed. */
+    size_t keptCorners(const IndexType& face, std::vector<uint_t>& corners) const {
+        corners.clear();
+        size_t nbcorners = face.size();
+        if (Face::fixedSize) {
+            for(size_t j = 0; j < nbcorners; ++j)
+                for(size_t k = j+1; k < nbcorners; ++k)
+                    if (__roots[face[j]] == __roots[face[k]]) return 0;
+            for(size_t j = 0; j < nbcorners; ++j) corners.push_back(j);
+        }
+        else {
+            for(size_t j = 0; j < nbcorners; ++j)
+                if (__roots[face[j]] != __roots[face[(j+1)%nbcorners]]) corners.push_back(j);
+            if (corners.size() < 3) corners.clear();
+        }
+        return corners.size();
+    }
+
+    /* Restriction of an attribute face index to the kept corners. */
+    IndexType filter(const IndexType& index, size_t faceSize, const std::vector<uint_t>& corners, std::vector<uint_t>& values) const {
+        if (Face::fixedSize || index.size() != faceSize) return index;
+        values.clear();
+        for(std::vector<uint_t>::const_iterator it = corners.begin(); it != corners.end(); ++it) values.push_back(index[*it]);
+        return Face::make(values);
+    }
+
+    /* Parallel passes on the faces. In the first one, the kept faces are determined.
+       In the second one, the faces and their attributes are written at their new position. */
+    void operator()(size_t begin, size_t end, size_t) {
+        std::vector<uint_t> corners, values;
+        const IndexArray& indices = *__mesh.getIndexList();
+        if (!__faceOffsets.empty()) {
+            for(size_t f = begin; f < end; ++f){
+                if (__faceOffsets[f] == __faceOffsets[f+1]) continue;
+                const IndexType& face = indices.getAt(f);
+                keptCorners(face,corners);
+                size_t target = __faceOffsets[f];
+                values.clear();
+                for(std::vector<uint_t>::const_iterator it = corners.begin(); it != corners.end(); ++it) 
+                    values.push_back(__newIds[__roots[face[*it]]]);
+                __indices->setAt(target,Face::make(values));
+                if (__normalIndices) __normalIndices->setAt(target,filter(__mesh.getNormalIndexListAt(f),face.size(),corners,values));
+                if (__colorIndices) __colorIndices->setAt(target,filter(__mesh.getColorIndexListAt(f),face.size(),corners,values));
+                if (__texCoordIndices) {
+                    if (__keepTexCoordSeams) {
+                        values.clear();
+                        for(std::vector<uint_t>::const_iterator it = corners.begin(); it != corners.end(); ++it) values.push_back(face[*it]);
+                        __texCoordIndices->setAt(target,Face::make(values));
+                    }
+                    else __texCoordIndices->setAt(target,filter(__mesh.getTexCoordIndexListAt(f),face.size(),corners,values));
+                }
+                if (__faceNormals) __normals->setAt(target,__mesh.getNormalList()->getAt(f));
+                if (__faceColors) __colors->setAt(target,__mesh.getColorList()->getAt(f));
+            }
+        }
+        else {
+            for(size_t f = begin; f < end; ++f) __keptSizes[f] = keptCorners(indices.getAt(f),corners);
+        }
+    }
+
+    RCPtr<MeshType> weld(MeshWeldStatistics * stats) {
+        const Point3ArrayPtr& points = __mesh.getPointList();
+        const IndexArrayPtr& indices = __mesh.getIndexList();
+        if (!points || !indices) return RCPtr<MeshType>();
+        size_t nbpoints = points->size();
+        size_t nbfaces = indices->size();
+
+        weld_roots(points,__tolerance,__roots);
+
+        // Determine the kept faces.
+        __keptSizes.resize(nbfaces);
+        parallel_for(nbfaces,*this,256);
+        std::vector<size_t> faceOffsets(nbfaces+1,0);
+        for(size_t f = 0; f < nbfaces; ++f) faceOffsets[f+1] = faceOffsets[f] + (__keptSizes[f] > 0 ? 1 : 0);
+        size_t nbkeptfaces = faceOffsets[nbfaces];
+
+        if (stats) {
+            stats->inputPoints = nbpoints;
+            stats->inputFaces = nbfaces;
+            stats->outputFaces = nbkeptfaces;
+            stats->outputPoints = 0;
+        }
+        if (nbkeptfaces == 0) return RCPtr<MeshType>();
+
+        // Keep the representatives referenced by the remaining faces.
+        // Corners collapsed in a polygon share their representative with a kept corner.
+        std::vector<bool> used(nbpoints,false);
+        for(size_t f = 0; f < nbfaces; ++f){
+            if (__keptSizes[f] == 0) continue;
+            const IndexType& face = indices->getAt(f);
+            for(size_t j = 0; j < face.size(); ++j) used[__roots[face[j]]] = true;
+        }
+        __newIds.assign(nbpoints,uint_t(-1));
+        Point3ArrayPtr newpoints(new Point3Array());
+        for(size_t i = 0; i < nbpoints; ++i){
+            if (__roots[i] == i && used[i]) {
+                __newIds[i] = newpoints->size();
+                newpoints->push_back(points->getAt(i));
+            }
+        }
+        size_t nbnewpoints = newpoints->size();
+        if (stats) stats->outputPoints = nbnewpoints;
+
+        // Attributes
+        Point3ArrayPtr normals;
+        __faceNormals = false;
+        const Point3ArrayPtr& oldnormals = __mesh.getNormalList();
+        if (oldnormals) {
+            if (__mesh.getNormalIndexList()) {
+                normals = oldnormals;
+                __normalIndices = IndexArrayPtr(new IndexArray(nbkeptfaces));
+            }
+            else if (__mesh.getNormalPerVertex() && oldnormals->size() >= nbpoints) {
+                normals = Point3ArrayPtr(new Point3Array(nbnewpoints,Vector3::ORIGIN));
+                for(size_t i = 0; i < nbpoints; ++i)
+                    if (used[__roots[i]]) normals->getAt(__newIds[__roots[i]]) += oldnormals->getAt(i);
+                for(size_t i = 0; i < nbpoints; ++i){
+                    if (__roots[i] != i || !used[i]) continue;
+                    Vector3& n = normals->getAt(__newIds[i]);
+                    if (normSquared(n) > 0) n.normalize();
+                    else n = oldnormals->getAt(i);
+                }
+            }
+            else if (!__mesh.getNormalPerVertex() && oldnormals->size() >= nbfaces) {
+                normals = Point3ArrayPtr(new Point3Array(nbkeptfaces));
+                __faceNormals = true;
+            }
+        }
+
+        Color4ArrayPtr colors;
+        __faceColors = false;
+        const Color4ArrayPtr& oldcolors = __mesh.getColorList();
+        if (oldcolors) {
+            if (__mesh.getColorIndexList()) {
+                colors = oldcolors;
+                __colorIndices = IndexArrayPtr(new IndexArray(nbkeptfaces));
+            }
+            else if (__mesh.getColorPerVertex() && oldcolors->size() >= nbpoints) {
+                std::vector<uint_t> sums(4*nbnewpoints,0), counts(nbnewpoints,0);
+                for(size_t i = 0; i < nbpoints; ++i){
+                    if (!used[__roots[i]]) continue;
+                    uint_t pid = __newIds[__roots[i]];
+                    const Color4& c = oldcolors->getAt(i);
+                    for(int k = 0; k < 4; ++k) sums[4*pid+k] += c[k];
+                    ++counts[pid];
+                }
+                colors = Color4ArrayPtr(new Color4Array(nbnewpoints));
+                for(size_t pid = 0; pid < nbnewpoints; ++pid)
+                    colors->setAt(pid,Color4(uchar_t((sums[4*pid]+counts[pid]/2)/counts[pid]),
+                                             uchar_t((sums[4*pid+1]+counts[pid]/2)/counts[pid]),
+                                             uchar_t((sums[4*pid+2]+counts[pid]/2)/counts[pid]),
+                                             uchar_t((sums[4*pid+3]+counts[pid]/2)/counts[pid])));
+            }
+            else if (!__mesh.getColorPerVertex() && oldcolors->size() >= nbfaces) {
+                colors = Color4ArrayPtr(new Color4Array(nbkeptfaces));
+                __faceColors = true;
+            }
+        }
+
+        Point2ArrayPtr texcoords;
+        __keepTexCoordSeams = false;
+        const Point2ArrayPtr& oldtexcoords = __mesh.getTexCoordList();
+        if (oldtexcoords) {
+            if (__mesh.getTexCoordIndexList()) {
+                texcoords = oldtexcoords;
+                __texCoordIndices = IndexArrayPtr(new IndexArray(nbkeptfaces));
+            }
+            else if (oldtexcoords->size() >= nbpoints) {
+                for(size_t i = 0; i < nbpoints && !__keepTexCoordSeams; ++i)
+                    if (used[__roots[i]] && normSquared(oldtexcoords->getAt(i)-oldtexcoords->getAt(__roots[i])) > GEOM_EPSILON*GEOM_EPSILON)
+                        __keepTexCoordSeams = true;
+                if (__keepTexCoordSeams) {
+                    // Merged vertices have different texture coordinates: index them by the original points.
+                    texcoords = oldtexcoords;
+                    __texCoordIndices = IndexArrayPtr(new IndexArray(nbkeptfaces));
+                }
+                else {
+                    texcoords = Point2ArrayPtr(new Point2Array(nbnewpoints));
+                    for(size_t i = 0; i < nbpoints; ++i)
+                        if (__roots[i] == i && used[i]) texcoords->setAt(__newIds[i],oldtexcoords->getAt(i));
+                }
+            }
+        }
+
+        // Write the faces.
+        __indices = IndexArrayPtr(new IndexArray(nbkeptfaces));
+        __normals = normals;
+        __colors = colors;
+        __faceOffsets.swap(faceOffsets);
+        parallel_for(nbfaces,*this,256);
+
+        return RCPtr<MeshType>(new MeshType(newpoints, __indices, 
+                                            normals, __normalIndices,
+                                            colors, __colorIndices,
+                                            texcoords, __texCoordIndices,
+                                            __mesh.getNormalPerVertex(), __mesh.getColorPerVertex(),
+                                            __mesh.getCCW(), __mesh.getSolid(), __mesh.getSkeleton()));
+    }
+
+protected:
+    const MeshType& __mesh;
+    real_t __tolerance;
+
+    std::vector<uint_t> __roots;
+    std::vector<uint_t> __newIds;
+    std::vector<size_t> __keptSizes;
+    std::vector<size_t> __faceOffsets;
+
+    IndexArrayPtr __indices;
+    IndexArrayPtr __normalIndices;
+    IndexArrayPtr __colorIndices;
+    IndexArrayPtr __texCoordIndices;
+    Point3ArrayPtr __normals;
+    Color4ArrayPtr __colors;
+    bool __faceNormals;
+    bool __faceColors;
+    bool __keepTexCoordSeams;
+};
+
+/* ----------------------------------------------------------------------- */
+
+TriangleSetPtr PGL(weld_vertices)(const TriangleSetPtr& mesh, real_t tolerance, MeshWeldStatistics * stats)
+{
+    if (!mesh) return TriangleSetPtr();
+    return MeshWelder<TriangleSet>(*mesh,tolerance).weld(stats);
+}
+
+QuadSetPtr PGL(weld_vertices)(const QuadSetPtr& mesh, real_t tolerance, MeshWeldStatistics * stats)
+{
+    if (!mesh) return QuadSetPtr();
+    return MeshWelder<QuadSet>(*mesh,tolerance).weld(stats);
+}
+
+FaceSetPtr PGL(weld_vertices)(const FaceSetPtr& mesh, real_t tolerance, MeshWeldStatistics * stats)
+{
+    if (!mesh) return FaceSetPtr();
+    return MeshWelder<FaceSet>(*mesh,tolerance).weld(stats);
+}
+
+MeshPtr PGL(weld_mesh_vertices)(const MeshPtr& mesh, real_t tolerance, MeshWeldStatistics * stats)
+{
+    TriangleSetPtr triangles = dynamic_pointer_cast<TriangleSet>(mesh);
+    if (triangles) return MeshPtr(weld_vertices(triangles,tolerance,stats));
+    QuadSetPtr quads = dynamic_pointer_cast<QuadSet>(mesh);
+    if (quads) return MeshPtr(weld_vertices(quads,tolerance,stats));
+    FaceSetPtr faces = dynamic_pointer_cast<FaceSet>(mesh);
+    if (faces) return MeshPtr(weld_vertices(faces,tolerance,stats));
+    pglWarning("weld_mesh_vertices: unsupported mesh type.");
+    return MeshPtr();
+}
+
+/* ----------------------------------------------------------------------- */
@@ -0,0 +1,96 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+/*! \file meshwelder.h
+    \brief Welding of the coincident vertices of explicit meshes.
+
+    Points are sorted into the cells of a spatial hash whose size is the
+    tolerance. Each point is then merged with the point of lowest index found
+    within the tolerance in its 27 neighboring cells.
+*/
+
+#ifndef __meshwelder_h__
+#define __meshwelder_h__
+
+#include "../algo_config.h"
+#include <plantgl/scenegraph/geometry/triangleset.h>
+#include <plantgl/scenegraph/geometry/quadset.h>
+#include <plantgl/scenegraph/geometry/faceset.h>
+
+PGL_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/// Statistics on a welding of mesh vertices.
+struct ALGO_API MeshWeldStatistics {
+  MeshWeldStatistics();
+
+  /// Number of points before and after welding.
+  uint_t inputPoints, outputPoints;
+
+  /// Number of faces before and after welding. Faces degenerated by welding are removed.
+  uint_t inputFaces, outputFaces;
+};
+
+/* ----------------------------------------------------------------------- */
+
+/** Merge the points of \e points closer than \e tolerance.
+    Returns the merged points. \e remap is filled with the index in the merged points of each input point.
+    A tolerance of 0 merges only identical points. */
+ALGO_API Point3ArrayPtr weld_points(const Point3ArrayPtr& points, real_t tolerance, Index& remap);
+
+/** Merge the vertices of \e mesh closer than \e tolerance.
+    Indices are remapped and faces that are degenerated by welding are removed, as well as
+    unreferenced points. Normals and colors given per vertex are averaged over merged vertices.
+    Normals and colors given per vertex without an entry for each point are dropped.
+    Texture coordinates are merged when they coincide, else an index list is created to keep seams.
+    Returns a null pointer if no valid face remains. */
+ALGO_API TriangleSetPtr weld_vertices(const TriangleSetPtr& mesh, real_t tolerance = GEOM_EPSILON, MeshWeldStatistics * stats = NULL);
+
+/// Merge the vertices of \e mesh closer than \e tolerance. Quads with two merged vertices are removed.
+ALGO_API QuadSetPtr weld_vertices(const QuadSetPtr& mesh, real_t tolerance = GEOM_EPSILON, MeshWeldStatistics * stats = NULL);
+
+/// Merge the vertices of \e mesh closer than \e tolerance. Consecutive merged vertices of a face are collapsed.
+ALGO_API FaceSetPtr weld_vertices(const FaceSetPtr& mesh, real_t tolerance = GEOM_EPSILON, MeshWeldStatistics * stats = NULL);
+
+/// Merge the vertices of \e mesh closer than \e tolerance if it is a TriangleSet, a QuadSet or a FaceSet.
+ALGO_API MeshPtr weld_mesh_vertices(const MeshPtr& mesh, real_t tolerance = GEOM_EPSILON, MeshWeldStatistics * stats = NULL);
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+// __meshwelder_h__
+#endif
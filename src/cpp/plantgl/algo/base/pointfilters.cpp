@@ -0,0 +1,547 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *  ----------------------------------------------------------------------------
+ */
+
+#include "pointfilters.h"
+#include "pointkdtree.h"
+#include <plantgl/tool/util_parallel.h>
+#include <plantgl/tool/errormsg.h>
+#include <cmath>
+
+PGL_USING_NAMESPACE
+TOOLS_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+// Minimal number of points processed by a thread.
+#define PARALLEL_GRAIN 4096
+
+// Number of bits of the digits of the radix sort.
+#define RADIX_BITS 11
+#define RADIX_SIZE (1 << RADIX_BITS)
+
+/* ----------------------------------------------------------------------- */
+
+// Regular grid of cubic cells over the bounding box of a set of points. Keys are ordered along x first.
+struct VoxelGrid {
+    Vector3 origin;
+    real_t size;
+    uint64_t dims[3];
+
+    bool init(const Point3Array& points, real_t voxelsize) {
+        if (!(voxelsize > 0)) {
+            pglError("Invalid voxel size : %f.", voxelsize);
+            return false;
+        }
+        size = voxelsize;
+        Vector3 lower = points.getAt(0), upper = lower;
+        for (Point3Array::const_iterator it = points.begin(); it != points.end(); ++it){
+            for (int i = 0; i < 3; ++i){
+                if ((*it)[i] < lower[i]) lower[i] = (*it)[i];
+                else if ((*it)[i] > upper[i]) upper[i] = (*it)[i];
+            }
+        }
+        origin = lower;
+        double nbcells = 1;
+        for (int i = 0; i < 3; ++i){
+            dims[i] = uint64_t(floor((upper[i] - lower[i]) / size)) + 1;
+            nbcells *= double(dims[i]);
+        }
+        if (nbcells >= 9.2e18) {
+            pglError("Voxel size %f too small for the extent of the points.", voxelsize);
+            return false;
+        }
+        return true;
+    }
+
+    inline uint64_t key(const Vector3& p) const {
+        uint64_t c[3];
+        for (int i = 0; i < 3; ++i){
+            c[i] = uint64_t((p[i] - origin[i]) / size);
+            if (c[i] >= dims[i]) c[i] = dims[i] - 1;
+        }
+        return c[0] + dims[0] * (c[1] + dims[1] * c[2]);
+    }
+
+    inline void coordinates(uint64_t key, uint64_t * c) const {
+        c[0] = key % dims[0]; key /= dims[0];
+        c[1] = key % dims[1];
+        c[2] = key / dims[1];
+    }
+
+    inline uint64_t key(const uint64_t * c) const { return c[0] + dims[0] * (c[1] + dims[1] * c[2]); }
+
+    inline uint64_t maxkey() const { return dims[0] * dims[1] * dims[2] - 1; }
+};
+
+struct VoxelKeyFunctor {
+    const VoxelGrid * grid;
+    const Point3Array * points;
+    uint64_t * keys;
+    uint32_t * pids;
+
+    void operator()(size_t begin, size_t end, size_t) {
+        for (size_t pid = begin; pid < end; ++pid){
+            keys[pid] = grid->key(points->getAt(pid));
+            pids[pid] = pid;
+        }
+    }
+};
+
+// One pass of the radix sort. Counts the digits of each range of elements, or scatters them if the offsets are computed.
+struct RadixPassFunctor {
+    const uint64_t * keys;
+    const uint32_t * pids;
+    uint64_t * sortedkeys;
+    uint32_t * sortedpids;
+    uint32_t shift;
+    uint32_t * offsets; // RADIX_SIZE per range
+    bool scatter;
+
+    void operator()(size_t begin, size_t end, size_t chunk) {
+        uint32_t * chunkoffsets = offsets + chunk * RADIX_SIZE;
+        if (!scatter) {
+            std::fill(chunkoffsets, chunkoffsets + RADIX_SIZE, 0);
+            for (size_t i = begin; i < end; ++i) ++chunkoffsets[(keys[i] >> shift) & (RADIX_SIZE - 1)];
+        }
+        else {
+            for (size_t i = begin; i < end; ++i){
+                uint32_t target = chunkoffsets[(keys[i] >> shift) & (RADIX_SIZE - 1)]++;
+                sortedkeys[target] = keys[i];
+                sortedpids[target] = pids[i];
+            }
+        }
+    }
+};
+
+// Count the first elements of the runs of equal keys of each range, or store their positions if the offsets are computed.
+struct RunFunctor {
+    const uint64_t * keys;
+    uint32_t * counts;
+    uint32_t * starts;
+    bool fill;
+
+    void operator()(size_t begin, size_t end, size_t chunk) {
+        uint32_t target = (fill ? counts[chunk] : 0);
+        for (size_t i = begin; i < end; ++i){
+            if (i == 0 || keys[i] != keys[i-1]) {
+                if (fill) starts[target] = i;
+                ++target;
+            }
+        }
+        if (!fill) counts[chunk] = target;
+    }
+};
+
+/*
+   Points sorted by voxel. The points of the voxel v are pids[offsets[v]] to pids[offsets[v+1]-1],
+   in increasing order, and keys gives the key of each voxel.
+*/
+struct VoxelPartition {
+    VoxelGrid grid;
+    std::vector<uint64_t> keys;
+    std::vector<uint32_t> pids;
+    std::vector<uint32_t> offsets;
+
+    bool build(const Point3Array& points, real_t voxelsize) {
+        size_t nbpoints = points.size();
+        if (nbpoints == 0) { offsets.assign(1, 0); return true; }
+        if (!grid.init(points, voxelsize)) return false;
+
+        std::vector<uint64_t> pointkeys(nbpoints);
+        pids.resize(nbpoints);
+        VoxelKeyFunctor kfunctor;
+        kfunctor.grid = &grid;
+        kfunctor.points = &points;
+        kfunctor.keys = &pointkeys[0];
+        kfunctor.pids = &pids[0];
+        parallel_for(nbpoints, kfunctor, PARALLEL_GRAIN);
+
+        // least significant digit radix sort, stable to keep the points of a voxel in increasing order
+        uint32_t nbbits = 0;
+        for (uint64_t maxkey = grid.maxkey(); maxkey > 0; maxkey >>= 1) ++nbbits;
+        size_t nbchunks = parallel_chunk_count(nbpoints, PARALLEL_GRAIN);
+        std::vector<uint32_t> radixoffsets(nbchunks * RADIX_SIZE);
+        std::vector<uint64_t> sortedkeys(nbbits > 0 ? nbpoints : 0);
+        std::vector<uint32_t> sortedpids(nbbits > 0 ? nbpoints : 0);
+        RadixPassFunctor rfunctor;
+        rfunctor.offsets = &radixoffsets[0];
+        for (uint32_t shift = 0; shift < nbbits; shift += RADIX_BITS){
+            rfunctor.keys = &pointkeys[0];
+            rfunctor.pids = &pids[0];
+            rfunctor.sortedkeys = &sortedkeys[0];
+            rfunctor.sortedpids = &sortedpids[0];
+            rfunctor.shift = shift;
+            rfunctor.scatter = false;
+            parallel_for(nbpoints, rfunctor, PARALLEL_GRAIN);
+            uint32_t total = 0;
+            for (uint32_t digit = 0; digit < RADIX_SIZE; ++digit)
+                for (size_t chunk = 0; chunk < nbchunks; ++chunk){
+                    uint32_t count = radixoffsets[chunk * RADIX_SIZE + digit];
+                    radixoffsets[chunk * RADIX_SIZE + digit] = total;
+                    total += count;
+                }
+            rfunctor.scatter = true;
+            parallel_for(nbpoints, rfunctor, PARALLEL_GRAIN);
+            pointkeys.swap(sortedkeys);
+            pids.swap(sortedpids);
+        }
+
+        std::vector<uint32_t> runcounts(nbchunks + 1, 0);
+        RunFunctor runfunctor;
+        runfunctor.keys = &pointkeys[0];
+        runfunctor.counts = &runcounts[0];
+        runfunctor.fill = false;
+        parallel_for(nbpoints, runfunctor, PARALLEL_GRAIN);
+        uint32_t nbvoxels = 0;
+        for (size_t chunk = 0; chunk < nbchunks; ++chunk){
+            uint32_t count = runcounts[chunk];
+            runcounts[chunk] = nbvoxels;
+            nbvoxels += count;
+        }
+        offsets.resize(nbvoxels + 1);
+        offsets[nbvoxels] = nbpoints;
+        runfunctor.starts = &offsets[0];
+        runfunctor.fill = true;
+        parallel_for(nbpoints, runfunctor, PARALLEL_GRAIN);
+
+        keys.resize(nbvoxels);
+        for (uint32_t v = 0; v < nbvoxels; ++v) keys[v] = pointkeys[offsets[v]];
+        return true;
+    }
+
+    inline uint32_t size() const { return offsets.size() - 1; }
+
+    // Find the voxel of key, or return UINT32_MAX if it is empty.
+    inline uint32_t find(uint64_t key) const {
+        std::vector<uint64_t>::const_iterator it = std::lower_bound(keys.begin(), keys.end(), key);
+        if (it == keys.end() || *it != key) return UINT32_MAX;
+        return it - keys.begin();
+    }
+};
+
+/* ----------------------------------------------------------------------- */
+
+struct VoxelMeanFunctor {
+    const VoxelPartition * partition;
+    const Point3Array * points;
+    const Color4Array * colors;
+    uint32_t * representatives;
+    Point3Array * meanpoints;
+    uint32_t * counts;
+    Color4Array * meancolors;
+
+    void operator()(size_t begin, size_t end, size_t) {
+        for (size_t v = begin; v < end; ++v){
+            uint32_t pbegin = partition->offsets[v], pend = partition->offsets[v+1];
+            uint32_t nb = pend - pbegin;
+            double sum[3] = { 0, 0, 0 };
+            for (uint32_t i = pbegin; i < pend; ++i){
+                const Vector3& p = points->getAt(partition->pids[i]);
+                sum[0] += p[0]; sum[1] += p[1]; sum[2] += p[2];
+            }
+            Vector3 mean(sum[0] / nb, sum[1] / nb, sum[2] / nb);
+            real_t best = REAL_MAX;
+            for (uint32_t i = pbegin; i < pend; ++i){
+                real_t d = squared_distance(points->getAt(partition->pids[i]), mean);
+                if (d < best) { best = d; representatives[v] = partition->pids[i]; }
+            }
+            if (meanpoints) meanpoints->setAt(v, mean);
+            if (counts) counts[v] = nb;
+            if (meancolors) {
+                uint64_t csum[4] = { 0, 0, 0, 0 };
+                for (uint32_t i = pbegin; i < pend; ++i){
+                    const Color4& c = colors->getAt(partition->pids[i]);
+                    for (int j = 0; j < 4; ++j) csum[j] += c[j];
+                }
+                Color4 mc;
+                for (int j = 0; j < 4; ++j) mc[j] = uchar_t((csum[j] + nb / 2) / nb);
+                meancolors->setAt(v, mc);
+            }
+        }
+    }
+};
+
+static Index voxel_downsample_impl(const Point3ArrayPtr points, real_t voxelsize,
+                                   Point3ArrayPtr * meanpoints, Uint32Array1Ptr * counts,
+                                   const Color4ArrayPtr colors, Color4ArrayPtr * meancolors)
+{
+    VoxelPartition partition;
+    if (!points || !partition.build(*points, voxelsize)) return Index();
+    uint32_t nbvoxels = partition.size();
+
+    Index result(nbvoxels);
+    VoxelMeanFunctor functor;
+    functor.partition = &partition;
+    functor.points = points.get();
+    functor.colors = NULL;
+    functor.representatives = (nbvoxels > 0 ? &result[0] : NULL);
+    functor.meanpoints = NULL;
+    functor.counts = NULL;
+    functor.meancolors = NULL;
+    if (meanpoints) {
+        *meanpoints = Point3ArrayPtr(new Point3Array(nbvoxels));
+        functor.meanpoints = meanpoints->get();
+    }
+    if (counts) {
+        *counts = Uint32Array1Ptr(new Uint32Array1(nbvoxels));
+        functor.counts = (nbvoxels > 0 ? &*(*counts)->begin() : NULL);
+    }
+    if (meancolors) {
+        *meancolors = Color4ArrayPtr();
+        if (colors && colors->size() != points->size())
+            pglError("voxel_downsample : %i colors given for %i points. Colors are ignored.", colors->size(), points->size());
+        else if (colors) {
+            *meancolors = Color4ArrayPtr(new Color4Array(nbvoxels));
+            functor.colors = colors.get();
+            functor.meancolors = meancolors->get();
+        }
+    }
+    parallel_for(nbvoxels, functor, PARALLEL_GRAIN / 16);
+    return result;
+}
+
+Index PGL::voxel_downsample(const Point3ArrayPtr points, real_t voxelsize)
+{
+    return voxel_downsample_impl(points, voxelsize, NULL, NULL, Color4ArrayPtr(), NULL);
+}
+
+Index PGL::voxel_downsample(const Point3ArrayPtr points, real_t voxelsize,
+                            Point3ArrayPtr& meanpoints, 
+                            Uint32Array1Ptr& counts,
+                            const Color4ArrayPtr colors,
+                            Color4ArrayPtr& meancolors)
+{
+    return voxel_downsample_impl(points, voxelsize, &meanpoints, &counts, colors, &meancolors);
+}
+
+IndexArrayPtr PGL::voxel_groups(const Point3ArrayPtr points, real_t voxelsize)
+{
+    VoxelPartition partition;
+    if (!points || !partition.build(*points, voxelsize)) return IndexArrayPtr(new IndexArray(0));
+    uint32_t nbvoxels = partition.size();
+    IndexArrayPtr result(new IndexArray(nbvoxels));
+    for (uint32_t v = 0; v < nbvoxels; ++v)
+        result->setAt(v, Index(partition.pids.begin() + partition.offsets[v], partition.pids.begin() + partition.offsets[v+1]));
+    return result;
+}
+
+/* ----------------------------------------------------------------------- */
+
+/*
+   Selection of the samples of a set of cells that do not touch each other. 
+   The samples of a cell are stored at the beginning of its range in samples, 
+   and tested against the ones of the 26 neighbor cells.
+*/
+struct PoissonDiskFunctor {
+    const VoxelPartition * partition;
+    const Point3Array * points;
+    const std::vector<uint32_t> * cells;
+    real_t radius2;
+    uint32_t * samples;
+    uint32_t * nbsamples;
+
+    void operator()(size_t begin, size_t end, size_t) {
+        std::vector<uint32_t> neighbors;
+        neighbors.reserve(27);
+        for (size_t i = begin; i < end; ++i){
+            uint32_t cell = (*cells)[i];
+            uint64_t c[3], nc[3];
+            partition->grid.coordinates(partition->keys[cell], c);
+            neighbors.clear();
+            for (int dz = -1; dz <= 1; ++dz){
+                if ((dz < 0 && c[2] == 0) || (dz > 0 && c[2] + 1 == partition->grid.dims[2])) continue;
+                nc[2] = c[2] + dz;
+                for (int dy = -1; dy <= 1; ++dy){
+                    if ((dy < 0 && c[1] == 0) || (dy > 0 && c[1] + 1 == partition->grid.dims[1])) continue;
+                    nc[1] = c[1] + dy;
+                    for (int dx = -1; dx <= 1; ++dx){
+                        if ((dx < 0 && c[0] == 0) || (dx > 0 && c[0] + 1 == partition->grid.dims[0])) continue;
+                        if (dx == 0 && dy == 0 && dz == 0) continue;
+                        nc[0] = c[0] + dx;
+                        uint32_t neighbor = partition->find(partition->grid.key(nc));
+                        if (neighbor != UINT32_MAX && nbsamples[neighbor] > 0) neighbors.push_back(neighbor);
+                    }
+                }
+            }
+            uint32_t first = partition->offsets[cell];
+            uint32_t nb = 0;
+            for (uint32_t j = first; j < partition->offsets[cell+1]; ++j){
+                uint32_t pid = partition->pids[j];
+                const Vector3& p = points->getAt(pid);
+                bool accepted = true;
+                for (uint32_t s = first; s < first + nb && accepted; ++s)
+                    if (squared_distance(points->getAt(samples[s]), p) < radius2) accepted = false;
+                for (std::vector<uint32_t>::const_iterator itn = neighbors.begin(); itn != neighbors.end() && accepted; ++itn){
+                    uint32_t nfirst = partition->offsets[*itn];
+                    for (uint32_t s = nfirst; s < nfirst + nbsamples[*itn]; ++s)
+                        if (squared_distance(points->getAt(samples[s]), p) < radius2) { accepted = false; break; }
+                }
+                if (accepted) samples[first + nb++] = pid;
+            }
+            nbsamples[cell] = nb;
+        }
+    }
+};
+
+Index PGL::poisson_disk_subsample(const Point3ArrayPtr points, real_t radius)
+{
+    VoxelPartition partition;
+    if (!points || !partition.build(*points, radius)) return Index();
+    uint32_t nbcells = partition.size();
+
+    // cells whose coordinates are equal modulo 3 are processed in parallel
+    std::vector<uint32_t> phases[27];
+    for (uint32_t cell = 0; cell < nbcells; ++cell){
+        uint64_t c[3];
+        partition.grid.coordinates(partition.keys[cell], c);
+        phases[(c[0] % 3) + 3 * (c[1] % 3) + 9 * (c[2] % 3)].push_back(cell);
+    }
+
+    std::vector<uint32_t> samples(points->size());
+    std::vector<uint32_t> nbsamples(nbcells, 0);
+    PoissonDiskFunctor functor;
+    functor.partition = &partition;
+    functor.points = points.get();
+    functor.radius2 = radius * radius;
+    functor.samples = (samples.empty() ? NULL : &samples[0]);
+    functor.nbsamples = (nbsamples.empty() ? NULL : &nbsamples[0]);
+    for (int phase = 0; phase < 27; ++phase){
+        functor.cells = &phases[phase];
+        parallel_for(phases[phase].size(), functor, PARALLEL_GRAIN / 64);
+    }
+
+    Index result;
+    for (uint32_t cell = 0; cell < nbcells; ++cell)
+        result.insert(result.end(), samples.begin() + partition.offsets[cell], samples.begin() + partition.offsets[cell] + nbsamples[cell]);
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+/* ----------------------------------------------------------------------- */
+
+struct MeanDistanceFunctor {
+    const PointKDTree * tree;
+    uint32_t k;
+    real_t * meandistances;
+
+    void operator()(size_t begin, size_t end, size_t) {
+        std::vector<DistancePoint> heap;
+        heap.reserve(k);
+        OtherPointFilter filter;
+        // points are processed in the order of the tree to query close points successively
+        for (size_t i = begin; i < end; ++i){
+            uint32_t pid = tree->index[i];
+            filter.pid = pid;
+            tree->k_closest(tree->points.getAt(pid), k, filter, heap);
+            real_t sum = 0;
+            for (std::vector<DistancePoint>::const_iterator it = heap.begin(); it != heap.end(); ++it) sum += sqrt(it->first);
+            meandistances[pid] = (heap.empty() ? 0 : sum / heap.size());
+        }
+    }
+};
+
+Index PGL::statistical_outlier_filter(const Point3ArrayPtr points, uint32_t k, real_t stdratio,
+                                      RealArrayPtr& meandistances)
+{
+    size_t nbpoints = (points ? points->size() : 0);
+    meandistances = RealArrayPtr(new RealArray(nbpoints));
+    if (nbpoints == 0) return Index();
+
+    PointKDTree tree(*points);
+    MeanDistanceFunctor functor;
+    functor.tree = &tree;
+    functor.k = k;
+    functor.meandistances = &*meandistances->begin();
+    parallel_for(nbpoints, functor, PARALLEL_GRAIN / 16);
+
+    double sum = 0, sum2 = 0;
+    for (RealArray::const_iterator it = meandistances->begin(); it != meandistances->end(); ++it){
+        sum += *it;
+        sum2 += *it * *it;
+    }
+    double mean = sum / nbpoints;
+    double deviation = sqrt(std::max(0.0, sum2 / nbpoints - mean * mean));
+    real_t threshold = real_t(mean + stdratio * deviation);
+
+    Index result;
+    uint32_t pid = 0;
+    for (RealArray::const_iterator it = meandistances->begin(); it != meandistances->end(); ++it, ++pid)
+        if (*it <= threshold) result.push_back(pid);
+    return result;
+}
+
+Index PGL::statistical_outlier_filter(const Point3ArrayPtr points, uint32_t k, real_t stdratio)
+{
+    RealArrayPtr meandistances;
+    return statistical_outlier_filter(points, k, stdratio, meandistances);
+}
+
+/* ----------------------------------------------------------------------- */
+
+struct RadiusCountFunctor {
+    const PointKDTree * tree;
+    real_t radius2;
+    uint32_t minneighbors;
+    uchar_t * kept;
+
+    void operator()(size_t begin, size_t end, size_t) {
+        OtherPointFilter filter;
+        for (size_t i = begin; i < end; ++i){
+            uint32_t pid = tree->index[i];
+            filter.pid = pid;
+            kept[pid] = (tree->count_closer(tree->points.getAt(pid), radius2, minneighbors, filter) >= minneighbors);
+        }
+    }
+};
+
+Index PGL::radius_outlier_filter(const Point3ArrayPtr points, real_t radius, uint32_t minneighbors)
+{
+    size_t nbpoints = (points ? points->size() : 0);
+    if (nbpoints == 0) return Index();
+    if (minneighbors == 0) return Index(range<Index>(nbpoints, 0, 1));
+
+    PointKDTree tree(*points);
+    std::vector<uchar_t> kept(nbpoints);
+    RadiusCountFunctor functor;
+    functor.tree = &tree;
+    functor.radius2 = radius * radius;
+    functor.minneighbors = minneighbors;
+    functor.kept = &kept[0];
+    parallel_for(nbpoints, functor, PARALLEL_GRAIN / 16);
+
+    Index result;
+    for (uint32_t pid = 0; pid < nbpoints; ++pid)
+        if (kept[pid]) result.push_back(pid);
+    return result;
+}
+
+/* ----------------------------------------------------------------------- */
@@ -0,0 +1,93 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *  ----------------------------------------------------------------------------
+ */
+
+/*! \file pointfilters.h
+    \brief Subsampling and denoising of point clouds.
+
+    Voxel based filters sort the points by voxel with a parallel radix sort on the voxel keys.
+    Outlier filters query a kd-tree over the points in parallel.
+*/
+
+#ifndef __pointfilters_h__
+#define __pointfilters_h__
+
+#include "../algo_config.h"
+#include <plantgl/scenegraph/container/pointarray.h>
+#include <plantgl/scenegraph/container/indexarray.h>
+#include <plantgl/scenegraph/container/colorarray.h>
+#include <plantgl/tool/util_array.h>
+
+PGL_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/** Subsample points with a grid of cubic voxels of size \e voxelsize. 
+    Return for each non empty voxel the point closest to the mean of its points. 
+    Voxels are ordered by their position in the grid, along x first. */
+ALGO_API Index voxel_downsample(const Point3ArrayPtr points, real_t voxelsize);
+
+/** Subsample points with a grid of cubic voxels as voxel_downsample and compute for each 
+    voxel the mean of its points and their number. If \e colors is given, \e meancolors 
+    receives the mean color of the points of each voxel. */
+ALGO_API Index voxel_downsample(const Point3ArrayPtr points, real_t voxelsize,
+                                Point3ArrayPtr& meanpoints, 
+                                TOOLS(Uint32Array1Ptr)& counts,
+                                const Color4ArrayPtr colors,
+                                Color4ArrayPtr& meancolors);
+
+/// Return the points of each non empty voxel, in the order of voxel_downsample.
+ALGO_API IndexArrayPtr voxel_groups(const Point3ArrayPtr points, real_t voxelsize);
+
+/** Subsample points such that no two selected points are closer than \e radius. 
+    Points are considered in the order of their index in each cell of size \e radius, 
+    and cells are processed in parallel by phases of cells that do not touch each other.
+    The result does not depend on the number of threads. Indices are returned in increasing order. */
+ALGO_API Index poisson_disk_subsample(const Point3ArrayPtr points, real_t radius);
+
+/** Remove the points whose mean distance to their \e k nearest neighbors is greater than 
+    the mean of these distances over all the points plus \e stdratio times their standard deviation.
+    Return the indices of the remaining points in increasing order. */
+ALGO_API Index statistical_outlier_filter(const Point3ArrayPtr points, uint32_t k, real_t stdratio = 1);
+
+/// Same as statistical_outlier_filter. \e meandistances receives the mean distance of each point to its neighbors.
+ALGO_API Index statistical_outlier_filter(const Point3ArrayPtr points, uint32_t k, real_t stdratio,
+                                          TOOLS(RealArrayPtr)& meandistances);
+
+/** Remove the points that have less than \e minneighbors other points closer than \e radius. 
+    Return the indices of the remaining points in increasing order. */
+ALGO_API Index radius_outlier_filter(const Point3ArrayPtr points, real_t radius, uint32_t minneighbors);
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+#endif
@@ -0,0 +1,261 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *  ----------------------------------------------------------------------------
+ */
+
+/*! \file pointkdtree.h
+    \brief A kd-tree over a set of points for nearest neighbor queries without ANN.
+*/
+
+#ifndef __pointkdtree_h__
+#define __pointkdtree_h__
+
+#include "../algo_config.h"
+#include <plantgl/scenegraph/container/pointarray.h>
+#include <algorithm>
+#include <vector>
+
+PGL_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+typedef std::pair<real_t,uint32_t> DistancePoint;
+
+/// Squared distance between a and b, with the coordinates accessed inline.
+inline real_t squared_distance(const TOOLS(Vector3)& a, const TOOLS(Vector3)& b)
+{
+    real_t dx = a[0] - b[0], dy = a[1] - b[1], dz = a[2] - b[2];
+    return dx * dx + dy * dy + dz * dz;
+}
+
+/// Squared distance of p to the box [lower, upper].
+inline real_t box_distance2(const TOOLS(Vector3)& p, const TOOLS(Vector3)& lower, const TOOLS(Vector3)& upper)
+{
+    real_t d2 = 0;
+    for (int i = 0; i < 3; ++i){
+        real_t delta = std::max(lower[i] - p[i], p[i] - upper[i]);
+        if (delta > 0) d2 += delta * delta;
+    }
+    return d2;
+}
+
+/*
+   Kd-tree over a subset of points, split at the median of the largest extent.
+   The first child of a node follows it, the second one is given by its index.
+   The tree refers to the points, which should not be modified without a call to rebuild.
+*/
+struct PointKDTree {
+    // Maximal number of points in a leaf.
+    enum { LeafSize = 8 };
+
+    struct KDNode {
+        real_t split;
+        int axis;       // -1 for leaves
+        uint32_t begin; // range of the points of a leaf
+        uint32_t end;   // second child of an internal node
+    };
+
+    struct CoordinateCompare {
+        const Point3Array * points;
+        int axis;
+        bool operator()(uint32_t a, uint32_t b) const { return points->getAt(a)[axis] < points->getAt(b)[axis]; }
+    };
+
+    const Point3Array& points;
+    std::vector<uint32_t> index;
+    std::vector<KDNode> nodes;
+    TOOLS(Vector3) lower, upper;
+
+    PointKDTree(const Point3Array& _points) : points(_points) {
+        rebuild();
+    }
+
+    PointKDTree(const Point3Array& _points, const std::vector<uint32_t>& subset) : points(_points), index(subset) {
+        init();
+    }
+
+    /// Build again the tree over all the points, after a modification of their positions. Buffers are reused.
+    void rebuild() {
+        index.resize(points.size());
+        for (uint32_t pid = 0; pid < index.size(); ++pid) index[pid] = pid;
+        nodes.clear();
+        init();
+    }
+
+    void init() {
+        if (index.empty()) return;
+        lower = upper = points.getAt(index[0]);
+        for (std::vector<uint32_t>::const_iterator it = index.begin(); it != index.end(); ++it){
+            lower = Min(lower, points.getAt(*it));
+            upper = Max(upper, points.getAt(*it));
+        }
+        nodes.reserve(2 * (index.size() / LeafSize + 1));
+        build(0, index.size(), lower, upper);
+    }
+
+    uint32_t build(uint32_t begin, uint32_t end, const TOOLS(Vector3)& blower, const TOOLS(Vector3)& bupper) {
+        uint32_t nid = nodes.size();
+        nodes.push_back(KDNode());
+        TOOLS(Vector3) extent = bupper - blower;
+        if (end - begin <= LeafSize || normLinf(extent) == 0) {
+            nodes[nid].axis = -1;
+            nodes[nid].begin = begin;
+            nodes[nid].end = end;
+            return nid;
+        }
+        CoordinateCompare cmp;
+        cmp.points = &points;
+        cmp.axis = (extent.x() >= extent.y() ? (extent.x() >= extent.z() ? 0 : 2) : (extent.y() >= extent.z() ? 1 : 2));
+        uint32_t mid = begin + (end - begin) / 2;
+        std::nth_element(index.begin() + begin, index.begin() + mid, index.begin() + end, cmp);
+        real_t split = points.getAt(index[mid])[cmp.axis];
+        TOOLS(Vector3) lupper = bupper, rlower = blower;
+        lupper[cmp.axis] = split;
+        rlower[cmp.axis] = split;
+        build(begin, mid, blower, lupper);
+        uint32_t second = build(mid, end, rlower, bupper);
+        nodes[nid].axis = cmp.axis;
+        nodes[nid].split = split;
+        nodes[nid].begin = begin;
+        nodes[nid].end = second;
+        return nid;
+    }
+
+    // off gives the offsets of p to the cell of the node along each axis, and rd its squared distance to it.
+    template<class Filter>
+    void search(uint32_t nid, const TOOLS(Vector3)& p, uint32_t k, const Filter& filter,
+                std::vector<DistancePoint>& heap, real_t& maxdist2, real_t * off, real_t rd) const {
+        const KDNode& node = nodes[nid];
+        if (node.axis < 0) {
+            for (uint32_t i = node.begin; i < node.end; ++i){
+                uint32_t pid = index[i];
+                if (!filter(pid)) continue;
+                DistancePoint dp(squared_distance(points.getAt(pid),p), pid);
+                if (dp.first >= maxdist2) continue;
+                if (heap.size() < k) { 
+                    heap.push_back(dp); std::push_heap(heap.begin(),heap.end()); 
+                }
+                else {
+                    std::pop_heap(heap.begin(),heap.end());
+                    heap.back() = dp;
+                    std::push_heap(heap.begin(),heap.end());
+                }
+                if (heap.size() == k) maxdist2 = heap.front().first;
+            }
+            return;
+        }
+        real_t diff = p[node.axis] - node.split;
+        uint32_t first = nid + 1, second = node.end;
+        if (diff > 0) std::swap(first,second);
+        search(first, p, k, filter, heap, maxdist2, off, rd);
+        real_t previous = off[node.axis];
+        rd += diff * diff - previous * previous;
+        if (rd < maxdist2) {
+            off[node.axis] = diff;
+            search(second, p, k, filter, heap, maxdist2, off, rd);
+            off[node.axis] = previous;
+        }
+    }
+
+    /** Find the k closest points to p accepted by filter, and closer than sqrt(maxdist2).
+        heap receives them sorted by increasing distance. */
+    template<class Filter>
+    void k_closest(const TOOLS(Vector3)& p, uint32_t k, const Filter& filter,
+                   std::vector<DistancePoint>& heap, real_t maxdist2 = REAL_MAX) const {
+        heap.clear();
+        if (k == 0 || nodes.empty()) return;
+        // distance to the bounding box of the points
+        real_t off[3] = { 0, 0, 0 };
+        real_t d2 = 0;
+        for (int i = 0; i < 3; ++i){
+            real_t delta = std::max(lower[i] - p[i], p[i] - upper[i]);
+            if (delta > 0) { off[i] = delta; d2 += delta * delta; }
+        }
+        if (d2 >= maxdist2) return;
+        search(0, p, k, filter, heap, maxdist2, off, d2);
+        std::sort_heap(heap.begin(),heap.end());
+    }
+
+    template<class Filter>
+    void count(uint32_t nid, const TOOLS(Vector3)& p, real_t maxdist2, uint32_t maxcount, const Filter& filter,
+               uint32_t& result, real_t * off, real_t rd) const {
+        const KDNode& node = nodes[nid];
+        if (node.axis < 0) {
+            for (uint32_t i = node.begin; i < node.end && result < maxcount; ++i){
+                uint32_t pid = index[i];
+                if (filter(pid) && squared_distance(points.getAt(pid),p) < maxdist2) ++result;
+            }
+            return;
+        }
+        real_t diff = p[node.axis] - node.split;
+        uint32_t first = nid + 1, second = node.end;
+        if (diff > 0) std::swap(first,second);
+        count(first, p, maxdist2, maxcount, filter, result, off, rd);
+        if (result >= maxcount) return;
+        real_t previous = off[node.axis];
+        rd += diff * diff - previous * previous;
+        if (rd < maxdist2) {
+            off[node.axis] = diff;
+            count(second, p, maxdist2, maxcount, filter, result, off, rd);
+            off[node.axis] = previous;
+        }
+    }
+
+    /// Count the points accepted by filter closer than sqrt(maxdist2) to p. Counting stops at maxcount.
+    template<class Filter>
+    uint32_t count_closer(const TOOLS(Vector3)& p, real_t maxdist2, uint32_t maxcount, const Filter& filter) const {
+        uint32_t result = 0;
+        if (maxcount == 0 || nodes.empty()) return result;
+        real_t off[3] = { 0, 0, 0 };
+        real_t d2 = 0;
+        for (int i = 0; i < 3; ++i){
+            real_t delta = std::max(lower[i] - p[i], p[i] - upper[i]);
+            if (delta > 0) { off[i] = delta; d2 += delta * delta; }
+        }
+        if (d2 >= maxdist2) return result;
+        count(0, p, maxdist2, maxcount, filter, result, off, d2);
+        return result;
+    }
+};
+
+struct OtherPointFilter {
+    uint32_t pid;
+    inline bool operator()(uint32_t i) const { return i != pid; }
+};
+
+struct AllPointFilter {
+    inline bool operator()(uint32_t) const { return true; }
+};
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+#endif
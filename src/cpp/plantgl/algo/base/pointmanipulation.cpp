@@ -31,7 +31,10 @@
 
 
 #include "pointmanipulation.h"
+#include "eigenkernels.h"
+#include "kmeansclustering.h"
 #include <plantgl/scenegraph/container/indexarray_iterator.h>
+#include <plantgl/tool/util_parallel.h>
 #include <stdio.h>
 
 PGL_USING_NAMESPACE
@@ -57,6 +60,11 @@ void PGL::unregister_progressstatus_func()
     PSFUNC = progressprint;
 }
 
+void PGL::print_progressstatus(const char * msg, float percent)
+{
+    PSFUNC(msg,percent);
+}
+
 
 
 class ProgressStatus {
@@ -71,22 +79,22 @@ public:
     inline ProgressStatus & operator ++()  { increment(); return *this; }
 
     void increment(uint32_t inc = 1) { 
-        current += inc; 
-        if (current <= nbsteps){
-            if (current == nbsteps){
-                    std::string msg("\x0d");
-                    msg += message;
-                    msg += "\n";
-                    PSFUNC(msg.c_str(),100.0);
-            }
-            else {
-                real_t ncpercent = 100 * current / float(nbsteps);
-                if(cpercent +  percenttoprint <= ncpercent ) {
-                    std::string msg("\x0d");
-                    msg += message;
-                    PSFUNC(msg.c_str(),ncpercent);
-                    cpercent = ncpercent;
-                }
+        if (current >= nbsteps) return;
+        // Increments by several steps do not go past the last one.
+        current = std::min(current + inc, nbsteps); 
+        if (current == nbsteps){
+                std::string msg("\x0d");
+                msg += message;
+                msg += "\n";
+                PSFUNC(msg.c_str(),100.0);
+        }
+        else {
+            real_t ncpercent = 100 * current / float(nbsteps);
+            if(cpercent +  percenttoprint <= ncpercent ) {
+                std::string msg("\x0d");
+                msg += message;
+                PSFUNC(msg.c_str(),ncpercent);
+                cpercent = ncpercent;
             }
         }
     }
@@ -100,32 +108,46 @@ protected:
 };
 
 
-struct PointSorter {
-    PointSorter(Point3ArrayPtr _points, uint32_t _ref) : points(_points), refpoint(_points->getAt(_ref)) {}
-    Point3ArrayPtr points;
-    const Vector3& refpoint;
-
-    bool operator()(uint32_t i, uint32_t j){
-        return norm(refpoint-points->getAt(i)) <  norm(refpoint-points->getAt(j));  
+// Keep the k closest neighbors of each point in rows of Delaunay neighbors.
+struct DelaunayKClosestFunctor {
+    const Point3Array * points;
+    const uint32_t * offsets;
+    const uint32_t * neighbors;
+    size_t k;
+    IndexArray * result;
+
+    void operator()(size_t begin, size_t end, size_t) {
+        std::vector<std::pair<real_t,uint32_t> > candidates;
+        for (size_t pid = begin; pid < end; ++pid){
+            const Vector3& refpoint = points->getAt(pid);
+            candidates.clear();
+            for (uint32_t i = offsets[pid]; i < offsets[pid+1]; ++i)
+                candidates.push_back(std::pair<real_t,uint32_t>(normSquared(points->getAt(neighbors[i]) - refpoint), neighbors[i]));
+            size_t nb = std::min(k, candidates.size());
+            std::partial_sort(candidates.begin(), candidates.begin() + nb, candidates.end());
+            Index& row = result->getAt(pid);
+            row.reserve(nb);
+            for (size_t i = 0; i < nb; ++i) row.push_back(candidates[i].second);
+        }
     }
 };
 
- IndexArrayPtr 
+IndexArrayPtr 
 PGL::k_closest_points_from_delaunay(const Point3ArrayPtr points, size_t k)
 {
-    IndexArrayPtr res = delaunay_point_connection(points);
-    IndexArrayPtr filteredres(new IndexArray(res->size()));
-    IndexArray::iterator ittarget = filteredres->begin();
-    uint32_t pointid = 0;
-    for (IndexArray::iterator it = res->begin(); it != res->end(); ++it, ++ittarget){
-        if (it->size() <= k) *ittarget = *it;
-        else {
-            std::sort(it->begin(), it->end(),PointSorter(points,pointid));
-            *ittarget = Index(it->begin(),it->begin()+k);
-        }
-        ++pointid;
-    }
-    return filteredres;
+    Uint32Array1Ptr offsets, neighbors;
+    if (!delaunay_point_connection(points, offsets, neighbors)) return IndexArrayPtr();
+
+    IndexArrayPtr result(new IndexArray(points->size()));
+    if (neighbors->empty()) return result;
+    DelaunayKClosestFunctor functor;
+    functor.points = points.get();
+    functor.offsets = &*offsets->begin();
+    functor.neighbors = &*neighbors->begin();
+    functor.k = k;
+    functor.result = result.get();
+    parallel_for(points->size(), functor, 1024);
+    return result;
 }
 
 
@@ -738,41 +760,48 @@ PGL::pointset_max_radial_distance(  const Vector3& origin,
     return max_distance;
 }
 
+/*
+   Sums of the products of coordinates of the points, accumulated by chunks
+   in parallel and combined in chunk order.
+*/
+struct CovarianceSum {
+    const Point3Array& points;
+    const Index& group;
+    std::vector<SymmetricMatrix3> sums;
+
+    CovarianceSum(const Point3Array& _points, const Index& _group) : points(_points), group(_group) { }
+
+    void operator()(size_t begin, size_t end, size_t chunk) {
+        SymmetricMatrix3 s = { 0, 0, 0, 0, 0, 0 };
+        for(size_t i = begin; i < end; ++i){
+            const Vector3& v = points.getAt(group.empty() ? i : group[i]);
+            s.xx += v.x() * v.x(); s.xy += v.x() * v.y(); s.xz += v.x() * v.z();
+            s.yy += v.y() * v.y(); s.yz += v.y() * v.z(); s.zz += v.z() * v.z();
+        }
+        sums[chunk] = s;
+    }
+};
+
 Matrix3 
 PGL::pointset_covariance(const Point3ArrayPtr points,  const Index& group)
 {
-    Matrix3 result(0,0,0,0,0,0,0,0,0);
-    if (group.empty()){
-        for (Point3Array::const_iterator it = points->begin(); it != points->end(); ++it){
-            const Vector3& v = *it;
-            result(0,0) += v.x() * v.x();
-            result(0,1) += v.x() * v.y();
-            result(0,2) += v.x() * v.z();
-            result(1,0) += v.y() * v.x();
-            result(1,1) += v.y() * v.y();
-            result(1,2) += v.y() * v.z();
-            result(2,0) += v.z() * v.x();
-            result(2,1) += v.z() * v.y();
-            result(2,2) += v.z() * v.z();
-        }
-        result /= points->size();
-    }
-    else {
-        for (Index::const_iterator it = group.begin(); it != group.end(); ++it){
-            const Vector3& v = points->getAt(*it);
-            result(0,0) += v.x() * v.x();
-            result(0,1) += v.x() * v.y();
-            result(0,2) += v.x() * v.z();
-            result(1,0) += v.y() * v.x();
-            result(1,1) += v.y() * v.y();
-            result(1,2) += v.y() * v.z();
-            result(2,0) += v.z() * v.x();
-            result(2,1) += v.z() * v.y();
-            result(2,2) += v.z() * v.z();
-        }
-        result /= group.size();
+    size_t nbpoints = group.empty() ? points->size() : group.size();
+    if (nbpoints == 0) return Matrix3(0,0,0,0,0,0,0,0,0);
+
+    CovarianceSum sum(*points,group);
+    sum.sums.resize(parallel_chunk_count(nbpoints,4096));
+    parallel_for(nbpoints,sum,4096);
+
+    SymmetricMatrix3 s = { 0, 0, 0, 0, 0, 0 };
+    for(std::vector<SymmetricMatrix3>::const_iterator it = sum.sums.begin(); it != sum.sums.end(); ++it){
+        s.xx += it->xx; s.xy += it->xy; s.xz += it->xz;
+        s.yy += it->yy; s.yz += it->yz; s.zz += it->zz;
     }
-    return result;
+    real_t xx = s.xx / nbpoints, xy = s.xy / nbpoints, xz = s.xz / nbpoints;
+    real_t yy = s.yy / nbpoints, yz = s.yz / nbpoints, zz = s.zz / nbpoints;
+    return Matrix3(xx, xy, xz,
+                   xy, yy, yz,
+                   xz, yz, zz);
 }
 
 
@@ -1691,7 +1720,7 @@ Point3ArrayPtr PGL::optimize_positions(const Point3ArrayPtr points,
 }
 
 
-#include <plantgl/scenegraph/geometry/lineicmodel.h>
+#include <plantgl/algo/grid/capsuletree.h>
 
 real_t 
 PGL::average_radius(const Point3ArrayPtr points, 
@@ -1699,47 +1728,17 @@ PGL::average_radius(const Point3ArrayPtr points,
                       const TOOLS(Uint32Array1Ptr) parents,
                       uint32_t maxclosestnode)
 {
-#ifdef WITH_ANN
-    uint32_t root;
-    IndexArrayPtr children = determine_children(parents, root);
-
     uint32_t nb_nodes = nodes->size();
     if (nb_nodes == 0) return REAL_MAX;
-    if (maxclosestnode >= nb_nodes) maxclosestnode = nb_nodes;
+    uint32_t nbPoints = points->size();
+    if (nbPoints == 0) return 0;
+    CapsuleTree tree(nodes, parents);
+    std::vector<real_t> distances(nbPoints);
+    tree.closest_capsules(*points, &distances[0], NULL, NULL, CapsuleTree::eAxisDistance);
     real_t sum_min_dist = 0;
-    uint32_t nb_samples = 0;
-    ANNKDTree3 tree(nodes);
-    for (Point3Array::const_iterator itp = points->begin(); itp != points->end(); ++itp)
-    {
-        real_t minpdist = REAL_MAX;
-        Index nids = tree.k_closest_points(*itp,maxclosestnode);
-        for(Index::const_iterator nit = nids.begin(); nit != nids.end(); ++nit){
-
-            Vector3 point(*itp);
-            real_t d = closestPointToSegment(point,nodes->getAt(*nit),nodes->getAt(parents->getAt(*nit)));
-            if (d < minpdist) minpdist = d;
-
-            for (Index::const_iterator nitc = children->getAt(*nit).begin(); nitc != children->getAt(*nit).end(); ++nitc){
-                Vector3 mpoint(*itp);
-                d = closestPointToSegment(mpoint,nodes->getAt(*nit),nodes->getAt(*nitc));
-                if (d < minpdist) minpdist = d;
-            }
-        }
-        if (minpdist != REAL_MAX) {
-            sum_min_dist += minpdist;
-            nb_samples += 1;
-        }
-    }
-    return sum_min_dist / nb_samples;
-#else
-    #ifdef _MSC_VER
-    #pragma message("function 'average_radius' disabled. ANN needed.")
-    #else
-    #warning "function 'average_radius' disabled. ANN needed"
-    #endif
-
-    return 0;
-#endif
+    for (std::vector<real_t>::const_iterator itd = distances.begin(); itd != distances.end(); ++itd)
+        sum_min_dist += *itd;
+    return sum_min_dist / nbPoints;
 }
 
 real_t PGL::average_distance_to_shape(const Point3ArrayPtr points, 
@@ -1748,55 +1747,17 @@ real_t PGL::average_distance_to_shape(const Point3ArrayPtr points,
                                           const TOOLS(RealArrayPtr) radii,
                                           uint32_t maxclosestnodes)
 {
-#ifdef WITH_ANN
-    uint32_t root;
-    IndexArrayPtr children = determine_children(parents, root);
-
     uint32_t nb_nodes = nodes->size();
     if (nb_nodes == 0) return REAL_MAX;
-    if (maxclosestnodes >= nb_nodes) maxclosestnodes = nb_nodes;
+    uint32_t nbPoints = points->size();
+    if (nbPoints == 0) return 0;
+    CapsuleTree tree(nodes, parents, radii);
+    std::vector<real_t> distances(nbPoints);
+    tree.closest_capsules(*points, &distances[0], NULL, NULL, CapsuleTree::eSignedDistance);
     real_t sum_min_dist = 0;
-    uint32_t nb_samples = 0;
-    ANNKDTree3 tree(nodes);
-    ProgressStatus st(points->size(),"distance to shape for %.2f%% of points.");
-
-    for (Point3Array::const_iterator itp = points->begin(); itp != points->end(); ++itp, ++st)
-    {
-        real_t minpdist = REAL_MAX;
-        Index nids = tree.k_closest_points(*itp,maxclosestnodes);
-        for(Index::const_iterator nit = nids.begin(); nit != nids.end(); ++nit){
-
-            Vector3 point(*itp);
-            real_t u;
-            uint32_t parent = parents->getAt(*nit);
-            real_t d = closestPointToSegment(point,nodes->getAt(*nit),nodes->getAt(parent),&u);
-            real_t r = radii->getAt(parent) * u + radii->getAt(*nit) * (1 - u);
-            d -= r;
-            if (d < minpdist) minpdist = d;
-
-            for (Index::const_iterator nitc = children->getAt(*nit).begin(); nitc != children->getAt(*nit).end(); ++nitc){
-                Vector3 mpoint(*itp);
-                d = closestPointToSegment(mpoint,nodes->getAt(*nit),nodes->getAt(*nitc),&u);
-                real_t r = radii->getAt(*nitc) * u + radii->getAt(*nit) * (1 - u);
-                d -= r;
-                if (d < minpdist) minpdist = d;
-            }
-        }
-        if (minpdist != REAL_MAX) {
-            sum_min_dist += minpdist;
-            nb_samples += 1;
-        }
-    }
-    return sum_min_dist / nb_samples;
-#else
-    #ifdef _MSC_VER
-    #pragma message("function 'average_distance_to_shape' disabled. ANN needed.")
-    #else
-    #warning "function 'average_distance_to_shape' disabled. ANN needed"
-    #endif
-
-    return 0;
-#endif
+    for (std::vector<real_t>::const_iterator itd = distances.begin(); itd != distances.end(); ++itd)
+        sum_min_dist += *itd;
+    return sum_min_dist / nbPoints;
 }
 
 TOOLS(RealArrayPtr) PGL::distance_to_shape(const Point3ArrayPtr points, 
@@ -1805,53 +1766,10 @@ TOOLS(RealArrayPtr) PGL::distance_to_shape(const Point3ArrayPtr points,
                                           const TOOLS(RealArrayPtr) radii,
                                           uint32_t maxclosestnodes)
 {
-#ifdef WITH_ANN
-    uint32_t root;
-    IndexArrayPtr children = determine_children(parents, root);
-
     uint32_t nb_nodes = nodes->size();
     if (nb_nodes == 0) return RealArrayPtr();
-    if (maxclosestnodes >= nb_nodes) maxclosestnodes = nb_nodes;
-    uint32_t nbPoints = points->size();
-    RealArrayPtr result(new RealArray(nbPoints));
-    uint32_t pid = 0;
-    ANNKDTree3 tree(nodes);
-    ProgressStatus st(nbPoints,"distance to shape for %.2f%% of points.");
-
-    for (Point3Array::const_iterator itp = points->begin(); itp != points->end(); ++itp, ++pid, ++st)
-    {
-        real_t minpdist = REAL_MAX;
-        Index nids = tree.k_closest_points(*itp,maxclosestnodes);
-        for(Index::const_iterator nit = nids.begin(); nit != nids.end(); ++nit){
-
-            Vector3 point(*itp);
-            real_t u;
-            uint32_t parent = parents->getAt(*nit);
-            real_t d = closestPointToSegment(point,nodes->getAt(*nit),nodes->getAt(parent),&u);
-            real_t r = radii->getAt(parent) * u + radii->getAt(*nit) * (1 - u);
-            d = fabs(d-r);
-            if (d < minpdist) minpdist = d;
-
-            for (Index::const_iterator nitc = children->getAt(*nit).begin(); nitc != children->getAt(*nit).end(); ++nitc){
-                Vector3 mpoint(*itp);
-                d = closestPointToSegment(mpoint,nodes->getAt(*nit),nodes->getAt(*nitc),&u);
-                real_t r = radii->getAt(*nitc) * u + radii->getAt(*nit) * (1 - u);
-                d = fabs(d-r);
-                if (d < minpdist) minpdist = d;
-            }
-        }
-        result->getAt(pid) = minpdist;
-    }
-    return result;
-#else
-    #ifdef _MSC_VER
-    #pragma message("function 'distance_to_shape' disabled. ANN needed.")
-    #else
-    #warning "function 'distance_to_shape' disabled. ANN needed"
-    #endif
-
-    return 0;
-#endif
+    CapsuleTree tree(nodes, parents, radii);
+    return tree.distances(points, CapsuleTree::eAbsoluteDistance);
 }
 
 TOOLS(RealArrayPtr) PGL::estimate_radii_from_points(const Point3ArrayPtr points, 
@@ -1860,53 +1778,25 @@ TOOLS(RealArrayPtr) PGL::estimate_radii_from_points(const Point3ArrayPtr points,
                                                     bool maxmethod,
                                                     uint32_t maxclosestnodes)
 {
-#ifdef WITH_ANN
-    uint32_t root;
-    IndexArrayPtr children = determine_children(parents, root);
-
     uint32_t nb_nodes = nodes->size();
     if (nb_nodes == 0) return RealArrayPtr();
-    if (maxclosestnodes >= nb_nodes) maxclosestnodes = nb_nodes;
     uint32_t nbPoints = points->size();
     RealArrayPtr result(new RealArray(nb_nodes));
     Uint32Array1Ptr resultnb(new Uint32Array1(nb_nodes));
-    uint32_t pid = 0;
-    ANNKDTree3 tree(nodes);
-    ProgressStatus st(nbPoints,"distance to shape for %.2f%% of points.");
 
-    for (Point3Array::const_iterator itp = points->begin(); itp != points->end(); ++itp, ++pid, ++st)
-    {
-        real_t minpdist = REAL_MAX;
-        Index nids = tree.k_closest_points(*itp,maxclosestnodes);
-        uint32_t nid1 = 0, nid2 = 0;
-        real_t posu = 0;
-        for(Index::const_iterator nit = nids.begin(); nit != nids.end(); ++nit){
-
-            Vector3 point(*itp);
-            real_t u;
-            uint32_t parent = parents->getAt(*nit);
-            real_t d = closestPointToSegment(point,nodes->getAt(*nit),nodes->getAt(parent),&u);
-            if (d < minpdist) {
-                minpdist = d;
-                nid1 = *nit;
-                nid2 = parent;
-                posu = u;
-            }
+    CapsuleTree tree(nodes, parents);
+    std::vector<real_t> distances(nbPoints), us(nbPoints);
+    std::vector<uint32_t> capsules(nbPoints);
+    if (nbPoints > 0) tree.closest_capsules(*points, &distances[0], &capsules[0], &us[0], CapsuleTree::eAxisDistance);
 
-            for (Index::const_iterator nitc = children->getAt(*nit).begin(); nitc != children->getAt(*nit).end(); ++nitc){
-                Vector3 mpoint(*itp);
-                d = closestPointToSegment(mpoint,nodes->getAt(*nit),nodes->getAt(*nitc),&u);
-                if (d < minpdist) {
-                    minpdist = d;
-                    nid1 = *nit;
-                    nid2 = *nitc;
-                    posu = u;
-                }
-            }
-        }
-        if (posu > 0.5){
-            nid1 = nid2;
+    for (uint32_t pid = 0; pid < nbPoints; ++pid)
+    {
+        // a point contributes to the closest extremity of its capsule
+        uint32_t nid1 = capsules[pid];
+        if (us[pid] > 0.5){
+            nid1 = parents->getAt(nid1);
         }
+        real_t minpdist = distances[pid];
         if (maxmethod)
             result->getAt(nid1) = std::max(result->getAt(nid1),minpdist);
         else {
@@ -1917,24 +1807,10 @@ TOOLS(RealArrayPtr) PGL::estimate_radii_from_points(const Point3ArrayPtr points,
     if(!maxmethod) {
         Uint32Array1::const_iterator itresnb = resultnb->begin();
         for (RealArray::iterator itres = result->begin(); itres != result->end(); ++itres, ++itresnb)
-            *itres /= *itresnb;
+            if (*itresnb > 0) *itres /= *itresnb;
     }
 
     return result;
-#else
-    #ifdef _MSC_VER
-    #pragma message("function 'estimate_radii_from_points' disabled. ANN needed.")
-    #else
-    #warning "function 'distance_to_shape' disabled. ANN needed"
-    #endif
-
-    return 0;
-#endif
-}
-
-inline bool distance_test ( real_t d, real_t distance, bool reversed){
-    if (reversed) return d > distance;
-    else return d < distance;
 }
 
 Index PGL::points_at_distance_from_skeleton(const Point3ArrayPtr points, 
@@ -1943,120 +1819,37 @@ Index PGL::points_at_distance_from_skeleton(const Point3ArrayPtr points,
                                                 real_t distance,
                                                 uint32_t maxclosestnodes)
 {
-#ifdef WITH_ANN
-    Index result;
-    uint32_t root;
-    IndexArrayPtr children = determine_children(parents, root);
-
     uint32_t nb_nodes = nodes->size();
     if (nb_nodes == 0) return range<Index>(0,points->size(),1);
 
-    if (maxclosestnodes >= nb_nodes) maxclosestnodes = nb_nodes;
-
     bool reversed = false;
     if (distance < 0) {
         distance = - distance;
         reversed = true;
     }
 
-    
-    ANNKDTree3 tree(nodes);
-
-    size_t pid = 0;
-    for (Point3Array::const_iterator itp = points->begin(); itp != points->end(); ++itp, ++pid)
-    {
-        real_t minpdist = REAL_MAX;
-        Index nids = tree.k_closest_points(*itp,maxclosestnodes);
-        bool ok = false;
-        for(Index::const_iterator nit = nids.begin(); !ok && nit != nids.end(); ++nit){
-
-            Vector3 point(*itp);
-            real_t d = closestPointToSegment(point,nodes->getAt(*nit),nodes->getAt(parents->getAt(*nit)));
-            if (d < distance) { 
-                ok = true; 
-                if(!reversed) result.push_back(pid); 
-                continue;
-            }
-
-            for (Index::const_iterator nitc = children->getAt(*nit).begin(); nitc != children->getAt(*nit).end(); ++nitc){
-                Vector3 mpoint(*itp);
-                d = closestPointToSegment(mpoint,nodes->getAt(*nit),nodes->getAt(*nitc));
-                if (d < distance) { 
-                    ok = true; 
-                    if(!reversed) result.push_back(pid); 
-                    continue;
-                }
-            }
-            if (ok) continue;
-        }
-        if(!ok && reversed) result.push_back(pid); 
-    }
-    return result;
-#else
-    #ifdef _MSC_VER
-    #pragma message("function 'points_at_distance_from_skeleton' disabled. ANN needed.")
-    #else
-    #warning "function 'points_at_distance_from_skeleton' disabled. ANN needed"
-    #endif
-
-    return Index();
-#endif
+    CapsuleTree tree(nodes, parents);
+    return tree.points_at_distance(points, distance, CapsuleTree::eAxisDistance, reversed);
 }
 
 IndexArrayPtr PGL::cluster_points(const Point3ArrayPtr points, const Point3ArrayPtr clustercentroid)
 {
-    IndexArrayPtr result(new IndexArray(clustercentroid->size()));
-
-#ifdef WITH_ANN
-    ANNKDTree3 centroids(clustercentroid);
-#else
-    Point3GridPtr centroids(new Point3Grid(clustercentroid,20));
-#endif   
-
-    size_t pid = 0;
-    for (Point3Array::const_iterator itp = points->begin(); itp != points->end(); ++itp, ++pid)
-    {
-        real_t minpdist = REAL_MAX;
-#ifdef WITH_ANN
-        Index nids = centroids.k_closest_points(*itp,1);
-        result->getAt(nids[0]).push_back(pid);
-#else
-        size_t pidclosest;
-        if( centroids->closest_point(*itp, pidclosest) )
-            result->getAt(pidclosest).push_back(pid);
-#endif   
-
-    }
-
-    return result;
+    // one cluster per centroid, even without point or centroid
+    if (!clustercentroid || clustercentroid->empty() || !points || points->empty())
+        return IndexArrayPtr(new IndexArray(clustercentroid ? clustercentroid->size() : 0));
+    KMeansClustering clustering;
+    clustering.assign(points, clustercentroid);
+    return clustering.getClusters();
 }
 
 Uint32Array1Ptr PGL::points_clusters(const Point3ArrayPtr points, const Point3ArrayPtr clustercentroid)
 {
-    Uint32Array1Ptr result(new Uint32Array1(points->size()));
-
-#ifdef WITH_ANN
-    ANNKDTree3 centroids(clustercentroid);
-#else
-    Point3GridPtr centroids(new Point3Grid(clustercentroid,20));
-#endif   
-
-    size_t pid = 0;
-    for (Point3Array::const_iterator itp = points->begin(); itp != points->end(); ++itp, ++pid)
-    {
-        real_t minpdist = REAL_MAX;
-#ifdef WITH_ANN
-        Index nids = centroids.k_closest_points(*itp,1);
-        result->setAt(pid,nids[0]);
-#else
-        size_t pidclosest;
-        if( centroids->closest_point(*itp, pidclosest) )
-            result->setAt(pid,pidclosest);
-#endif   
-
-    }
-
-    return result;
+    // without centroid, all points are assigned to 0
+    if (!clustercentroid || clustercentroid->empty() || !points || points->empty())
+        return Uint32Array1Ptr(new Uint32Array1(points ? points->size() : 0));
+    KMeansClustering clustering;
+    clustering.assign(points, clustercentroid);
+    return clustering.getAssignments();
 }
 
 TOOLS(RealArrayPtr) 
@@ -2739,17 +2532,33 @@ PGL::pointset_angulardirections(const Point3ArrayPtr points, const TOOLS(Vector3
     return result;
 }
 
-Point3ArrayPtr PGL::pointsets_orientations(const Point3ArrayPtr points, const IndexArrayPtr groups)
+/*
+   The orientations are computed in parallel by steps of groups,
+   after each of which the progress is printed.
+*/
+static Point3ArrayPtr pointsets_orientations_with_progress(const Point3ArrayPtr points, const IndexArrayPtr groups, Point3Array * features)
 {
-    size_t nbPoints = points->size();
-    Point3ArrayPtr result(new Point3Array(nbPoints));
+    size_t nbGroups = groups->size();
+    Point3ArrayPtr result(new Point3Array(nbGroups));
+    const size_t step = 16384;
+    ProgressStatus st(nbGroups, "orientations computed for %.2f%% of points.");
+    for(size_t begin = 0; begin < nbGroups; begin += step){
+        size_t end = std::min(begin + step, nbGroups);
+        pointsets_principal_axes(points, groups, begin, end, NULL, result.get(), NULL, features);
+        st.increment(end - begin);
+    }
+    return result;
+}
 
-    ProgressStatus st(nbPoints, "orientations computed for %.2f%% of points.");
-    IndexArray::const_iterator itNbrhd = groups->begin();
-    for(Point3Array::iterator itRes = result->begin(); itRes != result->end(); ++itRes, ++itNbrhd, ++st)
-        *itRes = pointset_orientation(points,*itNbrhd);
+Point3ArrayPtr PGL::pointsets_orientations(const Point3ArrayPtr points, const IndexArrayPtr groups)
+{
+    return pointsets_orientations_with_progress(points, groups, NULL);
+}
 
-    return result;
+Point3ArrayPtr PGL::pointsets_orientations(const Point3ArrayPtr points, const IndexArrayPtr groups, Point3ArrayPtr& features)
+{
+    features = Point3ArrayPtr(new Point3Array(groups->size()));
+    return pointsets_orientations_with_progress(points, groups, features.get());
 }
 
 std::pair<uint32_t,real_t> 
@@ -85,6 +85,9 @@ ALGO_API void register_progressstatus_func(progressstatusfunction func);
 
 ALGO_API void unregister_progressstatus_func();
 
+// display a progress message with the registered function
+ALGO_API void print_progressstatus(const char * msg, float percent);
+
 
 // typedef std::vector<std::vector<uint32_t> > AdjacencyMap;
 
@@ -92,6 +95,13 @@ ALGO_API void unregister_progressstatus_func();
 ALGO_API IndexArrayPtr 
 delaunay_point_connection(const Point3ArrayPtr points);
 
+/** Delaunay edges of points in compressed rows : the neighbors of the point i are neighbors[offsets[i]] to neighbors[offsets[i+1]-1], 
+    in increasing order. Returns false if CGAL is not available. */
+ALGO_API bool
+delaunay_point_connection(const Point3ArrayPtr points, 
+                          TOOLS(Uint32Array1Ptr)& offsets, 
+                          TOOLS(Uint32Array1Ptr)& neighbors);
+
 ALGO_API Index3ArrayPtr 
 delaunay_triangulation(const Point3ArrayPtr points);
 
@@ -266,12 +276,21 @@ pointset_orientation(const Point3ArrayPtr points, const Index& group);
 ALGO_API Point3ArrayPtr 
 pointsets_orientations(const Point3ArrayPtr points, const IndexArrayPtr groups);
 
+/// Orientations of the groups, with their shape features (linearity, planarity, sphericity) computed in the same pass.
+ALGO_API Point3ArrayPtr 
+pointsets_orientations(const Point3ArrayPtr points, const IndexArrayPtr groups, Point3ArrayPtr& features);
+
 ALGO_API TOOLS(Vector3) 
 pointset_normal(const Point3ArrayPtr points, const Index& group);
 
+/// Normals of the groups, i.e. their directions of smallest variance. The result has one normal per group, not per point.
 ALGO_API Point3ArrayPtr 
 pointsets_normals(const Point3ArrayPtr points, const IndexArrayPtr groups);
 
+/// Normals of the groups, with their shape features (linearity, planarity, sphericity) computed in the same pass.
+ALGO_API Point3ArrayPtr 
+pointsets_normals(const Point3ArrayPtr points, const IndexArrayPtr groups, Point3ArrayPtr& features);
+
 
 ALGO_API Point3ArrayPtr 
 pointsets_orient_normals(const Point3ArrayPtr normals, const Point3ArrayPtr points, const IndexArrayPtr riemanian);
@@ -450,6 +469,7 @@ Point3ArrayPtr  centroids_of_groups(const Point3ArrayPtr points,
     return result;
 }
 
+// Assign each point to its closest centroid. cluster_points gives one list of points per centroid.
 ALGO_API IndexArrayPtr cluster_points(const Point3ArrayPtr points, const Point3ArrayPtr clustercentroid);
 ALGO_API TOOLS(Uint32Array1Ptr) points_clusters(const Point3ArrayPtr points, const Point3ArrayPtr clustercentroid);
 
@@ -493,6 +513,11 @@ ALGO_API Point3ArrayPtr optimize_positions(const Point3ArrayPtr points,
                                            const TOOLS(Uint32Array1Ptr) parents, 
                                            const TOOLS(RealArrayPtr) weights);
 
+// Distances to the skeleton are computed exactly with a CapsuleTree over its segments.
+// They were previously searched among the segments of the maxclosestnodes closest nodes,
+// which needed ANN. maxclosestnodes is kept for compatibility and is no longer used.
+// Averages over an empty set of points are 0.
+
 // estimate average radius around edges
 ALGO_API real_t average_radius(const Point3ArrayPtr points, 
                                const Point3ArrayPtr nodes,
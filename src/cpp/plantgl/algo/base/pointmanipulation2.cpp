@@ -31,7 +31,9 @@
 
 
 #include "pointmanipulation.h"
+#include "eigenkernels.h"
 #include <plantgl/scenegraph/container/indexarray_iterator.h>
+#include <plantgl/tool/util_parallel.h>
 
 PGL_USING_NAMESPACE
 TOOLS_USING_NAMESPACE
@@ -72,39 +74,85 @@ TOOLS_USING_NAMESPACE
 
 #endif
 
-IndexArrayPtr 
-PGL::delaunay_point_connection(const Point3ArrayPtr points)
-{
 #ifdef WITH_CGAL
 
-    typedef CGAL::Exact_predicates_inexact_constructions_kernel         TK;
-    typedef CGAL::Triangulation_vertex_base_with_info_3<uint32_t, TK>   TVb;
-    typedef CGAL::Triangulation_data_structure_3<TVb>                    Tds;
-
-    typedef CGAL::Delaunay_triangulation_3<TK, Tds>                      Triangulation;
-    // typedef CGAL::Triangulation_3<K,Tds>      Triangulation;
+typedef CGAL::Exact_predicates_inexact_constructions_kernel         DK;
+typedef CGAL::Triangulation_vertex_base_with_info_3<uint32_t, DK>   DVb;
+typedef CGAL::Triangulation_data_structure_3<DVb>                   DTds;
+typedef CGAL::Delaunay_triangulation_3<DK, DTds>                    DelaunayTriangulation;
+
+/* 
+   Insert points in triangulation with their index as info of their vertex. 
+   Points are inserted as a range that CGAL sorts along a Hilbert curve first, so that 
+   each point is located from the previous one. Duplicated points are represented only 
+   by their first occurrence.
+*/
+static void delaunay_insert(DelaunayTriangulation& triangulation, const Point3ArrayPtr points)
+{
+    typedef std::pair<DelaunayTriangulation::Point, uint32_t> IndexedPoint;
+    std::vector<IndexedPoint> input;
+    input.reserve(points->size());
+    uint32_t pointCount = 0;
+    for (Point3Array::const_iterator it = points->begin(); it != points->end(); ++it)
+        input.push_back(IndexedPoint(toPoint3<DelaunayTriangulation::Point>(*it), pointCount++));
+    triangulation.insert(input.begin(), input.end());
+}
 
+#endif
 
-    typedef Triangulation::Cell_handle    TCell_handle;
-    typedef Triangulation::Vertex_handle  TVertex_handle;
-    typedef Triangulation::Locate_type    TLocate_type;
-    typedef Triangulation::Point          TPoint;
-    typedef Triangulation::Segment        TSegment;
+struct SortRowsFunctor {
+    const uint32_t * offsets;
+    uint32_t * neighbors;
 
-    Triangulation triangulation;
-    uint32_t pointCount = 0;
-    for (Point3Array::const_iterator it = points->begin(); it != points->end(); ++it)
-        triangulation.insert(toPoint3<TPoint>(*it))->info() = pointCount++;
+    void operator()(size_t begin, size_t end, size_t) {
+        for (size_t pid = begin; pid < end; ++pid)
+            std::sort(neighbors + offsets[pid], neighbors + offsets[pid+1]);
+    }
+};
 
+bool
+PGL::delaunay_point_connection(const Point3ArrayPtr points,
+                               TOOLS(Uint32Array1Ptr)& offsets,
+                               TOOLS(Uint32Array1Ptr)& neighbors)
+{
+#ifdef WITH_CGAL
+    size_t nbpoints = points->size();
+    offsets = Uint32Array1Ptr(new Uint32Array1(nbpoints + 1, 0));
+    {
+        DelaunayTriangulation triangulation;
+        delaunay_insert(triangulation, points);
+
+        // the edges are read twice, to count the neighbors of each point and to fill the rows
+        uint32_t * rows = &*offsets->begin();
+        for(DelaunayTriangulation::Finite_edges_iterator it = triangulation.finite_edges_begin();
+            it != triangulation.finite_edges_end(); ++it){
+                ++rows[it->first->vertex(it->second)->info() + 1];
+                ++rows[it->first->vertex(it->third)->info() + 1];
+        }
+        for (size_t pid = 1; pid <= nbpoints; ++pid) rows[pid] += rows[pid-1];
+        neighbors = Uint32Array1Ptr(new Uint32Array1(rows[nbpoints]));
+
+        if (!neighbors->empty()) {
+            std::vector<uint32_t> cursor(offsets->begin(), offsets->end() - 1);
+            uint32_t * target = &*neighbors->begin();
+            for(DelaunayTriangulation::Finite_edges_iterator it = triangulation.finite_edges_begin();
+                it != triangulation.finite_edges_end(); ++it){
+                    uint32_t source = it->first->vertex(it->second)->info();
+                    uint32_t dest = it->first->vertex(it->third)->info();
+                    target[cursor[source]++] = dest;
+                    target[cursor[dest]++] = source;
+            }
+        }
+    }
 
-    IndexArrayPtr result(new IndexArray(points->size(),Index()));
-    for(Triangulation::Finite_edges_iterator it = triangulation.finite_edges_begin();
-        it != triangulation.finite_edges_end(); ++it){
-            uint32_t source = it->first->vertex(it->second)->info();
-            uint32_t target = it->first->vertex(it->third)->info();
-            result->getAt(source).push_back(target);
-            result->getAt(target).push_back(source);
-    } 
+    // the neighbors of each point are sorted in increasing order
+    if (!neighbors->empty()) {
+        SortRowsFunctor functor;
+        functor.offsets = &*offsets->begin();
+        functor.neighbors = &*neighbors->begin();
+        parallel_for(nbpoints, functor, 4096);
+    }
+    return true;
 #else
     #ifdef _MSC_VER
     #pragma message("function 'delaunay_point_connection' disabled. CGAL needed.")
@@ -112,8 +160,20 @@ PGL::delaunay_point_connection(const Point3ArrayPtr points)
     #warning "function 'delaunay_point_connection' disabled. CGAL needed"
     #endif
 
-    IndexArrayPtr result;
+    return false;
 #endif
+}
+
+IndexArrayPtr 
+PGL::delaunay_point_connection(const Point3ArrayPtr points)
+{
+    Uint32Array1Ptr offsets, neighbors;
+    if (!delaunay_point_connection(points, offsets, neighbors)) return IndexArrayPtr();
+
+    IndexArrayPtr result(new IndexArray(points->size(),Index()));
+    Uint32Array1::const_iterator itoffset = offsets->begin();
+    for (IndexArray::iterator it = result->begin(); it != result->end(); ++it, ++itoffset)
+        *it = Index(neighbors->begin() + *itoffset, neighbors->begin() + *(itoffset + 1));
     return result;
 }
 
@@ -121,29 +181,12 @@ Index3ArrayPtr
 PGL::delaunay_triangulation(const Point3ArrayPtr points)
 {
 #ifdef WITH_CGAL
-
-    typedef CGAL::Exact_predicates_inexact_constructions_kernel         TK;
-    typedef CGAL::Triangulation_vertex_base_with_info_3<uint32_t, TK>   TVb;
-    typedef CGAL::Triangulation_data_structure_3<TVb>                    Tds;
-
-    typedef CGAL::Delaunay_triangulation_3<TK, Tds>                      Triangulation;
-    // typedef CGAL::Triangulation_3<K,Tds>      Triangulation;
-
-
-    typedef Triangulation::Cell_handle    TCell_handle;
-    typedef Triangulation::Vertex_handle  TVertex_handle;
-    typedef Triangulation::Locate_type    TLocate_type;
-    typedef Triangulation::Point          TPoint;
-    typedef Triangulation::Segment        TSegment;
-
-    Triangulation triangulation;
-    uint32_t pointCount = 0;
-    for (Point3Array::const_iterator it = points->begin(); it != points->end(); ++it)
-        triangulation.insert(toPoint3<TPoint>(*it))->info() = pointCount++;
-
+    DelaunayTriangulation triangulation;
+    delaunay_insert(triangulation, points);
 
     Index3ArrayPtr result(new Index3Array());
-    for(Triangulation::Finite_facets_iterator it = triangulation.finite_facets_begin();
+    result->reserve(triangulation.number_of_finite_facets());
+    for(DelaunayTriangulation::Finite_facets_iterator it = triangulation.finite_facets_begin();
         it != triangulation.finite_facets_end(); ++it){
 			Index3 ind; int j = 0;
 			for(int i = 0; i < 4; ++i){
@@ -173,29 +216,11 @@ PGL::delaunay_triangulation(const Point3ArrayPtr points)
 
 Vector3 PGL::pointset_orientation(const Point3ArrayPtr points, const Index& group )
 {
-#ifdef WITH_CGAL
-    typedef CGAL::Cartesian<real_t>   CK;
-    typedef CK::Point_3               CPoint;
-    typedef CK::Line_3                CLine;
-
-	std::list<CPoint> pointdata;
-	// for (Point3Array::const_iterator it = points->begin(); it != points->end() ; ++it)
-	for (Index::const_iterator it = group.begin(); it != group.end() ; ++it)
-		pointdata.push_back(toPoint3<CPoint>(points->getAt(*it)));
-
-	CLine line;
-	linear_least_squares_fitting_3(pointdata.begin(), pointdata.end(), line, CGAL::Dimension_tag<0>());
-
-	return toVector3(line.to_vector());
-#else
-    #ifdef _MSC_VER
-    #pragma message("function 'pointset_orientation' disabled. CGAL needed.")
-    #else
-    #warning "function 'pointset_orientation' disabled. CGAL needed"
-    #endif
-
-    return Vector3(0,0,0);
-#endif
+    if (group.empty()) return Vector3(0,0,0);
+    double values[3];
+    Vector3 vectors[3];
+    symmetric_eigen(pointset_centered_covariance(points,group),values,vectors);
+    return vectors[0];
 }
 
 ALGO_API TOOLS(Vector3) 
@@ -300,39 +325,26 @@ PGL::principal_curvatures(const Point3ArrayPtr points, const IndexArrayPtr adjac
 
 Vector3 PGL::pointset_normal(const Point3ArrayPtr points, const Index& group )
 {
-#ifdef WITH_CGAL
-    typedef CGAL::Cartesian<real_t>   CK;
-    typedef CK::Point_3               CPoint;
-    typedef CK::Plane_3                CPlane;
-
-	std::list<CPoint> pointdata;
-	// for (Point3Array::const_iterator it = points->begin(); it != points->end() ; ++it)
-	for (Index::const_iterator it = group.begin(); it != group.end() ; ++it)
-		pointdata.push_back(toPoint3<CPoint>(points->getAt(*it)));
-
-	CPlane plane;
-	linear_least_squares_fitting_3(pointdata.begin(), pointdata.end(), plane, CGAL::Dimension_tag<0>());
-
-	return dir2Vector3(plane.orthogonal_direction());
-#else
-    #ifdef _MSC_VER
-    #pragma message("function 'pointset_normal' disabled. CGAL needed.")
-    #else
-    #warning "function 'pointset_normal' disabled. CGAL needed"
-    #endif
-
-    return Vector3(0,0,0);
-#endif
+    if (group.empty()) return Vector3(0,0,0);
+    double values[3];
+    Vector3 vectors[3];
+    symmetric_eigen(pointset_centered_covariance(points,group),values,vectors);
+    return vectors[2];
 }
 
 Point3ArrayPtr
 PGL::pointsets_normals(const Point3ArrayPtr points, const IndexArrayPtr groups)
 {
-    Point3ArrayPtr result(new Point3Array(points->size()));
-    uint32_t i = 0;
-    for(IndexArray::const_iterator it = groups->begin(); it != groups->end(); ++it, ++i){
-        result->setAt(i, pointset_normal(points,*it));
-    }
+    Point3ArrayPtr result;
+    pointsets_principal_axes(points, groups, NULL, NULL, &result);
+    return result;
+}
+
+Point3ArrayPtr
+PGL::pointsets_normals(const Point3ArrayPtr points, const IndexArrayPtr groups, Point3ArrayPtr& features)
+{
+    Point3ArrayPtr result;
+    pointsets_principal_axes(points, groups, NULL, NULL, &result, &features);
     return result;
 }
 
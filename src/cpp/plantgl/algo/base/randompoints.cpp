@@ -33,6 +33,13 @@
 
 
 #include "randompoints.h"
+#include "scenebaker.h"
+#include "pointfilters.h"
+#include <plantgl/tool/util_random.h>
+#include <plantgl/tool/util_parallel.h>
+#include <plantgl/tool/errormsg.h>
+#include <plantgl/math/util_math.h>
+#include <algorithm>
 #include <stdlib.h>
 
 PGL_USING_NAMESPACE
@@ -40,16 +47,13 @@ TOOLS_USING_NAMESPACE
 
 Vector3 PGL(random_point_in_box)(const Vector3& minpt, const Vector3& maxpt)
 {
-    return minpt + Vector3((maxpt.x()-minpt.x())*rand()/RAND_MAX, (maxpt.y()-minpt.y())*rand()/RAND_MAX, (maxpt.z()-minpt.z())*rand()/RAND_MAX);
+    return minpt + Vector3((maxpt.x()-minpt.x())*rand()/real_t(RAND_MAX), (maxpt.y()-minpt.y())*rand()/real_t(RAND_MAX), (maxpt.z()-minpt.z())*rand()/real_t(RAND_MAX));
 }
 
-Vector3 PGL(random_point_in_tetrahedron)(const Vector3& p0, const Vector3& p1, const Vector3& p2, const Vector3& p3)
+/* Maps the point (s,t,u) of the unit cube in the tetrahedron. */
+static Vector3 tetrahedron_point(real_t s, real_t t, real_t u, const Vector3& p0, const Vector3& p1, const Vector3& p2, const Vector3& p3)
 {
     // from http://vcg.isti.cnr.it/activities/geometryegraphics/pointintetraedro.html    
-    float s = rand()/RAND_MAX;
-    float t = rand()/RAND_MAX;
-    float u = rand()/RAND_MAX;
-
     if (s+t > 1.0)
     { // cut and fold the cube into a prism
       s = 1.0 - s;
@@ -57,20 +61,28 @@ Vector3 PGL(random_point_in_tetrahedron)(const Vector3& p0, const Vector3& p1, c
     }
     if (t+u > 1.0)
     { // cut and fold the cube into a tetrahedron
-      float tmp = u;
+      real_t tmp = u;
       u = 1.0 - s -t;
       t = 1.0 - tmp;
     }
     else if (s+t+u > 1.0) {
-      float tmp = u;
+      real_t tmp = u;
       u = s + t + u - 1.0;
       s = 1 - t - tmp;
     }
-    float a = 1 - s - t - u;
+    real_t a = 1 - s - t - u;
     
     return (p0 * a + p1 * s + p2 * t + p3 * u);
 }
 
+Vector3 PGL(random_point_in_tetrahedron)(const Vector3& p0, const Vector3& p1, const Vector3& p2, const Vector3& p3)
+{
+    real_t s = rand()/real_t(RAND_MAX);
+    real_t t = rand()/real_t(RAND_MAX);
+    real_t u = rand()/real_t(RAND_MAX);
+    return tetrahedron_point(s, t, u, p0, p1, p2, p3);
+}
+
 Point3ArrayPtr PGL(random_points_in_tetrahedron)(size_t nb, const Vector3& p0, const Vector3& p1, const Vector3& p2, const Vector3& p3)
 {
     Point3ArrayPtr res(new Point3Array(nb));
@@ -83,18 +95,279 @@ Point3ArrayPtr PGL(random_points_in_tetrahedra)(size_t nb_per_tetra, const Point
 {
     Point3ArrayPtr res(new Point3Array(nb_per_tetra* tetraindices->size()));
     Point3Array::iterator it = res->begin();
-    for (Index4Array::iterator ittetra = tetraindices->begin(); ittetra != tetraindices->end(); ++it, ++ittetra){
+    for (Index4Array::iterator ittetra = tetraindices->begin(); ittetra != tetraindices->end(); ++ittetra){
         const Vector3& p0 = points->getAt(ittetra->getAt(0));
         const Vector3& p1 = points->getAt(ittetra->getAt(1)); 
         const Vector3& p2 = points->getAt(ittetra->getAt(2));
         const Vector3& p3 = points->getAt(ittetra->getAt(3));
-        for (int i = 0; i < nb_per_tetra; ++i)
+        for (size_t i = 0; i < nb_per_tetra; ++i, ++it)
             *it = random_point_in_tetrahedron(p0, p1, p2, p3);
     }
     return res;
 
 }
 
+/* ----------------------------------------------------------------------- */
+
+#define PARALLEL_GRAIN 4096
+
+/* Samples the tetrahedra [begin,end[, each one with its own random stream. */
+struct TetrahedraSampler {
+    const Point3Array * points;
+    const Index4Array * tetraindices;
+    Point3Array * result;
+    size_t nb_per_tetra;
+    uint32_t seed;
+
+    void operator()(size_t begin, size_t end, size_t) {
+        for (size_t tetra = begin; tetra < end; ++tetra){
+            const Index4& ids = tetraindices->getAt(tetra);
+            const Vector3& p0 = points->getAt(ids.getAt(0));
+            const Vector3& p1 = points->getAt(ids.getAt(1)); 
+            const Vector3& p2 = points->getAt(ids.getAt(2));
+            const Vector3& p3 = points->getAt(ids.getAt(3));
+            CounterRandom random(seed, tetra);
+            for (size_t i = 0; i < nb_per_tetra; ++i){
+                real_t s = random.uniform(), t = random.uniform(), u = random.uniform();
+                result->setAt(tetra * nb_per_tetra + i, tetrahedron_point(s, t, u, p0, p1, p2, p3));
+            }
+        }
+    }
+};
+
+Point3ArrayPtr PGL(random_points_in_tetrahedra)(size_t nb_per_tetra, const Point3ArrayPtr points, const Index4ArrayPtr tetraindices, uint32_t seed)
+{
+    Point3ArrayPtr res(new Point3Array(nb_per_tetra * tetraindices->size()));
+    if (res->empty()) return res;
+    TetrahedraSampler sampler;
+    sampler.points = points.get();
+    sampler.tetraindices = tetraindices.get();
+    sampler.result = res.get();
+    sampler.nb_per_tetra = nb_per_tetra;
+    sampler.seed = seed;
+    parallel_for(tetraindices->size(), sampler, std::max<size_t>(1, PARALLEL_GRAIN / nb_per_tetra));
+    return res;
+}
+
+/* ----------------------------------------------------------------------- */
+
+/* Size of the blocks of triangles of the prefix sum of the areas. 
+   It does not depend on the number of threads so that the sums are always done in the same order. */
+#define AREA_BLOCK_SIZE 4096
+
+/* Computes the areas of the triangles of the blocks [begin,end[. 
+   The first pass gives the sum of the areas of each block and the second one their cumulated sums. */
+struct TriangleAreaFunctor {
+    const CompactMeshBuffer * buffer;
+    std::vector<double> * cdf;
+    std::vector<double> * blocksums;
+    bool cumulate;
+
+    void operator()(size_t begin, size_t end, size_t) {
+        size_t nbtriangles = cdf->size();
+        for (size_t block = begin; block < end; ++block){
+            size_t first = block * AREA_BLOCK_SIZE;
+            size_t last = std::min(first + AREA_BLOCK_SIZE, nbtriangles);
+            double sum = (cumulate ? (*blocksums)[block] : 0);
+            for (size_t t = first; t < last; ++t){
+                if (cumulate) { sum += (*cdf)[t]; (*cdf)[t] = sum; continue; }
+                const float * p0 = &buffer->vertices[3 * buffer->indices[3*t]];
+                const float * p1 = &buffer->vertices[3 * buffer->indices[3*t+1]];
+                const float * p2 = &buffer->vertices[3 * buffer->indices[3*t+2]];
+                double u[3] = { double(p1[0]) - p0[0], double(p1[1]) - p0[1], double(p1[2]) - p0[2] };
+                double v[3] = { double(p2[0]) - p0[0], double(p2[1]) - p0[1], double(p2[2]) - p0[2] };
+                double cx = u[1]*v[2] - u[2]*v[1], cy = u[2]*v[0] - u[0]*v[2], cz = u[0]*v[1] - u[1]*v[0];
+                double area = 0.5 * sqrt(cx*cx + cy*cy + cz*cz);
+                (*cdf)[t] = area;
+                sum += area;
+            }
+            if (!cumulate) (*blocksums)[block] = sum;
+        }
+    }
+};
+
+/* The tesselated scene with the cumulated areas of its triangles. */
+struct SceneSurface {
+    CompactMeshBuffer buffer;
+    std::vector<double> cdf;
+
+    bool build(const ScenePtr& scene) {
+        if (!bake_scene(scene, buffer, true)) return false;
+        size_t nbtriangles = buffer.shapeIndices.size();
+        cdf.resize(nbtriangles);
+        if (nbtriangles == 0) return true;
+        size_t nbblocks = (nbtriangles + AREA_BLOCK_SIZE - 1) / AREA_BLOCK_SIZE;
+        std::vector<double> blocksums(nbblocks);
+        TriangleAreaFunctor functor;
+        functor.buffer = &buffer;
+        functor.cdf = &cdf;
+        functor.blocksums = &blocksums;
+        functor.cumulate = false;
+        parallel_for(nbblocks, functor, 1);
+        double total = 0;
+        for (size_t block = 0; block < nbblocks; ++block){
+            double sum = blocksums[block];
+            blocksums[block] = total;
+            total += sum;
+        }
+        functor.cumulate = true;
+        parallel_for(nbblocks, functor, 1);
+        return true;
+    }
+
+    inline double area() const { return cdf.empty() ? 0 : cdf.back(); }
+};
+
+/* Draws the samples [begin,end[. The sample i is in the stratum [i/nb,(i+1)/nb[ of the total area and 
+   has its own random stream. The strata of a range are increasing, so its triangles are found 
+   with one binary search followed by a linear walk. */
+struct SurfaceSampler {
+    const SceneSurface * surface;
+    size_t nb;
+    uint32_t seed;
+    Point3Array * points;
+    Point3Array * normals;
+    Uint32Array1 * shapeIds;
+    Uint32Array1 * triangleIndices;
+    Point3Array * barycentrics;
+
+    void operator()(size_t begin, size_t end, size_t) {
+        const CompactMeshBuffer& buffer = surface->buffer;
+        const std::vector<double>& cdf = surface->cdf;
+        size_t last = cdf.size() - 1;
+        double total = surface->area();
+        size_t t = 0;
+        for (size_t i = begin; i < end; ++i){
+            CounterRandom random(seed, i);
+            double target = (i + random.uniform()) * total / nb;
+            if (i == begin) t = std::upper_bound(cdf.begin(), cdf.end(), target) - cdf.begin();
+            else while (t < last && cdf[t] <= target) ++t;
+            if (t > last) t = last;
+
+            // Uniform point of the triangle
+            real_t r1 = sqrt(random.uniform()), r2 = random.uniform();
+            real_t a = 1 - r1, b = r1 * (1 - r2), c = r1 * r2;
+            const float * p0 = &buffer.vertices[3 * buffer.indices[3*t]];
+            const float * p1 = &buffer.vertices[3 * buffer.indices[3*t+1]];
+            const float * p2 = &buffer.vertices[3 * buffer.indices[3*t+2]];
+            points->setAt(i, Vector3(a * p0[0] + b * p1[0] + c * p2[0],
+                                     a * p0[1] + b * p1[1] + c * p2[1],
+                                     a * p0[2] + b * p1[2] + c * p2[2]));
+            if (!normals) continue;
+
+            const float * n0 = &buffer.normals[3 * buffer.indices[3*t]];
+            const float * n1 = &buffer.normals[3 * buffer.indices[3*t+1]];
+            const float * n2 = &buffer.normals[3 * buffer.indices[3*t+2]];
+            Vector3 n(a * n0[0] + b * n1[0] + c * n2[0], a * n0[1] + b * n1[1] + c * n2[1], a * n0[2] + b * n1[2] + c * n2[2]);
+            if (n.normalize() < GEOM_EPSILON){
+                n = cross(Vector3(p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]), Vector3(p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]));
+                n.normalize();
+            }
+            normals->setAt(i, n);
+            uint32_t shapeIndex = buffer.shapeIndices[t];
+            shapeIds->setAt(i, buffer.shapeIds[shapeIndex]);
+            triangleIndices->setAt(i, uint32_t(t - buffer.triangleOffsets[shapeIndex]));
+            barycentrics->setAt(i, Vector3(a, b, c));
+        }
+    }
+};
+
+static Point3ArrayPtr sample_surface(const SceneSurface& surface, size_t nb, uint32_t seed, bool attributes,
+                                     Point3ArrayPtr& normals, Uint32Array1Ptr& shapeIds,
+                                     Uint32Array1Ptr& triangleIndices, Point3ArrayPtr& barycentrics)
+{
+    if (surface.area() <= 0) nb = 0;
+    Point3ArrayPtr points(new Point3Array(nb));
+    if (attributes){
+        normals = Point3ArrayPtr(new Point3Array(nb));
+        shapeIds = Uint32Array1Ptr(new Uint32Array1(nb));
+        triangleIndices = Uint32Array1Ptr(new Uint32Array1(nb));
+        barycentrics = Point3ArrayPtr(new Point3Array(nb));
+    }
+    if (nb == 0) return points;
+    SurfaceSampler sampler;
+    sampler.surface = &surface;
+    sampler.nb = nb;
+    sampler.seed = seed;
+    sampler.points = points.get();
+    sampler.normals = (attributes ? normals.get() : NULL);
+    sampler.shapeIds = (attributes ? shapeIds.get() : NULL);
+    sampler.triangleIndices = (attributes ? triangleIndices.get() : NULL);
+    sampler.barycentrics = (attributes ? barycentrics.get() : NULL);
+    parallel_for(nb, sampler, PARALLEL_GRAIN);
+    return points;
+}
+
+Point3ArrayPtr PGL(random_points_on_scene)(const ScenePtr& scene, size_t nb, uint32_t seed)
+{
+    SceneSurface surface;
+    if (!surface.build(scene)) return Point3ArrayPtr(new Point3Array());
+    Point3ArrayPtr normals, barycentrics;
+    Uint32Array1Ptr shapeIds, triangleIndices;
+    return sample_surface(surface, nb, seed, false, normals, shapeIds, triangleIndices, barycentrics);
+}
+
+Point3ArrayPtr PGL(random_points_on_scene)(const ScenePtr& scene, size_t nb, uint32_t seed,
+                                           Point3ArrayPtr& normals,
+                                           Uint32Array1Ptr& shapeIds,
+                                           Uint32Array1Ptr& triangleIndices,
+                                           Point3ArrayPtr& barycentrics)
+{
+    SceneSurface surface;
+    if (!surface.build(scene)) nb = 0;
+    return sample_surface(surface, nb, seed, true, normals, shapeIds, triangleIndices, barycentrics);
+}
+
+/* ----------------------------------------------------------------------- */
 
+template<class Array>
+static RCPtr<Array> select_points(const RCPtr<Array>& values, const Index& selection)
+{
+    RCPtr<Array> result(new Array(selection.size()));
+    typename Array::iterator it = result->begin();
+    for (Index::const_iterator itsel = selection.begin(); itsel != selection.end(); ++itsel, ++it)
+        *it = values->getAt(*itsel);
+    return result;
+}
 
+static Point3ArrayPtr poisson_disk_sample_surface(const ScenePtr& scene, real_t radius, uint32_t seed, real_t oversampling, bool attributes,
+                                                  Point3ArrayPtr& normals, Uint32Array1Ptr& shapeIds,
+                                                  Uint32Array1Ptr& triangleIndices, Point3ArrayPtr& barycentrics)
+{
+    if (radius <= 0) {
+        pglError("Invalid radius for Poisson disk sampling: %f", radius);
+        return sample_surface(SceneSurface(), 0, seed, attributes, normals, shapeIds, triangleIndices, barycentrics);
+    }
+    SceneSurface surface;
+    size_t nb = 0;
+    if (surface.build(scene)) nb = size_t(ceil(oversampling * surface.area() / (GEOM_PI * radius * radius)));
+    Point3ArrayPtr candidates = sample_surface(surface, nb, seed, attributes, normals, shapeIds, triangleIndices, barycentrics);
+    if (candidates->empty()) return candidates;
+
+    Index selection = poisson_disk_subsample(candidates, radius);
+    if (attributes){
+        normals = select_points(normals, selection);
+        shapeIds = select_points(shapeIds, selection);
+        triangleIndices = select_points(triangleIndices, selection);
+        barycentrics = select_points(barycentrics, selection);
+    }
+    return select_points(candidates, selection);
+}
+
+Point3ArrayPtr PGL(poisson_disk_points_on_scene)(const ScenePtr& scene, real_t radius, uint32_t seed, real_t oversampling)
+{
+    Point3ArrayPtr normals, barycentrics;
+    Uint32Array1Ptr shapeIds, triangleIndices;
+    return poisson_disk_sample_surface(scene, radius, seed, oversampling, false, normals, shapeIds, triangleIndices, barycentrics);
+}
+
+Point3ArrayPtr PGL(poisson_disk_points_on_scene)(const ScenePtr& scene, real_t radius, uint32_t seed, real_t oversampling,
+                                                 Point3ArrayPtr& normals,
+                                                 Uint32Array1Ptr& shapeIds,
+                                                 Uint32Array1Ptr& triangleIndices,
+                                                 Point3ArrayPtr& barycentrics)
+{
+    return poisson_disk_sample_surface(scene, radius, seed, oversampling, true, normals, shapeIds, triangleIndices, barycentrics);
+}
 
+/* ----------------------------------------------------------------------- */
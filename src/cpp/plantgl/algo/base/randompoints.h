@@ -37,7 +37,9 @@
 #include "../algo_config.h"
 #include <plantgl/scenegraph/container/pointarray.h>
 #include <plantgl/scenegraph/container/indexarray.h>
+#include <plantgl/scenegraph/scene/scene.h>
 #include <plantgl/math/util_vector.h>
+#include <plantgl/tool/util_array.h>
 
 
 PGL_BEGIN_NAMESPACE
@@ -47,6 +49,41 @@ ALGO_API TOOLS(Vector3) random_point_in_tetrahedron(const TOOLS(Vector3)& p0, co
 ALGO_API Point3ArrayPtr random_points_in_tetrahedron(size_t nb, const TOOLS(Vector3)& p0, const TOOLS(Vector3)& p1, const TOOLS(Vector3)& p2, const TOOLS(Vector3)& p3);
 ALGO_API Point3ArrayPtr random_points_in_tetrahedra(size_t nb_per_tetra, const Point3ArrayPtr points, const Index4ArrayPtr tetraindices);
 
+/** Sample \e nb_per_tetra points in each tetrahedron. Each tetrahedron draws from its own counter based 
+    random stream derived from \e seed, so the tetrahedra are processed in parallel and the result 
+    does not depend on the number of threads. */
+ALGO_API Point3ArrayPtr random_points_in_tetrahedra(size_t nb_per_tetra, const Point3ArrayPtr points, const Index4ArrayPtr tetraindices, uint32_t seed);
+
+/* ----------------------------------------------------------------------- */
+
+/** Sample \e nb points uniformly on the surfaces of the shapes of \e scene.
+    The scene is tesselated and the samples are stratified along the cumulated area of its triangles.
+    Each sample draws from its own counter based random stream derived from \e seed, so the result 
+    does not depend on the number of threads. */
+ALGO_API Point3ArrayPtr random_points_on_scene(const ScenePtr& scene, size_t nb, uint32_t seed = 0);
+
+/** Sample points on \e scene as above and give also for each point its normal, interpolated from the
+    normals of the vertices, the id of its shape, the index of its triangle in the tesselation of the shape 
+    and its barycentric coordinates in this triangle. The vertices of the triangle are ordered 
+    counter clockwise around its normal. */
+ALGO_API Point3ArrayPtr random_points_on_scene(const ScenePtr& scene, size_t nb, uint32_t seed,
+                                               Point3ArrayPtr& normals,
+                                               TOOLS(Uint32Array1Ptr)& shapeIds,
+                                               TOOLS(Uint32Array1Ptr)& triangleIndices,
+                                               Point3ArrayPtr& barycentrics);
+
+/** Sample points on the surfaces of \e scene such that no two points are closer than \e radius.
+    \e oversampling times area / (pi radius^2) points are sampled uniformly and then 
+    subsampled with poisson_disk_subsample. */
+ALGO_API Point3ArrayPtr poisson_disk_points_on_scene(const ScenePtr& scene, real_t radius, uint32_t seed = 0, real_t oversampling = 4);
+
+/// Sample points on \e scene as above with the attributes given by random_points_on_scene.
+ALGO_API Point3ArrayPtr poisson_disk_points_on_scene(const ScenePtr& scene, real_t radius, uint32_t seed, real_t oversampling,
+                                                     Point3ArrayPtr& normals,
+                                                     TOOLS(Uint32Array1Ptr)& shapeIds,
+                                                     TOOLS(Uint32Array1Ptr)& triangleIndices,
+                                                     Point3ArrayPtr& barycentrics);
+
 
 
 PGL_END_NAMESPACE
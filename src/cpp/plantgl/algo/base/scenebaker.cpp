@@ -0,0 +1,235 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+#include "scenebaker.h"
+#include "tesselator.h"
+
+#include <plantgl/scenegraph/scene/scene.h>
+#include <plantgl/scenegraph/scene/shape.h>
+#include <plantgl/scenegraph/geometry/triangleset.h>
+#include <plantgl/tool/util_parallel.h>
+#include <plantgl/tool/errormsg.h>
+#include <limits>
+#include <cmath>
+
+PGL_USING_NAMESPACE
+TOOLS_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/* A tesselated shape and its place in the buffer. */
+struct BakedShape {
+    TriangleSetPtr triangles;
+    size_t shapeIndex;
+    size_t vertexOffset;
+    size_t triangleOffset;
+    bool copyNormals;
+    bool flat;
+};
+
+/* Writes the baked shapes [begin,end[ in the buffer. 
+   Each shape writes in its own range of the arrays, so shapes can be processed from several threads. */
+template<class RealType, class IndexType>
+struct BakedShapeWriter {
+    const std::vector<BakedShape>& shapes;
+    MeshBuffer<RealType,IndexType>& buffer;
+    bool computeNormals;
+
+    BakedShapeWriter(const std::vector<BakedShape>& _shapes, MeshBuffer<RealType,IndexType>& _buffer, bool _computeNormals):
+        shapes(_shapes), buffer(_buffer), computeNormals(_computeNormals) {}
+
+    void operator()(size_t begin, size_t end, size_t) {
+        for(size_t i = begin; i < end; ++i) write(shapes[i]);
+    }
+
+    void write(const BakedShape& shape) {
+        const TriangleSet& triangles = *shape.triangles;
+        const Point3Array& points = *triangles.getPointList();
+        const Index3Array& indices = *triangles.getIndexList();
+        bool ccw = triangles.getCCW();
+
+        if (shape.flat) { writeFlat(shape); return; }
+
+        RealType * vertex = &buffer.vertices[3 * shape.vertexOffset];
+        for(Point3Array::const_iterator it = points.begin(); it != points.end(); ++it){
+            *vertex++ = (RealType)it->x(); *vertex++ = (RealType)it->y(); *vertex++ = (RealType)it->z();
+        }
+
+        IndexType * index = &buffer.indices[3 * shape.triangleOffset];
+        IndexType * shapeIndex = &buffer.shapeIndices[shape.triangleOffset];
+        for(Index3Array::const_iterator it = indices.begin(); it != indices.end(); ++it){
+            *index++ = (IndexType)(shape.vertexOffset + it->getAt(0));
+            *index++ = (IndexType)(shape.vertexOffset + it->getAt(ccw ? 1 : 2));
+            *index++ = (IndexType)(shape.vertexOffset + it->getAt(ccw ? 2 : 1));
+            *shapeIndex++ = (IndexType)shape.shapeIndex;
+        }
+
+        if (!computeNormals) return;
+        RealType * normal = &buffer.normals[3 * shape.vertexOffset];
+        if (shape.copyNormals) {
+            const Point3Array& normals = *triangles.getNormalList();
+            for(Point3Array::const_iterator it = normals.begin(); it != normals.end(); ++it){
+                *normal++ = (RealType)it->x(); *normal++ = (RealType)it->y(); *normal++ = (RealType)it->z();
+            }
+        }
+        else {
+            // Area weighted normals accumulated in double precision.
+            std::vector<double> accu(3 * points.size(), 0.0);
+            const IndexType * tri = &buffer.indices[3 * shape.triangleOffset];
+            for(size_t t = 0; t < indices.size(); ++t, tri += 3){
+                size_t i0 = tri[0] - shape.vertexOffset, i1 = tri[1] - shape.vertexOffset, i2 = tri[2] - shape.vertexOffset;
+                const Vector3& p0 = points.getAt(i0);
+                Vector3 n = cross(points.getAt(i1) - p0, points.getAt(i2) - p0);
+                size_t v[3] = { i0, i1, i2 };
+                for(int j = 0; j < 3; ++j){
+                    accu[3*v[j]] += n.x(); accu[3*v[j]+1] += n.y(); accu[3*v[j]+2] += n.z();
+                }
+            }
+            for(size_t v = 0; v < points.size(); ++v){
+                double nx = accu[3*v], ny = accu[3*v+1], nz = accu[3*v+2];
+                double l = sqrt(nx*nx+ny*ny+nz*nz);
+                if (l > 0) { nx /= l; ny /= l; nz /= l; }
+                *normal++ = (RealType)nx; *normal++ = (RealType)ny; *normal++ = (RealType)nz;
+            }
+        }
+    }
+
+    /* Faceted shapes: each triangle gets its own 3 vertices, all with the normal of the face. */
+    void writeFlat(const BakedShape& shape) {
+        const TriangleSet& triangles = *shape.triangles;
+        const Point3Array& points = *triangles.getPointList();
+        const Index3Array& indices = *triangles.getIndexList();
+        bool ccw = triangles.getCCW();
+        bool faceNormals = triangles.hasNormalList() && !triangles.getNormalIndexList() &&
+                           triangles.getNormalList()->size() == indices.size();
+
+        RealType * vertex = &buffer.vertices[3 * shape.vertexOffset];
+        RealType * normal = &buffer.normals[3 * shape.vertexOffset];
+        IndexType * index = &buffer.indices[3 * shape.triangleOffset];
+        IndexType * shapeIndex = &buffer.shapeIndices[shape.triangleOffset];
+        size_t current = shape.vertexOffset;
+        for(size_t t = 0; t < indices.size(); ++t){
+            const Index3& tri = indices.getAt(t);
+            const Vector3& p0 = points.getAt(tri.getAt(0));
+            const Vector3& p1 = points.getAt(tri.getAt(ccw ? 1 : 2));
+            const Vector3& p2 = points.getAt(tri.getAt(ccw ? 2 : 1));
+            Vector3 n = (faceNormals ? triangles.getNormalList()->getAt(t) : cross(p1 - p0, p2 - p0));
+            if (!faceNormals) n.normalize();
+            const Vector3 * p[3] = { &p0, &p1, &p2 };
+            for(int j = 0; j < 3; ++j){
+                *vertex++ = (RealType)p[j]->x(); *vertex++ = (RealType)p[j]->y(); *vertex++ = (RealType)p[j]->z();
+                *normal++ = (RealType)n.x(); *normal++ = (RealType)n.y(); *normal++ = (RealType)n.z();
+                *index++ = (IndexType)(current++);
+            }
+            *shapeIndex++ = (IndexType)shape.shapeIndex;
+        }
+    }
+};
+
+/* ----------------------------------------------------------------------- */
+
+template<class RealType, class IndexType>
+bool PGL(bake_scene)(const ScenePtr& scene, MeshBuffer<RealType,IndexType>& buffer, bool computeNormals)
+{
+    buffer.clear();
+    if (!scene) return false;
+
+    // Tesselation. The cache of the tesselator makes shared geometries tesselated only once.
+    // It is done sequentially since reference counting of scene objects is not thread safe.
+    Tesselator tesselator;
+    std::vector<BakedShape> shapes;
+    size_t nbShapes = scene->size();
+    shapes.reserve(nbShapes);
+    buffer.shapeIds.resize(nbShapes, Shape::NOID);
+    buffer.triangleOffsets.resize(nbShapes+1, 0);
+    size_t shapeIndex = 0;
+    for(Scene::const_iterator it = scene->begin(); it != scene->end(); ++it, ++shapeIndex){
+        Shape * sh = dynamic_cast<Shape *>(it->get());
+        if (!sh || !sh->getGeometry()) continue;
+        buffer.shapeIds[shapeIndex] = sh->id;
+        if (!sh->getGeometry()->apply(tesselator)) continue;
+        TriangleSetPtr triangles = tesselator.getTriangulation();
+        if (!triangles || !triangles->getPointList() || !triangles->getIndexList()) continue;
+        BakedShape bshape;
+        bshape.triangles = triangles;
+        bshape.shapeIndex = shapeIndex;
+        bshape.copyNormals = triangles->getNormalPerVertex() && 
+                             triangles->hasNormalList() && 
+                             !triangles->getNormalIndexList() &&
+                             triangles->getNormalList()->size() == triangles->getPointList()->size();
+        bshape.flat = computeNormals && !triangles->getNormalPerVertex();
+        shapes.push_back(bshape);
+    }
+
+    // Prefix sums of the sizes of the shapes give their place in the buffer.
+    size_t nbVertices = 0, nbTriangles = 0;
+    std::vector<BakedShape>::iterator itbaked = shapes.begin();
+    for(size_t i = 0; i < nbShapes; ++i){
+        buffer.triangleOffsets[i] = nbTriangles;
+        if (itbaked != shapes.end() && itbaked->shapeIndex == i){
+            itbaked->vertexOffset = nbVertices;
+            itbaked->triangleOffset = nbTriangles;
+            size_t shapeTriangles = itbaked->triangles->getIndexList()->size();
+            nbVertices += (itbaked->flat ? 3 * shapeTriangles : itbaked->triangles->getPointList()->size());
+            nbTriangles += shapeTriangles;
+            ++itbaked;
+        }
+    }
+    buffer.triangleOffsets[nbShapes] = nbTriangles;
+
+    if (nbVertices > (size_t)std::numeric_limits<IndexType>::max() || nbShapes > (size_t)std::numeric_limits<IndexType>::max()) {
+        pglError("Too many vertices (%lu) for the index type of the mesh buffer.", (unsigned long)nbVertices);
+        buffer.clear();
+        return false;
+    }
+
+    buffer.vertices.resize(3 * nbVertices);
+    buffer.indices.resize(3 * nbTriangles);
+    buffer.shapeIndices.resize(nbTriangles);
+    if (computeNormals) buffer.normals.resize(3 * nbVertices);
+
+    // Copy of the shapes in their own range of the buffer.
+    BakedShapeWriter<RealType,IndexType> writer(shapes, buffer, computeNormals);
+    parallel_for(shapes.size(), writer, 16);
+    return true;
+}
+
+/* ----------------------------------------------------------------------- */
+
+template ALGO_API bool PGL(bake_scene)<double,uint64_t>(const ScenePtr&, MeshBuffer<double,uint64_t>&, bool);
+template ALGO_API bool PGL(bake_scene)<double,uint32_t>(const ScenePtr&, MeshBuffer<double,uint32_t>&, bool);
+template ALGO_API bool PGL(bake_scene)<float,uint64_t>(const ScenePtr&, MeshBuffer<float,uint64_t>&, bool);
+template ALGO_API bool PGL(bake_scene)<float,uint32_t>(const ScenePtr&, MeshBuffer<float,uint32_t>&, bool);
+
+/* ----------------------------------------------------------------------- */
@@ -0,0 +1,128 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+/*! \file scenebaker.h
+    \brief Tesselation of a whole scene into one flat indexed triangle buffer.
+*/
+
+#ifndef __scenebaker_h__
+#define __scenebaker_h__
+
+#include "../algo_config.h"
+#include <plantgl/tool/util_types.h>
+#include <plantgl/tool/rcobject.h>
+#include <vector>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+class Scene;
+typedef RCPtr<Scene> ScenePtr;
+
+/* ----------------------------------------------------------------------- */
+
+/**
+   \class MeshBuffer
+   \brief A flat indexed triangle buffer, typically fed to ray tracers and exporters.
+
+   Coordinates and indices are stored in flat arrays. Precision of coordinates and
+   size of indices are given by \e RealType and \e IndexType.
+*/
+template<class RealType, class IndexType>
+struct MeshBuffer {
+
+  typedef RealType real_type;
+  typedef IndexType index_type;
+
+  /// Coordinates x, y, z of the vertices.
+  std::vector<RealType> vertices;
+
+  /// Coordinates x, y, z of the normals of the vertices. Empty if normals were not required.
+  std::vector<RealType> normals;
+
+  /// Indices of the 3 vertices of the triangles, in counter clockwise order.
+  std::vector<IndexType> indices;
+
+  /// For each triangle, the position in the scene of the shape it comes from.
+  std::vector<IndexType> shapeIndices;
+
+  /// For each shape of the scene, its id.
+  std::vector<uint_t> shapeIds;
+
+  /** For each shape of the scene, the index of its first triangle.
+      An additional last value gives the total number of triangles. */
+  std::vector<size_t> triangleOffsets;
+
+  /// Returns the number of vertices.
+  inline size_t vertexCount() const { return vertices.size() / 3; }
+
+  /// Returns the number of triangles.
+  inline size_t triangleCount() const { return indices.size() / 3; }
+
+  /// Clears all the arrays.
+  void clear() {
+    vertices.clear(); normals.clear(); indices.clear(); 
+    shapeIndices.clear(); shapeIds.clear(); triangleOffsets.clear();
+  }
+};
+
+/// Buffer with the precision of the library and 64 bits indices.
+typedef MeshBuffer<real_t, uint64_t> RealMeshBuffer;
+
+/// Buffer with float32 coordinates and uint32 indices.
+typedef MeshBuffer<float, uint32_t> CompactMeshBuffer;
+
+/* ----------------------------------------------------------------------- */
+
+/** Tesselate all the shapes of \e scene into \e buffer.
+    Each distinct geometry is tesselated once. Offsets of each shape in the buffer are then
+    computed with a prefix sum and the shapes are written in parallel in the pre-sized arrays.
+    Per vertex normals are copied from the tesselation when available or computed otherwise.
+    Vertices of faceted shapes (without per vertex normals) are duplicated for each triangle
+    to keep the normals of the faces.
+    Shapes whose tesselation is not a triangle set (curves, points) are skipped.
+    Returns false if \e buffer cannot index all the vertices with its index type. */
+template<class RealType, class IndexType>
+ALGO_API bool bake_scene(const ScenePtr& scene, MeshBuffer<RealType,IndexType>& buffer, bool computeNormals = true);
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+// __scenebaker_h__
+#endif
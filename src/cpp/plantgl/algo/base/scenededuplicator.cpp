@@ -0,0 +1,703 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2006 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *  ----------------------------------------------------------------------------
+ */
+
+#include "scenededuplicator.h"
+
+#include <plantgl/pgl_appearance.h>
+#include <plantgl/pgl_geometry.h>
+#include <plantgl/pgl_transformation.h>
+#include <plantgl/pgl_container.h>
+#include <plantgl/scenegraph/scene/shape.h>
+#include <plantgl/tool/util_string.h>
+#include <cstring>
+
+PGL_USING_NAMESPACE
+TOOLS_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+#define DEDUP_FNV_OFFSET 14695981039346656037ULL
+#define DEDUP_FNV_PRIME 1099511628211ULL
+
+static inline void dedup_hash( unsigned long long& h, const void * data, size_t size ) {
+  const unsigned char * _c = static_cast<const unsigned char *>(data);
+  for (const unsigned char * _end = _c + size; _c != _end; ++_c)
+    h = (h ^ *_c) * DEDUP_FNV_PRIME;
+}
+
+/* Elements of the arrays are hashed and compared bitwise, except
+   the index lists of the faces and the transformations of IFS. */
+
+template<class T>
+inline void dedup_hash_element( unsigned long long& h, const T& value ) { dedup_hash(h,&value,sizeof(T)); }
+
+template<class T>
+inline bool dedup_equal_element( const T& a, const T& b ) { return memcmp(&a,&b,sizeof(T)) == 0; }
+
+template<class T>
+inline size_t dedup_element_bytes( const T& ) { return sizeof(T); }
+
+inline void dedup_hash_element( unsigned long long& h, const Index& value ) {
+  uint_t _size = value.size();
+  dedup_hash(h,&_size,sizeof(uint_t));
+  if (_size > 0) dedup_hash(h,&*value.begin(),_size*sizeof(uint_t));
+}
+
+inline bool dedup_equal_element( const Index& a, const Index& b ) {
+  return a.size() == b.size() && (a.size() == 0 || memcmp(&*a.begin(),&*b.begin(),a.size()*sizeof(uint_t)) == 0);
+}
+
+inline size_t dedup_element_bytes( const Index& value ) { return sizeof(Index) + value.size()*sizeof(uint_t); }
+
+inline void dedup_hash_element( unsigned long long& h, const Transform4Ptr& value ) {
+  Matrix4 _m = value ? value->getMatrix() : Matrix4::IDENTITY;
+  dedup_hash(h,&_m,sizeof(Matrix4));
+}
+
+inline bool dedup_equal_element( const Transform4Ptr& a, const Transform4Ptr& b ) {
+  Matrix4 _ma = a ? a->getMatrix() : Matrix4::IDENTITY;
+  Matrix4 _mb = b ? b->getMatrix() : Matrix4::IDENTITY;
+  return memcmp(&_ma,&_mb,sizeof(Matrix4)) == 0;
+}
+
+inline size_t dedup_element_bytes( const Transform4Ptr& ) { return sizeof(Transform4Ptr) + sizeof(Transform4); }
+
+template<class ArrayT>
+static bool dedup_equal_array( const RefCountObject * a, const RefCountObject * b ) {
+  const ArrayT * _a = static_cast<const ArrayT *>(a);
+  const ArrayT * _b = static_cast<const ArrayT *>(b);
+  if (_a == _b) return true;
+  if (_a->size() != _b->size()) return false;
+  for (typename ArrayT::const_iterator _ita = _a->begin(), _itb = _b->begin(); _ita != _a->end(); ++_ita, ++_itb)
+    if (!dedup_equal_element(*_ita,*_itb)) return false;
+  return true;
+}
+
+/* ----------------------------------------------------------------------- */
+
+template<class T>
+inline void dedup_add_field( SceneDeduplicator::Key& key, const T& value ) {
+  key.fields.append(reinterpret_cast<const char *>(&value),sizeof(T));
+}
+
+inline void dedup_add_field( SceneDeduplicator::Key& key, const std::string& value ) {
+  dedup_add_field(key,value.size());
+  key.fields.append(value);
+}
+
+template<class T>
+inline void dedup_add_child( SceneDeduplicator::Key& key, const RCPtr<T>& child ) {
+  size_t _id = child ? child->SceneObject::getId() : 0;
+  dedup_add_field(key,_id);
+}
+
+template<class ArrayT>
+void dedup_add_array( SceneDeduplicator::Key& key, const RCPtr<ArrayT>& array ) {
+  if (!array) { key.fields.push_back('\0'); return; }
+  key.fields.push_back('\1');
+  unsigned long long _h = DEDUP_FNV_OFFSET;
+  size_t _bytes = sizeof(ArrayT);
+  for (typename ArrayT::const_iterator _it = array->begin(); _it != array->end(); ++_it) {
+    dedup_hash_element(_h,*_it);
+    _bytes += dedup_element_bytes(*_it);
+  }
+  dedup_add_field(key,size_t(array->size()));
+  dedup_add_field(key,_h);
+  SceneDeduplicator::ArrayRef _ref;
+  _ref.array = RefCountObjectPtr(array.get());
+  _ref.equal = &dedup_equal_array<ArrayT>;
+  _ref.bytes = _bytes;
+  key.arrays.push_back(_ref);
+}
+
+template<class MatrixT>
+void dedup_add_matrix( SceneDeduplicator::Key& key, const RCPtr<MatrixT>& matrix ) {
+  if (matrix) {
+    dedup_add_field(key,matrix->getRowNb());
+    dedup_add_field(key,matrix->getColumnNb());
+  }
+  dedup_add_array(key,matrix);
+}
+
+/* ----------------------------------------------------------------------- */
+
+#define GEOM_DEDUP_BEGIN(type,obj) \
+  GEOM_ASSERT(obj); \
+  if (isVisited(obj)) return true; \
+  Key _key; \
+  beginKey(_key,#type,obj); \
+
+#define GEOM_DEDUP_END(obj) \
+  return endKey(_key,obj,sizeof(*obj)); \
+
+#define GEOM_DEDUP_FIELD(obj,field) \
+  dedup_add_field(_key,obj->get##field());
+
+#define GEOM_DEDUP_ARRAY(obj,field) \
+  dedup_add_array(_key,obj->get##field());
+
+#define GEOM_DEDUP_MATRIX(obj,field) \
+  dedup_add_matrix(_key,obj->get##field());
+
+#define GEOM_DEDUP_CHILD(obj,field) \
+  canonicalize(obj->get##field()); \
+  dedup_add_child(_key,obj->get##field());
+
+#define GEOM_DEDUP_CHILDREN(obj,field) \
+  if (obj->get##field()) { \
+    dedup_add_field(_key,size_t(obj->get##field()->size())); \
+    for (uint_t _i = 0; _i < obj->get##field()->size(); ++_i) { \
+      canonicalize(obj->get##field()->getAt(_i)); \
+      dedup_add_child(_key,obj->get##field()->getAt(_i)); \
+    } \
+  } \
+  else _key.fields.push_back('\0');
+
+#define GEOM_DEDUP_MESH(obj) \
+  GEOM_DEDUP_FIELD(obj,CCW) \
+  GEOM_DEDUP_FIELD(obj,Solid) \
+  GEOM_DEDUP_FIELD(obj,NormalPerVertex) \
+  GEOM_DEDUP_FIELD(obj,ColorPerVertex) \
+  GEOM_DEDUP_ARRAY(obj,PointList) \
+  GEOM_DEDUP_ARRAY(obj,IndexList) \
+  GEOM_DEDUP_ARRAY(obj,NormalList) \
+  GEOM_DEDUP_ARRAY(obj,NormalIndexList) \
+  GEOM_DEDUP_ARRAY(obj,ColorList) \
+  GEOM_DEDUP_ARRAY(obj,ColorIndexList) \
+  GEOM_DEDUP_ARRAY(obj,TexCoordList) \
+  GEOM_DEDUP_ARRAY(obj,TexCoordIndexList) \
+  GEOM_DEDUP_CHILD(obj,Skeleton)
+
+/* ----------------------------------------------------------------------- */
+
+SceneDeduplicator::SceneDeduplicator( bool ignoreNames ) :
+  Action(),
+  __keys(),
+  __canonical(),
+  __result(),
+  __ignoreNames(ignoreNames),
+  __visitedNb(0),
+  __duplicateNb(0),
+  __savedMemory(0){
+}
+
+SceneDeduplicator::~SceneDeduplicator( ) {
+}
+
+void SceneDeduplicator::clear( ) {
+  __keys.clear();
+  __canonical.clear();
+  __result = SceneObjectPtr();
+  __visitedNb = 0;
+  __duplicateNb = 0;
+  __savedMemory = 0;
+}
+
+uint_t SceneDeduplicator::deduplicate( const ScenePtr& scene ) {
+  if (!scene) return 0;
+  uint_t _duplicateNb = __duplicateNb;
+  scene->apply(*this);
+  __result = SceneObjectPtr();
+  __canonical.clear();
+  return __duplicateNb - _duplicateNb;
+}
+
+SceneObjectPtr SceneDeduplicator::deduplicate( const SceneObjectPtr& object ) {
+  if (!object) return object;
+  __result = SceneObjectPtr();
+  object->apply(*this);
+  SceneObjectPtr _result = (__result ? __result : object);
+  __canonical.clear();
+  return _result;
+}
+
+/* ----------------------------------------------------------------------- */
+
+bool SceneDeduplicator::isVisited( SceneObject * object ) {
+  CanonicalMap::const_iterator _it = __canonical.find(object->SceneObject::getId());
+  if (_it == __canonical.end()) return false;
+  __result = _it->second.second;
+  return true;
+}
+
+/* The names given by the shapes to their unnamed geometry and appearance
+   end with the id of the object (see Shape::setComputedName). */
+static bool dedup_is_computed_name( SceneObject * object ) {
+  const std::string& _name = object->getName();
+  std::string _suffix = "_" + number(object->getId());
+  return _name.size() > _suffix.size() &&
+         _name.compare(_name.size()-_suffix.size(),_suffix.size(),_suffix) == 0;
+}
+
+void SceneDeduplicator::beginKey( Key& key, const char * type, SceneObject * object ) const {
+  key.fields.append(type);
+  key.fields.push_back('\0');
+  if (!__ignoreNames && object->isNamed() && !dedup_is_computed_name(object))
+    dedup_add_field(key,object->getName());
+  else key.fields.push_back('\0');
+}
+
+bool SceneDeduplicator::endKey( Key& key, SceneObject * object, size_t objectSize ) {
+  ++__visitedNb;
+  unsigned long long _h = DEDUP_FNV_OFFSET;
+  dedup_hash(_h,key.fields.data(),key.fields.size());
+  KeyList& _candidates = __keys[size_t(_h)];
+  for (KeyList::const_iterator _it = _candidates.begin(); _it != _candidates.end(); ++_it) {
+    if (_it->fields != key.fields || _it->arrays.size() != key.arrays.size()) continue;
+    bool _equal = true;
+    for (size_t _i = 0; _equal && _i < key.arrays.size(); ++_i)
+      _equal = key.arrays[_i].equal(key.arrays[_i].array.get(),_it->arrays[_i].array.get());
+    if (!_equal) continue;
+    __canonical[object->SceneObject::getId()] = VisitedObject(SceneObjectPtr(object),_it->object);
+    __result = _it->object;
+    // A canonical instance of a previous deduplication.
+    if (_it->object.get() == object) return true;
+    // The arrays already shared with the canonical instance are not released.
+    size_t _saved = objectSize;
+    for (size_t _i = 0; _i < key.arrays.size(); ++_i)
+      if (key.arrays[_i].array.get() != _it->arrays[_i].array.get()) _saved += key.arrays[_i].bytes;
+    __savedMemory += _saved;
+    ++__duplicateNb;
+    return true;
+  }
+  key.object = SceneObjectPtr(object);
+  _candidates.push_back(key);
+  __canonical[object->SceneObject::getId()] = VisitedObject(key.object,key.object);
+  __result = key.object;
+  return true;
+}
+
+/* ----------------------------------------------------------------------- */
+
+bool SceneDeduplicator::process( Shape * shape ) {
+  GEOM_ASSERT(shape);
+  canonicalize(shape->getGeometry());
+  canonicalize(shape->getAppearance());
+  __result = SceneObjectPtr();
+  return true;
+}
+
+/* ----------------------------------------------------------------------- */
+
+bool SceneDeduplicator::process( Material * material ) {
+  GEOM_DEDUP_BEGIN(Material,material);
+  GEOM_DEDUP_FIELD(material,Ambient);
+  GEOM_DEDUP_FIELD(material,Diffuse);
+  GEOM_DEDUP_FIELD(material,Specular);
+  GEOM_DEDUP_FIELD(material,Emission);
+  GEOM_DEDUP_FIELD(material,Shininess);
+  GEOM_DEDUP_FIELD(material,Transparency);
+  GEOM_DEDUP_END(material);
+}
+
+bool SceneDeduplicator::process( MonoSpectral * monoSpectral ) {
+  GEOM_DEDUP_BEGIN(MonoSpectral,monoSpectral);
+  GEOM_DEDUP_FIELD(monoSpectral,Reflectance);
+  GEOM_DEDUP_FIELD(monoSpectral,Transmittance);
+  GEOM_DEDUP_END(monoSpectral);
+}
+
+bool SceneDeduplicator::process( MultiSpectral * multiSpectral ) {
+  GEOM_DEDUP_BEGIN(MultiSpectral,multiSpectral);
+  GEOM_DEDUP_FIELD(multiSpectral,Filter);
+  GEOM_DEDUP_ARRAY(multiSpectral,Reflectance);
+  GEOM_DEDUP_ARRAY(multiSpectral,Transmittance);
+  GEOM_DEDUP_END(multiSpectral);
+}
+
+bool SceneDeduplicator::process( ImageTexture * texture ) {
+  GEOM_DEDUP_BEGIN(ImageTexture,texture);
+  GEOM_DEDUP_FIELD(texture,Filename);
+  GEOM_DEDUP_FIELD(texture,Mipmaping);
+  GEOM_DEDUP_FIELD(texture,RepeatS);
+  GEOM_DEDUP_FIELD(texture,RepeatT);
+  GEOM_DEDUP_END(texture);
+}
+
+bool SceneDeduplicator::process( Texture2D * texture ) {
+  GEOM_DEDUP_BEGIN(Texture2D,texture);
+  GEOM_DEDUP_CHILD(texture,Image);
+  GEOM_DEDUP_CHILD(texture,Transformation);
+  GEOM_DEDUP_FIELD(texture,BaseColor);
+  GEOM_DEDUP_END(texture);
+}
+
+bool SceneDeduplicator::process( Texture2DTransformation * texturetransformation ) {
+  GEOM_DEDUP_BEGIN(Texture2DTransformation,texturetransformation);
+  GEOM_DEDUP_FIELD(texturetransformation,Scale);
+  GEOM_DEDUP_FIELD(texturetransformation,Translation);
+  GEOM_DEDUP_FIELD(texturetransformation,RotationCenter);
+  GEOM_DEDUP_FIELD(texturetransformation,RotationAngle);
+  GEOM_DEDUP_END(texturetransformation);
+}
+
+/* ----------------------------------------------------------------------- */
+
+bool SceneDeduplicator::process( AmapSymbol * amapSymbol ) {
+  GEOM_DEDUP_BEGIN(AmapSymbol,amapSymbol);
+  GEOM_DEDUP_FIELD(amapSymbol,FileName);
+  GEOM_DEDUP_MESH(amapSymbol);
+  GEOM_DEDUP_ARRAY(amapSymbol,TexCoord3List);
+  GEOM_DEDUP_END(amapSymbol);
+}
+
+bool SceneDeduplicator::process( AsymmetricHull * asymmetricHull ) {
+  GEOM_DEDUP_BEGIN(AsymmetricHull,asymmetricHull);
+  GEOM_DEDUP_FIELD(asymmetricHull,NegXRadius);
+  GEOM_DEDUP_FIELD(asymmetricHull,PosXRadius);
+  GEOM_DEDUP_FIELD(asymmetricHull,NegYRadius);
+  GEOM_DEDUP_FIELD(asymmetricHull,PosYRadius);
+  GEOM_DEDUP_FIELD(asymmetricHull,NegXHeight);
+  GEOM_DEDUP_FIELD(asymmetricHull,PosXHeight);
+  GEOM_DEDUP_FIELD(asymmetricHull,NegYHeight);
+  GEOM_DEDUP_FIELD(asymmetricHull,PosYHeight);
+  GEOM_DEDUP_FIELD(asymmetricHull,Bottom);
+  GEOM_DEDUP_FIELD(asymmetricHull,Top);
+  GEOM_DEDUP_FIELD(asymmetricHull,BottomShape);
+  GEOM_DEDUP_FIELD(asymmetricHull,TopShape);
+  GEOM_DEDUP_FIELD(asymmetricHull,Slices);
+  GEOM_DEDUP_FIELD(asymmetricHull,Stacks);
+  GEOM_DEDUP_END(asymmetricHull);
+}
+
+bool SceneDeduplicator::process( AxisRotated * axisRotated ) {
+  GEOM_DEDUP_BEGIN(AxisRotated,axisRotated);
+  GEOM_DEDUP_FIELD(axisRotated,Axis);
+  GEOM_DEDUP_FIELD(axisRotated,Angle);
+  GEOM_DEDUP_CHILD(axisRotated,Geometry);
+  GEOM_DEDUP_END(axisRotated);
+}
+
+bool SceneDeduplicator::process( BezierCurve * bezierCurve ) {
+  GEOM_DEDUP_BEGIN(BezierCurve,bezierCurve);
+  GEOM_DEDUP_FIELD(bezierCurve,Degree);
+  GEOM_DEDUP_FIELD(bezierCurve,Stride);
+  GEOM_DEDUP_FIELD(bezierCurve,Width);
+  GEOM_DEDUP_ARRAY(bezierCurve,CtrlPointList);
+  GEOM_DEDUP_END(bezierCurve);
+}
+
+bool SceneDeduplicator::process( BezierPatch * bezierPatch ) {
+  GEOM_DEDUP_BEGIN(BezierPatch,bezierPatch);
+  GEOM_DEDUP_FIELD(bezierPatch,UStride);
+  GEOM_DEDUP_FIELD(bezierPatch,VStride);
+  GEOM_DEDUP_FIELD(bezierPatch,CCW);
+  GEOM_DEDUP_MATRIX(bezierPatch,CtrlPointMatrix);
+  GEOM_DEDUP_END(bezierPatch);
+}
+
+bool SceneDeduplicator::process( Box * box ) {
+  GEOM_DEDUP_BEGIN(Box,box);
+  GEOM_DEDUP_FIELD(box,Size);
+  GEOM_DEDUP_END(box);
+}
+
+bool SceneDeduplicator::process( Cone * cone ) {
+  GEOM_DEDUP_BEGIN(Cone,cone);
+  GEOM_DEDUP_FIELD(cone,Radius);
+  GEOM_DEDUP_FIELD(cone,Height);
+  GEOM_DEDUP_FIELD(cone,Solid);
+  GEOM_DEDUP_FIELD(cone,Slices);
+  GEOM_DEDUP_END(cone);
+}
+
+bool SceneDeduplicator::process( Cylinder * cylinder ) {
+  GEOM_DEDUP_BEGIN(Cylinder,cylinder);
+  GEOM_DEDUP_FIELD(cylinder,Radius);
+  GEOM_DEDUP_FIELD(cylinder,Height);
+  GEOM_DEDUP_FIELD(cylinder,Solid);
+  GEOM_DEDUP_FIELD(cylinder,Slices);
+  GEOM_DEDUP_END(cylinder);
+}
+
+bool SceneDeduplicator::process( ElevationGrid * elevationGrid ) {
+  GEOM_DEDUP_BEGIN(ElevationGrid,elevationGrid);
+  GEOM_DEDUP_FIELD(elevationGrid,XSpacing);
+  GEOM_DEDUP_FIELD(elevationGrid,YSpacing);
+  GEOM_DEDUP_FIELD(elevationGrid,CCW);
+  GEOM_DEDUP_MATRIX(elevationGrid,HeightList);
+  GEOM_DEDUP_END(elevationGrid);
+}
+
+bool SceneDeduplicator::process( EulerRotated * eulerRotated ) {
+  GEOM_DEDUP_BEGIN(EulerRotated,eulerRotated);
+  GEOM_DEDUP_FIELD(eulerRotated,Azimuth);
+  GEOM_DEDUP_FIELD(eulerRotated,Elevation);
+  GEOM_DEDUP_FIELD(eulerRotated,Roll);
+  GEOM_DEDUP_CHILD(eulerRotated,Geometry);
+  GEOM_DEDUP_END(eulerRotated);
+}
+
+bool SceneDeduplicator::process( ExtrudedHull * extrudedHull ) {
+  GEOM_DEDUP_BEGIN(ExtrudedHull,extrudedHull);
+  GEOM_DEDUP_FIELD(extrudedHull,CCW);
+  GEOM_DEDUP_CHILD(extrudedHull,Vertical);
+  GEOM_DEDUP_CHILD(extrudedHull,Horizontal);
+  GEOM_DEDUP_END(extrudedHull);
+}
+
+bool SceneDeduplicator::process( FaceSet * faceSet ) {
+  GEOM_DEDUP_BEGIN(FaceSet,faceSet);
+  GEOM_DEDUP_MESH(faceSet);
+  GEOM_DEDUP_END(faceSet);
+}
+
+bool SceneDeduplicator::process( Frustum * frustum ) {
+  GEOM_DEDUP_BEGIN(Frustum,frustum);
+  GEOM_DEDUP_FIELD(frustum,Radius);
+  GEOM_DEDUP_FIELD(frustum,Height);
+  GEOM_DEDUP_FIELD(frustum,Taper);
+  GEOM_DEDUP_FIELD(frustum,Solid);
+  GEOM_DEDUP_FIELD(frustum,Slices);
+  GEOM_DEDUP_END(frustum);
+}
+
+bool SceneDeduplicator::process( Extrusion * extrusion ) {
+  GEOM_DEDUP_BEGIN(Extrusion,extrusion);
+  GEOM_DEDUP_FIELD(extrusion,Solid);
+  GEOM_DEDUP_FIELD(extrusion,CCW);
+  GEOM_DEDUP_FIELD(extrusion,InitialNormal);
+  GEOM_DEDUP_CHILD(extrusion,Axis);
+  GEOM_DEDUP_CHILD(extrusion,CrossSection);
+  ProfileTransformationPtr _profile = extrusion->getProfileTransformation();
+  if (_profile) {
+    GEOM_DEDUP_ARRAY(_profile,Scale);
+    GEOM_DEDUP_ARRAY(_profile,Orientation);
+    GEOM_DEDUP_ARRAY(_profile,KnotList);
+  }
+  else _key.fields.push_back('\0');
+  GEOM_DEDUP_END(extrusion);
+}
+
+bool SceneDeduplicator::process( Group * group ) {
+  GEOM_DEDUP_BEGIN(Group,group);
+  GEOM_DEDUP_CHILDREN(group,GeometryList);
+  GEOM_DEDUP_CHILD(group,Skeleton);
+  GEOM_DEDUP_END(group);
+}
+
+bool SceneDeduplicator::process( IFS * ifs ) {
+  GEOM_DEDUP_BEGIN(IFS,ifs);
+  GEOM_DEDUP_FIELD(ifs,Depth);
+  GEOM_DEDUP_ARRAY(ifs,TransfoList);
+  GEOM_DEDUP_CHILD(ifs,Geometry);
+  GEOM_DEDUP_END(ifs);
+}
+
+bool SceneDeduplicator::process( NurbsCurve * nurbsCurve ) {
+  GEOM_DEDUP_BEGIN(NurbsCurve,nurbsCurve);
+  GEOM_DEDUP_FIELD(nurbsCurve,Degree);
+  GEOM_DEDUP_FIELD(nurbsCurve,Stride);
+  GEOM_DEDUP_FIELD(nurbsCurve,Width);
+  GEOM_DEDUP_ARRAY(nurbsCurve,KnotList);
+  GEOM_DEDUP_ARRAY(nurbsCurve,CtrlPointList);
+  GEOM_DEDUP_END(nurbsCurve);
+}
+
+bool SceneDeduplicator::process( NurbsPatch * nurbsPatch ) {
+  GEOM_DEDUP_BEGIN(NurbsPatch,nurbsPatch);
+  GEOM_DEDUP_FIELD(nurbsPatch,UDegree);
+  GEOM_DEDUP_FIELD(nurbsPatch,VDegree);
+  GEOM_DEDUP_FIELD(nurbsPatch,UStride);
+  GEOM_DEDUP_FIELD(nurbsPatch,VStride);
+  GEOM_DEDUP_FIELD(nurbsPatch,CCW);
+  GEOM_DEDUP_ARRAY(nurbsPatch,UKnotList);
+  GEOM_DEDUP_ARRAY(nurbsPatch,VKnotList);
+  GEOM_DEDUP_MATRIX(nurbsPatch,CtrlPointMatrix);
+  GEOM_DEDUP_END(nurbsPatch);
+}
+
+bool SceneDeduplicator::process( Oriented * oriented ) {
+  GEOM_DEDUP_BEGIN(Oriented,oriented);
+  GEOM_DEDUP_FIELD(oriented,Primary);
+  GEOM_DEDUP_FIELD(oriented,Secondary);
+  GEOM_DEDUP_CHILD(oriented,Geometry);
+  GEOM_DEDUP_END(oriented);
+}
+
+bool SceneDeduplicator::process( Paraboloid * paraboloid ) {
+  GEOM_DEDUP_BEGIN(Paraboloid,paraboloid);
+  GEOM_DEDUP_FIELD(paraboloid,Radius);
+  GEOM_DEDUP_FIELD(paraboloid,Height);
+  GEOM_DEDUP_FIELD(paraboloid,Shape);
+  GEOM_DEDUP_FIELD(paraboloid,Solid);
+  GEOM_DEDUP_FIELD(paraboloid,Slices);
+  GEOM_DEDUP_FIELD(paraboloid,Stacks);
+  GEOM_DEDUP_END(paraboloid);
+}
+
+bool SceneDeduplicator::process( PointSet * pointSet ) {
+  GEOM_DEDUP_BEGIN(PointSet,pointSet);
+  GEOM_DEDUP_FIELD(pointSet,Width);
+  GEOM_DEDUP_ARRAY(pointSet,PointList);
+  GEOM_DEDUP_ARRAY(pointSet,ColorList);
+  GEOM_DEDUP_END(pointSet);
+}
+
+bool SceneDeduplicator::process( Polyline * polyline ) {
+  GEOM_DEDUP_BEGIN(Polyline,polyline);
+  GEOM_DEDUP_FIELD(polyline,Width);
+  GEOM_DEDUP_ARRAY(polyline,PointList);
+  GEOM_DEDUP_ARRAY(polyline,ColorList);
+  GEOM_DEDUP_END(polyline);
+}
+
+bool SceneDeduplicator::process( QuadSet * quadSet ) {
+  GEOM_DEDUP_BEGIN(QuadSet,quadSet);
+  GEOM_DEDUP_MESH(quadSet);
+  GEOM_DEDUP_END(quadSet);
+}
+
+bool SceneDeduplicator::process( Revolution * revolution ) {
+  GEOM_DEDUP_BEGIN(Revolution,revolution);
+  GEOM_DEDUP_FIELD(revolution,Slices);
+  GEOM_DEDUP_CHILD(revolution,Profile);
+  GEOM_DEDUP_END(revolution);
+}
+
+bool SceneDeduplicator::process( Swung * swung ) {
+  GEOM_DEDUP_BEGIN(Swung,swung);
+  GEOM_DEDUP_FIELD(swung,Slices);
+  GEOM_DEDUP_FIELD(swung,CCW);
+  GEOM_DEDUP_FIELD(swung,Degree);
+  GEOM_DEDUP_FIELD(swung,Stride);
+  GEOM_DEDUP_ARRAY(swung,AngleList);
+  GEOM_DEDUP_CHILDREN(swung,ProfileList);
+  GEOM_DEDUP_END(swung);
+}
+
+bool SceneDeduplicator::process( Scaled * scaled ) {
+  GEOM_DEDUP_BEGIN(Scaled,scaled);
+  GEOM_DEDUP_FIELD(scaled,Scale);
+  GEOM_DEDUP_CHILD(scaled,Geometry);
+  GEOM_DEDUP_END(scaled);
+}
+
+bool SceneDeduplicator::process( ScreenProjected * screenprojected ) {
+  GEOM_DEDUP_BEGIN(ScreenProjected,screenprojected);
+  GEOM_DEDUP_FIELD(screenprojected,KeepAspectRatio);
+  GEOM_DEDUP_CHILD(screenprojected,Geometry);
+  GEOM_DEDUP_END(screenprojected);
+}
+
+bool SceneDeduplicator::process( Sphere * sphere ) {
+  GEOM_DEDUP_BEGIN(Sphere,sphere);
+  GEOM_DEDUP_FIELD(sphere,Radius);
+  GEOM_DEDUP_FIELD(sphere,Slices);
+  GEOM_DEDUP_FIELD(sphere,Stacks);
+  GEOM_DEDUP_END(sphere);
+}
+
+bool SceneDeduplicator::process( Tapered * tapered ) {
+  GEOM_DEDUP_BEGIN(Tapered,tapered);
+  GEOM_DEDUP_FIELD(tapered,BaseRadius);
+  GEOM_DEDUP_FIELD(tapered,TopRadius);
+  GEOM_DEDUP_CHILD(tapered,Primitive);
+  GEOM_DEDUP_END(tapered);
+}
+
+bool SceneDeduplicator::process( Translated * translated ) {
+  GEOM_DEDUP_BEGIN(Translated,translated);
+  GEOM_DEDUP_FIELD(translated,Translation);
+  GEOM_DEDUP_CHILD(translated,Geometry);
+  GEOM_DEDUP_END(translated);
+}
+
+bool SceneDeduplicator::process( TriangleSet * triangleSet ) {
+  GEOM_DEDUP_BEGIN(TriangleSet,triangleSet);
+  GEOM_DEDUP_MESH(triangleSet);
+  GEOM_DEDUP_END(triangleSet);
+}
+
+/* ----------------------------------------------------------------------- */
+
+bool SceneDeduplicator::process( BezierCurve2D * bezierCurve ) {
+  GEOM_DEDUP_BEGIN(BezierCurve2D,bezierCurve);
+  GEOM_DEDUP_FIELD(bezierCurve,Degree);
+  GEOM_DEDUP_FIELD(bezierCurve,Stride);
+  GEOM_DEDUP_FIELD(bezierCurve,Width);
+  GEOM_DEDUP_ARRAY(bezierCurve,CtrlPointList);
+  GEOM_DEDUP_END(bezierCurve);
+}
+
+bool SceneDeduplicator::process( Disc * disc ) {
+  GEOM_DEDUP_BEGIN(Disc,disc);
+  GEOM_DEDUP_FIELD(disc,Radius);
+  GEOM_DEDUP_FIELD(disc,Slices);
+  GEOM_DEDUP_END(disc);
+}
+
+bool SceneDeduplicator::process( NurbsCurve2D * nurbsCurve ) {
+  GEOM_DEDUP_BEGIN(NurbsCurve2D,nurbsCurve);
+  GEOM_DEDUP_FIELD(nurbsCurve,Degree);
+  GEOM_DEDUP_FIELD(nurbsCurve,Stride);
+  GEOM_DEDUP_FIELD(nurbsCurve,Width);
+  GEOM_DEDUP_ARRAY(nurbsCurve,KnotList);
+  GEOM_DEDUP_ARRAY(nurbsCurve,CtrlPointList);
+  GEOM_DEDUP_END(nurbsCurve);
+}
+
+bool SceneDeduplicator::process( PointSet2D * pointSet ) {
+  GEOM_DEDUP_BEGIN(PointSet2D,pointSet);
+  GEOM_DEDUP_FIELD(pointSet,Width);
+  GEOM_DEDUP_ARRAY(pointSet,PointList);
+  GEOM_DEDUP_END(pointSet);
+}
+
+bool SceneDeduplicator::process( Polyline2D * polyline ) {
+  GEOM_DEDUP_BEGIN(Polyline2D,polyline);
+  GEOM_DEDUP_FIELD(polyline,Width);
+  GEOM_DEDUP_ARRAY(polyline,PointList);
+  GEOM_DEDUP_END(polyline);
+}
+
+/* ----------------------------------------------------------------------- */
+
+bool SceneDeduplicator::process( Text * text ) {
+  GEOM_DEDUP_BEGIN(Text,text);
+  GEOM_DEDUP_FIELD(text,String);
+  GEOM_DEDUP_FIELD(text,Position);
+  GEOM_DEDUP_FIELD(text,ScreenCoordinates);
+  GEOM_DEDUP_CHILD(text,FontStyle);
+  GEOM_DEDUP_END(text);
+}
+
+bool SceneDeduplicator::process( Font * font ) {
+  GEOM_DEDUP_BEGIN(Font,font);
+  GEOM_DEDUP_FIELD(font,Family);
+  GEOM_DEDUP_FIELD(font,Size);
+  GEOM_DEDUP_FIELD(font,Bold);
+  GEOM_DEDUP_FIELD(font,Italic);
+  GEOM_DEDUP_END(font);
+}
+
+/* ----------------------------------------------------------------------- */
@@ -0,0 +1,282 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2006 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *  ----------------------------------------------------------------------------
+ */
+
+/*! \file actn_scenededuplicator.h
+    \brief Definition of the action class SceneDeduplicator.
+*/
+
+
+#ifndef __actn_scenededuplicator_h__
+#define __actn_scenededuplicator_h__
+
+#include <plantgl/pgl_config.h>
+#include "../algo_config.h"
+#include <plantgl/scenegraph/core/action.h>
+#include <plantgl/scenegraph/core/sceneobject.h>
+#include <plantgl/scenegraph/scene/scene.h>
+#include <plantgl/tool/util_hashmap.h>
+#include <string>
+#include <vector>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/**
+   \class SceneDeduplicator
+   \brief An action which replaces structurally identical geometries and appearances by a single shared instance.
+
+   Objects are compared bottom-up: the children of an object are deduplicated first,
+   so that two objects are identical when their fields and arrays have the same values and
+   they refer to the same (deduplicated) children. Arrays are compared by a hash of their
+   content, confirmed by an exact comparison. Shapes keep their identity; only their
+   geometry and appearance are replaced. Objects with different names are kept apart
+   unless names are ignored. The names computed by the shapes for their unnamed geometry
+   and appearance do not count.
+
+   The canonical instances are kept between successive calls, so that several scenes
+   processed by the same SceneDeduplicator share their objects. Call clear() to release them.
+*/
+
+class ALGO_API SceneDeduplicator : public Action
+{
+public:
+
+  /// Constructs a SceneDeduplicator.
+  SceneDeduplicator( bool ignoreNames = false );
+
+  /// Destructor
+  virtual ~SceneDeduplicator( );
+
+  /// Releases the canonical instances and resets the statistics.
+  void clear( );
+
+  /// Deduplicates in place the objects of \e scene. Returns the number of replaced objects.
+  uint_t deduplicate( const ScenePtr& scene );
+
+  /// Returns the canonical instance of \e object, deduplicating its children on the way.
+  SceneObjectPtr deduplicate( const SceneObjectPtr& object );
+
+  /// Returns the canonical instance of the last processed object.
+  inline const SceneObjectPtr& getResult( ) const { return __result; }
+
+  /// Returns whether the names of the objects are ignored in the comparison.
+  inline bool getIgnoreNames( ) const { return __ignoreNames; }
+
+  /// Sets whether the names of the objects are ignored in the comparison.
+  inline void setIgnoreNames( bool ignoreNames ) { __ignoreNames = ignoreNames; }
+
+  /// Returns the number of distinct objects visited.
+  inline uint_t getVisitedNb( ) const { return __visitedNb; }
+
+  /// Returns the number of objects replaced by a canonical instance.
+  inline uint_t getDuplicateNb( ) const { return __duplicateNb; }
+
+  /// Returns an estimate in bytes of the memory released by the replaced objects.
+  inline size_t getSavedMemory( ) const { return __savedMemory; }
+
+  /// @name Shape
+  //@{
+  virtual bool process( Shape * shape );
+  //@}
+
+  /// @name Material
+  //@{
+  virtual bool process( Material * material );
+
+  virtual bool process( MonoSpectral * monoSpectral );
+
+  virtual bool process( MultiSpectral * multiSpectral );
+
+  virtual bool process( ImageTexture * texture );
+
+  virtual bool process( Texture2D * texture );
+
+  virtual bool process( Texture2DTransformation * texturetransformation );
+  //@}
+
+  /// @name Geom3D
+  //@{
+  virtual bool process( AmapSymbol * amapSymbol );
+
+  virtual bool process( AsymmetricHull * asymmetricHull );
+
+  virtual bool process( AxisRotated * axisRotated );
+
+  virtual bool process( BezierCurve * bezierCurve );
+
+  virtual bool process( BezierPatch * bezierPatch );
+
+  virtual bool process( Box * box );
+
+  virtual bool process( Cone * cone );
+
+  virtual bool process( Cylinder * cylinder );
+
+  virtual bool process( ElevationGrid * elevationGrid );
+
+  virtual bool process( EulerRotated * eulerRotated );
+
+  virtual bool process( ExtrudedHull * extrudedHull );
+
+  virtual bool process( FaceSet * faceSet );
+
+  virtual bool process( Frustum * frustum );
+
+  virtual bool process( Extrusion * extrusion );
+
+  virtual bool process( Group * group );
+
+  virtual bool process( IFS * ifs );
+
+  virtual bool process( NurbsCurve * nurbsCurve );
+
+  virtual bool process( NurbsPatch * nurbsPatch );
+
+  virtual bool process( Oriented * oriented );
+
+  virtual bool process( Paraboloid * paraboloid );
+
+  virtual bool process( PointSet * pointSet );
+
+  virtual bool process( Polyline * polyline );
+
+  virtual bool process( QuadSet * quadSet );
+
+  virtual bool process( Revolution * revolution );
+
+  virtual bool process( Swung * swung );
+
+  virtual bool process( Scaled * scaled );
+
+  virtual bool process( ScreenProjected * screenprojected );
+
+  virtual bool process( Sphere * sphere );
+
+  virtual bool process( Tapered * tapered );
+
+  virtual bool process( Translated * translated );
+
+  virtual bool process( TriangleSet * triangleSet );
+  //@}
+
+  /// @name Geom2D
+  //@{
+  virtual bool process( BezierCurve2D * bezierCurve );
+
+  virtual bool process( Disc * disc );
+
+  virtual bool process( NurbsCurve2D * nurbsCurve );
+
+  virtual bool process( PointSet2D * pointSet );
+
+  virtual bool process( Polyline2D * polyline );
+  //@}
+
+  virtual bool process( Text * text );
+
+  virtual bool process( Font * font );
+
+  /// A reference on an array of a key, with the function comparing its content.
+  struct ArrayRef {
+    TOOLS(RefCountObjectPtr) array;
+    bool (* equal)( const TOOLS(RefCountObject) *, const TOOLS(RefCountObject) * );
+    size_t bytes;
+  };
+
+  /// The structural key of an object.
+  struct Key {
+    /// The type, the fields, the ids of the children and the hashes of the arrays.
+    std::string fields;
+    /// The arrays, for the exact comparison.
+    std::vector<ArrayRef> arrays;
+    /// The canonical object with this key.
+    SceneObjectPtr object;
+  };
+
+protected:
+
+  /// Returns whether \e object has already been visited, setting the result to its canonical instance.
+  bool isVisited( SceneObject * object );
+
+  /// Starts the key of \e object.
+  void beginKey( Key& key, const char * type, SceneObject * object ) const;
+
+  /// Looks for an object with the same key, or registers \e object as canonical instance.
+  bool endKey( Key& key, SceneObject * object, size_t objectSize );
+
+  /// Replaces \e child by its canonical instance.
+  template<class T>
+  void canonicalize( RCPtr<T>& child ) {
+    if (!child) return;
+    __result = SceneObjectPtr();
+    child->apply(*this);
+    if (__result && __result.get() != child.get()) {
+      RCPtr<T> canonical = dynamic_pointer_cast<T>(__result);
+      if (canonical) child = canonical;
+    }
+  }
+
+  typedef std::vector<Key> KeyList;
+  typedef pgl_hash_map<size_t,KeyList> KeyTable;
+  typedef std::pair<SceneObjectPtr,SceneObjectPtr> VisitedObject;
+  typedef pgl_hash_map<size_t,VisitedObject> CanonicalMap;
+
+  /// The canonical instances sorted by hash of their key.
+  KeyTable __keys;
+
+  /** The visited objects and their canonical instance, indexed by their ids, during a deduplication.
+      The visited objects are held so that their ids are not given to new objects. */
+  CanonicalMap __canonical;
+
+  /// The canonical instance of the last processed object.
+  SceneObjectPtr __result;
+
+  bool __ignoreNames;
+
+  uint_t __visitedNb;
+
+  uint_t __duplicateNb;
+
+  size_t __savedMemory;
+
+};
+
+/* ------------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+/* ------------------------------------------------------------------------- */
+
+#endif
@@ -0,0 +1,149 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2006 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+#include "sceneobjectcollector.h"
+
+#include <plantgl/pgl_appearance.h>
+#include <plantgl/pgl_geometry.h>
+#include <plantgl/pgl_transformation.h>
+#include <plantgl/pgl_container.h>
+#include <plantgl/scenegraph/scene/shape.h>
+
+PGL_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+#define GEOM_COLLECT(obj) \
+  GEOM_ASSERT(obj); \
+  if (! __ids.insert(obj->SceneObject::getId()).second) return true; \
+
+#define GEOM_APPLY(obj,field) \
+  if(obj->get##field())obj->get##field()->apply(*this);
+
+#define GEOM_COLLECT_LEAF(type) \
+  bool SceneObjectCollector::process( type * obj ) { \
+    GEOM_COLLECT(obj); \
+    return true; \
+  } \
+
+#define GEOM_COLLECT_ONE(type,field) \
+  bool SceneObjectCollector::process( type * obj ) { \
+    GEOM_COLLECT(obj); \
+    GEOM_APPLY(obj,field); \
+    return true; \
+  } \
+
+#define GEOM_COLLECT_TWO(type,field1,field2) \
+  bool SceneObjectCollector::process( type * obj ) { \
+    GEOM_COLLECT(obj); \
+    GEOM_APPLY(obj,field1); \
+    GEOM_APPLY(obj,field2); \
+    return true; \
+  } \
+
+/* ----------------------------------------------------------------------- */
+
+SceneObjectCollector::SceneObjectCollector( ) :
+  Action(),
+  __ids(){
+}
+
+SceneObjectCollector::~SceneObjectCollector( ) {
+}
+
+void SceneObjectCollector::clear( ) {
+  __ids.clear();
+}
+
+/* ----------------------------------------------------------------------- */
+
+GEOM_COLLECT_TWO(Shape,Geometry,Appearance)
+
+/* ----------------------------------------------------------------------- */
+
+GEOM_COLLECT_LEAF(Material)
+GEOM_COLLECT_LEAF(MonoSpectral)
+GEOM_COLLECT_LEAF(MultiSpectral)
+GEOM_COLLECT_LEAF(ImageTexture)
+GEOM_COLLECT_TWO(Texture2D,Image,Transformation)
+GEOM_COLLECT_LEAF(Texture2DTransformation)
+
+/* ----------------------------------------------------------------------- */
+
+GEOM_COLLECT_ONE(AmapSymbol,Skeleton)
+GEOM_COLLECT_LEAF(AsymmetricHull)
+GEOM_COLLECT_ONE(AxisRotated,Geometry)
+GEOM_COLLECT_LEAF(BezierCurve)
+GEOM_COLLECT_LEAF(BezierPatch)
+GEOM_COLLECT_LEAF(Box)
+GEOM_COLLECT_LEAF(Cone)
+GEOM_COLLECT_LEAF(Cylinder)
+GEOM_COLLECT_LEAF(ElevationGrid)
+GEOM_COLLECT_ONE(EulerRotated,Geometry)
+GEOM_COLLECT_TWO(ExtrudedHull,Vertical,Horizontal)
+GEOM_COLLECT_ONE(FaceSet,Skeleton)
+GEOM_COLLECT_LEAF(Frustum)
+GEOM_COLLECT_TWO(Extrusion,Axis,CrossSection)
+GEOM_COLLECT_TWO(Group,GeometryList,Skeleton)
+GEOM_COLLECT_ONE(IFS,Geometry)
+GEOM_COLLECT_LEAF(NurbsCurve)
+GEOM_COLLECT_LEAF(NurbsPatch)
+GEOM_COLLECT_ONE(Oriented,Geometry)
+GEOM_COLLECT_LEAF(Paraboloid)
+GEOM_COLLECT_LEAF(PointSet)
+GEOM_COLLECT_LEAF(Polyline)
+GEOM_COLLECT_ONE(QuadSet,Skeleton)
+GEOM_COLLECT_ONE(Revolution,Profile)
+GEOM_COLLECT_ONE(Swung,ProfileList)
+GEOM_COLLECT_ONE(Scaled,Geometry)
+GEOM_COLLECT_ONE(ScreenProjected,Geometry)
+GEOM_COLLECT_LEAF(Sphere)
+GEOM_COLLECT_ONE(Tapered,Primitive)
+GEOM_COLLECT_ONE(Translated,Geometry)
+GEOM_COLLECT_ONE(TriangleSet,Skeleton)
+
+/* ----------------------------------------------------------------------- */
+
+GEOM_COLLECT_LEAF(BezierCurve2D)
+GEOM_COLLECT_LEAF(Disc)
+GEOM_COLLECT_LEAF(NurbsCurve2D)
+GEOM_COLLECT_LEAF(PointSet2D)
+GEOM_COLLECT_LEAF(Polyline2D)
+
+/* ----------------------------------------------------------------------- */
+
+GEOM_COLLECT_ONE(Text,FontStyle)
+GEOM_COLLECT_LEAF(Font)
+
+/* ----------------------------------------------------------------------- */
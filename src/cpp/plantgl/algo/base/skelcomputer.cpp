@@ -82,6 +82,10 @@ void SkelComputer::clear( ) {
 //  __skeleton = PolylinePtr();
 }
 
+void SkelComputer::retain( const pgl_hash_set_size_t& ids ) {
+  __cache.retain(ids);
+}
+
 Discretizer&
 SkelComputer::getDiscretizer( ) {
   return __discretizer;
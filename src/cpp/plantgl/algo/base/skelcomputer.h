@@ -42,6 +42,7 @@
 #include <plantgl/scenegraph/core/action.h>
 #include <plantgl/tool/rcobject.h>
 #include <plantgl/tool/util_cache.h>
+#include <plantgl/tool/util_hashset.h>
 #ifndef GEOM_FWDEF
 #include <plantgl/scenegraph/geometry/polyline.h>
 #endif
@@ -80,6 +81,9 @@ public:
   /// Clears \e self.
   void clear( );
 
+  /// Removes from the cache the results of the objects whose id is not in \e ids.
+  void retain( const pgl_hash_set_size_t& ids );
+
   /// Returns the Discretizer attached to \e self.
   Discretizer& getDiscretizer( );
 
@@ -0,0 +1,597 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *  ----------------------------------------------------------------------------
+ */
+
+#include "skeletonpipeline.h"
+#include "pointmanipulation.h"
+#include "pointkdtree.h"
+#include <plantgl/tool/util_parallel.h>
+#include <plantgl/tool/errormsg.h>
+#include <QtCore/QElapsedTimer>
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <string>
+
+PGL_USING_NAMESPACE
+TOOLS_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+// Minimal number of points or groups processed by a thread.
+#define PARALLEL_GRAIN 512
+
+/* ----------------------------------------------------------------------- */
+
+struct KNeighborsFunctor {
+    const PointKDTree * tree;
+    uint32_t k;
+    uint32_t * neighbors;
+    uint32_t * counts;
+
+    void operator()(size_t begin, size_t end, size_t) {
+        std::vector<DistancePoint> heap;
+        heap.reserve(k);
+        OtherPointFilter filter;
+        // points are processed in the order of the tree to query close points successively
+        for (size_t i = begin; i < end; ++i){
+            uint32_t pid = tree->index[i];
+            filter.pid = pid;
+            tree->k_closest(tree->points.getAt(pid),k,filter,heap);
+            counts[pid] = heap.size();
+            for (uint32_t j = 0; j < heap.size(); ++j) neighbors[k * pid + j] = heap[j].second;
+        }
+    }
+};
+
+// Merge of the direct and reverse neighbors of each point. If not fill, only count them.
+struct SymmetrizeFunctor {
+    const std::vector<uint32_t> * offsets;
+    const std::vector<uint32_t> * neighbors;
+    const std::vector<uint32_t> * roffsets;
+    const std::vector<uint32_t> * rneighbors;
+    std::vector<uint32_t> * resoffsets;
+    std::vector<uint32_t> * resneighbors;
+    bool fill;
+
+    void operator()(size_t begin, size_t end, size_t) {
+        for (size_t pid = begin; pid < end; ++pid){
+            uint32_t dbegin = (*offsets)[pid], dend = (*offsets)[pid+1];
+            uint32_t nb = dend - dbegin;
+            uint32_t target = (fill ? (*resoffsets)[pid] : 0);
+            if (fill) for (uint32_t i = dbegin; i < dend; ++i) (*resneighbors)[target++] = (*neighbors)[i];
+            for (uint32_t i = (*roffsets)[pid]; i < (*roffsets)[pid+1]; ++i){
+                uint32_t n = (*rneighbors)[i];
+                if (std::find(neighbors->begin() + dbegin, neighbors->begin() + dend, n) == neighbors->begin() + dend) {
+                    if (fill) (*resneighbors)[target++] = n;
+                    else ++nb;
+                }
+            }
+            if (!fill) (*resoffsets)[pid+1] = nb;
+        }
+    }
+};
+
+static void prefix_sum(std::vector<uint32_t>& offsets)
+{
+    for (size_t i = 1; i < offsets.size(); ++i) offsets[i] += offsets[i-1];
+}
+
+/* Find the closest pair of points between the sets of two trees if their squared distance 
+   is below bound2. In this case, bound2 is updated and the pair (point of a, point of b) is returned. */
+static bool closest_pair(const PointKDTree& a, const PointKDTree& b, real_t& bound2, std::pair<uint32_t,uint32_t>& result)
+{
+    real_t d2 = 0;
+    for (int i = 0; i < 3; ++i){
+        real_t delta = std::max(a.lower[i] - b.upper[i], b.lower[i] - a.upper[i]);
+        if (delta > 0) d2 += delta * delta;
+    }
+    if (d2 >= bound2) return false;
+
+    // points of the smallest set are searched in the tree of the other one
+    bool swapped = a.index.size() > b.index.size();
+    const PointKDTree& query = (swapped ? b : a);
+    const PointKDTree& target = (swapped ? a : b);
+
+    // starts with the point closest to the center of the other set to get quickly a small bound
+    Vector3 center = (target.lower + target.upper) / 2;
+    uint32_t start = 0;
+    real_t startdist = REAL_MAX;
+    for (uint32_t i = 0; i < query.index.size(); ++i){
+        real_t d = normSquared(query.points.getAt(query.index[i]) - center);
+        if (d < startdist) { startdist = d; start = i; }
+    }
+
+    bool found = false;
+    AllPointFilter filter;
+    std::vector<DistancePoint> heap;
+    for (uint32_t i = 0; i < query.index.size(); ++i){
+        uint32_t pid = query.index[i == 0 ? start : (i == start ? 0 : i)];
+        const Vector3& p = query.points.getAt(pid);
+        if (box_distance2(p, target.lower, target.upper) >= bound2) continue;
+        target.k_closest(p,1,filter,heap,bound2);
+        if (!heap.empty()) {
+            bound2 = heap[0].first;
+            result = (swapped ? std::pair<uint32_t,uint32_t>(heap[0].second, pid) : std::pair<uint32_t,uint32_t>(pid, heap[0].second));
+            found = true;
+        }
+    }
+    return found;
+}
+
+// Update the distances of the pending components to the connected ones with a new connected component.
+struct ComponentDistanceFunctor {
+    const std::vector<PointKDTree *> * trees;
+    const std::vector<uint32_t> * pending;
+    uint32_t newcomponent;
+    std::vector<real_t> * distances;
+    std::vector<std::pair<uint32_t,uint32_t> > * connections;
+
+    void operator()(size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i){
+            uint32_t cid = (*pending)[i];
+            closest_pair(*(*trees)[newcomponent], *(*trees)[cid], (*distances)[cid], (*connections)[cid]);
+        }
+    }
+};
+
+/* ----------------------------------------------------------------------- */
+
+// Shortest path distances from root in a graph of points given in compressed rows.
+static void shortest_paths(const Point3Array& points,
+                           const std::vector<uint32_t>& offsets,
+                           const std::vector<uint32_t>& neighbors,
+                           uint32_t root,
+                           std::vector<real_t>& distances,
+                           std::vector<uint32_t>& parents)
+{
+    size_t nbpoints = points.size();
+    distances.assign(nbpoints,REAL_MAX);
+    parents.assign(nbpoints,UINT32_MAX);
+    distances[root] = 0;
+    parents[root] = root;
+    std::priority_queue<DistancePoint, std::vector<DistancePoint>, std::greater<DistancePoint> > queue;
+    queue.push(DistancePoint(0,root));
+    while (!queue.empty()){
+        DistancePoint current = queue.top();
+        queue.pop();
+        uint32_t pid = current.second;
+        if (current.first > distances[pid]) continue;
+        const Vector3& p = points.getAt(pid);
+        for (uint32_t i = offsets[pid]; i < offsets[pid+1]; ++i){
+            uint32_t n = neighbors[i];
+            real_t d = current.first + norm(points.getAt(n) - p);
+            if (d < distances[n]){
+                distances[n] = d;
+                parents[n] = pid;
+                queue.push(DistancePoint(d,n));
+            }
+        }
+    }
+}
+
+struct QuotientAdjacencyFunctor {
+    const std::vector<uint32_t> * offsets;
+    const std::vector<uint32_t> * neighbors;
+    const std::vector<uint32_t> * pointgroup;
+    const std::vector<uint32_t> * groupoffsets;
+    const std::vector<uint32_t> * groupmembers;
+    std::vector<uint32_t> * counts;
+    std::vector<std::vector<uint32_t> > * chunkneighbors;
+
+    void operator()(size_t begin, size_t end, size_t chunk) {
+        std::vector<uint32_t>& result = (*chunkneighbors)[chunk];
+        for (size_t gid = begin; gid < end; ++gid){
+            size_t first = result.size();
+            for (uint32_t i = (*groupoffsets)[gid]; i < (*groupoffsets)[gid+1]; ++i){
+                uint32_t pid = (*groupmembers)[i];
+                for (uint32_t j = (*offsets)[pid]; j < (*offsets)[pid+1]; ++j){
+                    uint32_t ngroup = (*pointgroup)[(*neighbors)[j]];
+                    if (ngroup == gid || ngroup == UINT32_MAX) continue;
+                    if (std::find(result.begin()+first,result.end(),ngroup) == result.end())
+                        result.push_back(ngroup);
+                }
+            }
+            (*counts)[gid+1] = result.size() - first;
+        }
+    }
+};
+
+struct CentroidsFunctor {
+    const Point3Array * points;
+    const std::vector<uint32_t> * groupoffsets;
+    const std::vector<uint32_t> * groupmembers;
+    Point3Array * centroids;
+
+    void operator()(size_t begin, size_t end, size_t) {
+        for (size_t gid = begin; gid < end; ++gid){
+            Vector3 centroid;
+            uint32_t gbegin = (*groupoffsets)[gid], gend = (*groupoffsets)[gid+1];
+            for (uint32_t i = gbegin; i < gend; ++i)
+                centroid += points->getAt((*groupmembers)[i]);
+            centroids->setAt(gid, centroid / real_t(gend - gbegin));
+        }
+    }
+};
+
+/* ----------------------------------------------------------------------- */
+
+SkeletonPipeline::SkeletonPipeline(real_t binsize, uint32_t k, bool connectAllPoints):
+    __binsize(binsize),
+    __k(k),
+    __connectAllPoints(connectAllPoints),
+    __averageRadius(0),
+    __pipeExponent(2.5)
+{
+    for (int i = 0; i < eNbStages; ++i) __times[i] = 0;
+}
+
+SkeletonPipeline::~SkeletonPipeline() { }
+
+const char * SkeletonPipeline::getStageName(Stage stage)
+{
+    static const char * names[eNbStages] = {
+        "neighborhoods", "connection", "distances to root", "quotient",
+        "quotient adjacency", "centroids", "spanning tree", "radii" };
+    if (stage < 0 || stage >= eNbStages) return "";
+    return names[stage];
+}
+
+double SkeletonPipeline::getTotalTime() const
+{
+    double total = 0;
+    for (int i = 0; i < eNbStages; ++i) total += __times[i];
+    return total;
+}
+
+void SkeletonPipeline::clear()
+{
+    __points = Point3ArrayPtr();
+    std::vector<uint32_t>().swap(__offsets);
+    std::vector<uint32_t>().swap(__neighbors);
+    std::vector<real_t>().swap(__distances);
+    std::vector<uint32_t>().swap(__pointgroup);
+    std::vector<uint32_t>().swap(__groupoffsets);
+    std::vector<uint32_t>().swap(__groupmembers);
+    std::vector<uint32_t>().swap(__goffsets);
+    std::vector<uint32_t>().swap(__gneighbors);
+    __nodes = Point3ArrayPtr();
+    __parents = Uint32Array1Ptr();
+    __radii = RealArrayPtr();
+    for (int i = 0; i < eNbStages; ++i) __times[i] = 0;
+}
+
+void SkeletonPipeline::endStage(Stage stage, double time)
+{
+    __times[stage] = time;
+    std::string msg("\x0dSkeleton extraction : %.2f%% (");
+    msg += getStageName(stage);
+    msg += ").";
+    if (stage == eRadii) msg += "\n";
+    print_progressstatus(msg.c_str(), 100.0 * (stage + 1) / eNbStages);
+}
+
+bool SkeletonPipeline::process(const Point3ArrayPtr& points, uint32_t root)
+{
+    clear();
+    if (!points || points->empty()) { pglError("SkeletonPipeline : no points given."); return false; }
+    if (root >= points->size()) { pglError("SkeletonPipeline : invalid root %u.", root); return false; }
+    if (__binsize <= 0) { pglError("SkeletonPipeline : invalid bin size %f.", __binsize); return false; }
+    __points = points;
+
+    QElapsedTimer timer;
+    timer.start();
+    computeNeighborhoods();
+    endStage(eNeighborhood, timer.restart() / 1000.);
+    if (__connectAllPoints) connectComponents();
+    endStage(eConnection, timer.restart() / 1000.);
+    computeDistancesToRoot(root);
+    endStage(eDistanceToRoot, timer.restart() / 1000.);
+    computeQuotient();
+    endStage(eQuotient, timer.restart() / 1000.);
+    computeQuotientAdjacency();
+    endStage(eQuotientAdjacency, timer.restart() / 1000.);
+    computeCentroids();
+    endStage(eCentroids, timer.restart() / 1000.);
+    computeSpanningTree();
+    endStage(eSpanningTree, timer.restart() / 1000.);
+    computeRadii();
+    endStage(eRadii, timer.restart() / 1000.);
+    return true;
+}
+
+void SkeletonPipeline::computeNeighborhoods()
+{
+    const Point3Array& points = *__points;
+    uint32_t nbpoints = points.size();
+    uint32_t k = std::min<uint32_t>(__k, nbpoints - 1);
+    PointKDTree tree(points);
+
+    // the k neighbors of a point i are stored from k * i.
+    std::vector<uint32_t> counts(nbpoints);
+    __neighbors.resize(size_t(nbpoints) * k);
+    KNeighborsFunctor functor;
+    functor.tree = &tree;
+    functor.k = k;
+    functor.neighbors = (k > 0 ? &__neighbors[0] : NULL);
+    functor.counts = &counts[0];
+    parallel_for(nbpoints, functor, PARALLEL_GRAIN);
+
+    __offsets.assign(nbpoints+1,0);
+    for (uint32_t pid = 0; pid < nbpoints; ++pid) __offsets[pid+1] = __offsets[pid] + counts[pid];
+    for (uint32_t pid = 0; pid < nbpoints; ++pid)
+        std::copy(__neighbors.begin() + size_t(k) * pid, __neighbors.begin() + size_t(k) * pid + counts[pid],
+                  __neighbors.begin() + __offsets[pid]);
+    __neighbors.resize(__offsets[nbpoints]);
+
+    if (__connectAllPoints) {
+        // reverse connections, sorted by source
+        std::vector<uint32_t> roffsets(nbpoints+1,0);
+        std::vector<uint32_t> rneighbors(__neighbors.size());
+        for (std::vector<uint32_t>::const_iterator it = __neighbors.begin(); it != __neighbors.end(); ++it)
+            ++roffsets[*it+1];
+        prefix_sum(roffsets);
+        std::vector<uint32_t> fill(roffsets.begin(),roffsets.end()-1);
+        for (uint32_t pid = 0; pid < nbpoints; ++pid)
+            for (uint32_t i = __offsets[pid]; i < __offsets[pid+1]; ++i)
+                rneighbors[fill[__neighbors[i]]++] = pid;
+
+        std::vector<uint32_t> offsets(nbpoints+1,0);
+        std::vector<uint32_t> neighbors;
+        SymmetrizeFunctor sfunctor;
+        sfunctor.offsets = &__offsets;
+        sfunctor.neighbors = &__neighbors;
+        sfunctor.roffsets = &roffsets;
+        sfunctor.rneighbors = &rneighbors;
+        sfunctor.resoffsets = &offsets;
+        sfunctor.resneighbors = &neighbors;
+        sfunctor.fill = false;
+        parallel_for(nbpoints, sfunctor, PARALLEL_GRAIN);
+        prefix_sum(offsets);
+        neighbors.resize(offsets[nbpoints]);
+        sfunctor.fill = true;
+        parallel_for(nbpoints, sfunctor, PARALLEL_GRAIN);
+        __offsets.swap(offsets);
+        __neighbors.swap(neighbors);
+    }
+}
+
+void SkeletonPipeline::connectComponents()
+{
+    const Point3Array& points = *__points;
+    uint32_t nbpoints = points.size();
+
+    // label the connex components
+    std::vector<uint32_t> component(nbpoints,UINT32_MAX);
+    uint32_t nbcomponents = 0;
+    std::vector<uint32_t> stack;
+    for (uint32_t pid = 0; pid < nbpoints; ++pid){
+        if (component[pid] != UINT32_MAX) continue;
+        component[pid] = nbcomponents;
+        stack.push_back(pid);
+        while (!stack.empty()){
+            uint32_t current = stack.back();
+            stack.pop_back();
+            for (uint32_t i = __offsets[current]; i < __offsets[current+1]; ++i){
+                uint32_t n = __neighbors[i];
+                if (component[n] == UINT32_MAX) { component[n] = nbcomponents; stack.push_back(n); }
+            }
+        }
+        ++nbcomponents;
+    }
+    if (nbcomponents == 1) return;
+
+    // points of each component
+    std::vector<uint32_t> componentoffsets(nbcomponents+1,0);
+    for (uint32_t pid = 0; pid < nbpoints; ++pid) ++componentoffsets[component[pid]+1];
+    prefix_sum(componentoffsets);
+    std::vector<uint32_t> componentpoints(nbpoints);
+    std::vector<uint32_t> fill(componentoffsets.begin(),componentoffsets.end()-1);
+    for (uint32_t pid = 0; pid < nbpoints; ++pid) componentpoints[fill[component[pid]]++] = pid;
+
+    std::vector<PointKDTree *> trees(nbcomponents);
+    for (uint32_t cid = 0; cid < nbcomponents; ++cid)
+        trees[cid] = new PointKDTree(points, std::vector<uint32_t>(componentpoints.begin() + componentoffsets[cid],
+                                                                   componentpoints.begin() + componentoffsets[cid+1]));
+
+    // connect iteratively the closest component to the connected ones, starting from the one of the first point.
+    // The distance of each pending component to the connected ones is updated with each new connected component.
+    std::vector<real_t> distances(nbcomponents,REAL_MAX);
+    std::vector<std::pair<uint32_t,uint32_t> > connections(nbcomponents);
+    std::vector<uint32_t> pending;
+    for (uint32_t cid = 0; cid < nbcomponents; ++cid) if (cid != component[0]) pending.push_back(cid);
+
+    std::vector<std::pair<uint32_t,uint32_t> > addedconnections;
+    uint32_t newcomponent = component[0];
+    while (!pending.empty()) {
+        ComponentDistanceFunctor functor;
+        functor.trees = &trees;
+        functor.pending = &pending;
+        functor.newcomponent = newcomponent;
+        functor.distances = &distances;
+        functor.connections = &connections;
+        parallel_for(pending.size(), functor);
+
+        std::vector<uint32_t>::iterator best = pending.begin();
+        for (std::vector<uint32_t>::iterator it = pending.begin() + 1; it != pending.end(); ++it)
+            if (distances[*it] < distances[*best]) best = it;
+        newcomponent = *best;
+        addedconnections.push_back(connections[newcomponent]);
+        pending.erase(best);
+    }
+    for (uint32_t cid = 0; cid < nbcomponents; ++cid) delete trees[cid];
+
+    // insert the new connections in the adjacency graph
+    std::vector<uint32_t> offsets(nbpoints+1,0);
+    for (uint32_t pid = 0; pid < nbpoints; ++pid) offsets[pid+1] = __offsets[pid+1] - __offsets[pid];
+    for (std::vector<std::pair<uint32_t,uint32_t> >::const_iterator it = addedconnections.begin(); it != addedconnections.end(); ++it){
+        ++offsets[it->first+1];
+        ++offsets[it->second+1];
+    }
+    prefix_sum(offsets);
+    std::vector<uint32_t> neighbors(offsets[nbpoints]);
+    fill.assign(offsets.begin(),offsets.end()-1);
+    for (uint32_t pid = 0; pid < nbpoints; ++pid)
+        for (uint32_t i = __offsets[pid]; i < __offsets[pid+1]; ++i)
+            neighbors[fill[pid]++] = __neighbors[i];
+    for (std::vector<std::pair<uint32_t,uint32_t> >::const_iterator it = addedconnections.begin(); it != addedconnections.end(); ++it){
+        neighbors[fill[it->first]++] = it->second;
+        neighbors[fill[it->second]++] = it->first;
+    }
+    __offsets.swap(offsets);
+    __neighbors.swap(neighbors);
+}
+
+void SkeletonPipeline::computeDistancesToRoot(uint32_t root)
+{
+    std::vector<uint32_t> parents;
+    shortest_paths(*__points, __offsets, __neighbors, root, __distances, parents);
+}
+
+void SkeletonPipeline::computeQuotient()
+{
+    uint32_t nbpoints = __points->size();
+
+    // bin of distance of each point
+    std::vector<uint32_t> bins(nbpoints);
+    for (uint32_t pid = 0; pid < nbpoints; ++pid)
+        bins[pid] = (__distances[pid] == REAL_MAX ? UINT32_MAX : uint32_t(__distances[pid] / __binsize));
+
+    // points are processed by increasing distance to root
+    std::vector<DistancePoint> order;
+    order.reserve(nbpoints);
+    for (uint32_t pid = 0; pid < nbpoints; ++pid)
+        if (bins[pid] != UINT32_MAX) order.push_back(DistancePoint(__distances[pid],pid));
+    std::sort(order.begin(),order.end());
+
+    // as in quotient_points_from_adjacency_graph, a group is made of the points of a same bin
+    // reachable from its closest point. The graph is not symmetric if all points are not connected.
+    __pointgroup.assign(nbpoints,UINT32_MAX);
+    uint32_t nbgroups = 0;
+    std::vector<uint32_t> stack;
+    for (std::vector<DistancePoint>::const_iterator it = order.begin(); it != order.end(); ++it){
+        uint32_t pid = it->second;
+        if (__pointgroup[pid] != UINT32_MAX) continue;
+        __pointgroup[pid] = nbgroups;
+        stack.push_back(pid);
+        while (!stack.empty()){
+            uint32_t current = stack.back();
+            stack.pop_back();
+            for (uint32_t i = __offsets[current]; i < __offsets[current+1]; ++i){
+                uint32_t n = __neighbors[i];
+                if (bins[n] == bins[pid] && __pointgroup[n] == UINT32_MAX) { __pointgroup[n] = nbgroups; stack.push_back(n); }
+            }
+        }
+        ++nbgroups;
+    }
+
+    __groupoffsets.assign(nbgroups+1,0);
+    for (uint32_t pid = 0; pid < nbpoints; ++pid)
+        if (__pointgroup[pid] != UINT32_MAX) ++__groupoffsets[__pointgroup[pid]+1];
+    prefix_sum(__groupoffsets);
+    __groupmembers.resize(__groupoffsets[nbgroups]);
+    std::vector<uint32_t> fill(__groupoffsets.begin(),__groupoffsets.end()-1);
+    for (uint32_t pid = 0; pid < nbpoints; ++pid)
+        if (__pointgroup[pid] != UINT32_MAX) __groupmembers[fill[__pointgroup[pid]]++] = pid;
+}
+
+void SkeletonPipeline::computeQuotientAdjacency()
+{
+    uint32_t nbgroups = __groupoffsets.size() - 1;
+    size_t nbchunks = parallel_chunk_count(nbgroups, PARALLEL_GRAIN / 8);
+    std::vector<std::vector<uint32_t> > chunkneighbors(nbchunks);
+    __goffsets.assign(nbgroups+1,0);
+
+    QuotientAdjacencyFunctor functor;
+    functor.offsets = &__offsets;
+    functor.neighbors = &__neighbors;
+    functor.pointgroup = &__pointgroup;
+    functor.groupoffsets = &__groupoffsets;
+    functor.groupmembers = &__groupmembers;
+    functor.counts = &__goffsets;
+    functor.chunkneighbors = &chunkneighbors;
+    parallel_for(nbgroups, functor, PARALLEL_GRAIN / 8);
+
+    // chunks are ranges of groups in increasing order
+    prefix_sum(__goffsets);
+    __gneighbors.clear();
+    __gneighbors.reserve(__goffsets[nbgroups]);
+    for (size_t c = 0; c < nbchunks; ++c)
+        __gneighbors.insert(__gneighbors.end(),chunkneighbors[c].begin(),chunkneighbors[c].end());
+}
+
+void SkeletonPipeline::computeCentroids()
+{
+    uint32_t nbgroups = __groupoffsets.size() - 1;
+    __nodes = Point3ArrayPtr(new Point3Array(nbgroups));
+    CentroidsFunctor functor;
+    functor.points = __points.get();
+    functor.groupoffsets = &__groupoffsets;
+    functor.groupmembers = &__groupmembers;
+    functor.centroids = __nodes.get();
+    parallel_for(nbgroups, functor, PARALLEL_GRAIN / 8);
+}
+
+void SkeletonPipeline::computeSpanningTree()
+{
+    // the group of the root is the first one
+    std::vector<real_t> distances;
+    std::vector<uint32_t> parents;
+    shortest_paths(*__nodes, __goffsets, __gneighbors, 0, distances, parents);
+    __parents = Uint32Array1Ptr(new Uint32Array1(parents.begin(),parents.end()));
+}
+
+void SkeletonPipeline::computeRadii()
+{
+    real_t averageradius = __averageRadius;
+    if (averageradius <= 0) averageradius = average_radius(__points, __nodes, __parents);
+    if (__nodes->size() < 2) __radii = RealArrayPtr(new RealArray(__nodes->size(),averageradius));
+    else {
+        RealArrayPtr weights = carried_length(__nodes, __parents);
+        __radii = estimate_radii_from_pipemodel(__nodes, __parents, weights, averageradius, __pipeExponent);
+    }
+}
+
+Uint32Array1Ptr SkeletonPipeline::getPointGroups() const
+{
+    return Uint32Array1Ptr(new Uint32Array1(__pointgroup.begin(),__pointgroup.end()));
+}
+
+IndexArrayPtr SkeletonPipeline::getGroups() const
+{
+    uint32_t nbgroups = (__groupoffsets.empty() ? 0 : __groupoffsets.size() - 1);
+    IndexArrayPtr result(new IndexArray(nbgroups));
+    for (uint32_t gid = 0; gid < nbgroups; ++gid)
+        result->setAt(gid, Index(__groupmembers.begin() + __groupoffsets[gid], __groupmembers.begin() + __groupoffsets[gid+1]));
+    return result;
+}
+
+/* ----------------------------------------------------------------------- */
@@ -0,0 +1,183 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *  ----------------------------------------------------------------------------
+ */
+
+/*! \file skeletonpipeline.h
+    \brief Extraction of a skeleton from a point cloud by clustering of the distances to a root.
+
+    The pipeline chains the stages of skeleton_from_distance_to_root_clusters (Xu et al. 07)
+    with the estimation of radii by the pipe model. Intermediate graphs are stored in
+    compressed rows shared between the stages, and the stages that can be are run in parallel.
+*/
+
+#ifndef __skeletonpipeline_h__
+#define __skeletonpipeline_h__
+
+#include "../algo_config.h"
+#include <plantgl/scenegraph/container/pointarray.h>
+#include <plantgl/scenegraph/container/indexarray.h>
+#include <plantgl/tool/util_array.h>
+#include <vector>
+
+PGL_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/**
+    \class SkeletonPipeline
+    \brief Compute a skeleton (nodes, parents, radii) from a point cloud.
+
+    The stages are :
+    - the k nearest neighbors graph of the points, symmetrized if all points are connected,
+    - the connection of all its connex components, if required,
+    - the shortest path distances of the points to the root,
+    - the groups of points of a same bin of distance reachable from their closest point,
+    - the adjacency graph of the groups,
+    - the centroids of the groups, which are the nodes of the skeleton,
+    - the shortest path tree of the groups from the group of the root,
+    - the radii of the nodes from the pipe model with the carried length as weight.
+
+    Progress is reported through the function registered with register_progressstatus_func.
+*/
+class ALGO_API SkeletonPipeline {
+public:
+
+    enum Stage {
+        eNeighborhood,
+        eConnection,
+        eDistanceToRoot,
+        eQuotient,
+        eQuotientAdjacency,
+        eCentroids,
+        eSpanningTree,
+        eRadii,
+        eNbStages
+    };
+
+    /// Constructor.
+    SkeletonPipeline(real_t binsize, uint32_t k = 7, bool connectAllPoints = true);
+
+    ~SkeletonPipeline();
+
+    /** Compute the skeleton of \e points from the point \e root.
+        Returns false if the skeleton cannot be computed. */
+    bool process(const Point3ArrayPtr& points, uint32_t root = 0);
+
+    /// Free the intermediate buffers and the results.
+    void clear();
+
+    /// The nodes of the skeleton, centroids of the groups of points.
+    inline const Point3ArrayPtr& getNodes() const { return __nodes; }
+
+    /// The parent of each node. The root node is its own parent.
+    inline const TOOLS(Uint32Array1Ptr)& getParents() const { return __parents; }
+
+    /// The radius of each node.
+    inline const TOOLS(RealArrayPtr)& getRadii() const { return __radii; }
+
+    /// The group of each point, UINT32_MAX if the point is not connected to the root.
+    TOOLS(Uint32Array1Ptr) getPointGroups() const;
+
+    /// The points of each group.
+    IndexArrayPtr getGroups() const;
+
+    /// The time, in seconds, spent in \e stage by the last process.
+    inline double getStageTime(Stage stage) const { return __times[stage]; }
+
+    /// The total time, in seconds, spent by the last process.
+    double getTotalTime() const;
+
+    /// The name of \e stage.
+    static const char * getStageName(Stage stage);
+
+    inline real_t getBinSize() const { return __binsize; }
+    inline void setBinSize(real_t binsize) { __binsize = binsize; }
+
+    inline uint32_t getK() const { return __k; }
+    inline void setK(uint32_t k) { __k = k; }
+
+    inline bool getConnectAllPoints() const { return __connectAllPoints; }
+    inline void setConnectAllPoints(bool enabled) { __connectAllPoints = enabled; }
+
+    /// The average radius of the pipe model. If not positive, it is estimated from the distances of the points to the skeleton.
+    inline real_t getAverageRadius() const { return __averageRadius; }
+    inline void setAverageRadius(real_t radius) { __averageRadius = radius; }
+
+    inline real_t getPipeExponent() const { return __pipeExponent; }
+    inline void setPipeExponent(real_t exponent) { __pipeExponent = exponent; }
+
+protected:
+    void computeNeighborhoods();
+    void connectComponents();
+    void computeDistancesToRoot(uint32_t root);
+    void computeQuotient();
+    void computeQuotientAdjacency();
+    void computeCentroids();
+    void computeSpanningTree();
+    void computeRadii();
+
+    void endStage(Stage stage, double time);
+
+    real_t   __binsize;
+    uint32_t __k;
+    bool     __connectAllPoints;
+    real_t   __averageRadius;
+    real_t   __pipeExponent;
+
+    Point3ArrayPtr __points;
+
+    // adjacency graph of the points, in compressed rows
+    std::vector<uint32_t> __offsets;
+    std::vector<uint32_t> __neighbors;
+
+    std::vector<real_t> __distances;
+
+    // group of each point and points of each group, in compressed rows
+    std::vector<uint32_t> __pointgroup;
+    std::vector<uint32_t> __groupoffsets;
+    std::vector<uint32_t> __groupmembers;
+
+    // adjacency graph of the groups, in compressed rows
+    std::vector<uint32_t> __goffsets;
+    std::vector<uint32_t> __gneighbors;
+
+    Point3ArrayPtr __nodes;
+    TOOLS(Uint32Array1Ptr) __parents;
+    TOOLS(RealArrayPtr) __radii;
+
+    double __times[eNbStages];
+};
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+#endif
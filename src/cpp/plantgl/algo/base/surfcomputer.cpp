@@ -37,6 +37,7 @@
 
 #include "surfcomputer.h"
 #include "discretizer.h"
+#include "meshkernels.h"
 
 #include <plantgl/pgl_scene.h>
 #include <plantgl/pgl_geometry.h>
@@ -144,22 +145,7 @@ bool SurfComputer::process( AmapSymbol * amapSymbol ) {
 
   GEOM_SURFCOMPUTER_CHECK_CACHE(amapSymbol);
 
-  __result  = 0;
-  uint_t _iSize = amapSymbol->getIndexListSize();
-  for (uint_t _i = 0; _i < _iSize; _i++) {
-    const Index& _index = amapSymbol->getIndexList()->getAt(_i);
-    uint_t _jSize = _index.size();
-    for (uint_t _j = 1; _j < _jSize - 1; _j++) {
-      /* Vector3 _vi = amapSymbol->getPointAt(_i,_j) -
-                    amapSymbol->getPointAt(_i,0);
-      Vector3 _vj = amapSymbol->getPointAt(_i,_j + 1) -
-                    amapSymbol->getPointAt(_i,0); 
-      __result += 0.5 * norm(cross(_vi,_vj)); */
-	  __result += surface(amapSymbol->getFacePointAt(_i,0),
-						  amapSymbol->getFacePointAt(_i,_j),
-						  amapSymbol->getFacePointAt(_i,_j + 1));
-    };
-  };
+  __result = polygons_surface(amapSymbol->getPointList(),amapSymbol->getIndexList());
 
   GEOM_SURFCOMPUTER_UPDATE_CACHE(amapSymbol);
 
@@ -305,15 +291,7 @@ bool SurfComputer::process( FaceSet * faceSet ) {
 
   GEOM_SURFCOMPUTER_CHECK_CACHE(faceSet);
 
-  __result  = 0;
-  uint_t _iSize = faceSet->getIndexListSize();
-  for (uint_t _i = 0; _i < _iSize; _i++) {
-    const Index& _index = faceSet->getIndexList()->getAt(_i);
-    uint_t _jSize = _index.size();
-    for (uint_t _j = 1; _j < _jSize - 1; _j++) {
-	  __result += surface(faceSet->getFacePointAt(_i,0),faceSet->getFacePointAt(_i,_j),faceSet->getFacePointAt(_i,_j+1));
-    };
-  };
+  __result = polygons_surface(faceSet->getPointList(),faceSet->getIndexList());
 
   GEOM_SURFCOMPUTER_UPDATE_CACHE(faceSet);
 
@@ -478,15 +456,7 @@ bool SurfComputer::process( QuadSet * quadSet ) {
 
   GEOM_SURFCOMPUTER_CHECK_CACHE(quadSet);
 
-  __result  = 0;
-  uint_t _size = quadSet->getIndexListSize();
-  for (uint_t _i = 0; _i < _size; _i++) {
-    Vector3 _v1 = quadSet->getFacePointAt(_i,1) - quadSet->getFacePointAt(_i,0);
-    Vector3 _v2 = quadSet->getFacePointAt(_i,2) - quadSet->getFacePointAt(_i,0);
-    Vector3 _v3 = quadSet->getFacePointAt(_i,3) - quadSet->getFacePointAt(_i,0);
-    __result += 0.5 * norm(cross(_v1,_v2));
-    __result += 0.5 * norm(cross(_v2,_v3));
-  };
+  __result = quads_surface(quadSet->getPointList(),quadSet->getIndexList());
 
   GEOM_SURFCOMPUTER_UPDATE_CACHE(quadSet);
 
@@ -557,13 +527,7 @@ bool SurfComputer::process( TriangleSet * triangleSet ) {
 
   GEOM_SURFCOMPUTER_CHECK_CACHE(triangleSet);
 
-  __result  = 0;
-  uint_t _size = triangleSet->getIndexListSize();
-  for (uint_t _i = 0; _i < _size; _i++) {
-    __result += surface(triangleSet->getFacePointAt(_i,0),
-						triangleSet->getFacePointAt(_i,1),
-						triangleSet->getFacePointAt(_i,2));
-  };
+  __result = triangles_surface(triangleSet->getPointList(),triangleSet->getIndexList());
 
   GEOM_SURFCOMPUTER_UPDATE_CACHE(triangleSet);
 
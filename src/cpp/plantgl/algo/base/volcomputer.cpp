@@ -36,6 +36,7 @@
 
 #include "volcomputer.h"
 #include "discretizer.h"
+#include "meshkernels.h"
 
 #include <plantgl/pgl_scene.h>
 #include <plantgl/pgl_geometry.h>
@@ -268,19 +269,8 @@ bool VolComputer::process( FaceSet * faceSet ) {
   GEOM_VOLCOMPUTER_CHECK_CACHE(faceSet);
 
   if(faceSet->getSolid()){
-    uint_t _iSize = faceSet->getIndexListSize();
-    Vector3 center = faceSet->getPointList()->getCenter();
-    for (uint_t _i = 0; _i < _iSize; _i++) {
-      const Index& _index = faceSet->getIndexList()->getAt(_i);
-      uint_t _jSize = _index.size();
-      const Vector3& _origfacet = faceSet->getFacePointAt(_i,0);
-      Vector3 _center = center - _origfacet;
-      for (uint_t _j = 1; _j < _jSize - 1; _j++) {
-	Vector3 _vi = faceSet->getFacePointAt(_i,_j) - _origfacet;
-	Vector3 _vj = faceSet->getFacePointAt(_i,_j + 1) - _origfacet;
-	__result += fabs(dot(_center,cross(_vi,_vj)))/6;
-       };
-    };
+    __result = polygons_volume(faceSet->getPointList(),faceSet->getIndexList(),
+                               faceSet->getPointList()->getCenter());
   }
 
 
@@ -453,17 +443,8 @@ bool VolComputer::process( QuadSet * quadSet ) {
   GEOM_VOLCOMPUTER_CHECK_CACHE(quadSet);
 
   if(quadSet->getSolid()){
-    uint_t _size = quadSet->getIndexListSize();
-    Vector3 center = quadSet->getPointList()->getCenter();    
-    for (uint_t _i = 0; _i < _size; _i++) {
-      const Vector3& _origfacet = quadSet->getFacePointAt(_i,0);
-      Vector3 _center = center - _origfacet;
-      Vector3 _v1 = quadSet->getFacePointAt(_i,1) - _origfacet;
-      Vector3 _v2 = quadSet->getFacePointAt(_i,2) - _origfacet;
-      Vector3 _v3 = quadSet->getFacePointAt(_i,3) - _origfacet;
-      __result += fabs(dot(_center,cross(_v1,_v2)))/6;
-      __result += fabs(dot(_center,cross(_v2,_v3)))/6;
-    };
+    __result = quads_volume(quadSet->getPointList(),quadSet->getIndexList(),
+                            quadSet->getPointList()->getCenter());
   }
 
   GEOM_VOLCOMPUTER_UPDATE_CACHE(quadSet);
@@ -534,21 +515,8 @@ bool VolComputer::process( TriangleSet * triangleSet ) {
 
   if(triangleSet->getSolid()){
     /// For each facet (v0,v1,v2) we compute the volume of the tetrahedron (v0,v1,v2,center of triangleSets)
-    /// For this v = 1/3 | xC yC zC 1 |
-    ///                  | x0 y0 z0 1 |
-    ///                  | x1 y1 z1 1 |
-    ///                  | x2 y2 z2 1 |
-    /// Normaly coef is 1/6 (??)
-
-    uint_t _size = triangleSet->getIndexListSize();
-    Vector3 center = triangleSet->getPointList()->getCenter();
-    for (uint_t _i = 0; _i < _size; _i++) {
-      const Vector3& _origfacet = triangleSet->getFacePointAt(_i,0);
-      Vector3 _center = center - _origfacet;
-      Vector3 _v1 = triangleSet->getFacePointAt(_i,1) - _origfacet;
-      Vector3 _v2 = triangleSet->getFacePointAt(_i,2) - _origfacet;
-      __result += fabs(dot(_center,cross(_v1,_v2)))/6;
-    };
+    __result = triangles_volume(triangleSet->getPointList(),triangleSet->getIndexList(),
+                                triangleSet->getPointList()->getCenter());
   }
   GEOM_VOLCOMPUTER_UPDATE_CACHE(triangleSet);
 
@@ -43,6 +43,7 @@
 #include <plantgl/tool/util_string.h>
 #include <plantgl/tool/errormsg.h>
 #include <plantgl/tool/timer.h>
+#include <plantgl/tool/util_mappedfile.h>
 
 #include <plantgl/scenegraph/core/sceneobject.h>
 #include <plantgl/scenegraph/core/smbtable.h>
@@ -132,10 +133,14 @@ ScenePtr GeomCodec::read(const std::string& fname)
     return sc;
   } */
   else {
-    ifstream _file(fname.c_str());
+	// The lexer reads the file directly from memory when it can be mapped.
+	MappedFileBuf _mapped(fname);
+	std::istream _mappedstream(&_mapped);
+    ifstream _file;
+	if(!_mapped.isValid()) _file.open(fname.c_str());
 	SceneObjectSymbolTable table;
 	ScenePtr scene(new Scene());
-	bool b = geom_read(_file,table,scene,fname);
+	bool b = geom_read(_mapped.isValid() ? _mappedstream : _file,table,scene,fname);
     if(!b) return ScenePtr();
 	else {
 		if(scene && !scene->empty()) return scene;
@@ -39,6 +39,8 @@
 #include "cdc_pov.h"
 #include "cdc_vrml.h"
 #include <plantgl/scenegraph/scene/factory.h>
+#include <plantgl/algo/base/scenededuplicator.h>
+#include <plantgl/tool/errormsg.h>
 
 /* ----------------------------------------------------------------------- */
 
@@ -51,6 +53,21 @@ public:
 
 static CodecInstaller MyCodecInstaller;
 
+/// Shares the structurally identical geometries and appearances of the scenes read.
+class DeduplicationProcess : public SceneReadProcess {
+public:
+	DeduplicationProcess() : SceneReadProcess("Deduplication",false) {}
+
+	virtual void process(const ScenePtr& scene) {
+		SceneDeduplicator deduplicator;
+		deduplicator.deduplicate(scene);
+		if (deduplicator.getDuplicateNb() > 0)
+			pglDebug("Deduplication : %u of %u objects shared, %lu bytes saved.",
+					 deduplicator.getDuplicateNb(), deduplicator.getVisitedNb(),
+					 (unsigned long)deduplicator.getSavedMemory());
+	}
+};
+
 void installCodecs(){
 	static bool installed = false;
 	if(!installed){
@@ -60,6 +77,7 @@ void installCodecs(){
 		SceneFactory::get().registerCodec(SceneCodecPtr(new VgStarCodec()));
 		SceneFactory::get().registerCodec(SceneCodecPtr(new PovCodec()));
 		SceneFactory::get().registerCodec(SceneCodecPtr(new VrmlCodec()));
+		SceneFactory::get().registerReadProcess(SceneReadProcessPtr(new DeduplicationProcess()));
 	}
 }
 
@@ -51,10 +51,14 @@
 #include <plantgl/scenegraph/transformation/tapered.h>
 #include <plantgl/scenegraph/scene/shape.h>
 #include <plantgl/scenegraph/scene/scene.h>
+#include <plantgl/scenegraph/geometry/boundingbox.h>
 #include <plantgl/algo/base/discretizer.h>
+#include <plantgl/algo/base/surfcomputer.h>
+#include <plantgl/algo/base/bboxcomputer.h>
 #include <plantgl/tool/bfstream.h>
 #include <plantgl/tool/dirnames.h>
 #include <plantgl/math/util_math.h>
+#include <cstring>
 
 PGL_USING_NAMESPACE
 TOOLS_USING_NAMESPACE
@@ -373,6 +377,26 @@ bool LigRecord::read( bifstream& stream){
   return true;
 }
 
+template<class T>
+inline void decode_value(const char *& data, T& value){
+    memcpy(&value,data,sizeof(T));
+    data += sizeof(T);
+}
+
+void LigRecord::decode( const char * data ){
+  int32_t value;
+  decode_value(data,value); __symbol = value;
+  decode_value(data,value); __val1 = value;
+  decode_value(data,value); __val2 = value;
+  decode_value(data,value); __range = value;
+  for(int i=0;i<3;i++)
+    for(int j=0;j<4;j++)
+      decode_value(data,__matrix[i][j]);
+  decode_value(data,__base_dia);
+  decode_value(data,__sommit_dia);
+  decode_value(data,value); __entity_number = value;
+}
+
 bofstream& operator<<( bofstream& stream, const LigRecord& l ){
     stream << l.__symbol << l.__val1 << l.__val2 << l.__range;
     for(int i=0;i<3;i++)
@@ -388,21 +412,14 @@ bofstream& operator<<( bofstream& stream, const LigRecord& l ){
 Ligfile::Ligfile( const string& fileName, bool bigendian):
     _fileName(fileName),
     recordTable(0){
-    bifstream  * stream;
-	if(bigendian) stream = new beifstream(_fileName.c_str());
-	else stream = new leifstream(_fileName.c_str());
-    if(*stream){
-        char protection[81];
-        stream->read(protection,80);
+    LigStreamReader stream(_fileName,bigendian);
+    if(stream.isValid()){
         recordTable = new vector< LigRecord >;
-        while(!stream->eof()){
-            LigRecord a;
-            if(a.read(*stream))
-                 recordTable->push_back(a);
-        }
+        recordTable->reserve(stream.getSize());
+        vector< LigRecord > chunk;
+        while(stream.readChunk(chunk))
+            recordTable->insert(recordTable->end(),chunk.begin(),chunk.end());
     }
-	delete stream;
-
 }
 
 Ligfile::~Ligfile( ) {
@@ -419,28 +436,37 @@ const unsigned int Ligfile::getSize( ) const{
     else return recordTable->size();
 }
 
+/* 
+   Add the geometry of record \e rec to \e scene. The discretizer \e dis is shared
+   between records so that the discretization of a symbol is computed only once.
+*/
+static void add_record_to_scene(const ScenePtr& scene, const LigRecord& rec, size_t recid,
+                                const Dtafile& dtafile, Discretizer& dis, const AppearancePtr& defaultapp){
+    ShapePtr a = dtafile.getdtainfo((unsigned int)rec.getSymbolNumber());
+    if(a){
+        GeometryPtr b = rec.getTransformed(a->getGeometry(),dis);
+        if(!a->getAppearance())pglError("The Dta object %i don't have a valid Appearance.",rec.getSymbolNumber());
+        if(b)scene->add(Shape3DPtr(new Shape(b,AppearancePtr(a->getAppearance()),rec.getEntityNumber())));
+        else  pglError("The object %i cannot be computed.",recid );
+    }
+    else {
+        pglWarning("Cannot find symbol in Dta file for object %i. Default geometry used.", recid);
+        GeometryPtr b = rec.getTransformed(GeometryPtr(),dis);
+        if(b)scene->add(Shape3DPtr(new  Shape(b,defaultapp,rec.getEntityNumber())));
+        else  pglError("The object %i cannot be computed", recid );
+    }
+}
+
 ScenePtr Ligfile::computeScene(const Dtafile& _dtafile) const{
     AppearancePtr _default( Material::DEFAULT_MATERIAL);
     if(!isValid() && _dtafile.isValid())return ScenePtr();
     ScenePtr result(new Scene());
-    uint_t id = 1;
-    for(vector< LigRecord >::iterator _it=recordTable->begin();
+    Discretizer dis;
+    size_t recid = 0;
+    for(vector< LigRecord >::const_iterator _it=recordTable->begin();
         _it!=recordTable->end();
-        _it++){
-        ShapePtr a = _dtafile.getdtainfo((unsigned int)_it->getSymbolNumber());
-        if(a){
-            GeometryPtr b = _it->getTransformed(a->getGeometry());
-            if(!a->getAppearance())pglError("The Dta object %i don't have a valid Appearance.",_it->getSymbolNumber());
-            if(b)result->add(Shape3DPtr(new Shape(b,AppearancePtr(a->getAppearance()),_it->getEntityNumber())));
-            else  pglError("The object %i cannot be computed.",distance(recordTable->begin(),_it) );
-        }
-        else {
-            pglWarning("Cannot find symbol in Dta file for object %i. Default geometry used.", distance(recordTable->begin(),_it));;
-            GeometryPtr b = _it->getTransformed(GeometryPtr());
-            if(b)result->add(Shape3DPtr(new  Shape(b,_default,_it->getEntityNumber())));
-            else  pglError("The object %i cannot be computed", distance(recordTable->begin(),_it) );
-        }
-        id++;
+        _it++, recid++){
+        add_record_to_scene(result,*_it,recid,_dtafile,dis,_default);
     }
     return result;
 }
@@ -453,21 +479,152 @@ bool Ligfile::isValid( ) const {
 /* ----------------------------------------------------------------------- */
 
 bool Ligfile::isBigEndian( const std::string& fileName ){
-	beifstream stream(fileName.c_str());
-    if(stream){
-        char protection[81];
-        stream.read(protection,80);
-        if(!stream.eof()){
-            LigRecord a;
-            if(a.read(stream)){
-				if (a.getSymbolNumber() >= 0x1000) return false;
-			}
-		}
-	}
-	return true;
+    LigStreamReader stream(fileName,true,1);
+    vector< LigRecord > chunk;
+    if(stream.readChunk(chunk)){
+        if (chunk[0].getSymbolNumber() >= 0x1000 || chunk[0].getSymbolNumber() < 0) return false;
+    }
+    return true;
 }
 
 
+/* ----------------------------------------------------------------------- */
+
+const size_t LigStreamReader::RECORD_SIZE = 19 * 4;
+const size_t LigStreamReader::HEADER_SIZE = 80;
+
+LigStreamReader::LigStreamReader( const std::string& fileName, bool bigendian, uint_t chunkSize ):
+    __fileName(fileName),
+    __stream(new ifstream(fileName.c_str(),ios::in | ios::binary)),
+#if __BYTE_ORDER == __LITTLE_ENDIAN
+    __swap(bigendian),
+#else
+    __swap(!bigendian),
+#endif
+    __chunkSize(chunkSize > 0 ? chunkSize : 1),
+    __size(0),
+    __position(0),
+    __buffer(){
+    if(*__stream){
+        __stream->seekg(0,ios::end);
+        size_t filesize = (size_t)__stream->tellg();
+        if (filesize >= HEADER_SIZE) __size = (filesize - HEADER_SIZE) / RECORD_SIZE;
+        __stream->seekg(HEADER_SIZE,ios::beg);
+    }
+    if(!*__stream){
+        delete __stream;
+        __stream = NULL;
+    }
+}
+
+LigStreamReader::~LigStreamReader( ) {
+    if(__stream) delete __stream;
+}
+
+bool LigStreamReader::isValid( ) const {
+    return __stream != NULL;
+}
+
+void LigStreamReader::rewind( ) {
+    if(!__stream) return;
+    __stream->clear();
+    __stream->seekg(HEADER_SIZE,ios::beg);
+    __position = 0;
+}
+
+uint_t LigStreamReader::readBuffer( ) {
+    if(!__stream || atEnd()) return 0;
+    uint_t nbrecords = std::min(__chunkSize, __size - __position);
+    size_t nbbytes = nbrecords * RECORD_SIZE;
+    if (__buffer.size() < nbbytes) __buffer.resize(nbbytes);
+    __stream->read(&__buffer[0],nbbytes);
+    nbrecords = __stream->gcount() / RECORD_SIZE;
+    if (__swap) {
+        // All the fields of a record are 4 bytes long: the whole buffer can be swapped at once.
+        uint32_t * words = (uint32_t *)&__buffer[0];
+        size_t nbwords = nbrecords * RECORD_SIZE / 4;
+        for(size_t i = 0; i < nbwords; ++i){
+            uint32_t w = words[i];
+            words[i] = (w >> 24) | ((w >> 8) & 0x0000ff00) | ((w << 8) & 0x00ff0000) | (w << 24);
+        }
+    }
+    __position += nbrecords;
+    if (nbrecords == 0) __position = __size;
+    return nbrecords;
+}
+
+bool LigStreamReader::readChunk( std::vector<LigRecord>& chunk ) {
+    uint_t nbrecords = readBuffer();
+    chunk.resize(nbrecords);
+    if (nbrecords == 0) return false;
+    const char * data = &__buffer[0];
+    for(uint_t i = 0; i < nbrecords; ++i, data += RECORD_SIZE)
+        chunk[i].decode(data);
+    return true;
+}
+
+bool LigStreamReader::readBatches( LigRecordBatches& batches ) {
+    batches.clear();
+    uint_t nbrecords = readBuffer();
+    if (nbrecords == 0) return false;
+    const char * data = &__buffer[0];
+    LigRecordBatches::iterator itbatch = batches.end();
+    for(uint_t i = 0; i < nbrecords; ++i, data += RECORD_SIZE){
+        LigRecord rec;
+        rec.decode(data);
+        // consecutive records often share their symbol
+        if (itbatch == batches.end() || itbatch->first != rec.getSymbolNumber())
+            itbatch = batches.insert(LigRecordBatches::value_type(rec.getSymbolNumber(),vector<LigRecord>())).first;
+        itbatch->second.push_back(rec);
+    }
+    return true;
+}
+
+/* ----------------------------------------------------------------------- */
+
+LigSceneReader::LigSceneReader( const std::string& ligFile, const std::string& dtaFile, const std::string& smbpath,
+                                bool bigendian, uint_t chunkSize ):
+    __dtafile(NULL),
+    __reader(ligFile,bigendian,chunkSize),
+    __discretizer(new Discretizer()),
+    __chunk(){
+    string p = get_cwd();
+    __dtafile = new Dtafile(dtaFile,smbpath);
+    chg_dir(p);
+    if(!__dtafile->isValid()) pglError("Error : Invalid Dta File !");
+    if(!__reader.isValid()) pglError("Error : Invalid Lig File !");
+}
+
+LigSceneReader::~LigSceneReader( ) {
+    delete __dtafile;
+    delete __discretizer;
+}
+
+bool LigSceneReader::isValid( ) const {
+    return __reader.isValid() && __dtafile->getScene();
+}
+
+ScenePtr LigSceneReader::nextScene( ) {
+    if(!isValid()) return ScenePtr();
+    size_t recid = __reader.getPosition();
+    if(!__reader.readChunk(__chunk)) return ScenePtr();
+    AppearancePtr _default( Material::DEFAULT_MATERIAL);
+    ScenePtr result(new Scene());
+    for(vector<LigRecord>::const_iterator itrec = __chunk.begin(); itrec != __chunk.end(); ++itrec, ++recid)
+        add_record_to_scene(result,*itrec,recid,*__dtafile,*__discretizer,_default);
+    return result;
+}
+
+/* ----------------------------------------------------------------------- */
+
+LigSymbolStatistics::LigSymbolStatistics( long _symbol ):
+    symbol(_symbol),
+    count(0),
+    invalid(0),
+    surface(0),
+    bbox(){
+}
+
 /* ----------------------------------------------------------------------- */
 
 ScenePtr PGL(readLineTree)(string ligFile, 
@@ -502,3 +659,94 @@ ScenePtr PGL(readLineTree)(string ligFile,
 }
 
 
+
+/* ----------------------------------------------------------------------- */
+
+ScenePtr PGL(readLineTreeByChunks)(string ligFile, 
+                                    string dtaFile, 
+                                    string smbpath,
+                                    bool bigendian,
+                                    uint_t chunkSize,
+                                    ostream& output){
+
+    PglErrorStream::Binder psb(output);
+    LigSceneReader l(ligFile,dtaFile,smbpath,bigendian,chunkSize);
+    if(!l.isValid()) {
+        ScenePtr dtascene = l.getDtafile().getScene();
+        return (dtascene ? dtascene : ScenePtr(new Scene()));
+    }
+    ScenePtr result(new Scene());
+    ScenePtr chunk;
+    while((chunk = l.nextScene())) result->merge(chunk);
+    if(!result->isValid())pglError("Error : Invalid Scene !");
+    return result;
+}
+
+/* ----------------------------------------------------------------------- */
+
+LigSymbolStatisticsList PGL(computeLineTreeStatistics)(string ligFile, 
+                                                        string dtaFile, 
+                                                        string smbpath,
+                                                        bool bigendian,
+                                                        bool surface,
+                                                        bool bbox,
+                                                        uint_t chunkSize,
+                                                        ostream& output){
+    string p = get_cwd();
+    LigSymbolStatisticsList result;
+    PglErrorStream::Binder psb(output);
+    Dtafile d(dtaFile,smbpath);
+    if(!d.isValid()){
+        pglError("Error : Invalid Dta File !");
+        chg_dir(p);
+        return result;
+    }
+    LigStreamReader l(ligFile,bigendian,chunkSize);
+    if(!l.isValid()){
+        pglError("Error : Invalid Lig File !");
+        chg_dir(p);
+        return result;
+    }
+
+    Discretizer dis;
+    SurfComputer surfc(dis);
+    BBoxComputer bboxc(dis);
+
+    typedef std::map<long, LigSymbolStatistics> StatMap;
+    StatMap stats;
+    LigRecordBatches batches;
+    while(l.readBatches(batches)){
+        for(LigRecordBatches::const_iterator itbatch = batches.begin(); itbatch != batches.end(); ++itbatch){
+            StatMap::iterator itstat = stats.find(itbatch->first);
+            if (itstat == stats.end()) 
+                itstat = stats.insert(StatMap::value_type(itbatch->first,LigSymbolStatistics(itbatch->first))).first;
+            LigSymbolStatistics& stat = itstat->second;
+            stat.count += itbatch->second.size();
+            if (!surface && !bbox) continue;
+
+            // The symbol is retrieved once for the whole batch.
+            ShapePtr a = d.getdtainfo((unsigned int)itbatch->first);
+            GeometryPtr symbol = (a ? a->getGeometry() : GeometryPtr());
+            for(vector<LigRecord>::const_iterator itrec = itbatch->second.begin(); itrec != itbatch->second.end(); ++itrec){
+                // The transformed geometry is only transient. Only the shared symbol is cached by the actions.
+                GeometryPtr geom = itrec->getTransformed(symbol,dis);
+                if (!geom) { ++stat.invalid; continue; }
+                if (surface) {
+                    if (geom->apply(surfc)) stat.surface += surfc.getSurface();
+                    else ++stat.invalid;
+                }
+                if (bbox && geom->apply(bboxc)) {
+                    if (stat.bbox) stat.bbox->extend(bboxc.getBoundingBox());
+                    else stat.bbox = BoundingBoxPtr(new BoundingBox(*bboxc.getBoundingBox()));
+                }
+            }
+        }
+    }
+    chg_dir(p);
+    result.reserve(stats.size());
+    for(StatMap::const_iterator itstat = stats.begin(); itstat != stats.end(); ++itstat)
+        result.push_back(itstat->second);
+    return result;
+}
+
+/* ----------------------------------------------------------------------- */
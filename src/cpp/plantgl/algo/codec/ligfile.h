@@ -47,6 +47,8 @@
 #include <plantgl/math/util_vector.h>
 #include <string>
 #include <vector>
+#include <map>
+#include <iostream>
 
 /* ----------------------------------------------------------------------- */
 
@@ -69,6 +71,8 @@ class Geometry;
 typedef RCPtr<Geometry> GeometryPtr;
 class Dtafile;
 class Discretizer;
+class BoundingBox;
+typedef RCPtr<BoundingBox> BoundingBoxPtr;
 
 /* ----------------------------------------------------------------------- */
 
@@ -114,6 +118,10 @@ class CODEC_API LigRecord {
     /// read values on \e stream.
     bool read( TOOLS(bifstream)& stream);
 
+    /** Decode values from a raw record of LigStreamReader::RECORD_SIZE bytes.
+        The bytes are supposed to be already in the byte order of the host. */
+    void decode( const char * data );
+
     /// Read \e l in the input stream \e stream.
     friend CODEC_API TOOLS(bifstream)& operator>>( TOOLS(bifstream)& stream, LigRecord& l);
 
@@ -185,6 +193,175 @@ public:
 // typedef RCPtr<Ligfile> LigfilePtr;
 
 
+/* ----------------------------------------------------------------------- */
+
+/// Records of a Linetree grouped by symbol number.
+typedef std::map<long, std::vector<LigRecord> > LigRecordBatches;
+
+/**
+   \class LigStreamReader
+   \brief A sequential reader of a Linetree file in the AMAP format.
+
+   Records are read by chunks of fixed size in a raw buffer that is byte
+   swapped at once, so that the whole file never has to be kept in memory.
+*/
+class CODEC_API LigStreamReader {
+
+public:
+
+  /// Size in bytes of a record in the file.
+  static const size_t RECORD_SIZE;
+
+  /// Size in bytes of the header of the file.
+  static const size_t HEADER_SIZE;
+
+  /// Constructs a reader on \e fileName that decodes \e chunkSize records at once.
+  LigStreamReader( const std::string& fileName, bool bigendian = true, uint_t chunkSize = 65536 );
+
+  /// Destructor
+  virtual ~LigStreamReader( );
+
+  /// Returns \b FileName value.
+  inline const std::string& getFileName( ) const { return __fileName; }
+
+  /// Returns the total number of records of the file.
+  inline uint_t getSize( ) const { return __size; }
+
+  /// Returns the number of records already read.
+  inline uint_t getPosition( ) const { return __position; }
+
+  /// Returns the number of records read at once.
+  inline uint_t getChunkSize( ) const { return __chunkSize; }
+
+  /// Test whether the end of the file has been reached.
+  inline bool atEnd( ) const { return __position >= __size; }
+
+  /// Go back to the first record.
+  void rewind( );
+
+  /** Read the next chunk of records in \e chunk.
+      Returns false if no more records can be read. */
+  bool readChunk( std::vector<LigRecord>& chunk );
+
+  /** Read the next chunk of records and dispatch them by symbol in \e batches.
+      Previous content of \e batches is cleared. Returns false if no more records can be read.
+      Records of a batch are in file order, but batches are sorted by symbol: 
+      the records of a chunk are thus not given in the order of the file. */
+  bool readBatches( LigRecordBatches& batches );
+
+  /// Test object validity.
+  virtual bool isValid( ) const;
+
+protected:
+
+  /// Read the next chunk in the raw buffer and returns the number of records read.
+  uint_t readBuffer( );
+
+  std::string __fileName;
+  std::ifstream * __stream;
+  bool __swap;
+  uint_t __chunkSize;
+  uint_t __size;
+  uint_t __position;
+  std::vector<char> __buffer;
+
+};
+
+/* ----------------------------------------------------------------------- */
+
+/**
+   \class LigSceneReader
+   \brief A sequential reader of the scene of a Linetree.
+
+   The scene is given chunk by chunk, so that only the shapes of one chunk
+   of records are in memory at once. The discretization of each symbol is 
+   computed once and shared by all its instances.
+*/
+class CODEC_API LigSceneReader {
+
+public:
+
+  /// Constructs a reader on files \e ligFile, \e dtaFile and \e smbpath that reads \e chunkSize records at once.
+  LigSceneReader( const std::string& ligFile, const std::string& dtaFile, const std::string& smbpath,
+                  bool bigendian = true, uint_t chunkSize = 65536 );
+
+  /// Destructor
+  virtual ~LigSceneReader( );
+
+  /// Returns the total number of records of the Linetree.
+  inline uint_t getSize( ) const { return __reader.getSize(); }
+
+  /// Returns the number of records already read.
+  inline uint_t getPosition( ) const { return __reader.getPosition(); }
+
+  /// Test whether all the records have been read.
+  inline bool atEnd( ) const { return __reader.atEnd(); }
+
+  /// Go back to the first record.
+  inline void rewind( ) { __reader.rewind(); }
+
+  /// Returns the symbols and materials of the Linetree.
+  inline const Dtafile& getDtafile( ) const { return *__dtafile; }
+
+  /** Returns the shapes of the next chunk of records, in the order of the file.
+      Returns a null pointer when no more records can be read. */
+  ScenePtr nextScene( );
+
+  /// Test object validity.
+  virtual bool isValid( ) const;
+
+protected:
+
+  Dtafile * __dtafile;
+  LigStreamReader __reader;
+  Discretizer * __discretizer;
+  std::vector<LigRecord> __chunk;
+
+};
+
+/* ----------------------------------------------------------------------- */
+
+/// Statistics on all the instances of a symbol of a Linetree.
+struct CODEC_API LigSymbolStatistics {
+
+  LigSymbolStatistics( long _symbol = 0 );
+
+  /// The symbol number.
+  long symbol;
+
+  /// The number of records using the symbol.
+  uint_t count;
+
+  /// The number of records that cannot be computed.
+  uint_t invalid;
+
+  /// The total surface of the instances.
+  real_t surface;
+
+  /// The bounding box of the instances.
+  BoundingBoxPtr bbox;
+};
+
+typedef std::vector<LigSymbolStatistics> LigSymbolStatisticsList;
+
+/* ----------------------------------------------------------------------- */
+
+/** Read a Linetree from files \e ligFile, \e dtaFile and \e smbpath by chunks of \e chunkSize records.
+    The discretization of each symbol is computed once and shared by all its instances.
+    Shapes are in the order of the file, as with readLineTree. The whole scene is kept in memory:
+    use LigSceneReader to process it chunk by chunk. */
+ScenePtr CODEC_API readLineTreeByChunks(std::string ligFile, std::string dtaFile, std::string smbpath, 
+                                        bool bigendian = true, uint_t chunkSize = 65536,
+                                        std::ostream& output = std::cerr);
+
+/** Compute the number of instances, the total surface and the bounding box of each symbol of a Linetree
+    without building its scene. Surfaces and bounding boxes are computed only if \e surface and \e bbox are set. */
+LigSymbolStatisticsList CODEC_API computeLineTreeStatistics(std::string ligFile, std::string dtaFile, std::string smbpath, 
+                                                            bool bigendian = true, 
+                                                            bool surface = true, bool bbox = true,
+                                                            uint_t chunkSize = 65536,
+                                                            std::ostream& output = std::cerr);
+
 /* ----------------------------------------------------------------------- */
 
 /// Read a Linetree from files \e ligFile, \e dtaFile and \e smbpath. Error output will be made on \e output.
@@ -199,6 +199,84 @@ using namespace std;
 
 /* ----------------------------------------------------------------------- */
 
+/* Formatting of the elements of the mesh2 lists with the same syntax as the macros above. */
+
+inline void pov_format(TextBuffer& text, const Vector2& val)
+{
+  text.append('<'); text.appendReal(val.x());
+  text.append(','); text.appendReal(val.y()); text.append('>');
+}
+
+inline void pov_format(TextBuffer& text, const Vector3& val)
+{
+  text.append('<'); text.appendReal(val.x());
+  text.append(','); text.appendReal(val.y());
+  text.append(','); text.appendReal(val.z()); text.append('>');
+}
+
+inline void pov_format(TextBuffer& text, const Index3& val)
+{
+  text.append('<'); text.appendInteger(val.getAt(0));
+  text.append(','); text.appendInteger(val.getAt(1));
+  text.append(','); text.appendInteger(val.getAt(2)); text.append('>');
+}
+
+inline void pov_format(TextBuffer& text, const Color4& val)
+{
+  text.append("texture { pigment { rgbt <",26); text.appendReal((real_t)val.getAt(0) / 255.0);
+  text.append(','); text.appendReal((real_t)val.getAt(1) / 255.0);
+  text.append(','); text.appendReal((real_t)val.getAt(2) / 255.0);
+  text.append(','); text.appendReal((real_t)val.getAt(3) / 255.0); text.append(">}}",3);
+}
+
+template<class ArrayPtr>
+struct PovArrayFormat {
+  PovArrayFormat(const ArrayPtr& array) : array(array) { }
+  inline void operator()(TextBuffer& text, size_t i) const { pov_format(text,array->getAt(i)); }
+  const ArrayPtr& array;
+};
+
+template<class ArrayPtr>
+inline PovArrayFormat<ArrayPtr> pov_array_format(const ArrayPtr& array)
+{ return PovArrayFormat<ArrayPtr>(array); }
+
+/// The indices of the points of a face, followed by the indices of its colors if any.
+struct PovFaceIndexFormat {
+  PovFaceIndexFormat(const TriangleSet * triangleSet) : triangleSet(triangleSet) { }
+  inline void operator()(TextBuffer& text, size_t cpid) const {
+    pov_format(text,triangleSet->getIndexList()->getAt(cpid));
+    if (triangleSet->hasColorList()){
+      text.append(", ",2);
+      if(!triangleSet->getColorPerVertex()){
+        text.appendInteger(uint32_t(cpid)); text.append(", ",2);
+        text.appendInteger(uint32_t(cpid)); text.append(", ",2);
+        text.appendInteger(uint32_t(cpid));
+      }
+      else {
+        const Index3& ind = (is_null_ptr(triangleSet->getColorIndexList()) ? triangleSet->getIndexList()->getAt(cpid) : triangleSet->getColorIndexList()->getAt(cpid));
+        text.appendInteger(ind.getAt(0)); text.append(", ",2);
+        text.appendInteger(ind.getAt(1)); text.append(", ",2);
+        text.appendInteger(ind.getAt(2));
+      }
+    }
+  }
+  const TriangleSet * triangleSet;
+};
+
+/// The indices of the normals of a face.
+struct PovNormalIndexFormat {
+  PovNormalIndexFormat(const TriangleSet * triangleSet) : triangleSet(triangleSet) { }
+  inline void operator()(TextBuffer& text, size_t cpid) const {
+    if(!triangleSet->getNormalPerVertex())
+      pov_format(text,Index3(uint_t(cpid),uint_t(cpid),uint_t(cpid)));
+    else
+      pov_format(text,triangleSet->getNormalIndexList()->getAt(cpid));
+  }
+  const TriangleSet * triangleSet;
+};
+
+/* ----------------------------------------------------------------------- */
+
 
 PovPrinter::PovPrinter( ostream& povStream,
                         Tesselator& tesselator,
@@ -1181,37 +1259,22 @@ bool PovPrinter::process( TriangleSet * triangleSet ) {
 
     GEOM_POVPRINT_BEGIN(__geomStream,"mesh2",triangleSet);
 
-    __geomStream << __indent << "vertex_vectors { " << triangleSet->getPointList()->size() << endl << __indent;
-    size_t pointperline = 5;
-    size_t cpid = 0;
-    Point3Array::const_iterator endpoints = triangleSet->getPointList()->end();
+    // The lists of vectors and indices are written with the TextWriter, 5 elements per line.
+    const size_t perline = 5;
+    const std::string linesep = ", \n" + __indent;
 
-    for (Point3Array::const_iterator itPoints = triangleSet->getPointList()->begin(); itPoints != endpoints; ++itPoints, ++cpid) 
-    {
-		    GEOM_POVPRINT_VECTOR3(__geomStream,(*itPoints));
-		    if (itPoints != endpoints -1){
-                __geomStream << ", ";
-                if ((cpid+1) % 5 == 0) __geomStream << endl << __indent;
-            }
-            else __geomStream << '}' << endl ;
-    }
+    __geomStream << __indent << "vertex_vectors { " << triangleSet->getPointList()->size() << endl << __indent;
+    __writer.writeArray(__geomStream,triangleSet->getPointList()->size(),
+                        pov_array_format(triangleSet->getPointList()),", ",perline,linesep);
+    if (!triangleSet->getPointList()->empty()) __geomStream << '}' << endl ;
 
     triangleSet->checkNormalList();
 
     __geomStream << __indent << "normal_vectors { " << triangleSet->getNormalList()->size() << endl << __indent;
+    __writer.writeArray(__geomStream,triangleSet->getNormalList()->size(),
+                        pov_array_format(triangleSet->getNormalList()),", ",perline,linesep);
+    if (!triangleSet->getNormalList()->empty()) __geomStream << '}' << endl ;
 
-    cpid = 0;
-    endpoints = triangleSet->getNormalList()->end();
-
-    for (Point3Array::const_iterator itPoints = triangleSet->getNormalList()->begin(); itPoints != endpoints; ++itPoints, ++cpid) 
-    {
-		    GEOM_POVPRINT_VECTOR3(__geomStream,(*itPoints));
-		    if (itPoints != endpoints -1){
-                __geomStream << ", ";
-                if ((cpid+1) % 5 == 0) __geomStream << endl << __indent;
-            }
-            else __geomStream << '}' << endl ;
-    }
     if (__tesselator.texCoordComputed() && triangleSet->getTexCoordList())
     {
 	    Point2ArrayPtr newtexcoord = triangleSet->getTexCoordList();
@@ -1221,100 +1284,32 @@ bool PovPrinter::process( TriangleSet * triangleSet ) {
 	    }
 
         __geomStream << __indent << "uv_vectors  { " << newtexcoord->size() << endl << __indent;
-
-        cpid = 0;
-        Point2Array::const_iterator endtex = newtexcoord->end();
-
-        for (Point2Array::const_iterator itTex = newtexcoord->begin(); itTex != endtex; ++itTex, ++cpid) 
-        {
-		        GEOM_POVPRINT_VECTOR2(__geomStream,(*itTex));
-		        if (itTex != endtex -1){
-                    __geomStream << ", ";
-                    if ((cpid+1) % 5 == 0) __geomStream << endl << __indent;
-                }
-                else __geomStream << '}' << endl ;
-        }
-
+        __writer.writeArray(__geomStream,newtexcoord->size(),pov_array_format(newtexcoord),", ",perline,linesep);
+        if (!newtexcoord->empty()) __geomStream << '}' << endl ;
     }
 
     if(triangleSet->hasColorList()) {
         __geomStream << __indent << "texture_list  { " << triangleSet->getColorList()->size() << endl << __indent;
-
-        cpid = 0;
-        Color4Array::const_iterator endColor = triangleSet->getColorList()->end();
-
-        for (Color4Array::const_iterator itColor = triangleSet->getColorList()->begin(); itColor != endColor; ++itColor, ++cpid) 
-        {
-		        __geomStream << "texture { pigment { rgbt ";
-                GEOM_POVPRINT_COLOR4(__geomStream,(*itColor));
-                __geomStream << "}}";
-		        if (itColor != endColor -1){
-                    __geomStream << ", ";
-                    if ((cpid+1) % 5 == 0) __geomStream << endl << __indent;
-                }
-                else __geomStream << '}' << endl ;
-        }
+        __writer.writeArray(__geomStream,triangleSet->getColorList()->size(),
+                            pov_array_format(triangleSet->getColorList()),", ",perline,linesep);
+        if (!triangleSet->getColorList()->empty()) __geomStream << '}' << endl ;
     }
-     
-    __geomStream << __indent << "face_indices  { " << nbFaces << endl << __indent;
 
-    cpid = 0;
-    Index3Array::const_iterator endIndex = triangleSet->getIndexList()->end();
-
-    for (Index3Array::const_iterator itIndex = triangleSet->getIndexList()->begin(); itIndex != endIndex; ++itIndex, ++cpid) 
-    {
-		    GEOM_POVPRINT_INDEX3(__geomStream,(*itIndex));
-            if (triangleSet->hasColorList()){
-                __geomStream << ", ";
-                if(!triangleSet->getColorPerVertex()){
-                    __geomStream << cpid << ", " << cpid << ", " << cpid;
-                }
-                else {
-                    Index3& ind = (is_null_ptr(triangleSet->getColorIndexList()) ? triangleSet->getIndexList()->getAt(cpid) : triangleSet->getColorIndexList()->getAt(cpid));
-                    __geomStream << ind.getAt(0) << ", " << ind.getAt(1) << ", " << ind.getAt(2) ;
-                }
-            }
-		    if (itIndex != endIndex -1){
-                __geomStream << ", ";
-                if ((cpid+1) % 5 == 0) __geomStream << endl << __indent;
-            }
-            else __geomStream << '}' << endl ;
-    }
-
-    if (!(triangleSet->getNormalPerVertex() && is_null_ptr(triangleSet->getNormalIndexList()))) { 
+    __geomStream << __indent << "face_indices  { " << nbFaces << endl << __indent;
+    __writer.writeArray(__geomStream,nbFaces,PovFaceIndexFormat(triangleSet),", ",perline,linesep);
+    if (nbFaces != 0) __geomStream << '}' << endl ;
 
+    if (!(triangleSet->getNormalPerVertex() && is_null_ptr(triangleSet->getNormalIndexList()))) {
         __geomStream << __indent << "normal_indices  { " << nbFaces << endl << __indent;
-
-        for (cpid = 0; cpid < nbFaces;  ++cpid) 
-        {
-                if(!triangleSet->getNormalPerVertex()){
-                    Index3 findex(cpid,cpid,cpid);
-                    GEOM_POVPRINT_INDEX3(__geomStream,findex);
-                }
-                else {
-                    GEOM_POVPRINT_INDEX3(__geomStream,triangleSet->getNormalIndexList()->getAt(cpid));
-                }
-                if (cpid != nbFaces -1){
-                    __geomStream << ", ";
-                    if ((cpid+1) % 5 == 0) __geomStream << endl << __indent;
-                }
-                else __geomStream << '}' << endl ;
-        }
+        __writer.writeArray(__geomStream,nbFaces,PovNormalIndexFormat(triangleSet),", ",perline,linesep);
+        if (nbFaces != 0) __geomStream << '}' << endl ;
     }
 
     if (__tesselator.texCoordComputed() && triangleSet->getTexCoordIndexList()){
-
         __geomStream << __indent << "uv_indices  { " << nbFaces << endl << __indent;
-
-        for (cpid = 0; cpid < nbFaces;  ++cpid) 
-        {
-                GEOM_POVPRINT_INDEX3(__geomStream,triangleSet->getTexCoordIndexList()->getAt(cpid));
-                if (cpid != nbFaces -1){
-                    __geomStream << ", ";
-                    if ((cpid+1) % 5 == 0) __geomStream << endl << __indent;
-                }
-                else __geomStream << '}' << endl ;
-        }
+        __writer.writeArray(__geomStream,nbFaces,
+                            pov_array_format(triangleSet->getTexCoordIndexList()),", ",perline,linesep);
+        if (nbFaces != 0) __geomStream << '}' << endl ;
     }
 
     /*
@@ -251,6 +251,18 @@ using namespace std;
   };
 
 
+/// Print the array of values of a field in bulk with the TextWriter of the printer.
+#define GEOM_PRINT_FIELD_BULKARRAY(stream,obj,field) { \
+    stream << __indent << #field << " [ " << endl; \
+    GEOM_PRINT_INCREMENT_INDENT; \
+    stream << __indent; \
+    __writer.writeArray(stream,obj->get##field()->size(), \
+                        geom_array_format(*obj->get##field()),", \n" + __indent); \
+    GEOM_PRINT_DECREMENT_INDENT; \
+    stream << '\n' << __indent << "]" << endl; \
+  };
+
+
 #define GEOM_PRINT_FIELD_MATRIX(stream,obj,field,type) { \
     uint_t _cols =obj->get##field()->getRowSize(); \
     stream << __indent << #field << " [" << endl; \
@@ -278,6 +290,91 @@ using namespace std;
   stream << __indent <<'}' << endl; \
 
 
+/* ----------------------------------------------------------------------- */
+
+/* Formatting of the elements of arrays with the same syntax as the macros above. */
+
+inline void geom_format(TextBuffer& text, const real_t& val)
+{ text.appendReal(val); }
+
+inline void geom_format(TextBuffer& text, const Vector2& val)
+{
+  text.append('<'); text.appendReal(val.x());
+  text.append(','); text.appendReal(val.y()); text.append('>');
+}
+
+inline void geom_format(TextBuffer& text, const Vector3& val)
+{
+  text.append('<'); text.appendReal(val.x());
+  text.append(','); text.appendReal(val.y());
+  text.append(','); text.appendReal(val.z()); text.append('>');
+}
+
+inline void geom_format(TextBuffer& text, const Vector4& val)
+{
+  text.append('<'); text.appendReal(val.x());
+  text.append(','); text.appendReal(val.y());
+  text.append(','); text.appendReal(val.z());
+  text.append(','); text.appendReal(val.w()); text.append('>');
+}
+
+inline void geom_format(TextBuffer& text, const Index3& val)
+{
+  text.append('['); text.appendInteger(val.getAt(0));
+  text.append(','); text.appendInteger(val.getAt(1));
+  text.append(','); text.appendInteger(val.getAt(2)); text.append(']');
+}
+
+inline void geom_format(TextBuffer& text, const Index4& val)
+{
+  text.append('['); text.appendInteger(val.getAt(0));
+  text.append(','); text.appendInteger(val.getAt(1));
+  text.append(','); text.appendInteger(val.getAt(2));
+  text.append(','); text.appendInteger(val.getAt(3)); text.append(']');
+}
+
+inline void geom_format(TextBuffer& text, const Index& val)
+{
+  text.append('[');
+  uint_t _sizej = val.size();
+  for (uint_t _j = 0; _j < _sizej; _j++) {
+    text.appendInteger(val.getAt(_j));
+    text.append(_j == (_sizej - 1) ? ']' : ',');
+  }
+}
+
+inline void geom_format(TextBuffer& text, const Color4& val)
+{
+  if(val == Color4::BLACK) text.append("Black",5);
+  else if(val == Color4::BLUE) text.append("Blue",4);
+  else if(val == Color4::CYAN) text.append("Cyan",4);
+  else if(val == Color4::GREEN) text.append("Green",5);
+  else if(val == Color4::MAGENTA) text.append("Magenta",7);
+  else if(val == Color4::RED) text.append("Red",3);
+  else if(val == Color4::WHITE) text.append("White",5);
+  else if(val == Color4::YELLOW) text.append("Yellow",6);
+  else if(val.getRed() == val.getGreen() && val.getRed() == val.getBlue()&& val.getRed() == val.getAlpha())
+    text.appendInteger(uint32_t(val.getRed()));
+  else {
+    text.append('<'); text.appendInteger(uint32_t(val.getRed()));
+    text.append(','); text.appendInteger(uint32_t(val.getGreen()));
+    text.append(','); text.appendInteger(uint32_t(val.getBlue()));
+    text.append(','); text.appendInteger(uint32_t(val.getAlpha())); text.append('>');
+  }
+}
+
+template<class Array>
+struct GeomArrayFormat {
+  GeomArrayFormat(const Array& array) : array(array) { }
+  inline void operator()(TextBuffer& text, size_t i) const { geom_format(text,array.getAt(i)); }
+  const Array& array;
+};
+
+template<class Array>
+inline GeomArrayFormat<Array> geom_array_format(const Array& array)
+{ return GeomArrayFormat<Array>(array); }
+
+
 /* ----------------------------------------------------------------------- */
 
 
@@ -287,7 +384,8 @@ Printer::Printer( ) :
   __geomStream(cout),
   __matStream(cout),
   __cache(),
-  __indent() {
+  __indent(),
+  __writer() {
 }
 
 Printer::Printer( ostream& stream  ) :
@@ -296,7 +394,8 @@ Printer::Printer( ostream& stream  ) :
   __geomStream(stream),
   __matStream(stream),
   __cache(),
-  __indent() {
+  __indent(),
+  __writer() {
 }
 
 Printer::Printer( ostream& shapeStream, ostream& geomStream, ostream& matStream ) :
@@ -305,7 +404,8 @@ Printer::Printer( ostream& shapeStream, ostream& geomStream, ostream& matStream
   __geomStream(geomStream),
   __matStream(matStream),
   __cache(),
-  __indent() {
+  __indent(),
+  __writer() {
 }
 
 Printer::~Printer( ) {
@@ -538,9 +638,9 @@ bool Printer::process( MultiSpectral * multiSpectral ) {
   GEOM_ASSERT(multiSpectral);
   GEOM_PRINT_BEGIN(__matStream,"MultiSpectral",multiSpectral);
 
-  GEOM_PRINT_FIELD_ARRAY(__matStream,multiSpectral,Reflectance,REAL);
+  GEOM_PRINT_FIELD_BULKARRAY(__matStream,multiSpectral,Reflectance);
 
-  GEOM_PRINT_FIELD_ARRAY(__matStream,multiSpectral,Transmittance,REAL);
+  GEOM_PRINT_FIELD_BULKARRAY(__matStream,multiSpectral,Transmittance);
 
   if (! multiSpectral->isFilterToDefault())
     GEOM_PRINT_FIELD(__matStream,multiSpectral,Filter,INDEX3);
@@ -669,7 +769,7 @@ bool Printer::process( BezierCurve * bezierCurve ) {
 
   GEOM_PRINT_FIELD(__geomStream,bezierCurve,Degree,INTEGER);
 
-  GEOM_PRINT_FIELD_ARRAY(__geomStream,bezierCurve,CtrlPointList,VECTOR4);
+  GEOM_PRINT_FIELD_BULKARRAY(__geomStream,bezierCurve,CtrlPointList);
 
   if (! bezierCurve->isStrideToDefault())
     GEOM_PRINT_FIELD(__geomStream,bezierCurve,Stride,INTEGER);
@@ -854,13 +954,13 @@ bool Printer::process( Extrusion * extrusion ) {
   if(extrusion->getProfileTransformation()){
       ProfileTransformationPtr _p = extrusion->getProfileTransformation();
       if( ! extrusion->isScaleToDefault() )
-          GEOM_PRINT_FIELD_ARRAY(__geomStream, _p,Scale,VECTOR2);
+          GEOM_PRINT_FIELD_BULKARRAY(__geomStream, _p,Scale);
 
       if( ! extrusion->isOrientationToDefault() )
           GEOM_PRINT_FIELD_ARRAY(__geomStream, _p,Orientation,ANGLE);
 
       if(!  extrusion->isKnotListToDefault() )
-          GEOM_PRINT_FIELD_ARRAY(__geomStream, _p,KnotList,REAL);
+          GEOM_PRINT_FIELD_BULKARRAY(__geomStream, _p,KnotList);
 
   }
 
@@ -886,33 +986,33 @@ bool Printer::process( FaceSet * faceSet ) {
   GEOM_ASSERT(faceSet);
   GEOM_PRINT_BEGIN(__geomStream,"FaceSet",faceSet);
 
-  GEOM_PRINT_FIELD_ARRAY(__geomStream,faceSet,PointList,VECTOR3);
+  GEOM_PRINT_FIELD_BULKARRAY(__geomStream,faceSet,PointList);
 
-  GEOM_PRINT_FIELD_ARRAY(__geomStream,faceSet,IndexList,INDEXN);
+  GEOM_PRINT_FIELD_BULKARRAY(__geomStream,faceSet,IndexList);
 
   if (!faceSet->isNormalPerVertexToDefault())
 	GEOM_PRINT_FIELD(__geomStream,faceSet,NormalPerVertex,BOOLEAN);
 
   if (!faceSet->isNormalListToDefault())
-	GEOM_PRINT_FIELD_ARRAY(__geomStream,faceSet,NormalList,VECTOR3);
+	GEOM_PRINT_FIELD_BULKARRAY(__geomStream,faceSet,NormalList);
 
   if (!faceSet->isNormalIndexListToDefault())
-	GEOM_PRINT_FIELD_ARRAY(__geomStream,faceSet,NormalIndexList,INDEXN);
+	GEOM_PRINT_FIELD_BULKARRAY(__geomStream,faceSet,NormalIndexList);
 
   if (!faceSet->isColorPerVertexToDefault())
 	  GEOM_PRINT_FIELD(__geomStream,faceSet,ColorPerVertex,BOOLEAN);
 
   if (!faceSet->isColorListToDefault())
-	GEOM_PRINT_FIELD_ARRAY(__geomStream,faceSet,ColorList,COLOR4);
+	GEOM_PRINT_FIELD_BULKARRAY(__geomStream,faceSet,ColorList);
 
   if (!faceSet->isColorIndexListToDefault())
-	GEOM_PRINT_FIELD_ARRAY(__geomStream,faceSet,ColorIndexList,INDEXN);
+	GEOM_PRINT_FIELD_BULKARRAY(__geomStream,faceSet,ColorIndexList);
 
   if (! faceSet->isTexCoordListToDefault())
-	GEOM_PRINT_FIELD_ARRAY(__geomStream,faceSet,TexCoordList,VECTOR2);
+	GEOM_PRINT_FIELD_BULKARRAY(__geomStream,faceSet,TexCoordList);
 
   if (! faceSet->isTexCoordIndexListToDefault())
-	GEOM_PRINT_FIELD_ARRAY(__geomStream,faceSet,TexCoordIndexList,INDEXN);
+	GEOM_PRINT_FIELD_BULKARRAY(__geomStream,faceSet,TexCoordIndexList);
 
   if (! faceSet->isCCWToDefault())
     GEOM_PRINT_FIELD(__geomStream,faceSet,CCW,BOOLEAN);
@@ -1008,10 +1108,10 @@ bool Printer::process( NurbsCurve * nurbsCurve ) {
   if (! nurbsCurve->isDegreeToDefault())
     GEOM_PRINT_FIELD(__geomStream,nurbsCurve,Degree,INTEGER);
 
-  GEOM_PRINT_FIELD_ARRAY(__geomStream,nurbsCurve,CtrlPointList,VECTOR4);
+  GEOM_PRINT_FIELD_BULKARRAY(__geomStream,nurbsCurve,CtrlPointList);
 
   if (! nurbsCurve->isKnotListToDefault())
-    GEOM_PRINT_FIELD_ARRAY(__geomStream,nurbsCurve,KnotList,REAL);
+    GEOM_PRINT_FIELD_BULKARRAY(__geomStream,nurbsCurve,KnotList);
 
   if (! nurbsCurve->isStrideToDefault())
     GEOM_PRINT_FIELD(__geomStream,nurbsCurve,Stride,INTEGER);
@@ -1039,10 +1139,10 @@ bool Printer::process( NurbsPatch * nurbsPatch ) {
   GEOM_PRINT_FIELD_MATRIX(__geomStream,nurbsPatch,CtrlPointMatrix,VECTOR4);
 
   if (! nurbsPatch->isUKnotListToDefault())
-    GEOM_PRINT_FIELD_ARRAY(__geomStream,nurbsPatch,UKnotList,REAL);
+    GEOM_PRINT_FIELD_BULKARRAY(__geomStream,nurbsPatch,UKnotList);
 
   if (! nurbsPatch->isVKnotListToDefault())
-    GEOM_PRINT_FIELD_ARRAY(__geomStream,nurbsPatch,VKnotList,REAL);
+    GEOM_PRINT_FIELD_BULKARRAY(__geomStream,nurbsPatch,VKnotList);
 
   if (! nurbsPatch->isUStrideToDefault())
     GEOM_PRINT_FIELD(__geomStream,nurbsPatch,UStride,INTEGER);
@@ -1111,10 +1211,10 @@ bool Printer::process( PointSet * pointSet ) {
   GEOM_ASSERT(pointSet);
   GEOM_PRINT_BEGIN(__geomStream,"PointSet",pointSet);
 
-  GEOM_PRINT_FIELD_ARRAY(__geomStream,pointSet,PointList,VECTOR3);
+  GEOM_PRINT_FIELD_BULKARRAY(__geomStream,pointSet,PointList);
 
   if(! pointSet->isColorListToDefault())
-	GEOM_PRINT_FIELD_ARRAY(__geomStream,pointSet,ColorList,COLOR4);
+	GEOM_PRINT_FIELD_BULKARRAY(__geomStream,pointSet,ColorList);
 
   if(! pointSet->isWidthToDefault())
 	GEOM_PRINT_FIELD(__geomStream,pointSet,Width,INTEGER);
@@ -1131,10 +1231,10 @@ bool Printer::process( Polyline * polyline ) {
   GEOM_ASSERT(polyline);
   GEOM_PRINT_BEGIN(__geomStream,"Polyline",polyline);
 
-  GEOM_PRINT_FIELD_ARRAY(__geomStream,polyline,PointList,VECTOR3);
+  GEOM_PRINT_FIELD_BULKARRAY(__geomStream,polyline,PointList);
 
   if(! polyline->isColorListToDefault())
-	GEOM_PRINT_FIELD_ARRAY(__geomStream,polyline,ColorList,COLOR4);
+	GEOM_PRINT_FIELD_BULKARRAY(__geomStream,polyline,ColorList);
 
   if(! polyline->isWidthToDefault())
 	GEOM_PRINT_FIELD(__geomStream,polyline,Width,INTEGER);
@@ -1197,33 +1297,33 @@ bool Printer::process( QuadSet * quadSet ) {
   GEOM_ASSERT(quadSet);
   GEOM_PRINT_BEGIN(__geomStream,"QuadSet",quadSet);
 
-  GEOM_PRINT_FIELD_ARRAY(__geomStream,quadSet,PointList,VECTOR3);
+  GEOM_PRINT_FIELD_BULKARRAY(__geomStream,quadSet,PointList);
 
-  GEOM_PRINT_FIELD_ARRAY(__geomStream,quadSet,IndexList,INDEX4);
+  GEOM_PRINT_FIELD_BULKARRAY(__geomStream,quadSet,IndexList);
 
   if (!quadSet->isNormalPerVertexToDefault())
 	  GEOM_PRINT_FIELD(__geomStream,quadSet,NormalPerVertex,BOOLEAN);
 
   if (!quadSet->isNormalListToDefault())
-	GEOM_PRINT_FIELD_ARRAY(__geomStream,quadSet,NormalList,VECTOR3);
+	GEOM_PRINT_FIELD_BULKARRAY(__geomStream,quadSet,NormalList);
 
   if (!quadSet->isNormalIndexListToDefault())
-	GEOM_PRINT_FIELD_ARRAY(__geomStream,quadSet,NormalIndexList,INDEX4);
+	GEOM_PRINT_FIELD_BULKARRAY(__geomStream,quadSet,NormalIndexList);
 
   if (!quadSet->isColorPerVertexToDefault())
 	  GEOM_PRINT_FIELD(__geomStream,quadSet,ColorPerVertex,BOOLEAN);
 
   if (!quadSet->isColorListToDefault())
-	GEOM_PRINT_FIELD_ARRAY(__geomStream,quadSet,ColorList,COLOR4);
+	GEOM_PRINT_FIELD_BULKARRAY(__geomStream,quadSet,ColorList);
 
   if (!quadSet->isColorIndexListToDefault())
-	GEOM_PRINT_FIELD_ARRAY(__geomStream,quadSet,ColorIndexList,INDEX4);
+	GEOM_PRINT_FIELD_BULKARRAY(__geomStream,quadSet,ColorIndexList);
 
   if (! quadSet->isTexCoordListToDefault())
-	GEOM_PRINT_FIELD_ARRAY(__geomStream,quadSet,TexCoordList,VECTOR2);
+	GEOM_PRINT_FIELD_BULKARRAY(__geomStream,quadSet,TexCoordList);
 
   if (! quadSet->isTexCoordIndexListToDefault())
-	GEOM_PRINT_FIELD_ARRAY(__geomStream,quadSet,TexCoordIndexList,INDEX4);
+	GEOM_PRINT_FIELD_BULKARRAY(__geomStream,quadSet,TexCoordIndexList);
 
   if (! quadSet->isCCWToDefault())
     GEOM_PRINT_FIELD(__geomStream,quadSet,CCW,BOOLEAN);
@@ -1338,33 +1438,33 @@ bool Printer::process( TriangleSet * triangleSet ) {
   GEOM_ASSERT(triangleSet);
   GEOM_PRINT_BEGIN(__geomStream,"TriangleSet",triangleSet);
 
-  GEOM_PRINT_FIELD_ARRAY(__geomStream,triangleSet,PointList,VECTOR3);
+  GEOM_PRINT_FIELD_BULKARRAY(__geomStream,triangleSet,PointList);
 
-  GEOM_PRINT_FIELD_ARRAY(__geomStream,triangleSet,IndexList,INDEX3);
+  GEOM_PRINT_FIELD_BULKARRAY(__geomStream,triangleSet,IndexList);
 
   if (!triangleSet->isNormalPerVertexToDefault())
 	GEOM_PRINT_FIELD(__geomStream,triangleSet,NormalPerVertex,BOOLEAN);
 
   if (!triangleSet->isNormalListToDefault())
-	GEOM_PRINT_FIELD_ARRAY(__geomStream,triangleSet,NormalList,VECTOR3);
+	GEOM_PRINT_FIELD_BULKARRAY(__geomStream,triangleSet,NormalList);
 
   if (!triangleSet->isNormalIndexListToDefault())
-	GEOM_PRINT_FIELD_ARRAY(__geomStream,triangleSet,NormalIndexList,INDEX3);
+	GEOM_PRINT_FIELD_BULKARRAY(__geomStream,triangleSet,NormalIndexList);
 
   if (!triangleSet->isColorPerVertexToDefault())
 	GEOM_PRINT_FIELD(__geomStream,triangleSet,ColorPerVertex,BOOLEAN);
 
   if (!triangleSet->isColorListToDefault())
-	GEOM_PRINT_FIELD_ARRAY(__geomStream,triangleSet,ColorList,COLOR4);
+	GEOM_PRINT_FIELD_BULKARRAY(__geomStream,triangleSet,ColorList);
 
   if (!triangleSet->isColorIndexListToDefault())
-	GEOM_PRINT_FIELD_ARRAY(__geomStream,triangleSet,ColorIndexList,INDEX3);
+	GEOM_PRINT_FIELD_BULKARRAY(__geomStream,triangleSet,ColorIndexList);
 
   if (! triangleSet->isTexCoordListToDefault())
-	GEOM_PRINT_FIELD_ARRAY(__geomStream,triangleSet,TexCoordList,VECTOR2);
+	GEOM_PRINT_FIELD_BULKARRAY(__geomStream,triangleSet,TexCoordList);
 
   if (! triangleSet->isTexCoordIndexListToDefault())
-	GEOM_PRINT_FIELD_ARRAY(__geomStream,triangleSet,TexCoordIndexList,INDEX3);
+	GEOM_PRINT_FIELD_BULKARRAY(__geomStream,triangleSet,TexCoordIndexList);
 
   if (! triangleSet->isCCWToDefault())
     GEOM_PRINT_FIELD(__geomStream,triangleSet,CCW,BOOLEAN);
@@ -1389,7 +1489,7 @@ bool Printer::process( BezierCurve2D * bezierCurve ) {
 
   GEOM_PRINT_FIELD(__geomStream,bezierCurve,Degree,INTEGER);
 
-  GEOM_PRINT_FIELD_ARRAY(__geomStream,bezierCurve,CtrlPointList,VECTOR2);
+  GEOM_PRINT_FIELD_BULKARRAY(__geomStream,bezierCurve,CtrlPointList);
 
   if (! bezierCurve->isStrideToDefault())
     GEOM_PRINT_FIELD(__geomStream,bezierCurve,Stride,INTEGER);
@@ -1430,10 +1530,10 @@ bool Printer::process( NurbsCurve2D * nurbsCurve ) {
   if (! nurbsCurve->isDegreeToDefault())
     GEOM_PRINT_FIELD(__geomStream,nurbsCurve,Degree,INTEGER);
 
-  GEOM_PRINT_FIELD_ARRAY(__geomStream,nurbsCurve,CtrlPointList,VECTOR2);
+  GEOM_PRINT_FIELD_BULKARRAY(__geomStream,nurbsCurve,CtrlPointList);
 
   if (! nurbsCurve->isKnotListToDefault())
-    GEOM_PRINT_FIELD_ARRAY(__geomStream,nurbsCurve,KnotList,REAL);
+    GEOM_PRINT_FIELD_BULKARRAY(__geomStream,nurbsCurve,KnotList);
 
   if (! nurbsCurve->isStrideToDefault())
     GEOM_PRINT_FIELD(__geomStream,nurbsCurve,Stride,INTEGER);
@@ -1452,7 +1552,7 @@ bool Printer::process( PointSet2D * pointSet ) {
   GEOM_ASSERT(pointSet);
   GEOM_PRINT_BEGIN(__geomStream,"PointSet2D",pointSet);
 
-  GEOM_PRINT_FIELD_ARRAY(__geomStream,pointSet,PointList,VECTOR2);
+  GEOM_PRINT_FIELD_BULKARRAY(__geomStream,pointSet,PointList);
 
   if (! pointSet->isWidthToDefault())
     GEOM_PRINT_FIELD(__geomStream,pointSet,Width,INTEGER);
@@ -1469,7 +1569,7 @@ bool Printer::process( Polyline2D * polyline ) {
   GEOM_ASSERT(polyline);
   GEOM_PRINT_BEGIN(__geomStream,"Polyline2D",polyline);
 
-  GEOM_PRINT_FIELD_ARRAY(__geomStream,polyline,PointList,VECTOR2);
+  GEOM_PRINT_FIELD_BULKARRAY(__geomStream,polyline,PointList);
 
   if (! polyline->isWidthToDefault())
     GEOM_PRINT_FIELD(__geomStream,polyline,Width,INTEGER);
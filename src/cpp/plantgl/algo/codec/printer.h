@@ -42,6 +42,7 @@
 #define __actn_printer_h__
 
 #include "codec_config.h"
+#include "textwriter.h"
 #include <plantgl/tool/util_types.h>
 #include <plantgl/tool/rcobject.h>
 #include <plantgl/tool/util_hashset.h>
@@ -94,6 +95,11 @@ public:
   /// test if an object is already printed.
   virtual bool isPrinted(SceneObjectPtr);
 
+  /** Set the number of significant digits of the reals written in arrays.
+      The precision of the output stream is used if negative, the shortest exact text if 0. */
+  inline void setArrayPrecision(int precision) { __writer.setPrecision(precision); }
+  inline int getArrayPrecision() const { return __writer.getPrecision(); }
+
   /// Add comment in the header of the output file.
   virtual bool header(const char * comment = NULL);
 
@@ -229,6 +235,9 @@ protected:
   /// The ident used to perform a pretty print.
   std::string __indent;
 
+  /// The writer of the large arrays.
+  TextWriter __writer;
+
 };
 
 
@@ -145,68 +145,120 @@ ostream& print_value(ostream& os, const GeometryArrayPtr& value, const std::stri
 	return os;
 }
 
+/* Formatting of the elements of arrays with the same syntax as print_value. */
+
+inline void py_format(TextBuffer& text, const real_t& value)
+{
+	text.appendReal(value);
+}
+
+inline void py_format(TextBuffer& text, const Vector2& value)
+{
+	text.append('('); text.appendReal(value.x());
+	text.append(", ",2); text.appendReal(value.y()); text.append(')');
+}
+
+inline void py_format(TextBuffer& text, const Vector3& value)
+{
+	text.append('('); text.appendReal(value.x());
+	text.append(", ",2); text.appendReal(value.y());
+	text.append(", ",2); text.appendReal(value.z()); text.append(')');
+}
+
+inline void py_format(TextBuffer& text, const Vector4& value)
+{
+	text.append('('); text.appendReal(value.x());
+	text.append(", ",2); text.appendReal(value.y());
+	text.append(", ",2); text.appendReal(value.z());
+	text.append(", ",2); text.appendReal(value.w()); text.append(')');
+}
+
+inline void py_format(TextBuffer& text, const Color4& value)
+{
+	text.append('('); text.appendInteger(uint32_t(value.getRed()));
+	text.append(','); text.appendInteger(uint32_t(value.getGreen()));
+	text.append(','); text.appendInteger(uint32_t(value.getBlue()));
+	text.append(','); text.appendInteger(uint32_t(value.getAlpha())); text.append(')');
+}
+
+inline void py_format(TextBuffer& text, const Index3& value)
+{
+	text.append('('); text.appendInteger(value[0]);
+	text.append(','); text.appendInteger(value[1]);
+	text.append(','); text.appendInteger(value[2]); text.append(')');
+}
+
+inline void py_format(TextBuffer& text, const Index4& value)
+{
+	text.append('('); text.appendInteger(value[0]);
+	text.append(','); text.appendInteger(value[1]);
+	text.append(','); text.appendInteger(value[2]);
+	text.append(','); text.appendInteger(value[3]); text.append(')');
+}
+
+template<class array>
+struct PyArrayFormat {
+	PyArrayFormat(const array& value) : value(value) { }
+	inline void operator()(TextBuffer& text, size_t i) const { py_format(text,value->getAt(i)); }
+	const array& value;
+};
+
 template<class array>
-ostream& print_value_array(ostream& os, const array& value, const std::string& pglnamespace)
+ostream& print_value_array(ostream& os, const array& value, const std::string& pglnamespace, TextWriter& writer)
 {
 	os << "([";
-	if (!value->empty()){
-		uint_t _sizei = value->size();
-		print_value(os,value->getAt(0),pglnamespace);
-		for (uint_t _i = 1; _i < _sizei; _i++) {
-			os << ','; print_value(os,value->getAt(_i),pglnamespace);
-		}
-	}
+	writer.writeArray(os,value->size(),PyArrayFormat<array>(value),",");
 	os << "])";
 	return os;
 }
 
-ostream& print_value(ostream& os, const Index3ArrayPtr& value, const std::string& pglnamespace)
+ostream& print_value(ostream& os, const Index3ArrayPtr& value, const std::string& pglnamespace, TextWriter& writer)
 {
 	os << _pgltype(pglnamespace,"Index3Array");
-	print_value_array(os,value,pglnamespace);
+	print_value_array(os,value,pglnamespace,writer);
 	return os;
 }
 
-ostream& print_value(ostream& os, const Index4ArrayPtr& value, const std::string& pglnamespace)
+ostream& print_value(ostream& os, const Index4ArrayPtr& value, const std::string& pglnamespace, TextWriter& writer)
 {
 	os << _pgltype(pglnamespace,"Index4Array");
-	print_value_array(os,value,pglnamespace);
+	print_value_array(os,value,pglnamespace,writer);
 	return os;
 }
 
-ostream& print_value(ostream& os, const RealArrayPtr& value, const std::string& pglnamespace)
+ostream& print_value(ostream& os, const RealArrayPtr& value, const std::string& pglnamespace, TextWriter& writer)
 {
 	os << _pgltype(pglnamespace,"RealArray");
-	print_value_array(os,value,pglnamespace);
+	print_value_array(os,value,pglnamespace,writer);
 	return os;
 }
 
-ostream& print_value(ostream& os, const Color4ArrayPtr& value, const std::string& pglnamespace)
+ostream& print_value(ostream& os, const Color4ArrayPtr& value, const std::string& pglnamespace, TextWriter& writer)
 {	
 	os << _pgltype(pglnamespace,"Color4Array");
-	print_value_array(os,value,pglnamespace);
+	print_value_array(os,value,pglnamespace,writer);
 	return os;
 } 
 
 
-ostream& print_value(ostream& os, const Point2ArrayPtr& value, const std::string& pglnamespace)
+ostream& print_value(ostream& os, const Point2ArrayPtr& value, const std::string& pglnamespace, TextWriter& writer)
 {
 	os << _pgltype(pglnamespace,"Point2Array");
-	print_value_array(os,value,pglnamespace);
+	print_value_array(os,value,pglnamespace,writer);
 	return os;
 }
 
-ostream& print_value(ostream& os, const Point3ArrayPtr& value, const std::string& pglnamespace)
+ostream& print_value(ostream& os, const Point3ArrayPtr& value, const std::string& pglnamespace, TextWriter& writer)
 {
 	os << _pgltype(pglnamespace,"Point3Array");
-	print_value_array(os,value,pglnamespace);
+	print_value_array(os,value,pglnamespace,writer);
 	return os;
 }
 
-ostream& print_value(ostream& os, const Point4ArrayPtr& value, const std::string& pglnamespace)
+ostream& print_value(ostream& os, const Point4ArrayPtr& value, const std::string& pglnamespace, TextWriter& writer)
 {
 	os << _pgltype(pglnamespace,"Point4Array");
-	print_value_array(os,value,pglnamespace);
+	print_value_array(os,value,pglnamespace,writer);
 	return os;
 }
 
@@ -268,6 +320,13 @@ inline ostream& print_value(ostream& os, PolylinePtr value,const std::string& pg
 	return os << compute_name(value);
 }
 
+/// The values other than the arrays are printed without the TextWriter.
+template<class T>
+inline ostream& print_value(ostream& os, const T& value, const std::string& pglnamespace, TextWriter& writer)
+{
+	return print_value(os,value,pglnamespace);
+}
+
 /* ----------------------------------------------------------------------- */
 
 
@@ -276,7 +335,7 @@ ostream& PyPrinter::print_field(ostream& os, const string& name, const string& f
 {
 	if(newline) os << __indentation; 
 	os << name << '.' << field << " = ";
-	print_value(os,value,__pglnamespace);
+	print_value(os,value,__pglnamespace,__writer);
 	if(newline) os << endl;
 	return os;
 }
@@ -286,7 +345,7 @@ ostream& PyPrinter::print_arg_field(ostream& os, const string& field, const T& v
 {
 	if(newline) os << __indentation; 
 	os << field << " = ";
-	print_value(os,value,__pglnamespace);
+	print_value(os,value,__pglnamespace,__writer);
 	os << " , ";
 	if(newline) os << endl;
 	return os;
@@ -297,7 +356,7 @@ template <typename T>
 ostream& PyPrinter::print_unamed_arg_field(ostream& os, const T& value, bool newline)
 {
 	if(newline) os << __indentation; 
-	print_value(os,value,__pglnamespace);
+	print_value(os,value,__pglnamespace,__writer);
 	os << " , ";
 	if(newline) os << endl;
 	return os;
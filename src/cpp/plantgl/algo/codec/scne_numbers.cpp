@@ -0,0 +1,223 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2006 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+#include "scne_numbers.h"
+#include <plantgl/tool/util_parallel.h>
+#include <sstream>
+#include <locale>
+#include <cstring>
+#include <cmath>
+#include <cfloat>
+
+PGL_USING_NAMESPACE
+TOOLS_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+namespace {
+
+const double POWERS_OF_10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+inline bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+/// Conversion of the numbers that cannot be converted exactly with double arithmetic.
+double parseRealWithStream(const char * begin, const char * end)
+{
+  std::istringstream stream(std::string(begin, end));
+  stream.imbue(std::locale::classic());
+  double value = 0;
+  stream >> value;
+  // The stream gives the largest double on overflow, where strtod gives an infinity.
+  if (stream.fail() && (value == DBL_MAX || value == -DBL_MAX)) return (value > 0 ? HUGE_VAL : -HUGE_VAL);
+  return value;
+}
+
+/* Array literals are cut in chunks of about CHUNK_SIZE characters, starting on a '<'.
+   The vectors of each chunk are counted, then converted, chunk by chunk in parallel. */
+const size_t CHUNK_SIZE = 1 << 18;
+
+struct LiteralChunks {
+  LiteralChunks(const char * text, size_t length)
+  {
+    size_t nbChunks = length / CHUNK_SIZE + 1;
+    const char * end = text + length;
+    bounds.push_back(text);
+    for (size_t i = 1; i < nbChunks; ++i) {
+      const char * bound = text + i * (length / nbChunks);
+      if (bound < bounds.back()) bound = bounds.back();
+      const char * next = (const char *)memchr(bound, '<', end - bound);
+      bounds.push_back(next ? next : end);
+    }
+    bounds.push_back(end);
+    counts.resize(nbChunks, 0);
+  }
+
+  size_t size() const { return counts.size(); }
+
+  void operator()(size_t begin, size_t end, size_t)
+  {
+    for (size_t c = begin; c < end; ++c)
+      for (const char * p = bounds[c]; (p = (const char *)memchr(p, '<', bounds[c + 1] - p)) != NULL; ++p)
+        ++counts[c];
+  }
+
+  std::vector<const char *> bounds;
+  /// Number of vectors in each chunk, then index of the first vector of each chunk.
+  std::vector<size_t> counts;
+};
+
+template<class Array, int Dim>
+struct LiteralArrayParser {
+  typedef typename Array::element_type Vector;
+
+  LiteralArrayParser(const LiteralChunks& chunks, Array& result) : __chunks(chunks), __result(result) {}
+
+  void operator()(size_t begin, size_t end, size_t)
+  {
+    for (size_t c = begin; c < end; ++c) {
+      typename Array::iterator it = __result.begin() + __chunks.counts[c];
+      const char * p = __chunks.bounds[c];
+      const char * chunkEnd = __chunks.bounds[c + 1];
+      while ((p = (const char *)memchr(p, '<', chunkEnd - p)) != NULL) {
+        ++p;
+        double values[Dim];
+        for (int k = 0; k < Dim; ++k) {
+          while (isSpace(*p)) ++p;
+          values[k] = geom_parse_real(p);
+          while (isSpace(*p)) ++p;
+          ++p; // ',' or '>'
+        }
+        *it = toVector(values, (Vector *)0);
+        ++it;
+      }
+    }
+  }
+
+  static TOOLS(Vector2) toVector(const double * v, TOOLS(Vector2) *) { return TOOLS(Vector2)(v[0], v[1]); }
+  static TOOLS(Vector3) toVector(const double * v, TOOLS(Vector3) *) { return TOOLS(Vector3)(v[0], v[1], v[2]); }
+
+  const LiteralChunks& __chunks;
+  Array& __result;
+};
+
+template<class Array, int Dim>
+RCPtr<Array> parseLiteralArray(const char * text, size_t length)
+{
+  LiteralChunks chunks(text, length);
+  parallel_for(chunks.size(), chunks);
+  size_t total = 0;
+  for (size_t c = 0; c < chunks.size(); ++c) {
+    size_t count = chunks.counts[c];
+    chunks.counts[c] = total;
+    total += count;
+  }
+  RCPtr<Array> result(new Array(total));
+  LiteralArrayParser<Array, Dim> parser(chunks, *result);
+  parallel_for(chunks.size(), parser);
+  return result;
+}
+
+}
+
+/* ----------------------------------------------------------------------- */
+
+double PGL(geom_parse_real)(const char *& text)
+{
+  const char * begin = text;
+  const char * p = text;
+  bool negative = false;
+  if (*p == '-' || *p == '+') negative = (*p++ == '-');
+
+  // Up to 19 significant digits fit in the mantissa.
+  unsigned long long mantissa = 0;
+  int digits = 0;
+  int exponent = 0;
+  bool truncated = false;
+  for (; isDigit(*p); ++p) {
+    if (digits < 19) {
+      mantissa = mantissa * 10 + (*p - '0');
+      if (mantissa) ++digits;
+    }
+    else {
+      ++exponent;
+      if (*p != '0') truncated = true;
+    }
+  }
+  if (*p == '.') {
+    for (++p; isDigit(*p); ++p) {
+      if (digits < 19) {
+        mantissa = mantissa * 10 + (*p - '0');
+        if (mantissa) ++digits;
+        --exponent;
+      }
+      else if (*p != '0') truncated = true;
+    }
+  }
+  if ((*p == 'e' || *p == 'E') && (isDigit(p[1]) || ((p[1] == '-' || p[1] == '+') && isDigit(p[2])))) {
+    ++p;
+    bool negativeExponent = false;
+    if (*p == '-' || *p == '+') negativeExponent = (*p++ == '-');
+    int value = 0;
+    for (; isDigit(*p); ++p)
+      if (value < 100000) value = value * 10 + (*p - '0');
+    exponent += (negativeExponent ? -value : value);
+  }
+  text = p;
+
+  // Exact conversion when the mantissa and the power of 10 are exactly represented as doubles.
+  double result;
+  if (mantissa == 0) result = 0;
+  else if (!truncated && mantissa <= (1ULL << 53) && exponent >= -22 && exponent <= 22) {
+    result = double(mantissa);
+    if (exponent < 0) result /= POWERS_OF_10[-exponent];
+    else result *= POWERS_OF_10[exponent];
+  }
+  else return parseRealWithStream(begin, p);
+  return negative ? -result : result;
+}
+
+Point2ArrayPtr PGL(geom_parse_point2_array)(const char * text, size_t length)
+{
+  return parseLiteralArray<Point2Array, 2>(text, length);
+}
+
+Point3ArrayPtr PGL(geom_parse_point3_array)(const char * text, size_t length)
+{
+  return parseLiteralArray<Point3Array, 3>(text, length);
+}
+
+/* ----------------------------------------------------------------------- */
@@ -0,0 +1,71 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2006 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+/*! \file scne_numbers.h
+    \brief Fast conversion of the numbers and numeric array literals read by the geom scanner.
+*/
+
+#ifndef __scne_numbers_h__
+#define __scne_numbers_h__
+
+/* ----------------------------------------------------------------------- */
+
+#include "codec_config.h"
+#include <plantgl/scenegraph/container/pointarray.h>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/** Converts the number written at \e text, with '.' as decimal separator whatever the locale.
+    \e text is moved after the number. The result is the same as strtod in the "C" locale. */
+CODEC_API double geom_parse_real(const char *& text);
+
+/** Converts a literal array of 2D vectors written only with numbers, such as [<0,1>,<2.5,-1e3>].
+    \e text must match the array literal rule of the geom scanner. Large arrays are converted in parallel. */
+CODEC_API Point2ArrayPtr geom_parse_point2_array(const char * text, size_t length);
+
+/// Converts a literal array of 3D vectors written only with numbers, such as [<0,1,2>,<2.5,-1e3,0>].
+CODEC_API Point3ArrayPtr geom_parse_point3_array(const char * text, size_t length);
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+// __scne_numbers_h__
+#endif
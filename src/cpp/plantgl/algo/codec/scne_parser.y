@@ -492,6 +492,8 @@ void parser_build_object(RCPtr<GeomType> *& shape, std::string * name, GeomBuild
 %token <real_o>        TokReal
 %token <string_t>      TokName
 %token <string_t>      TokFile
+%token <vector2_a>     TokPoint2Array
+%token <vector3_a>     TokPoint3Array
 
 %token TokShape
 %token TokInline
@@ -2777,7 +2779,8 @@ Filename :
 Point2Array:
    '[' Vector2List ']' {
      GEOM_PARSER_CREATE_ARRAY(Point2Array,$2,$$);
-   };
+   }
+ | TokPoint2Array { $$ = $1; };
 
 /*
 Point2ArrayList:
@@ -2797,14 +2800,30 @@ Point2Matrix:
 Point3Array:
    '[' Vector3List ']' {
      GEOM_PARSER_CREATE_ARRAY(Point3Array,$2,$$);
-   };
+   }
+ | TokPoint3Array { $$ = $1; };
 
 Point3ArrayList:
    Point3ArrayList ',' '[' Vector3List ']' {
      GEOM_PARSER_ADD_MATRIX($1,$4,$$);
    }
+   | Point3ArrayList ',' TokPoint3Array {
+     if ($1 && !($1->empty())) {
+       $1->pushRow((*$3)->begin(),(*$3)->end());
+       $$ = $1;
+     }
+     else {
+       if ($1) delete $1;
+       $$ = NULL;
+     }
+     delete $3;
+   }
    |  '[' Vector3List ']' {
      GEOM_PARSER_INIT_MATRIX(Point3Matrix,$2,$$);
+   }
+   |  TokPoint3Array {
+     $$ = new Point3Matrix((*$1)->begin(),(*$1)->end(),(*$1)->size());
+     delete $1;
    };
 
 Point3Matrix:
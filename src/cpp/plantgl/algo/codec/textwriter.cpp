@@ -0,0 +1,291 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2006 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+
+
+#include "textwriter.h"
+#include "scne_numbers.h"
+#include <cmath>
+#include <cfloat>
+#include <cstdio>
+#include <cstdlib>
+
+PGL_USING_NAMESPACE
+TOOLS_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+namespace {
+
+const double POWERS_OF_10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+const unsigned long long INTEGER_POWERS_OF_10[] = {
+  1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL,
+  1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+  100000000000000ULL, 1000000000000000ULL };
+
+/// Largest number of significant digits converted with double arithmetic.
+const int MAX_FAST_PRECISION = 15;
+
+/// Conversion of the values that cannot be converted exactly with double arithmetic.
+char * formatRealWithPrintf(char * buffer, double value, int precision)
+{
+  int length = sprintf(buffer, "%.*g", precision, value);
+  // The decimal separator of printf depends on the locale.
+  for (int i = 0; i < length; ++i) if (buffer[i] == ',') buffer[i] = '.';
+  return buffer + length;
+}
+
+/** Writes the \e nbdigits first chars of \e digits in the style of %g with \e precision digits,
+    given the decimal exponent of the first digit. */
+char * writeDigits(char * buffer, const char * digits, int nbdigits, int exponent, int precision)
+{
+  int significant = nbdigits;
+  while (significant > 1 && digits[significant-1] == '0') --significant;
+  if (exponent < -4 || exponent >= precision) {
+    *buffer++ = digits[0];
+    if (significant > 1) {
+      *buffer++ = '.';
+      for (int i = 1; i < significant; ++i) *buffer++ = digits[i];
+    }
+    *buffer++ = 'e';
+    if (exponent < 0) { *buffer++ = '-'; exponent = -exponent; }
+    else *buffer++ = '+';
+    if (exponent >= 100) { *buffer++ = char('0' + exponent / 100); exponent %= 100; }
+    *buffer++ = char('0' + exponent / 10);
+    *buffer++ = char('0' + exponent % 10);
+  }
+  else if (exponent >= 0) {
+    for (int i = 0; i <= exponent; ++i) *buffer++ = (i < nbdigits ? digits[i] : '0');
+    if (significant > exponent + 1) {
+      *buffer++ = '.';
+      for (int i = exponent + 1; i < significant; ++i) *buffer++ = digits[i];
+    }
+  }
+  else {
+    *buffer++ = '0';
+    *buffer++ = '.';
+    for (int i = -1; i > exponent; --i) *buffer++ = '0';
+    for (int i = 0; i < significant; ++i) *buffer++ = digits[i];
+  }
+  return buffer;
+}
+
+/** Scales \e value by 10^\e power with one rounding only.
+    Returns false if the power of 10 is not exactly representable. */
+inline bool scale(double value, int power, double& result)
+{
+  if (power > 22 || power < -22) return false;
+  result = (power >= 0 ? value * POWERS_OF_10[power] : value / POWERS_OF_10[-power]);
+  return true;
+}
+
+/** Conversion of a finite non zero \e value with double arithmetic. The value is scaled to an integer
+    of \e precision digits: the fraction rounded away is exact, but the scaled value has an error
+    of one half ulp at most. If \e exact, values too close to a tie to know how they are rounded
+    are rejected. Returns NULL if the value is not converted. */
+char * formatRealWithDouble(char * buffer, double value, int precision, bool exact)
+{
+  if (value < 0) { *buffer++ = '-'; value = -value; }
+  int exponent = int(floor(log10(value)));
+  double scaled;
+  if (!scale(value, precision - 1 - exponent, scaled)) return NULL;
+  if (scaled < INTEGER_POWERS_OF_10[precision - 1]) {
+    --exponent;
+    if (!scale(value, precision - 1 - exponent, scaled)) return NULL;
+  }
+  else if (scaled >= INTEGER_POWERS_OF_10[precision]) {
+    ++exponent;
+    if (!scale(value, precision - 1 - exponent, scaled)) return NULL;
+  }
+  double integral = floor(scaled);
+  double fraction = scaled - integral;
+  if (exact && fabs(fraction - 0.5) <= scaled * 2.3e-16) return NULL;
+
+  unsigned long long mantissa = (unsigned long long)integral + (fraction > 0.5 ? 1 : 0);
+  if (mantissa == INTEGER_POWERS_OF_10[precision]) {
+    mantissa = INTEGER_POWERS_OF_10[precision - 1];
+    ++exponent;
+  }
+  char digits[MAX_FAST_PRECISION];
+  for (int i = precision - 1; i >= 0; --i) {
+    digits[i] = char('0' + mantissa % 10);
+    mantissa /= 10;
+  }
+  return writeDigits(buffer, digits, precision, exponent, precision);
+}
+
+/// Test if the text written from \e buffer to \e end reads back to \e value.
+template<class Real>
+inline bool readsBack(char * buffer, char * end, Real value)
+{
+  *end = '\0';
+  const char * text = buffer;
+  return Real(geom_parse_real(text)) == value;
+}
+
+/// Writes \e value with \e precision significant digits rounded by printf, in the style of %g with \e style digits.
+char * formatDigitsWithPrintf(char * buffer, double value, int precision, int style)
+{
+  char text[32];
+  sprintf(text, "%.*e", precision - 1, value);
+  // The decimal separator of printf depends on the locale.
+  char digits[17];
+  int nbdigits = 0;
+  const char * p = text;
+  for (; *p != 'e'; ++p) if (*p >= '0' && *p <= '9') digits[nbdigits++] = *p;
+  if (value < 0) *buffer++ = '-';
+  return writeDigits(buffer, digits, nbdigits, atoi(p + 1), style);
+}
+
+/** Conversion of finite values with the fewest digits from \e precision that read back.
+    printf rounds the digits exactly, the rounding of a longer text would round twice. */
+template<class Real>
+char * formatRealShortestWithPrintf(char * buffer, Real value, int precision, int maxprecision)
+{
+  for (; precision < maxprecision; ++precision) {
+    char * end = formatDigitsWithPrintf(buffer, value, precision, maxprecision);
+    if (readsBack(buffer, end, value)) return end;
+  }
+  return formatDigitsWithPrintf(buffer, value, maxprecision, maxprecision);
+}
+
+}
+
+/* ----------------------------------------------------------------------- */
+
+char * PGL(format_real)(char * buffer, double value, int precision)
+{
+  if (precision < 1) precision = 1;
+  if (value != value || value - value != 0 || precision > MAX_FAST_PRECISION)
+    return formatRealWithPrintf(buffer,value,precision);
+  if (value == 0) {
+    if (1 / value < 0) *buffer++ = '-';
+    *buffer++ = '0';
+    return buffer;
+  }
+  char * end = formatRealWithDouble(buffer,value,precision,true);
+  if (end == NULL) return formatRealWithPrintf(buffer,value,precision);
+  return end;
+}
+
+char * PGL(format_real_shortest)(char * buffer, double value)
+{
+  if (value != value || value - value != 0 || value == 0) return format_real(buffer,value,17);
+  // The digits of subnormal values are not all significant.
+  if (fabs(value) < DBL_MIN) return formatRealShortestWithPrintf(buffer,value,1,17);
+  // Any text that reads back is right, so values close to a tie need not be rejected.
+  // Its trailing zeros are removed, so it is also the shortest text of less digits that reads back.
+  char * end = formatRealWithDouble(buffer,value,MAX_FAST_PRECISION,false);
+  if (end == NULL) return formatRealShortestWithPrintf(buffer,value,MAX_FAST_PRECISION,17);
+  if (readsBack(buffer,end,value)) return end;
+  return formatRealShortestWithPrintf(buffer,value,MAX_FAST_PRECISION+1,17);
+}
+
+char * PGL(format_real_shortest)(char * buffer, float value)
+{
+  if (value != value || value - value != 0 || value == 0) return format_real(buffer,value,9);
+  if (fabs(value) < FLT_MIN) return formatRealShortestWithPrintf(buffer,value,1,9);
+  for (int precision = 6; precision <= 9; ++precision) {
+    char * end = formatRealWithDouble(buffer,value,precision,false);
+    if (end == NULL) return formatRealShortestWithPrintf(buffer,value,precision,9);
+    if (precision == 9 || readsBack(buffer,end,value)) return end;
+  }
+  return buffer;
+}
+
+char * PGL(format_integer)(char * buffer, uint32_t value)
+{
+  char digits[10];
+  int nbdigits = 0;
+  do {
+    digits[nbdigits++] = char('0' + value % 10);
+    value /= 10;
+  } while (value != 0);
+  while (nbdigits > 0) *buffer++ = digits[--nbdigits];
+  return buffer;
+}
+
+char * PGL(format_integer)(char * buffer, int32_t value)
+{
+  if (value >= 0) return format_integer(buffer,uint32_t(value));
+  *buffer++ = '-';
+  return format_integer(buffer,uint32_t(0) - uint32_t(value));
+}
+
+/* ----------------------------------------------------------------------- */
+
+TextBuffer::TextBuffer(int precision) :
+  __data(),
+  __size(0),
+  __precision(precision) {
+}
+
+void TextBuffer::grow(size_t length)
+{
+  size_t capacity = (__data.empty() ? 4096 : 2 * __data.size());
+  if (capacity < length) capacity = length;
+  __data.resize(capacity);
+}
+
+void TextBuffer::writeTo(std::ostream& stream)
+{
+  if (__size != 0) stream.write(&__data[0], __size);
+  __size = 0;
+}
+
+/* ----------------------------------------------------------------------- */
+
+const size_t TextWriter::PARALLEL_THRESHOLD = 16384;
+
+const size_t TextWriter::FLUSH_SIZE = 1 << 20;
+
+TextWriter::TextWriter(int precision) :
+  __buffers(),
+  __precision(precision) {
+}
+
+void TextWriter::prepare(std::ostream& stream, size_t nb)
+{
+  int precision = __precision;
+  if (precision < 0) precision = (stream.precision() > 0 ? int(stream.precision()) : 1);
+  if (__buffers.size() < nb) __buffers.resize(nb);
+  for (size_t i = 0; i < nb; ++i) {
+    __buffers[i].clear();
+    __buffers[i].setPrecision(precision);
+  }
+}
+
+/* ----------------------------------------------------------------------- */
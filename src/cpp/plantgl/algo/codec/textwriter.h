@@ -0,0 +1,247 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2006 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+
+
+/*! \file textwriter.h
+    \brief Fast conversion of numbers to text and bulk writing of arrays by the text printers.
+*/
+
+#ifndef __textwriter_h__
+#define __textwriter_h__
+
+/* ----------------------------------------------------------------------- */
+
+#include "codec_config.h"
+#include <plantgl/tool/util_types.h>
+#include <plantgl/tool/util_parallel.h>
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <iostream>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/** Writes \e value at \e buffer as a std::ostream with \e precision significant digits
+    and the default float field would, i.e. as printf("%.*g"), with '.' as decimal separator
+    whatever the locale. \e buffer must hold 32 chars. Returns the end of the text. */
+CODEC_API char * format_real(char * buffer, double value, int precision);
+
+/** Writes the shortest text of at most 17 significant digits that reads back to \e value.
+    \e buffer must hold 32 chars. Returns the end of the text. */
+CODEC_API char * format_real_shortest(char * buffer, double value);
+
+/// Writes the shortest text of at most 9 significant digits that reads back to the float \e value.
+CODEC_API char * format_real_shortest(char * buffer, float value);
+
+/// Writes \e value in decimal at \e buffer which must hold 12 chars. Returns the end of the text.
+CODEC_API char * format_integer(char * buffer, uint32_t value);
+
+/// Writes \e value in decimal at \e buffer which must hold 12 chars. Returns the end of the text.
+CODEC_API char * format_integer(char * buffer, int32_t value);
+
+/* ----------------------------------------------------------------------- */
+
+/**
+   \class TextBuffer
+   \brief A growable buffer of text. Clearing it keeps its memory for the next use.
+*/
+class CODEC_API TextBuffer {
+public:
+
+  /// Constructs an empty buffer writing reals with \e precision significant digits.
+  TextBuffer(int precision = 6);
+
+  /// Set the number of significant digits of the reals. 0 writes the shortest exact text.
+  inline void setPrecision(int precision) { __precision = precision; }
+  inline int getPrecision() const { return __precision; }
+
+  inline void clear() { __size = 0; }
+  inline size_t size() const { return __size; }
+  inline bool empty() const { return __size == 0; }
+  inline const char * data() const { return __size == 0 ? NULL : &__data[0]; }
+
+  inline void append(char c)
+  { reserve(1); __data[__size++] = c; }
+
+  inline void append(const char * text, size_t length)
+  { reserve(length); for (size_t i = 0; i < length; ++i) __data[__size + i] = text[i]; __size += length; }
+
+  inline void append(const std::string& text)
+  { append(text.data(), text.size()); }
+
+  inline void appendReal(double value)
+  { reserve(32); __size = (__precision > 0 ? format_real(&__data[__size],value,__precision)
+                                            : format_real_shortest(&__data[__size],value)) - &__data[0]; }
+
+  inline void appendReal(float value)
+  { reserve(32); __size = (__precision > 0 ? format_real(&__data[__size],value,__precision)
+                                            : format_real_shortest(&__data[__size],value)) - &__data[0]; }
+
+  inline void appendInteger(uint32_t value)
+  { reserve(12); __size = format_integer(&__data[__size],value) - &__data[0]; }
+
+  inline void appendInteger(int32_t value)
+  { reserve(12); __size = format_integer(&__data[__size],value) - &__data[0]; }
+
+  /// Writes the content of the buffer on \e stream and clears it.
+  void writeTo(std::ostream& stream);
+
+protected:
+  inline void reserve(size_t length)
+  { if (__size + length > __data.size()) grow(__size + length); }
+
+  void grow(size_t length);
+
+  std::vector<char> __data;
+  size_t __size;
+  int __precision;
+};
+
+/* ----------------------------------------------------------------------- */
+
+/**
+   \class TextWriter
+   \brief Writes arrays of values on a stream through large reusable buffers.
+
+   Each element is written by a formatter called as formatter(buffer, i) with a TextBuffer
+   and the index of the element. The elements are followed by a separator, except the last one.
+   Large arrays are formatted in parallel by chunks written afterwards in order on the stream,
+   so the formatter must be safe to call from several threads.
+*/
+class CODEC_API TextWriter {
+public:
+
+  /// Number of elements from which an array is formatted in parallel.
+  static const size_t PARALLEL_THRESHOLD;
+
+  /// Size of the text accumulated before writing on the stream.
+  static const size_t FLUSH_SIZE;
+
+  /** Constructs a writer. The reals are written with \e precision significant digits,
+      the precision of the stream if \e precision is negative, or as the shortest exact text if 0. */
+  TextWriter(int precision = -1);
+
+  inline void setPrecision(int precision) { __precision = precision; }
+  inline int getPrecision() const { return __precision; }
+
+  /** Writes the \e size elements of an array on \e stream. Elements are separated by \e separator,
+      or by \e lineSeparator after every \e perLine elements if \e perLine is not 0. */
+  template<class Formatter>
+  void writeArray(std::ostream& stream, size_t size, const Formatter& formatter,
+                  const std::string& separator, size_t perLine = 0,
+                  const std::string& lineSeparator = std::string());
+
+protected:
+
+  template<class Formatter>
+  struct ChunkFormatter {
+    ChunkFormatter(std::vector<TextBuffer>& buffers, const Formatter& formatter, size_t offset, size_t size,
+                   const std::string& separator, size_t perLine, const std::string& lineSeparator) :
+      buffers(buffers), formatter(formatter), offset(offset), size(size),
+      separator(separator), perLine(perLine), lineSeparator(lineSeparator) { }
+
+    void operator()(size_t begin, size_t end, size_t chunk)
+    {
+      TextBuffer& buffer = buffers[chunk];
+      for (size_t i = offset + begin; i < offset + end; ++i) {
+        formatter(buffer,i);
+        if (i + 1 != size) {
+          if (perLine != 0 && (i + 1) % perLine == 0) buffer.append(lineSeparator);
+          else buffer.append(separator);
+        }
+      }
+    }
+
+    std::vector<TextBuffer>& buffers;
+    const Formatter& formatter;
+    size_t offset;
+    size_t size;
+    const std::string& separator;
+    size_t perLine;
+    const std::string& lineSeparator;
+  };
+
+  /// Prepare \e nb buffers with the precision of the reals for \e stream.
+  void prepare(std::ostream& stream, size_t nb);
+
+  std::vector<TextBuffer> __buffers;
+  int __precision;
+};
+
+/* ----------------------------------------------------------------------- */
+
+template<class Formatter>
+void TextWriter::writeArray(std::ostream& stream, size_t size, const Formatter& formatter,
+                            const std::string& separator, size_t perLine,
+                            const std::string& lineSeparator)
+{
+  if (size < PARALLEL_THRESHOLD || TOOLS(parallel_thread_count)() == 1) {
+    prepare(stream,1);
+    ChunkFormatter<Formatter> chunks(__buffers,formatter,0,size,separator,perLine,lineSeparator);
+    TextBuffer& buffer = __buffers[0];
+    const size_t step = 1024;
+    for (size_t begin = 0; begin < size; begin += step) {
+      chunks(begin,std::min(begin + step, size),0);
+      if (buffer.size() >= FLUSH_SIZE) buffer.writeTo(stream);
+    }
+    buffer.writeTo(stream);
+  }
+  else {
+    // Blocks of the array are formatted in parallel to keep the memory used bounded.
+    const size_t grain = PARALLEL_THRESHOLD / 4;
+    const size_t blocksize = grain * 4 * TOOLS(parallel_thread_count)();
+    for (size_t offset = 0; offset < size; offset += blocksize) {
+      size_t blocklength = std::min(blocksize, size - offset);
+      size_t nbchunks = TOOLS(parallel_chunk_count)(blocklength,grain);
+      prepare(stream,nbchunks);
+      ChunkFormatter<Formatter> chunks(__buffers,formatter,offset,size,separator,perLine,lineSeparator);
+      TOOLS(parallel_for)(blocklength,chunks,grain);
+      for (size_t chunk = 0; chunk < nbchunks; ++chunk) __buffers[chunk].writeTo(stream);
+    }
+  }
+}
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+// __textwriter_h__
+#endif
@@ -287,12 +287,8 @@ using namespace std;
    GEOM_VRMLPRINT_INCREMENT_INDENT; \
    __geomStream << __indent  << "point ["  << endl; \
    GEOM_VRMLPRINT_INCREMENT_INDENT; \
-   for(Point3Array::iterator _i = val->begin();_i!=val->end();_i++){ \
-      __geomStream << __indent << _i->y() \
-         << " " << _i->z() \
-         << " " << _i->x(); \
-      if(_i!=val->end()-1)__geomStream << ',' << endl; \
-   } \
+   if(!val->empty())__geomStream << __indent; \
+   __writer.writeArray(__geomStream,val->size(),vrml_array_format(val),",\n" + __indent); \
    GEOM_VRMLPRINT_DECREMENT_INDENT; \
    __geomStream << endl << __indent << ']' << endl; \
    GEOM_VRMLPRINT_DECREMENT_INDENT; \
@@ -303,18 +299,8 @@ using namespace std;
    __geomStream << '[' << endl; \
    GEOM_VRMLPRINT_INCREMENT_INDENT; \
    __geomStream << __indent; \
-    uint_t _j =0 ; \
-    for(RealArray2::const_iterator _i = val->begin();_i!=val->end();_i++){ \
-      _j++; \
-      GEOM_VRMLPRINT_REAL(*_i); \
-      if(_i!=val->end()-1){ \
-        __geomStream << " , "; \
-        if(_j == val->getRowSize() ){ \
-            _j = 0; \
-            __geomStream << endl << __indent; \
-        } \
-      } \
-   } \
+   __writer.writeArray(__geomStream,val->size(),vrml_array_format(val)," , ", \
+                       val->getRowSize()," , \n" + __indent); \
    __geomStream  << ']' << endl; \
  };
 
@@ -323,12 +309,8 @@ using namespace std;
    GEOM_VRMLPRINT_INCREMENT_INDENT; \
    __geomStream << __indent  << "vector ["  << endl; \
    GEOM_VRMLPRINT_INCREMENT_INDENT; \
-   for(Point3Array::const_iterator _i = val->begin();_i!=val->end();_i++){ \
-      __geomStream << __indent << _i->y() \
-         << " " << _i->z() \
-         << " " << _i->x(); \
-      if(_i!=val->end()-1)__geomStream << ',' << endl; \
-   } \
+   if(!val->empty())__geomStream << __indent; \
+   __writer.writeArray(__geomStream,val->size(),vrml_array_format(val),",\n" + __indent); \
    GEOM_VRMLPRINT_DECREMENT_INDENT; \
    __geomStream << endl << __indent << ']' << endl; \
    GEOM_VRMLPRINT_DECREMENT_INDENT; \
@@ -338,51 +320,15 @@ using namespace std;
 #define GEOM_VRMLPRINT_INDEXARRAY(val){ \
    __geomStream << '[' << endl; \
    GEOM_VRMLPRINT_INCREMENT_INDENT; \
-   uint_t _sizej = val->size(); \
-   for(uint_t _j = 0 ; _j < _sizej; _j++){ \
-     __geomStream << __indent; \
-     uint_t _sizek = val->getAt(_j).size(); \
-     for(uint_t _k = 0 ; _k < _sizek ; _k++){ \
-       __geomStream << (val->getAt(_j).getAt(_k)) << " , "; \
-     } \
-     __geomStream << "-1" ; \
-     if(_j != _sizej-1)__geomStream << " , " << endl; \
-   } \
+   if(!val->empty())__geomStream << __indent; \
+   __writer.writeArray(__geomStream,val->size(),vrml_array_format(val)," , \n" + __indent); \
    GEOM_VRMLPRINT_DECREMENT_INDENT; \
    __geomStream << endl << __indent << ']'; \
  };
 
-#define GEOM_VRMLPRINT_INDEXARRAY3(val){ \
-   __geomStream << '[' << endl; \
-   GEOM_VRMLPRINT_INCREMENT_INDENT; \
-   uint_t _sizej = val->size(); \
-   for(uint_t _j = 0 ; _j < _sizej; _j++){ \
-     __geomStream << __indent; \
-     for(uint_t _k = 0 ; _k < 3 ; _k++){ \
-       __geomStream << (val->getAt(_j).getAt(_k)) << " , "; \
-     } \
-     __geomStream << "-1" ; \
-     if(_j != _sizej-1)__geomStream << " , "<< endl; \
-   } \
-   GEOM_VRMLPRINT_DECREMENT_INDENT; \
-   __geomStream << endl << __indent << ']'; \
- };
+#define GEOM_VRMLPRINT_INDEXARRAY3(val) GEOM_VRMLPRINT_INDEXARRAY(val)
 
-#define GEOM_VRMLPRINT_INDEXARRAY4(val){ \
-   __geomStream << '[' << endl; \
-   GEOM_VRMLPRINT_INCREMENT_INDENT; \
-   uint_t _sizej = val->size(); \
-   for(uint_t _j = 0 ; _j < _sizej; _j++){ \
-     __geomStream << __indent; \
-     for(uint_t _k = 0 ; _k < 4 ; _k++){ \
-       __geomStream << (val->getAt(_j).getAt(_k)) << " , "; \
-     } \
-     __geomStream << "-1" ; \
-     if(_j != _sizej-1)__geomStream << " , "<< endl; \
-   } \
-   GEOM_VRMLPRINT_DECREMENT_INDENT; \
-   __geomStream << endl << __indent << ']'; \
- };
+#define GEOM_VRMLPRINT_INDEXARRAY4(val) GEOM_VRMLPRINT_INDEXARRAY(val)
 
 #define GEOM_VRMLDISCRETIZE(obj){ \
   obj->apply(__discretizer); \
@@ -397,6 +343,42 @@ using namespace std;
 
 /* ----------------------------------------------------------------------- */
 
+/* Formatting of the elements of arrays with the same syntax as the macros above. */
+
+inline void vrml_format(TextBuffer& text, const real_t& val)
+{ text.appendReal(val); }
+
+inline void vrml_format(TextBuffer& text, const Vector3& val)
+{
+  text.appendReal(val.y()); text.append(' ');
+  text.appendReal(val.z()); text.append(' ');
+  text.appendReal(val.x());
+}
+
+template<class IndexType>
+inline void vrml_format(TextBuffer& text, const IndexType& val)
+{
+  uint_t _sizek = val.size();
+  for(uint_t _k = 0 ; _k < _sizek ; _k++){
+    text.appendInteger(val.getAt(_k));
+    text.append(" , ",3);
+  }
+  text.append("-1",2);
+}
+
+template<class ArrayPtr>
+struct VrmlArrayFormat {
+  VrmlArrayFormat(const ArrayPtr& array) : array(array) { }
+  inline void operator()(TextBuffer& text, size_t i) const { vrml_format(text,*(array->begin() + i)); }
+  const ArrayPtr& array;
+};
+
+template<class ArrayPtr>
+inline VrmlArrayFormat<ArrayPtr> vrml_array_format(const ArrayPtr& array)
+{ return VrmlArrayFormat<ArrayPtr>(array); }
+
+/* ----------------------------------------------------------------------- */
+
 
 VrmlPrinter::VrmlPrinter( ostream& vrmlStream, Discretizer& discretizer ) :
   Printer(vrmlStream,vrmlStream,vrmlStream),
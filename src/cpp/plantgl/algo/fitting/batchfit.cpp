@@ -0,0 +1,169 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+#include "batchfit.h"
+#include "fit.h"
+#include <plantgl/algo/base/tesselator.h>
+#include <plantgl/scenegraph/geometry/geometry.h>
+#include <plantgl/tool/util_parallel.h>
+#include <plantgl/tool/util_string.h>
+#include <plantgl/tool/errormsg.h>
+#include <algorithm>
+
+PGL_USING_NAMESPACE
+TOOLS_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/* Fits the groups of a range and tesselates the results. */
+struct GroupFitter {
+  const Point3Array& points;
+  const IndexArray& groups;
+  std::string classname;
+  std::vector<Point3ArrayPtr> meshPoints;
+  std::vector<Index3ArrayPtr> meshIndices;
+  std::vector<real_t> volumes;
+  std::vector<real_t> areas;
+
+  GroupFitter(const Point3Array& _points, const IndexArray& _groups, const std::string& _classname) :
+    points(_points), groups(_groups), classname(_classname),
+    meshPoints(_groups.size()), meshIndices(_groups.size()), 
+    volumes(_groups.size(), 0), areas(_groups.size(), 0) {}
+
+  void operator()(size_t begin, size_t end, size_t) {
+    Tesselator tesselator;
+    for (size_t g = begin; g < end; ++g) {
+      const Index& group = groups.getAt(g);
+      Point3ArrayPtr subset(new Point3Array(group.size()));
+      for (size_t i = 0; i < group.size(); ++i) subset->setAt(i, points.getAt(group.getAt(i)));
+
+      Fit fit(subset);
+      // qhull has a global state.
+      fit.setQhullUse(false);
+      GeometryPtr geometry = fit.use(classname);
+      if (!geometry || !geometry->apply(tesselator)) continue;
+      TriangleSetPtr mesh = tesselator.getTriangulation();
+      tesselator.clear();
+      if (!mesh || !mesh->getPointList() || !mesh->getIndexList()) continue;
+      meshPoints[g] = mesh->getPointList();
+      meshIndices[g] = mesh->getIndexList();
+
+      // Surface and volume by the divergence theorem.
+      real_t volume = 0, area = 0;
+      const Point3Array& vertices = *meshPoints[g];
+      for (Index3Array::const_iterator it = meshIndices[g]->begin(); it != meshIndices[g]->end(); ++it) {
+        const Vector3& a = vertices.getAt(it->getAt(0));
+        const Vector3& b = vertices.getAt(it->getAt(1));
+        const Vector3& c = vertices.getAt(it->getAt(2));
+        volume += dot(a, cross(b, c));
+        area += norm(cross(b - a, c - a));
+      }
+      volumes[g] = fabs(volume) / 6;
+      areas[g] = area / 2;
+    }
+  }
+};
+
+/* ----------------------------------------------------------------------- */
+
+BatchFit::BatchFit( const Point3ArrayPtr& points, const IndexArrayPtr& groups ) :
+  __points(points),
+  __groups(groups)
+{
+}
+
+BatchFit::~BatchFit( )
+{
+}
+
+bool BatchFit::fit( const std::string& classname )
+{
+  __meshPoints = Point3ArrayPtr(new Point3Array());
+  __meshIndices = Index3ArrayPtr(new Index3Array());
+  __pointOffsets = Index(1, 0);
+  __indexOffsets = Index(1, 0);
+  __volumes = RealArrayPtr(new RealArray());
+  __areas = RealArrayPtr(new RealArray());
+  if (!__points || !__groups) return false;
+
+  std::vector<std::string> volumes = Fit::getVolumeClassNames();
+  if (std::find(volumes.begin(), volumes.end(), toUpper(classname)) == volumes.end()) {
+    pglError("BatchFit: '%s' is not a volume.", classname.c_str());
+    return false;
+  }
+  for (IndexArray::const_iterator it = __groups->begin(); it != __groups->end(); ++it)
+    for (Index::const_iterator it2 = it->begin(); it2 != it->end(); ++it2)
+      if (*it2 >= __points->size()) {
+        pglError("BatchFit: invalid point index %u.", *it2);
+        return false;
+      }
+
+  GroupFitter fitter(*__points, *__groups, classname);
+  parallel_for(__groups->size(), fitter, 1);
+
+  size_t nbGroups = __groups->size();
+  __pointOffsets = Index(nbGroups + 1, 0);
+  __indexOffsets = Index(nbGroups + 1, 0);
+  for (size_t g = 0; g < nbGroups; ++g) {
+    __pointOffsets[g+1] = __pointOffsets[g] + (fitter.meshPoints[g] ? fitter.meshPoints[g]->size() : 0);
+    __indexOffsets[g+1] = __indexOffsets[g] + (fitter.meshIndices[g] ? fitter.meshIndices[g]->size() : 0);
+  }
+  __meshPoints->reserve(__pointOffsets[nbGroups]);
+  __meshIndices->reserve(__indexOffsets[nbGroups]);
+  for (size_t g = 0; g < nbGroups; ++g) {
+    if (!fitter.meshPoints[g]) continue;
+    __meshPoints->insert(__meshPoints->end(), fitter.meshPoints[g]->begin(), fitter.meshPoints[g]->end());
+    uint_t offset = __pointOffsets[g];
+    for (Index3Array::const_iterator it = fitter.meshIndices[g]->begin(); it != fitter.meshIndices[g]->end(); ++it)
+      __meshIndices->push_back(Index3(it->getAt(0) + offset, it->getAt(1) + offset, it->getAt(2) + offset));
+  }
+  __volumes = RealArrayPtr(new RealArray(fitter.volumes.begin(), fitter.volumes.end()));
+  __areas = RealArrayPtr(new RealArray(fitter.areas.begin(), fitter.areas.end()));
+  return true;
+}
+
+/* ----------------------------------------------------------------------- */
+
+TriangleSetPtr BatchFit::getMesh( uint_t i ) const
+{
+  if (i + 1 >= __pointOffsets.size() || __indexOffsets[i] == __indexOffsets[i+1]) return TriangleSetPtr();
+  uint_t offset = __pointOffsets[i];
+  Point3ArrayPtr points(new Point3Array(__meshPoints->begin() + offset, __meshPoints->begin() + __pointOffsets[i+1]));
+  Index3ArrayPtr indices(new Index3Array());
+  indices->reserve(__indexOffsets[i+1] - __indexOffsets[i]);
+  for (Index3Array::const_iterator it = __meshIndices->begin() + __indexOffsets[i]; it != __meshIndices->begin() + __indexOffsets[i+1]; ++it)
+    indices->push_back(Index3(it->getAt(0) - offset, it->getAt(1) - offset, it->getAt(2) - offset));
+  return TriangleSetPtr(new TriangleSet(points, indices));
+}
+
+/* ----------------------------------------------------------------------- */
@@ -0,0 +1,129 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+/*! \file batchfit.h
+    \brief Definition of the action BatchFit.
+*/
+
+#ifndef __batchfit_h__
+#define __batchfit_h__
+
+#include "../algo_config.h"
+#include <plantgl/scenegraph/container/pointarray.h>
+#include <plantgl/scenegraph/container/indexarray.h>
+#include <plantgl/scenegraph/geometry/triangleset.h>
+#include <plantgl/tool/util_array.h>
+#include <string>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/**
+   \class BatchFit
+   \brief Fits a volume on each group of a set of points, the groups being processed in parallel.
+
+   The fits are done by Fit with the builtin hull algorithms. The fitted volumes are tesselated
+   and their meshes are stored one after the other in a single list of points and of triangles.
+   The points and triangles of the group \e i are in [offset[i], offset[i+1][ of these lists.
+   Groups on which the fit failed have an empty mesh, and a null volume and area.
+*/
+class ALGO_API BatchFit
+{
+
+public:
+
+  /// Constructs a BatchFit of the groups \e groups of indices in \e points.
+  BatchFit( const Point3ArrayPtr& points, const IndexArrayPtr& groups );
+
+  /// Destructor.
+  ~BatchFit( );
+
+  /** Fits the volume \e classname, one of Fit::getVolumeClassNames(), on each group.
+      Returns false if \e classname is not a volume or if a group contains an invalid index. */
+  bool fit( const std::string& classname );
+
+  /// Returns the number of groups.
+  inline uint_t size( ) const { return __groups ? __groups->size() : 0; }
+
+  /// Returns the points of the meshes.
+  inline const Point3ArrayPtr& getPointList( ) const { return __meshPoints; }
+
+  /// Returns the triangles of the meshes. Their indices refer to the points of all the meshes.
+  inline const Index3ArrayPtr& getIndexList( ) const { return __meshIndices; }
+
+  /// Returns the position of the first point of each mesh, followed by the total number of points.
+  inline const Index& getPointOffsets( ) const { return __pointOffsets; }
+
+  /// Returns the position of the first triangle of each mesh, followed by the total number of triangles.
+  inline const Index& getIndexOffsets( ) const { return __indexOffsets; }
+
+  /// Returns the volumes of the meshes.
+  inline const TOOLS(RealArrayPtr)& getVolumes( ) const { return __volumes; }
+
+  /// Returns the surface areas of the meshes.
+  inline const TOOLS(RealArrayPtr)& getAreas( ) const { return __areas; }
+
+  /// Returns the mesh of the group \e i as a TriangleSet, or a null pointer if it is empty.
+  TriangleSetPtr getMesh( uint_t i ) const;
+
+protected:
+
+  Point3ArrayPtr __points;
+
+  IndexArrayPtr __groups;
+
+  Point3ArrayPtr __meshPoints;
+
+  Index3ArrayPtr __meshIndices;
+
+  Index __pointOffsets;
+
+  Index __indexOffsets;
+
+  TOOLS(RealArrayPtr) __volumes;
+
+  TOOLS(RealArrayPtr) __areas;
+
+};
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+// __batchfit_h__
+#endif
@@ -0,0 +1,309 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+#include "convexhull.h"
+#include <plantgl/math/util_math.h>
+#include <map>
+#include <limits>
+#include <algorithm>
+
+PGL_USING_NAMESPACE
+TOOLS_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+namespace {
+
+/* A face of the hull being built. Its edge i goes from vertex i to vertex i+1 and is shared with neighbor i. */
+struct HullFace {
+  uint32_t vertex[3];
+  uint32_t neighbor[3];
+  double normal[3];
+  double offset;
+  /// Points above the face that are not assigned to another face.
+  std::vector<uint32_t> outside;
+  bool alive;
+};
+
+class QuickHull {
+public:
+  QuickHull(const Point3Array& points) : __points(points.size()) { 
+    size_t i = 0;
+    for (Point3Array::const_iterator it = points.begin(); it != points.end(); ++it, ++i) {
+      __points[i][0] = it->x(); __points[i][1] = it->y(); __points[i][2] = it->z();
+    }
+  }
+
+  bool compute(Index3Array& triangles);
+
+protected:
+
+  inline double distance(const HullFace& face, uint32_t p) const {
+    const double * q = __points[p].v;
+    return face.normal[0] * q[0] + face.normal[1] * q[1] + face.normal[2] * q[2] - face.offset;
+  }
+
+  uint32_t addFace(uint32_t a, uint32_t b, uint32_t c);
+  bool initialSimplex(uint32_t simplex[4]);
+  void assign(uint32_t point, const std::vector<uint32_t>& faces);
+  void addPoint(uint32_t face);
+
+  struct Coords { double v[3]; double& operator[](int i) { return v[i]; } };
+  std::vector<Coords> __points;
+  std::vector<HullFace> __faces;
+  double __epsilon;
+};
+
+uint32_t QuickHull::addFace(uint32_t a, uint32_t b, uint32_t c)
+{
+  HullFace face;
+  face.vertex[0] = a; face.vertex[1] = b; face.vertex[2] = c;
+  face.neighbor[0] = face.neighbor[1] = face.neighbor[2] = UINT32_MAX;
+  const double * pa = __points[a].v, * pb = __points[b].v, * pc = __points[c].v;
+  double u[3] = { pb[0] - pa[0], pb[1] - pa[1], pb[2] - pa[2] };
+  double v[3] = { pc[0] - pa[0], pc[1] - pa[1], pc[2] - pa[2] };
+  face.normal[0] = u[1] * v[2] - u[2] * v[1];
+  face.normal[1] = u[2] * v[0] - u[0] * v[2];
+  face.normal[2] = u[0] * v[1] - u[1] * v[0];
+  double n = sqrt(face.normal[0] * face.normal[0] + face.normal[1] * face.normal[1] + face.normal[2] * face.normal[2]);
+  if (n > 0) { face.normal[0] /= n; face.normal[1] /= n; face.normal[2] /= n; }
+  face.offset = face.normal[0] * pa[0] + face.normal[1] * pa[1] + face.normal[2] * pa[2];
+  face.alive = true;
+  __faces.push_back(face);
+  return uint32_t(__faces.size() - 1);
+}
+
+/* Finds 4 points that are not coplanar, using the extreme points along the axes. */
+bool QuickHull::initialSimplex(uint32_t simplex[4])
+{
+  uint32_t extremes[6] = { 0, 0, 0, 0, 0, 0 };
+  for (uint32_t i = 1; i < __points.size(); ++i)
+    for (int j = 0; j < 3; ++j) {
+      if (__points[i][j] < __points[extremes[2*j]][j]) extremes[2*j] = i;
+      if (__points[i][j] > __points[extremes[2*j+1]][j]) extremes[2*j+1] = i;
+    }
+  double scale = 0;
+  for (int j = 0; j < 3; ++j) 
+    scale = std::max(scale, std::max(fabs(__points[extremes[2*j]][j]), fabs(__points[extremes[2*j+1]][j])));
+  __epsilon = 3 * scale * std::numeric_limits<double>::epsilon() * 16;
+
+  // The two most distant extreme points.
+  double best = -1;
+  for (int i = 0; i < 6; ++i)
+    for (int k = i + 1; k < 6; ++k) {
+      double d = 0;
+      for (int j = 0; j < 3; ++j) d += sq(__points[extremes[i]][j] - __points[extremes[k]][j]);
+      if (d > best) { best = d; simplex[0] = extremes[i]; simplex[1] = extremes[k]; }
+    }
+  if (sqrt(best) <= __epsilon) return false;
+
+  // The point the most distant from their line.
+  const double * a = __points[simplex[0]].v, * b = __points[simplex[1]].v;
+  double dir[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+  best = -1;
+  for (uint32_t i = 0; i < __points.size(); ++i) {
+    const double * p = __points[i].v;
+    double w[3] = { p[0] - a[0], p[1] - a[1], p[2] - a[2] };
+    double c[3] = { dir[1] * w[2] - dir[2] * w[1], dir[2] * w[0] - dir[0] * w[2], dir[0] * w[1] - dir[1] * w[0] };
+    double d = c[0] * c[0] + c[1] * c[1] + c[2] * c[2];
+    if (d > best) { best = d; simplex[2] = i; }
+  }
+  if (sqrt(best) / sqrt(dir[0] * dir[0] + dir[1] * dir[1] + dir[2] * dir[2]) <= __epsilon) return false;
+
+  // The point the most distant from their plane.
+  uint32_t face = addFace(simplex[0], simplex[1], simplex[2]);
+  best = 0;
+  for (uint32_t i = 0; i < __points.size(); ++i) {
+    double d = fabs(distance(__faces[face], i));
+    if (d > best) { best = d; simplex[3] = i; }
+  }
+  __faces.clear();
+  return best > __epsilon;
+}
+
+/* Assigns \e point to the first of \e faces it is above. Points above no face are inside the hull. */
+void QuickHull::assign(uint32_t point, const std::vector<uint32_t>& faces)
+{
+  for (std::vector<uint32_t>::const_iterator it = faces.begin(); it != faces.end(); ++it)
+    if (distance(__faces[*it], point) > __epsilon) {
+      __faces[*it].outside.push_back(point);
+      return;
+    }
+}
+
+/* Adds to the hull the farthest point above \e face. */
+void QuickHull::addPoint(uint32_t face)
+{
+  std::vector<uint32_t>& outside = __faces[face].outside;
+  uint32_t eye = outside[0];
+  double best = distance(__faces[face], eye);
+  for (std::vector<uint32_t>::const_iterator it = outside.begin() + 1; it != outside.end(); ++it) {
+    double d = distance(__faces[face], *it);
+    if (d > best) { best = d; eye = *it; }
+  }
+
+  // Faces seen from the eye, and the edges of the horizon between them and the others.
+  std::vector<uint32_t> visible(1, face), stack(1, face);
+  std::vector<std::pair<uint32_t,uint32_t> > horizon; // (visible face, edge)
+  __faces[face].alive = false;
+  while (!stack.empty()) {
+    uint32_t f = stack.back();
+    stack.pop_back();
+    for (int i = 0; i < 3; ++i) {
+      uint32_t n = __faces[f].neighbor[i];
+      if (!__faces[n].alive) continue;
+      if (distance(__faces[n], eye) > __epsilon) {
+        __faces[n].alive = false;
+        visible.push_back(n);
+        stack.push_back(n);
+      }
+      else horizon.push_back(std::pair<uint32_t,uint32_t>(f, i));
+    }
+  }
+
+  // A cone of new faces from the horizon to the eye.
+  std::vector<uint32_t> created;
+  created.reserve(horizon.size());
+  std::map<uint32_t,uint32_t> starting; // first vertex of the horizon edge -> new face
+  for (std::vector<std::pair<uint32_t,uint32_t> >::const_iterator it = horizon.begin(); it != horizon.end(); ++it) {
+    const HullFace& old = __faces[it->first];
+    uint32_t a = old.vertex[it->second], b = old.vertex[(it->second + 1) % 3];
+    uint32_t n = old.neighbor[it->second];
+    uint32_t f = addFace(a, b, eye);
+    __faces[f].neighbor[0] = n;
+    HullFace& other = __faces[n];
+    for (int i = 0; i < 3; ++i) if (other.neighbor[i] == it->first) other.neighbor[i] = f;
+    starting[a] = f;
+    created.push_back(f);
+  }
+  for (std::vector<uint32_t>::const_iterator it = created.begin(); it != created.end(); ++it) {
+    HullFace& f = __faces[*it];
+    // Edge (b, eye) is shared with the face starting at b, whose edge (eye, b) ends it.
+    uint32_t next = starting[f.vertex[1]];
+    f.neighbor[1] = next;
+    __faces[next].neighbor[2] = *it;
+  }
+
+  for (std::vector<uint32_t>::const_iterator it = visible.begin(); it != visible.end(); ++it) {
+    std::vector<uint32_t> points;
+    points.swap(__faces[*it].outside);
+    for (std::vector<uint32_t>::const_iterator p = points.begin(); p != points.end(); ++p)
+      if (*p != eye) assign(*p, created);
+  }
+}
+
+bool QuickHull::compute(Index3Array& triangles)
+{
+  triangles.clear();
+  if (__points.size() < 4) return false;
+  uint32_t simplex[4];
+  if (!initialSimplex(simplex)) return false;
+
+  // Faces of the tetrahedron oriented outward.
+  const double * a = __points[simplex[0]].v, * b = __points[simplex[1]].v, * c = __points[simplex[2]].v, * d = __points[simplex[3]].v;
+  double u[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] }, v[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+  double w[3] = { d[0] - a[0], d[1] - a[1], d[2] - a[2] };
+  double volume = w[0] * (u[1] * v[2] - u[2] * v[1]) + w[1] * (u[2] * v[0] - u[0] * v[2]) + w[2] * (u[0] * v[1] - u[1] * v[0]);
+  if (volume > 0) std::swap(simplex[1], simplex[2]);
+  uint32_t s0 = simplex[0], s1 = simplex[1], s2 = simplex[2], s3 = simplex[3];
+  addFace(s0, s1, s2); // 0
+  addFace(s0, s3, s1); // 1
+  addFace(s1, s3, s2); // 2
+  addFace(s2, s3, s0); // 3
+  uint32_t neighbors[4][3] = { { 1, 2, 3 }, { 3, 2, 0 }, { 1, 3, 0 }, { 2, 1, 0 } };
+  for (int i = 0; i < 4; ++i)
+    for (int j = 0; j < 3; ++j) __faces[i].neighbor[j] = neighbors[i][j];
+
+  std::vector<uint32_t> initial;
+  for (uint32_t i = 0; i < 4; ++i) initial.push_back(i);
+  for (uint32_t i = 0; i < __points.size(); ++i)
+    if (i != s0 && i != s1 && i != s2 && i != s3) assign(i, initial);
+
+  for (uint32_t f = 0; f < __faces.size(); ++f)
+    if (__faces[f].alive && !__faces[f].outside.empty()) addPoint(f);
+
+  for (std::vector<HullFace>::const_iterator it = __faces.begin(); it != __faces.end(); ++it)
+    if (it->alive) triangles.push_back(Index3(it->vertex[0], it->vertex[1], it->vertex[2]));
+  return true;
+}
+
+}
+
+/* ----------------------------------------------------------------------- */
+
+bool PGL(convex_hull_3d)( const Point3Array& points, Index3Array& triangles )
+{
+  QuickHull hull(points);
+  return hull.compute(triangles);
+}
+
+/* ----------------------------------------------------------------------- */
+
+static inline real_t turn( const Vector2& o, const Vector2& a, const Vector2& b )
+{ return (a.x() - o.x()) * (b.y() - o.y()) - (a.y() - o.y()) * (b.x() - o.x()); }
+
+static inline bool lexicographic_less( const Vector2& a, const Vector2& b )
+{ return a.x() < b.x() || (a.x() == b.x() && a.y() < b.y()); }
+
+Point2ArrayPtr PGL(convex_hull_2d)( const Point2Array& points )
+{
+  std::vector<Vector2> sorted(points.begin(), points.end());
+  std::sort(sorted.begin(), sorted.end(), lexicographic_less);
+  sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+  Point2ArrayPtr result(new Point2Array(0));
+  if (sorted.size() < 3) return result;
+
+  // Lower then upper chains, counter clockwise.
+  std::vector<Vector2> hull(2 * sorted.size());
+  size_t k = 0;
+  for (size_t i = 0; i < sorted.size(); ++i) {
+    while (k >= 2 && turn(hull[k-2], hull[k-1], sorted[i]) <= 0) --k;
+    hull[k++] = sorted[i];
+  }
+  for (size_t i = sorted.size() - 1, lower = k + 1; i > 0; --i) {
+    while (k >= lower && turn(hull[k-2], hull[k-1], sorted[i-1]) <= 0) --k;
+    hull[k++] = sorted[i-1];
+  }
+  // The first point is repeated at the end.
+  hull.resize(k - 1);
+  if (hull.size() < 3) return result;
+
+  size_t lowest = 0;
+  for (size_t i = 1; i < hull.size(); ++i)
+    if (hull[i].y() < hull[lowest].y()) lowest = i;
+  result->insert(result->end(), hull.begin() + lowest, hull.end());
+  result->insert(result->end(), hull.begin(), hull.begin() + lowest);
+  return result;
+}
+
+/* ----------------------------------------------------------------------- */
@@ -0,0 +1,69 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+/*! \file convexhull.h
+    \brief Convex hulls computed without global state.
+*/
+
+#ifndef __convexhull_h__
+#define __convexhull_h__
+
+#include "../algo_config.h"
+#include <plantgl/scenegraph/container/pointarray.h>
+#include <plantgl/scenegraph/container/indexarray.h>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/** Computes the convex hull of \e points with the quickhull algorithm.
+    \e triangles receives the faces of the hull as indices in \e points, counter clockwise
+    seen from outside. Returns false if the points are coplanar.
+    Unlike qhull, this function has no global state and can be called from several threads. */
+ALGO_API bool convex_hull_3d( const Point3Array& points, Index3Array& triangles );
+
+/** Computes the convex hull of \e points with the monotone chain algorithm.
+    The hull is returned counter clockwise, starting from its lowest point, without aligned points.
+    Returns an empty array if the points are aligned. */
+ALGO_API Point2ArrayPtr convex_hull_2d( const Point2Array& points );
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+// __convexhull_h__
+#endif
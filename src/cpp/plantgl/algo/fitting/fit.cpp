@@ -54,6 +54,7 @@
 #include <plantgl/math/util_matrixmath.h>
 #include "miniball.h"
 #include "eigenvector.h"
+#include "convexhull.h"
 
 // #define WITHOUT_QHULL
 
@@ -84,7 +85,12 @@ Fit::Fit():
     __pointstofit(),
     __radius(),
     __default_crossSection(),
-    __optimization(0)
+    __optimization(0),
+#ifdef WITHOUT_QHULL
+    __useQhull(false)
+#else
+    __useQhull(true)
+#endif
 {
 }
 
@@ -92,22 +98,32 @@ Fit::Fit(const Point3ArrayPtr& _pointstofit ):
     __pointstofit(_pointstofit),
     __radius(),
     __default_crossSection(),
-    __optimization(0)
+    __optimization(0),
+#ifdef WITHOUT_QHULL
+    __useQhull(false)
+#else
+    __useQhull(true)
+#endif
 {
 }
 
+bool Fit::setQhullUse(bool _use){
+#ifdef WITHOUT_QHULL
+    if(_use) return false;
+#endif
+    __useQhull = _use;
+    return true;
+}
+
 /* ----------------------------------------------------------------------- */
 
 
 GeometryPtr Fit::use(const string& classname){
     if(! __pointstofit )return GeometryPtr();
 	string cl = toUpper(classname);
-#ifndef WITHOUT_QHULL
     if(cl =="CONVEXHULL")
 	return convexHull();
-	else 
-#endif
-	if(cl =="EXTRUDEDHULL")
+	else if(cl =="EXTRUDEDHULL")
 	return extrudedHull();
     else if(cl =="ASYMMETRICHULL")
 	return asymmetricHull();
@@ -150,9 +166,7 @@ GeometryPtr Fit::use(const string& classname){
 
 vector<string> Fit::getVolumeClassNames(){
     vector<string> classname;
-#ifndef WITHOUT_QHULL
 	classname.push_back(string("CONVEXHULL"));
-#endif
 	classname.push_back(string("ASYMMETRICHULL"));
 	classname.push_back(string("EXTRUDEDHULL"));
 	classname.push_back(string("SPHERE"));
@@ -1336,7 +1350,7 @@ GeometryPtr Fit::extrudedHull(){
 	    _it++)
 	    horizontal_proj->setAt(k++,Vector2(_it->x(),_it->y()));
 	
-	Point2ArrayPtr horizontal_profile = convexPolyline(horizontal_proj);
+	Point2ArrayPtr horizontal_profile = (__useQhull ? convexPolyline(horizontal_proj) : convex_hull_2d(*horizontal_proj));
 
 	/// Vertical Profile.
 	Point2ArrayPtr vertical_proj(new Point2Array(numpoints));
@@ -1347,7 +1361,7 @@ GeometryPtr Fit::extrudedHull(){
 	    vertical_proj->setAt(k++,Vector2(_it2->x(),_it2->z()));
   
 
-	Point2ArrayPtr vertical_profile = convexPolyline(vertical_proj);
+	Point2ArrayPtr vertical_profile = (__useQhull ? convexPolyline(vertical_proj) : convex_hull_2d(*vertical_proj));
 
 
 	if(!vertical_profile||!horizontal_profile){
@@ -1580,12 +1594,50 @@ GeometryPtr Fit::extrudedHull(){
 
 /* ----------------------------------------------------------------------- */
 
+/* Convex hull computed with the builtin quickhull. */
+static GeometryPtr builtin_convex_hull(const Point3ArrayPtr& _points){
+  if(_points->size() > 3){
+    Index3Array hull;
+    if(!convex_hull_3d(*_points,hull)) return GeometryPtr();
+    // Only the vertices of the hull are kept.
+    vector<uint32_t> mem(_points->size(),UINT32_MAX);
+    Point3ArrayPtr resulting_points(new Point3Array());
+    Index3ArrayPtr resulting_topo(new Index3Array(hull.size()));
+    for(size_t i = 0; i < hull.size(); ++i){
+      Index3 topo = hull.getAt(i);
+      for(int j = 0; j < 3; ++j){
+        uint32_t& _id = mem[topo.getAt(j)];
+        if(_id == UINT32_MAX){
+          _id = resulting_points->size();
+          resulting_points->push_back(_points->getAt(topo.getAt(j)));
+        }
+        topo.getAt(j) = _id;
+      }
+      resulting_topo->setAt(i,topo);
+    }
+    pair<Point3Array::const_iterator,Point3Array::const_iterator> _skel = resulting_points->getZMinAndMax();
+    return GeometryPtr(new TriangleSet(resulting_points,resulting_topo,true,true,true,
+                                       PolylinePtr(new Polyline(*(_skel.first),*(_skel.second)))));
+  }
+  else if(_points->size()==3){
+      Index3ArrayPtr topo(new Index3Array());
+      topo->push_back(Index3(0,1,2));
+      return GeometryPtr(new TriangleSet(_points,topo, true,true, true,
+                                         PolylinePtr(new Polyline(_points->getAt(0),_points->getAt(1)))));
+  }
+  else if(_points->size()==2){
+      return GeometryPtr(new Polyline(_points));
+  }
+  else return GeometryPtr();
+}
+
 GeometryPtr
 Fit::convexHull(){
+  if(! __pointstofit )return GeometryPtr();
+  if(!__useQhull) return builtin_convex_hull(__pointstofit);
 #ifdef WITHOUT_QHULL
 	return GeometryPtr();
 #else
-  if(! __pointstofit )return GeometryPtr();
 
   /// Transform Point3Array in qhull format.
 
@@ -1724,7 +1776,8 @@ Fit::convexHull(){
 
 Point2ArrayPtr Fit::convexPolyline(const Point2ArrayPtr& _points){
 #ifdef WITHOUT_QHULL
-	return Point2ArrayPtr();
+	if(!_points) return Point2ArrayPtr();
+	return convex_hull_2d(*_points);
 #else
 
     /* dimension of points */
@@ -108,6 +108,15 @@ class ALGO_API Fit
       return __optimization;
     }
 
+    /** Set whether the hulls are computed with qhull. Otherwise builtin algorithms are used.
+        Unlike qhull, they have no global state and several Fit can run in parallel. */
+    virtual bool setQhullUse(bool _use);
+
+    /// get whether the hulls are computed with qhull.
+    virtual bool getQhullUse() const {
+      return __useQhull;
+    }
+
     /// Fit the points using classname.
     virtual GeometryPtr use(const std::string& classname);
 
@@ -430,6 +439,9 @@ protected:
 
   /// Level of optimisation
   uchar_t __optimization;
+
+  /// Whether the hulls are computed with qhull.
+  bool __useQhull;
 };
 
 
@@ -0,0 +1,510 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+#include "flatskeleton.h"
+#include <plantgl/math/util_math.h>
+#include <plantgl/tool/errormsg.h>
+#include <algorithm>
+
+PGL_USING_NAMESPACE
+TOOLS_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+namespace {
+
+inline double orient(const Vector2& a, const Vector2& b, const Vector2& c)
+{ return (b.x() - a.x()) * (c.y() - a.y()) - (b.y() - a.y()) * (c.x() - a.x()); }
+
+inline bool inTriangle(const Vector2& p, const Vector2& a, const Vector2& b, const Vector2& c)
+{ return orient(a,b,p) >= 0 && orient(b,c,p) >= 0 && orient(c,a,p) >= 0; }
+
+/* True if d is inside the circumcircle of the counter clockwise triangle abc.
+   Nearly cocircular points are considered outside so that edges are not flipped back and forth. */
+bool inCircle(const Vector2& a, const Vector2& b, const Vector2& c, const Vector2& d)
+{
+  double adx = a.x() - d.x(), ady = a.y() - d.y();
+  double bdx = b.x() - d.x(), bdy = b.y() - d.y();
+  double cdx = c.x() - d.x(), cdy = c.y() - d.y();
+  double alift = adx * adx + ady * ady;
+  double blift = bdx * bdx + bdy * bdy;
+  double clift = cdx * cdx + cdy * cdy;
+  double det = alift * (bdx * cdy - cdx * bdy) + blift * (cdx * ady - adx * cdy) + clift * (adx * bdy - bdx * ady);
+  double permanent = alift * (fabs(bdx * cdy) + fabs(cdx * bdy)) 
+                   + blift * (fabs(cdx * ady) + fabs(adx * cdy))
+                   + clift * (fabs(adx * bdy) + fabs(bdx * ady));
+  return det > 1e-10 * permanent;
+}
+
+/* Circumcenter if the triangle is acute, middle of its longest edge otherwise. Same as SkelTriangle::getPseudoCircumCenter. */
+Vector2 pseudoCircumCenter(const Vector2& a, const Vector2& b, const Vector2& c)
+{
+  Vector2 ab = b - a, ac = c - a, bc = c - b;
+  double lab = normSquared(ab), lac = normSquared(ac), lbc = normSquared(bc);
+  if (lab >= lac && lab >= lbc) { if (lac + lbc <= lab) return (a + b) / 2; }
+  else if (lac >= lbc) { if (lab + lbc <= lac) return (a + c) / 2; }
+  else if (lab + lac <= lbc) return (b + c) / 2;
+  double det = 2 * (ab.x() * ac.y() - ab.y() * ac.x());
+  return a + Vector2((ac.y() * lab - ab.y() * lac) / det, (ab.x() * lac - ac.x() * lab) / det);
+}
+
+inline void link(std::vector<int>& twins, uint_t h, int twin)
+{
+  twins[h] = twin;
+  if (twin >= 0) twins[twin] = h;
+}
+
+}
+
+/* ----------------------------------------------------------------------- */
+
+FlatSkeleton::FlatSkeleton(const Polyline2DPtr discretizedShape) :
+  m_reversed(false)
+{
+  if (is_null_ptr(discretizedShape) || is_null_ptr(discretizedShape->getPointList())) return;
+  const Point2ArrayPtr& points = discretizedShape->getPointList();
+  m_points.reserve(points->size());
+  for (Point2Array::const_iterator it = points->begin(); it != points->end(); ++it)
+    if (m_points.empty() || *it != m_points.back()) m_points.push_back(*it);
+  while (m_points.size() > 1 && m_points.back() == m_points.front()) m_points.pop_back();
+  if (m_points.size() < 3) {
+    pglError("FlatSkeleton : Give me more than 3 points to process.");
+    m_points.clear();
+    return;
+  }
+  double area = 0;
+  for (uint_t i = 0; i < m_points.size(); ++i)
+    area += cross(m_points[i], m_points[i + 1 == m_points.size() ? 0 : i + 1]);
+  m_reversed = area < 0;
+  triangulate();
+  makeDelaunay();
+}
+
+void FlatSkeleton::triangulate()
+{
+  uint_t n = m_points.size();
+  // Ring of the vertices left to clip, counter clockwise.
+  std::vector<uint_t> next(n), prev(n);
+  // Reflex and flat vertices are the only ones that can lie inside an ear.
+  std::vector<bool> reflex(n, false);
+  uint_t nbReflex = 0;
+  Vector2 lower = m_points[0], upper = m_points[0];
+  for (uint_t v = 0; v < n; ++v) {
+    next[v] = nextVertex(v);
+    prev[v] = prevVertex(v);
+    if (orient(m_points[prev[v]], m_points[v], m_points[next[v]]) <= 0) {
+      reflex[v] = true;
+      ++nbReflex;
+    }
+    lower = Min(lower, m_points[v]);
+    upper = Max(upper, m_points[v]);
+  }
+
+  // Reflex vertices are sorted in a regular grid so that only the ones close to an ear are tested.
+  // Vertices that become convex are not removed from the grid but are skipped.
+  uint_t gridSize = std::max<uint_t>(1, uint_t(sqrt(nbReflex / 2.)));
+  Vector2 cellSize = (upper - lower) / double(gridSize);
+  if (cellSize.x() <= 0) cellSize.x() = 1;
+  if (cellSize.y() <= 0) cellSize.y() = 1;
+  std::vector<uint_t> cellStart(gridSize * gridSize + 1, 0);
+  std::vector<uint_t> cellContent(nbReflex);
+  std::vector<uint_t> cellOf(n, 0);
+  for (uint_t v = 0; v < n; ++v) {
+    if (!reflex[v]) continue;
+    uint_t i = std::min<uint_t>(gridSize - 1, uint_t((m_points[v].x() - lower.x()) / cellSize.x()));
+    uint_t j = std::min<uint_t>(gridSize - 1, uint_t((m_points[v].y() - lower.y()) / cellSize.y()));
+    cellOf[v] = i + j * gridSize;
+    ++cellStart[cellOf[v] + 1];
+  }
+  for (uint_t c = 0; c < gridSize * gridSize; ++c) cellStart[c + 1] += cellStart[c];
+  std::vector<uint_t> cellFill(cellStart.begin(), cellStart.end() - 1);
+  for (uint_t v = 0; v < n; ++v) 
+    if (reflex[v]) cellContent[cellFill[cellOf[v]]++] = v;
+
+  // Half-edge of the clipped triangles on the other side of the ring edge from v to next[v], -1 on the border.
+  std::vector<int> outer(n, -1);
+
+  m_halfEdgeVertex.reserve(3 * (n - 2));
+  m_halfEdgeTwin.reserve(3 * (n - 2));
+
+  uint_t left = n;
+  uint_t v = m_reversed ? n - 1 : 0;
+  uint_t tries = 0;
+  while (left > 3) {
+    uint_t p = prev[v], nx = next[v];
+    bool ear = !reflex[v];
+    if (ear) {
+      const Vector2& a = m_points[p], & b = m_points[v], & c = m_points[nx];
+      Vector2 earLower = Min(Min(a, b), c) - lower, earUpper = Max(Max(a, b), c) - lower;
+      uint_t imin = std::min<uint_t>(gridSize - 1, uint_t(earLower.x() / cellSize.x()));
+      uint_t imax = std::min<uint_t>(gridSize - 1, uint_t(earUpper.x() / cellSize.x()));
+      uint_t jmin = std::min<uint_t>(gridSize - 1, uint_t(earLower.y() / cellSize.y()));
+      uint_t jmax = std::min<uint_t>(gridSize - 1, uint_t(earUpper.y() / cellSize.y()));
+      for (uint_t j = jmin; j <= jmax && ear; ++j)
+        for (uint_t i = imin; i <= imax && ear; ++i) {
+          uint_t cell = i + j * gridSize;
+          for (uint_t k = cellStart[cell]; k < cellStart[cell + 1]; ++k) {
+            uint_t r = cellContent[k];
+            if (!reflex[r] || r == p || r == nx) continue;
+            if (inTriangle(m_points[r], a, b, c)) { ear = false; break; }
+          }
+        }
+    }
+    // On degenerated polygons there may be no ear left. The current vertex is then clipped anyway.
+    if (!ear && tries < left) { v = nx; ++tries; continue; }
+
+    uint_t h = m_halfEdgeVertex.size();
+    m_halfEdgeVertex.push_back(p); m_halfEdgeVertex.push_back(v); m_halfEdgeVertex.push_back(nx);
+    m_halfEdgeTwin.push_back(-1); m_halfEdgeTwin.push_back(-1); m_halfEdgeTwin.push_back(-1);
+    link(m_halfEdgeTwin, h, outer[p]);
+    link(m_halfEdgeTwin, h + 1, outer[v]);
+    outer[p] = h + 2;
+    next[p] = nx;
+    prev[nx] = p;
+    --left;
+    tries = 0;
+
+    reflex[v] = false;
+    if (reflex[p] && orient(m_points[prev[p]], m_points[p], m_points[nx]) > 0) reflex[p] = false;
+    if (reflex[nx] && orient(m_points[p], m_points[nx], m_points[next[nx]]) > 0) reflex[nx] = false;
+    v = p;
+  }
+
+  uint_t p = prev[v], nx = next[v];
+  uint_t h = m_halfEdgeVertex.size();
+  m_halfEdgeVertex.push_back(p); m_halfEdgeVertex.push_back(v); m_halfEdgeVertex.push_back(nx);
+  m_halfEdgeTwin.push_back(-1); m_halfEdgeTwin.push_back(-1); m_halfEdgeTwin.push_back(-1);
+  link(m_halfEdgeTwin, h, outer[p]);
+  link(m_halfEdgeTwin, h + 1, outer[v]);
+  link(m_halfEdgeTwin, h + 2, outer[nx]);
+}
+
+void FlatSkeleton::makeDelaunay()
+{
+  std::vector<uint_t> toCheck;
+  for (uint_t h = 0; h < m_halfEdgeTwin.size(); ++h)
+    if (m_halfEdgeTwin[h] > int(h)) toCheck.push_back(h);
+
+  while (!toCheck.empty()) {
+    uint_t h = toCheck.back();
+    toCheck.pop_back();
+    if (m_halfEdgeTwin[h] < 0) continue;
+    uint_t g = m_halfEdgeTwin[h];
+    uint_t hn = nextHalfEdge(h), hp = prevHalfEdge(h);
+    uint_t gn = nextHalfEdge(g), gp = prevHalfEdge(g);
+
+    // Triangles (a,b,c) and (b,a,d) become (c,a,d) and (d,b,c).
+    uint_t a = m_halfEdgeVertex[h], b = m_halfEdgeVertex[hn];
+    uint_t c = m_halfEdgeVertex[hp], d = m_halfEdgeVertex[gp];
+    if (!inCircle(m_points[a], m_points[b], m_points[c], m_points[d])) continue;
+    if (orient(m_points[c], m_points[a], m_points[d]) <= 0 || 
+        orient(m_points[d], m_points[b], m_points[c]) <= 0) continue;
+
+    int thn = m_halfEdgeTwin[hn], thp = m_halfEdgeTwin[hp];
+    int tgn = m_halfEdgeTwin[gn], tgp = m_halfEdgeTwin[gp];
+    m_halfEdgeVertex[h] = c; m_halfEdgeVertex[hn] = a; m_halfEdgeVertex[hp] = d;
+    m_halfEdgeVertex[g] = d; m_halfEdgeVertex[gn] = b; m_halfEdgeVertex[gp] = c;
+    link(m_halfEdgeTwin, h, thp);
+    link(m_halfEdgeTwin, hn, tgn);
+    link(m_halfEdgeTwin, g, tgp);
+    link(m_halfEdgeTwin, gn, thn);
+    link(m_halfEdgeTwin, hp, gp);
+
+    if (m_halfEdgeTwin[h] >= 0) toCheck.push_back(h);
+    if (m_halfEdgeTwin[hn] >= 0) toCheck.push_back(hn);
+    if (m_halfEdgeTwin[g] >= 0) toCheck.push_back(g);
+    if (m_halfEdgeTwin[gn] >= 0) toCheck.push_back(gn);
+  }
+}
+
+/* ----------------------------------------------------------------------- */
+
+int FlatSkeleton::interiorEdgeCount(uint_t triangle) const
+{
+  return (m_halfEdgeTwin[3 * triangle] >= 0) + (m_halfEdgeTwin[3 * triangle + 1] >= 0) + (m_halfEdgeTwin[3 * triangle + 2] >= 0);
+}
+
+Vector2 FlatSkeleton::edgeMiddle(uint_t h) const
+{
+  return (m_points[m_halfEdgeVertex[h]] + m_points[m_halfEdgeVertex[nextHalfEdge(h)]]) / 2;
+}
+
+Vector2 FlatSkeleton::nodePoint(uint_t triangle) const
+{
+  const Vector2& a = m_points[m_halfEdgeVertex[3 * triangle]];
+  const Vector2& b = m_points[m_halfEdgeVertex[3 * triangle + 1]];
+  const Vector2& c = m_points[m_halfEdgeVertex[3 * triangle + 2]];
+  if (interiorEdgeCount(triangle) == 3) return pseudoCircumCenter(a, b, c);
+  return (a + b + c) / 3;
+}
+
+TriangleSetPtr FlatSkeleton::getTriangleSet() const
+{
+  if (!isValid()) return TriangleSetPtr();
+  Point3ArrayPtr points(new Point3Array(m_points.size()));
+  for (uint_t i = 0; i < m_points.size(); ++i)
+    points->setAt(i, Vector3(m_points[i].x(), m_points[i].y(), 0));
+  Index3ArrayPtr indices(new Index3Array(getTriangleCount()));
+  for (uint_t t = 0; t < getTriangleCount(); ++t)
+    indices->setAt(t, Index3(m_halfEdgeVertex[3 * t], m_halfEdgeVertex[3 * t + 1], m_halfEdgeVertex[3 * t + 2]));
+  return TriangleSetPtr(new TriangleSet(points, indices));
+}
+
+/* ----------------------------------------------------------------------- */
+
+std::list<Polyline2DPtr> FlatSkeleton::getChordalAxisTransform()
+{
+  m_branches.clear();
+  m_jonctions.clear();
+  uint_t nbTriangles = getTriangleCount();
+  if (nbTriangles == 0) {
+    pglError("FlatSkeleton, Chordal Axis Transform : Triangulation is empty");
+    return std::list<Polyline2DPtr>();
+  }
+
+  // Branches are followed from a junction if any, or from a termination.
+  std::vector<int> junctionOf(nbTriangles, -1);
+  int start = -1;
+  for (uint_t t = 0; t < nbTriangles; ++t) {
+    if (interiorEdgeCount(t) == 3) {
+      junctionOf[t] = m_jonctions.size();
+      Junction junction;
+      junction.m_point = nodePoint(t);
+      junction.m_branches[0] = junction.m_branches[1] = junction.m_branches[2] = -1;
+      junction.m_nbBranches = 0;
+      m_jonctions.push_back(junction);
+      if (start < 0) start = t;
+    }
+  }
+  for (uint_t t = 0; t < nbTriangles && start < 0; ++t)
+    if (interiorEdgeCount(t) == 1) start = t;
+  // A single triangle has no axis.
+  if (start < 0) return getBranches();
+
+  std::vector<bool> visited(m_halfEdgeVertex.size(), false);
+  std::vector<uint_t> toVisit(1, start);
+  while (!toVisit.empty()) {
+    uint_t t = toVisit.back();
+    toVisit.pop_back();
+    for (uint_t h = 3 * t; h < 3 * t + 3; ++h) {
+      if (m_halfEdgeTwin[h] < 0 || visited[h]) continue;
+      int end = traceBranch(t, h, visited, junctionOf);
+      if (end >= 0) toVisit.push_back(end);
+    }
+  }
+  return getBranches();
+}
+
+int FlatSkeleton::traceBranch(uint_t t, uint_t h, std::vector<bool>& visited, const std::vector<int>& junctionOf)
+{
+  Branch branch;
+  branch.m_removed = false;
+  branch.m_middleBump = -1;
+  for (int e = 0; e < 2; ++e) branch.m_chords[e][0] = branch.m_chords[e][1] = -1;
+
+  branch.m_points.push_back(nodePoint(t));
+  branch.m_junctions[0] = junctionOf[t];
+  if (junctionOf[t] >= 0) {
+    branch.m_ends[0] = JONCTION;
+    branch.m_chords[0][0] = m_halfEdgeVertex[h];
+    branch.m_chords[0][1] = m_halfEdgeVertex[nextHalfEdge(h)];
+  }
+  else {
+    branch.m_ends[0] = TERMINATION;
+    branch.m_middleBump = m_halfEdgeVertex[prevHalfEdge(h)];
+  }
+
+  // Sleeve triangles add the middle of their interior edges.
+  uint_t g;
+  for (;;) {
+    branch.m_points.push_back(edgeMiddle(h));
+    g = m_halfEdgeTwin[h];
+    visited[h] = visited[g] = true;
+    if (interiorEdgeCount(g / 3) != 2) break;
+    h = m_halfEdgeTwin[nextHalfEdge(g)] >= 0 ? nextHalfEdge(g) : prevHalfEdge(g);
+  }
+
+  uint_t u = g / 3;
+  branch.m_points.push_back(nodePoint(u));
+  branch.m_junctions[1] = junctionOf[u];
+  if (junctionOf[u] >= 0) {
+    branch.m_ends[1] = JONCTION;
+    branch.m_chords[1][0] = m_halfEdgeVertex[g];
+    branch.m_chords[1][1] = m_halfEdgeVertex[nextHalfEdge(g)];
+  }
+  else {
+    branch.m_ends[1] = TERMINATION;
+    branch.m_middleBump = m_halfEdgeVertex[prevHalfEdge(g)];
+  }
+
+  int id = m_branches.size();
+  for (int e = 0; e < 2; ++e) {
+    if (branch.m_junctions[e] < 0) continue;
+    Junction& junction = m_jonctions[branch.m_junctions[e]];
+    junction.m_branches[junction.m_nbBranches++] = id;
+  }
+  m_branches.push_back(branch);
+  return branch.m_ends[1] == JONCTION ? int(u) : -1;
+}
+
+void FlatSkeleton::filterLittleBranchesOnBranchAreaSize(const double areaMaxBranchesToRemove)
+{
+  for (int j = 0; j < int(m_jonctions.size()); ++j) {
+    Junction& junction = m_jonctions[j];
+    for (int i = junction.m_nbBranches - 1; i >= 0; --i) {
+      Branch& branch = m_branches[junction.m_branches[i]];
+      int e = (branch.m_junctions[0] == j ? 0 : 1);
+      if (branch.m_ends[1 - e] != TERMINATION) continue;
+      if (bumpArea(branch.m_chords[e][0], branch.m_chords[e][1]) >= areaMaxBranchesToRemove) continue;
+
+      branch.m_removed = true;
+      for (int k = i; k < junction.m_nbBranches - 1; ++k) junction.m_branches[k] = junction.m_branches[k + 1];
+      junction.m_branches[--junction.m_nbBranches] = -1;
+      if (junction.m_nbBranches == 0) continue;
+
+      // The bump of the removed branch is given to a remaining branch, preferably one ending with a termination.
+      int keep = -1;
+      for (int k = 0; k < junction.m_nbBranches && keep < 0; ++k) {
+        const Branch& other = m_branches[junction.m_branches[k]];
+        if (other.m_ends[other.m_junctions[0] == j ? 1 : 0] == TERMINATION) keep = k;
+      }
+      if (keep < 0 && junction.m_nbBranches == 1) {
+        // A branch between two junctions now ends here.
+        Branch& other = m_branches[junction.m_branches[0]];
+        int ek = (other.m_junctions[0] == j ? 0 : 1);
+        other.m_ends[ek] = TERMINATION;
+        other.m_junctions[ek] = -1;
+        other.m_chords[ek][0] = other.m_chords[ek][1] = -1;
+        other.m_middleBump = branch.m_middleBump;
+        junction.m_branches[0] = -1;
+        junction.m_nbBranches = 0;
+        break;
+      }
+      if (keep < 0) keep = 0;
+      Branch& other = m_branches[junction.m_branches[keep]];
+      int * chord = other.m_chords[other.m_junctions[0] == j ? 0 : 1];
+      const int * removed = branch.m_chords[e];
+      if (removed[1] == chord[0]) chord[0] = removed[0];
+      else if (chord[1] == removed[0]) chord[1] = removed[1];
+    }
+  }
+}
+
+std::list<Polyline2DPtr> FlatSkeleton::getBranches() const
+{
+  std::list<Polyline2DPtr> result;
+  for (std::vector<Branch>::const_iterator it = m_branches.begin(); it != m_branches.end(); ++it)
+    if (!it->m_removed)
+      result.push_back(Polyline2DPtr(new Polyline2D(Point2ArrayPtr(new Point2Array(it->m_points.begin(), it->m_points.end())))));
+  return result;
+}
+
+double FlatSkeleton::bumpArea(int begin, int end) const
+{
+  if (begin < 0 || end < 0) return 0;
+  // Once the bumps of all the other branches are merged into it, a bump goes round the whole polygon.
+  double area = cross(m_points[end], m_points[begin]);
+  uint_t v = begin;
+  do {
+    area += cross(m_points[v], m_points[nextVertex(v)]);
+    v = nextVertex(v);
+  } while (v != uint_t(end));
+  return area / 2;
+}
+
+Polyline2DPtr FlatSkeleton::bumpPolyline(int begin, int end) const
+{
+  Point2ArrayPtr points(new Point2Array());
+  if (begin >= 0 && end >= 0) {
+    uint_t v = begin;
+    do {
+      points->push_back(m_points[v]);
+      v = nextVertex(v);
+    } while (v != uint_t(end));
+    points->push_back(m_points[end]);
+  }
+  return Polyline2DPtr(new Polyline2D(points));
+}
+
+/* ----------------------------------------------------------------------- */
+
+std::list<Polyline2DPtr> 
+FlatSkeleton::getChordalAxisTransform(const Polyline2DPtr discretizedShape, const double areaMaxFilter)
+{
+  FlatSkeleton skel(discretizedShape);
+  skel.getChordalAxisTransform();
+  skel.filterLittleBranchesOnBranchAreaSize(areaMaxFilter);
+  return skel.getBranches();
+}
+
+std::list<Polyline2DPtr> 
+FlatSkeleton::getSkeletonInformation(const Polyline2DPtr discretizedShape, 
+                                     const double areaMaxFilter,
+                                     std::list<Vector2> * ends,
+                                     std::list<Vector2> * end_tgts,
+                                     std::list<Vector2> * bump_ends,
+                                     std::list<Vector2> * bump_tgts,
+                                     std::list<Polyline2DPtr> * bumps)
+{
+  FlatSkeleton skel(discretizedShape);
+  skel.getChordalAxisTransform();
+  skel.filterLittleBranchesOnBranchAreaSize(areaMaxFilter);
+  uint_t n = skel.m_points.size();
+  for (std::vector<Branch>::const_iterator it = skel.m_branches.begin(); it != skel.m_branches.end(); ++it) {
+    const std::vector<Vector2>& points = it->m_points;
+    if (it->m_removed || points.size() < 2) continue;
+    if (it->m_ends[0] == TERMINATION) {
+      ends->push_back(points.front());
+      end_tgts->push_back(points[1] - points[0]);
+    }
+    if (it->m_ends[1] == TERMINATION) {
+      ends->push_back(points.back());
+      end_tgts->push_back(points[points.size() - 2] - points.back());
+    }
+    if (it->m_ends[0] != TERMINATION && it->m_ends[1] != TERMINATION) continue;
+    // The bump is cut by the chord at the junction end of the branch.
+    const int * chord = it->m_chords[it->m_ends[0] == JONCTION ? 0 : 1];
+    if (chord[0] < 0 || it->m_middleBump < 0) continue;
+    int middle = it->m_middleBump;
+    bump_ends->push_back(skel.m_points[middle]);
+    bump_tgts->push_back(skel.m_points[middle == 0 ? n - 1 : middle - 1] - skel.m_points[middle + 1 == int(n) ? 0 : middle + 1]);
+    bumps->push_back(skel.bumpPolyline(chord[0], chord[1]));
+  }
+  return skel.getBranches();
+}
+
+TriangleSetPtr FlatSkeleton::getDelaunayConstrained2DTriangulation(const Polyline2DPtr discretizedShape)
+{
+  FlatSkeleton skel(discretizedShape);
+  return skel.getTriangleSet();
+}
@@ -0,0 +1,169 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+/*! \file flatskeleton.h
+    \brief Chordal axis transform of a polygon computed on a flat half-edge triangulation.
+*/
+
+#ifndef __flatskeleton_h__
+#define __flatskeleton_h__
+
+#include "../algo_config.h"
+#include <plantgl/scenegraph/geometry/polyline.h>
+#include <plantgl/scenegraph/geometry/triangleset.h>
+#include <list>
+#include <vector>
+
+/* ----------------------------------------------------------------------- */
+
+TOOLS_USING(Vector2)
+
+PGL_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/**
+   \class FlatSkeleton
+   \brief Chordal axis transform of a simple polygon (see Prasad 97), as computed by Skeleton.
+
+   The constrained Delaunay triangulation of the polygon is built by ear clipping followed
+   by edge flips, without CGAL. Triangles are stored as three consecutive half-edges in
+   flat arrays: half-edge \e h starts at vertex m_halfEdgeVertex[h] and its opposite is
+   m_halfEdgeTwin[h], or -1 on the border of the polygon. Branches and junctions refer to
+   each other by index.
+
+   The polygon must be simple. Successive identical points are ignored.
+*/
+class ALGO_API FlatSkeleton
+{
+ public:
+  enum EndType { UNDEFINED, TERMINATION, JONCTION };
+
+  /// A branch of the skeleton, between two junctions or terminations.
+  struct Branch {
+    std::vector<Vector2> m_points;
+    EndType m_ends[2];
+    /// Index of the junction at each end, -1 for a termination.
+    int m_junctions[2];
+    /// Border vertices of the chord cut by the branch at each junction end, -1 otherwise.
+    /// The part of the polygon on the side of the branch goes from the first to the second one.
+    int m_chords[2][2];
+    /// Tip vertex of the bump ending the branch, -1 if none.
+    int m_middleBump;
+    bool m_removed;
+  };
+
+  /// A junction of the skeleton, at the pseudo circumcenter of a triangle without border edge.
+  struct Junction {
+    Vector2 m_point;
+    int m_branches[3];
+    int m_nbBranches;
+  };
+
+  FlatSkeleton(const Polyline2DPtr discretizedShape);
+
+  bool isValid() const { return !m_halfEdgeVertex.empty(); }
+
+  uint_t getPointCount() const { return m_points.size(); }
+  uint_t getTriangleCount() const { return m_halfEdgeVertex.size() / 3; }
+
+  /// Returns the constrained Delaunay triangulation of the shape.
+  TriangleSetPtr getTriangleSet() const;
+
+  /// Computes the branches of the chordal axis transform.
+  std::list<Polyline2DPtr> getChordalAxisTransform();
+
+  /// Removes the branches ending with a bump whose area is lower than \e areaMaxBranchesToRemove.
+  void filterLittleBranchesOnBranchAreaSize(const double areaMaxBranchesToRemove);
+
+  /// Returns the branches that have not been filtered.
+  std::list<Polyline2DPtr> getBranches() const;
+
+  const std::vector<Branch>& getBranchList() const { return m_branches; }
+  const std::vector<Junction>& getJunctionList() const { return m_jonctions; }
+
+  /// Returns the area of the part of the polygon going from border vertex \e begin to \e end, the whole polygon if they are equal.
+  double bumpArea(int begin, int end) const;
+
+  /// Returns the border of the part of the polygon going from border vertex \e begin to \e end.
+  Polyline2DPtr bumpPolyline(int begin, int end) const;
+
+  static std::list<Polyline2DPtr> getChordalAxisTransform(const Polyline2DPtr discretizedShape,
+                                                          const double areaMaxFilter);
+
+  static std::list<Polyline2DPtr> getSkeletonInformation(const Polyline2DPtr discretizedShape,
+                                                         const double areaMaxFilter,
+                                                         std::list<Vector2> * ends,
+                                                         std::list<Vector2> * end_tgts,
+                                                         std::list<Vector2> * bump_ends,
+                                                         std::list<Vector2> * bump_tgts,
+                                                         std::list<Polyline2DPtr> * bumps);
+
+  static TriangleSetPtr getDelaunayConstrained2DTriangulation(const Polyline2DPtr discretizedShape);
+
+ protected:
+  void triangulate();
+  void makeDelaunay();
+  int traceBranch(uint_t triangle, uint_t halfedge, std::vector<bool>& visited, const std::vector<int>& junctionOf);
+
+  inline uint_t nextHalfEdge(uint_t h) const { return h % 3 == 2 ? h - 2 : h + 1; }
+  inline uint_t prevHalfEdge(uint_t h) const { return h % 3 == 0 ? h + 2 : h - 1; }
+  /// Next border vertex, counter clockwise.
+  inline uint_t nextVertex(uint_t v) const
+  { return m_reversed ? (v == 0 ? m_points.size() - 1 : v - 1) : (v + 1 == m_points.size() ? 0 : v + 1); }
+  inline uint_t prevVertex(uint_t v) const
+  { return m_reversed ? (v + 1 == m_points.size() ? 0 : v + 1) : (v == 0 ? m_points.size() - 1 : v - 1); }
+
+  int interiorEdgeCount(uint_t triangle) const;
+  Vector2 edgeMiddle(uint_t h) const;
+  Vector2 nodePoint(uint_t triangle) const;
+
+  std::vector<Vector2> m_points;
+  /// True if the points are given clockwise.
+  bool m_reversed;
+
+  std::vector<uint_t> m_halfEdgeVertex;
+  std::vector<int> m_halfEdgeTwin;
+
+  std::vector<Branch> m_branches;
+  std::vector<Junction> m_jonctions;
+};
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+// __flatskeleton_h__
+#endif
@@ -30,6 +30,7 @@
  */
 
 #include "skeleton.h"
+#include "flatskeleton.h"
 
 #include <math.h>
 
@@ -3232,6 +3233,10 @@ std::list<Polyline2DPtr>
 PGL::Skeleton::getChordalAxisTransform
 (const Polyline2DPtr discretizedShape, const double areaMaxFilter)
 {
+#ifndef WITH_CGAL
+  // Without CGAL, the triangulation is computed by FlatSkeleton.
+  return FlatSkeleton::getChordalAxisTransform(discretizedShape, areaMaxFilter);
+#endif
   filterAndHomogenize(*(discretizedShape->getPointList()));
   Skeleton skel(discretizedShape);
   skel.getChordalAxisTransform();
@@ -3248,6 +3253,10 @@ PGL::Skeleton::getSkeletonInformation(const Polyline2DPtr discretizedShape,
 				      std::list<Vector2> * bump_tgts,
 				      std::list<Polyline2DPtr> * bumps)
 {
+#ifndef WITH_CGAL
+  return FlatSkeleton::getSkeletonInformation(discretizedShape, areaMaxFilter, 
+					      ends, end_tgts, bump_ends, bump_tgts, bumps);
+#endif
   filterAndHomogenize(*(discretizedShape->getPointList()));
   Skeleton skel(discretizedShape);
   skel.getChordalAxisTransform();
@@ -3305,6 +3314,8 @@ TriangleSetPtr PGL::Skeleton::getDelaunayConstrained2DTriangulation(const Polyli
 //  filterAndHomogenize(*(discretizedShape->getPointList()));
 #ifdef WITH_CGAL
 //   removeLoopsInShape(discretizedShape);
+#else
+  return FlatSkeleton::getDelaunayConstrained2DTriangulation(discretizedShape);
 #endif
   Skeleton skel(discretizedShape);
   return skel.getTriangleSet();
@@ -66,12 +66,19 @@ Index3ArrayPtr
 PGL::delaunay_triangulation3D(const Point3ArrayPtr points)
 {
 #ifdef WITH_CGAL
-    Triangulation triangulation;
+    // inserted as a range, the points are sorted along a Hilbert curve before insertion
+    std::vector<std::pair<Point, uint32_t> > input;
+    input.reserve(points->size());
     uint32_t pointCount = 0;
     for (Point3Array::const_iterator it = points->begin(); it != points->end(); ++it)
-        triangulation.insert(toPoint(*it))->info() = pointCount++;
+        input.push_back(std::pair<Point, uint32_t>(toPoint(*it), pointCount++));
+
+    Triangulation triangulation;
+    triangulation.insert(input.begin(), input.end());
 
+    // the facets follow one default Index3 per point
     Index3ArrayPtr result(new Index3Array(points->size()));
+    result->reserve(points->size() + triangulation.number_of_finite_facets());
     for(Triangulation::Finite_facets_iterator it = triangulation.finite_facets_begin();
         it != triangulation.finite_facets_end(); ++it){
             const Cell_handle cell = it->first;
@@ -0,0 +1,310 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2012 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+
+/* ----------------------------------------------------------------------- */
+
+#include "capsuletree.h"
+#include <plantgl/tool/util_parallel.h>
+#include <algorithm>
+
+PGL_USING_NAMESPACE
+TOOLS_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+#define PARALLEL_GRAIN 1024
+#define MAX_DEPTH 64
+
+struct CentroidCompare {
+    const std::vector<Vector3> * centroids;
+    int axis;
+    bool operator()(uint32_t a, uint32_t b) const
+    { return (*centroids)[a][axis] < (*centroids)[b][axis]; }
+};
+
+struct CapsuleTreeBuilder {
+    std::vector<CapsuleTree::Node>& nodes;
+    std::vector<uint32_t>& order;
+    const std::vector<Vector3>& lowers;
+    const std::vector<Vector3>& uppers;
+    const std::vector<Vector3>& centroids;
+    const std::vector<real_t>& radii;
+    uint32_t leafsize;
+
+    CapsuleTreeBuilder(std::vector<CapsuleTree::Node>& _nodes, std::vector<uint32_t>& _order,
+                       const std::vector<Vector3>& _lowers, const std::vector<Vector3>& _uppers,
+                       const std::vector<Vector3>& _centroids, const std::vector<real_t>& _radii,
+                       uint32_t _leafsize):
+        nodes(_nodes), order(_order), lowers(_lowers), uppers(_uppers),
+        centroids(_centroids), radii(_radii), leafsize(_leafsize) { }
+
+    // Build the node of the capsules order[begin:end] and returns its id.
+    uint32_t build(uint32_t begin, uint32_t end) {
+        uint32_t nid = nodes.size();
+        nodes.push_back(CapsuleTree::Node());
+        CapsuleTree::Node node;
+        node.lower = lowers[order[begin]];
+        node.upper = uppers[order[begin]];
+        node.maxradius = radii[order[begin]];
+        Vector3 clower = centroids[order[begin]], cupper = clower;
+        for (uint32_t i = begin + 1; i < end; ++i){
+            uint32_t cid = order[i];
+            node.lower = Min(node.lower, lowers[cid]);
+            node.upper = Max(node.upper, uppers[cid]);
+            node.maxradius = std::max(node.maxradius, radii[cid]);
+            clower = Min(clower, centroids[cid]);
+            cupper = Max(cupper, centroids[cid]);
+        }
+        Vector3 extent = cupper - clower;
+        if (end - begin <= leafsize || norm(extent) == 0) {
+            node.first = begin;
+            node.count = end - begin;
+        }
+        else {
+            // median split along the largest extent of the centroids
+            CentroidCompare cmp;
+            cmp.centroids = &centroids;
+            cmp.axis = (extent.x() >= extent.y() ? (extent.x() >= extent.z() ? 0 : 2) : (extent.y() >= extent.z() ? 1 : 2));
+            uint32_t mid = begin + (end - begin) / 2;
+            std::nth_element(order.begin() + begin, order.begin() + mid, order.begin() + end, cmp);
+            build(begin, mid);
+            node.first = build(mid, end);
+            node.count = 0;
+        }
+        nodes[nid] = node;
+        return nid;
+    }
+};
+
+CapsuleTree::CapsuleTree(const Point3ArrayPtr& nodes,
+                         const Uint32Array1Ptr& parents,
+                         const RealArrayPtr& radii,
+                         uint32_t leafsize)
+{
+    uint32_t nbnodes = (nodes ? nodes->size() : 0);
+    __capsules.resize(nbnodes);
+    for (uint32_t i = 0; i < nbnodes; ++i){
+        Capsule& c = __capsules[i];
+        uint32_t parent = parents->getAt(i);
+        if (parent >= nbnodes) parent = i;
+        c.origin = nodes->getAt(i);
+        c.axis = nodes->getAt(parent) - c.origin;
+        real_t l2 = normSquared(c.axis);
+        c.invlength2 = (l2 > 0 ? 1 / l2 : 0);
+        c.radius = (radii ? radii->getAt(i) : 0);
+        c.deltaradius = (radii ? radii->getAt(parent) : 0) - c.radius;
+        c.node = i;
+    }
+    build(std::max<uint32_t>(leafsize,1));
+}
+
+CapsuleTree::~CapsuleTree() { }
+
+void CapsuleTree::build(uint32_t leafsize)
+{
+    __nodes.clear();
+    uint32_t nbcapsules = __capsules.size();
+    if (nbcapsules == 0) return;
+
+    std::vector<Vector3> lowers(nbcapsules), uppers(nbcapsules), centroids(nbcapsules);
+    std::vector<real_t> radii(nbcapsules);
+    std::vector<uint32_t> order(nbcapsules);
+    for (uint32_t i = 0; i < nbcapsules; ++i){
+        const Capsule& c = __capsules[i];
+        Vector3 end = c.origin + c.axis;
+        lowers[i] = Min(c.origin, end);
+        uppers[i] = Max(c.origin, end);
+        centroids[i] = c.origin + c.axis / 2;
+        radii[i] = std::max(c.radius, c.radius + c.deltaradius);
+        order[i] = i;
+    }
+
+    __nodes.reserve(2 * (nbcapsules / leafsize + 1));
+    CapsuleTreeBuilder builder(__nodes, order, lowers, uppers, centroids, radii, leafsize);
+    builder.build(0, nbcapsules);
+
+    // store the capsules in the order of the leaves
+    std::vector<Capsule> capsules(nbcapsules);
+    for (uint32_t i = 0; i < nbcapsules; ++i) capsules[i] = __capsules[order[i]];
+    __capsules.swap(capsules);
+}
+
+/* ----------------------------------------------------------------------- */
+
+static inline real_t box_distance(const CapsuleTree::Node& node, const Vector3& p, CapsuleTree::DistanceType dtype)
+{
+    real_t d2 = 0;
+    for (int i = 0; i < 3; ++i){
+        real_t delta = std::max(node.lower[i] - p[i], p[i] - node.upper[i]);
+        if (delta > 0) d2 += delta * delta;
+    }
+    real_t d = sqrt(d2);
+    switch(dtype){
+        case CapsuleTree::eAxisDistance: return d;
+        case CapsuleTree::eSignedDistance: return d - node.maxradius;
+        default: return std::max<real_t>(d - node.maxradius, 0);
+    }
+}
+
+static inline real_t capsule_distance(const CapsuleTree::Capsule& c, const Vector3& p, CapsuleTree::DistanceType dtype, real_t& u)
+{
+    Vector3 diff = p - c.origin;
+    u = dot(c.axis,diff) * c.invlength2;
+    if (u < 0) u = 0;
+    else if (u > 1) u = 1;
+    diff -= c.axis * u;
+    real_t d = norm(diff);
+    switch(dtype){
+        case CapsuleTree::eAxisDistance: return d;
+        case CapsuleTree::eSignedDistance: return d - c.radius - c.deltaradius * u;
+        default: return fabs(d - c.radius - c.deltaradius * u);
+    }
+}
+
+real_t CapsuleTree::closest_capsule(const Vector3& point,
+                                    uint32_t& capsule, real_t& u,
+                                    DistanceType dtype,
+                                    real_t maxdist) const
+{
+    real_t best = maxdist;
+    capsule = UINT32_MAX;
+    u = 0;
+    if (__nodes.empty()) return REAL_MAX;
+
+    uint32_t stack[MAX_DEPTH];
+    real_t bounds[MAX_DEPTH];
+    int top = 0;
+    stack[0] = 0;
+    bounds[0] = box_distance(__nodes[0],point,dtype);
+    ++top;
+
+    while (top > 0) {
+        --top;
+        if (bounds[top] >= best) continue;
+        uint32_t nid = stack[top];
+        const Node& node = __nodes[nid];
+        if (node.count > 0) {
+            for (uint32_t i = node.first; i < node.first + node.count; ++i){
+                real_t lu;
+                real_t d = capsule_distance(__capsules[i],point,dtype,lu);
+                if (d < best) {
+                    best = d;
+                    capsule = __capsules[i].node;
+                    u = lu;
+                }
+            }
+        }
+        else {
+            // push the farthest child first to process the closest one first
+            uint32_t c1 = nid + 1, c2 = node.first;
+            real_t b1 = box_distance(__nodes[c1],point,dtype);
+            real_t b2 = box_distance(__nodes[c2],point,dtype);
+            if (b1 < b2) { std::swap(c1,c2); std::swap(b1,b2); }
+            if (b1 < best) { stack[top] = c1; bounds[top] = b1; ++top; }
+            if (b2 < best) { stack[top] = c2; bounds[top] = b2; ++top; }
+        }
+    }
+    if (capsule == UINT32_MAX) return REAL_MAX;
+    return best;
+}
+
+/* ----------------------------------------------------------------------- */
+
+struct ClosestCapsuleFunctor {
+    const CapsuleTree * tree;
+    const Point3Array * points;
+    real_t * distances;
+    uint32_t * capsules;
+    real_t * us;
+    CapsuleTree::DistanceType dtype;
+    real_t maxdist;
+
+    void operator()(size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i){
+            uint32_t capsule;
+            real_t u;
+            real_t d = tree->closest_capsule(points->getAt(i),capsule,u,dtype,maxdist);
+            if (distances) distances[i] = d;
+            if (capsules) capsules[i] = capsule;
+            if (us) us[i] = u;
+        }
+    }
+};
+
+void CapsuleTree::closest_capsules(const Point3Array& points,
+                                   real_t * distances, uint32_t * capsules, real_t * us,
+                                   DistanceType dtype,
+                                   real_t maxdist) const
+{
+    ClosestCapsuleFunctor functor;
+    functor.tree = this;
+    functor.points = &points;
+    functor.distances = distances;
+    functor.capsules = capsules;
+    functor.us = us;
+    functor.dtype = dtype;
+    functor.maxdist = maxdist;
+    parallel_for(points.size(), functor, PARALLEL_GRAIN);
+}
+
+RealArrayPtr CapsuleTree::distances(const Point3ArrayPtr& points, DistanceType dtype) const
+{
+    RealArrayPtr result(new RealArray(points->size()));
+    if (!result->empty()) closest_capsules(*points, &*result->begin(), NULL, NULL, dtype);
+    return result;
+}
+
+Uint32Array1Ptr CapsuleTree::closest_capsules(const Point3ArrayPtr& points, DistanceType dtype) const
+{
+    Uint32Array1Ptr result(new Uint32Array1(points->size()));
+    if (!result->empty()) closest_capsules(*points, NULL, &*result->begin(), NULL, dtype);
+    return result;
+}
+
+Index CapsuleTree::points_at_distance(const Point3ArrayPtr& points, real_t distance,
+                                      DistanceType dtype, bool reversed) const
+{
+    Index result;
+    uint32_t nbpoints = points->size();
+    if (nbpoints == 0) return result;
+    std::vector<uint32_t> capsules(nbpoints);
+    // the search is limited to the given distance
+    closest_capsules(*points, NULL, &capsules[0], NULL, dtype, distance);
+    for (uint32_t pid = 0; pid < nbpoints; ++pid)
+        if ((capsules[pid] != UINT32_MAX) != reversed) result.push_back(pid);
+    return result;
+}
+
+/* ----------------------------------------------------------------------- */
@@ -0,0 +1,150 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2012 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+/*! \file capsuletree.h
+    \brief Definition of CapsuleTree, a bounding volume hierarchy over the segments of a skeleton.
+*/
+
+
+
+#ifndef __capsuletree_h__
+#define __capsuletree_h__
+
+/* ----------------------------------------------------------------------- */
+
+#include "../algo_config.h"
+#include <plantgl/scenegraph/container/pointarray.h>
+#include <plantgl/scenegraph/container/indexarray.h>
+#include <plantgl/tool/util_array.h>
+#include <vector>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/**
+    \class CapsuleTree
+    \brief A bounding volume hierarchy over the segments of a skeleton given by nodes and parents.
+
+    Each node \e i defines a capsule going from node \e i (u = 0) to its parent (u = 1),
+    with a radius linearly interpolated between the radii of both nodes. A root defines
+    a sphere. The distance of a point to a capsule is measured from its projection on
+    the axis of the capsule, as done by closestPointToSegment, and the radius at the
+    projection is removed when required. Closest capsule queries are exact.
+*/
+
+/* ----------------------------------------------------------------------- */
+
+class ALGO_API CapsuleTree : public TOOLS(RefCountObject)
+{
+public:
+
+    enum DistanceType {
+        eAxisDistance,     /// Distance to the axis of the capsule. Radii are ignored.
+        eSignedDistance,   /// Distance to the axis minus the radius. Negative inside the capsule.
+        eAbsoluteDistance  /// Absolute value of the signed distance.
+    };
+
+    /// Constructor. If \e radii is null, all capsules have a null radius.
+    CapsuleTree(const Point3ArrayPtr& nodes,
+                const TOOLS(Uint32Array1Ptr)& parents,
+                const TOOLS(RealArrayPtr)& radii = TOOLS(RealArrayPtr)(),
+                uint32_t leafsize = 4);
+
+    virtual ~CapsuleTree();
+
+    /// Returns the number of capsules, which is the number of nodes of the skeleton. Capsule ids are node ids.
+    inline size_t size() const { return __capsules.size(); }
+
+    /** Find the closest capsule of \e point according to \e dtype and returns its distance.
+        \e capsule and \e u receive the capsule id and the position of the projection along it.
+        Only capsules closer than \e maxdist are considered. If none, REAL_MAX is returned
+        and \e capsule is set to UINT32_MAX. */
+    real_t closest_capsule(const TOOLS(Vector3)& point,
+                           uint32_t& capsule, real_t& u,
+                           DistanceType dtype = eSignedDistance,
+                           real_t maxdist = REAL_MAX) const;
+
+    /** Find in parallel the closest capsule of all \e points.
+        The arrays \e distances, \e capsules and \e us should have the size of \e points or be null. */
+    void closest_capsules(const Point3Array& points,
+                          real_t * distances, uint32_t * capsules, real_t * us,
+                          DistanceType dtype = eSignedDistance,
+                          real_t maxdist = REAL_MAX) const;
+
+    /// Returns the distance of all \e points to their closest capsule.
+    TOOLS(RealArrayPtr) distances(const Point3ArrayPtr& points, DistanceType dtype = eSignedDistance) const;
+
+    /// Returns the id of the closest capsule of all \e points.
+    TOOLS(Uint32Array1Ptr) closest_capsules(const Point3ArrayPtr& points, DistanceType dtype = eSignedDistance) const;
+
+    /** Returns the indices of the points whose distance to the closest capsule is below \e distance.
+        If \e reversed, the indices of the other points are returned. */
+    Index points_at_distance(const Point3ArrayPtr& points, real_t distance,
+                             DistanceType dtype = eAxisDistance, bool reversed = false) const;
+
+    struct Capsule {
+        TOOLS(Vector3) origin;
+        TOOLS(Vector3) axis;
+        real_t invlength2;
+        real_t radius;
+        real_t deltaradius;
+        uint32_t node;
+    };
+
+    struct Node {
+        TOOLS(Vector3) lower;
+        TOOLS(Vector3) upper;
+        real_t maxradius;
+        // for internal nodes, first is the id of the second child, the first one follows the node.
+        uint32_t first;
+        uint32_t count;
+    };
+
+protected:
+    void build(uint32_t leafsize);
+
+    std::vector<Capsule> __capsules;
+    std::vector<Node> __nodes;
+};
+
+typedef RCPtr<CapsuleTree> CapsuleTreePtr;
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+#endif
@@ -0,0 +1,582 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2012 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+/* ----------------------------------------------------------------------- */
+
+#include "scenevoxelizer.h"
+#include "../base/scenebaker.h"
+#include <plantgl/tool/util_parallel.h>
+#include <plantgl/tool/errormsg.h>
+#include <plantgl/math/util_math.h>
+#include <algorithm>
+#include <cmath>
+
+PGL_USING_NAMESPACE
+TOOLS_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+#define PARALLEL_GRAIN 4096
+// Budget of the dense buffers of a slab in bytes.
+#define MAX_SLAB_BYTES (1 << 26)
+// A triangle clipped by the 6 planes of a voxel has at most 9 vertices.
+#define MAX_POLYGON_SIZE 12
+
+struct ClipPolygon {
+    real_t p[MAX_POLYGON_SIZE][3];
+    int n;
+};
+
+// Split the convex polygon \e poly by the plane coord[axis] = c.
+static inline void split_polygon(const ClipPolygon& poly, int axis, real_t c, ClipPolygon& below, ClipPolygon& above)
+{
+    below.n = 0; above.n = 0;
+    for (int i = 0; i < poly.n; ++i) {
+        const real_t * a = poly.p[i];
+        const real_t * b = poly.p[i+1 < poly.n ? i+1 : 0];
+        real_t da = a[axis] - c;
+        real_t db = b[axis] - c;
+        if (da <= 0) { real_t * q = below.p[below.n++]; q[0] = a[0]; q[1] = a[1]; q[2] = a[2]; }
+        if (da >= 0) { real_t * q = above.p[above.n++]; q[0] = a[0]; q[1] = a[1]; q[2] = a[2]; }
+        if ((da < 0 && db > 0) || (da > 0 && db < 0)) {
+            real_t t = da / (da - db);
+            real_t x[3] = { a[0] + t * (b[0] - a[0]), a[1] + t * (b[1] - a[1]), a[2] + t * (b[2] - a[2]) };
+            x[axis] = c;
+            real_t * q = below.p[below.n++]; q[0] = x[0]; q[1] = x[1]; q[2] = x[2];
+            q = above.p[above.n++]; q[0] = x[0]; q[1] = x[1]; q[2] = x[2];
+        }
+    }
+}
+
+static inline real_t polygon_area(const ClipPolygon& poly)
+{
+    if (poly.n < 3) return 0;
+    const real_t * o = poly.p[0];
+    real_t nx = 0, ny = 0, nz = 0;
+    for (int i = 1; i + 1 < poly.n; ++i) {
+        real_t u0 = poly.p[i][0] - o[0], u1 = poly.p[i][1] - o[1], u2 = poly.p[i][2] - o[2];
+        real_t v0 = poly.p[i+1][0] - o[0], v1 = poly.p[i+1][1] - o[1], v2 = poly.p[i+1][2] - o[2];
+        nx += u1 * v2 - u2 * v1;
+        ny += u2 * v0 - u0 * v2;
+        nz += u0 * v1 - u1 * v0;
+    }
+    return 0.5 * sqrt(nx * nx + ny * ny + nz * nz);
+}
+
+/* ----------------------------------------------------------------------- */
+
+// Common description of the grid and of the baked scene.
+struct VoxelGridInfo {
+    const CompactMeshBuffer * buffer;
+    real_t origin[3];
+    real_t size[3];
+    int32_t dims[3];
+    uint32_t layers;
+    size_t nbSlabs;
+
+    inline void triangle(size_t t, real_t p[3][3]) const {
+        const uint32_t * ind = &buffer->indices[3 * t];
+        for (int i = 0; i < 3; ++i) {
+            const float * v = &buffer->vertices[3 * ind[i]];
+            for (int j = 0; j < 3; ++j) p[i][j] = real_t(v[j]) - origin[j];
+        }
+    }
+
+    // Range of cells [k0, k1] of the coordinates [vmin, vmax] along axis.
+    // Returns false if it is outside of the grid.
+    inline bool cell_range(int axis, real_t vmin, real_t vmax, int32_t& k0, int32_t& k1) const {
+        real_t c0 = floor(vmin / size[axis]);
+        real_t c1 = floor(vmax / size[axis]);
+        if (c1 < 0 || c0 >= dims[axis]) return false;
+        k0 = (c0 < 0 ? 0 : int32_t(c0));
+        k1 = (c1 >= dims[axis] ? dims[axis] - 1 : int32_t(c1));
+        return true;
+    }
+
+    // Range of slabs [s0, s1] crossed by the triangle t.
+    inline bool slab_range(size_t t, size_t& s0, size_t& s1) const {
+        real_t p[3][3];
+        triangle(t,p);
+        int32_t k0, k1;
+        for (int axis = 0; axis < 3; ++axis) {
+            real_t vmin = std::min(p[0][axis],std::min(p[1][axis],p[2][axis]));
+            real_t vmax = std::max(p[0][axis],std::max(p[1][axis],p[2][axis]));
+            if (!cell_range(axis, vmin, vmax, k0, k1)) return false;
+        }
+        s0 = k0 / layers;
+        s1 = k1 / layers;
+        return true;
+    }
+};
+
+/* ----------------------------------------------------------------------- */
+
+// Bounds of the vertices of the buffer, computed by ranges.
+struct VertexBounds {
+    const float * vertices;
+    std::vector<real_t> lowers;
+    std::vector<real_t> uppers;
+
+    VertexBounds(const float * _vertices, size_t nbchunks) :
+        vertices(_vertices), lowers(3 * nbchunks, REAL_MAX), uppers(3 * nbchunks, -REAL_MAX) { }
+
+    void operator()(size_t begin, size_t end, size_t chunk) {
+        real_t * lower = &lowers[3 * chunk];
+        real_t * upper = &uppers[3 * chunk];
+        for (size_t i = begin; i < end; ++i)
+            for (int j = 0; j < 3; ++j) {
+                real_t v = vertices[3 * i + j];
+                if (v < lower[j]) lower[j] = v;
+                if (v > upper[j]) upper[j] = v;
+            }
+    }
+};
+
+// Distribution of the triangles in the slabs they cross.
+// A first pass counts the triangles of each slab by range, the second one fills the slabs
+// so that each slab lists its triangles in increasing order.
+struct SlabBinning {
+    const VoxelGridInfo * grid;
+    size_t * counts;
+    uint32_t * triangles;
+
+    void operator()(size_t begin, size_t end, size_t chunk) {
+        size_t * cursor = counts + chunk * grid->nbSlabs;
+        size_t s0, s1;
+        for (size_t t = begin; t < end; ++t) {
+            if (!grid->slab_range(t, s0, s1)) continue;
+            for (size_t s = s0; s <= s1; ++s) {
+                if (triangles) triangles[cursor[s]] = uint32_t(t);
+                ++cursor[s];
+            }
+        }
+    }
+};
+
+/* ----------------------------------------------------------------------- */
+
+struct VoxelShapeEntry {
+    uint32_t shape;
+    real_t area;
+    uint32_t next;
+    bool operator<(const VoxelShapeEntry& other) const { return shape < other.shape; }
+};
+
+// Non empty voxels of a range of slabs.
+struct SlabVoxels {
+    std::vector<uint32_t> voxels;
+    std::vector<real_t> areas;
+    std::vector<real_t> histograms;
+    std::vector<uint32_t> shapeCounts;
+    std::vector<uint32_t> shapeIds;
+    std::vector<real_t> shapeAreas;
+};
+
+// Accumulation of the triangles of a range of slabs in a dense buffer of the size of a slab.
+struct SlabVoxelizer {
+    const VoxelGridInfo * grid;
+    const size_t * slabOffsets;
+    const uint32_t * slabTriangles;
+    uint32_t nbInclinationClasses;
+    uint32_t nbAzimuthClasses;
+    SlabVoxels * results;
+
+    // dense buffers of the current slab
+    std::vector<real_t> * areas;
+    std::vector<real_t> * histograms;
+    std::vector<uint32_t> * heads;
+    std::vector<VoxelShapeEntry> * entries;
+    std::vector<uint32_t> * touched;
+
+    uint32_t orientation_class(const real_t p[3][3], real_t& area) const {
+        real_t u[3] = { p[1][0] - p[0][0], p[1][1] - p[0][1], p[1][2] - p[0][2] };
+        real_t v[3] = { p[2][0] - p[0][0], p[2][1] - p[0][1], p[2][2] - p[0][2] };
+        real_t n[3] = { u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0] };
+        real_t norm = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        area = 0.5 * norm;
+        if (norm <= 0) return 0;
+        // Both faces have the same orientation.
+        if (n[2] < 0) { n[0] = -n[0]; n[1] = -n[1]; n[2] = -n[2]; }
+        real_t inclination = acos(std::min<real_t>(n[2] / norm, 1));
+        uint32_t i = uint32_t(inclination / GEOM_HALF_PI * nbInclinationClasses);
+        if (i >= nbInclinationClasses) i = nbInclinationClasses - 1;
+        uint32_t j = 0;
+        if (nbAzimuthClasses > 1) {
+            real_t azimuth = atan2(n[1], n[0]);
+            if (azimuth < 0) azimuth += GEOM_TWO_PI;
+            j = uint32_t(azimuth / GEOM_TWO_PI * nbAzimuthClasses);
+            if (j >= nbAzimuthClasses) j = nbAzimuthClasses - 1;
+        }
+        return i * nbAzimuthClasses + j;
+    }
+
+    inline void accumulate(uint32_t voxel, real_t area, uint32_t oclass, uint32_t shape) {
+        (*areas)[voxel] += area;
+        (*histograms)[size_t(voxel) * nbInclinationClasses * nbAzimuthClasses + oclass] += area;
+        uint32_t& head = (*heads)[voxel];
+        if (head == UINT32_MAX) touched->push_back(voxel);
+        // Triangles of a shape are consecutive, so the shape is mostly the first of the list.
+        for (uint32_t e = head; e != UINT32_MAX; e = (*entries)[e].next)
+            if ((*entries)[e].shape == shape) { (*entries)[e].area += area; return; }
+        VoxelShapeEntry entry;
+        entry.shape = shape; entry.area = area; entry.next = head;
+        head = uint32_t(entries->size());
+        entries->push_back(entry);
+    }
+
+    // Clip the part of a polygon in the cell \e voxel along \e axis along the next axis.
+    inline void clip_cell(const ClipPolygon& poly, int axis, uint32_t voxel, uint32_t stride[3],
+                          uint32_t oclass, uint32_t shape) {
+        if (axis == 0) {
+            real_t area = polygon_area(poly);
+            if (area > 0) accumulate(voxel, area, oclass, shape);
+        }
+        else clip(poly, axis - 1, 0, grid->dims[axis - 1] - 1, voxel, stride, oclass, shape);
+    }
+
+    // Clip poly successively along the cells of z, y and x.
+    void clip(const ClipPolygon& poly, int axis, int32_t lo, int32_t hi, uint32_t voxel, uint32_t stride[3],
+              uint32_t oclass, uint32_t shape) {
+        real_t vmin = poly.p[0][axis], vmax = vmin;
+        for (int i = 1; i < poly.n; ++i) {
+            if (poly.p[i][axis] < vmin) vmin = poly.p[i][axis];
+            else if (poly.p[i][axis] > vmax) vmax = poly.p[i][axis];
+        }
+        int32_t k0, k1;
+        if (!grid->cell_range(axis, vmin, vmax, k0, k1)) return;
+        if (k0 < lo) k0 = lo;
+        if (k1 > hi) k1 = hi;
+        if (k0 > k1) return;
+        real_t size = grid->size[axis];
+        // Most triangles are smaller than the voxels and lie in one cell.
+        if (k0 == k1 && k0 * size <= vmin && (k1 + 1) * size >= vmax) {
+            clip_cell(poly, axis, voxel + (k0 - lo) * stride[axis], stride, oclass, shape);
+            return;
+        }
+        ClipPolygon rest, piece, tmp;
+        // Remove the part below the first cell.
+        if (k0 * size > vmin) { split_polygon(poly, axis, k0 * size, tmp, rest); }
+        else rest = poly;
+        for (int32_t k = k0; k <= k1 && rest.n >= 3; ++k) {
+            const ClipPolygon * current = &rest;
+            if ((k + 1) * size < vmax) {
+                split_polygon(rest, axis, (k + 1) * size, piece, tmp);
+                current = &piece;
+            }
+            if (current->n >= 3) clip_cell(*current, axis, voxel + (k - lo) * stride[axis], stride, oclass, shape);
+            if (current == &rest) break;
+            rest = tmp;
+        }
+    }
+
+    void operator()(size_t begin, size_t end, size_t chunk) {
+        const int32_t * dims = grid->dims;
+        uint32_t nbclasses = nbInclinationClasses * nbAzimuthClasses;
+        size_t slabsize = size_t(dims[0]) * dims[1] * grid->layers;
+        uint32_t stride[3] = { 1, uint32_t(dims[0]), uint32_t(dims[0] * dims[1]) };
+        std::vector<real_t> slabAreas(slabsize, 0);
+        std::vector<real_t> slabHistograms(slabsize * nbclasses, 0);
+        std::vector<uint32_t> slabHeads(slabsize, UINT32_MAX);
+        std::vector<VoxelShapeEntry> slabEntries;
+        std::vector<uint32_t> slabTouched;
+        areas = &slabAreas; histograms = &slabHistograms; heads = &slabHeads;
+        entries = &slabEntries; touched = &slabTouched;
+
+        SlabVoxels& result = results[chunk];
+        std::vector<VoxelShapeEntry> voxelEntries;
+        real_t p[3][3];
+        real_t area;
+        for (size_t s = begin; s < end; ++s) {
+            int32_t z0 = int32_t(s * grid->layers);
+            int32_t z1 = std::min<int32_t>(z0 + grid->layers, dims[2]) - 1;
+            for (size_t it = slabOffsets[s]; it < slabOffsets[s+1]; ++it) {
+                uint32_t t = slabTriangles[it];
+                grid->triangle(t, p);
+                uint32_t oclass = orientation_class(p, area);
+                if (area <= 0) continue;
+                ClipPolygon poly;
+                poly.n = 3;
+                for (int i = 0; i < 3; ++i) for (int j = 0; j < 3; ++j) poly.p[i][j] = p[i][j];
+                clip(poly, 2, z0, z1, 0, stride, oclass, grid->buffer->shapeIndices[t]);
+            }
+
+            // Compaction of the non empty voxels in increasing order.
+            std::sort(slabTouched.begin(), slabTouched.end());
+            uint32_t offset = uint32_t(z0) * stride[2];
+            for (std::vector<uint32_t>::const_iterator itv = slabTouched.begin(); itv != slabTouched.end(); ++itv) {
+                uint32_t v = *itv;
+                result.voxels.push_back(offset + v);
+                result.areas.push_back(slabAreas[v]);
+                slabAreas[v] = 0;
+                real_t * hist = &slabHistograms[size_t(v) * nbclasses];
+                result.histograms.insert(result.histograms.end(), hist, hist + nbclasses);
+                std::fill(hist, hist + nbclasses, real_t(0));
+                voxelEntries.clear();
+                for (uint32_t e = slabHeads[v]; e != UINT32_MAX; e = slabEntries[e].next)
+                    voxelEntries.push_back(slabEntries[e]);
+                slabHeads[v] = UINT32_MAX;
+                std::sort(voxelEntries.begin(), voxelEntries.end());
+                result.shapeCounts.push_back(voxelEntries.size());
+                for (std::vector<VoxelShapeEntry>::const_iterator ite = voxelEntries.begin(); ite != voxelEntries.end(); ++ite) {
+                    result.shapeIds.push_back(grid->buffer->shapeIds[ite->shape]);
+                    result.shapeAreas.push_back(ite->area);
+                }
+            }
+            slabTouched.clear();
+            slabEntries.clear();
+        }
+    }
+};
+
+/* ----------------------------------------------------------------------- */
+
+SceneVoxelizer::SceneVoxelizer(const Vector3& voxelsize, uint32_t nbInclinationClasses, uint32_t nbAzimuthClasses):
+    __voxelsize(voxelsize),
+    __nbInclinationClasses(std::max<uint32_t>(nbInclinationClasses,1)),
+    __nbAzimuthClasses(std::max<uint32_t>(nbAzimuthClasses,1)),
+    __userBounds(false),
+    __dimensions(0,0,0),
+    __nbTriangles(0)
+{ }
+
+SceneVoxelizer::~SceneVoxelizer() { }
+
+void SceneVoxelizer::setBoundingBox(const Vector3& lower, const Vector3& upper)
+{
+    __userBounds = true;
+    __lower = lower;
+    __upper = upper;
+}
+
+void SceneVoxelizer::unsetBoundingBox()
+{
+    __userBounds = false;
+}
+
+void SceneVoxelizer::clear()
+{
+    __dimensions = Uint32Tuple3(0,0,0);
+    __nbTriangles = 0;
+    std::vector<uint32_t>().swap(__voxels);
+    std::vector<real_t>().swap(__areas);
+    std::vector<real_t>().swap(__histograms);
+    std::vector<uint32_t>().swap(__shapeOffsets);
+    std::vector<uint32_t>().swap(__shapeIds);
+    std::vector<real_t>().swap(__shapeAreas);
+}
+
+bool SceneVoxelizer::process(const ScenePtr& scene)
+{
+    clear();
+    if (__voxelsize.x() <= 0 || __voxelsize.y() <= 0 || __voxelsize.z() <= 0) {
+        pglError("Invalid voxel size (%f,%f,%f).", __voxelsize.x(), __voxelsize.y(), __voxelsize.z());
+        return false;
+    }
+
+    CompactMeshBuffer buffer;
+    if (!bake_scene(scene, buffer, false)) return false;
+    size_t nbTriangles = buffer.triangleCount();
+    if (nbTriangles >= UINT32_MAX) {
+        pglError("Too many triangles (%lu) to voxelize.", (unsigned long)nbTriangles);
+        return false;
+    }
+
+    // Dimensions of the grid.
+    Vector3 lower = __lower, upper = __upper;
+    if (!__userBounds) {
+        size_t nbVertices = buffer.vertexCount();
+        if (nbVertices == 0) return false;
+        VertexBounds bounds(&buffer.vertices[0], parallel_chunk_count(nbVertices, PARALLEL_GRAIN));
+        parallel_for(nbVertices, bounds, PARALLEL_GRAIN);
+        lower = Vector3(REAL_MAX,REAL_MAX,REAL_MAX);
+        upper = Vector3(-REAL_MAX,-REAL_MAX,-REAL_MAX);
+        for (size_t c = 0; c < bounds.lowers.size(); c += 3)
+            for (int j = 0; j < 3; ++j) {
+                lower[j] = std::min(lower[j], bounds.lowers[c+j]);
+                upper[j] = std::max(upper[j], bounds.uppers[c+j]);
+            }
+    }
+    VoxelGridInfo grid;
+    grid.buffer = &buffer;
+    uint64_t nbVoxels = 1;
+    for (int j = 0; j < 3; ++j) {
+        grid.origin[j] = lower[j];
+        grid.size[j] = __voxelsize[j];
+        real_t extent = (upper[j] - lower[j]) / __voxelsize[j];
+        if (extent < 0) {
+            pglError("Invalid bounding box.");
+            return false;
+        }
+        // A point on the upper side of the box of the scene lies in an additional layer of voxels.
+        real_t dim = (__userBounds ? std::max<real_t>(ceil(extent),1) : floor(extent) + 1);
+        if (dim >= UINT32_MAX) nbVoxels = UINT64_MAX;
+        else { grid.dims[j] = int32_t(dim); nbVoxels *= uint64_t(dim); }
+        if (nbVoxels >= UINT32_MAX) {
+            pglError("Too many voxels to voxelize the scene.");
+            return false;
+        }
+    }
+
+    // Slabs of layers along z, small enough for their dense buffers and numerous enough to use all the threads.
+    uint32_t nbclasses = __nbInclinationClasses * __nbAzimuthClasses;
+    size_t layersize = size_t(grid.dims[0]) * grid.dims[1];
+    size_t voxelbytes = (nbclasses + 1) * sizeof(real_t) + sizeof(uint32_t);
+    size_t layers = std::max<size_t>(MAX_SLAB_BYTES / (voxelbytes * layersize), 1);
+    size_t minslabs = 4 * parallel_thread_count();
+    layers = std::min(layers, std::max<size_t>((grid.dims[2] + minslabs - 1) / minslabs, 1));
+    grid.layers = uint32_t(layers);
+    grid.nbSlabs = (grid.dims[2] + layers - 1) / layers;
+
+    // Triangles of each slab.
+    size_t nbchunks = parallel_chunk_count(nbTriangles, PARALLEL_GRAIN);
+    std::vector<size_t> counts(nbchunks * grid.nbSlabs, 0);
+    SlabBinning binning;
+    binning.grid = &grid;
+    binning.counts = counts.empty() ? NULL : &counts[0];
+    binning.triangles = NULL;
+    parallel_for(nbTriangles, binning, PARALLEL_GRAIN);
+    std::vector<size_t> slabOffsets(grid.nbSlabs + 1, 0);
+    size_t total = 0;
+    for (size_t s = 0; s < grid.nbSlabs; ++s) {
+        slabOffsets[s] = total;
+        for (size_t c = 0; c < nbchunks; ++c) {
+            size_t n = counts[c * grid.nbSlabs + s];
+            counts[c * grid.nbSlabs + s] = total;
+            total += n;
+        }
+    }
+    slabOffsets[grid.nbSlabs] = total;
+    std::vector<uint32_t> slabTriangles(total);
+    binning.triangles = total == 0 ? NULL : &slabTriangles[0];
+    if (total > 0) parallel_for(nbTriangles, binning, PARALLEL_GRAIN);
+
+    // Accumulation of the triangles in the slabs.
+    size_t nbSlabChunks = parallel_chunk_count(grid.nbSlabs, 1);
+    std::vector<SlabVoxels> results(nbSlabChunks);
+    SlabVoxelizer voxelizer;
+    voxelizer.grid = &grid;
+    voxelizer.slabOffsets = &slabOffsets[0];
+    voxelizer.slabTriangles = total == 0 ? NULL : &slabTriangles[0];
+    voxelizer.nbInclinationClasses = __nbInclinationClasses;
+    voxelizer.nbAzimuthClasses = __nbAzimuthClasses;
+    voxelizer.results = &results[0];
+    if (total > 0) parallel_for(grid.nbSlabs, voxelizer, 1);
+    std::vector<uint32_t>().swap(slabTriangles);
+
+    // Concatenation of the slabs.
+    size_t nbNonEmpty = 0, nbEntries = 0;
+    for (size_t c = 0; c < nbSlabChunks; ++c) {
+        nbNonEmpty += results[c].voxels.size();
+        nbEntries += results[c].shapeIds.size();
+    }
+    __voxels.reserve(nbNonEmpty);
+    __areas.reserve(nbNonEmpty);
+    __histograms.reserve(nbNonEmpty * nbclasses);
+    __shapeOffsets.reserve(nbNonEmpty + 1);
+    __shapeIds.reserve(nbEntries);
+    __shapeAreas.reserve(nbEntries);
+    __shapeOffsets.push_back(0);
+    for (size_t c = 0; c < nbSlabChunks; ++c) {
+        SlabVoxels& result = results[c];
+        __voxels.insert(__voxels.end(), result.voxels.begin(), result.voxels.end());
+        __areas.insert(__areas.end(), result.areas.begin(), result.areas.end());
+        __histograms.insert(__histograms.end(), result.histograms.begin(), result.histograms.end());
+        for (std::vector<uint32_t>::const_iterator it = result.shapeCounts.begin(); it != result.shapeCounts.end(); ++it)
+            __shapeOffsets.push_back(__shapeOffsets.back() + *it);
+        __shapeIds.insert(__shapeIds.end(), result.shapeIds.begin(), result.shapeIds.end());
+        __shapeAreas.insert(__shapeAreas.end(), result.shapeAreas.begin(), result.shapeAreas.end());
+        result = SlabVoxels();
+    }
+
+    __origin = lower;
+    __dimensions = Uint32Tuple3(grid.dims[0], grid.dims[1], grid.dims[2]);
+    __nbTriangles = nbTriangles;
+    return true;
+}
+
+/* ----------------------------------------------------------------------- */
+
+Uint32Array1Ptr SceneVoxelizer::getVoxelIndices() const
+{
+    return Uint32Array1Ptr(new Uint32Array1(__voxels.begin(), __voxels.end()));
+}
+
+Point3ArrayPtr SceneVoxelizer::getVoxelCenters() const
+{
+    Point3ArrayPtr result(new Point3Array(__voxels.size()));
+    Point3Array::iterator itres = result->begin();
+    uint32_t nx = __dimensions.getAt(0), ny = __dimensions.getAt(1);
+    for (std::vector<uint32_t>::const_iterator it = __voxels.begin(); it != __voxels.end(); ++it, ++itres) {
+        uint32_t x = *it % nx, y = (*it / nx) % ny, z = *it / (nx * ny);
+        *itres = Vector3(__origin.x() + (x + 0.5) * __voxelsize.x(),
+                         __origin.y() + (y + 0.5) * __voxelsize.y(),
+                         __origin.z() + (z + 0.5) * __voxelsize.z());
+    }
+    return result;
+}
+
+RealArrayPtr SceneVoxelizer::getAreas() const
+{
+    return RealArrayPtr(new RealArray(__areas.begin(), __areas.end()));
+}
+
+RealArrayPtr SceneVoxelizer::getAreaDensities() const
+{
+    RealArrayPtr result(new RealArray(__areas.begin(), __areas.end()));
+    real_t volume = __voxelsize.x() * __voxelsize.y() * __voxelsize.z();
+    for (RealArray::iterator it = result->begin(); it != result->end(); ++it) *it /= volume;
+    return result;
+}
+
+RealArray2Ptr SceneVoxelizer::getOrientationHistograms() const
+{
+    return RealArray2Ptr(new RealArray2(__histograms.begin(), __histograms.end(), 
+                                        __nbInclinationClasses * __nbAzimuthClasses));
+}
+
+Uint32Array1Ptr SceneVoxelizer::getShapeOffsets() const
+{
+    return Uint32Array1Ptr(new Uint32Array1(__shapeOffsets.begin(), __shapeOffsets.end()));
+}
+
+Uint32Array1Ptr SceneVoxelizer::getShapeIds() const
+{
+    return Uint32Array1Ptr(new Uint32Array1(__shapeIds.begin(), __shapeIds.end()));
+}
+
+RealArrayPtr SceneVoxelizer::getShapeAreas() const
+{
+    return RealArrayPtr(new RealArray(__shapeAreas.begin(), __shapeAreas.end()));
+}
+
+/* ----------------------------------------------------------------------- */
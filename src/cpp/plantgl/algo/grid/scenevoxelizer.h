@@ -0,0 +1,178 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2012 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+/*! \file scenevoxelizer.h
+    \brief Definition of SceneVoxelizer, the accumulation of the surfaces of a scene in a regular grid.
+*/
+
+
+
+#ifndef __scenevoxelizer_h__
+#define __scenevoxelizer_h__
+
+/* ----------------------------------------------------------------------- */
+
+#include "../algo_config.h"
+#include <plantgl/scenegraph/scene/scene.h>
+#include <plantgl/scenegraph/container/pointarray.h>
+#include <plantgl/math/util_vector.h>
+#include <plantgl/tool/util_array.h>
+#include <plantgl/tool/util_array2.h>
+#include <plantgl/tool/util_tuple.h>
+#include <vector>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/**
+    \class SceneVoxelizer
+    \brief Accumulate the area of the triangles of a scene in the voxels of a regular grid.
+
+    The scene is tesselated with bake_scene and each triangle is clipped exactly against
+    the planes of the grid. For each voxel, the voxelizer accumulates the area of the
+    triangles, its distribution in classes of orientation of their normals, and the area
+    of each shape. Only non empty voxels are stored, ordered by their index
+    x + nx * (y + ny * z).
+
+    The grid is processed in parallel by slabs of layers along z. Each slab accumulates
+    its triangles in its own dense buffer, which is then compacted. Results do not depend
+    on the number of threads.
+
+    Orientation classes split the inclination of the normal to the vertical, from 0 to 90 degrees,
+    and its azimuth, from 0 to 360 degrees. Both faces of a triangle have the same orientation.
+*/
+
+/* ----------------------------------------------------------------------- */
+
+class ALGO_API SceneVoxelizer
+{
+public:
+
+    /// Constructor. Voxels have the size \e voxelsize.
+    SceneVoxelizer(const TOOLS(Vector3)& voxelsize, 
+                   uint32_t nbInclinationClasses = 9, 
+                   uint32_t nbAzimuthClasses = 1);
+
+    ~SceneVoxelizer();
+
+    /** Voxelize \e scene. If no bounding box was set, the grid covers the bounding box of the scene.
+        Returns false if the scene cannot be voxelized. */
+    bool process(const ScenePtr& scene);
+
+    /// Free the results.
+    void clear();
+
+    /// Restrict the grid to the box [lower, upper]. Parts of triangles outside are ignored.
+    void setBoundingBox(const TOOLS(Vector3)& lower, const TOOLS(Vector3)& upper);
+
+    /// Let the grid cover the bounding box of the scene.
+    void unsetBoundingBox();
+
+    inline const TOOLS(Vector3)& getVoxelSize() const { return __voxelsize; }
+
+    /// The lower corner of the grid of the last process.
+    inline const TOOLS(Vector3)& getOrigin() const { return __origin; }
+
+    /// The number of voxels along x, y and z of the grid of the last process.
+    inline const TOOLS(Uint32Tuple3)& getDimensions() const { return __dimensions; }
+
+    inline uint32_t getNbInclinationClasses() const { return __nbInclinationClasses; }
+    inline uint32_t getNbAzimuthClasses() const { return __nbAzimuthClasses; }
+
+    /// The number of non empty voxels.
+    inline uint32_t size() const { return __voxels.size(); }
+
+    /// The index x + nx * (y + ny * z) of each non empty voxel.
+    TOOLS(Uint32Array1Ptr) getVoxelIndices() const;
+
+    /// The center of each non empty voxel.
+    Point3ArrayPtr getVoxelCenters() const;
+
+    /// The area of the triangles in each non empty voxel.
+    TOOLS(RealArrayPtr) getAreas() const;
+
+    /// The area of the triangles in each non empty voxel divided by the volume of the voxel.
+    TOOLS(RealArrayPtr) getAreaDensities() const;
+
+    /** The area of each orientation class in each non empty voxel, one row per voxel.
+        The class of inclination i and azimuth j is the column i * nbAzimuthClasses + j. */
+    TOOLS(RealArray2Ptr) getOrientationHistograms() const;
+
+    /** The shapes in each non empty voxel in compressed rows : the shapes of the voxel v 
+        are given from getShapeOffsets()[v] to getShapeOffsets()[v+1] - 1. */
+    TOOLS(Uint32Array1Ptr) getShapeOffsets() const;
+
+    /// The ids of the shapes of each non empty voxel.
+    TOOLS(Uint32Array1Ptr) getShapeIds() const;
+
+    /// The area of each shape in each non empty voxel.
+    TOOLS(RealArrayPtr) getShapeAreas() const;
+
+    /// The number of triangles voxelized by the last process.
+    inline size_t getTriangleCount() const { return __nbTriangles; }
+
+protected:
+    TOOLS(Vector3) __voxelsize;
+    uint32_t __nbInclinationClasses;
+    uint32_t __nbAzimuthClasses;
+
+    bool __userBounds;
+    TOOLS(Vector3) __lower;
+    TOOLS(Vector3) __upper;
+
+    TOOLS(Vector3) __origin;
+    TOOLS(Uint32Tuple3) __dimensions;
+    size_t __nbTriangles;
+
+    // non empty voxels, with their area and orientation histogram
+    std::vector<uint32_t> __voxels;
+    std::vector<real_t> __areas;
+    std::vector<real_t> __histograms;
+
+    // shapes of each voxel in compressed rows
+    std::vector<uint32_t> __shapeOffsets;
+    std::vector<uint32_t> __shapeIds;
+    std::vector<real_t> __shapeAreas;
+};
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+// __scenevoxelizer_h__
+#endif
@@ -58,6 +58,7 @@
 #include <plantgl/scenegraph/scene/shape.h>
 #include <plantgl/math/util_math.h>
 #include <plantgl/tool/util_types.h>
+#include <typeinfo>
 #include <plantgl/tool/util_string.h>
 
 #include <sstream>
@@ -235,7 +236,8 @@ TurtleParam::TurtleParam() :
   customId(Shape::NOID),
   customParentId(Shape::NOID),
   sectionResolution(Cylinder::DEFAULT_SLICES),
-  initial()
+  initial(),
+  __sharedPoints(false)
 {        
 }
 
@@ -260,19 +262,37 @@ TurtleParam::reset(){
   screenCoordinates = false;
   __polygon = false;
   __generalizedCylinder = false;
-  pointList->clear();
-  leftList.clear();
-  radiusList.clear();
+  removePoints();
   initial.reset();
   guide = TurtlePathPtr();
 }
     
 TurtleParam * TurtleParam::copy(){
+  if(__polygon) detachPoints();
   TurtleParam * t = new TurtleParam(*this);
   if(t->guide)t->guide = t->guide->copy();
   if(!__polygon)t->pointList = new Point3Array(*t->pointList);
+  t->__sharedPoints = false;
   return t;
 }
+
+void TurtleParam::copyTo(TurtleParam& target){
+  // polygon points are shared on purpose between branches.
+  if(__polygon) detachPoints();
+  else __sharedPoints = true;
+  target = *this;
+}
+
+void TurtleParam::detachPoints(){
+  if(__sharedPoints){
+    if(!pointList->unique()) pointList = new Point3Array(*pointList);
+    __sharedPoints = false;
+  }
+}
+
+void TurtleParam::detachGuide(){
+  if(guide && !guide->unique()) guide = guide->copy();
+}
     
 void TurtleParam::dump(){
    std::cerr << "Position : " << position << std::endl;
@@ -309,19 +329,23 @@ bool TurtleParam::isValid() const{
 void TurtleParam::keepLastPoint(){
   if(!pointList->empty()){
 	Vector3 lastp = *(pointList->end()-1);
-	pointList->clear();
-	pointList->push_back(lastp);
-    // pointList = vector<Vector3>(1,*(pointList.end()-1));
-	// pointList = vector<Vector3>(1,*(pointList.end()-1));
+	if(__sharedPoints && !pointList->unique()) pointList = new Point3Array(1,lastp);
+	else {
+	  pointList->clear();
+	  pointList->push_back(lastp);
+	}
+	__sharedPoints = false;
   }
   if(!leftList.empty())
-	leftList = vector<Vector3>(1,*(leftList.end()-1));
+	leftList.erase(leftList.begin(),leftList.end()-1);
   if(!radiusList.empty())
-    radiusList = vector<real_t>(1,*(radiusList.end()-1));
+	radiusList.erase(radiusList.begin(),radiusList.end()-1);
 }
     
 void TurtleParam::removePoints(){
-  pointList->clear();
+  if(__sharedPoints && !pointList->unique()) pointList = new Point3Array();
+  else pointList->clear();
+  __sharedPoints = false;
   leftList.clear();
   radiusList.clear();
 }
@@ -351,6 +375,7 @@ void TurtleParam::generalizedCylinder(bool t){
 }
     
 void TurtleParam::pushPosition(){
+  detachPoints();
   pointList->push_back(position);
   if(__generalizedCylinder) {
 	leftList.push_back(left);
@@ -379,7 +404,14 @@ Turtle::Turtle(TurtleParam * params):
 	assert (__params->crossSection && "Failed to initialize cross section");
 }
 
-Turtle::~Turtle() { }
+Turtle::~Turtle() {
+	while(!__paramstack.empty()){
+	  delete __paramstack.top();
+	  __paramstack.pop();
+	}
+	for(std::vector<TurtleParam *>::const_iterator it = __parampool.begin(); it != __parampool.end(); ++it)
+	  delete *it;
+}
 
 string 
 Turtle::str() const {
@@ -399,7 +431,10 @@ void Turtle::reset(){
 void Turtle::resetValues(){
 	__params->reset();
 	if (!__params->crossSection) setDefaultCrossSection();
-	__paramstack = stack<TurtleParam *>();
+	while(!__paramstack.empty()){
+	  __releaseParams(__paramstack.top());
+	  __paramstack.pop();
+	}
 }
   
 void Turtle::dump() const{
@@ -437,6 +472,30 @@ uint_t Turtle::popId()
     return nid;
 }
 
+TurtleParam * Turtle::__saveParams()
+{
+    // derived parameters classes use their own copy
+    if (typeid(*__params) != typeid(TurtleParam)) return __params->copy();
+    TurtleParam * frame;
+    if (__parampool.empty()) frame = new TurtleParam();
+    else {
+        frame = __parampool.back();
+        __parampool.pop_back();
+    }
+    // frame vectors keep their capacity: no allocation once the stack has been used.
+    __params->copyTo(*frame);
+    return frame;
+}
+
+void Turtle::__releaseParams(TurtleParam * frame)
+{
+    if (typeid(*frame) != typeid(TurtleParam)) { delete frame; return; }
+    // release shared data so that the frames still in use own them again
+    frame->pointList = Point3ArrayPtr();
+    frame->guide = TurtlePathPtr();
+    __parampool.push_back(frame);
+}
+
 void Turtle::stop(){
   if(__params->isGeneralizedCylinderOn()){
 	  if(__params->pointList->size() > 1){
@@ -452,7 +511,7 @@ void Turtle::stop(){
   
   void Turtle::push(){
     __params->lastId = parentId;
-	__paramstack.push(__params->copy());
+	__paramstack.push(__saveParams());
     if(__params->isGeneralizedCylinderOn()){
 	    __params->keepLastPoint();
         __params->customParentId = __params->customId;
@@ -472,7 +531,7 @@ void Turtle::stop(){
 		}
 	}
 	if(!__paramstack.empty()){
-	  delete __params;
+	  __releaseParams(__params);
 	  __params = __paramstack.top();
 	  __paramstack.pop();
       parentId = __params->lastId;
@@ -587,6 +646,7 @@ void Turtle::iRollL(real_t angle){
 	__params->up = m*__params->up;
 	__params->left = m*__params->left;
 	if (__params->guide && !__params->guide->is2D()){
+		__params->detachGuide();
 		Turtle3DPath * guide = (Turtle3DPath *)__params->guide.get();
 		Matrix3 m2 = Matrix3::axisRotation(guide->__lastHeading,ra);
 		guide->__lastUp   = m2*guide->__lastUp;
@@ -920,7 +980,7 @@ void  Turtle::setSectionResolution(uint_t resolution)
 
 void Turtle::setPositionOnGuide(real_t t)
 { 
-	if(__params->guide) getParameters().guide->setPosition(t); 
+	if(__params->guide) { __params->detachGuide(); __params->guide->setPosition(t); }
 	else warning("Guide not set. Cannot set position on it.");
 }
 
@@ -947,6 +1007,7 @@ void Turtle::_applyTropism() {
 }
 
 void Turtle::_applyGuide(real_t& l) {
+		__params->detachGuide();
 		bool local_ajustement = (fabs(l) < GEOM_EPSILON);
 		real_t current = __params->guide->__actualT;
 		if( current >= 1.0 && !local_ajustement) { 
@@ -37,6 +37,7 @@
 
 #include <string>
 #include <stack>
+#include <vector>
 
 
 PGL_BEGIN_NAMESPACE
@@ -505,10 +506,18 @@ protected:
 
     uint_t popId();
 
+	/// get a frame holding a copy of the current parameters. Frames are recycled.
+    TurtleParam * __saveParams();
+
+	/// give back a frame no more used for recycling.
+    void __releaseParams(TurtleParam * frame);
+
     TurtleParam *        __params;
 
     std::stack<TurtleParam *> __paramstack;
 
+    std::vector<TurtleParam *> __parampool;
+
 	real_t default_step;
 	real_t angle_increment;
 	real_t width_increment;
@@ -153,6 +153,13 @@ public:
     
 	/// make a deep copy of this. usefull for putting a copy of this on a stack 
     virtual TurtleParam * copy();
+
+	/** copy this into \e target, reusing the memory already allocated by \e target.
+	    The point list is shared and only duplicated when one of the two is modified (copy on write). */
+    void copyTo(TurtleParam& target);
+
+	/// make the guide owned by this before modifying it
+    void detachGuide();
     
 	/// write main parameters values 
     void dump();
@@ -243,8 +250,12 @@ public:
   bool screenCoordinates;
 
 protected:
+  /// make the point list owned by this before modifying it
+  void detachPoints();
+
   bool __polygon;
   bool __generalizedCylinder;
+  bool __sharedPoints;
 
 };
 
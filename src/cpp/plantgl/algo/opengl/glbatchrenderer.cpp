@@ -0,0 +1,399 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright 1995-2007 UMR CIRAD/INRIA/INRA DAP 
+ *
+ *       File author(s): F. Boudon et al.
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+
+
+
+#include "glbatchrenderer.h"
+#include "glrenderer.h"
+#include <QtOpenGL/QGLFramebufferObject>
+#include <plantgl/algo/base/scenebaker.h>
+#include <plantgl/scenegraph/appearance/material.h>
+#include <plantgl/scenegraph/scene/shape.h>
+#include <plantgl/tool/util_hashmap.h>
+#include <plantgl/tool/util_hashset.h>
+#include <plantgl/tool/errormsg.h>
+
+PGL_USING_NAMESPACE
+TOOLS_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER 0x8892
+#define GL_ELEMENT_ARRAY_BUFFER 0x8893
+#endif
+
+#ifndef GL_STATIC_DRAW
+#define GL_STATIC_DRAW 0x88E4
+#endif
+
+#ifndef GL_MULTISAMPLE
+#define GL_MULTISAMPLE 0x809D
+#endif
+
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+
+/* Buffer objects functions are resolved at runtime since they are not
+   exported by all OpenGL libraries (OpenGL 1.5). */
+typedef void (APIENTRY * PGLGENBUFFERSPROC) (GLsizei n, GLuint * buffers);
+typedef void (APIENTRY * PGLDELETEBUFFERSPROC) (GLsizei n, const GLuint * buffers);
+typedef void (APIENTRY * PGLBINDBUFFERPROC) (GLenum target, GLuint buffer);
+typedef void (APIENTRY * PGLBUFFERDATAPROC) (GLenum target, ptrdiff_t size, const GLvoid * data, GLenum usage);
+
+PGL_BEGIN_NAMESPACE
+
+/* Entry points of the buffer objects functions of an OpenGL context.
+   They may differ from one context to another and are thus resolved for
+   the context in which the buffers are created. */
+struct GLBufferFunctions {
+  PGLGENBUFFERSPROC genBuffers;
+  PGLDELETEBUFFERSPROC deleteBuffers;
+  PGLBINDBUFFERPROC bindBuffer;
+  PGLBUFFERDATAPROC bufferData;
+
+  GLBufferFunctions( const QGLContext * context ) {
+    genBuffers = (PGLGENBUFFERSPROC)context->getProcAddress("glGenBuffers");
+    deleteBuffers = (PGLDELETEBUFFERSPROC)context->getProcAddress("glDeleteBuffers");
+    bindBuffer = (PGLBINDBUFFERPROC)context->getProcAddress("glBindBuffer");
+    bufferData = (PGLBUFFERDATAPROC)context->getProcAddress("glBufferData");
+  }
+
+  bool isValid( ) const { return genBuffers && deleteBuffers && bindBuffer && bufferData; }
+};
+
+PGL_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+GLBatchRenderer::GLBatchRenderer( ) :
+  __triangleNb(0),
+  __vertexNb(0),
+  __uploaded(false),
+  __context(NULL),
+  __functions(NULL)
+{
+  __buffers[0] = __buffers[1] = __buffers[2] = __buffers[3] = 0;
+}
+
+GLBatchRenderer::~GLBatchRenderer( )
+{
+  clear();
+}
+
+void GLBatchRenderer::releaseBuffers( )
+{
+  // Buffer names are only meaningful in the context that created them.
+  // If this context is not current, it has been destroyed with its buffers
+  // or is not ours to modify.
+  if (__buffers[0] != 0 && QGLContext::currentContext() == __context)
+    __functions->deleteBuffers(4, __buffers);
+  __buffers[0] = __buffers[1] = __buffers[2] = __buffers[3] = 0;
+  delete __functions;
+  __functions = NULL;
+  __context = NULL;
+}
+
+void GLBatchRenderer::clear( )
+{
+  releaseBuffers();
+  __uploaded = false;
+  __scene = ScenePtr();
+  __unbatched = ScenePtr();
+  __batches.clear();
+  std::vector<float>().swap(__vertices);
+  std::vector<float>().swap(__normals);
+  std::vector<GLubyte>().swap(__colors);
+  std::vector<uint32_t>().swap(__indices);
+  __triangleNb = 0;
+  __vertexNb = 0;
+}
+
+/* ----------------------------------------------------------------------- */
+
+void GLBatchRenderer::encodePosition( uint_t position, GLubyte * rgba )
+{
+  // 0 is kept for the background
+  uint_t code = position + 1;
+  rgba[0] = GLubyte(code & 0xff);
+  rgba[1] = GLubyte((code >> 8) & 0xff);
+  rgba[2] = GLubyte((code >> 16) & 0xff);
+  rgba[3] = 255;
+}
+
+uint_t GLBatchRenderer::decodePosition( const GLubyte * rgba )
+{
+  uint_t code = uint_t(rgba[0]) | (uint_t(rgba[1]) << 8) | (uint_t(rgba[2]) << 16);
+  return code == 0 ? UINT32_MAX : code - 1;
+}
+
+/* ----------------------------------------------------------------------- */
+
+bool GLBatchRenderer::build( const ScenePtr& scene )
+{
+  clear();
+  if (!scene) return false;
+  __scene = scene;
+  __unbatched = ScenePtr(new Scene());
+
+  // Textured shapes need texture coordinates and are left to the GLRenderer.
+  ScenePtr batchable(new Scene());
+  std::vector<uint_t> positions;
+  uint_t position = 0;
+  for (Scene::const_iterator it = scene->begin(); it != scene->end(); ++it, ++position){
+    ShapePtr sh = dynamic_pointer_cast<Shape>(*it);
+    if (sh && sh->geometry && !(sh->appearance && sh->appearance->isTexture()) && position < 0xffffff){
+      batchable->add(sh);
+      positions.push_back(position);
+    }
+    else __unbatched->add(*it);
+  }
+
+  CompactMeshBuffer mesh;
+  if (!bake_scene(batchable, mesh, true)) {
+    pglWarning("GLBatchRenderer: too many vertices to be batched.");
+    __unbatched = scene;
+    return false;
+  }
+  size_t nbShapes = positions.size();
+
+  // Groups the shapes by appearance
+  pgl_hash_map<size_t,uint_t> batchIds;
+  std::vector<uint_t> shapeBatch(nbShapes,0);
+  for (size_t s = 0; s < nbShapes; ++s){
+    size_t nbTriangles = mesh.triangleOffsets[s+1] - mesh.triangleOffsets[s];
+    ShapePtr sh = static_pointer_cast<Shape>(batchable->getAt(s));
+    if (nbTriangles == 0) {
+      // curves, points or texts
+      __unbatched->add(Shape3DPtr(sh));
+      continue;
+    }
+    const AppearancePtr& appearance = (sh->appearance ? sh->appearance : Material::DEFAULT_MATERIAL);
+    pgl_hash_map<size_t,uint_t>::const_iterator itb = batchIds.find(appearance->getId());
+    if (itb == batchIds.end()){
+      itb = batchIds.insert(std::pair<size_t,uint_t>(appearance->getId(),uint_t(__batches.size()))).first;
+      Batch batch;
+      batch.appearance = appearance;
+      batch.firstIndex = 0;
+      batch.indexCount = 0;
+      __batches.push_back(batch);
+    }
+    shapeBatch[s] = itb->second;
+    __batches[itb->second].indexCount += 3 * nbTriangles;
+  }
+
+  size_t first = 0;
+  for (std::vector<Batch>::iterator itb = __batches.begin(); itb != __batches.end(); ++itb){
+    itb->firstIndex = first;
+    first += itb->indexCount;
+  }
+
+  // Reorders the triangles by batch and sets the color code of the vertices
+  __indices.resize(first);
+  __colors.resize(4 * mesh.vertexCount(), 0);
+  std::vector<size_t> cursors(__batches.size());
+  for (size_t b = 0; b < __batches.size(); ++b) cursors[b] = __batches[b].firstIndex;
+  for (size_t s = 0; s < nbShapes; ++s){
+    size_t begin = 3 * mesh.triangleOffsets[s], end = 3 * mesh.triangleOffsets[s+1];
+    if (begin == end) continue;
+    GLubyte code[4];
+    encodePosition(positions[s], code);
+    size_t& cursor = cursors[shapeBatch[s]];
+    for (size_t i = begin; i < end; ++i){
+      uint32_t vertex = mesh.indices[i];
+      __indices[cursor++] = vertex;
+      std::copy(code, code+4, __colors.begin() + 4 * vertex);
+    }
+  }
+
+  __triangleNb = first / 3;
+  __vertexNb = mesh.vertexCount();
+  __vertices.swap(mesh.vertices);
+  __normals.swap(mesh.normals);
+  return true;
+}
+
+/* ----------------------------------------------------------------------- */
+
+void GLBatchRenderer::upload( )
+{
+  __uploaded = true;
+  if (__vertexNb == 0) return;
+  const QGLContext * context = QGLContext::currentContext();
+  if (!context) return;
+  GLBufferFunctions * functions = new GLBufferFunctions(context);
+  if (!functions->isValid()) { delete functions; return; }
+  functions->genBuffers(4, __buffers);
+  if (__buffers[0] == 0) { delete functions; return; }
+  __context = context;
+  __functions = functions;
+  __functions->bindBuffer(GL_ARRAY_BUFFER, __buffers[0]);
+  __functions->bufferData(GL_ARRAY_BUFFER, __vertices.size() * sizeof(float), &__vertices[0], GL_STATIC_DRAW);
+  __functions->bindBuffer(GL_ARRAY_BUFFER, __buffers[1]);
+  __functions->bufferData(GL_ARRAY_BUFFER, __normals.size() * sizeof(float), &__normals[0], GL_STATIC_DRAW);
+  __functions->bindBuffer(GL_ARRAY_BUFFER, __buffers[2]);
+  __functions->bufferData(GL_ARRAY_BUFFER, __colors.size(), &__colors[0], GL_STATIC_DRAW);
+  __functions->bindBuffer(GL_ARRAY_BUFFER, 0);
+  __functions->bindBuffer(GL_ELEMENT_ARRAY_BUFFER, __buffers[3]);
+  __functions->bufferData(GL_ELEMENT_ARRAY_BUFFER, __indices.size() * sizeof(uint32_t), &__indices[0], GL_STATIC_DRAW);
+  __functions->bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+  // Data are now on the graphic card.
+  std::vector<float>().swap(__vertices);
+  std::vector<float>().swap(__normals);
+  std::vector<GLubyte>().swap(__colors);
+  std::vector<uint32_t>().swap(__indices);
+}
+
+void GLBatchRenderer::bindArrays( bool colors )
+{
+  if (!__uploaded) upload();
+  glEnableClientState(GL_VERTEX_ARRAY);
+  if (colors) glEnableClientState(GL_COLOR_ARRAY);
+  else glEnableClientState(GL_NORMAL_ARRAY);
+  if (useBufferObjects()) {
+    __functions->bindBuffer(GL_ARRAY_BUFFER, __buffers[0]);
+    glVertexPointer(3, GL_FLOAT, 0, 0);
+    if (colors) {
+      __functions->bindBuffer(GL_ARRAY_BUFFER, __buffers[2]);
+      glColorPointer(4, GL_UNSIGNED_BYTE, 0, 0);
+    }
+    else {
+      __functions->bindBuffer(GL_ARRAY_BUFFER, __buffers[1]);
+      glNormalPointer(GL_FLOAT, 0, 0);
+    }
+    __functions->bindBuffer(GL_ELEMENT_ARRAY_BUFFER, __buffers[3]);
+  }
+  else {
+    glVertexPointer(3, GL_FLOAT, 0, &__vertices[0]);
+    if (colors) glColorPointer(4, GL_UNSIGNED_BYTE, 0, &__colors[0]);
+    else glNormalPointer(GL_FLOAT, 0, &__normals[0]);
+  }
+}
+
+void GLBatchRenderer::unbindArrays( bool colors )
+{
+  if (useBufferObjects()) {
+    __functions->bindBuffer(GL_ARRAY_BUFFER, 0);
+    __functions->bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+  }
+  if (colors) glDisableClientState(GL_COLOR_ARRAY);
+  else glDisableClientState(GL_NORMAL_ARRAY);
+  glDisableClientState(GL_VERTEX_ARRAY);
+}
+
+/* ----------------------------------------------------------------------- */
+
+#define GEOM_GLBATCH_DRAW(batch) \
+  glDrawElements(GL_TRIANGLES, GLsizei(batch.indexCount), GL_UNSIGNED_INT, \
+                 (useBufferObjects() ? (const GLvoid *)(batch.firstIndex * sizeof(uint32_t)) \
+                                     : (const GLvoid *)(&__indices[batch.firstIndex])));
+
+void GLBatchRenderer::render( GLRenderer& renderer )
+{
+  if (__batches.empty()) return;
+  // The material state may have been changed since the renderer last applied one.
+  renderer.clearAppearanceCache();
+  bindArrays(false);
+  for (std::vector<Batch>::const_iterator it = __batches.begin(); it != __batches.end(); ++it){
+    it->appearance->apply(renderer);
+    GEOM_GLBATCH_DRAW((*it));
+  }
+  unbindArrays(false);
+  renderer.clearAppearanceCache();
+}
+
+void GLBatchRenderer::renderIds( )
+{
+  if (__batches.empty()) return;
+  glPushAttrib(GL_ENABLE_BIT | GL_LIGHTING_BIT | GL_COLOR_BUFFER_BIT | GL_CURRENT_BIT);
+  glDisable(GL_LIGHTING);
+  glDisable(GL_TEXTURE_2D);
+  glDisable(GL_BLEND);
+  glDisable(GL_DITHER);
+  glDisable(GL_FOG);
+  // antialiasing would blend the color codes of neighbor shapes on their edges
+  glDisable(GL_MULTISAMPLE);
+  glShadeModel(GL_FLAT);
+  bindArrays(true);
+  for (std::vector<Batch>::const_iterator it = __batches.begin(); it != __batches.end(); ++it){
+    GEOM_GLBATCH_DRAW((*it));
+  }
+  unbindArrays(true);
+  glPopAttrib();
+}
+
+ScenePtr GLBatchRenderer::select( int x, int y, int w, int h )
+{
+  ScenePtr result(new Scene());
+  if (__batches.empty() || w <= 0 || h <= 0) return result;
+
+  // The ids are rendered offscreen when possible to keep the view intact.
+  QGLFramebufferObject * offscreen = NULL;
+  if (QGLFramebufferObject::hasOpenGLFramebufferObjects()) {
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    offscreen = new QGLFramebufferObject(viewport[0]+viewport[2], viewport[1]+viewport[3],
+                                         QGLFramebufferObject::Depth);
+    if (!offscreen->isValid() || !offscreen->bind()) { delete offscreen; offscreen = NULL; }
+  }
+
+  // Only the selection rectangle is drawn.
+  glPushAttrib(GL_COLOR_BUFFER_BIT | GL_SCISSOR_BIT);
+  glEnable(GL_SCISSOR_TEST);
+  glScissor(x, y, w, h);
+  glClearColor(0,0,0,0);
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  renderIds();
+  glPopAttrib();
+
+  std::vector<GLubyte> pixels(4 * size_t(w) * size_t(h));
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glReadPixels(x, y, w, h, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]);
+
+  if (offscreen) {
+    offscreen->release();
+    delete offscreen;
+  }
+
+  pgl_hash_set_uint32 selected;
+  for (size_t i = 0; i < pixels.size(); i += 4){
+    uint_t position = decodePosition(&pixels[i]);
+    if (position < __scene->size() && selected.insert(position).second)
+      result->add(__scene->getAt(position));
+  }
+  return result;
+}
+
+/* ----------------------------------------------------------------------- */
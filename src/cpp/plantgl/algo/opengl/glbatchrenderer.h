@@ -0,0 +1,188 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright 1995-2007 UMR CIRAD/INRIA/INRA DAP 
+ *
+ *       File author(s): F. Boudon et al.
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+
+
+/*! \file glbatchrenderer.h
+    \brief Definition of the class GLBatchRenderer.
+*/
+
+
+
+#ifndef __glbatchrenderer_h__
+#define __glbatchrenderer_h__
+
+
+#include "util_gl.h"
+#include <plantgl/scenegraph/scene/scene.h>
+#include <plantgl/scenegraph/appearance/appearance.h>
+#include <vector>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+class GLRenderer;
+struct GLBufferFunctions;
+
+/* ----------------------------------------------------------------------- */
+
+/**
+   \class GLBatchRenderer
+   \brief Render a whole scene with a few draw calls.
+
+   The shapes are tesselated and packed into shared vertex and index buffers,
+   grouped by appearance. Each group is drawn with a single call. Buffers are
+   stored in vertex buffer objects when OpenGL supports them (OpenGL 1.5) and
+   in client side arrays otherwise.
+   Textured shapes and shapes not tesselated into triangles (curves, points, texts)
+   are not batched. They are given by getUnbatchedShapes to be rendered with a GLRenderer.
+   For selection, the color of each vertex encodes the position of its shape in the scene.
+*/
+
+class ALGO_API GLBatchRenderer
+{
+
+public:
+
+  /// A set of triangles sharing the same appearance.
+  struct Batch {
+    AppearancePtr appearance;
+    size_t firstIndex;
+    size_t indexCount;
+  };
+
+  /// Constructs a GLBatchRenderer.
+  GLBatchRenderer( );
+
+  /// Destructor. Releases the buffers as clear does.
+  ~GLBatchRenderer( );
+
+  /** Tesselates and packs the shapes of \e scene. No OpenGL context is required.
+      Returns false if the scene cannot be batched. */
+  bool build( const ScenePtr& scene );
+
+  /** Releases the buffers. Buffer objects are deleted only if the OpenGL context
+      in which they were created is current. */
+  void clear( );
+
+  /// Returns whether a scene has been built.
+  inline bool isBuilt( ) const { return is_valid_ptr(__scene); }
+
+  /// Draws the batches. Appearances are applied with \e renderer.
+  void render( GLRenderer& renderer );
+
+  /// Draws the batches without lighting, with the colors encoding the shape positions.
+  void renderIds( );
+
+  /** Returns the shapes visible in the window rectangle starting at (\e x, \e y) of size \e w x \e h.
+      The projection and modelview matrices of the view should be set. The ids are rendered
+      in a framebuffer object. Without framebuffer object support, the rectangle is drawn in
+      the current color and depth buffers and the view should be redrawn afterwards. */
+  ScenePtr select( int x, int y, int w = 1, int h = 1 );
+
+  /// Returns the shapes that are not batched.
+  inline const ScenePtr& getUnbatchedShapes( ) const { return __unbatched; }
+
+  /// Returns the batches.
+  inline const std::vector<Batch>& getBatches( ) const { return __batches; }
+
+  /// Returns the number of batched triangles.
+  inline size_t getTriangleNb( ) const { return __triangleNb; }
+
+  /// Returns the number of batched vertices.
+  inline size_t getVertexNb( ) const { return __vertexNb; }
+
+  /// Returns whether vertex buffer objects are used.
+  inline bool useBufferObjects( ) const { return __buffers[0] != 0; }
+
+  /// Returns the color encoding the shape at \e position in the scene.
+  static void encodePosition( uint_t position, GLubyte * rgba );
+
+  /// Returns the position in the scene encoded by \e rgba. Returns UINT32_MAX for background.
+  static uint_t decodePosition( const GLubyte * rgba );
+
+protected:
+
+  /// Uploads the arrays in buffer objects if supported. Called at first rendering.
+  void upload( );
+
+  /// Enables the arrays and binds the buffers.
+  void bindArrays( bool colors );
+
+  /// Disables the arrays and unbinds the buffers.
+  void unbindArrays( bool colors );
+
+  /// Deletes the buffer objects if their OpenGL context is current.
+  void releaseBuffers( );
+
+  /// The batched scene.
+  ScenePtr __scene;
+
+  /// Shapes not batched.
+  ScenePtr __unbatched;
+
+  std::vector<Batch> __batches;
+
+  std::vector<float> __vertices;
+  std::vector<float> __normals;
+  std::vector<GLubyte> __colors;
+  std::vector<uint32_t> __indices;
+
+  size_t __triangleNb;
+  size_t __vertexNb;
+
+  /// Whether the arrays have been uploaded.
+  bool __uploaded;
+
+  /// Buffer objects for vertices, normals, colors and indices.
+  GLuint __buffers[4];
+
+  /// The OpenGL context in which the buffer objects were created.
+  const QGLContext * __context;
+
+  /// The buffer objects functions of this context.
+  GLBufferFunctions * __functions;
+
+};
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+// __glbatchrenderer_h__
+#endif
+
@@ -88,7 +88,7 @@ TOOLS_USING_NAMESPACE
 #define GEOM_GLRENDERER_PRECOMPILE_BEG(geom) \
     if(__compil == ePreCompileMode) { \
       if(!geom->unique()) { \
-         Cache<GLuint>::Iterator _it = __cache.find((uint_t)geom->getId()); \
+         Cache<GLuint>::Iterator _it = __cache.find(geom->getId()); \
          if (_it != __cache.end()) return true; \
          ++__precompildepth; \
       } \
@@ -288,10 +288,29 @@ void GLRenderer::clear( )
   if(__compil != -1)__compil = 0;
 }
 
+void GLRenderer::retain( const pgl_hash_set_size_t& ids )
+{
+  for (Cache<GLuint>::Iterator _it = __cache.begin(); _it != __cache.end(); _it++){
+    if (_it->second && ids.find(_it->first) == ids.end()) glDeleteLists(_it->second,1);
+  }
+  __cache.retain(ids);
+  // the scene display list has to be rebuilt but kept display lists are called from it.
+  if(__scenecache !=0){
+    glDeleteLists(__scenecache,1);
+    __scenecache = 0;
+  }
+  for (Cache<GLuint>::Iterator _it2 = __cachetexture.begin(); _it2 != __cachetexture.end(); _it2++){
+    if (_it2->second && ids.find(_it2->first) == ids.end()) glDeleteTextures(1,&(_it2->second));
+  }
+  __cachetexture.retain(ids);
+  __currentdisplaylist = false;
+  if(__compil != -1)__compil = 0;
+}
+
 
 bool GLRenderer::check(size_t id, GLuint& displaylist){
   if(__Mode != DynamicPrimitive){ 
-	Cache<GLuint>::Iterator _it = __cache.find((uint_t)id); 
+	Cache<GLuint>::Iterator _it = __cache.find(id); 
 	if (_it != __cache.end()) { 
 	  displaylist = _it->second;
 	  glCallList(displaylist); 
@@ -321,7 +340,7 @@ bool GLRenderer::check(size_t id, GLuint& displaylist){
 
 bool GLRenderer::call(size_t id){
   if(__Mode != DynamicPrimitive){ 
-	Cache<GLuint>::Iterator _it = __cache.find((uint_t)id); 
+	Cache<GLuint>::Iterator _it = __cache.find(id); 
 	if (_it != __cache.end()) { 
 	  glCallList(_it->second); 
 #ifdef GEOM_DLDEBUG
@@ -340,12 +359,17 @@ void GLRenderer::update(size_t id, GLuint displaylist){
 	  printf("End Display List %i for obj %zu\n",displaylist,id);
 #endif
 	  glEndList(); 
-	  __cache.insert((uint_t)id,displaylist); 
+	  __cache.insert(id,displaylist); 
 	  assert( glGetError( ) == GL_NO_ERROR); 
 	  __currentdisplaylist = false;
   }
 }
 
+GLuint GLRenderer::getDisplayList(size_t id){
+  Cache<GLuint>::Iterator _it = __cache.find(id); 
+  return (_it != __cache.end() ? _it->second : 0);
+}
+
 void GLRenderer::registerTexture(ImageTexture * texture, GLuint id, bool erasePreviousIfExists)
 { 
   Cache<GLuint>::Iterator it = __cachetexture.find(texture->getId());
@@ -46,6 +46,7 @@
 #include <plantgl/scenegraph/core/action.h>
 #include <plantgl/tool/rcobject.h>
 #include <plantgl/tool/util_cache.h>
+#include <plantgl/tool/util_hashset.h>
 #include <plantgl/scenegraph/appearance/appearance.h>
 
 /* ----------------------------------------------------------------------- */
@@ -113,6 +114,9 @@ public:
   /// Clears \e self.
   void clear( );
 
+  /// Removes from the cache the results of the objects whose id is not in \e ids.
+  void retain( const pgl_hash_set_size_t& ids );
+
   void init();
 
   /// Returns the Discretizer attached to \e self.
@@ -271,7 +275,11 @@ public:
   bool check(size_t id, GLuint& displaylist);
   bool call(size_t id);
   void update(size_t id, GLuint displaylist);
+  /// Returns the display list of the object identified by \e id, or 0 if it is not cached.
+  GLuint getDisplayList(size_t id);
   const AppearancePtr& getAppearanceCache() const { return __appearance; }
+  /// Forget the current material so that the next one is always applied.
+  void clearAppearanceCache() { __appearance = AppearancePtr(); }
 
   void registerTexture(ImageTexture * texture, GLuint id, bool erasePreviousIfExists = true);
   GLuint getTextureId(ImageTexture * texture);
@@ -0,0 +1,270 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+#include "bvh.h"
+
+PGL_USING_NAMESPACE
+TOOLS_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+#define BVH_BIN_NB 16
+
+/* Bounds of a set of boxes. */
+struct BVHBounds {
+  float lower[3];
+  float upper[3];
+
+  BVHBounds() { 
+    for (int i = 0; i < 3; ++i) { 
+      lower[i] = std::numeric_limits<float>::max(); 
+      upper[i] = -std::numeric_limits<float>::max(); 
+    } 
+  }
+
+  inline void extend(const float * box) {
+    for (int i = 0; i < 3; ++i) {
+      if (box[i] < lower[i]) lower[i] = box[i];
+      if (box[i+3] > upper[i]) upper[i] = box[i+3];
+    }
+  }
+
+  inline void extend(const BVHBounds& b) {
+    for (int i = 0; i < 3; ++i) {
+      if (b.lower[i] < lower[i]) lower[i] = b.lower[i];
+      if (b.upper[i] > upper[i]) upper[i] = b.upper[i];
+    }
+  }
+
+  inline void extendPoint(const float * p) {
+    for (int i = 0; i < 3; ++i) {
+      if (p[i] < lower[i]) lower[i] = p[i];
+      if (p[i] > upper[i]) upper[i] = p[i];
+    }
+  }
+
+  /// Half of the area of the box. 
+  inline float area() const {
+    if (lower[0] > upper[0]) return 0;
+    float dx = upper[0] - lower[0], dy = upper[1] - lower[1], dz = upper[2] - lower[2];
+    return dx * dy + dy * dz + dz * dx;
+  }
+};
+
+/* A primitive during the construction. Primitives are moved by the partitions 
+   so that each node reads a contiguous range of memory. */
+struct BVHPrimitive {
+  float box[6];
+  float center[3];
+  uint32_t index;
+};
+
+/* Top down construction of the hierarchy. */
+struct BVHBuilder {
+  std::vector<BVHPrimitive> items;
+  std::vector<BVH::Node>& nodes;
+  uint32_t maxLeafSize;
+
+  BVHBuilder(const std::vector<float>& boxes, std::vector<BVH::Node>& _nodes, uint32_t _maxLeafSize) :
+    nodes(_nodes), maxLeafSize(_maxLeafSize) 
+  {
+    size_t nb = boxes.size() / 6;
+    items.resize(nb);
+    for (size_t i = 0; i < nb; ++i) {
+      BVHPrimitive& item = items[i];
+      for (int j = 0; j < 6; ++j) item.box[j] = boxes[6*i+j];
+      for (int j = 0; j < 3; ++j) item.center[j] = 0.5f * (item.box[j] + item.box[j+3]);
+      item.index = uint32_t(i);
+    }
+  }
+
+  struct CenterLess {
+    int axis;
+    CenterLess(int _axis) : axis(_axis) {}
+    inline bool operator()(const BVHPrimitive& a, const BVHPrimitive& b) const { return a.center[axis] < b.center[axis]; }
+  };
+
+  struct InBins {
+    int axis;
+    float lower, scale;
+    size_t split;
+    InBins(int _axis, float _lower, float _scale, size_t _split) : 
+      axis(_axis), lower(_lower), scale(_scale), split(_split) {}
+    inline size_t bin(const BVHPrimitive& a) const { 
+      return std::min<size_t>(BVH_BIN_NB - 1, size_t((a.center[axis] - lower) * scale)); 
+    }
+    inline bool operator()(const BVHPrimitive& a) const { return bin(a) < split; }
+  };
+
+  uint32_t build(size_t begin, size_t end) {
+    uint32_t index = uint32_t(nodes.size());
+    nodes.push_back(BVH::Node());
+
+    BVHBounds bounds, centerBounds;
+    for (size_t i = begin; i < end; ++i) {
+      bounds.extend(items[i].box);
+      centerBounds.extendPoint(items[i].center);
+    }
+    for (int j = 0; j < 3; ++j) {
+      nodes[index].lower[j] = bounds.lower[j];
+      nodes[index].upper[j] = bounds.upper[j];
+    }
+
+    size_t count = end - begin;
+    if (count <= maxLeafSize) return makeLeaf(index, begin, end);
+
+    int axis = 0;
+    float extent[3];
+    for (int j = 0; j < 3; ++j) extent[j] = centerBounds.upper[j] - centerBounds.lower[j];
+    if (extent[1] > extent[axis]) axis = 1;
+    if (extent[2] > extent[axis]) axis = 2;
+
+    size_t mid = begin;
+    if (extent[axis] > 0) {
+      // Binned surface area heuristic
+      float scale = BVH_BIN_NB / extent[axis];
+      InBins binner(axis, centerBounds.lower[axis], scale, 0);
+      BVHBounds binBounds[BVH_BIN_NB];
+      size_t binCounts[BVH_BIN_NB] = { 0 };
+      for (size_t i = begin; i < end; ++i) {
+        size_t b = binner.bin(items[i]);
+        binBounds[b].extend(items[i].box);
+        ++binCounts[b];
+      }
+      float rightCosts[BVH_BIN_NB];
+      BVHBounds accu;
+      size_t accuCount = 0;
+      for (size_t b = BVH_BIN_NB - 1; b > 0; --b) {
+        accu.extend(binBounds[b]);
+        accuCount += binCounts[b];
+        rightCosts[b] = accu.area() * accuCount;
+      }
+      accu = BVHBounds();
+      accuCount = 0;
+      float bestCost = std::numeric_limits<float>::max();
+      size_t bestSplit = 0;
+      for (size_t b = 1; b < BVH_BIN_NB; ++b) {
+        accu.extend(binBounds[b-1]);
+        accuCount += binCounts[b-1];
+        if (accuCount == 0 || accuCount == count) continue;
+        float cost = accu.area() * accuCount + rightCosts[b];
+        if (cost < bestCost) { bestCost = cost; bestSplit = b; }
+      }
+      if (bestSplit > 0) {
+        if (count <= 4 * maxLeafSize && bestCost >= bounds.area() * count) 
+          return makeLeaf(index, begin, end);
+        binner.split = bestSplit;
+        mid = std::partition(items.begin() + begin, items.begin() + end, binner) - items.begin();
+      }
+    }
+    if (mid == begin || mid == end) {
+      // Median split when the heuristic cannot separate the primitives
+      mid = (begin + end) / 2;
+      std::nth_element(items.begin() + begin, items.begin() + mid, items.begin() + end, CenterLess(axis));
+    }
+
+    build(begin, mid);
+    uint32_t second = build(mid, end);
+    nodes[index].offset = second;
+    nodes[index].count = 0;
+    return index;
+  }
+
+  uint32_t makeLeaf(uint32_t index, size_t begin, size_t end) {
+    nodes[index].offset = uint32_t(begin);
+    nodes[index].count = uint32_t(end - begin);
+    return index;
+  }
+};
+
+/* ----------------------------------------------------------------------- */
+
+BVH::BVH( uint32_t maxLeafSize ) :
+  __maxLeafSize(maxLeafSize > 0 ? maxLeafSize : 1)
+{
+}
+
+BVH::~BVH( )
+{
+}
+
+void BVH::clear( )
+{
+  std::vector<Node>().swap(__nodes);
+  std::vector<uint32_t>().swap(__primitives);
+}
+
+void BVH::build( const std::vector<float>& boxes )
+{
+  clear();
+  size_t nb = boxes.size() / 6;
+  if (nb == 0) return;
+  __nodes.reserve(2 * (nb / __maxLeafSize + 1));
+  BVHBuilder builder(boxes, __nodes, __maxLeafSize);
+  builder.build(0, nb);
+  __primitives.resize(nb);
+  for (size_t i = 0; i < nb; ++i) __primitives[i] = builder.items[i].index;
+}
+
+size_t BVH::getDepth( ) const
+{
+  if (__nodes.empty()) return 0;
+  size_t depth = 0;
+  std::vector<std::pair<uint32_t,size_t> > stack;
+  stack.push_back(std::pair<uint32_t,size_t>(0,1));
+  while (!stack.empty()) {
+    std::pair<uint32_t,size_t> next = stack.back();
+    stack.pop_back();
+    if (next.second > depth) depth = next.second;
+    const Node& node = __nodes[next.first];
+    if (!node.isLeaf()) {
+      stack.push_back(std::pair<uint32_t,size_t>(next.first+1,next.second+1));
+      stack.push_back(std::pair<uint32_t,size_t>(node.offset,next.second+1));
+    }
+  }
+  return depth;
+}
+
+Vector3 BVH::getLowerCorner( ) const
+{
+  if (__nodes.empty()) return Vector3::ORIGIN;
+  return Vector3(__nodes[0].lower[0], __nodes[0].lower[1], __nodes[0].lower[2]);
+}
+
+Vector3 BVH::getUpperCorner( ) const
+{
+  if (__nodes.empty()) return Vector3::ORIGIN;
+  return Vector3(__nodes[0].upper[0], __nodes[0].upper[1], __nodes[0].upper[2]);
+}
+
+/* ----------------------------------------------------------------------- */
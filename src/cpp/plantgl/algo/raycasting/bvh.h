@@ -0,0 +1,257 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+/*! \file bvh.h
+    \brief A bounding volume hierarchy over axis aligned boxes.
+*/
+
+#ifndef __bvh_h__
+#define __bvh_h__
+
+#include "../algo_config.h"
+#include <plantgl/math/util_vector.h>
+#include <plantgl/tool/util_types.h>
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/**
+   \class BVH
+   \brief A bounding volume hierarchy over a set of primitives given by their boxes.
+
+   The tree is built with a binned surface area heuristic and stored as a flat array
+   of nodes in depth first order: the first child of an inner node follows it in the array.
+   Primitives are only known by their index. Tests on the primitives themselves are
+   done by the functors given to the traversals.
+*/
+class ALGO_API BVH
+{
+
+public:
+
+  /// A node of the hierarchy. 32 bytes.
+  struct Node {
+    float lower[3];
+    float upper[3];
+    /// For a leaf, position of its first primitive. For an inner node, index of its second child.
+    uint32_t offset;
+    /// Number of primitives of a leaf. 0 for an inner node.
+    uint32_t count;
+
+    inline bool isLeaf() const { return count != 0; }
+  };
+
+  /// Location of a box relatively to a volume, as returned by the classifiers of traverse.
+  enum Location { Outside = 0, Intersecting = 1, Inside = 2 };
+
+  /// Constructs an empty BVH. Leaves contain at most \e maxLeafSize primitives.
+  BVH( uint32_t maxLeafSize = 4 );
+
+  /// Destructor.
+  ~BVH( );
+
+  /** Builds the hierarchy over the boxes of the primitives.
+      \e boxes contains 6 values per primitive: xmin, ymin, zmin, xmax, ymax, zmax. */
+  void build( const std::vector<float>& boxes );
+
+  /// Clears \e self.
+  void clear( );
+
+  /// Returns whether \e self contains no primitive.
+  inline bool empty( ) const { return __nodes.empty(); }
+
+  /// Returns the number of primitives.
+  inline size_t size( ) const { return __primitives.size(); }
+
+  /// Returns the nodes.
+  inline const std::vector<Node>& getNodes( ) const { return __nodes; }
+
+  /// Returns the indices of the primitives in the order of the leaves.
+  inline const std::vector<uint32_t>& getPrimitives( ) const { return __primitives; }
+
+  /// Returns the depth of the tree.
+  size_t getDepth( ) const;
+
+  /// Returns the lower corner of the box of the whole hierarchy.
+  TOOLS(Vector3) getLowerCorner( ) const;
+
+  /// Returns the upper corner of the box of the whole hierarchy.
+  TOOLS(Vector3) getUpperCorner( ) const;
+
+  /** Returns the entry distance of the ray (\e origin, \e invdir) in \e node if it is before \e tmax.
+      \e invdir contains the inverse of the coordinates of the direction of the ray.
+      Returns a negative value if the ray misses the node. */
+  static inline real_t entry( const Node& node, const real_t * origin, const real_t * invdir, real_t tmax );
+
+  /** Finds the nearest primitive hit by the ray (\e origin, \e direction) before \e tmax.
+      Leaves are visited front to back and nodes farther than the nearest hit are skipped.
+      \e intersector is called as <tt>bool intersector(uint32_t primitive, real_t& tmax)</tt>
+      and should return true and decrease \e tmax if the primitive is hit before \e tmax.
+      Returns whether a primitive has been hit. \e tmax is then the distance of the nearest hit. */
+  template<class Intersector>
+  bool intersect( const TOOLS(Vector3)& origin, const TOOLS(Vector3)& direction,
+                  real_t& tmax, Intersector& intersector ) const;
+
+  /// Stack of the nodes to visit with their entry distance.
+  typedef std::vector<std::pair<uint32_t,real_t> > TraversalStack;
+
+  /** Same as above with a \e stack given by the caller, that can be reused 
+      to avoid allocations when casting many rays. */
+  template<class Intersector>
+  bool intersect( const TOOLS(Vector3)& origin, const TOOLS(Vector3)& direction,
+                  real_t& tmax, Intersector& intersector, TraversalStack& stack ) const;
+
+  /** Visits the primitives in the volume defined by \e classifier.
+      \e classifier is called as <tt>Location classifier(const Node& node)</tt> for each node.
+      \e visitor is called as <tt>bool visitor(uint32_t primitive, bool inside)</tt> for the primitives
+      of the leaves that are not outside, \e inside being true if the leaf is completely inside the volume.
+      The traversal stops as soon as \e visitor returns false. */
+  template<class Classifier, class Visitor>
+  void traverse( Classifier& classifier, Visitor& visitor ) const;
+
+protected:
+
+  std::vector<Node> __nodes;
+  std::vector<uint32_t> __primitives;
+  uint32_t __maxLeafSize;
+
+};
+
+/* ----------------------------------------------------------------------- */
+
+real_t BVH::entry( const Node& node, const real_t * origin, const real_t * invdir, real_t tmax )
+{
+  real_t tmin = 0;
+  for (int i = 0; i < 3; ++i) {
+    real_t t0 = (node.lower[i] - origin[i]) * invdir[i];
+    real_t t1 = (node.upper[i] - origin[i]) * invdir[i];
+    if (t0 > t1) std::swap(t0, t1);
+    if (t0 > tmin) tmin = t0;
+    if (t1 < tmax) tmax = t1;
+    if (tmin > tmax) return -1;
+  }
+  return tmin;
+}
+
+template<class Intersector>
+bool BVH::intersect( const TOOLS(Vector3)& origin, const TOOLS(Vector3)& direction,
+                     real_t& tmax, Intersector& intersector ) const
+{
+  TraversalStack stack;
+  stack.reserve(64);
+  return intersect(origin, direction, tmax, intersector, stack);
+}
+
+template<class Intersector>
+bool BVH::intersect( const TOOLS(Vector3)& origin, const TOOLS(Vector3)& direction,
+                     real_t& tmax, Intersector& intersector, TraversalStack& stack ) const
+{
+  if (__nodes.empty()) return false;
+  real_t o[3] = { origin.x(), origin.y(), origin.z() };
+  real_t invdir[3];
+  for (int i = 0; i < 3; ++i) {
+    real_t d = direction[i];
+    invdir[i] = (d != 0 ? 1 / d : (d < 0 ? -1 : 1) * std::numeric_limits<real_t>::max());
+  }
+  if (entry(__nodes[0], o, invdir, tmax) < 0) return false;
+
+  bool hit = false;
+  stack.clear();
+  stack.push_back(std::pair<uint32_t,real_t>(0,0));
+  while (!stack.empty()) {
+    std::pair<uint32_t,real_t> next = stack.back();
+    stack.pop_back();
+    if (next.second > tmax) continue;
+    const Node * node = &__nodes[next.first];
+    while (!node->isLeaf()) {
+      uint32_t first = uint32_t(node - &__nodes[0]) + 1, second = node->offset;
+      real_t d1 = entry(__nodes[first], o, invdir, tmax);
+      real_t d2 = entry(__nodes[second], o, invdir, tmax);
+      if (d1 < 0 && d2 < 0) { node = NULL; break; }
+      if (d1 < 0) { node = &__nodes[second]; continue; }
+      if (d2 < 0) { node = &__nodes[first]; continue; }
+      // Visits the nearest child first
+      if (d2 < d1) { std::swap(first, second); std::swap(d1, d2); }
+      stack.push_back(std::pair<uint32_t,real_t>(second,d2));
+      node = &__nodes[first];
+    }
+    if (node == NULL) continue;
+    for (uint32_t i = node->offset; i < node->offset + node->count; ++i)
+      if (intersector(__primitives[i], tmax)) hit = true;
+  }
+  return hit;
+}
+
+template<class Classifier, class Visitor>
+void BVH::traverse( Classifier& classifier, Visitor& visitor ) const
+{
+  if (__nodes.empty()) return;
+  // Nodes to visit with whether they are known to be inside
+  std::vector<std::pair<uint32_t,bool> > stack;
+  stack.reserve(64);
+  stack.push_back(std::pair<uint32_t,bool>(0,false));
+  while (!stack.empty()) {
+    uint32_t index = stack.back().first;
+    bool inside = stack.back().second;
+    stack.pop_back();
+    const Node& node = __nodes[index];
+    if (!inside) {
+      Location location = Location(classifier(node));
+      if (location == Outside) continue;
+      inside = (location == Inside);
+    }
+    if (node.isLeaf()) {
+      for (uint32_t i = node.offset; i < node.offset + node.count; ++i)
+        if (!visitor(__primitives[i], inside)) return;
+    }
+    else {
+      stack.push_back(std::pair<uint32_t,bool>(node.offset,inside));
+      stack.push_back(std::pair<uint32_t,bool>(index+1,inside));
+    }
+  }
+}
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+// __bvh_h__
+#endif
@@ -0,0 +1,340 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+#include "lidarscanner.h"
+#include <plantgl/tool/util_parallel.h>
+#include <plantgl/tool/util_random.h>
+#include <plantgl/tool/errormsg.h>
+#include <plantgl/math/util_math.h>
+
+PGL_USING_NAMESPACE
+TOOLS_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+#define PARALLEL_GRAIN 1024
+// Number of pulses emitted before their returns are appended to the results.
+#define PULSE_BATCH (1 << 22)
+
+/* ----------------------------------------------------------------------- */
+
+/* Unit vectors u and v orthogonal to the unit vector d. */
+static inline void orthogonal_basis( const Vector3& d, Vector3& u, Vector3& v )
+{
+  if (fabs(d.x()) < 0.9) u = Vector3(0, d.z(), -d.y());
+  else u = Vector3(-d.z(), 0, d.x());
+  u.normalize();
+  v = cross(d, u);
+}
+
+/* A ray of a pulse that hit a triangle. */
+struct BeamHit {
+  real_t distance;
+  real_t energy;
+  uint32_t shape;
+  bool operator<( const BeamHit& other ) const { return distance < other.distance; }
+};
+
+/* A return of a pulse. */
+struct LidarReturn {
+  Vector3 point;
+  uint_t shapeId;
+  real_t intensity;
+  uint32_t number;
+  uint32_t count;
+  uint32_t scan;
+};
+
+/* Emission of a range of pulses. */
+struct PulseEmitter {
+  const TriangleBVH * triangles;
+  const std::vector<LidarScanner::Scan> * scans;
+  /// First pulse of each scan, with the total number of pulses at the end.
+  const std::vector<size_t> * scanOffsets;
+  size_t firstPulse;
+  real_t resolution;
+  uint32_t seed;
+  real_t beamRadius;
+  uint32_t beamSamples;
+  real_t returnSeparation;
+  uint32_t maxReturns;
+  real_t maxRange;
+  real_t rangeNoise;
+  real_t angularNoise;
+
+  /// Returns of the pulses, by chunk.
+  std::vector<std::vector<LidarReturn> > * returns;
+
+  // Origin and nominal direction of the pulse of the scan at column col and row row.
+  inline void pulse( const LidarScanner::Scan& scan, uint32_t col, uint32_t row, Vector3& origin, Vector3& direction ) const {
+    if (!scan.airborne) {
+      real_t azimuth = scan.firstAngle[0] + col * resolution;
+      real_t elevation = scan.firstAngle[1] + row * resolution;
+      origin = scan.start;
+      direction = Vector3(cos(elevation) * cos(azimuth), cos(elevation) * sin(azimuth), sin(elevation));
+    }
+    else {
+      Vector3 track = scan.end - scan.start;
+      real_t length = norm(track);
+      track /= length;
+      Vector3 side = cross(track, Vector3::OZ);
+      side.normalize();
+      real_t angle = scan.firstAngle[1] + row * resolution;
+      origin = scan.start + track * std::min<real_t>(col * (length / std::max<uint32_t>(scan.size[0] - 1, 1)), length);
+      direction = Vector3(0, 0, -cos(angle)) + side * sin(angle);
+    }
+  }
+
+  void operator()( size_t begin, size_t end, size_t chunk ) {
+    std::vector<LidarReturn>& chunkReturns = (*returns)[chunk];
+    BVH::TraversalStack stack;
+    stack.reserve(64);
+    std::vector<BeamHit> hits;
+    hits.reserve(beamSamples);
+    size_t s = 0;
+    size_t pulseIndex = firstPulse + begin;
+    while ((*scanOffsets)[s+1] <= pulseIndex) ++s;
+    for (size_t p = begin; p < end; ++p, ++pulseIndex) {
+      while ((*scanOffsets)[s+1] <= pulseIndex) ++s;
+      const LidarScanner::Scan& scan = (*scans)[s];
+      size_t local = pulseIndex - (*scanOffsets)[s];
+      uint32_t col = uint32_t(local / scan.size[1]), row = uint32_t(local % scan.size[1]);
+      Vector3 origin, nominal;
+      pulse(scan, col, row, origin, nominal);
+      CounterRandom random(seed, pulseIndex);
+
+      // The actual direction of the pulse deviates from its nominal one.
+      Vector3 u, v, direction = nominal;
+      orthogonal_basis(nominal, u, v);
+      if (angularNoise > 0) {
+        direction += u * random.normal(0, angularNoise) + v * random.normal(0, angularNoise);
+        direction.normalize();
+        orthogonal_basis(direction, u, v);
+      }
+
+      // Rays in the cone of the beam.
+      hits.clear();
+      uint32_t nbrays = (beamRadius > 0 ? std::max<uint32_t>(beamSamples, 1) : 1);
+      real_t rayEnergy = real_t(1) / nbrays;
+      for (uint32_t r = 0; r < nbrays; ++r) {
+        Vector3 raydir = direction;
+        if (nbrays > 1) {
+          real_t radius = beamRadius * sqrt(random.uniform()), angle = GEOM_TWO_PI * random.uniform();
+          raydir += u * (radius * cos(angle)) + v * (radius * sin(angle));
+          raydir.normalize();
+        }
+        real_t distance = maxRange;
+        uint32_t triangle = triangles->intersect(origin, raydir, distance, stack);
+        if (triangle == UINT32_MAX) continue;
+        BeamHit hit;
+        hit.distance = distance;
+        hit.energy = rayEnergy * fabs(dot(triangles->getNormal(triangle), raydir));
+        hit.shape = triangle;
+        hits.push_back(hit);
+      }
+      if (hits.empty()) continue;
+      std::sort(hits.begin(), hits.end());
+
+      // Grouping of the hits into returns.
+      size_t firstReturn = chunkReturns.size();
+      std::vector<BeamHit>::const_iterator it = hits.begin();
+      while (it != hits.end() && chunkReturns.size() - firstReturn < maxReturns) {
+        std::vector<BeamHit>::const_iterator last = it;
+        real_t energy = 0, weighted = 0, distances = 0;
+        uint32_t nbhits = 0;
+        const BeamHit * main = &*it;
+        for (; last != hits.end() && (last == it || last->distance - (last-1)->distance <= returnSeparation); ++last) {
+          energy += last->energy;
+          weighted += last->energy * last->distance;
+          distances += last->distance;
+          ++nbhits;
+          if (last->energy > main->energy) main = &*last;
+        }
+        real_t distance = (energy > 0 ? weighted / energy : distances / nbhits);
+        if (rangeNoise > 0) distance += random.normal(0, rangeNoise);
+        LidarReturn result;
+        result.point = origin + nominal * distance;
+        result.shapeId = triangles->getShapeId(main->shape);
+        result.intensity = energy;
+        result.number = uint32_t(chunkReturns.size() - firstReturn + 1);
+        result.scan = uint32_t(s);
+        chunkReturns.push_back(result);
+        it = last;
+      }
+      uint32_t count = uint32_t(chunkReturns.size() - firstReturn);
+      for (size_t i = firstReturn; i < chunkReturns.size(); ++i) chunkReturns[i].count = count;
+    }
+  }
+};
+
+/* ----------------------------------------------------------------------- */
+
+LidarScanner::LidarScanner( real_t angularResolution, uint32_t seed ) :
+  __angularResolution(angularResolution),
+  __seed(seed),
+  __beamDivergence(0),
+  __beamSampleCount(16),
+  __returnSeparation(0.5),
+  __maxReturns(4),
+  __maxRange(REAL_MAX),
+  __rangeNoise(0),
+  __angularNoise(0)
+{
+}
+
+LidarScanner::~LidarScanner( )
+{
+}
+
+void LidarScanner::addTerrestrialScan( const Vector3& position, 
+                                       real_t azimuthMin, real_t azimuthMax,
+                                       real_t elevationMin, real_t elevationMax )
+{
+  if (__angularResolution <= 0 || azimuthMax < azimuthMin || elevationMax < elevationMin) {
+    pglError("Invalid angles of terrestrial scan.");
+    return;
+  }
+  Scan scan;
+  scan.airborne = false;
+  scan.start = position;
+  scan.end = position;
+  scan.firstAngle[0] = azimuthMin; scan.lastAngle[0] = azimuthMax;
+  scan.firstAngle[1] = elevationMin; scan.lastAngle[1] = elevationMax;
+  // A full turn does not emit twice in the same direction.
+  real_t azimuthRange = azimuthMax - azimuthMin;
+  if (azimuthRange >= GEOM_TWO_PI) scan.size[0] = std::max<uint32_t>(uint32_t(GEOM_TWO_PI / __angularResolution), 1);
+  else scan.size[0] = uint32_t(azimuthRange / __angularResolution) + 1;
+  scan.size[1] = uint32_t((elevationMax - elevationMin) / __angularResolution) + 1;
+  __scans.push_back(scan);
+}
+
+void LidarScanner::addAirborneScan( const Vector3& start, const Vector3& end, 
+                                    real_t scanAngle, real_t lineSpacing )
+{
+  Vector3 track = end - start;
+  if (__angularResolution <= 0 || lineSpacing <= 0 || scanAngle < 0 || norm(cross(track, Vector3::OZ)) <= 0) {
+    pglError("Invalid airborne scan. Flight line should not be vertical.");
+    return;
+  }
+  Scan scan;
+  scan.airborne = true;
+  scan.start = start;
+  scan.end = end;
+  scan.firstAngle[0] = 0; scan.lastAngle[0] = 0;
+  scan.firstAngle[1] = -scanAngle; scan.lastAngle[1] = scanAngle;
+  scan.size[0] = uint32_t(norm(track) / lineSpacing) + 1;
+  scan.size[1] = uint32_t(2 * scanAngle / __angularResolution) + 1;
+  __scans.push_back(scan);
+}
+
+void LidarScanner::clearScans( )
+{
+  __scans.clear();
+}
+
+size_t LidarScanner::getPulseCount( ) const
+{
+  size_t count = 0;
+  for (std::vector<Scan>::const_iterator it = __scans.begin(); it != __scans.end(); ++it)
+    count += size_t(it->size[0]) * it->size[1];
+  return count;
+}
+
+void LidarScanner::clear( )
+{
+  __points = Point3ArrayPtr(new Point3Array());
+  __shapeIds = Uint32Array1Ptr(new Uint32Array1());
+  __intensities = RealArrayPtr(new RealArray());
+  __returnNumbers = Uint32Array1Ptr(new Uint32Array1());
+  __returnCounts = Uint32Array1Ptr(new Uint32Array1());
+  __scanIds = Uint32Array1Ptr(new Uint32Array1());
+}
+
+bool LidarScanner::process( const ScenePtr& scene )
+{
+  clear();
+  if (__scans.empty()) return false;
+  TriangleBVH triangles;
+  if (!triangles.build(scene)) return false;
+
+  std::vector<size_t> scanOffsets(1, 0);
+  for (std::vector<Scan>::const_iterator it = __scans.begin(); it != __scans.end(); ++it)
+    scanOffsets.push_back(scanOffsets.back() + size_t(it->size[0]) * it->size[1]);
+  size_t nbPulses = scanOffsets.back();
+
+  PulseEmitter emitter;
+  emitter.triangles = &triangles;
+  emitter.scans = &__scans;
+  emitter.scanOffsets = &scanOffsets;
+  emitter.resolution = __angularResolution;
+  emitter.seed = __seed;
+  emitter.beamRadius = tan(__beamDivergence / 2);
+  emitter.beamSamples = __beamSampleCount;
+  emitter.returnSeparation = __returnSeparation;
+  emitter.maxReturns = std::max<uint32_t>(__maxReturns, 1);
+  emitter.maxRange = __maxRange;
+  emitter.rangeNoise = __rangeNoise;
+  emitter.angularNoise = __angularNoise;
+
+  // Pulses are emitted by batches whose returns are appended to the results in order.
+  for (size_t first = 0; first < nbPulses; first += PULSE_BATCH) {
+    size_t batch = std::min<size_t>(PULSE_BATCH, nbPulses - first);
+    std::vector<std::vector<LidarReturn> > returns(parallel_chunk_count(batch, PARALLEL_GRAIN));
+    emitter.firstPulse = first;
+    emitter.returns = &returns;
+    parallel_for(batch, emitter, PARALLEL_GRAIN);
+
+    size_t nbReturns = __points->size();
+    for (size_t c = 0; c < returns.size(); ++c) nbReturns += returns[c].size();
+    __points->reserve(nbReturns);
+    __shapeIds->reserve(nbReturns);
+    __intensities->reserve(nbReturns);
+    __returnNumbers->reserve(nbReturns);
+    __returnCounts->reserve(nbReturns);
+    __scanIds->reserve(nbReturns);
+    for (size_t c = 0; c < returns.size(); ++c) {
+      for (std::vector<LidarReturn>::const_iterator it = returns[c].begin(); it != returns[c].end(); ++it) {
+        __points->push_back(it->point);
+        __shapeIds->push_back(it->shapeId);
+        __intensities->push_back(it->intensity);
+        __returnNumbers->push_back(it->number);
+        __returnCounts->push_back(it->count);
+        __scanIds->push_back(it->scan);
+      }
+      std::vector<LidarReturn>().swap(returns[c]);
+    }
+  }
+  return true;
+}
+
+/* ----------------------------------------------------------------------- */
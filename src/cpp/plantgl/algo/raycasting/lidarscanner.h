@@ -0,0 +1,204 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+/*! \file lidarscanner.h
+    \brief Definition of LidarScanner.
+*/
+
+#ifndef __lidarscanner_h__
+#define __lidarscanner_h__
+
+#include "trianglebvh.h"
+#include <plantgl/scenegraph/container/pointarray.h>
+#include <plantgl/tool/util_array.h>
+#include <plantgl/math/util_math.h>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/**
+   \class LidarScanner
+   \brief Simulation of terrestrial and airborne LiDAR scans of a scene.
+
+   A terrestrial scan emits pulses from a fixed position on a grid of azimuths and elevations.
+   An airborne scan emits pulses from positions regularly spaced along a flight line, each
+   position sweeping the scene across the track.
+
+   The divergence of the beam is simulated by casting several rays randomly distributed in
+   the cone of the beam. The hits of the rays are sorted by distance and grouped into returns
+   when they are closer than the return separation. Each return gives a point on the nominal
+   direction of the pulse, at the mean distance of its hits, with the shape that contributes
+   most to it. Its intensity is the fraction of the energy of the beam it reflects, weighted
+   by the cosine of the incidence on the triangles.
+
+   Pulses are emitted in parallel on a TriangleBVH and the random numbers of a pulse only
+   depend on its index and the seed, so that scans do not depend on the number of threads.
+*/
+class ALGO_API LidarScanner
+{
+
+public:
+
+  /// Constructs a scanner with an angular step between pulses of \e angularResolution, in radians.
+  LidarScanner( real_t angularResolution = 0.001, uint32_t seed = 0 );
+
+  /// Destructor.
+  ~LidarScanner( );
+
+  /** Adds a terrestrial scan from \e position, from \e azimuthMin to \e azimuthMax and
+      from \e elevationMin to \e elevationMax. Angles are in radians, azimuths are 
+      counterclockwise from the x axis and elevations are above the horizontal plane. */
+  void addTerrestrialScan( const TOOLS(Vector3)& position, 
+                           real_t azimuthMin = 0, real_t azimuthMax = GEOM_TWO_PI,
+                           real_t elevationMin = -GEOM_HALF_PI / 2, real_t elevationMax = GEOM_HALF_PI );
+
+  /** Adds an airborne scan along the flight line from \e start to \e end, with pulse positions 
+      separated by \e lineSpacing. From each position, the scanner sweeps downward across the track
+      from -\e scanAngle to \e scanAngle, in radians. */
+  void addAirborneScan( const TOOLS(Vector3)& start, const TOOLS(Vector3)& end, 
+                        real_t scanAngle = GEOM_PI / 6, real_t lineSpacing = 0.1 );
+
+  /// Removes all the scans.
+  void clearScans( );
+
+  /// Returns the number of scans.
+  inline size_t getScanCount( ) const { return __scans.size(); }
+
+  /// Returns the number of pulses of all the scans.
+  size_t getPulseCount( ) const;
+
+  inline real_t getAngularResolution( ) const { return __angularResolution; }
+  inline void setAngularResolution( real_t value ) { __angularResolution = value; }
+
+  /// Full angle of the cone of the beam, in radians.
+  inline real_t getBeamDivergence( ) const { return __beamDivergence; }
+  inline void setBeamDivergence( real_t value ) { __beamDivergence = value; }
+
+  /// Number of rays cast for each pulse when the beam diverges.
+  inline uint32_t getBeamSampleCount( ) const { return __beamSampleCount; }
+  inline void setBeamSampleCount( uint32_t value ) { __beamSampleCount = value; }
+
+  /// Minimal distance between two returns of a pulse.
+  inline real_t getReturnSeparation( ) const { return __returnSeparation; }
+  inline void setReturnSeparation( real_t value ) { __returnSeparation = value; }
+
+  /// Maximal number of returns of a pulse.
+  inline uint32_t getMaxReturns( ) const { return __maxReturns; }
+  inline void setMaxReturns( uint32_t value ) { __maxReturns = value; }
+
+  inline real_t getMaxRange( ) const { return __maxRange; }
+  inline void setMaxRange( real_t value ) { __maxRange = value; }
+
+  /// Standard deviation of the gaussian noise on the distances.
+  inline real_t getRangeNoise( ) const { return __rangeNoise; }
+  inline void setRangeNoise( real_t value ) { __rangeNoise = value; }
+
+  /// Standard deviation of the gaussian noise on the directions of the pulses, in radians.
+  inline real_t getAngularNoise( ) const { return __angularNoise; }
+  inline void setAngularNoise( real_t value ) { __angularNoise = value; }
+
+  inline uint32_t getSeed( ) const { return __seed; }
+  inline void setSeed( uint32_t value ) { __seed = value; }
+
+  /// Scans \e scene. Returns false if \e scene has no triangle or if there is no scan.
+  bool process( const ScenePtr& scene );
+
+  /// Clears the results.
+  void clear( );
+
+  /// Returns the points of all the returns, scan after scan and pulse after pulse.
+  inline const Point3ArrayPtr& getPoints( ) const { return __points; }
+
+  /// Returns the id of the shape of each point.
+  inline const TOOLS(Uint32Array1Ptr)& getShapeIds( ) const { return __shapeIds; }
+
+  /// Returns the intensity of each point.
+  inline const TOOLS(RealArrayPtr)& getIntensities( ) const { return __intensities; }
+
+  /// Returns the number of the return of each point in its pulse, starting at 1.
+  inline const TOOLS(Uint32Array1Ptr)& getReturnNumbers( ) const { return __returnNumbers; }
+
+  /// Returns the number of returns of the pulse of each point.
+  inline const TOOLS(Uint32Array1Ptr)& getReturnCounts( ) const { return __returnCounts; }
+
+  /// Returns the scan of each point.
+  inline const TOOLS(Uint32Array1Ptr)& getScanIds( ) const { return __scanIds; }
+
+  /// A scan, as a grid of pulses.
+  struct Scan {
+    bool airborne;
+    /// Position of a terrestrial scanner or start of a flight line.
+    TOOLS(Vector3) start;
+    /// End of a flight line.
+    TOOLS(Vector3) end;
+    /// Range of the angles of the columns and rows of pulses.
+    real_t firstAngle[2];
+    real_t lastAngle[2];
+    /// Number of columns and rows of pulses.
+    uint32_t size[2];
+  };
+
+protected:
+
+  real_t __angularResolution;
+  uint32_t __seed;
+  real_t __beamDivergence;
+  uint32_t __beamSampleCount;
+  real_t __returnSeparation;
+  uint32_t __maxReturns;
+  real_t __maxRange;
+  real_t __rangeNoise;
+  real_t __angularNoise;
+
+  std::vector<Scan> __scans;
+
+  Point3ArrayPtr __points;
+  TOOLS(Uint32Array1Ptr) __shapeIds;
+  TOOLS(RealArrayPtr) __intensities;
+  TOOLS(Uint32Array1Ptr) __returnNumbers;
+  TOOLS(Uint32Array1Ptr) __returnCounts;
+  TOOLS(Uint32Array1Ptr) __scanIds;
+
+};
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+// __lidarscanner_h__
+#endif
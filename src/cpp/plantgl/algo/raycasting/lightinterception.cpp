@@ -0,0 +1,352 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+#include "lightinterception.h"
+#include <plantgl/tool/util_parallel.h>
+#include <plantgl/tool/util_random.h>
+#include <plantgl/tool/errormsg.h>
+#include <plantgl/math/util_math.h>
+
+PGL_USING_NAMESPACE
+TOOLS_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+#define PARALLEL_GRAIN 4096
+
+/* ----------------------------------------------------------------------- */
+
+/* Elevations (in degrees) of the bands of the turtle with 46 sectors, with their number of sectors. */
+static const real_t TURTLE46_ELEVATIONS[8] = { 9.23, 10.81, 26.57, 31.08, 47.41, 52.62, 69.16, 90 };
+static const uint32_t TURTLE46_BANDSIZES[8] = { 10, 5, 5, 10, 5, 5, 5, 1 };
+
+/* Azimuths (in degrees) of the sectors of the turtle, band after band. */
+static const real_t TURTLE46_AZIMUTHS[46] = { 
+  12.23, 59.77, 84.23, 131.77, 156.23, 203.77, 228.23, 275.77, 300.23, 347.77,
+  36, 108, 180, 252, 324,
+  0, 72, 144, 216, 288,
+  23.27, 48.73, 95.27, 120.73, 167.27, 192.73, 239.27, 264.73, 311.27, 336.73,
+  0, 72, 144, 216, 288,
+  36, 108, 180, 252, 324,
+  0, 72, 144, 216, 288,
+  180 };
+
+/* ----------------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------------- */
+
+/* A bundle of parallel rays cast from a grid of cells on the top plane. */
+struct RayBundle {
+  /// Direction of the rays, pointing down.
+  real_t direction[3];
+  /// Lower corner and size of the cells of the grid.
+  real_t lower[2];
+  real_t cellsize[2];
+  uint32_t nbcells[2];
+  /// Energy of each ray.
+  real_t energy;
+  /// Index of the first row of the bundle in all the rows.
+  size_t firstRow;
+};
+
+/* Cast the rows of rays of the bundles. */
+struct RayCaster {
+  const TriangleBVH * triangles;
+  const std::vector<RayBundle> * bundles;
+  uint32_t seed;
+  real_t ztop;
+  real_t zbottom;
+  bool periodic;
+  real_t domainLower[2];
+  real_t domainUpper[2];
+  /// Translations of the pattern whose shapes may be in the domain.
+  const std::vector<std::pair<real_t,real_t> > * offsets;
+
+  /// Energy intercepted by each shape, by chunk.
+  std::vector<std::vector<real_t> > * energies;
+  std::vector<real_t> * transmitted;
+
+  // Cast the ray (origin, direction) before tmax. Returns the triangle hit or UINT32_MAX.
+  inline uint32_t cast( const Vector3& origin, const Vector3& direction, real_t& tmax, BVH::TraversalStack& stack ) const {
+    if (!periodic) return triangles->intersect(origin, direction, tmax, stack);
+    uint32_t hit = UINT32_MAX;
+    for (std::vector<std::pair<real_t,real_t> >::const_iterator it = offsets->begin(); it != offsets->end(); ++it) {
+      uint32_t offsethit = triangles->intersect(Vector3(origin.x() - it->first, origin.y() - it->second, origin.z()), 
+                                                direction, tmax, stack);
+      if (offsethit != UINT32_MAX) hit = offsethit;
+    }
+    return hit;
+  }
+
+  // Follow the ray from origin, through the periodic domain if needed, until it hits a triangle or the bottom.
+  inline uint32_t trace( Vector3 origin, const Vector3& direction, BVH::TraversalStack& stack ) const {
+    real_t d[3] = { direction.x(), direction.y(), direction.z() };
+    for (;;) {
+      real_t tbottom = (zbottom - origin.z()) / d[2];
+      real_t tmax = tbottom;
+      int exitaxis = -1;
+      if (periodic) {
+        for (int j = 0; j < 2; ++j) {
+          if (d[j] == 0) continue;
+          real_t texit = ((d[j] > 0 ? domainUpper[j] : domainLower[j]) - origin[j]) / d[j];
+          if (texit < tmax) { tmax = texit; exitaxis = j; }
+        }
+      }
+      uint32_t hit = cast(origin, direction, tmax, stack);
+      if (hit != UINT32_MAX || exitaxis < 0) return hit;
+      // The ray enters the neighboring pattern, seen as the domain itself.
+      origin += direction * tmax;
+      for (int j = 0; j < 2; ++j) {
+        if (j == exitaxis || (d[j] > 0 && origin[j] >= domainUpper[j]) || (d[j] < 0 && origin[j] <= domainLower[j]))
+          origin[j] = (d[j] > 0 ? domainLower[j] : domainUpper[j]);
+      }
+    }
+  }
+
+  void operator()( size_t begin, size_t end, size_t chunk ) {
+    std::vector<real_t>& chunkEnergies = (*energies)[chunk];
+    real_t& chunkTransmitted = (*transmitted)[chunk];
+    BVH::TraversalStack stack;
+    stack.reserve(64);
+    // The bundle of the first row.
+    size_t b = 0;
+    while (b + 1 < bundles->size() && (*bundles)[b+1].firstRow <= begin) ++b;
+    for (size_t row = begin; row < end; ++row) {
+      while ((*bundles)[b].firstRow + (*bundles)[b].nbcells[1] <= row) ++b;
+      const RayBundle& bundle = (*bundles)[b];
+      Vector3 direction(bundle.direction[0], bundle.direction[1], bundle.direction[2]);
+      uint32_t y = uint32_t(row - bundle.firstRow);
+      uint64_t rowkey = counter_hash((uint64_t(seed) << 32) | b, y);
+      for (uint32_t x = 0; x < bundle.nbcells[0]; ++x) {
+        real_t u = counter_uniform(rowkey + 2 * uint64_t(x)), v = counter_uniform(rowkey + 2 * uint64_t(x) + 1);
+        Vector3 origin(bundle.lower[0] + (x + u) * bundle.cellsize[0],
+                       bundle.lower[1] + (y + v) * bundle.cellsize[1], ztop);
+        uint32_t hit = trace(origin, direction, stack);
+        if (hit == UINT32_MAX) chunkTransmitted += bundle.energy;
+        else chunkEnergies[triangles->getShapePosition(hit)] += bundle.energy;
+      }
+    }
+  }
+};
+
+/* ----------------------------------------------------------------------- */
+
+LightInterception::LightInterception( real_t raySpacing, uint32_t seed ) :
+  __raySpacing(raySpacing),
+  __seed(seed),
+  __periodic(false),
+  __incidentEnergy(0),
+  __transmittedEnergy(0),
+  __rayCount(0)
+{
+  setTurtleSky();
+}
+
+LightInterception::~LightInterception( )
+{
+}
+
+void LightInterception::setSky( const Point3ArrayPtr& directions, const RealArrayPtr& weights )
+{
+  if (!directions || !weights || directions->size() != weights->size()) {
+    pglError("Sky directions and weights should have the same size.");
+    return;
+  }
+  __directions = Point3ArrayPtr(new Point3Array(*directions));
+  for (Point3Array::iterator it = __directions->begin(); it != __directions->end(); ++it) it->normalize();
+  __weights = RealArrayPtr(new RealArray(*weights));
+}
+
+void LightInterception::setTurtleSky( SkyType type )
+{
+  __directions = Point3ArrayPtr(new Point3Array(46));
+  __weights = RealArrayPtr(new RealArray(46));
+  real_t total = 0;
+  uint32_t sector = 0;
+  for (uint32_t band = 0; band < 8; ++band) {
+    real_t elevation = TURTLE46_ELEVATIONS[band] * GEOM_RAD;
+    real_t luminance = (type == eStandardOvercast ? (1 + 2 * sin(elevation)) / 3 : 1);
+    for (uint32_t i = 0; i < TURTLE46_BANDSIZES[band]; ++i, ++sector) {
+      real_t azimuth = TURTLE46_AZIMUTHS[sector] * GEOM_RAD;
+      __directions->setAt(sector, Vector3(cos(elevation) * cos(azimuth), cos(elevation) * sin(azimuth), sin(elevation)));
+      real_t weight = luminance * sin(elevation);
+      __weights->setAt(sector, weight);
+      total += weight;
+    }
+  }
+  for (RealArray::iterator it = __weights->begin(); it != __weights->end(); ++it) *it /= total;
+}
+
+void LightInterception::setPeriodicDomain( const Vector2& lower, const Vector2& upper )
+{
+  if (upper.x() <= lower.x() || upper.y() <= lower.y()) {
+    pglError("Invalid periodic domain.");
+    return;
+  }
+  __periodic = true;
+  __lower = lower;
+  __upper = upper;
+}
+
+void LightInterception::unsetPeriodicDomain( )
+{
+  __periodic = false;
+}
+
+void LightInterception::clear( )
+{
+  std::vector<real_t>().swap(__energies);
+  std::vector<real_t>().swap(__areas);
+  std::vector<uint_t>().swap(__shapeIds);
+  __incidentEnergy = 0;
+  __transmittedEnergy = 0;
+  __rayCount = 0;
+}
+
+bool LightInterception::process( const ScenePtr& scene )
+{
+  clear();
+  if (__raySpacing <= 0) {
+    pglError("Invalid ray spacing (%f).", __raySpacing);
+    return false;
+  }
+  TriangleBVH triangles;
+  bool built = triangles.build(scene);
+  size_t nbShapes = triangles.getShapeCount();
+  __shapeIds = triangles.getBuffer().shapeIds;
+  __energies.resize(nbShapes, 0);
+  if (!built) {
+    __areas.resize(nbShapes, 0);
+    return false;
+  }
+  __areas = triangles.getShapeAreas();
+  Vector3 lower = triangles.getLowerCorner(), upper = triangles.getUpperCorner();
+
+  RayCaster caster;
+  caster.triangles = &triangles;
+  caster.seed = __seed;
+  // Rays start just above the scene and stop at its bottom.
+  caster.ztop = upper.z() + __raySpacing;
+  caster.zbottom = lower.z() - __raySpacing;
+  caster.periodic = __periodic;
+  std::vector<std::pair<real_t,real_t> > offsets;
+  if (__periodic) {
+    real_t width[2] = { __upper.x() - __lower.x(), __upper.y() - __lower.y() };
+    int32_t range[2][2];
+    for (int j = 0; j < 2; ++j) {
+      caster.domainLower[j] = __lower[j];
+      caster.domainUpper[j] = __upper[j];
+      range[j][0] = int32_t(ceil((__lower[j] - upper[j]) / width[j]));
+      range[j][1] = int32_t(floor((__upper[j] - lower[j]) / width[j]));
+    }
+    for (int32_t i = range[0][0]; i <= range[0][1]; ++i)
+      for (int32_t j = range[1][0]; j <= range[1][1]; ++j)
+        offsets.push_back(std::pair<real_t,real_t>(i * width[0], j * width[1]));
+  }
+  caster.offsets = &offsets;
+
+  // A bundle of rays for each direction of the sky, covering the domain or the shadow of the scene.
+  std::vector<RayBundle> bundles;
+  size_t nbRows = 0;
+  real_t height = caster.ztop - caster.zbottom;
+  for (uint32_t i = 0; i < __directions->size(); ++i) {
+    const Vector3& sky = __directions->getAt(i);
+    real_t weight = __weights->getAt(i);
+    if (sky.z() <= 0 || weight <= 0) continue;
+    RayBundle bundle;
+    bundle.direction[0] = -sky.x(); bundle.direction[1] = -sky.y(); bundle.direction[2] = -sky.z();
+    bundle.energy = weight;
+    for (int j = 0; j < 2; ++j) {
+      real_t first, last;
+      if (__periodic) { first = __lower[j]; last = __upper[j]; }
+      else {
+        real_t shift = height * sky[j] / sky.z();
+        first = lower[j] + std::min<real_t>(shift, 0);
+        last = upper[j] + std::max<real_t>(shift, 0);
+      }
+      bundle.nbcells[j] = std::max<uint32_t>(uint32_t(ceil((last - first) / __raySpacing)), 1);
+      bundle.lower[j] = first;
+      bundle.cellsize[j] = (last - first) / bundle.nbcells[j];
+      bundle.energy *= bundle.cellsize[j];
+    }
+    bundle.firstRow = nbRows;
+    nbRows += bundle.nbcells[1];
+    __rayCount += size_t(bundle.nbcells[0]) * bundle.nbcells[1];
+    __incidentEnergy += bundle.energy * bundle.nbcells[0] * bundle.nbcells[1];
+    bundles.push_back(bundle);
+  }
+  if (bundles.empty()) return false;
+  caster.bundles = &bundles;
+
+  // Each chunk of rows accumulates its own energies.
+  size_t grain = std::max<size_t>(PARALLEL_GRAIN / bundles[0].nbcells[0], 1);
+  size_t nbchunks = parallel_chunk_count(nbRows, grain);
+  std::vector<std::vector<real_t> > energies(nbchunks, std::vector<real_t>(nbShapes, 0));
+  std::vector<real_t> transmitted(nbchunks, 0);
+  caster.energies = &energies;
+  caster.transmitted = &transmitted;
+  parallel_for(nbRows, caster, grain);
+
+  for (size_t c = 0; c < nbchunks; ++c) {
+    for (size_t s = 0; s < nbShapes; ++s) __energies[s] += energies[c][s];
+    __transmittedEnergy += transmitted[c];
+  }
+  return true;
+}
+
+/* ----------------------------------------------------------------------- */
+
+RealArrayPtr LightInterception::getShapeEnergies( ) const
+{
+  return RealArrayPtr(new RealArray(__energies.begin(), __energies.end()));
+}
+
+RealArrayPtr LightInterception::getShapeIrradiances( ) const
+{
+  RealArrayPtr result(new RealArray(__energies.size(), 0));
+  for (size_t s = 0; s < __energies.size(); ++s)
+    if (__areas[s] > 0) result->setAt(s, __energies[s] / __areas[s]);
+  return result;
+}
+
+RealArrayPtr LightInterception::getShapeAreas( ) const
+{
+  return RealArrayPtr(new RealArray(__areas.begin(), __areas.end()));
+}
+
+Uint32Array1Ptr LightInterception::getShapeIds( ) const
+{
+  return Uint32Array1Ptr(new Uint32Array1(__shapeIds.begin(), __shapeIds.end()));
+}
+
+/* ----------------------------------------------------------------------- */
@@ -0,0 +1,175 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+/*! \file lightinterception.h
+    \brief Definition of LightInterception.
+*/
+
+#ifndef __lightinterception_h__
+#define __lightinterception_h__
+
+#include "trianglebvh.h"
+#include <plantgl/scenegraph/scene/scene.h>
+#include <plantgl/scenegraph/container/pointarray.h>
+#include <plantgl/tool/util_array.h>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/**
+   \class LightInterception
+   \brief Monte-Carlo estimation of the light intercepted by the shapes of a scene from a discretized sky.
+
+   The sky is a set of directions, pointing from the scene to the sky, weighted by their
+   contribution to the irradiance of a horizontal surface. For each direction, a bundle of
+   parallel rays is cast from a horizontal plane above the scene, on a grid whose cells are
+   jittered randomly. Each ray carries the energy of its cell and gives it to the first
+   triangle it hits. Energies are thus expressed relatively to an irradiance of 1 on a
+   horizontal surface.
+
+   The triangles of the scene are baked into one buffer and organized into a BVH.
+   Rays are cast in parallel and the random jitter of each ray only depends on its
+   direction, its cell and the seed, so that results do not depend on the number of threads.
+
+   In a periodic canopy, the scene is a pattern repeated on a horizontal domain. Rays leaving
+   the domain on one side enter again on the opposite side, and the parts of the shapes
+   outside of the domain are seen in the neighboring patterns.
+*/
+class ALGO_API LightInterception
+{
+
+public:
+
+  /// Distributions of the luminance of the sky.
+  enum SkyType { 
+    /// Uniform luminance.
+    eUniformOvercast, 
+    /// Standard overcast sky of Moon and Spencer, 3 times brighter at the zenith than at the horizon.
+    eStandardOvercast 
+  };
+
+  /// Constructs a LightInterception casting rays separated by \e raySpacing horizontally.
+  LightInterception( real_t raySpacing = 0.01, uint32_t seed = 0 );
+
+  /// Destructor.
+  ~LightInterception( );
+
+  /// Sets the sky as \e directions, pointing to the sky, with \e weights. Directions below the horizon are ignored.
+  void setSky( const Point3ArrayPtr& directions, const TOOLS(RealArrayPtr)& weights );
+
+  /** Sets the sky as the 46 sectors of the turtle of den Dulk (1989). The sectors having about
+      the same solid angle, their weight is proportional to their luminance and to the sine of their elevation. 
+      Weights sum to 1. The azimuth of the sectors is measured from the x axis counterclockwise. */
+  void setTurtleSky( SkyType type = eStandardOvercast );
+
+  /// Returns the directions of the sky.
+  inline const Point3ArrayPtr& getSkyDirections( ) const { return __directions; }
+
+  /// Returns the weights of the directions of the sky.
+  inline const TOOLS(RealArrayPtr)& getSkyWeights( ) const { return __weights; }
+
+  /// Repeats the scene periodically on the horizontal domain [\e lower, \e upper].
+  void setPeriodicDomain( const TOOLS(Vector2)& lower, const TOOLS(Vector2)& upper );
+
+  /// Considers the scene as isolated.
+  void unsetPeriodicDomain( );
+
+  /// Returns whether the scene is repeated periodically.
+  inline bool isPeriodic( ) const { return __periodic; }
+
+  inline real_t getRaySpacing( ) const { return __raySpacing; }
+  inline void setRaySpacing( real_t raySpacing ) { __raySpacing = raySpacing; }
+
+  inline uint32_t getSeed( ) const { return __seed; }
+  inline void setSeed( uint32_t seed ) { __seed = seed; }
+
+  /// Computes the energy intercepted by the shapes of \e scene. Returns false if nothing can be computed.
+  bool process( const ScenePtr& scene );
+
+  /// Clears the results.
+  void clear( );
+
+  /// Returns the energy intercepted by each shape, in the order of the scene.
+  TOOLS(RealArrayPtr) getShapeEnergies( ) const;
+
+  /// Returns the energy intercepted by each shape divided by its area.
+  TOOLS(RealArrayPtr) getShapeIrradiances( ) const;
+
+  /// Returns the area of each shape.
+  TOOLS(RealArrayPtr) getShapeAreas( ) const;
+
+  /// Returns the id of each shape.
+  TOOLS(Uint32Array1Ptr) getShapeIds( ) const;
+
+  /// Returns the energy carried by all the rays.
+  inline real_t getIncidentEnergy( ) const { return __incidentEnergy; }
+
+  /// Returns the energy of the rays that hit no triangle.
+  inline real_t getTransmittedEnergy( ) const { return __transmittedEnergy; }
+
+  /// Returns the number of rays cast.
+  inline size_t getRayCount( ) const { return __rayCount; }
+
+protected:
+
+  real_t __raySpacing;
+  uint32_t __seed;
+
+  Point3ArrayPtr __directions;
+  TOOLS(RealArrayPtr) __weights;
+
+  bool __periodic;
+  TOOLS(Vector2) __lower;
+  TOOLS(Vector2) __upper;
+
+  /// Results, by position of the shapes in the scene.
+  std::vector<real_t> __energies;
+  std::vector<real_t> __areas;
+  std::vector<uint_t> __shapeIds;
+  real_t __incidentEnergy;
+  real_t __transmittedEnergy;
+  size_t __rayCount;
+
+};
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+// __lightinterception_h__
+#endif
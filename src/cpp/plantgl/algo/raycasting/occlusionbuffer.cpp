@@ -0,0 +1,162 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+#include "occlusionbuffer.h"
+#include <plantgl/math/util_math.h>
+#include <limits>
+#include <algorithm>
+
+PGL_USING_NAMESPACE
+TOOLS_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+OcclusionBuffer::OcclusionBuffer( uint_t width, uint_t height ) :
+  __clip(Matrix4::IDENTITY),
+  __width(std::max<uint_t>(width,1)),
+  __height(std::max<uint_t>(height,1)),
+  __depths(__width * __height, std::numeric_limits<float>::max())
+{
+}
+
+OcclusionBuffer::~OcclusionBuffer( )
+{
+}
+
+void OcclusionBuffer::setClipMatrix( const Matrix4& clip )
+{
+  __clip = clip;
+  clear();
+}
+
+void OcclusionBuffer::clear( )
+{
+  std::fill(__depths.begin(), __depths.end(), std::numeric_limits<float>::max());
+}
+
+/* ----------------------------------------------------------------------- */
+
+real_t OcclusionBuffer::depth( const Vector3& point ) const
+{
+  // The clip z coordinate is an increasing affine function of the depth in the camera frame.
+  return __clip(2,0) * point.x() + __clip(2,1) * point.y() + __clip(2,2) * point.z() + __clip(2,3);
+}
+
+bool OcclusionBuffer::project( const Vector3& point, real_t& x, real_t& y, real_t& z ) const
+{
+  Vector4 p = __clip * Vector4(point, 1);
+  if (p.w() <= GEOM_EPSILON) return false;
+  x = (p.x() / p.w() + 1) * real_t(0.5) * __width;
+  y = (p.y() / p.w() + 1) * real_t(0.5) * __height;
+  z = (p.z() / p.w() + 1) * real_t(0.5);
+  return true;
+}
+
+/* ----------------------------------------------------------------------- */
+
+bool OcclusionBuffer::isOccluded( const Vector3& lower, const Vector3& upper ) const
+{
+  real_t xmin = std::numeric_limits<real_t>::max(), ymin = xmin, zmin = xmin;
+  real_t xmax = -xmin, ymax = -xmin;
+  for (int i = 0; i < 8; ++i) {
+    Vector3 corner((i & 1) ? upper.x() : lower.x(), (i & 2) ? upper.y() : lower.y(), (i & 4) ? upper.z() : lower.z());
+    real_t x, y, z;
+    // A box crossing the near plane may hide everything.
+    if (!project(corner, x, y, z)) return false;
+    xmin = std::min(xmin, x); xmax = std::max(xmax, x);
+    ymin = std::min(ymin, y); ymax = std::max(ymax, y);
+    zmin = std::min(zmin, z);
+  }
+  if (zmin <= 0) return false;
+
+  int x0 = std::max<int>(0, int(floor(xmin))), x1 = std::min<int>(__width - 1, int(floor(xmax)));
+  int y0 = std::max<int>(0, int(floor(ymin))), y1 = std::min<int>(__height - 1, int(floor(ymax)));
+  // Out of the view. This is left to the frustum test.
+  if (x0 > x1 || y0 > y1) return false;
+
+  for (int y = y0; y <= y1; ++y) {
+    const float * row = &__depths[y * __width];
+    for (int x = x0; x <= x1; ++x)
+      if (row[x] > zmin) return false;
+  }
+  return true;
+}
+
+/* ----------------------------------------------------------------------- */
+
+void OcclusionBuffer::addTriangle( const Vector3& a, const Vector3& b, const Vector3& c )
+{
+  real_t ax, ay, az, bx, by, bz, cx, cy, cz;
+  if (!project(a, ax, ay, az) || !project(b, bx, by, bz) || !project(c, cx, cy, cz)) return;
+
+  // Pixels completely covered have their 4 corners in the triangle.
+  int i0 = std::max<int>(0, int(ceil(std::min(ax, std::min(bx, cx)))));
+  int i1 = std::min<int>(__width, int(floor(std::max(ax, std::max(bx, cx)))));
+  int j0 = std::max<int>(0, int(ceil(std::min(ay, std::min(by, cy)))));
+  int j1 = std::min<int>(__height, int(floor(std::max(ay, std::max(by, cy)))));
+  if (i0 >= i1 || j0 >= j1) return;
+
+  real_t area = (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+  if (fabs(area) < GEOM_EPSILON) return;
+  real_t sign = (area > 0 ? 1 : -1);
+
+  // Depth is an affine function of the pixel coordinates.
+  real_t dzdx = ((bz - az) * (cy - ay) - (cz - az) * (by - ay)) / area;
+  real_t dzdy = ((cz - az) * (bx - ax) - (bz - az) * (cx - ax)) / area;
+  // Offset from the lower left corner of a pixel to its farthest corner.
+  real_t dzmax = std::max<real_t>(dzdx, 0) + std::max<real_t>(dzdy, 0);
+
+  size_t nbCorners = i1 - i0 + 1;
+  std::vector<char> below(nbCorners), above(nbCorners);
+  for (int j = j0; j <= j1; ++j) {
+    for (int i = i0; i <= i1; ++i) {
+      real_t e0 = ((bx - ax) * (j - ay) - (by - ay) * (i - ax)) * sign;
+      real_t e1 = ((cx - bx) * (j - by) - (cy - by) * (i - bx)) * sign;
+      real_t e2 = ((ax - cx) * (j - cy) - (ay - cy) * (i - cx)) * sign;
+      above[i - i0] = (e0 >= 0 && e1 >= 0 && e2 >= 0);
+    }
+    if (j > j0) {
+      float * row = &__depths[(j - 1) * __width];
+      for (int i = i0; i < i1; ++i) {
+        size_t k = i - i0;
+        if (below[k] && below[k+1] && above[k] && above[k+1]) {
+          float z = float(az + dzdx * (i - ax) + dzdy * (j - 1 - ay) + dzmax);
+          if (z < row[i]) row[i] = z;
+        }
+      }
+    }
+    below.swap(above);
+  }
+}
+
+/* ----------------------------------------------------------------------- */
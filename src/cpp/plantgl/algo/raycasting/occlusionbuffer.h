@@ -0,0 +1,122 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+/*! \file occlusionbuffer.h
+    \brief Definition of OcclusionBuffer.
+*/
+
+#ifndef __occlusionbuffer_h__
+#define __occlusionbuffer_h__
+
+#include "../algo_config.h"
+#include <plantgl/math/util_matrix.h>
+#include <vector>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/**
+   \class OcclusionBuffer
+   \brief A coarse depth buffer computed on the CPU to find boxes hidden by already drawn triangles.
+
+   Triangles are rasterized conservatively: a pixel is only written if the triangle covers
+   it completely, with the farthest depth of the triangle on the pixel. A box is occluded
+   if its nearest depth is behind the buffer on every pixel covered by its projection.
+   Depths are normalized device depths, in [0,1] from the near to the far plane.
+*/
+class ALGO_API OcclusionBuffer
+{
+
+public:
+
+  /// Constructs an OcclusionBuffer of \e width x \e height pixels.
+  OcclusionBuffer( uint_t width = 128, uint_t height = 128 );
+
+  /// Destructor.
+  ~OcclusionBuffer( );
+
+  /// Sets the clip matrix (projection * modelview) and clears the buffer.
+  void setClipMatrix( const TOOLS(Matrix4)& clip );
+
+  /// Returns the clip matrix.
+  inline const TOOLS(Matrix4)& getClipMatrix( ) const { return __clip; }
+
+  /// Clears the buffer.
+  void clear( );
+
+  /// Returns the width of the buffer.
+  inline uint_t getWidth( ) const { return __width; }
+
+  /// Returns the height of the buffer.
+  inline uint_t getHeight( ) const { return __height; }
+
+  /// Returns the depths of the pixels, row by row from the bottom of the view.
+  inline const std::vector<float>& getDepths( ) const { return __depths; }
+
+  /** Returns a value that increases with the distance of \e point from the viewer,
+      for orthographic as well as perspective projections. */
+  real_t depth( const TOOLS(Vector3)& point ) const;
+
+  /// Returns whether the box (\e lower, \e upper) is hidden.
+  bool isOccluded( const TOOLS(Vector3)& lower, const TOOLS(Vector3)& upper ) const;
+
+  /// Adds the triangle (\e a, \e b, \e c) as an occluder.
+  void addTriangle( const TOOLS(Vector3)& a, const TOOLS(Vector3)& b, const TOOLS(Vector3)& c );
+
+protected:
+
+  /** Projects \e point into pixel coordinates (\e x, \e y) and depth \e z.
+      Returns false if \e point is behind the near plane. */
+  bool project( const TOOLS(Vector3)& point, real_t& x, real_t& y, real_t& z ) const;
+
+  TOOLS(Matrix4) __clip;
+
+  uint_t __width;
+
+  uint_t __height;
+
+  std::vector<float> __depths;
+
+};
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+// __occlusionbuffer_h__
+#endif
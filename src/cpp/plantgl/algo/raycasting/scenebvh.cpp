@@ -0,0 +1,429 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+#include "scenebvh.h"
+#include "occlusionbuffer.h"
+#include "../base/bboxcomputer.h"
+#include <plantgl/scenegraph/geometry/triangleset.h>
+#include <plantgl/scenegraph/geometry/polyline.h>
+#include <plantgl/scenegraph/geometry/pointset.h>
+#include <plantgl/scenegraph/geometry/boundingbox.h>
+
+PGL_USING_NAMESPACE
+TOOLS_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/// Meshes with more primitives than this have their own hierarchy.
+#define SCENEBVH_MESH_LEAF 32
+
+/* ----------------------------------------------------------------------- */
+
+/* Intersection of a ray with the triangle (a, b, c), whatever its orientation (Moller-Trumbore). */
+static bool ray_triangle( const Vector3& origin, const Vector3& direction, 
+                          const Vector3& a, const Vector3& b, const Vector3& c, real_t& t )
+{
+  Vector3 e1 = b - a, e2 = c - a;
+  Vector3 p = cross(direction, e2);
+  real_t det = dot(e1, p);
+  if (fabs(det) < std::numeric_limits<real_t>::min()) return false;
+  real_t invdet = 1 / det;
+  Vector3 s = origin - a;
+  real_t u = dot(s, p) * invdet;
+  if (u < 0 || u > 1) return false;
+  Vector3 q = cross(s, e1);
+  real_t v = dot(direction, q) * invdet;
+  if (v < 0 || u + v > 1) return false;
+  t = dot(e2, q) * invdet;
+  return t >= 0;
+}
+
+/* Intersection of a ray with a box. */
+static bool ray_box( const Vector3& origin, const Vector3& direction, const float * box, real_t tmax, real_t& t )
+{
+  real_t tmin = 0;
+  for (int i = 0; i < 3; ++i) {
+    if (direction[i] == 0) {
+      if (origin[i] < box[i] || origin[i] > box[i+3]) return false;
+      continue;
+    }
+    real_t t0 = (box[i] - origin[i]) / direction[i];
+    real_t t1 = (box[i+3] - origin[i]) / direction[i];
+    if (t0 > t1) std::swap(t0, t1);
+    if (t0 > tmin) tmin = t0;
+    if (t1 < tmax) tmax = t1;
+    if (tmin > tmax) return false;
+  }
+  t = tmin;
+  return true;
+}
+
+/* ----------------------------------------------------------------------- */
+
+/* Finds the nearest shape hit by a ray. */
+struct SceneBVHIntersector {
+  SceneBVH& bvh;
+  const Ray& ray;
+  const std::vector<uint_t>& positions;
+  uint_t position;
+
+  SceneBVHIntersector(SceneBVH& _bvh, const Ray& _ray, const std::vector<uint_t>& _positions) : 
+    bvh(_bvh), ray(_ray), positions(_positions), position(UINT32_MAX) {}
+
+  bool operator()(uint32_t primitive, real_t& tmax) {
+    if (!bvh.intersect(positions[primitive], ray, tmax)) return false;
+    position = positions[primitive];
+    return true;
+  }
+};
+
+/* Finds the nearest primitive of a mesh hit by a ray. */
+struct MeshIntersector {
+  const Point3Array& points;
+  const std::vector<uint32_t>& indices;
+  const Ray& ray;
+
+  MeshIntersector(const Point3Array& _points, const std::vector<uint32_t>& _indices, const Ray& _ray) :
+    points(_points), indices(_indices), ray(_ray) {}
+
+  bool operator()(uint32_t triangle, real_t& tmax) {
+    real_t t;
+    if (ray_triangle(ray.getOrigin(), ray.getDirection(), 
+                     points.getAt(indices[3*triangle]), points.getAt(indices[3*triangle+1]), points.getAt(indices[3*triangle+2]), t) 
+        && t < tmax) {
+      tmax = t;
+      return true;
+    }
+    return false;
+  }
+};
+
+/* Collects the shapes with a part in a frustum. */
+struct SceneBVHSelector {
+  SceneBVH& bvh;
+  const ViewFrustum& frustum;
+  const std::vector<uint_t>& positions;
+  std::vector<uint_t> selection;
+
+  SceneBVHSelector(SceneBVH& _bvh, const ViewFrustum& _frustum, const std::vector<uint_t>& _positions) :
+    bvh(_bvh), frustum(_frustum), positions(_positions) {}
+
+  bool operator()(uint32_t primitive, bool inside) {
+    uint_t position = positions[primitive];
+    if (inside || bvh.intersect(position, frustum)) selection.push_back(position);
+    return true;
+  }
+};
+
+/* Finds whether a primitive of a mesh is in a frustum. */
+struct MeshSelector {
+  const Point3Array& points;
+  const std::vector<uint32_t>& indices;
+  uint32_t degree;
+  const ViewFrustum& frustum;
+  bool found;
+
+  MeshSelector(const Point3Array& _points, const std::vector<uint32_t>& _indices, uint32_t _degree, const ViewFrustum& _frustum) :
+    points(_points), indices(_indices), degree(_degree), frustum(_frustum), found(false) {}
+
+  bool operator()(uint32_t primitive, bool inside) {
+    if (inside || test(primitive)) found = true;
+    return !found;
+  }
+
+  bool test(uint32_t primitive) const {
+    const uint32_t * index = &indices[degree * primitive];
+    switch(degree) {
+      case 3: return frustum.intersect(points.getAt(index[0]), points.getAt(index[1]), points.getAt(index[2]));
+      case 2: return frustum.intersect(points.getAt(index[0]), points.getAt(index[1]));
+      default: return frustum.contains(points.getAt(index[0]));
+    }
+  }
+};
+
+/* ----------------------------------------------------------------------- */
+
+SceneBVH::SceneBVH( BBoxComputer& bboxComputer ) :
+  __bboxComputer(bboxComputer),
+  __tesselator(),
+  __hierarchy(2)
+{
+}
+
+SceneBVH::~SceneBVH( )
+{
+  clear();
+}
+
+void SceneBVH::clear( )
+{
+  for (std::vector<ShapeMesh *>::iterator it = __meshes.begin(); it != __meshes.end(); ++it)
+    if (*it) delete *it;
+  std::vector<ShapeMesh *>().swap(__meshes);
+  std::vector<float>().swap(__boxes);
+  std::vector<uint_t>().swap(__positions);
+  std::vector<uint_t>().swap(__unbounded);
+  __hierarchy.clear();
+  __tesselator.clear();
+  __scene = ScenePtr();
+}
+
+bool SceneBVH::build( const ScenePtr& scene )
+{
+  clear();
+  if (!scene || scene->empty()) return false;
+  __scene = scene;
+  size_t nbShapes = scene->size();
+  __boxes.resize(6 * nbShapes);
+  __meshes.resize(nbShapes, NULL);
+  __positions.reserve(nbShapes);
+  std::vector<float> boxes;
+  boxes.reserve(6 * nbShapes);
+
+  uint_t position = 0;
+  for (Scene::const_iterator it = scene->begin(); it != scene->end(); ++it, ++position) {
+    float * box = &__boxes[6 * position];
+    BoundingBoxPtr bbox;
+    if ((*it)->applyGeometryOnly(__bboxComputer) && (bbox = __bboxComputer.getBoundingBox())) {
+      const Vector3& lower = bbox->getLowerLeftCorner();
+      const Vector3& upper = bbox->getUpperRightCorner();
+      for (int j = 0; j < 3; ++j) {
+        // Rounding to float should not shrink the boxes.
+        real_t margin = (fabs(lower[j]) + fabs(upper[j])) * std::numeric_limits<float>::epsilon();
+        box[j] = float(lower[j] - margin);
+        box[j+3] = float(upper[j] + margin);
+      }
+      boxes.insert(boxes.end(), box, box + 6);
+      __positions.push_back(position);
+    }
+    else {
+      box[0] = box[1] = box[2] = 1;
+      box[3] = box[4] = box[5] = -1;
+      __unbounded.push_back(position);
+    }
+  }
+  __hierarchy.build(boxes);
+  return true;
+}
+
+/* ----------------------------------------------------------------------- */
+
+const SceneBVH::ShapeMesh& SceneBVH::getMesh( uint_t position )
+{
+  ShapeMesh *& mesh = __meshes[position];
+  if (mesh) return *mesh;
+  mesh = new ShapeMesh();
+  mesh->degree = 0;
+  if (!__scene->getAt(position)->applyGeometryOnly(__tesselator)) return *mesh;
+
+  TriangleSetPtr triangles = __tesselator.getTriangulation();
+  if (triangles && triangles->getPointList() && triangles->getIndexList()) {
+    mesh->points = triangles->getPointList();
+    mesh->degree = 3;
+    const Index3Array& indices = *triangles->getIndexList();
+    mesh->indices.reserve(3 * indices.size());
+    for (Index3Array::const_iterator it = indices.begin(); it != indices.end(); ++it){
+      mesh->indices.push_back(it->getAt(0)); mesh->indices.push_back(it->getAt(1)); mesh->indices.push_back(it->getAt(2));
+    }
+  }
+  else {
+    ExplicitModelPtr model = __tesselator.getDiscretization();
+    PolylinePtr polyline;
+    PointSetPtr pointset;
+    if ((polyline = dynamic_pointer_cast<Polyline>(model)) && polyline->getPointList()) {
+      mesh->points = polyline->getPointList();
+      mesh->degree = 2;
+      for (uint32_t i = 1; i < mesh->points->size(); ++i) { mesh->indices.push_back(i-1); mesh->indices.push_back(i); }
+    }
+    else if ((pointset = dynamic_pointer_cast<PointSet>(model)) && pointset->getPointList()) {
+      mesh->points = pointset->getPointList();
+      mesh->degree = 1;
+      for (uint32_t i = 0; i < mesh->points->size(); ++i) mesh->indices.push_back(i);
+    }
+  }
+
+  size_t nbPrimitives = (mesh->degree > 0 ? mesh->indices.size() / mesh->degree : 0);
+  if (nbPrimitives > SCENEBVH_MESH_LEAF) {
+    std::vector<float> boxes(6 * nbPrimitives);
+    for (size_t i = 0; i < nbPrimitives; ++i) {
+      float * box = &boxes[6 * i];
+      box[0] = box[1] = box[2] = std::numeric_limits<float>::max();
+      box[3] = box[4] = box[5] = -std::numeric_limits<float>::max();
+      for (uint32_t k = 0; k < mesh->degree; ++k) {
+        const Vector3& p = mesh->points->getAt(mesh->indices[mesh->degree * i + k]);
+        for (int j = 0; j < 3; ++j) {
+          real_t margin = fabs(p[j]) * std::numeric_limits<float>::epsilon();
+          box[j] = std::min(box[j], float(p[j] - margin));
+          box[j+3] = std::max(box[j+3], float(p[j] + margin));
+        }
+      }
+    }
+    mesh->hierarchy = new BVH();
+    mesh->hierarchy->build(boxes);
+  }
+  return *mesh;
+}
+
+/* ----------------------------------------------------------------------- */
+
+bool SceneBVH::intersect( const Ray& ray, uint_t& position, real_t& distance )
+{
+  if (!isBuilt()) return false;
+  SceneBVHIntersector intersector(*this, ray, __positions);
+  real_t tmax = std::numeric_limits<real_t>::max();
+  if (!__hierarchy.intersect(ray.getOrigin(), ray.getDirection(), tmax, intersector)) return false;
+  position = intersector.position;
+  distance = tmax;
+  return true;
+}
+
+bool SceneBVH::intersect( uint_t position, const Ray& ray, real_t& distance )
+{
+  const float * box = &__boxes[6 * position];
+  real_t t;
+  if (box[0] > box[3] || !ray_box(ray.getOrigin(), ray.getDirection(), box, distance, t)) return false;
+
+  const ShapeMesh& mesh = getMesh(position);
+  if (mesh.degree != 3) {
+    // Curves and points are too thin to be hit. Their bounding box is used instead.
+    distance = t;
+    return true;
+  }
+  MeshIntersector intersector(*mesh.points, mesh.indices, ray);
+  if (mesh.hierarchy) return mesh.hierarchy->intersect(ray.getOrigin(), ray.getDirection(), distance, intersector);
+
+  bool hit = false;
+  for (uint32_t i = 0; i < mesh.indices.size() / 3; ++i)
+    if (intersector(i, distance)) hit = true;
+  return hit;
+}
+
+/* ----------------------------------------------------------------------- */
+
+std::vector<uint_t> SceneBVH::select( const ViewFrustum& frustum )
+{
+  SceneBVHSelector selector(*this, frustum, __positions);
+  if (isBuilt()) __hierarchy.traverse(frustum, selector);
+  return selector.selection;
+}
+
+bool SceneBVH::intersect( uint_t position, const ViewFrustum& frustum )
+{
+  const float * box = &__boxes[6 * position];
+  if (box[0] > box[3]) return false;
+  BVH::Location location = frustum.locate(Vector3(box[0],box[1],box[2]), Vector3(box[3],box[4],box[5]));
+  if (location == BVH::Outside) return false;
+  if (location == BVH::Inside) return true;
+
+  const ShapeMesh& mesh = getMesh(position);
+  if (mesh.degree == 0) return true;
+  MeshSelector selector(*mesh.points, mesh.indices, mesh.degree, frustum);
+  if (mesh.hierarchy) mesh.hierarchy->traverse(frustum, selector);
+  else {
+    size_t nbPrimitives = mesh.indices.size() / mesh.degree;
+    for (uint32_t i = 0; i < nbPrimitives && !selector.found; ++i) selector(i, false);
+  }
+  return selector.found;
+}
+
+/* ----------------------------------------------------------------------- */
+
+static inline Vector3 node_lower( const BVH::Node& node ) { return Vector3(node.lower[0], node.lower[1], node.lower[2]); }
+static inline Vector3 node_upper( const BVH::Node& node ) { return Vector3(node.upper[0], node.upper[1], node.upper[2]); }
+
+std::vector<uint_t> SceneBVH::cull( const ViewFrustum& frustum, OcclusionBuffer * occlusion,
+                                    CullingStatistics * statistics )
+{
+  std::vector<uint_t> visible;
+  CullingStatistics stats;
+  if (isBuilt() && !__hierarchy.empty()) {
+    const std::vector<BVH::Node>& nodes = __hierarchy.getNodes();
+    const std::vector<uint32_t>& primitives = __hierarchy.getPrimitives();
+    // Nodes to visit with whether they are known to be in the frustum
+    std::vector<std::pair<uint32_t,bool> > stack;
+    stack.reserve(64);
+    stack.push_back(std::pair<uint32_t,bool>(0,false));
+    while (!stack.empty()) {
+      uint32_t index = stack.back().first;
+      bool inside = stack.back().second;
+      stack.pop_back();
+      const BVH::Node& node = nodes[index];
+      ++stats.nodes;
+      if (!inside) {
+        BVH::Location location = frustum(node);
+        if (location == BVH::Outside) continue;
+        inside = (location == BVH::Inside);
+      }
+      if (occlusion && occlusion->isOccluded(node_lower(node), node_upper(node))) continue;
+
+      if (!node.isLeaf()) {
+        uint32_t first = index + 1, second = node.offset;
+        // The nearest child is visited first so that it can hide the other one.
+        if (occlusion && occlusion->depth((node_lower(nodes[second]) + node_upper(nodes[second])) / 2) <
+                         occlusion->depth((node_lower(nodes[first]) + node_upper(nodes[first])) / 2))
+          std::swap(first, second);
+        stack.push_back(std::pair<uint32_t,bool>(second,inside));
+        stack.push_back(std::pair<uint32_t,bool>(first,inside));
+        continue;
+      }
+
+      for (uint32_t i = node.offset; i < node.offset + node.count; ++i) {
+        uint_t position = __positions[primitives[i]];
+        ++stats.tested;
+        // The box of a leaf with a single shape is the box of the shape.
+        if (node.count > 1) {
+          const float * box = &__boxes[6 * position];
+          Vector3 lower(box[0], box[1], box[2]), upper(box[3], box[4], box[5]);
+          if (!inside && frustum.locate(lower, upper) == BVH::Outside) continue;
+          if (occlusion && occlusion->isOccluded(lower, upper)) continue;
+        }
+        visible.push_back(position);
+        if (occlusion) {
+          const ShapeMesh& mesh = getMesh(position);
+          if (mesh.degree == 3) {
+            const Point3Array& points = *mesh.points;
+            for (size_t j = 0; j < mesh.indices.size(); j += 3)
+              occlusion->addTriangle(points.getAt(mesh.indices[j]), points.getAt(mesh.indices[j+1]), points.getAt(mesh.indices[j+2]));
+          }
+        }
+      }
+    }
+    stats.culled = __positions.size() - visible.size();
+  }
+  visible.insert(visible.end(), __unbounded.begin(), __unbounded.end());
+  stats.drawn = visible.size();
+  if (statistics) *statistics = stats;
+  return visible;
+}
+
+/* ----------------------------------------------------------------------- */
@@ -0,0 +1,178 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+/*! \file scenebvh.h
+    \brief Definition of SceneBVH.
+*/
+
+#ifndef __scenebvh_h__
+#define __scenebvh_h__
+
+#include "bvh.h"
+#include "viewfrustum.h"
+#include "ray.h"
+#include "../base/tesselator.h"
+#include <plantgl/scenegraph/scene/scene.h>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+class BBoxComputer;
+class OcclusionBuffer;
+
+/* ----------------------------------------------------------------------- */
+
+/**
+   \class SceneBVH
+   \brief A bounding volume hierarchy over the shapes of a scene for picking and selection.
+
+   The hierarchy is built over the bounding boxes of the shapes, which makes the construction
+   fast and light even for millions of shapes. The shapes are tesselated only when a query
+   reaches them, and a second hierarchy is built over the triangles of the large meshes.
+   Shapes are designated by their position in the scene.
+   Curves and point sets are tested exactly against frustums and by their bounding box against rays.
+*/
+class ALGO_API SceneBVH
+{
+
+public:
+
+  /// Constructs a SceneBVH. \e bboxComputer is used to compute the bounding boxes of the shapes.
+  SceneBVH( BBoxComputer& bboxComputer );
+
+  /// Destructor.
+  ~SceneBVH( );
+
+  /// Builds the hierarchy over the shapes of \e scene. Returns false if \e scene is empty.
+  bool build( const ScenePtr& scene );
+
+  /// Clears \e self.
+  void clear( );
+
+  /// Returns whether a scene has been built.
+  inline bool isBuilt( ) const { return is_valid_ptr(__scene); }
+
+  /// Returns the scene.
+  inline const ScenePtr& getScene( ) const { return __scene; }
+
+  /// Returns the hierarchy over the shapes.
+  inline const BVH& getHierarchy( ) const { return __hierarchy; }
+
+  /** Finds the nearest shape hit by \e ray. Returns its position in the scene and the distance
+      of the hit from the origin of the ray. Returns false if no shape is hit. */
+  bool intersect( const Ray& ray, uint_t& position, real_t& distance );
+
+  /** Returns whether the shape at \e position is hit by \e ray before \e distance.
+      If so, \e distance is set to the distance of the hit. */
+  bool intersect( uint_t position, const Ray& ray, real_t& distance );
+
+  /// Returns the positions of the shapes that have a part in \e frustum.
+  std::vector<uint_t> select( const ViewFrustum& frustum );
+
+  /// Returns whether the shape at \e position has a part in \e frustum.
+  bool intersect( uint_t position, const ViewFrustum& frustum );
+
+  /// Counts of a culling pass.
+  struct CullingStatistics {
+    CullingStatistics( ) : nodes(0), tested(0), culled(0), drawn(0) { }
+    /// Number of nodes of the hierarchy tested.
+    uint_t nodes;
+    /// Number of shapes tested individually.
+    uint_t tested;
+    /// Number of shapes culled, with those of the culled nodes.
+    uint_t culled;
+    /// Number of shapes to draw.
+    uint_t drawn;
+  };
+
+  /** Returns the positions of the shapes to draw for the view \e frustum.
+      Only the bounding boxes of the shapes are tested against the frustum.
+      If \e occlusion is given, the hierarchy is visited front to back and the triangles of the
+      shapes to draw are rasterized into it, so that the boxes they hide can be skipped.
+      Shapes without bounding box are always drawn. */
+  std::vector<uint_t> cull( const ViewFrustum& frustum, OcclusionBuffer * occlusion = NULL,
+                            CullingStatistics * statistics = NULL );
+
+protected:
+
+  /// The tesselation of a shape.
+  struct ShapeMesh {
+    ShapeMesh( ) : hierarchy(NULL) { }
+    ~ShapeMesh( ) { if (hierarchy) delete hierarchy; }
+
+    /// Points and indices of the triangles, or of the segments or points for curves and point sets.
+    Point3ArrayPtr points;
+    std::vector<uint32_t> indices;
+    /// Number of points by primitive. 3 for triangles, 2 for segments, 1 for points, 0 if unknown.
+    uint32_t degree;
+    /// Hierarchy over the primitives of large meshes.
+    BVH * hierarchy;
+  };
+
+  /// Returns the tesselation of the shape at \e position.
+  const ShapeMesh& getMesh( uint_t position );
+
+  BBoxComputer& __bboxComputer;
+
+  Tesselator __tesselator;
+
+  ScenePtr __scene;
+
+  /// Hierarchy over the bounding boxes of the shapes.
+  BVH __hierarchy;
+
+  /// Bounding boxes of the shapes, with 6 values per shape. Empty boxes have their lower corner above their upper one.
+  std::vector<float> __boxes;
+
+  /// Positions in the scene of the primitives of the hierarchy. Shapes without bounding box are not in the hierarchy.
+  std::vector<uint_t> __positions;
+
+  /// Positions in the scene of the shapes without bounding box.
+  std::vector<uint_t> __unbounded;
+
+  /// Tesselations of the shapes, computed when needed.
+  std::vector<ShapeMesh *> __meshes;
+
+};
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+// __scenebvh_h__
+#endif
@@ -0,0 +1,192 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+#include "trianglebvh.h"
+#include <plantgl/tool/util_parallel.h>
+#include <plantgl/math/util_math.h>
+
+PGL_USING_NAMESPACE
+TOOLS_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+#define PARALLEL_GRAIN 4096
+
+/* ----------------------------------------------------------------------- */
+
+/* Boxes of the triangles of the buffer. */
+struct TriangleBoxes {
+  const CompactMeshBuffer * buffer;
+  float * boxes;
+
+  void operator()( size_t begin, size_t end, size_t chunk ) {
+    for (size_t t = begin; t < end; ++t) {
+      float * box = boxes + 6 * t;
+      const uint32_t * ind = &buffer->indices[3 * t];
+      for (int j = 0; j < 3; ++j) { box[j] = std::numeric_limits<float>::max(); box[j+3] = -std::numeric_limits<float>::max(); }
+      for (int i = 0; i < 3; ++i) {
+        const float * v = &buffer->vertices[3 * ind[i]];
+        for (int j = 0; j < 3; ++j) {
+          if (v[j] < box[j]) box[j] = v[j];
+          if (v[j] > box[j+3]) box[j+3] = v[j];
+        }
+      }
+    }
+  }
+};
+
+/* Area of the shapes of the buffer. */
+struct ShapeAreas {
+  const CompactMeshBuffer * buffer;
+  real_t * areas;
+
+  void operator()( size_t begin, size_t end, size_t chunk ) {
+    for (size_t s = begin; s < end; ++s) {
+      real_t area = 0;
+      for (size_t t = buffer->triangleOffsets[s]; t < buffer->triangleOffsets[s+1]; ++t) {
+        const uint32_t * ind = &buffer->indices[3 * t];
+        const float * a = &buffer->vertices[3 * ind[0]];
+        const float * b = &buffer->vertices[3 * ind[1]];
+        const float * c = &buffer->vertices[3 * ind[2]];
+        real_t u[3] = { real_t(b[0]) - a[0], real_t(b[1]) - a[1], real_t(b[2]) - a[2] };
+        real_t v[3] = { real_t(c[0]) - a[0], real_t(c[1]) - a[1], real_t(c[2]) - a[2] };
+        real_t n[3] = { u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0] };
+        area += 0.5 * sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+      }
+      areas[s] = area;
+    }
+  }
+};
+
+/* Intersection of a ray with the triangles of the buffer, whatever their orientation (Moller-Trumbore). */
+struct TriangleIntersector {
+  const CompactMeshBuffer * buffer;
+  real_t origin[3];
+  real_t direction[3];
+  uint32_t hit;
+
+  bool operator()( uint32_t t, real_t& tmax ) {
+    const uint32_t * ind = &buffer->indices[3 * t];
+    const float * a = &buffer->vertices[3 * ind[0]];
+    const float * b = &buffer->vertices[3 * ind[1]];
+    const float * c = &buffer->vertices[3 * ind[2]];
+    real_t e1[3] = { real_t(b[0]) - a[0], real_t(b[1]) - a[1], real_t(b[2]) - a[2] };
+    real_t e2[3] = { real_t(c[0]) - a[0], real_t(c[1]) - a[1], real_t(c[2]) - a[2] };
+    const real_t * d = direction;
+    real_t p[3] = { d[1] * e2[2] - d[2] * e2[1], d[2] * e2[0] - d[0] * e2[2], d[0] * e2[1] - d[1] * e2[0] };
+    real_t det = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+    if (fabs(det) < std::numeric_limits<real_t>::min()) return false;
+    real_t invdet = 1 / det;
+    real_t s[3] = { origin[0] - a[0], origin[1] - a[1], origin[2] - a[2] };
+    real_t u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * invdet;
+    if (u < 0 || u > 1) return false;
+    real_t q[3] = { s[1] * e1[2] - s[2] * e1[1], s[2] * e1[0] - s[0] * e1[2], s[0] * e1[1] - s[1] * e1[0] };
+    real_t v = (d[0] * q[0] + d[1] * q[1] + d[2] * q[2]) * invdet;
+    if (v < 0 || u + v > 1) return false;
+    real_t dist = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) * invdet;
+    if (dist < 0 || dist >= tmax) return false;
+    tmax = dist;
+    hit = t;
+    return true;
+  }
+};
+
+/* ----------------------------------------------------------------------- */
+
+TriangleBVH::TriangleBVH( uint32_t maxLeafSize ) :
+  __hierarchy(maxLeafSize)
+{
+}
+
+TriangleBVH::~TriangleBVH( )
+{
+}
+
+void TriangleBVH::clear( )
+{
+  __buffer.clear();
+  __hierarchy.clear();
+}
+
+bool TriangleBVH::build( const ScenePtr& scene )
+{
+  clear();
+  if (!bake_scene(scene, __buffer, false)) return false;
+  size_t nbTriangles = __buffer.triangleCount();
+  if (nbTriangles == 0) return false;
+  std::vector<float> boxes(6 * nbTriangles);
+  TriangleBoxes boxer;
+  boxer.buffer = &__buffer;
+  boxer.boxes = &boxes[0];
+  parallel_for(nbTriangles, boxer, PARALLEL_GRAIN);
+  __hierarchy.build(boxes);
+  return true;
+}
+
+Vector3 TriangleBVH::getNormal( uint32_t triangle ) const
+{
+  const uint32_t * ind = &__buffer.indices[3 * triangle];
+  const float * a = &__buffer.vertices[3 * ind[0]];
+  const float * b = &__buffer.vertices[3 * ind[1]];
+  const float * c = &__buffer.vertices[3 * ind[2]];
+  Vector3 normal = cross(Vector3(b[0] - a[0], b[1] - a[1], b[2] - a[2]), Vector3(c[0] - a[0], c[1] - a[1], c[2] - a[2]));
+  normal.normalize();
+  return normal;
+}
+
+std::vector<real_t> TriangleBVH::getShapeAreas( ) const
+{
+  std::vector<real_t> areas(__buffer.shapeIds.size(), 0);
+  if (areas.empty()) return areas;
+  ShapeAreas computer;
+  computer.buffer = &__buffer;
+  computer.areas = &areas[0];
+  parallel_for(areas.size(), computer, 16);
+  return areas;
+}
+
+uint32_t TriangleBVH::intersect( const Vector3& origin, const Vector3& direction, real_t& tmax,
+                                 BVH::TraversalStack& stack ) const
+{
+  TriangleIntersector intersector;
+  intersector.buffer = &__buffer;
+  intersector.hit = UINT32_MAX;
+  for (int j = 0; j < 3; ++j) { 
+    intersector.origin[j] = origin[j]; 
+    intersector.direction[j] = direction[j]; 
+  }
+  __hierarchy.intersect(origin, direction, tmax, intersector, stack);
+  return intersector.hit;
+}
+
+/* ----------------------------------------------------------------------- */
@@ -0,0 +1,127 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+/*! \file trianglebvh.h
+    \brief Definition of TriangleBVH.
+*/
+
+#ifndef __trianglebvh_h__
+#define __trianglebvh_h__
+
+#include "bvh.h"
+#include "../base/scenebaker.h"
+#include <plantgl/scenegraph/scene/scene.h>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/**
+   \class TriangleBVH
+   \brief A bounding volume hierarchy over all the triangles of a scene, for casting many rays.
+
+   The scene is baked into one triangle buffer and the hierarchy is built over the boxes
+   of the triangles. Contrary to SceneBVH, nothing is computed during the queries, so that
+   rays can be cast from several threads at once.
+*/
+class ALGO_API TriangleBVH
+{
+
+public:
+
+  /// Constructs an empty TriangleBVH. Leaves contain at most \e maxLeafSize triangles.
+  TriangleBVH( uint32_t maxLeafSize = 4 );
+
+  /// Destructor.
+  ~TriangleBVH( );
+
+  /// Bakes \e scene and builds the hierarchy over its triangles. Returns false if \e scene has no triangle.
+  bool build( const ScenePtr& scene );
+
+  /// Clears \e self.
+  void clear( );
+
+  /// Returns the baked triangles.
+  inline const CompactMeshBuffer& getBuffer( ) const { return __buffer; }
+
+  /// Returns the hierarchy over the triangles.
+  inline const BVH& getHierarchy( ) const { return __hierarchy; }
+
+  /// Returns the number of triangles.
+  inline size_t size( ) const { return __buffer.triangleCount(); }
+
+  /// Returns the number of shapes of the scene, with those without triangles.
+  inline size_t getShapeCount( ) const { return __buffer.shapeIds.size(); }
+
+  /// Returns the position in the scene of the shape of the triangle \e triangle.
+  inline uint32_t getShapePosition( uint32_t triangle ) const { return __buffer.shapeIndices[triangle]; }
+
+  /// Returns the id of the shape of the triangle \e triangle.
+  inline uint_t getShapeId( uint32_t triangle ) const { return __buffer.shapeIds[__buffer.shapeIndices[triangle]]; }
+
+  /// Returns the unit normal of the triangle \e triangle, following the order of its vertices.
+  TOOLS(Vector3) getNormal( uint32_t triangle ) const;
+
+  /// Returns the area of each shape of the scene.
+  std::vector<real_t> getShapeAreas( ) const;
+
+  /// Returns the lower corner of the box of the triangles.
+  inline TOOLS(Vector3) getLowerCorner( ) const { return __hierarchy.getLowerCorner(); }
+
+  /// Returns the upper corner of the box of the triangles.
+  inline TOOLS(Vector3) getUpperCorner( ) const { return __hierarchy.getUpperCorner(); }
+
+  /** Finds the nearest triangle hit by the ray (\e origin, \e direction) before \e tmax, whatever its orientation.
+      Returns its index and sets \e tmax to the distance of the hit, or returns UINT32_MAX if no triangle is hit.
+      \e stack is used for the traversal and can be reused between rays. */
+  uint32_t intersect( const TOOLS(Vector3)& origin, const TOOLS(Vector3)& direction, real_t& tmax,
+                      BVH::TraversalStack& stack ) const;
+
+protected:
+
+  CompactMeshBuffer __buffer;
+
+  BVH __hierarchy;
+
+};
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+// __trianglebvh_h__
+#endif
@@ -0,0 +1,141 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+#include "viewfrustum.h"
+
+PGL_USING_NAMESPACE
+TOOLS_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+ViewFrustum::ViewFrustum( )
+{
+  for (int i = 0; i < 6; ++i) __planes[i] = Vector4(0,0,0,1);
+}
+
+ViewFrustum::ViewFrustum( const Matrix4& clip )
+{
+  Vector4 row[4] = { clip.getRow(0), clip.getRow(1), clip.getRow(2), clip.getRow(3) };
+  __planes[Left]   = row[3] + row[0];
+  __planes[Right]  = row[3] - row[0];
+  __planes[Bottom] = row[3] + row[1];
+  __planes[Top]    = row[3] - row[1];
+  __planes[Near]   = row[3] + row[2];
+  __planes[Far]    = row[3] - row[2];
+  for (int i = 0; i < 6; ++i) {
+    real_t n = norm(Vector3(__planes[i].x(), __planes[i].y(), __planes[i].z()));
+    if (n > GEOM_EPSILON) __planes[i] /= n;
+  }
+}
+
+bool ViewFrustum::contains( const Vector3& point ) const
+{
+  for (int i = 0; i < 6; ++i)
+    if (distance(i, point) < 0) return false;
+  return true;
+}
+
+BVH::Location ViewFrustum::locate( const real_t * lower, const real_t * upper ) const
+{
+  BVH::Location result = BVH::Inside;
+  for (int i = 0; i < 6; ++i) {
+    const Vector4& plane = __planes[i];
+    // Corners of the box the farthest inside and outside of the plane
+    real_t pin = plane.w(), pout = plane.w();
+    for (int j = 0; j < 3; ++j) {
+      if (plane[j] > 0) { pin += plane[j] * upper[j]; pout += plane[j] * lower[j]; }
+      else { pin += plane[j] * lower[j]; pout += plane[j] * upper[j]; }
+    }
+    if (pin < 0) return BVH::Outside;
+    if (pout < 0) result = BVH::Intersecting;
+  }
+  return result;
+}
+
+BVH::Location ViewFrustum::locate( const Vector3& lower, const Vector3& upper ) const
+{
+  real_t l[3] = { lower.x(), lower.y(), lower.z() };
+  real_t u[3] = { upper.x(), upper.y(), upper.z() };
+  return locate(l, u);
+}
+
+BVH::Location ViewFrustum::operator()( const BVH::Node& node ) const
+{
+  real_t l[3] = { node.lower[0], node.lower[1], node.lower[2] };
+  real_t u[3] = { node.upper[0], node.upper[1], node.upper[2] };
+  return locate(l, u);
+}
+
+bool ViewFrustum::intersect( const Vector3& a, const Vector3& b, const Vector3& c ) const
+{
+  bool inside = true;
+  for (int i = 0; i < 6; ++i) {
+    real_t da = distance(i, a), db = distance(i, b), dc = distance(i, c);
+    if (da < 0 && db < 0 && dc < 0) return false;
+    if (da < 0 || db < 0 || dc < 0) inside = false;
+  }
+  if (inside) return true;
+
+  // Clipping of the triangle by each plane (Sutherland-Hodgman)
+  std::vector<Vector3> polygon, clipped;
+  polygon.reserve(9); clipped.reserve(9);
+  polygon.push_back(a); polygon.push_back(b); polygon.push_back(c);
+  for (int i = 0; i < 6 && !polygon.empty(); ++i) {
+    clipped.clear();
+    size_t nb = polygon.size();
+    for (size_t j = 0; j < nb; ++j) {
+      const Vector3& p = polygon[j];
+      const Vector3& q = polygon[(j+1) % nb];
+      real_t dp = distance(i, p), dq = distance(i, q);
+      if (dp >= 0) clipped.push_back(p);
+      if ((dp >= 0) != (dq >= 0)) clipped.push_back(p + (q - p) * (dp / (dp - dq)));
+    }
+    polygon.swap(clipped);
+  }
+  return !polygon.empty();
+}
+
+bool ViewFrustum::intersect( const Vector3& a, const Vector3& b ) const
+{
+  real_t t0 = 0, t1 = 1;
+  for (int i = 0; i < 6; ++i) {
+    real_t da = distance(i, a), db = distance(i, b);
+    if (da < 0 && db < 0) return false;
+    if (da < 0) t0 = std::max(t0, da / (da - db));
+    else if (db < 0) t1 = std::min(t1, da / (da - db));
+    if (t0 > t1) return false;
+  }
+  return true;
+}
+
+/* ----------------------------------------------------------------------- */
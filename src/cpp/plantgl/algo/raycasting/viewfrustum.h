@@ -0,0 +1,112 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Modeling Plant Geometry
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *
+ *       Development site : https://gforge.inria.fr/projects/openalea/
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+/*! \file viewfrustum.h
+    \brief Definition of ViewFrustum.
+*/
+
+#ifndef __viewfrustum_h__
+#define __viewfrustum_h__
+
+#include "bvh.h"
+#include <plantgl/math/util_matrix.h>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/**
+   \class ViewFrustum
+   \brief The volume seen by a camera, given by 6 planes.
+
+   Each plane is stored as a Vector4 (a,b,c,d) and a point p is inside the plane if
+   a.x+b.y+c.z+d >= 0. The planes are extracted from the matrix that transforms world
+   coordinates into clip coordinates (projection * modelview).
+*/
+class ALGO_API ViewFrustum
+{
+
+public:
+
+  enum PlaneId { Left = 0, Right, Bottom, Top, Near, Far };
+
+  /// Constructs a frustum that contains everything.
+  ViewFrustum( );
+
+  /** Constructs the frustum of the clip matrix \e clip (projection * modelview).
+      A point p is in the frustum if clip * p is in [-w,w]^3. */
+  ViewFrustum( const TOOLS(Matrix4)& clip );
+
+  /// Returns the \e i-th plane.
+  inline const TOOLS(Vector4)& getPlane( int i ) const { return __planes[i]; }
+
+  /// Sets the \e i-th plane. 
+  inline void setPlane( int i, const TOOLS(Vector4)& plane ) { __planes[i] = plane; }
+
+  /// Returns whether \e point is in the frustum.
+  bool contains( const TOOLS(Vector3)& point ) const;
+
+  /// Returns the location of the box [\e lower, \e upper] relatively to the frustum.
+  BVH::Location locate( const TOOLS(Vector3)& lower, const TOOLS(Vector3)& upper ) const;
+
+  /// Returns the location of the box of \e node relatively to the frustum. Used to traverse a BVH.
+  BVH::Location operator()( const BVH::Node& node ) const;
+
+  /** Returns whether the triangle (\e a, \e b, \e c) has a part in the frustum.
+      The test is exact: the triangle is clipped by the planes if needed. */
+  bool intersect( const TOOLS(Vector3)& a, const TOOLS(Vector3)& b, const TOOLS(Vector3)& c ) const;
+
+  /// Returns whether the segment [\e a, \e b] has a part in the frustum.
+  bool intersect( const TOOLS(Vector3)& a, const TOOLS(Vector3)& b ) const;
+
+protected:
+
+  inline real_t distance( int i, const TOOLS(Vector3)& p ) const
+  { return __planes[i].x() * p.x() + __planes[i].y() * p.y() + __planes[i].z() * p.z() + __planes[i].w(); }
+
+  BVH::Location locate( const real_t * lower, const real_t * upper ) const;
+
+  TOOLS(Vector4) __planes[6];
+
+};
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+// __viewfrustum_h__
+#endif
@@ -864,6 +864,34 @@ void ViewGLFrame::selectGL()
 {
   makeCurrent();
 
+  if (__scene){
+    // Picking without OpenGL selection mode if the renderer supports it.
+    GLint viewport[4];
+    GLdouble modelMatrix[16], projMatrix[16];
+    __camera->beginSelectGL(__mouse);
+    glGetIntegerv(GL_VIEWPORT,viewport);
+    glGetDoublev(GL_MODELVIEW_MATRIX,modelMatrix);
+    glGetDoublev(GL_PROJECTION_MATRIX,projMatrix);
+    __camera->endSelectGL();
+    // The pick matrix maps the picked point on the center of the viewport.
+    GLdouble winx = viewport[0]+viewport[2]/2.0;
+    GLdouble winy = viewport[1]+viewport[3]/2.0;
+    GLdouble x0, y0, z0, x1, y1, z1;
+    vector<uint_t> ids;
+    if( geomUnProject(winx,winy,0,modelMatrix,projMatrix,viewport,&x0,&y0,&z0) &&
+        geomUnProject(winx,winy,1,modelMatrix,projMatrix,viewport,&x1,&y1,&z1) &&
+        __scene->pick(Vector3(x0,y0,z0),Vector3(x1-x0,y1-y0,z1-z0),ids)){
+      if(!ids.empty()){
+        __scene->selectionEvent(ids[0]);
+        emit selectedShape(__scene->translateId(ids[0]));
+      }
+#ifdef GEOM_DEBUG
+      else warning("*** WARNING : hit miss all shapes");
+#endif
+      return;
+    }
+  }
+
   GLint hits;
   GLsizei bufsize = 512;
   GLuint selectBuf[512];
@@ -931,6 +959,35 @@ void ViewGLFrame::multipleSelectGL(const QPoint& p)
 {
   makeCurrent();
 
+  QRect region(min(__mouse.x(),p.x()),
+               min(__mouse.y(),p.y()),
+               abs(__mouse.x()-p.x()),
+               abs(__mouse.y()-p.y()));
+
+  if (__scene){
+    // Selection without OpenGL selection mode if the renderer supports it.
+    TOOLS(Matrix4) projMatrix, modelMatrix;
+    __camera->beginSelectGL(region);
+    glGeomGetMatrix(GL_PROJECTION_MATRIX,projMatrix);
+    glGeomGetMatrix(GL_MODELVIEW_MATRIX,modelMatrix);
+    __camera->endSelectGL();
+    vector<uint_t> ids;
+    if(__scene->pick(projMatrix*modelMatrix,ids)){
+      if(ids.size()==1){
+        __scene->selectionEvent(ids[0]);
+        emit selectedShape(__scene->translateId(ids[0]));
+      }
+      else if(!ids.empty()){
+        __scene->selectionEvent(ids);
+        emit selectedShapes(__scene->translateIds(ids));
+      }
+#ifdef GEOM_DEBUG
+      else warning("*** WARNING : hit miss all shapes");
+#endif
+      return;
+    }
+  }
+
   GLint hits;
   GLsizei bufsize = 400000;
   GLuint selectBuf[400000];
@@ -945,10 +1002,7 @@ void ViewGLFrame::multipleSelectGL(const QPoint& p)
   // transformations induites dans le repere du labo a partir
   // des coord de la souris dans le repere de la GL
 
-  __camera->beginSelectGL(QRect(min(__mouse.x(),p.x()),
-								min(__mouse.y(),p.y()),
-								abs(__mouse.x()-p.x()),
-								abs(__mouse.y()-p.y())));
+  __camera->beginSelectGL(region);
 
   glLineWidth(1);
   glPointSize(1);
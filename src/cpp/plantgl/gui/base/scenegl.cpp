@@ -104,6 +104,18 @@ ViewRendererGL::selectGL()
 {
 }
 
+bool
+ViewRendererGL::pick(const Vector3& origin, const Vector3& direction, std::vector<uint_t>& ids)
+{
+  return false;
+}
+
+bool
+ViewRendererGL::pick(const TOOLS(Matrix4)& clip, std::vector<uint_t>& ids)
+{
+  return false;
+}
+
 void
 ViewRendererGL::selectionEvent(uint_t i)
 {
@@ -145,6 +157,16 @@ ViewRendererGL::translateId(uint_t id) const
 	return id;
 }
 
+std::vector<uint_t> 
+ViewRendererGL::translateIds(const std::vector<uint_t>& ids) const
+{
+	std::vector<uint_t> res;
+	res.reserve(ids.size());
+	for(std::vector<uint_t>::const_iterator _it = ids.begin(); _it != ids.end(); _it++)
+		res.push_back(translateId(*_it));
+	return res;
+}
+
 bool
 ViewRendererGL::endSelect()
 {
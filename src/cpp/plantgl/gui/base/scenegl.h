@@ -44,6 +44,7 @@
 #include "glframe.h"
 #include <plantgl/tool/util_types.h>
 #include <plantgl/scenegraph/geometry/boundingbox.h>
+#include <plantgl/math/util_matrix.h>
 #include <QtCore/qdatetime.h>
 
 /* ----------------------------------------------------------------------- */
@@ -109,6 +110,14 @@ public :
   /// Paint scene for Selection.
   virtual void selectGL();
 
+  /** Selection without OpenGL of the nearest shape hit by the ray (\b origin, \b direction).
+      Return false if not supported, in which case selectGL is used. */
+  virtual bool pick(const TOOLS(Vector3)& origin, const TOOLS(Vector3)& direction, std::vector<uint_t>& ids);
+
+  /** Selection without OpenGL of the shapes in the view volume of the matrix \b clip (projection * modelview).
+      Return false if not supported, in which case selectGL is used. */
+  virtual bool pick(const TOOLS(Matrix4)& clip, std::vector<uint_t>& ids);
+
   /// End of Selection. Return whether viewer must stay in selection mode (true) or not (false).
   virtual bool endSelect();
 
@@ -173,6 +182,8 @@ public :
 
   virtual uint_t translateId(uint_t) const;
 
+  virtual std::vector<uint_t> translateIds(const std::vector<uint_t>&) const;
+
   /// Get the global Bounding Box.
   virtual const PGL::BoundingBoxPtr getGlobalBoundingBox() const;
 
@@ -43,6 +43,7 @@
 #include <plantgl/scenegraph/geometry/explicitmodel.h>
 #include <plantgl/algo/base/wirecomputer.h>
 #include <plantgl/algo/base/tesselator.h>
+#include <plantgl/algo/base/sceneobjectcollector.h>
 
 /// Viewer
 #include "../base/light.h"
@@ -97,8 +98,16 @@ ViewGeomSceneGL::ViewGeomSceneGL(ViewCameraGL * camera,
   __scene(),
   __discretizer(),
   __renderer(__discretizer,parent),
+  __batchRenderer(),
+  __batchedRendering(false),
+  __cacheRetention(false),
   __skelComputer(__discretizer),
   __bboxComputer(__discretizer),
+  __sceneBVH(__bboxComputer),
+  __culling(false),
+  __occlusionCulling(false),
+  __occlusionBuffer(),
+  __cullingStatistics(),
   __skelRenderer(__skelComputer),
   __bboxRenderer(__bboxComputer),
   __ctrlPtRenderer(__discretizer),
@@ -176,14 +185,17 @@ ViewGeomSceneGL::clearCache()
   __discretizer.clear();
   __selectedShapes.clear();
   clearDisplayList();
+  __cachedGeometries.clear();
 }
 
 void
 ViewGeomSceneGL::clearDisplayList()
 {
   __renderer.clear();
+  __batchRenderer.clear();
   __skelComputer.clear();
   __bboxComputer.clear();
+  __sceneBVH.clear();
   __skelRenderer.clear();
   __bboxRenderer.clear();
   __ctrlPtRenderer.clear();
@@ -217,6 +229,23 @@ ViewGeomSceneGL::translateId(uint_t id) const
 	return id;
 }
 
+vector<uint_t>
+ViewGeomSceneGL::translateIds(const vector<uint_t>& ids) const
+{
+    QHash<uint_t,uint_t> translation;
+    Shape3DPtr ptr;
+    for(Scene::iterator _it = __scene->begin();
+        _it != __scene->end(); _it++){
+      if( (ptr = dynamic_pointer_cast<Shape3D>(*_it)) )
+        translation.insert(ptr->SceneObject::getId(),ptr->getId());
+    }
+    vector<uint_t> res;
+    res.reserve(ids.size());
+    for(vector<uint_t>::const_iterator _it = ids.begin(); _it != ids.end(); _it++)
+      res.push_back(translation.value(*_it,*_it));
+    return res;
+}
+
 
 ScenePtr 
 ViewGeomSceneGL::getSelection( ) const
@@ -286,9 +315,153 @@ ViewGeomSceneGL::getDisplayListUse() const {
   return !(__renderer.getRenderingMode() & GLRenderer::Dynamic);
 }
 
+void
+ViewGeomSceneGL::changeBatchedRenderingUse(){
+  __batchedRendering = !__batchedRendering;
+  // The scene display list contains either all the shapes or only the unbatched ones.
+  __renderer.clearSceneList();
+  if(!__batchedRendering) __batchRenderer.clear();
+  emit batchedRendering(__batchedRendering);
+  emit valueChanged();
+}
+
+void
+ViewGeomSceneGL::useBatchedRendering(bool b){
+  if( __batchedRendering != b){
+	changeBatchedRenderingUse();
+  }
+}
+
+bool 
+ViewGeomSceneGL::getBatchedRenderingUse() const {
+  return __batchedRendering;
+}
+
+void
+ViewGeomSceneGL::changeCacheRetentionUse(){
+  __cacheRetention = !__cacheRetention;
+  emit cacheRetention(__cacheRetention);
+}
+
+void
+ViewGeomSceneGL::useCacheRetention(bool b){
+  if( __cacheRetention != b){
+	changeCacheRetentionUse();
+  }
+}
+
+bool 
+ViewGeomSceneGL::getCacheRetentionUse() const {
+  return __cacheRetention;
+}
+
+void
+ViewGeomSceneGL::changeCullingUse(){
+  __culling = !__culling;
+  // Culled shapes are rendered one by one and not in the scene display list.
+  __renderer.clearSceneList();
+  __cullingStatistics = SceneBVH::CullingStatistics();
+  emit culling(__culling);
+  emit valueChanged();
+}
+
+void
+ViewGeomSceneGL::useCulling(bool b){
+  if( __culling != b){
+	changeCullingUse();
+  }
+}
+
+bool 
+ViewGeomSceneGL::getCullingUse() const {
+  return __culling;
+}
+
+void
+ViewGeomSceneGL::changeOcclusionCullingUse(){
+  __occlusionCulling = !__occlusionCulling;
+  emit occlusionCulling(__occlusionCulling);
+  // Occlusion culling is only done after view frustum culling.
+  if(__occlusionCulling && !__culling) changeCullingUse();
+  else emit valueChanged();
+}
+
+void
+ViewGeomSceneGL::useOcclusionCulling(bool b){
+  if( __occlusionCulling != b){
+	changeOcclusionCullingUse();
+  }
+}
+
+bool 
+ViewGeomSceneGL::getOcclusionCullingUse() const {
+  return __occlusionCulling;
+}
+
+const SceneBVH::CullingStatistics& 
+ViewGeomSceneGL::getCullingStatistics() const {
+  return __cullingStatistics;
+}
+
+void
+ViewGeomSceneGL::renderBatches()
+{
+  if(!__batchRenderer.isBuilt()){
+    ScenePtr staticscene(new Scene());
+    for(Scene::const_iterator it = __scene->begin();it != __scene->end(); it++)
+      if (!(*it)->hasDynamicRendering()) staticscene->add(*it);
+    __batchRenderer.build(staticscene);
+    QString _msg(tr("Batched")+" ");
+    _msg+=QString::number(__batchRenderer.getTriangleNb())+" "+tr("triangles in")+" ";
+    _msg+=QString::number(__batchRenderer.getBatches().size())+" "+tr("batches")+".";
+    status(_msg,5000);
+  }
+  __batchRenderer.render(__renderer);
+  if(!__batchRenderer.getUnbatchedShapes()->empty() && __renderer.beginSceneList()){
+    __batchRenderer.getUnbatchedShapes()->apply(__renderer);
+    __renderer.endSceneList();
+  }
+}
+
+void
+ViewGeomSceneGL::renderCulled()
+{
+  if(!__sceneBVH.isBuilt()) __sceneBVH.build(__scene);
+  Matrix4 projMatrix, modelMatrix;
+  glGeomGetMatrix(GL_PROJECTION_MATRIX,projMatrix);
+  glGeomGetMatrix(GL_MODELVIEW_MATRIX,modelMatrix);
+  Matrix4 clip = projMatrix*modelMatrix;
+  OcclusionBuffer * occlusion = NULL;
+  if(__occlusionCulling){
+    __occlusionBuffer.setClipMatrix(clip);
+    occlusion = &__occlusionBuffer;
+  }
+  SceneBVH::CullingStatistics statistics;
+  vector<uint_t> visible = __sceneBVH.cull(ViewFrustum(clip),occlusion,&statistics);
+  __renderer.beginProcess();
+  for(vector<uint_t>::const_iterator _it = visible.begin(); _it != visible.end(); _it++){
+    Shape3DPtr shape = __scene->getAt(*_it);
+    if (!shape->hasDynamicRendering()) shape->apply(__renderer);
+  }
+  __renderer.endProcess();
+  if(statistics.drawn != __cullingStatistics.drawn || statistics.tested != __cullingStatistics.tested){
+    QString _msg(tr("Culling")+" : ");
+    _msg+=QString::number(statistics.drawn)+" "+tr("shape(s) drawn")+", ";
+    _msg+=QString::number(statistics.culled)+" "+tr("culled")+", ";
+    _msg+=QString::number(statistics.tested)+" "+tr("tested")+".";
+    status(_msg);
+  }
+  __cullingStatistics = statistics;
+}
+
 void 
 ViewGeomSceneGL::refreshDisplay() {
-  if(__scene)setScene(ScenePtr(__scene));
+  if(__scene){
+    ScenePtr scene(__scene);
+    // Forget the current scene to force a complete rebuild
+    __scene = ScenePtr();
+    if(setScene(scene) < 0) __scene = scene;
+  }
 }
 
 void ViewGeomSceneGL::enableBlending(bool b) { __blending = b; emit valueChanged(); }
@@ -355,10 +528,13 @@ ViewGeomSceneGL::setScene( const ScenePtr& scene )
   }
 
   // Clears all the actions
+  bool updated = false;
   if (isAnimated() == eStatic){
-    __scene = ScenePtr();
-    __bbox= BoundingBoxPtr();
-    clearCache();
+    if (!__cacheRetention || !(updated = updateCache(scene))){
+      __scene = ScenePtr();
+      __bbox= BoundingBoxPtr();
+      clearCache();
+    }
   }
   else { 
 	  __selectedShapes.clear(); 
@@ -368,7 +544,8 @@ ViewGeomSceneGL::setScene( const ScenePtr& scene )
   // Sets the scene
   __scene = scene;
 
-  if (is_null_ptr(__bbox)){
+  if (updated) __camera->buildCamera(__bbox);
+  else if (is_null_ptr(__bbox)){
 	  // Computes the global bounding box
 	  if (! __scene->empty()) {
 		  if(__bboxComputer.process(__scene))
@@ -394,6 +571,69 @@ ViewGeomSceneGL::setScene( const ScenePtr& scene )
   return 1;
 }
 
+bool
+ViewGeomSceneGL::updateCache( const ScenePtr& scene )
+{
+  if (!__scene || __scene->empty() || !__bbox) return false;
+
+  // Caches are indexed by object addresses. Entries of the objects that are
+  // not in the new scene are removed while these objects are still alive.
+  SceneObjectCollector objects;
+  scene->apply(objects);
+
+  pgl_hash_set_size_t previous;
+  uint_t kept = 0;
+  bool removal = false;
+  for (Scene::const_iterator it = __scene->begin(); it != __scene->end(); ++it){
+    previous.insert((*it)->SceneObject::getId());
+    ShapePtr sh = dynamic_pointer_cast<Shape>(*it);
+    if (sh && sh->geometry && objects.contains(sh->geometry->getId())) ++kept;
+    if (!objects.contains((*it)->SceneObject::getId())) removal = true;
+  }
+  if (kept == 0) return false;
+
+  __selectedShapes.clear();
+  const pgl_hash_set_size_t& ids = objects.getIds();
+  __discretizer.retain(ids);
+  __renderer.retain(ids);
+  __batchRenderer.clear();
+  __skelComputer.retain(ids);
+  __bboxComputer.retain(ids);
+  __sceneBVH.clear();
+  __skelRenderer.retain(ids);
+  __bboxRenderer.retain(ids);
+  __ctrlPtRenderer.retain(ids);
+
+  // The bounding box is only extended if no shape has been removed.
+  BoundingBoxPtr bbox;
+  if (!removal) bbox = BoundingBoxPtr(new BoundingBox(*__bbox));
+  std::vector<GeometryPtr> geometries;
+  geometries.reserve(scene->size());
+  uint_t added = 0;
+  for (Scene::const_iterator it = scene->begin(); it != scene->end(); ++it){
+    ShapePtr sh = dynamic_pointer_cast<Shape>(*it);
+    if (sh && sh->geometry) geometries.push_back(sh->geometry);
+    if (previous.find((*it)->SceneObject::getId()) == previous.end()){
+      ++added;
+      if (bbox && (*it)->apply(__bboxComputer)) bbox->extend(__bboxComputer.getBoundingBox());
+    }
+  }
+  __cachedGeometries.swap(geometries);
+
+  if (!bbox) {
+    // The bounding boxes of the kept geometries are found in the cache.
+    if (!scene->empty() && __bboxComputer.process(scene)) bbox = __bboxComputer.getBoundingBox();
+    else bbox = BoundingBoxPtr(new BoundingBox(Vector3(-1,-1,-1),Vector3(1,1,1)));
+  }
+  __bbox = bbox;
+
+  QString _msg(tr("Display")+" ");
+  _msg+=QString::number(scene->size());
+  _msg+=(" "+tr("geometric shapes")+" ("+QString::number(added)+" "+tr("updated")+").");
+  status(_msg,10000);
+  return true;
+}
+
 void  
 ViewGeomSceneGL::computeCamera()
 {
@@ -427,7 +667,9 @@ ViewGeomSceneGL::paintGL()
       if(__blending)glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
       else glBlendFunc(GL_ONE,GL_ZERO);
       glPolygonMode(GL_FRONT_AND_BACK,GL_FILL);
-      if(__renderer.beginSceneList()){
+      if(__batchedRendering) renderBatches();
+      else if(__culling) renderCulled();
+      else if(__renderer.beginSceneList()){
 		if(__renderer.getRenderingMode() & GLRenderer::Dynamic){
 			__scene->apply(__renderer);
         }
@@ -465,7 +707,9 @@ ViewGeomSceneGL::paintGL()
       __light->switchOff();
       glBlendFunc(GL_ONE,GL_ZERO);
       glPolygonMode(GL_FRONT_AND_BACK,GL_LINE);
-      if(__renderer.beginSceneList()){
+      if(__batchedRendering) renderBatches();
+      else if(__culling) renderCulled();
+      else if(__renderer.beginSceneList()){
         __scene->apply(__renderer);
         __renderer.endSceneList();
       }
@@ -555,6 +799,47 @@ ViewGeomSceneGL::selectGL()
   }
 }
 
+bool
+ViewGeomSceneGL::isPickingSupported() const
+{
+  // The hierarchy holds the surfaces of the shapes only. Skeletons and control
+  // points are selected as displayed with selectGL.
+  if (__renderingMode == 3 || __renderingOption[1]) return false;
+  // Shapes hidden by a clipping plane would still be hit.
+  GLint nbPlanes = 0;
+  glGetIntegerv(GL_MAX_CLIP_PLANES,&nbPlanes);
+  for (GLint i = 0; i < nbPlanes; ++i)
+    if (glIsEnabled(GLenum(GL_CLIP_PLANE0+i))) return false;
+  return true;
+}
+
+bool
+ViewGeomSceneGL::pick(const Vector3& origin, const Vector3& direction, vector<uint_t>& ids)
+{
+  if (!isPickingSupported()) return false;
+  if (!__scene || __scene->empty() || normSquared(direction) < GEOM_EPSILON) return true;
+  if (!__sceneBVH.isBuilt()) __sceneBVH.build(__scene);
+  uint_t position;
+  real_t distance;
+  // The ray goes from the near plane to the far plane. Hits beyond are clipped.
+  if (__sceneBVH.intersect(Ray(origin,direction),position,distance) && distance <= norm(direction))
+    ids.push_back((uint_t)__scene->getAt(position)->SceneObject::getId());
+  return true;
+}
+
+bool
+ViewGeomSceneGL::pick(const Matrix4& clip, vector<uint_t>& ids)
+{
+  if (!isPickingSupported()) return false;
+  if (!__scene || __scene->empty()) return true;
+  if (!__sceneBVH.isBuilt()) __sceneBVH.build(__scene);
+  vector<uint_t> positions = __sceneBVH.select(ViewFrustum(clip));
+  ids.reserve(positions.size());
+  for(vector<uint_t>::const_iterator _it = positions.begin(); _it != positions.end(); _it++)
+    ids.push_back((uint_t)__scene->getAt(*_it)->SceneObject::getId());
+  return true;
+}
+
 void
 ViewGeomSceneGL::selectionEvent(uint_t id)
 {
@@ -48,6 +48,9 @@
 #include <plantgl/algo/base/bboxcomputer.h>
 #include <plantgl/algo/opengl/glbboxrenderer.h>
 #include <plantgl/algo/opengl/glrenderer.h>
+#include <plantgl/algo/opengl/glbatchrenderer.h>
+#include <plantgl/algo/raycasting/scenebvh.h>
+#include <plantgl/algo/raycasting/occlusionbuffer.h>
 #include <plantgl/algo/opengl/gltransitionrenderer.h>
 #include <plantgl/algo/opengl/glskelrenderer.h>
 #include <plantgl/algo/opengl/glctrlptrenderer.h>
@@ -95,6 +98,18 @@ class VIEW_API ViewGeomSceneGL  : public ViewModalRendererGL
 
   virtual void selectGL();
 
+  /** Picking of the nearest shape along the ray with the hierarchy of the shapes.
+      Return false, to use selectGL, if isPickingSupported is false. */
+  virtual bool pick(const TOOLS(Vector3)& origin, const TOOLS(Vector3)& direction, std::vector<uint_t>& ids);
+
+  /** Picking of the shapes in the view volume with the hierarchy of the shapes.
+      Return false, to use selectGL, if isPickingSupported is false. */
+  virtual bool pick(const TOOLS(Matrix4)& clip, std::vector<uint_t>& ids);
+
+  /** Whether the hierarchy of the shapes matches what is displayed: neither skeleton
+      nor control points are rendered and no clipping plane is enabled. */
+  bool isPickingSupported() const;
+
   /// Scene change Event.
   virtual bool sceneChangeEvent(ViewSceneChangeEvent *);
 
@@ -142,6 +157,8 @@ class VIEW_API ViewGeomSceneGL  : public ViewModalRendererGL
   virtual std::vector<uint_t> getSelectionIds() const;
   virtual uint_t translateId(uint_t) const;
 
+  virtual std::vector<uint_t> translateIds(const std::vector<uint_t>&) const;
+
   /// Get the global Bounding Box.
   const PGL(BoundingBoxPtr) getGlobalBoundingBox() const;
 
@@ -167,6 +184,17 @@ class VIEW_API ViewGeomSceneGL  : public ViewModalRendererGL
  
   bool getDisplayListUse() const;
 
+  bool getBatchedRenderingUse() const;
+
+  bool getCacheRetentionUse() const;
+
+  bool getCullingUse() const;
+
+  bool getOcclusionCullingUse() const;
+
+  /// Statistics of the last culling pass.
+  const PGL(SceneBVH)::CullingStatistics& getCullingStatistics() const;
+
   static bool useThread();
 
   /// Save current scene in GEOM format in the file \b filename.
@@ -299,6 +327,18 @@ public slots:
   void changeDisplayListUse();
   virtual void useDisplayList(bool);
 
+  void changeBatchedRenderingUse();
+  virtual void useBatchedRendering(bool);
+
+  void changeCacheRetentionUse();
+  virtual void useCacheRetention(bool);
+
+  void changeCullingUse();
+  virtual void useCulling(bool);
+
+  void changeOcclusionCullingUse();
+  virtual void useOcclusionCulling(bool);
+
   /// Clear Selection Event.
   virtual void clearSelectionEvent();
   virtual void clearDisplayList();
@@ -325,12 +365,33 @@ signals:
   
   void displayList(bool);
 
+  void batchedRendering(bool);
+
+  void cacheRetention(bool);
+
+  void culling(bool);
+
+  void occlusionCulling(bool);
+
 protected :
 
   virtual void customEvent(QEvent *); 
 
   virtual void animationChangedEvent(eAnimationFlag);
 
+  /** Update the caches and the global bounding box for the new \b scene by
+      keeping the results of the objects it shares with the current scene.
+      Return false if nothing is shared and a complete rebuild is needed.
+      Objects are compared by identity: an object modified in place keeps its
+      previous results. Used only if cache retention is enabled. */
+  bool updateCache( const PGL(ScenePtr)& scene );
+
+  /// Render the static shapes of the scene with the batch renderer.
+  void renderBatches();
+
+  /// Render the static shapes of the scene that are in the view and, optionally, not hidden.
+  void renderCulled();
+
   /// The scene object (which contains all the geometric shape and appereance to display).
   PGL(ScenePtr) __scene;
 
@@ -343,12 +404,36 @@ protected :
   /// The Selection Renderer.
   PGL(GLRenderer) __renderer;
 
+  /// The Batch Renderer.
+  PGL(GLBatchRenderer) __batchRenderer;
+
+  /// Whether the scene is rendered with the batch renderer.
+  bool __batchedRendering;
+
+  /// Whether the caches of the objects shared with the previous scene are kept by setScene.
+  bool __cacheRetention;
+
   /// The Skeleton Computer.
   PGL(SkelComputer) __skelComputer;
 
   /// The Bounding Box Computer.
   PGL(BBoxComputer) __bboxComputer;
 
+  /// The hierarchy of the shapes used for picking and culling. Built when first needed.
+  PGL(SceneBVH) __sceneBVH;
+
+  /// Whether the shapes out of the view are skipped.
+  bool __culling;
+
+  /// Whether the shapes hidden by nearer ones are also skipped.
+  bool __occlusionCulling;
+
+  /// The coarse depth buffer used for occlusion culling.
+  PGL(OcclusionBuffer) __occlusionBuffer;
+
+  /// Statistics of the last culling pass.
+  PGL(SceneBVH)::CullingStatistics __cullingStatistics;
+
   /// The Skeleton Renderer.
   PGL(GLSkelRenderer) __skelRenderer;
 
@@ -361,6 +446,10 @@ protected :
   /// The global Bounding Box.
   PGL(BoundingBoxPtr) __bbox;
 
+  /** Geometries of the displayed scene kept referenced so that the actions
+      cache their results between two successive scenes. */
+  std::vector<PGL(GeometryPtr)> __cachedGeometries;
+
   /// Selected shapes.
   typedef QHash<uint_t,PGL(Shape3DPtr)> SelectionCache; 
   // typedef pgl_hash_map<uint_t,PGL(Shape3DPtr)> SelectionCache;
@@ -302,6 +302,31 @@ ViewGeomSceneGL::addProperties(QTabWidget * tab)
 
   tab->addTab( tab2, tr( "PlantGL &Scene" ) );
 
+  if(__culling && __scene && !__scene->empty()){
+    tab2 = new QWidget( tab );
+    const char * labels[4] = { QT_TR_NOOP("Shapes Drawn"), QT_TR_NOOP("Shapes Culled"), 
+                               QT_TR_NOOP("Shapes Tested"), QT_TR_NOOP("Nodes Tested") };
+    uint_t values[4] = { __cullingStatistics.drawn, __cullingStatistics.culled, 
+                         __cullingStatistics.tested, __cullingStatistics.nodes };
+
+    QLabel * TextLabel = new QLabel( tab2 );
+    TextLabel->setGeometry( QRect( 18, 20, 350, 31 ) );
+    TextLabel->setText( tr( "Last Frame" )+" ("+(__occlusionCulling?tr("View Frustum and Occlusion"):tr("View Frustum"))+")" );
+
+    for(int i = 0; i < 4; ++i){
+      TextLabel = new QLabel( tab2 );
+      TextLabel->setGeometry( QRect( 20, 60+30*i, 130, 31 ) );
+      TextLabel->setText( tr( labels[i] )+" :" );
+
+      QLineEdit * TextLabel2 = new QLineEdit( tab2 );
+      TextLabel2->setReadOnly(true);
+      TextLabel2->setAlignment(Qt::AlignHCenter);
+      TextLabel2->setGeometry( QRect( 170, 60+30*i, 200, 25 ) );
+      TextLabel2->setText( QString::number(values[i]) );
+    }
+    tab->addTab( tab2, tr( "&Culling" ) );
+  }
+
   if(!__selectedShapes.empty()){
 	  
 	  StatisticComputer comp;
@@ -504,10 +529,29 @@ ViewGeomSceneGL::createToolsMenu(QWidget * parent)
   act->setCheckable(true);
   act->setChecked(getDisplayListUse());
   QObject::connect(this,SIGNAL(displayList(bool)),act,SLOT(setChecked(bool)));
+  act = __displayMenu->addAction(tr("Keep Between Scenes"),this,SLOT(changeCacheRetentionUse()));
+  act->setCheckable(true);
+  act->setChecked(getCacheRetentionUse());
+  QObject::connect(this,SIGNAL(cacheRetention(bool)),act,SLOT(setChecked(bool)));
   __displayMenu->addSeparator();
   __displayMenu->addAction(tr("Recompute"),      this,SLOT(clearDisplayList()));
   __displayMenu->setTitle(tr("&Display List"));
   menu->addMenu(__displayMenu);
+  act = menu->addAction(tr("&Batched Rendering"),this,SLOT(changeBatchedRenderingUse()));
+  act->setCheckable(true);
+  act->setChecked(getBatchedRenderingUse());
+  QObject::connect(this,SIGNAL(batchedRendering(bool)),act,SLOT(setChecked(bool)));
+  QMenu * __cullingMenu = new QMenu(menu);
+  act = __cullingMenu->addAction(tr("View &Frustum"),this,SLOT(changeCullingUse()));
+  act->setCheckable(true);
+  act->setChecked(getCullingUse());
+  QObject::connect(this,SIGNAL(culling(bool)),act,SLOT(setChecked(bool)));
+  act = __cullingMenu->addAction(tr("&Occlusion"),this,SLOT(changeOcclusionCullingUse()));
+  act->setCheckable(true);
+  act->setChecked(getOcclusionCullingUse());
+  QObject::connect(this,SIGNAL(occlusionCulling(bool)),act,SLOT(setChecked(bool)));
+  __cullingMenu->setTitle(tr("&Culling"));
+  menu->addMenu(__cullingMenu);
   return menu;
 }
 
@@ -33,6 +33,7 @@
  
 
 #include "mesh.h"
+#include "meshnormals.h"
 #include <plantgl/scenegraph/core/pgl_messages.h>
 #include "polyline.h"
 #include <plantgl/scenegraph/container/pointarray.h>
@@ -333,47 +334,12 @@ Mesh::getFaceCenter( uint_t i ) const
 
 Point3ArrayPtr 
 Mesh::computeNormalPerVertex() const {
-    std::vector<bool> hasNormal(__pointList->size(),false);
-    Point3ArrayPtr normalList(new Point3Array(__pointList->size()));
-    uint_t i = 0;
-    uint_t j = 0;
-    for(j=0; j < getIndexListSize(); j++){
-        Vector3 _norm = cross(getFacePointAt(j,__ccw ? 1 : 2) - getFacePointAt(j,0),
-                              getFacePointAt(j,__ccw ? 2 : 1) - getFacePointAt(j,0));
-        for(i = 0; i < getFaceSize(j); i++){
-            uint_t _index = getFacePointIndexAt(j,i);
-            normalList->getAt(_index)+=_norm;
-            hasNormal[_index] = true;
-        }
-    }
-    for(i=0; i < __pointList->size(); i++) {
-        if(!hasNormal[i] )
-            normalList->setAt(i,Vector3( 1,0,0 ) );
-    }
-    for(Point3Array::iterator _it=normalList->begin();_it!=normalList->end();_it++)
-    {
-	    _it->normalize();
-        if (fabs(norm(*_it) - 1.0) > GEOM_EPSILON) *_it = DEFAULT_NORMAL_VALUE;
-    }
-
-    return normalList;
+    return MeshNormalComputer(*this).computeVertexNormals();
 }
 
 Point3ArrayPtr 
 Mesh::computeNormalPerFace() const {
-    Point3ArrayPtr normalList(new Point3Array(getIndexListSize())); 
-    for(uint_t j=0; j < getIndexListSize(); j++){ 
-	    normalList->setAt(j,cross(getFacePointAt(j,__ccw ? 1 : 2) - getFacePointAt(j,0), 
-			      getFacePointAt(j,__ccw ? 2 : 1) - getFacePointAt(j,0))); 
-    }
-    bool hasinvalid = false;
-    for(Point3Array::iterator _it=normalList->begin();_it!=normalList->end();_it++)
-    {
-	    _it->normalize();
-        if (fabs(norm(*_it) - 1.0) > GEOM_EPSILON) *_it = DEFAULT_NORMAL_VALUE;
-    }
-
-	return normalList;
+    return MeshNormalComputer(*this).computeFaceNormals();
 }
 
 
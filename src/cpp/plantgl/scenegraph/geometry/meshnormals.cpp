@@ -0,0 +1,408 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright 1995-2007 UMR CIRAD/INRIA/INRA DAP 
+ *
+ *       File author(s): F. Boudon et al.
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+#include "meshnormals.h"
+#include "triangleset.h"
+#include "quadset.h"
+#include <plantgl/scenegraph/container/pointarray.h>
+#include <plantgl/tool/util_parallel.h>
+#include <plantgl/tool/util_simd.h>
+#include <plantgl/tool/errormsg.h>
+#include <cmath>
+
+PGL_USING_NAMESPACE
+TOOLS_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+// Number of triangles gathered at once. Must be a multiple of PGL_PACK_SIZE.
+#define NORMAL_BLOCK_SIZE 256
+
+/* Parallel tasks computing the normals of a range of faces or vertices. */
+struct FaceVectorTask {
+    MeshNormalComputer& computer;
+    const uint_t * elements;
+    FaceVectorTask(MeshNormalComputer& _computer, const uint_t * _elements = NULL) : computer(_computer), elements(_elements) {}
+    void operator()(size_t begin, size_t end, size_t) { computer.faceVectors(elements,begin,end); }
+};
+
+struct VertexNormalTask {
+    MeshNormalComputer& computer;
+    const uint_t * elements;
+    VertexNormalTask(MeshNormalComputer& _computer, const uint_t * _elements = NULL) : computer(_computer), elements(_elements) {}
+    void operator()(size_t begin, size_t end, size_t) { computer.vertexNormals(elements,begin,end); }
+};
+
+/* Normalize (x,y,z) into \e result. Null vectors get the default normal. */
+inline void normalize_normal(double x, double y, double z, Vector3& result)
+{
+    double l = sqrt(x*x+y*y+z*z);
+    if (l > 0 && l < HUGE_VAL) result = Vector3(x/l,y/l,z/l);
+    else result = Mesh::DEFAULT_NORMAL_VALUE;
+}
+
+/* ----------------------------------------------------------------------- */
+
+MeshNormalComputer::MeshNormalComputer( Weighting weighting ) :
+    __ccw(true), __weighting(weighting), __faceSize(0), __cornerData(NULL), __faceNb(0),
+    __faceVectorsComputed(false), __stamp(0) 
+{ }
+
+MeshNormalComputer::MeshNormalComputer( const Mesh& mesh, Weighting weighting ) :
+    __ccw(true), __weighting(weighting), __faceSize(0), __cornerData(NULL), __faceNb(0),
+    __faceVectorsComputed(false), __stamp(0) 
+{ setMesh(mesh); }
+
+MeshNormalComputer::~MeshNormalComputer( ) 
+{ }
+
+void MeshNormalComputer::setWeighting( Weighting weighting ) 
+{ 
+    __weighting = weighting; 
+}
+
+void MeshNormalComputer::setMesh( const Mesh& mesh )
+{
+    __points = mesh.getPointList();
+    __ccw = mesh.getCCW();
+    __triangleIndices = Index3ArrayPtr();
+    __quadIndices = Index4ArrayPtr();
+    __corners.clear();
+    __faceStarts.clear();
+    __incidenceStarts.clear();
+    __incidences.clear();
+    __cornerFaces.clear();
+    __faceStamps.clear();
+    __vertexStamps.clear();
+    __faceVectorsComputed = false;
+    __faceNormals = Point3ArrayPtr();
+    __vertexNormals = Point3ArrayPtr();
+    __faceNb = mesh.getIndexListSize();
+    __faceSize = 0;
+    __cornerData = NULL;
+
+    // Index tuples hold their values contiguously: the index lists of triangles and quads are used in place.
+    const TriangleSet * triangles = dynamic_cast<const TriangleSet *>(&mesh);
+    const QuadSet * quads = dynamic_cast<const QuadSet *>(&mesh);
+    if (triangles && sizeof(Index3) == 3 * sizeof(uint_t)) {
+        __triangleIndices = triangles->getIndexList();
+        __faceSize = 3;
+        if (__faceNb > 0) __cornerData = __triangleIndices->begin()->begin();
+    }
+    else if (quads && sizeof(Index4) == 4 * sizeof(uint_t)) {
+        __quadIndices = quads->getIndexList();
+        __faceSize = 4;
+        if (__faceNb > 0) __cornerData = __quadIndices->begin()->begin();
+    }
+    else {
+        __faceStarts.reserve(__faceNb+1);
+        __faceStarts.push_back(0);
+        for(uint_t f = 0; f < __faceNb; ++f){
+            for(uint_t j = 0; j < mesh.getFaceSize(f); ++j)
+                __corners.push_back(mesh.getFacePointIndexAt(f,j));
+            __faceStarts.push_back(__corners.size());
+        }
+        if (!__corners.empty()) __cornerData = &__corners[0];
+    }
+    __faceVectors.clear();
+}
+
+void MeshNormalComputer::buildIncidence( )
+{
+    uint_t nbpoints = getPointNb();
+    uint_t nbcorners = faceBegin(__faceNb);
+    __incidenceStarts.assign(nbpoints+1,0);
+    for(uint_t c = 0; c < nbcorners; ++c)
+        if (__cornerData[c] < nbpoints) ++__incidenceStarts[__cornerData[c]+1];
+    for(uint_t i = 0; i < nbpoints; ++i) __incidenceStarts[i+1] += __incidenceStarts[i];
+
+    __incidences.resize(__incidenceStarts[nbpoints]);
+    std::vector<uint_t> fill(__incidenceStarts.begin(),__incidenceStarts.end()-1);
+    for(uint_t c = 0; c < nbcorners; ++c)
+        if (__cornerData[c] < nbpoints) __incidences[fill[__cornerData[c]]++] = c;
+
+    if (__faceSize == 0) {
+        __cornerFaces.resize(nbcorners);
+        for(uint_t f = 0; f < __faceNb; ++f)
+            for(uint_t c = __faceStarts[f]; c < __faceStarts[f+1]; ++c) __cornerFaces[c] = f;
+    }
+    if (!__vertexNormals || __vertexNormals->size() != nbpoints) 
+        __vertexNormals = Point3ArrayPtr(new Point3Array(nbpoints));
+}
+
+/* ----------------------------------------------------------------------- */
+
+void MeshNormalComputer::faceBlock( const uint_t * faces, size_t first, size_t n, double * nx, double * ny, double * nz ) const
+{
+    const Point3Array& points = *__points;
+    const double sign = (__ccw ? 1.0 : -1.0);
+    uint_t nbpoints = points.size();
+
+    if (__faceSize == 3 || __faceSize == 4) {
+        // Triangle normals are the cross product of two edges, and quad normals the cross product of their diagonals.
+        double e1x[NORMAL_BLOCK_SIZE], e1y[NORMAL_BLOCK_SIZE], e1z[NORMAL_BLOCK_SIZE];
+        double e2x[NORMAL_BLOCK_SIZE], e2y[NORMAL_BLOCK_SIZE], e2z[NORMAL_BLOCK_SIZE];
+        bool quad = (__faceSize == 4);
+        // Gather the edges in SoA form.
+        for(size_t k = 0; k < n; ++k){
+            const uint_t * c = __cornerData + __faceSize * (faces ? faces[first+k] : first+k);
+            if (c[0] >= nbpoints || c[1] >= nbpoints || c[2] >= nbpoints || (quad && c[3] >= nbpoints)) {
+                e1x[k] = e1y[k] = e1z[k] = e2x[k] = e2y[k] = e2z[k] = 0;
+                continue;
+            }
+            const Vector3& p0 = points.getAt(c[0]);
+            const Vector3& p1 = points.getAt(quad ? c[2] : c[1]);
+            const Vector3& q0 = points.getAt(quad ? c[1] : c[0]);
+            const Vector3& q1 = points.getAt(quad ? c[3] : c[2]);
+            e1x[k] = p1.x() - p0.x(); e1y[k] = p1.y() - p0.y(); e1z[k] = p1.z() - p0.z();
+            e2x[k] = q1.x() - q0.x(); e2y[k] = q1.y() - q0.y(); e2z[k] = q1.z() - q0.z();
+        }
+        size_t padded = n;
+        for(; padded % PGL_PACK_SIZE != 0; ++padded) 
+            e1x[padded] = e1y[padded] = e1z[padded] = e2x[padded] = e2y[padded] = e2z[padded] = 0;
+        dpack s = pk_set1(sign);
+        for(size_t k = 0; k < padded; k += PGL_PACK_SIZE){
+            dpack ax = pk_load(e1x+k), ay = pk_load(e1y+k), az = pk_load(e1z+k);
+            dpack bx = pk_load(e2x+k), by = pk_load(e2y+k), bz = pk_load(e2z+k);
+            pk_store(nx+k,pk_mul(s,pk_sub(pk_mul(ay,bz),pk_mul(az,by))));
+            pk_store(ny+k,pk_mul(s,pk_sub(pk_mul(az,bx),pk_mul(ax,bz))));
+            pk_store(nz+k,pk_mul(s,pk_sub(pk_mul(ax,by),pk_mul(ay,bx))));
+        }
+    }
+    else {
+        // Polygons are decomposed in fans around their first point.
+        for(size_t k = 0; k < n; ++k){
+            uint_t f = (faces ? faces[first+k] : first+k);
+            double cx = 0, cy = 0, cz = 0;
+            uint_t cfirst = faceBegin(f), clast = faceEnd(f);
+            bool valid = (clast - cfirst >= 3);
+            for(uint_t c = cfirst; c < clast && valid; ++c) valid = __cornerData[c] < nbpoints;
+            if (valid) {
+                const Vector3& p0 = points.getAt(__cornerData[cfirst]);
+                for(uint_t c = cfirst + 1; c + 1 < clast; ++c){
+                    Vector3 a = points.getAt(__cornerData[c]) - p0;
+                    Vector3 b = points.getAt(__cornerData[c+1]) - p0;
+                    cx += a.y() * b.z() - a.z() * b.y();
+                    cy += a.z() * b.x() - a.x() * b.z();
+                    cz += a.x() * b.y() - a.y() * b.x();
+                }
+            }
+            nx[k] = sign * cx; ny[k] = sign * cy; nz[k] = sign * cz;
+        }
+    }
+}
+
+void MeshNormalComputer::faceVectors( const uint_t * faces, size_t begin, size_t end )
+{
+    double nx[NORMAL_BLOCK_SIZE], ny[NORMAL_BLOCK_SIZE], nz[NORMAL_BLOCK_SIZE];
+    for(size_t first = begin; first < end; first += NORMAL_BLOCK_SIZE){
+        size_t n = std::min<size_t>(NORMAL_BLOCK_SIZE, end - first);
+        faceBlock(faces,first,n,nx,ny,nz);
+        for(size_t k = 0; k < n; ++k){
+            uint_t f = (faces ? faces[first+k] : first+k);
+            double * v = &__faceVectors[3*f];
+            v[0] = nx[k]; v[1] = ny[k]; v[2] = nz[k];
+            if (__faceNormals) normalize_normal(nx[k],ny[k],nz[k],__faceNormals->getAt(f));
+        }
+    }
+}
+
+void MeshNormalComputer::vertexNormals( const uint_t * vertices, size_t begin, size_t end )
+{
+    const Point3Array& points = *__points;
+    for(size_t i = begin; i < end; ++i){
+        uint_t v = (vertices ? vertices[i] : i);
+        uint_t first = __incidenceStarts[v], last = __incidenceStarts[v+1];
+        if (first == last) { 
+            // Point not used by any face.
+            __vertexNormals->setAt(v,Vector3(1,0,0)); 
+            continue; 
+        }
+        double nx = 0, ny = 0, nz = 0;
+        for(uint_t c = first; c < last; ++c){
+            uint_t corner = __incidences[c];
+            uint_t f = cornerFace(corner);
+            const double * fv = &__faceVectors[3*f];
+            if (__weighting == AREA_WEIGHTING) {
+                nx += fv[0]; ny += fv[1]; nz += fv[2];
+                continue;
+            }
+            double l = sqrt(fv[0]*fv[0]+fv[1]*fv[1]+fv[2]*fv[2]);
+            if (!(l > 0 && l < HUGE_VAL)) continue;
+            double w = 1 / l;
+            if (__weighting == ANGLE_WEIGHTING) {
+                uint_t ffirst = faceBegin(f), flast = faceEnd(f);
+                uint_t prev = (corner == ffirst ? flast : corner) - 1;
+                uint_t next = (corner + 1 == flast ? ffirst : corner + 1);
+                const Vector3& p = points.getAt(__cornerData[corner]);
+                Vector3 a = points.getAt(__cornerData[prev]) - p;
+                Vector3 b = points.getAt(__cornerData[next]) - p;
+                w *= atan2(norm(cross(a,b)),dot(a,b));
+            }
+            nx += w * fv[0]; ny += w * fv[1]; nz += w * fv[2];
+        }
+        normalize_normal(nx,ny,nz,__vertexNormals->getAt(v));
+    }
+}
+
+void MeshNormalComputer::scatterVertexNormals( )
+{
+    const Point3Array& points = *__points;
+    uint_t nbpoints = points.size();
+    std::vector<bool> used(nbpoints,false);
+    __vertexNormals = Point3ArrayPtr(new Point3Array(nbpoints));
+    Point3Array& normals = *__vertexNormals;
+
+    double nx[NORMAL_BLOCK_SIZE], ny[NORMAL_BLOCK_SIZE], nz[NORMAL_BLOCK_SIZE];
+    for(size_t first = 0; first < __faceNb; first += NORMAL_BLOCK_SIZE){
+        size_t n = std::min<size_t>(NORMAL_BLOCK_SIZE, __faceNb - first);
+        faceBlock(NULL,first,n,nx,ny,nz);
+        for(size_t k = 0; k < n; ++k){
+            uint_t f = first + k;
+            if (__faceNormals) normalize_normal(nx[k],ny[k],nz[k],__faceNormals->getAt(f));
+            double w = 1;
+            if (__weighting != AREA_WEIGHTING) {
+                double l = sqrt(nx[k]*nx[k]+ny[k]*ny[k]+nz[k]*nz[k]);
+                w = (l > 0 && l < HUGE_VAL ? 1 / l : 0);
+            }
+            uint_t ffirst = faceBegin(f), flast = faceEnd(f);
+            for(uint_t corner = ffirst; corner < flast; ++corner){
+                uint_t v = __cornerData[corner];
+                if (v >= nbpoints) continue;
+                used[v] = true;
+                double cw = w;
+                if (__weighting == ANGLE_WEIGHTING && w > 0) {
+                    uint_t prev = (corner == ffirst ? flast : corner) - 1;
+                    uint_t next = (corner + 1 == flast ? ffirst : corner + 1);
+                    const Vector3& p = points.getAt(v);
+                    Vector3 a = points.getAt(__cornerData[prev]) - p;
+                    Vector3 b = points.getAt(__cornerData[next]) - p;
+                    cw *= atan2(norm(cross(a,b)),dot(a,b));
+                }
+                Vector3& normal = normals.getAt(v);
+                normal.x() += cw * nx[k]; normal.y() += cw * ny[k]; normal.z() += cw * nz[k];
+            }
+        }
+    }
+    for(uint_t v = 0; v < nbpoints; ++v){
+        // Points not used by any face get the x axis.
+        Vector3& normal = normals.getAt(v);
+        if (!used[v]) normal = Vector3(1,0,0);
+        else normalize_normal(normal.x(),normal.y(),normal.z(),normal);
+    }
+}
+
+/* ----------------------------------------------------------------------- */
+
+const Point3ArrayPtr& MeshNormalComputer::computeFaceNormals( )
+{
+    if (!__points) return __faceNormals;
+    if (!__faceNormals) __faceNormals = Point3ArrayPtr(new Point3Array(__faceNb));
+    allFaceVectors();
+    return __faceNormals;
+}
+
+void MeshNormalComputer::allFaceVectors( )
+{
+    __faceVectors.resize(3*__faceNb);
+    FaceVectorTask task(*this);
+    parallel_for(__faceNb,task,NORMAL_BLOCK_SIZE);
+    __faceVectorsComputed = true;
+}
+
+const Point3ArrayPtr& MeshNormalComputer::computeVertexNormals( )
+{
+    if (!__points) return __vertexNormals;
+    if (__incidenceStarts.empty() && parallel_thread_count() == 1) {
+        // A single thread scatters face normals faster than building the incidence table first.
+        // Face vectors are not stored: they are computed again if an update is requested.
+        scatterVertexNormals();
+        __faceVectorsComputed = false;
+    }
+    else {
+        allFaceVectors();
+        if (__incidenceStarts.size() != getPointNb() + 1) buildIncidence();
+        VertexNormalTask vertextask(*this);
+        parallel_for(getPointNb(),vertextask,1024);
+    }
+    return __vertexNormals;
+}
+
+void MeshNormalComputer::update( const Index& changed )
+{
+    if (!__points) return;
+    if (!__incidenceStarts.empty() && __incidenceStarts.size() != getPointNb() + 1) {
+        pglWarning("MeshNormalComputer: number of points changed. setMesh should be called.");
+        return;
+    }
+    if (!__vertexNormals || 4 * changed.size() > getPointNb()) {
+        computeVertexNormals();
+        return;
+    }
+    if (!__faceVectorsComputed) allFaceVectors();
+    if (__incidenceStarts.empty()) buildIncidence();
+
+    uint_t nbpoints = getPointNb();
+    if (__faceStamps.empty() || __stamp == uint_t(-1)) {
+        __faceStamps.assign(__faceNb,0);
+        __vertexStamps.assign(nbpoints,0);
+        __stamp = 0;
+    }
+    ++__stamp;
+
+    // Faces incident to the moved points, and vertices of these faces.
+    std::vector<uint_t> faces, vertices;
+    for(Index::const_iterator it = changed.begin(); it != changed.end(); ++it){
+        if (*it >= nbpoints) continue;
+        for(uint_t c = __incidenceStarts[*it]; c < __incidenceStarts[*it+1]; ++c){
+            uint_t f = cornerFace(__incidences[c]);
+            if (__faceStamps[f] == __stamp) continue;
+            __faceStamps[f] = __stamp;
+            faces.push_back(f);
+            for(uint_t fc = faceBegin(f); fc < faceEnd(f); ++fc){
+                uint_t v = __cornerData[fc];
+                if (v < nbpoints && __vertexStamps[v] != __stamp) {
+                    __vertexStamps[v] = __stamp;
+                    vertices.push_back(v);
+                }
+            }
+        }
+    }
+    if (faces.empty()) return;
+
+    FaceVectorTask facetask(*this,&faces[0]);
+    parallel_for(faces.size(),facetask,NORMAL_BLOCK_SIZE);
+    VertexNormalTask vertextask(*this,&vertices[0]);
+    parallel_for(vertices.size(),vertextask,1024);
+}
+
+/* ----------------------------------------------------------------------- */
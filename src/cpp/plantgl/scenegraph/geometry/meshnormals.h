@@ -0,0 +1,196 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright 1995-2007 UMR CIRAD/INRIA/INRA DAP 
+ *
+ *       File author(s): F. Boudon et al.
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+/*! \file meshnormals.h
+    \brief Definition of the class MeshNormalComputer.
+*/
+
+#ifndef __geom_meshnormals_h__
+#define __geom_meshnormals_h__
+
+/* ----------------------------------------------------------------------- */
+
+#include "mesh.h"
+#include <plantgl/scenegraph/container/indexarray.h>
+#include <vector>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/**
+   \class MeshNormalComputer
+   \brief Computes the normals of the faces and of the vertices of a Mesh.
+
+   Faces normals are computed by blocks with SIMD instructions. Vertex normals are 
+   gathered in parallel from the normals of their incident faces, stored per vertex 
+   in a compressed (CSR) incidence table. With a single thread, the first computation
+   scatters face normals to the vertices instead. After a deformation of the mesh, update() 
+   recomputes only the faces around the moved points and the normals of their vertices.
+   The point list of the mesh is shared: points can be moved in place between updates.
+   setMesh() must be called again if the faces or the number of points change.
+*/
+
+class SG_API MeshNormalComputer
+{
+
+public:
+
+  /// The weighting of the normals of the faces incident to a vertex.
+  enum Weighting {
+    /// Weighted by the area of the faces.
+    AREA_WEIGHTING,
+    /// Weighted by the angle of the faces at the vertex.
+    ANGLE_WEIGHTING,
+    /// Unweighted mean of the normals of the faces.
+    UNIFORM_WEIGHTING
+  };
+
+  /// Constructor.
+  MeshNormalComputer( Weighting weighting = AREA_WEIGHTING );
+
+  /// Constructs a normal computer for \e mesh.
+  MeshNormalComputer( const Mesh& mesh, Weighting weighting = AREA_WEIGHTING );
+
+  /// Destructor.
+  ~MeshNormalComputer( );
+
+  /** Set the mesh to process. The points and the index list of triangle and quad sets 
+      are shared. Other faces are copied. */
+  void setMesh( const Mesh& mesh );
+
+  /// Returns the weighting of faces normals.
+  inline Weighting getWeighting( ) const { return __weighting; }
+
+  /// Set the weighting of faces normals.
+  void setWeighting( Weighting weighting );
+
+  /// Compute the normals of all the faces and return them.
+  const Point3ArrayPtr& computeFaceNormals( );
+
+  /// Compute the normals of all the faces and vertices and return the vertex normals.
+  const Point3ArrayPtr& computeVertexNormals( );
+
+  /** Update the normals after the points \e changed were moved.
+      Only the faces incident to these points and the normals of their vertices are recomputed.
+      Normals are fully recomputed if a large part of the points changed. */
+  void update( const Index& changed );
+
+  /** Returns the normals of the faces computed by computeFaceNormals.
+      Updates are made in place in this array. */
+  inline const Point3ArrayPtr& getFaceNormals( ) const { return __faceNormals; }
+
+  /// Returns the normals of the vertices. Updates are made in place in this array.
+  inline const Point3ArrayPtr& getVertexNormals( ) const { return __vertexNormals; }
+
+  /// Returns the number of faces.
+  inline uint_t getFaceNb( ) const { return __faceNb; }
+
+  /// Returns the number of points.
+  inline uint_t getPointNb( ) const { return __points ? __points->size() : 0; }
+
+  /// Compute the face vectors of the faces of \e faces, or of [begin,end[ if \e faces is null.
+  void faceVectors( const uint_t * faces, size_t begin, size_t end );
+
+  /// Compute the vertex normals of the vertices of \e vertices, or of [begin,end[ if \e vertices is null.
+  void vertexNormals( const uint_t * vertices, size_t begin, size_t end );
+
+protected:
+
+  void buildIncidence( );
+  void allFaceVectors( );
+  void scatterVertexNormals( );
+  void faceBlock( const uint_t * faces, size_t first, size_t n, double * nx, double * ny, double * nz ) const;
+
+  inline uint_t faceBegin( uint_t f ) const { return __faceSize ? __faceSize * f : __faceStarts[f]; }
+  inline uint_t faceEnd( uint_t f ) const { return __faceSize ? __faceSize * (f + 1) : __faceStarts[f+1]; }
+  inline uint_t cornerFace( uint_t c ) const { return __faceSize ? c / __faceSize : __cornerFaces[c]; }
+
+  /// The points of the mesh.
+  Point3ArrayPtr __points;
+
+  /// The orientation of the faces.
+  bool __ccw;
+
+  /// The weighting of faces normals.
+  Weighting __weighting;
+
+  /// The number of corners of the faces if they all have the same, 0 otherwise.
+  uint_t __faceSize;
+
+  /// The corners of the faces. Points into the index list of triangles and quads, else into __corners.
+  const uint_t * __cornerData;
+  Index3ArrayPtr __triangleIndices;
+  Index4ArrayPtr __quadIndices;
+  std::vector<uint_t> __corners;
+
+  /// The first corner of each face, for faces of variable size.
+  std::vector<uint_t> __faceStarts;
+
+  /// The number of faces.
+  uint_t __faceNb;
+
+  /// For each vertex, the first of its incident corners in __incidences.
+  std::vector<uint_t> __incidenceStarts;
+  std::vector<uint_t> __incidences;
+
+  /// The face of each corner, for faces of variable size.
+  std::vector<uint_t> __cornerFaces;
+
+  /// The unnormalized normals of the faces, whose norm is twice their area.
+  std::vector<double> __faceVectors;
+
+  /// Whether face vectors are computed.
+  bool __faceVectorsComputed;
+
+  /// Stamps used to collect faces and vertices of an update only once.
+  std::vector<uint_t> __faceStamps;
+  std::vector<uint_t> __vertexStamps;
+  uint_t __stamp;
+
+  /// The normals of the faces.
+  Point3ArrayPtr __faceNormals;
+
+  /// The normals of the vertices.
+  Point3ArrayPtr __vertexNormals;
+};
+
+/* ----------------------------------------------------------------------- */
+
+PGL_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+// __geom_meshnormals_h__
+#endif
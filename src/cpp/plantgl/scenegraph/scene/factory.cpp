@@ -67,6 +67,13 @@ bool SceneCodec::test(const std::string& fname, Mode openingMode)
 }
 /* ----------------------------------------------------------------------- */
 
+SceneReadProcess::SceneReadProcess(const std::string& name, bool enabled):
+	__name(name), __enabled(enabled){}
+
+SceneReadProcess::~SceneReadProcess(){}
+
+/* ----------------------------------------------------------------------- */
+
 SceneFactoryPtr SceneFactory::__factory;
 
 
@@ -91,7 +98,7 @@ void SceneFactory::finalize(){
 	}
 }
 
-void SceneFactory::clear() { __codecs.clear(); }
+void SceneFactory::clear() { __codecs.clear(); __readProcesses.clear(); }
 
 SceneFormatList
 SceneFactory::formats( SceneCodec::Mode openingMode ) const
@@ -147,6 +154,7 @@ SceneFactory::read(const std::string& fname)
 					ScenePtr sc = codec->read(fname);
 					if(sc) {
 						if(get_cwd() != cwd) chg_dir(cwd);
+						applyReadProcesses(sc);
 						return sc;
 					}
 				}
@@ -190,8 +198,11 @@ ScenePtr
 SceneFactory::read(const std::string& fname, const std::string& codecname)
 {
 	SceneCodecPtr codec = findCodec(codecname);
-	if (codec) // && codec->test(fname,SceneCodec::Read))
-		return codec->read(fname);
+	if (codec) { // && codec->test(fname,SceneCodec::Read))
+		ScenePtr sc = codec->read(fname);
+		if(sc) applyReadProcesses(sc);
+		return sc;
+	}
     else {
         // if (!codec) 
 			pglError("Cannot find codec : '%s'.",codecname.c_str());
@@ -229,6 +240,55 @@ void SceneFactory::unregisterCodec(const SceneCodecPtr& codec)
 	if(it != __codecs.end())__codecs.erase(it);
 }
 
+void SceneFactory::registerReadProcess(const SceneReadProcessPtr& process)
+{
+	if(process){
+		ReadProcessList::iterator it = find(__readProcesses.begin(),__readProcesses.end(),process);
+		if(it == __readProcesses.end()) __readProcesses.push_back(process);
+	}
+}
+
+void SceneFactory::unregisterReadProcess(const SceneReadProcessPtr& process)
+{
+	ReadProcessList::iterator it = find(__readProcesses.begin(),__readProcesses.end(),process);
+	if(it != __readProcesses.end())__readProcesses.erase(it);
+}
+
+SceneReadProcessPtr 
+SceneFactory::findReadProcess(const std::string& name)
+{
+	for(ReadProcessList::const_iterator it = __readProcesses.begin();
+		it !=__readProcesses.end(); ++it){
+			if ((*it)->getName() == name) return *it;
+	}
+	return SceneReadProcessPtr();
+}
+
+bool SceneFactory::setReadProcessEnabled(const std::string& name, bool enabled)
+{
+	SceneReadProcessPtr process = findReadProcess(name);
+	if (!process) {
+		pglError("Cannot find read process : '%s'.",name.c_str());
+		return false;
+	}
+	process->setEnabled(enabled);
+	return true;
+}
+
+bool SceneFactory::isReadProcessEnabled(const std::string& name)
+{
+	SceneReadProcessPtr process = findReadProcess(name);
+	return process && process->isEnabled();
+}
+
+void SceneFactory::applyReadProcesses(const ScenePtr& scene)
+{
+	for(ReadProcessList::const_iterator it = __readProcesses.begin();
+		it !=__readProcesses.end(); ++it){
+			if ((*it)->isEnabled()) (*it)->process(scene);
+	}
+}
+
 #include <QtCore/QLibrary>
 
 bool SceneFactory::installDefaultLib()
@@ -103,6 +103,30 @@ protected:
 
 typedef RCPtr<SceneCodec> SceneCodecPtr;
 
+/**
+   \class SceneReadProcess
+   \brief A process applied by the SceneFactory on the scenes it reads, when enabled.
+*/
+
+class SG_API SceneReadProcess : public TOOLS(RefCountObject){
+public :
+	SceneReadProcess(const std::string& name, bool enabled = false);
+	virtual ~SceneReadProcess();
+
+	virtual void process(const ScenePtr& scene) = 0;
+
+    void setName(const std::string& name) { __name = name; }
+    const std::string& getName() const { return __name; }
+
+    void setEnabled(bool enabled) { __enabled = enabled; }
+    bool isEnabled() const { return __enabled; }
+protected:
+	std::string __name;
+	bool __enabled;
+};
+
+typedef RCPtr<SceneReadProcess> SceneReadProcessPtr;
+
 typedef RCPtr<SceneFactory> SceneFactoryPtr;
 
 class SG_API SceneFactory : public TOOLS(RefCountObject)
@@ -110,6 +134,7 @@ class SG_API SceneFactory : public TOOLS(RefCountObject)
 
 public:
 	typedef std::vector<SceneCodecPtr> CodecList;
+	typedef std::vector<SceneReadProcessPtr> ReadProcessList;
 
 	~SceneFactory();
 	static SceneFactory& get();
@@ -129,6 +154,14 @@ public:
 	void registerCodec(const SceneCodecPtr& codec);
 	void unregisterCodec(const SceneCodecPtr& codec);
 
+	void registerReadProcess(const SceneReadProcessPtr& process);
+	void unregisterReadProcess(const SceneReadProcessPtr& process);
+	SceneReadProcessPtr findReadProcess(const std::string& name);
+
+	/// Enables or disables the read process \e name. Returns false if no such process is registered.
+	bool setReadProcessEnabled(const std::string& name, bool enabled);
+	bool isReadProcessEnabled(const std::string& name);
+
 	bool installLib(const std::string& libname);
 	bool installDefaultLib();
 	void clear();
@@ -143,7 +176,11 @@ protected:
 
 	SceneCodecPtr findCodec(const std::string& codecname);
 
+	/// Applies the enabled read processes on \e scene.
+	void applyReadProcesses(const ScenePtr& scene);
+
 	CodecList __codecs;
+	ReadProcessList __readProcesses;
 
 private:
 	static SceneFactoryPtr __factory;
@@ -118,6 +118,18 @@ public:
 	if(_it != end()) __cache.erase(_it);
   }
 
+  /** Removes from \e self the elements associated to objects whose
+      identifier is not in \e ids. Returns the number of removed elements. */
+  template<class IdSet>
+  inline size_t retain( const IdSet& ids ) {
+	size_t _nb = 0;
+	for(Iterator _it = begin(); _it != end(); ){
+	  if(ids.find(_it->first) == ids.end()) { __cache.erase(_it++); ++_nb; }
+	  else ++_it;
+	}
+	return _nb;
+  }
+
   /// Returns whether \e self is empty.
   inline bool isEmpty( ) const {
     return __cache.empty();
@@ -61,6 +61,7 @@
 
 typedef pgl_hash_set<std::string> pgl_hash_set_string ;
 typedef pgl_hash_set<uint_t> pgl_hash_set_uint32;
+typedef pgl_hash_set<size_t> pgl_hash_set_size_t;
 
 #else
 
@@ -89,11 +90,13 @@ typedef pgl_hash_set<uint_t> pgl_hash_set_uint32;
 
 typedef pgl_hash_set<std::string, pgl_hashstr, pgl_eqstr> pgl_hash_set_string;
 typedef pgl_hash_set<uint_t,pgl_hash<uint_t>,std::equal_to<uint_t> > pgl_hash_set_uint32;
+typedef pgl_hash_set<size_t,pgl_hash<size_t>,std::equal_to<size_t> > pgl_hash_set_size_t;
 
 #else
 
 typedef pgl_hash_set<std::string> pgl_hash_set_string ;
 typedef pgl_hash_set<uint_t> pgl_hash_set_uint32;
+typedef pgl_hash_set<size_t> pgl_hash_set_size_t;
 
 
 #endif
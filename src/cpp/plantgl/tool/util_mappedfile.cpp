@@ -0,0 +1,130 @@
+/* -*-c++-*- 
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Plant Graphic Library
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *               
+ *  ----------------------------------------------------------------------------
+ * 
+ *                      GNU General Public Licence
+ *           
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */				
+
+
+
+#include "util_mappedfile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+TOOLS_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& filename) :
+  __valid(false), __data(NULL), __size(0), __file(INVALID_HANDLE_VALUE), __mapping(NULL)
+{
+  __file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (__file == INVALID_HANDLE_VALUE) return;
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(__file, &size)) return;
+  __size = size_t(size.QuadPart);
+  // Empty files cannot be mapped.
+  if (__size == 0) { __valid = true; return; }
+  __mapping = CreateFileMappingA(__file, NULL, PAGE_READONLY, 0, 0, NULL);
+  if (__mapping == NULL) return;
+  __data = (const char *)MapViewOfFile(__mapping, FILE_MAP_READ, 0, 0, 0);
+  __valid = (__data != NULL);
+}
+
+MappedFile::~MappedFile()
+{
+  if (__data) UnmapViewOfFile(__data);
+  if (__mapping) CloseHandle(__mapping);
+  if (__file != INVALID_HANDLE_VALUE) CloseHandle(__file);
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& filename) :
+  __valid(false), __data(NULL), __size(0), __file(-1)
+{
+  __file = open(filename.c_str(), O_RDONLY);
+  if (__file < 0) return;
+  struct stat info;
+  if (fstat(__file, &info) != 0 || !S_ISREG(info.st_mode)) return;
+  __size = size_t(info.st_size);
+  // Empty files cannot be mapped.
+  if (__size == 0) { __valid = true; return; }
+  void * data = mmap(NULL, __size, PROT_READ, MAP_PRIVATE, __file, 0);
+  if (data == MAP_FAILED) return;
+#ifdef MADV_SEQUENTIAL
+  madvise(data, __size, MADV_SEQUENTIAL);
+#endif
+  __data = (const char *)data;
+  __valid = true;
+}
+
+MappedFile::~MappedFile()
+{
+  if (__data) munmap((void *)__data, __size);
+  if (__file >= 0) close(__file);
+}
+
+#endif
+
+/* ----------------------------------------------------------------------- */
+
+MappedFileBuf::MappedFileBuf(const std::string& filename) :
+  std::streambuf(), __file(filename)
+{
+  if (__file.data()) {
+    char * begin = const_cast<char *>(__file.data());
+    setg(begin, begin, begin + __file.size());
+  }
+}
+
+std::streambuf::pos_type MappedFileBuf::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+{
+  if (!(which & std::ios_base::in)) return pos_type(off_type(-1));
+  off_type pos = off;
+  if (dir == std::ios_base::cur) pos += gptr() - eback();
+  else if (dir == std::ios_base::end) pos += egptr() - eback();
+  if (pos < 0 || pos > egptr() - eback()) return pos_type(off_type(-1));
+  setg(eback(), eback() + pos, egptr());
+  return pos_type(pos);
+}
+
+std::streambuf::pos_type MappedFileBuf::seekpos(pos_type pos, std::ios_base::openmode which)
+{
+  return seekoff(off_type(pos), std::ios_base::beg, which);
+}
+
+/* ----------------------------------------------------------------------- */
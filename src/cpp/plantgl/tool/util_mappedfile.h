@@ -0,0 +1,107 @@
+/* -*-c++-*- 
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Plant Graphic Library
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *               
+ *  ----------------------------------------------------------------------------
+ * 
+ *                      GNU General Public Licence
+ *           
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */				
+
+
+/*! \file util_mappedfile.h
+    \brief Read only access to the content of a file mapped in memory.
+*/
+
+#ifndef __util_mappedfile_h__
+#define __util_mappedfile_h__
+
+/* ----------------------------------------------------------------------- */
+
+#include "tools_config.h"
+#include <string>
+#include <streambuf>
+
+/* ----------------------------------------------------------------------- */
+
+TOOLS_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/*!
+  \class MappedFile
+  \brief The content of a file mapped read only in memory.
+*/
+class TOOLS_API MappedFile {
+public:
+  /// Maps the file \e filename. isValid() returns false if it cannot be opened or mapped.
+  MappedFile(const std::string& filename);
+  ~MappedFile();
+
+  bool isValid() const { return __valid; }
+  const char * data() const { return __data; }
+  size_t size() const { return __size; }
+
+protected:
+  bool __valid;
+  const char * __data;
+  size_t __size;
+#ifdef _WIN32
+  void * __file;
+  void * __mapping;
+#else
+  int __file;
+#endif
+
+private:
+  MappedFile(const MappedFile&);
+  MappedFile& operator=(const MappedFile&);
+};
+
+/*!
+  \class MappedFileBuf
+  \brief A stream buffer on a MappedFile. An std::istream built on it reads
+  the file without system calls or intermediate copies.
+*/
+class TOOLS_API MappedFileBuf : public std::streambuf {
+public:
+  MappedFileBuf(const std::string& filename);
+
+  bool isValid() const { return __file.isValid(); }
+
+protected:
+  virtual pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which);
+  virtual pos_type seekpos(pos_type pos, std::ios_base::openmode which);
+
+  MappedFile __file;
+};
+
+/* ----------------------------------------------------------------------- */
+
+TOOLS_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+// __util_mappedfile_h__
+#endif
@@ -0,0 +1,101 @@
+/* -*-c++-*- 
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Plant Graphic Library
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *               
+ *  ----------------------------------------------------------------------------
+ * 
+ *                      GNU General Public Licence
+ *           
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */				
+
+
+
+#include "util_parallel.h"
+#include <algorithm>
+
+#include <QtGlobal>
+#include <QtCore/QList>
+#include <QtCore/QThreadPool>
+#if QT_VERSION >= 0x050000 
+   #include <QtConcurrent/QtConcurrentRun>
+#else
+    #include <QtCore/QtConcurrentRun>
+#endif
+
+/* ----------------------------------------------------------------------- */
+
+TOOLS_USING_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+ParallelTask::~ParallelTask() { }
+
+size_t TOOLS(parallel_thread_count)()
+{
+  int nbthreads = QThreadPool::globalInstance()->maxThreadCount();
+  return (nbthreads > 1 ? nbthreads : 1);
+}
+
+size_t TOOLS(parallel_chunk_count)(size_t size, size_t grain)
+{
+  if (size == 0) return 0;
+  if (grain == 0) grain = 1;
+  // A few ranges per thread to balance irregular loads.
+  size_t maxchunks = 4 * parallel_thread_count();
+  size_t nbchunks = size / grain;
+  if (nbchunks == 0) nbchunks = 1;
+  return std::min(nbchunks, maxchunks);
+}
+
+size_t TOOLS(parallel_chunk_begin)(size_t size, size_t chunk, size_t nbchunks)
+{
+  if (chunk >= nbchunks) return size;
+  return (size / nbchunks) * chunk + std::min(chunk, size % nbchunks);
+}
+
+static void run_parallel_chunk(ParallelTask * task, size_t begin, size_t end, size_t chunk)
+{
+  task->run(begin,end,chunk);
+}
+
+void TOOLS(parallel_run)(size_t size, ParallelTask& task, size_t grain)
+{
+  size_t nbchunks = parallel_chunk_count(size,grain);
+  if (nbchunks == 0) return;
+  if (nbchunks == 1 || parallel_thread_count() == 1) {
+    for (size_t chunk = 0; chunk < nbchunks; ++chunk)
+      task.run(parallel_chunk_begin(size,chunk,nbchunks),parallel_chunk_begin(size,chunk+1,nbchunks),chunk);
+    return;
+  }
+  QList<QFuture<void> > futures;
+  for (size_t chunk = 0; chunk < nbchunks - 1; ++chunk)
+    futures.append(QtConcurrent::run(run_parallel_chunk, &task, 
+                                     parallel_chunk_begin(size,chunk,nbchunks),
+                                     parallel_chunk_begin(size,chunk+1,nbchunks), chunk));
+  task.run(parallel_chunk_begin(size,nbchunks-1,nbchunks),size,nbchunks-1);
+  for (QList<QFuture<void> >::iterator it = futures.begin(); it != futures.end(); ++it)
+    it->waitForFinished();
+}
+
+/* ----------------------------------------------------------------------- */
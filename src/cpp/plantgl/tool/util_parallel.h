@@ -0,0 +1,106 @@
+/* -*-c++-*- 
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Plant Graphic Library
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *               
+ *  ----------------------------------------------------------------------------
+ * 
+ *                      GNU General Public Licence
+ *           
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */				
+
+
+
+#ifndef __util_parallel_h__
+#define __util_parallel_h__
+
+/*! \file util_parallel.h
+    \brief Utility functions to process ranges of elements with the thread pool.
+*/
+
+/* ----------------------------------------------------------------------- */
+
+#include "tools_config.h"
+#include <cstddef>
+
+/* ----------------------------------------------------------------------- */
+
+TOOLS_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/*!
+  \class ParallelTask
+  \brief A task processing ranges of elements, possibly from several threads at once.
+*/
+class TOOLS_API ParallelTask {
+public:
+  virtual ~ParallelTask();
+
+  /** Process the elements [\e begin, \e end[.
+      \e chunk is the index of the range in the partition made by parallel_run. */
+  virtual void run(size_t begin, size_t end, size_t chunk) = 0;
+};
+
+/// Returns the number of threads used for parallel computations.
+TOOLS_API size_t parallel_thread_count();
+
+/** Returns the number of ranges in which [0, \e size[ is partitioned by parallel_run.
+    Each range contains at least \e grain elements, except possibly the last one. */
+TOOLS_API size_t parallel_chunk_count(size_t size, size_t grain = 1);
+
+/// Returns the first element of the range \e chunk in the partition of [0, \e size[.
+TOOLS_API size_t parallel_chunk_begin(size_t size, size_t chunk, size_t nbchunks);
+
+/** Process [0, \e size[ with \e task by ranges dispatched on the thread pool.
+    The calling thread processes the last range and returns when all ranges are processed. */
+TOOLS_API void parallel_run(size_t size, ParallelTask& task, size_t grain = 1);
+
+/* ----------------------------------------------------------------------- */
+
+/// A ParallelTask calling a functor with the arguments (begin, end, chunk).
+template<class Functor>
+class ParallelFunctorTask : public ParallelTask {
+public:
+  ParallelFunctorTask(Functor& functor) : __functor(functor) { }
+  virtual void run(size_t begin, size_t end, size_t chunk) { __functor(begin,end,chunk); }
+protected:
+  Functor& __functor;
+};
+
+/// Process [0, \e size[ with \e functor called as functor(begin, end, chunk) by ranges in parallel.
+template<class Functor>
+inline void parallel_for(size_t size, Functor& functor, size_t grain = 1)
+{
+  ParallelFunctorTask<Functor> task(functor);
+  parallel_run(size,task,grain);
+}
+
+/* ----------------------------------------------------------------------- */
+
+TOOLS_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+// __util_parallel_h__
+#endif
@@ -0,0 +1,123 @@
+/* -*-c++-*- 
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Plant Graphic Library
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *               
+ *  ----------------------------------------------------------------------------
+ * 
+ *                      GNU General Public Licence
+ *           
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */				
+
+
+
+
+
+#ifndef __util_random_h__
+#define __util_random_h__
+
+/*! \file util_random.h
+    \brief Counter based random numbers, reproducible whatever the order in which they are drawn.
+*/
+
+/* ----------------------------------------------------------------------- */
+
+#include "tools_config.h"
+#include "util_types.h"
+#include <cmath>
+
+/* ----------------------------------------------------------------------- */
+
+TOOLS_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+/** Returns a hash of \e key (finalizer of splitmix64).
+    Hashes of consecutive keys are independent enough to be used as random numbers. */
+inline uint64_t counter_hash(uint64_t key)
+{
+  key += 0x9E3779B97F4A7C15ULL;
+  key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  key = (key ^ (key >> 27)) * 0x94D049BB133111EBULL;
+  return key ^ (key >> 31);
+}
+
+/// Returns a hash of the pair (\e key1, \e key2), to derive the key of a stream from a seed and an index.
+inline uint64_t counter_hash(uint64_t key1, uint64_t key2)
+{
+  return counter_hash(counter_hash(key1) ^ key2);
+}
+
+/// Returns a random number in [0,1[ for the counter \e key.
+inline real_t counter_uniform(uint64_t key)
+{
+  return real_t(counter_hash(key) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/* ----------------------------------------------------------------------- */
+
+/**
+  \class CounterRandom
+  \brief A stream of random numbers given by the hashes of a key and a counter.
+
+  Streams with different keys are independent. A computation split among threads
+  can thus give each of its items, or each of its ranges, its own stream and get the
+  same numbers whatever the number of threads.
+*/
+class CounterRandom {
+public:
+  /// Constructs the stream \e stream of the seed \e seed.
+  CounterRandom(uint64_t seed = 0, uint64_t stream = 0) : 
+    __key(counter_hash(seed, stream)), __counter(0) { }
+
+  /// Returns a random number in [0,1[.
+  inline real_t uniform() { return counter_uniform(__key + __counter++); }
+
+  /// Returns a random number in [\e a, \e b[.
+  inline real_t uniform(real_t a, real_t b) { return a + (b - a) * uniform(); }
+
+  /// Returns a random integer in [0, \e n[.
+  inline uint64_t integer(uint64_t n) { return uint64_t(uniform() * n) % n; }
+
+  /// Returns a random number with a normal distribution (Box-Muller).
+  inline real_t normal(real_t mean = 0, real_t sigma = 1) {
+    real_t u = uniform(), v = uniform();
+    return mean + sigma * sqrt(-2 * log(1 - u)) * cos(6.283185307179586 * v);
+  }
+
+  /// Returns the number of values drawn.
+  inline uint64_t getCounter() const { return __counter; }
+
+protected:
+  uint64_t __key;
+  uint64_t __counter;
+};
+
+/* ----------------------------------------------------------------------- */
+
+TOOLS_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+// __util_random_h__
+#endif
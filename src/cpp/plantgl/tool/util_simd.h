@@ -0,0 +1,142 @@
+/* -*-c++-*- 
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: Plant Graphic Library
+ *
+ *       Copyright 2000-2009 - Cirad/Inria/Inra - Virtual Plant Team
+ *
+ *       File author(s): F. Boudon (frederic.boudon@cirad.fr) et al.
+ *               
+ *  ----------------------------------------------------------------------------
+ * 
+ *                      GNU General Public Licence
+ *           
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */				
+
+
+/*! \file util_simd.h
+    \brief Minimal abstraction of a pack of double values, mapped on AVX or SSE2 
+    registers when available and on a scalar otherwise.
+*/
+
+#ifndef __util_simd_h__
+#define __util_simd_h__
+
+#include "tools_config.h"
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define PGL_SIMD_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PGL_SIMD_SSE2
+#endif
+
+/* ----------------------------------------------------------------------- */
+
+TOOLS_BEGIN_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+#if defined(PGL_SIMD_AVX)
+
+typedef __m256d dpack;
+#define PGL_PACK_SIZE 4
+#define PGL_SIMD_INSTRUCTION_SET "avx"
+
+inline dpack pk_load(const double * p) { return _mm256_loadu_pd(p); }
+inline dpack pk_set1(double v) { return _mm256_set1_pd(v); }
+inline void  pk_store(double * p, dpack v) { _mm256_storeu_pd(p,v); }
+inline dpack pk_add(dpack a, dpack b) { return _mm256_add_pd(a,b); }
+inline dpack pk_sub(dpack a, dpack b) { return _mm256_sub_pd(a,b); }
+inline dpack pk_mul(dpack a, dpack b) { return _mm256_mul_pd(a,b); }
+inline dpack pk_min(dpack a, dpack b) { return _mm256_min_pd(a,b); }
+inline dpack pk_max(dpack a, dpack b) { return _mm256_max_pd(a,b); }
+inline dpack pk_sqrt(dpack a) { return _mm256_sqrt_pd(a); }
+inline dpack pk_abs(dpack a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0),a); }
+
+#elif defined(PGL_SIMD_SSE2)
+
+typedef __m128d dpack;
+#define PGL_PACK_SIZE 2
+#define PGL_SIMD_INSTRUCTION_SET "sse2"
+
+inline dpack pk_load(const double * p) { return _mm_loadu_pd(p); }
+inline dpack pk_set1(double v) { return _mm_set1_pd(v); }
+inline void  pk_store(double * p, dpack v) { _mm_storeu_pd(p,v); }
+inline dpack pk_add(dpack a, dpack b) { return _mm_add_pd(a,b); }
+inline dpack pk_sub(dpack a, dpack b) { return _mm_sub_pd(a,b); }
+inline dpack pk_mul(dpack a, dpack b) { return _mm_mul_pd(a,b); }
+inline dpack pk_min(dpack a, dpack b) { return _mm_min_pd(a,b); }
+inline dpack pk_max(dpack a, dpack b) { return _mm_max_pd(a,b); }
+inline dpack pk_sqrt(dpack a) { return _mm_sqrt_pd(a); }
+inline dpack pk_abs(dpack a) { return _mm_andnot_pd(_mm_set1_pd(-0.0),a); }
+
+#else
+
+typedef double dpack;
+#define PGL_PACK_SIZE 1
+#define PGL_SIMD_INSTRUCTION_SET "scalar"
+
+inline dpack pk_load(const double * p) { return *p; }
+inline dpack pk_set1(double v) { return v; }
+inline void  pk_store(double * p, dpack v) { *p = v; }
+inline dpack pk_add(dpack a, dpack b) { return a + b; }
+inline dpack pk_sub(dpack a, dpack b) { return a - b; }
+inline dpack pk_mul(dpack a, dpack b) { return a * b; }
+inline dpack pk_min(dpack a, dpack b) { return (b < a ? b : a); }
+inline dpack pk_max(dpack a, dpack b) { return (b > a ? b : a); }
+inline dpack pk_sqrt(dpack a) { return sqrt(a); }
+inline dpack pk_abs(dpack a) { return fabs(a); }
+
+#endif
+
+inline double pk_hsum(dpack v) {
+    double tmp[PGL_PACK_SIZE];
+    pk_store(tmp,v);
+    double res = tmp[0];
+    for(int i = 1; i < PGL_PACK_SIZE; ++i) res += tmp[i];
+    return res;
+}
+
+inline double pk_hmin(dpack v) {
+    double tmp[PGL_PACK_SIZE];
+    pk_store(tmp,v);
+    double res = tmp[0];
+    for(int i = 1; i < PGL_PACK_SIZE; ++i) if (tmp[i] < res) res = tmp[i];
+    return res;
+}
+
+inline double pk_hmax(dpack v) {
+    double tmp[PGL_PACK_SIZE];
+    pk_store(tmp,v);
+    double res = tmp[0];
+    for(int i = 1; i < PGL_PACK_SIZE; ++i) if (tmp[i] > res) res = tmp[i];
+    return res;
+}
+
+/* ----------------------------------------------------------------------- */
+
+TOOLS_END_NAMESPACE
+
+/* ----------------------------------------------------------------------- */
+
+// __util_simd_h__
+#endif
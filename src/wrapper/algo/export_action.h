@@ -47,6 +47,7 @@ void export_VolComputer();
 void export_SurfComputer();
 void export_AmapTranslator();
 void export_MatrixComputer();
+void export_SceneDeduplicator();
 
 // custom algo
 void export_Merge();
@@ -67,6 +68,7 @@ void export_PyPrinter();
 
 // reader export
 void export_PglReader();
+void export_LigFile();
 
 /* ----------------------------------------------------------------------- */
 // gl export
@@ -74,6 +76,7 @@ void export_GLRenderer();
 void export_GLSkelRenderer();
 void export_GLBBoxRenderer();
 void export_GLCtrlPointRenderer();
+void export_GLBatchRenderer();
 
 /* ----------------------------------------------------------------------- */
 // Turtle export
@@ -90,7 +93,10 @@ void export_SpaceColonization();
 void export_SegIntersection();
 void export_Ray();
 void export_RayIntersection();
+void export_SceneBVH();
 void export_Intersection();
+void export_LightInterception();
+void export_LidarScanner();
 
 /* ----------------------------------------------------------------------- */
 // Grid export
@@ -100,6 +106,7 @@ void export_PointGrid();
 void export_KDtree();
 void export_PyGrid();
 void export_PlaneClip();
+void export_SceneVoxelizer();
 
 /* ----------------------------------------------------------------------- */
 // CurveManipulation export
@@ -113,6 +120,10 @@ void export_Skeleton();
 // Point manip export
 void export_PointManip();
 void export_Triangulation3D();
+void export_MeshWelder();
+void export_SceneBaker();
+void export_SkeletonPipeline();
+void export_KMeansClustering();
 
 // Dijkstra shortest path
 void export_Dijkstra();
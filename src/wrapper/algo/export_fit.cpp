@@ -31,6 +31,7 @@
 
 #include <plantgl/python/export_property.h>
 #include <plantgl/algo/fitting/fit.h>
+#include <plantgl/algo/fitting/batchfit.h>
 #include <plantgl/algo/base/discretizer.h>
 #include <boost/python.hpp>
 
@@ -106,6 +107,7 @@ void export_Fit()
     .def("__call__",&Fit::use)
 	.add_property("points",&Fit::getPoints,&Fit::setPoints)
 	.add_property("radius",&Fit::getRadius,&Fit::setRadius)
+	.add_property("qhullUse",&Fit::getQhullUse,&Fit::setQhullUse)
     .def("sphere",&Fit::sphere)
     .def("asphere",&Fit::asphere)
     .def("bsphere",&Fit::bsphere)
@@ -149,6 +151,19 @@ void export_Fit()
     ;
   
   
+  class_< BatchFit, boost::noncopyable > ("BatchFit", init<Point3ArrayPtr,IndexArrayPtr>
+     ( "BatchFit(points,groups) Fit a volume on each group of points. The groups are processed in parallel.",args("points","groups")))
+    .def("fit",&BatchFit::fit,args("classname"))
+    .def("__len__",&BatchFit::size)
+    .def("getPointList",&BatchFit::getPointList,return_value_policy<copy_const_reference>())
+    .def("getIndexList",&BatchFit::getIndexList,return_value_policy<copy_const_reference>())
+    .def("getPointOffsets",&BatchFit::getPointOffsets,return_value_policy<copy_const_reference>())
+    .def("getIndexOffsets",&BatchFit::getIndexOffsets,return_value_policy<copy_const_reference>())
+    .def("getVolumes",&BatchFit::getVolumes,return_value_policy<copy_const_reference>())
+    .def("getAreas",&BatchFit::getAreas,return_value_policy<copy_const_reference>())
+    .def("getMesh",&BatchFit::getMesh,args("group"))
+    ;
+
   def("fit",&fit,args("algo","src"));
   def("inertiaAxis",inertiaAxis,args("points"));
   def("inertiaAxis",inertiaAxis2d,args("points"));
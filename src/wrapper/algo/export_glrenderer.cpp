@@ -36,8 +36,11 @@
 #include <plantgl/algo/base/discretizer.h>
 #include <plantgl/algo/base/skelcomputer.h>
 #include <plantgl/algo/base/bboxcomputer.h>
+#include <plantgl/algo/base/sceneobjectcollector.h>
+#include <plantgl/scenegraph/scene/scene.h>
 #include <plantgl/algo/opengl/glbboxrenderer.h>
 #include <plantgl/algo/opengl/glctrlptrenderer.h>
+#include <plantgl/algo/opengl/glbatchrenderer.h>
 #include <plantgl/scenegraph/appearance/texture.h>
 
 #include <QtOpenGL/qgl.h>
@@ -65,6 +68,16 @@ void py_setGLFrame(GLRenderer * rd, boost::python::object widget){
 	rd->setGLFrame(extract_widget<QGLWidget>(widget)());
 }
 
+void py_retain(GLRenderer * rd, const ScenePtr& scene)
+{
+	SceneObjectCollector objects;
+	scene->apply(objects);
+	rd->retain(objects.getIds());
+}
+
+GLuint py_getDisplayList(GLRenderer * rd, const SceneObjectPtr& obj)
+{ return rd->getDisplayList(obj->getId()); }
+
 void export_GLRenderer()
 {
   scope glrenderer = class_< GLRenderer,bases< Action >,boost::noncopyable >
@@ -73,6 +86,8 @@ void export_GLRenderer()
     .def("beginSceneList",&GLRenderer::beginSceneList)
     .def("endSceneList",&GLRenderer::endSceneList)
     .def("clearSceneList",&GLRenderer::clearSceneList)
+    .def("retain",&py_retain,"retain(scene) : Remove from the cache the display lists of the objects that are not part of scene.")
+    .def("getDisplayList",&py_getDisplayList,"getDisplayList(object) : Return the display list of object, or 0 if it is not cached.")
 	.def("setGLFrame",&py_setGLFrame)
 	.add_property("renderingMode",&get_rd_mode,&GLRenderer::setRenderingMode)
 	.add_property("selectionMode",&get_sel_mode,&GLRenderer::setSelectionMode)
@@ -114,6 +129,30 @@ void export_GLBBoxRenderer()
 	;
 }
 
+size_t get_batch_nb(GLBatchRenderer * rd) { return rd->getBatches().size(); }
+
+boost::python::list get_batches(GLBatchRenderer * rd)
+{
+	boost::python::list result;
+	for (std::vector<GLBatchRenderer::Batch>::const_iterator it = rd->getBatches().begin(); it != rd->getBatches().end(); ++it)
+		result.append(make_tuple(it->appearance, it->firstIndex, it->indexCount));
+	return result;
+}
+
+boost::python::tuple py_encodePosition(uint_t position)
+{
+	GLubyte rgba[4];
+	GLBatchRenderer::encodePosition(position, rgba);
+	return make_tuple(int(rgba[0]), int(rgba[1]), int(rgba[2]), int(rgba[3]));
+}
+
+uint_t py_decodePosition(boost::python::object rgba)
+{
+	GLubyte code[4];
+	for (int i = 0; i < 4; ++i) code[i] = GLubyte(extract<int>(rgba[i])());
+	return GLBatchRenderer::decodePosition(code);
+}
+
 AppearancePtr get_default_app() { return GLCtrlPointRenderer::DEFAULT_APPEARANCE; }
 void set_default_app(AppearancePtr p) { GLCtrlPointRenderer::DEFAULT_APPEARANCE = p; }
 
@@ -125,4 +164,27 @@ void export_GLCtrlPointRenderer()
 	;
 }
 
+void export_GLBatchRenderer()
+{
+	class_< GLBatchRenderer,boost::noncopyable >
+    ( "GLBatchRenderer", init<>("GLBatchRenderer() Render a whole scene with a few draw calls by packing its shapes into buffers grouped by appearance."))
+	.def("build",&GLBatchRenderer::build)
+	.def("clear",&GLBatchRenderer::clear)
+	.def("isBuilt",&GLBatchRenderer::isBuilt)
+	.def("render",&GLBatchRenderer::render)
+	.def("renderIds",&GLBatchRenderer::renderIds)
+	.def("select",&GLBatchRenderer::select, (bp::arg("x"),bp::arg("y"),bp::arg("w")=1,bp::arg("h")=1))
+	.def("getUnbatchedShapes",&GLBatchRenderer::getUnbatchedShapes, return_value_policy<copy_const_reference>())
+	.def("getTriangleNb",&GLBatchRenderer::getTriangleNb)
+	.def("getVertexNb",&GLBatchRenderer::getVertexNb)
+	.def("getBatchNb",&get_batch_nb)
+	.def("getBatches",&get_batches,"getBatches() : Return a list of (appearance, firstIndex, indexCount) for each batch.")
+	.def("encodePosition",&py_encodePosition,"encodePosition(position) : Return the (r,g,b,a) color encoding a shape position for selection.")
+	.staticmethod("encodePosition")
+	.def("decodePosition",&py_decodePosition,"decodePosition(rgba) : Return the shape position encoded by a color, or 4294967295 for the background.")
+	.staticmethod("decodePosition")
+	.def("useBufferObjects",&GLBatchRenderer::useBufferObjects)
+	;
+}
+
 /* ----------------------------------------------------------------------- */
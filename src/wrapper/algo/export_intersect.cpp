@@ -32,6 +32,10 @@
 #include <plantgl/python/export_property.h>
 #include <plantgl/algo/raycasting/util_intersection.h>
 #include <plantgl/algo/raycasting/rayintersection.h>
+#include <plantgl/algo/raycasting/scenebvh.h>
+#include <plantgl/algo/raycasting/occlusionbuffer.h>
+#include <plantgl/algo/base/bboxcomputer.h>
+#include <plantgl/python/export_list.h>
 #include <plantgl/algo/base/discretizer.h>
 #include <plantgl/algo/base/intersection.h>
 #include <plantgl/scenegraph/geometry/geometry.h>
@@ -161,6 +165,60 @@ void export_RayIntersection()
 }
 
 
+object py_scenebvh_intersect( SceneBVH * self, const Ray& ray )
+{
+  uint_t position;
+  real_t distance;
+  if (self->intersect(ray, position, distance)) return make_tuple(position, distance);
+  return object();
+}
+
+object py_scenebvh_select( SceneBVH * self, const ViewFrustum& frustum )
+{ return make_list(self->select(frustum))(); }
+
+object py_scenebvh_cull( SceneBVH * self, const ViewFrustum& frustum, OcclusionBuffer * occlusion = NULL )
+{ return make_list(self->cull(frustum, occlusion))(); }
+
+BOOST_PYTHON_FUNCTION_OVERLOADS(py_scenebvh_cull_overloads, py_scenebvh_cull, 2, 3)
+
+void export_SceneBVH()
+{
+  {
+  scope frustum = class_< ViewFrustum > ("ViewFrustum", init<optional<const Matrix4&> >("ViewFrustum([Matrix4 clip]) The volume seen by a camera whose clip matrix (projection * modelview) is given.", args("clip")) )
+    .def("contains",&ViewFrustum::contains,args("point"))
+    .def("locate",(BVH::Location(ViewFrustum::*)(const Vector3&,const Vector3&) const)&ViewFrustum::locate,args("lower","upper"),"locate(lower,upper) -> location of the box [lower,upper] relatively to the frustum: Outside, Intersecting or Inside")
+    .def("intersect",(bool(ViewFrustum::*)(const Vector3&,const Vector3&,const Vector3&) const)&ViewFrustum::intersect,args("a","b","c"))
+    .def("intersect",(bool(ViewFrustum::*)(const Vector3&,const Vector3&) const)&ViewFrustum::intersect,args("a","b"))
+    .def("getPlane",&ViewFrustum::getPlane,return_value_policy<copy_const_reference>(),args("i"))
+    .def("setPlane",&ViewFrustum::setPlane,args("i","plane"))
+    ;
+
+  enum_<BVH::Location>("Location")
+    .value("Outside",BVH::Outside)
+    .value("Intersecting",BVH::Intersecting)
+    .value("Inside",BVH::Inside)
+    .export_values()
+    ;
+  }
+
+  class_< SceneBVH, boost::noncopyable > ("SceneBVH", init<BBoxComputer&>("SceneBVH(BBoxComputer b) A hierarchy of the bounding boxes of the shapes of a scene for picking and selection.", args("bboxcomputer"))[with_custodian_and_ward<1,2>()] )
+    .def("build",&SceneBVH::build,args("scene"))
+    .def("clear",&SceneBVH::clear)
+    .def("isBuilt",&SceneBVH::isBuilt)
+    .def("intersect",&py_scenebvh_intersect,args("ray"),"intersect(ray) -> (position, distance) of the nearest shape hit by the ray or None")
+    .def("select",&py_scenebvh_select,args("frustum"),"select(frustum) -> positions of the shapes with a part in the frustum")
+    .def("cull",&py_scenebvh_cull,py_scenebvh_cull_overloads(args("frustum","occlusion"),"cull(frustum[,occlusion]) -> positions of the shapes to draw"))
+    ;
+
+  class_< OcclusionBuffer, boost::noncopyable > ("OcclusionBuffer", init<optional<uint_t,uint_t> >("OcclusionBuffer([width,height]) A coarse depth buffer to find boxes hidden by triangles.", args("width","height")) )
+    .def("setClipMatrix",&OcclusionBuffer::setClipMatrix,args("clip"))
+    .def("clear",&OcclusionBuffer::clear)
+    .def("isOccluded",&OcclusionBuffer::isOccluded,args("lower","upper"))
+    .def("addTriangle",&OcclusionBuffer::addTriangle,args("a","b","c"))
+    ;
+}
+
+
 object py_polygon2ds_intersection_1(Point2ArrayPtr polygon1, Point2ArrayPtr polygon2)
 {
     std::pair<Point2ArrayPtr, IndexArrayPtr> result = polygon2ds_intersection(polygon1, polygon2);
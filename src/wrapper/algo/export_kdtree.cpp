@@ -32,6 +32,7 @@
 #include <plantgl/python/export_refcountptr.h>
 #include <plantgl/python/boost_python.h>
 #include <plantgl/algo/grid/kdtree.h>
+#include <plantgl/algo/grid/capsuletree.h>
 
 PGL_USING_NAMESPACE
 TOOLS_USING_NAMESPACE
@@ -64,6 +65,43 @@ KDTree4Ptr init_kdtree4(const Point4ArrayPtr points) { return KDTree4Ptr(new ANN
 
 #endif
 
+boost::python::object ct_closest_capsule(CapsuleTree * tree, const Vector3& point, CapsuleTree::DistanceType dtype, real_t maxdist)
+{
+    uint32_t capsule; real_t u;
+    real_t d = tree->closest_capsule(point, capsule, u, dtype, maxdist);
+    if (capsule == UINT32_MAX) return boost::python::object();
+    return boost::python::make_tuple(capsule, d, u);
+}
+
+Uint32Array1Ptr ct_closest_capsules(CapsuleTree * tree, const Point3ArrayPtr& points, CapsuleTree::DistanceType dtype)
+{ return tree->closest_capsules(points, dtype); }
+
+void export_CapsuleTree()
+{
+  class_< CapsuleTree, CapsuleTreePtr, boost::noncopyable > ct
+      ("CapsuleTree", "CapsuleTree(nodes, parents[, radii, leafsize]) -> a bounding volume hierarchy over the segments of a skeleton, seen as capsules with interpolated radii.",
+       init<Point3ArrayPtr, Uint32Array1Ptr, bp::optional<RealArrayPtr, uint32_t> >((bp::arg("nodes"),bp::arg("parents"),bp::arg("radii")=RealArrayPtr(),bp::arg("leafsize")=4)));
+
+  {
+    // the enum is needed for the default values of the methods
+    scope ctscope = ct;
+    enum_<CapsuleTree::DistanceType>("DistanceType")
+      .value("eAxisDistance",CapsuleTree::eAxisDistance)
+      .value("eSignedDistance",CapsuleTree::eSignedDistance)
+      .value("eAbsoluteDistance",CapsuleTree::eAbsoluteDistance)
+      .export_values()
+      ;
+  }
+
+  ct.def("closest_capsule", &ct_closest_capsule, (bp::arg("point"),bp::arg("dtype")=CapsuleTree::eSignedDistance,bp::arg("maxdist")=REAL_MAX),"Return (capsule, distance, u) for the closest capsule of point, or None if no capsule is closer than maxdist.")
+    .def("closest_capsules", &ct_closest_capsules, (bp::arg("points"),bp::arg("dtype")=CapsuleTree::eSignedDistance),"Return the id of the closest capsule of each point.")
+    .def("distances", &CapsuleTree::distances, (bp::arg("points"),bp::arg("dtype")=CapsuleTree::eSignedDistance),"Return the distance of each point to its closest capsule.")
+    .def("points_at_distance", &CapsuleTree::points_at_distance, (bp::arg("points"),bp::arg("distance"),bp::arg("dtype")=CapsuleTree::eAxisDistance,bp::arg("reversed")=false),"Return indices of the points whose distance to the closest capsule is below distance, or above it if reversed.")
+    .def("size", &CapsuleTree::size, "Return the number of capsules.")
+    .def("__len__", &CapsuleTree::size, "Return the number of capsules.")
+    ;
+}
+
 void export_KDtree()
 {
   class_< AbstractKDTree2, KDTree2Ptr, boost::noncopyable > ("AbstractKDTree2", no_init )
@@ -94,6 +132,8 @@ void export_KDtree()
   def("KDTree4", init_kdtree4, args("points"), "Construct a KD-Tree from a set of 4D points.");
 
 #endif
+
+  export_CapsuleTree();
 }
 
 
@@ -0,0 +1,86 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright 1995-2007 UMR CIRAD/INRIA/INRA DAP 
+ *
+ *       File author(s): F. Boudon et al.
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+
+#include <plantgl/python/export_refcountptr.h>
+#include <plantgl/algo/base/kmeansclustering.h>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_USING_NAMESPACE
+TOOLS_USING_NAMESPACE
+using namespace boost::python;
+#define bp boost::python
+
+object py_km_process(KMeansClustering * clustering, const Point3ArrayPtr& points, const Point3ArrayPtr& centroids)
+{
+    if (!clustering->process(points, centroids)) return object();
+    return make_tuple(clustering->getCentroids(), clustering->getAssignments());
+}
+
+object py_km_assign(KMeansClustering * clustering, const Point3ArrayPtr& points, const Point3ArrayPtr& centroids)
+{
+    if (!clustering->assign(points, centroids)) return object();
+    return object(clustering->getAssignments());
+}
+
+object py_kmeans_points(const Point3ArrayPtr& points, const Point3ArrayPtr& centroids, uint32_t maxiterations, real_t tolerance)
+{
+    KMeansClustering clustering(maxiterations, tolerance);
+    return py_km_process(&clustering, points, centroids);
+}
+
+void export_KMeansClustering()
+{
+    class_< KMeansClustering, boost::noncopyable >
+        ("KMeansClustering", "KMeansClustering([maxIterations, tolerance]) -> clusters points by k-means with bounds on the distances to the centroids.",
+         init<bp::optional<uint32_t, real_t> >((bp::arg("maxIterations")=100,bp::arg("tolerance")=0)))
+        .def("process",&py_km_process,(bp::arg("points"),bp::arg("centroids")),"Cluster points from the initial centroids and returns (centroids, assignments), or None if there is no centroid.")
+        .def("assign",&py_km_assign,(bp::arg("points"),bp::arg("centroids")),"Assign each point to its closest centroid and returns the assignments, or None if there is no centroid.")
+        .def("iterate",&KMeansClustering::iterate,"Do one more iteration and returns the number of points that changed of cluster.")
+        .def("clear",&KMeansClustering::clear)
+        .def("getCentroids",&KMeansClustering::getCentroids)
+        .def("getAssignments",&KMeansClustering::getAssignments,"Return the cluster of each point.")
+        .def("getClusters",&KMeansClustering::getClusters,"Return the points of each cluster.")
+        .def("getClusterSizes",&KMeansClustering::getClusterSizes)
+        .def("getIterationCount",&KMeansClustering::getIterationCount)
+        .def("getChangedCount",&KMeansClustering::getChangedCount)
+        .add_property("maxIterations",&KMeansClustering::getMaxIterations,&KMeansClustering::setMaxIterations)
+        .add_property("tolerance",&KMeansClustering::getTolerance,&KMeansClustering::setTolerance)
+        ;
+
+    def("kmeans_points",&py_kmeans_points,
+        (bp::arg("points"),bp::arg("centroids"),bp::arg("maxiterations")=100,bp::arg("tolerance")=0),
+        "Cluster points by k-means from the initial centroids and returns (centroids, assignments).");
+}
+
+/* ----------------------------------------------------------------------- */
@@ -0,0 +1,86 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright 1995-2007 UMR CIRAD/INRIA/INRA DAP 
+ *
+ *       File author(s): F. Boudon et al.
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+
+#include <plantgl/python/export_refcountptr.h>
+#include <plantgl/algo/raycasting/lidarscanner.h>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_USING_NAMESPACE
+TOOLS_USING_NAMESPACE
+using namespace boost::python;
+#define bp boost::python
+
+object py_ls_process( LidarScanner * scanner, const ScenePtr& scene )
+{
+  if (!scanner->process(scene)) return object();
+  return make_tuple(scanner->getPoints(), scanner->getShapeIds(), scanner->getIntensities(), 
+                    scanner->getReturnNumbers(), scanner->getReturnCounts());
+}
+
+void export_LidarScanner()
+{
+  class_< LidarScanner, boost::noncopyable >
+      ("LidarScanner", "LidarScanner([angularResolution, seed]) -> simulation of terrestrial and airborne LiDAR scans of a scene.",
+       init<bp::optional<real_t, uint32_t> >((bp::arg("angularResolution")=0.001,bp::arg("seed")=0)))
+    .def("addTerrestrialScan", &LidarScanner::addTerrestrialScan, 
+         (bp::arg("position"),bp::arg("azimuthMin")=0,bp::arg("azimuthMax")=GEOM_TWO_PI,bp::arg("elevationMin")=-GEOM_HALF_PI/2,bp::arg("elevationMax")=GEOM_HALF_PI),
+         "Add a terrestrial scan from position on a grid of azimuths and elevations, in radians.")
+    .def("addAirborneScan", &LidarScanner::addAirborneScan, 
+         (bp::arg("start"),bp::arg("end"),bp::arg("scanAngle")=GEOM_PI/6,bp::arg("lineSpacing")=0.1),
+         "Add an airborne scan along the flight line from start to end, sweeping across the track from -scanAngle to scanAngle.")
+    .def("clearScans", &LidarScanner::clearScans)
+    .def("getScanCount", &LidarScanner::getScanCount)
+    .def("getPulseCount", &LidarScanner::getPulseCount)
+    .add_property("angularResolution", &LidarScanner::getAngularResolution, &LidarScanner::setAngularResolution)
+    .add_property("beamDivergence", &LidarScanner::getBeamDivergence, &LidarScanner::setBeamDivergence)
+    .add_property("beamSampleCount", &LidarScanner::getBeamSampleCount, &LidarScanner::setBeamSampleCount)
+    .add_property("returnSeparation", &LidarScanner::getReturnSeparation, &LidarScanner::setReturnSeparation)
+    .add_property("maxReturns", &LidarScanner::getMaxReturns, &LidarScanner::setMaxReturns)
+    .add_property("maxRange", &LidarScanner::getMaxRange, &LidarScanner::setMaxRange)
+    .add_property("rangeNoise", &LidarScanner::getRangeNoise, &LidarScanner::setRangeNoise)
+    .add_property("angularNoise", &LidarScanner::getAngularNoise, &LidarScanner::setAngularNoise)
+    .add_property("seed", &LidarScanner::getSeed, &LidarScanner::setSeed)
+    .def("process", &py_ls_process, (bp::arg("scene")), 
+         "Scan scene and returns (points, shapeids, intensities, returnnumbers, returncounts), or None if nothing can be scanned.")
+    .def("clear", &LidarScanner::clear)
+    .def("getPoints", &LidarScanner::getPoints, return_value_policy<copy_const_reference>())
+    .def("getShapeIds", &LidarScanner::getShapeIds, return_value_policy<copy_const_reference>())
+    .def("getIntensities", &LidarScanner::getIntensities, return_value_policy<copy_const_reference>())
+    .def("getReturnNumbers", &LidarScanner::getReturnNumbers, return_value_policy<copy_const_reference>())
+    .def("getReturnCounts", &LidarScanner::getReturnCounts, return_value_policy<copy_const_reference>())
+    .def("getScanIds", &LidarScanner::getScanIds, return_value_policy<copy_const_reference>())
+    ;
+}
+
+/* ----------------------------------------------------------------------- */
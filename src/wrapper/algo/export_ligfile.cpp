@@ -0,0 +1,100 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright 1995-2007 UMR CIRAD/INRIA/INRA DAP 
+ *
+ *       File author(s): F. Boudon et al.
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+
+
+#include <plantgl/python/export_refcountptr.h>
+#include <plantgl/algo/codec/ligfile.h>
+#include <plantgl/scenegraph/scene/scene.h>
+#include <plantgl/scenegraph/geometry/boundingbox.h>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_USING_NAMESPACE
+TOOLS_USING_NAMESPACE
+using namespace boost::python;
+#define bp boost::python
+
+ScenePtr py_readLineTree(const std::string& ligFile, const std::string& dtaFile, const std::string& smbpath, bool bigendian)
+{ return readLineTree(ligFile, dtaFile, smbpath, bigendian); }
+
+ScenePtr py_readLineTreeByChunks(const std::string& ligFile, const std::string& dtaFile, const std::string& smbpath, 
+                                 bool bigendian, uint_t chunkSize)
+{ return readLineTreeByChunks(ligFile, dtaFile, smbpath, bigendian, chunkSize); }
+
+list py_computeLineTreeStatistics(const std::string& ligFile, const std::string& dtaFile, const std::string& smbpath, 
+                                  bool bigendian, bool surface, bool bbox, uint_t chunkSize)
+{
+    LigSymbolStatisticsList stats = computeLineTreeStatistics(ligFile, dtaFile, smbpath, bigendian, surface, bbox, chunkSize);
+    list result;
+    for (LigSymbolStatisticsList::const_iterator it = stats.begin(); it != stats.end(); ++it)
+        result.append(*it);
+    return result;
+}
+
+BoundingBoxPtr py_lss_bbox(const LigSymbolStatistics& stats) { return stats.bbox; }
+
+void export_LigFile()
+{
+    class_< LigSymbolStatistics >("LigSymbolStatistics", "Statistics on all the instances of a symbol of a Linetree.", no_init)
+        .def_readonly("symbol",&LigSymbolStatistics::symbol)
+        .def_readonly("count",&LigSymbolStatistics::count)
+        .def_readonly("invalid",&LigSymbolStatistics::invalid)
+        .def_readonly("surface",&LigSymbolStatistics::surface)
+        .add_property("bbox",&py_lss_bbox)
+        ;
+
+    class_< LigSceneReader, boost::noncopyable >
+        ("LigSceneReader", "LigSceneReader(ligFile, dtaFile, smbpath[, bigendian, chunkSize]) -> reads the scene of a Linetree chunk by chunk.",
+         init<const std::string&, const std::string&, const std::string&, bp::optional<bool, uint_t> >
+             ((bp::arg("ligFile"),bp::arg("dtaFile"),bp::arg("smbpath"),bp::arg("bigendian")=true,bp::arg("chunkSize")=65536)))
+        .def("nextScene",&LigSceneReader::nextScene,"Return the shapes of the next chunk of records in the order of the file, or None at the end.")
+        .def("rewind",&LigSceneReader::rewind)
+        .def("atEnd",&LigSceneReader::atEnd)
+        .def("isValid",&LigSceneReader::isValid)
+        .def("__len__",&LigSceneReader::getSize)
+        .add_property("size",&LigSceneReader::getSize)
+        .add_property("position",&LigSceneReader::getPosition)
+        ;
+
+    def("readLineTree",&py_readLineTree,(bp::arg("ligFile"),bp::arg("dtaFile"),bp::arg("smbpath"),bp::arg("bigendian")=true),
+        "Read the scene of a Linetree.");
+    def("readLineTreeByChunks",&py_readLineTreeByChunks,
+        (bp::arg("ligFile"),bp::arg("dtaFile"),bp::arg("smbpath"),bp::arg("bigendian")=true,bp::arg("chunkSize")=65536),
+        "Read the scene of a Linetree by chunks of chunkSize records. Shapes are in the order of the file, as with readLineTree.");
+    def("computeLineTreeStatistics",&py_computeLineTreeStatistics,
+        (bp::arg("ligFile"),bp::arg("dtaFile"),bp::arg("smbpath"),bp::arg("bigendian")=true,
+         bp::arg("surface")=true,bp::arg("bbox")=true,bp::arg("chunkSize")=65536),
+        "Return the number of instances, the surface and the bounding box of each symbol of a Linetree, without building its scene.");
+}
+
+/* ----------------------------------------------------------------------- */
@@ -0,0 +1,81 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright 1995-2007 UMR CIRAD/INRIA/INRA DAP 
+ *
+ *       File author(s): F. Boudon et al.
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+
+#include <plantgl/python/export_refcountptr.h>
+#include <plantgl/algo/raycasting/lightinterception.h>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_USING_NAMESPACE
+TOOLS_USING_NAMESPACE
+using namespace boost::python;
+#define bp boost::python
+
+void export_LightInterception()
+{
+  class_< LightInterception, boost::noncopyable > li
+      ("LightInterception", "LightInterception([raySpacing, seed]) -> Monte-Carlo estimation of the light intercepted by the shapes of a scene from a discretized sky.",
+       init<bp::optional<real_t, uint32_t> >((bp::arg("raySpacing")=0.01,bp::arg("seed")=0)));
+
+  {
+    // the enum is needed for the default values of the methods
+    scope liscope = li;
+    enum_<LightInterception::SkyType>("SkyType")
+      .value("eUniformOvercast",LightInterception::eUniformOvercast)
+      .value("eStandardOvercast",LightInterception::eStandardOvercast)
+      .export_values()
+      ;
+  }
+
+  li.def("setSky", &LightInterception::setSky, (bp::arg("directions"),bp::arg("weights")), "Set the sky as directions pointing to the sky with their weights on the irradiance of a horizontal surface.")
+    .def("setTurtleSky", &LightInterception::setTurtleSky, (bp::arg("type")=LightInterception::eStandardOvercast), "Set the sky as the 46 sectors of the turtle.")
+    .def("getSkyDirections", &LightInterception::getSkyDirections, return_value_policy<copy_const_reference>())
+    .def("getSkyWeights", &LightInterception::getSkyWeights, return_value_policy<copy_const_reference>())
+    .def("setPeriodicDomain", &LightInterception::setPeriodicDomain, (bp::arg("lower"),bp::arg("upper")), "Repeat the scene periodically on the horizontal domain [lower, upper].")
+    .def("unsetPeriodicDomain", &LightInterception::unsetPeriodicDomain)
+    .def("isPeriodic", &LightInterception::isPeriodic)
+    .add_property("raySpacing", &LightInterception::getRaySpacing, &LightInterception::setRaySpacing)
+    .add_property("seed", &LightInterception::getSeed, &LightInterception::setSeed)
+    .def("process", &LightInterception::process, (bp::arg("scene")), "Compute the energy intercepted by the shapes of scene, for an irradiance of 1 on a horizontal surface.")
+    .def("clear", &LightInterception::clear)
+    .def("getShapeEnergies", &LightInterception::getShapeEnergies, "Return the energy intercepted by each shape, in the order of the scene.")
+    .def("getShapeIrradiances", &LightInterception::getShapeIrradiances, "Return the energy intercepted by each shape divided by its area.")
+    .def("getShapeAreas", &LightInterception::getShapeAreas)
+    .def("getShapeIds", &LightInterception::getShapeIds)
+    .def("getIncidentEnergy", &LightInterception::getIncidentEnergy, "Return the energy carried by all the rays.")
+    .def("getTransmittedEnergy", &LightInterception::getTransmittedEnergy, "Return the energy of the rays that hit no shape.")
+    .def("getRayCount", &LightInterception::getRayCount)
+    ;
+}
+
+/* ----------------------------------------------------------------------- */
@@ -0,0 +1,72 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright 1995-2007 UMR CIRAD/INRIA/INRA DAP 
+ *
+ *       File author(s): F. Boudon et al.
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+#include <plantgl/python/export_refcountptr.h>
+#include <plantgl/algo/base/meshwelder.h>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_USING_NAMESPACE
+using namespace boost::python;
+#define bp boost::python
+
+object py_weld_points(const Point3ArrayPtr& points, real_t tolerance)
+{
+    Index remap;
+    Point3ArrayPtr result = weld_points(points,tolerance,remap);
+    return make_tuple(result,remap);
+}
+
+template<class MeshPtrType>
+object py_weld_vertices(const MeshPtrType& mesh, real_t tolerance)
+{
+    MeshWeldStatistics stats;
+    MeshPtrType result = weld_vertices(mesh,tolerance,&stats);
+    return make_tuple(result,stats);
+}
+
+void export_MeshWelder()
+{
+    class_<MeshWeldStatistics>("MeshWeldStatistics", "Statistics on a welding of mesh vertices.", init<>())
+        .def_readonly("inputPoints",&MeshWeldStatistics::inputPoints)
+        .def_readonly("outputPoints",&MeshWeldStatistics::outputPoints)
+        .def_readonly("inputFaces",&MeshWeldStatistics::inputFaces)
+        .def_readonly("outputFaces",&MeshWeldStatistics::outputFaces)
+        ;
+
+    def("weld_points",&py_weld_points,(bp::arg("points"),bp::arg("tolerance")=GEOM_EPSILON));
+    def("weld_vertices",&py_weld_vertices<TriangleSetPtr>,(bp::arg("mesh"),bp::arg("tolerance")=GEOM_EPSILON));
+    def("weld_vertices",&py_weld_vertices<QuadSetPtr>,(bp::arg("mesh"),bp::arg("tolerance")=GEOM_EPSILON));
+    def("weld_vertices",&py_weld_vertices<FaceSetPtr>,(bp::arg("mesh"),bp::arg("tolerance")=GEOM_EPSILON));
+}
+
+/* ----------------------------------------------------------------------- */
@@ -30,6 +30,8 @@
  */
 
 #include <plantgl/algo/base/pointmanipulation.h>
+#include <plantgl/algo/base/eigenkernels.h>
+#include <plantgl/algo/base/pointfilters.h>
 #include <boost/python.hpp>
 #include <plantgl/python/export_list.h>
 
@@ -51,6 +53,32 @@ using namespace boost::python;
 /* ----------------------------------------------------------------------- */
 
 
+object py_delaunay_point_connection_csr(const Point3ArrayPtr points)
+{
+    Uint32Array1Ptr offsets, neighbors;
+    if (!delaunay_point_connection(points, offsets, neighbors)) return object();
+    return make_tuple(offsets, neighbors);
+}
+
+object py_voxel_downsample(const Point3ArrayPtr points, real_t voxelsize, bool attributes, const Color4ArrayPtr colors)
+{
+    if (!attributes) return object(voxel_downsample(points, voxelsize));
+    Point3ArrayPtr meanpoints;
+    Uint32Array1Ptr counts;
+    Color4ArrayPtr meancolors;
+    Index result = voxel_downsample(points, voxelsize, meanpoints, counts, colors, meancolors);
+    if (meancolors) return make_tuple(result, meanpoints, counts, meancolors);
+    return make_tuple(result, meanpoints, counts);
+}
+
+object py_statistical_outlier_filter(const Point3ArrayPtr points, uint32_t k, real_t stdratio, bool meandistances)
+{
+    if (!meandistances) return object(statistical_outlier_filter(points, k, stdratio));
+    RealArrayPtr distances;
+    Index result = statistical_outlier_filter(points, k, stdratio, distances);
+    return make_tuple(result, distances);
+}
+
 object py_points_dijkstra_shortest_path(const Point3ArrayPtr points, 
                                         const IndexArrayPtr adjacencies, 
                                         uint32_t root)
@@ -97,6 +125,36 @@ py_determine_children(const TOOLS(Uint32Array1Ptr) parents)
     return make_tuple(children,root);
 }
 
+object py_pointsets_orientations(const Point3ArrayPtr points, const IndexArrayPtr groups, bool features)
+{
+    if (!features) return object(pointsets_orientations(points,groups));
+    Point3ArrayPtr shapefeatures;
+    Point3ArrayPtr orientations = pointsets_orientations(points,groups,shapefeatures);
+    return make_tuple(orientations,shapefeatures);
+}
+
+object py_pointsets_normals(const Point3ArrayPtr points, const IndexArrayPtr groups, bool features)
+{
+    if (!features) return object(pointsets_normals(points,groups));
+    Point3ArrayPtr shapefeatures;
+    Point3ArrayPtr normals = pointsets_normals(points,groups,shapefeatures);
+    return make_tuple(normals,shapefeatures);
+}
+
+object py_pointsets_principal_axes(const Point3ArrayPtr points, const IndexArrayPtr groups)
+{
+    Point3ArrayPtr eigenvalues, majoraxes, minoraxes, features;
+    pointsets_principal_axes(points,groups,&eigenvalues,&majoraxes,&minoraxes,&features);
+    return make_tuple(eigenvalues,majoraxes,minoraxes,features);
+}
+
+object py_symmetric_eigen(const Matrix3& m)
+{
+    Vector3 values, v1, v2, v3;
+    symmetric_eigen(m,values,v1,v2,v3);
+    return make_tuple(values,make_tuple(v1,v2,v3));
+}
+
 #ifdef CGAL_AND_SVD_SOLVER_ENABLED
 
 bp::object
@@ -255,7 +313,9 @@ void export_PointManip()
 
 
 #ifdef WITH_CGAL
-    def("delaunay_point_connection",&delaunay_point_connection,args("points"));
+    def("delaunay_point_connection",(IndexArrayPtr(*)(const Point3ArrayPtr))&delaunay_point_connection,args("points"));
+    def("delaunay_point_connection_csr",&py_delaunay_point_connection_csr,args("points"),
+        "Return the Delaunay edges of points in compressed rows as a tuple (offsets, neighbors), or None if CGAL is not available.");
     def("delaunay_triangulation",&delaunay_triangulation,args("points"));
     def("k_closest_points_from_delaunay",&k_closest_points_from_delaunay,args("points","k"));
 #endif
@@ -298,11 +358,18 @@ void export_PointManip()
     def("density_from_k_neighborhood",&density_from_k_neighborhood,(bp::arg("pid"),bp::arg("points"),bp::arg("adjacencies"),bp::arg("k")=0),"Compute density of a point according to its k neighboordhood. If k is 0, its value is deduced from adjacencies.");
     def("densities_from_k_neighborhood",&densities_from_k_neighborhood,(bp::arg("points"),bp::arg("adjacencies"),bp::arg("k")=0),"Compute local densities of a set of points according to their k neighboordhood. If k is 0, its value is deduced from adjacencies.");
 
-#ifdef WITH_CGAL
     def("pointset_orientation",&pointset_orientation,args("points","group"));
-    def("pointsets_orientations",&pointsets_orientations,args("points","groups"));
+    def("pointsets_orientations",&py_pointsets_orientations,(bp::arg("points"),bp::arg("groups"),bp::arg("features")=false),
+        "Compute the direction of largest variance of each group. If features is set, return also the (linearity, planarity, sphericity) of each group.");
     def("pointset_normal",&pointset_normal,(bp::arg("points"),bp::arg("groups")));
-    def("pointsets_normals",&pointsets_normals,(bp::arg("points"),bp::arg("groups")));
+    def("pointsets_normals",&py_pointsets_normals,(bp::arg("points"),bp::arg("groups"),bp::arg("features")=false),
+        "Compute the direction of smallest variance of each group. If features is set, return also the (linearity, planarity, sphericity) of each group.");
+    def("pointsets_principal_axes",&py_pointsets_principal_axes,(bp::arg("points"),bp::arg("groups")),
+        "Compute the eigen decomposition of the covariance of each group. Return a tuple (eigenvalues, majoraxes, minoraxes, features).");
+    def("symmetric_eigen",&py_symmetric_eigen,bp::arg("matrix"),
+        "Compute the eigenvalues in decreasing order and the eigenvectors of a symmetric matrix. Return a tuple (values,(v1,v2,v3)).");
+
+#ifdef WITH_CGAL
     def("triangleset_orientation",&triangleset_orientation,args("points","triangles"));
 
 #ifdef CGAL_AND_SVD_SOLVER_ENABLED
@@ -392,6 +459,14 @@ void export_PointManip()
 
     def("cluster_junction_points",&py_cluster_junction_points,(bp::arg("pointtoppology"),bp::arg("group1"),bp::arg("group2")));
 
+
+    def("voxel_downsample",&py_voxel_downsample,(bp::arg("points"),bp::arg("voxelsize"),bp::arg("attributes")=false,bp::arg("colors")=Color4ArrayPtr()),
+        "Return for each non empty voxel of size voxelsize the point closest to the mean of its points. If attributes, return a tuple (indices, meanpoints, counts[, meancolors]).");
+    def("voxel_groups",&voxel_groups,(bp::arg("points"),bp::arg("voxelsize")),"Return the points of each non empty voxel, in the order of voxel_downsample.");
+    def("poisson_disk_subsample",&poisson_disk_subsample,(bp::arg("points"),bp::arg("radius")),"Return a subset of points in which no two points are closer than radius.");
+    def("statistical_outlier_filter",&py_statistical_outlier_filter,(bp::arg("points"),bp::arg("k"),bp::arg("stdratio")=1,bp::arg("meandistances")=false),
+        "Return the points whose mean distance to their k nearest neighbors is below the mean of these distances plus stdratio times their deviation. If meandistances, return a tuple (indices, meandistances).");
+    def("radius_outlier_filter",&radius_outlier_filter,(bp::arg("points"),bp::arg("radius"),bp::arg("minneighbors")),"Return the points that have at least minneighbors other points closer than radius.");
     def("pointset_median",&pointset_median,(bp::arg("points")));
     def("approx_pointset_median",&approx_pointset_median,(bp::arg("points"),bp::arg("nbIterMax")=200));
 }
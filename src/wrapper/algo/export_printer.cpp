@@ -32,6 +32,7 @@
 #include "export_printer.h"
 #include <plantgl/algo/codec/printer.h>
 #include <plantgl/algo/codec/binaryprinter.h>
+#include <plantgl/algo/codec/textwriter.h>
 #include <plantgl/scenegraph/scene/scene.h>
 #include <plantgl/tool/bfstream.h>
 #include <boost/python.hpp>
@@ -87,6 +88,12 @@ void print_header0(Printer * p)
 void print_header(Printer * p, const std::string comment)
 { p->header(comment.c_str()); }
 
+std::string py_format_real(double value, int precision)
+{ char buffer[32]; return std::string(buffer,format_real(buffer,value,precision)); }
+
+std::string py_format_real_shortest(double value)
+{ char buffer[32]; return std::string(buffer,format_real_shortest(buffer,value)); }
+
 void export_PglPrinter()
 {
  class_< Printer, bases< Action >, boost::noncopyable > ( "PglPrinter" , no_init )
@@ -95,6 +102,8 @@ void export_PglPrinter()
     .def("isPrinted",&Printer::isPrinted)
     .def("header",&print_header0)
     .def("header",&print_header)
+    .add_property("arrayPrecision",&Printer::getArrayPrecision,&Printer::setArrayPrecision,
+                  "Significant digits of the reals written in arrays. The stream precision if negative, the shortest exact text if 0.")
     ;
 
   class_< PyStrPGLPrinter , bases< PyStrPrinter, Printer > , boost::noncopyable> 
@@ -104,6 +113,11 @@ void export_PglPrinter()
   class_< PyFilePGLPrinter , bases< PyFilePrinter, Printer > , boost::noncopyable> 
 	  ("PglFilePrinter",init<const std::string&>("File Printer in PGL format",args("filename")) );
     ;
+
+  def("format_real",&py_format_real,args("value","precision"),
+      "Text of value with precision significant digits as written in the arrays of the printers, as '%.*g' % (precision, value).");
+  def("format_real_shortest",&py_format_real_shortest,args("value"),
+      "Shortest text of value that reads back exactly, as written in the arrays of the printers with an arrayPrecision of 0.");
 }
 
 /* ----------------------------------------------------------------------- */
@@ -35,15 +35,45 @@
 /* ----------------------------------------------------------------------- */
 
 PGL_USING_NAMESPACE
+TOOLS_USING_NAMESPACE
 using namespace boost::python;
 
+object py_random_points_in_tetrahedra(size_t nb_per_tetra, const Point3ArrayPtr points, const Index4ArrayPtr tetraindices, object seed)
+{
+    if (seed.ptr() == Py_None) return object(random_points_in_tetrahedra(nb_per_tetra, points, tetraindices));
+    return object(random_points_in_tetrahedra(nb_per_tetra, points, tetraindices, extract<uint32_t>(seed)()));
+}
+
+object py_random_points_on_scene(const ScenePtr& scene, size_t nb, uint32_t seed, bool attributes)
+{
+    if (!attributes) return object(random_points_on_scene(scene, nb, seed));
+    Point3ArrayPtr normals, barycentrics;
+    Uint32Array1Ptr shapeIds, triangleIndices;
+    Point3ArrayPtr points = random_points_on_scene(scene, nb, seed, normals, shapeIds, triangleIndices, barycentrics);
+    return make_tuple(points, normals, shapeIds, triangleIndices, barycentrics);
+}
+
+object py_poisson_disk_points_on_scene(const ScenePtr& scene, real_t radius, uint32_t seed, real_t oversampling, bool attributes)
+{
+    if (!attributes) return object(poisson_disk_points_on_scene(scene, radius, seed, oversampling));
+    Point3ArrayPtr normals, barycentrics;
+    Uint32Array1Ptr shapeIds, triangleIndices;
+    Point3ArrayPtr points = poisson_disk_points_on_scene(scene, radius, seed, oversampling, normals, shapeIds, triangleIndices, barycentrics);
+    return make_tuple(points, normals, shapeIds, triangleIndices, barycentrics);
+}
+
 void export_randompoints()
 {
 
     def("random_point_in_box",&random_point_in_box,args("minpt","maxpt"));
     def("random_point_in_tetrahedron",&random_point_in_tetrahedron,args("p0","p1","p2","p3"));
     def("random_points_in_tetrahedron",&random_points_in_tetrahedron,args("nb","p0","p1","p2","p3"));
-    def("random_points_in_tetrahedra",&random_points_in_tetrahedra,args("nb_per_tetra","pointlist","tetraindices"));
+    def("random_points_in_tetrahedra",&py_random_points_in_tetrahedra,(arg("nb_per_tetra"),arg("pointlist"),arg("tetraindices"),arg("seed")=object()),
+        "Sample nb_per_tetra points in each tetrahedron. If seed is given, tetrahedra are sampled in parallel with reproducible random streams.");
+    def("random_points_on_scene",&py_random_points_on_scene,(arg("scene"),arg("nb"),arg("seed")=0,arg("attributes")=false),
+        "Sample nb points uniformly on the surfaces of scene. If attributes, return a tuple (points, normals, shapeids, triangleindices, barycentrics).");
+    def("poisson_disk_points_on_scene",&py_poisson_disk_points_on_scene,(arg("scene"),arg("radius"),arg("seed")=0,arg("oversampling")=4,arg("attributes")=false),
+        "Sample points on the surfaces of scene such that no two points are closer than radius. If attributes, return a tuple (points, normals, shapeids, triangleindices, barycentrics).");
   
 }
 
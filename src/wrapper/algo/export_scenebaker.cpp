@@ -0,0 +1,88 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright 1995-2007 UMR CIRAD/INRIA/INRA DAP 
+ *
+ *       File author(s): F. Boudon et al.
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+
+
+#include <plantgl/python/export_refcountptr.h>
+#include <plantgl/algo/base/scenebaker.h>
+#include <plantgl/scenegraph/scene/scene.h>
+#include <plantgl/scenegraph/container/pointarray.h>
+#include <plantgl/scenegraph/container/indexarray.h>
+#include <plantgl/tool/util_array.h>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_USING_NAMESPACE
+TOOLS_USING_NAMESPACE
+using namespace boost::python;
+#define bp boost::python
+
+static Point3ArrayPtr to_point_array(const std::vector<real_t>& coords)
+{
+    Point3ArrayPtr result(new Point3Array(coords.size() / 3));
+    for (size_t i = 0; i < result->size(); ++i)
+        result->setAt(i, Vector3(coords[3*i], coords[3*i+1], coords[3*i+2]));
+    return result;
+}
+
+template<class T>
+static Uint32Array1Ptr to_uint32_array(const std::vector<T>& values)
+{
+    Uint32Array1Ptr result(new Uint32Array1(values.size()));
+    for (size_t i = 0; i < values.size(); ++i) result->setAt(i, uint32_t(values[i]));
+    return result;
+}
+
+object py_bake_scene(const ScenePtr& scene, bool computeNormals)
+{
+    RealMeshBuffer buffer;
+    if (!bake_scene(scene, buffer, computeNormals)) return object();
+    Index3ArrayPtr triangles(new Index3Array(buffer.triangleCount()));
+    for (size_t i = 0; i < triangles->size(); ++i)
+        triangles->setAt(i, Index3(uint_t(buffer.indices[3*i]), uint_t(buffer.indices[3*i+1]), uint_t(buffer.indices[3*i+2])));
+    object normals;
+    if (computeNormals) normals = object(to_point_array(buffer.normals));
+    return make_tuple(to_point_array(buffer.vertices), normals, triangles,
+                      to_uint32_array(buffer.shapeIndices), to_uint32_array(buffer.shapeIds), 
+                      to_uint32_array(buffer.triangleOffsets));
+}
+
+void export_SceneBaker()
+{
+    def("bake_scene",&py_bake_scene,(bp::arg("scene"),bp::arg("computeNormals")=true),
+        "Tesselate all the shapes of scene into one indexed triangle buffer. "
+        "Return a tuple (points, normals, triangles, shapeindices, shapeids, triangleoffsets) or None if it cannot be built. "
+        "shapeindices gives for each triangle the position of its shape in the scene, and triangleoffsets the first triangle of each shape, "
+        "with a last value that is the number of triangles. normals is None if computeNormals is False.");
+}
+
+/* ----------------------------------------------------------------------- */
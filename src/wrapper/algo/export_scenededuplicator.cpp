@@ -0,0 +1,63 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright 1995-2007 UMR CIRAD/INRIA/INRA DAP 
+ *
+ *       File author(s): F. Boudon et al.
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+#include <plantgl/python/export_refcountptr.h>
+#include <plantgl/algo/base/scenededuplicator.h>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_USING_NAMESPACE
+using namespace boost::python;
+#define bp boost::python
+
+uint_t sd_deduplicate_scene(SceneDeduplicator * d, const ScenePtr& scene)
+{ return d->deduplicate(scene); }
+
+SceneObjectPtr sd_deduplicate_object(SceneDeduplicator * d, const SceneObjectPtr& object)
+{ return d->deduplicate(object); }
+
+void export_SceneDeduplicator()
+{
+  class_< SceneDeduplicator, bases<Action>, boost::noncopyable >
+    ("SceneDeduplicator", "SceneDeduplicator([ignoreNames]) -> replaces structurally identical geometries and appearances by a single shared instance.",
+     init<bp::optional<bool> >(bp::args("ignoreNames")))
+    .def("clear",&SceneDeduplicator::clear)
+    .def("deduplicate",&sd_deduplicate_scene,bp::args("scene"),"Deduplicates in place the objects of a scene. Returns the number of replaced objects.")
+    .def("deduplicate",&sd_deduplicate_object,bp::args("object"),"Returns the canonical instance of an object.")
+    .add_property("ignoreNames",&SceneDeduplicator::getIgnoreNames,&SceneDeduplicator::setIgnoreNames)
+    .add_property("visitedNb",&SceneDeduplicator::getVisitedNb)
+    .add_property("duplicateNb",&SceneDeduplicator::getDuplicateNb)
+    .add_property("savedMemory",&SceneDeduplicator::getSavedMemory)
+    ;
+}
+
+/* ----------------------------------------------------------------------- */
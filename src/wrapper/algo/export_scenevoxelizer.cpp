@@ -0,0 +1,82 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright 1995-2007 UMR CIRAD/INRIA/INRA DAP 
+ *
+ *       File author(s): F. Boudon et al.
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+
+#include <plantgl/python/export_refcountptr.h>
+#include <plantgl/algo/grid/scenevoxelizer.h>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_USING_NAMESPACE
+TOOLS_USING_NAMESPACE
+using namespace boost::python;
+#define bp boost::python
+
+Vector3 py_sv_getVoxelSize(SceneVoxelizer * voxelizer) { return voxelizer->getVoxelSize(); }
+
+Vector3 py_sv_getOrigin(SceneVoxelizer * voxelizer) { return voxelizer->getOrigin(); }
+
+object py_sv_getDimensions(SceneVoxelizer * voxelizer)
+{
+    const Uint32Tuple3& dims = voxelizer->getDimensions();
+    return make_tuple(dims.getAt(0), dims.getAt(1), dims.getAt(2));
+}
+
+void export_SceneVoxelizer()
+{
+    class_< SceneVoxelizer, boost::noncopyable >
+        ("SceneVoxelizer", "SceneVoxelizer(voxelsize[, nbInclinationClasses, nbAzimuthClasses]) -> accumulates the area of the triangles of a scene in the voxels of a regular grid.",
+         init<Vector3, bp::optional<uint32_t, uint32_t> >((bp::arg("voxelsize"),bp::arg("nbInclinationClasses")=9,bp::arg("nbAzimuthClasses")=1)))
+        .def("process",&SceneVoxelizer::process,(bp::arg("scene")),"Voxelize the triangles of scene. Returns False if the scene cannot be voxelized.")
+        .def("clear",&SceneVoxelizer::clear)
+        .def("setBoundingBox",&SceneVoxelizer::setBoundingBox,(bp::arg("lower"),bp::arg("upper")),"Restrict the grid to the box [lower, upper].")
+        .def("unsetBoundingBox",&SceneVoxelizer::unsetBoundingBox,"Let the grid cover the bounding box of the scene.")
+        .def("getVoxelSize",&py_sv_getVoxelSize)
+        .def("getOrigin",&py_sv_getOrigin,"Return the lower corner of the grid.")
+        .def("getDimensions",&py_sv_getDimensions,"Return the number of voxels along x, y and z.")
+        .def("getNbInclinationClasses",&SceneVoxelizer::getNbInclinationClasses)
+        .def("getNbAzimuthClasses",&SceneVoxelizer::getNbAzimuthClasses)
+        .def("getVoxelIndices",&SceneVoxelizer::getVoxelIndices,"Return the index x + nx * (y + ny * z) of each non empty voxel.")
+        .def("getVoxelCenters",&SceneVoxelizer::getVoxelCenters,"Return the center of each non empty voxel.")
+        .def("getAreas",&SceneVoxelizer::getAreas,"Return the area of the triangles in each non empty voxel.")
+        .def("getAreaDensities",&SceneVoxelizer::getAreaDensities,"Return the area of the triangles in each non empty voxel divided by its volume.")
+        .def("getOrientationHistograms",&SceneVoxelizer::getOrientationHistograms,"Return the area of each orientation class (inclination * nbAzimuthClasses + azimuth) in each non empty voxel.")
+        .def("getShapeOffsets",&SceneVoxelizer::getShapeOffsets,"Return the offsets of the shapes of each non empty voxel in getShapeIds and getShapeAreas.")
+        .def("getShapeIds",&SceneVoxelizer::getShapeIds)
+        .def("getShapeAreas",&SceneVoxelizer::getShapeAreas)
+        .def("getTriangleCount",&SceneVoxelizer::getTriangleCount)
+        .def("size",&SceneVoxelizer::size,"Return the number of non empty voxels.")
+        .def("__len__",&SceneVoxelizer::size)
+        ;
+}
+
+/* ----------------------------------------------------------------------- */
@@ -30,6 +30,7 @@
  */
 
 #include <plantgl/algo/fitting/skeleton.h>
+#include <plantgl/algo/fitting/flatskeleton.h>
 
 #include <plantgl/python/export_refcountptr.h>
 #include <plantgl/python/export_property.h>				
@@ -97,6 +98,39 @@ pyGetSkeletonInformation
   //  return make_list< std::list<Polyline2DPtr> >(skeleton)();
 }
 
+object 
+pyFlatGetChordalAxisTransform
+(Polyline2DPtr shape, double areaMaxFilter)
+{
+  std::list<Polyline2DPtr> rlist = FlatSkeleton::getChordalAxisTransform(shape, areaMaxFilter);
+  return make_list< std::list<Polyline2DPtr> >(rlist)();
+}
+
+object 
+pyFlatGetSkeletonInformation 
+(Polyline2DPtr shape, double areaMaxFilter)
+{
+  std::list<Vector2> ends;
+  std::list<Vector2> end_tgts;
+  std::list<Vector2> bumps_ends;
+  std::list<Vector2> bumps_tgts;
+  std::list<Polyline2DPtr> polyline_bumps;
+  std::list<Polyline2DPtr> skeleton;
+  skeleton = FlatSkeleton::getSkeletonInformation(shape,
+						  areaMaxFilter,
+						  &ends,
+						  &end_tgts,
+						  &bumps_ends,
+						  &bumps_tgts,
+						  &polyline_bumps);
+  return make_tuple(make_list< std::list<Polyline2DPtr> >(skeleton)(),
+		    make_list< std::list<Vector2> >(ends)(),
+		    make_list< std::list<Vector2> >(end_tgts)(),
+		    make_list< std::list<Vector2> >(bumps_ends)(),
+		    make_list< std::list<Vector2> >(bumps_tgts)(),
+		    make_list< std::list<Polyline2DPtr> >(polyline_bumps)());
+}
+
 void export_Skeleton()
 {
   class_<Skeleton, boost::noncopyable>("Skeleton",
@@ -109,5 +143,14 @@ void export_Skeleton()
     .staticmethod("removeLoopsInShape") 
     .def("getDelaunayConstrained2DTriangulation", &pyGetDelaunayConstrained2DTriangulation) 
     .staticmethod("getDelaunayConstrained2DTriangulation");
+
+  class_<FlatSkeleton, boost::noncopyable>("FlatSkeleton",
+				       "FlatSkeleton computes the same chordal axis transform as Skeleton on a flat half-edge triangulation, without CGAL. The shape must be a simple polygon.\n" , no_init)
+    .def("getChordalAxisTransform", &pyFlatGetChordalAxisTransform) 
+    .staticmethod("getChordalAxisTransform") 
+    .def("getSkeletonInformation", &pyFlatGetSkeletonInformation) 
+    .staticmethod("getSkeletonInformation") 
+    .def("getDelaunayConstrained2DTriangulation", &FlatSkeleton::getDelaunayConstrained2DTriangulation) 
+    .staticmethod("getDelaunayConstrained2DTriangulation");
 }
 
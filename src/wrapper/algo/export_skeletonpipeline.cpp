@@ -0,0 +1,91 @@
+/* -*-c++-*-
+ *  ----------------------------------------------------------------------------
+ *
+ *       PlantGL: The Plant Graphic Library
+ *
+ *       Copyright 1995-2007 UMR CIRAD/INRIA/INRA DAP 
+ *
+ *       File author(s): F. Boudon et al.
+ *
+ *  ----------------------------------------------------------------------------
+ *
+ *                      GNU General Public Licence
+ *
+ *       This program is free software; you can redistribute it and/or
+ *       modify it under the terms of the GNU General Public License as
+ *       published by the Free Software Foundation; either version 2 of
+ *       the License, or (at your option) any later version.
+ *
+ *       This program is distributed in the hope that it will be useful,
+ *       but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *       MERCHANTABILITY or FITNESS For A PARTICULAR PURPOSE. See the
+ *       GNU General Public License for more details.
+ *
+ *       You should have received a copy of the GNU General Public
+ *       License along with this program; see the file COPYING. If not,
+ *       write to the Free Software Foundation, Inc., 59
+ *       Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ *  ----------------------------------------------------------------------------
+ */
+
+
+
+#include <plantgl/python/export_refcountptr.h>
+#include <plantgl/algo/base/skeletonpipeline.h>
+
+/* ----------------------------------------------------------------------- */
+
+PGL_USING_NAMESPACE
+TOOLS_USING_NAMESPACE
+using namespace boost::python;
+#define bp boost::python
+
+object py_sp_process(SkeletonPipeline * pipeline, const Point3ArrayPtr& points, uint32_t root)
+{
+    if (!pipeline->process(points, root)) return object();
+    return make_tuple(pipeline->getNodes(), pipeline->getParents(), pipeline->getRadii());
+}
+
+dict py_sp_stage_times(SkeletonPipeline * pipeline)
+{
+    dict result;
+    for (int stage = 0; stage < SkeletonPipeline::eNbStages; ++stage)
+        result[SkeletonPipeline::getStageName(SkeletonPipeline::Stage(stage))] = pipeline->getStageTime(SkeletonPipeline::Stage(stage));
+    return result;
+}
+
+object py_skeleton_from_points(const Point3ArrayPtr& points, uint32_t root, real_t binsize, uint32_t k, 
+                               bool connect_all_points, real_t averageradius, real_t pipeexponent)
+{
+    SkeletonPipeline pipeline(binsize, k, connect_all_points);
+    pipeline.setAverageRadius(averageradius);
+    pipeline.setPipeExponent(pipeexponent);
+    return py_sp_process(&pipeline, points, root);
+}
+
+void export_SkeletonPipeline()
+{
+    class_< SkeletonPipeline, boost::noncopyable >
+        ("SkeletonPipeline", "SkeletonPipeline(binsize[, k, connectAllPoints]) -> computes a skeleton (nodes, parents, radii) from a point cloud by clustering of the distances to a root.",
+         init<real_t, bp::optional<uint32_t, bool> >((bp::arg("binsize"),bp::arg("k")=7,bp::arg("connectAllPoints")=true)))
+        .def("process",&py_sp_process,(bp::arg("points"),bp::arg("root")=0),"Compute the skeleton of points and returns (nodes, parents, radii), or None if it cannot be computed.")
+        .def("clear",&SkeletonPipeline::clear)
+        .def("getGroups",&SkeletonPipeline::getGroups,"Return the points of each node.")
+        .def("getPointGroups",&SkeletonPipeline::getPointGroups,"Return the node of each point.")
+        .def("getStageTimes",&py_sp_stage_times,"Return the time in seconds spent in each stage by the last process.")
+        .def("getTotalTime",&SkeletonPipeline::getTotalTime)
+        .add_property("binsize",&SkeletonPipeline::getBinSize,&SkeletonPipeline::setBinSize)
+        .add_property("k",&SkeletonPipeline::getK,&SkeletonPipeline::setK)
+        .add_property("connectAllPoints",&SkeletonPipeline::getConnectAllPoints,&SkeletonPipeline::setConnectAllPoints)
+        .add_property("averageRadius",&SkeletonPipeline::getAverageRadius,&SkeletonPipeline::setAverageRadius)
+        .add_property("pipeExponent",&SkeletonPipeline::getPipeExponent,&SkeletonPipeline::setPipeExponent)
+        ;
+
+    def("skeleton_from_points",&py_skeleton_from_points,
+        (bp::arg("points"),bp::arg("root"),bp::arg("binsize"),bp::arg("k")=7,bp::arg("connect_all_points")=true,
+         bp::arg("averageradius")=0,bp::arg("pipeexponent")=2.5),
+        "Compute a skeleton (nodes, parents, radii) from points with a SkeletonPipeline. If averageradius is not positive, it is estimated from the points.");
+}
+
+/* ----------------------------------------------------------------------- */
@@ -30,6 +30,7 @@
  */
 
 #include <plantgl/algo/modelling/turtleparam.h>
+#include <plantgl/scenegraph/container/pointarray.h>
 
 #include <boost/python.hpp>
 using namespace boost::python;
@@ -42,6 +43,16 @@ TOOLS_USING_NAMESPACE
 
     //add_property(#PROPNAME, make_getter(&_CLASS::PROPNAME), make_setter(&_CLASS::PROPNAME)) \
 
+// The point lists are copied: the turtle may share them between its stack frames.
+Point3ArrayPtr tp_getPointList(const TurtleParam * p)
+{ return Point3ArrayPtr(new Point3Array(*p->pointList)); }
+
+Point3ArrayPtr tp_getLeftList(const TurtleParam * p)
+{ return Point3ArrayPtr(new Point3Array(p->leftList.begin(),p->leftList.end())); }
+
+RealArrayPtr tp_getRadiusList(const TurtleParam * p)
+{ return RealArrayPtr(new RealArray(p->radiusList.begin(),p->radiusList.end())); }
+
 void export_TurtleParam()
 {
   class_< TurtleParam >("TurtleParam", init<>("TurtleParam() -> Create default turtle parameters"))
@@ -67,6 +78,9 @@ void export_TurtleParam()
     .EXPORT_PROP(color,TurtleParam)
     .EXPORT_PROP(width,TurtleParam)
     .EXPORT_PROP(crossSection,TurtleParam)
+    .add_property("pointList",&tp_getPointList)
+    .add_property("leftList",&tp_getLeftList)
+    .add_property("radiusList",&tp_getRadiusList)
     ;
 }
 
@@ -53,6 +53,7 @@ void module_algo()
     export_SurfComputer();
     export_AmapTranslator();
     export_MatrixComputer();
+    export_SceneDeduplicator();
 
 	// custom algo
     export_Merge();
@@ -72,12 +73,14 @@ void module_algo()
 
     // reader export
     export_PglReader();
+    export_LigFile();
 
     // gl export
     export_GLRenderer();
     export_GLSkelRenderer();
     export_GLBBoxRenderer();
     export_GLCtrlPointRenderer();
+    export_GLBatchRenderer();
 
     // Turtle export
     export_TurtleParam();
@@ -91,7 +94,10 @@ void module_algo()
     export_SegIntersection();
     export_Ray();
     export_RayIntersection();
+    export_SceneBVH();
     export_Intersection();
+    export_LightInterception();
+    export_LidarScanner();
 
     // Grid export
     export_Mvs();
@@ -100,6 +106,7 @@ void module_algo()
     export_KDtree();
     export_PyGrid();
     export_PlaneClip();
+    export_SceneVoxelizer();
 
     // CurveManipulation export
     export_CurveManipulation();
@@ -110,6 +117,10 @@ void module_algo()
     // Point manip
     export_PointManip();
     export_Triangulation3D();
+    export_MeshWelder();
+    export_SceneBaker();
+    export_SkeletonPipeline();
+    export_KMeansClustering();
 
     // Dijkstra shortest path
     export_Dijkstra();
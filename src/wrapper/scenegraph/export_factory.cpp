@@ -254,6 +254,9 @@ void export_SceneFactory()
       .def("read", (ScenePtr(SceneFactory::*)(const std::string&,const std::string&))&SceneFactory::read)
       .def("write", (bool(SceneFactory::*)(const std::string&,const ScenePtr&))&SceneFactory::write)
       .def("write", (bool(SceneFactory::*)(const std::string&,const ScenePtr&,const std::string&))&SceneFactory::write)
+      .def("setReadProcessEnabled", &SceneFactory::setReadProcessEnabled, bp::args("name","enabled"),
+           "Enable or disable a process applied on the scenes read, such as 'Deduplication'.")
+      .def("isReadProcessEnabled", &SceneFactory::isReadProcessEnabled, bp::args("name"))
   ;
 
 }
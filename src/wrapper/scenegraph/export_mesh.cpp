@@ -31,6 +31,7 @@
 
 
 #include <plantgl/scenegraph/geometry/mesh.h>
+#include <plantgl/scenegraph/geometry/meshnormals.h>
 
 #include <plantgl/python/export_property.h>
 #include <plantgl/python/export_refcountptr.h>
@@ -64,4 +65,23 @@ void export_Mesh()
 	  ;
   implicitly_convertible<MeshPtr, ExplicitModelPtr>();
 
+  scope normalcomputer = class_<MeshNormalComputer, boost::noncopyable>( "MeshNormalComputer", 
+      "Computes the normals of the faces and of the vertices of a mesh. Normals can be updated after some points moved.", 
+      init<optional<MeshNormalComputer::Weighting> >("MeshNormalComputer([weighting])"))
+	  .def(init<const Mesh&, optional<MeshNormalComputer::Weighting> >("MeshNormalComputer(mesh[,weighting])"))
+	  .def("setMesh", &MeshNormalComputer::setMesh)
+	  .add_property("weighting", &MeshNormalComputer::getWeighting, &MeshNormalComputer::setWeighting)
+	  .def("computeFaceNormals", &MeshNormalComputer::computeFaceNormals, return_value_policy<copy_const_reference>())
+	  .def("computeVertexNormals", &MeshNormalComputer::computeVertexNormals, return_value_policy<copy_const_reference>())
+	  .def("update", &MeshNormalComputer::update, args("changed"))
+	  .def("getFaceNormals", &MeshNormalComputer::getFaceNormals, return_value_policy<copy_const_reference>())
+	  .def("getVertexNormals", &MeshNormalComputer::getVertexNormals, return_value_policy<copy_const_reference>())
+	  ;
+
+  enum_<MeshNormalComputer::Weighting>("Weighting")
+	  .value("AREA_WEIGHTING", MeshNormalComputer::AREA_WEIGHTING)
+	  .value("ANGLE_WEIGHTING", MeshNormalComputer::ANGLE_WEIGHTING)
+	  .value("UNIFORM_WEIGHTING", MeshNormalComputer::UNIFORM_WEIGHTING)
+	  .export_values()
+	  ;
 }
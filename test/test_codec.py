@@ -51,3 +51,64 @@ def test_write_obj():
     s.clear()
     s.read('./data/test_trumpet.obj')
     assert s.isValid()
+
+
+GEOM_LITERALS = """
+:Define HALF 0.5
+TriangleSet realpoints {
+  PointList [ <0.5,0,0>, < -1.5 , +2 , 3e1 >,
+              <1,2,3> ]
+  IndexList [ <0,1,2> ]
+}
+TriangleSet intpoints {
+  PointList [ <0,0,0>, <1,0,0>, <0,-1,0> ]
+  IndexList [ <0,1,2> ]
+}
+Polyline2D points2d {
+  PointList [ <1.5,-2>, <.25,1E-1> ]
+}
+Polyline exprpoints {
+  PointList [ <HALF,1.5,0>, <1.5*2,-(1),0>, <1,2,3> ]
+}
+BezierPatch matrixpoints {
+  CtrlPointMatrix [ [ <0.5,0,0>, <1,0,0> ], [ <0,1,0>, <1,1,0> ] ]
+  UDegree 1
+  VDegree 1
+}
+"""
+
+def test_read_geom_literals():
+    """ Arrays of numbers are read by the scanner, other arrays by the grammar. """
+    b = isPglParserVerbose()
+    pglParserVerbose(False)
+    sc, dic = pgl_read(GEOM_LITERALS)
+    pglParserVerbose(b)
+    for name in ['realpoints', 'intpoints', 'points2d', 'exprpoints', 'matrixpoints']:
+        assert name in dic, name
+        assert dic[name].isValid(), name
+    assert list(dic['realpoints'].pointList) == [Vector3(0.5,0,0), Vector3(-1.5,2,30), Vector3(1,2,3)]
+    assert list(dic['intpoints'].pointList) == [Vector3(0,0,0), Vector3(1,0,0), Vector3(0,-1,0)]
+    # integer arrays are also index arrays
+    assert list(dic['intpoints'].indexList) == [Index3(0,1,2)]
+    assert list(dic['points2d'].pointList) == [Vector2(1.5,-2), Vector2(0.25,0.1)]
+    assert list(dic['exprpoints'].pointList) == [Vector3(0.5,1.5,0), Vector3(3,-1,0), Vector3(1,2,3)]
+    matrix = dic['matrixpoints'].ctrlPointMatrix
+    assert matrix[0,0] == Vector4(0.5,0,0,1) and matrix[0,1] == Vector4(1,0,0,1)
+    assert matrix[1,0] == Vector4(0,1,0,1) and matrix[1,1] == Vector4(1,1,0,1)
+
+def test_write_read_geom():
+    """ Points written in a geom file are read back. """
+    points = Point3Array([Vector3(0.5*i, -0.25*i, i) for i in xrange(1000)])
+    points2 = Point2Array([Vector2(i, 0.125*i) for i in xrange(100)])
+    indices = Index3Array([Index3(i,i+1,i+2) for i in xrange(998)])
+    s = Scene()
+    s += Shape(TriangleSet(points, indices), Material(), 1)
+    s += Shape(Polyline2D(points2), Material(), 2)
+    s += Shape(PointSet(Point3Array([Vector3(i,2*i,3*i) for i in xrange(10)])), Material(), 3)
+    s.save('./data/test_literals.geom')
+    s2 = Scene('./data/test_literals.geom')
+    assert len(s2) == 3
+    assert list(s2[0].geometry.pointList) == list(points)
+    assert list(s2[0].geometry.indexList) == list(indices)
+    assert list(s2[1].geometry.pointList) == list(points2)
+    assert list(s2[2].geometry.pointList) == list(s[2].geometry.pointList)
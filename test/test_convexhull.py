@@ -0,0 +1,165 @@
+from openalea.plantgl.all import *
+from random import Random
+
+def random_points(rng, nb, scale = 1):
+    return Point3Array([Vector3(rng.gauss(0,scale),rng.gauss(0,scale),rng.gauss(0,scale)) for i in xrange(nb)])
+
+def builtin_hull(points):
+    fit = Fit(points)
+    fit.qhullUse = False
+    return fit.convexHull()
+
+def triangles(mesh):
+    return [[mesh.indexList[i][j] for j in xrange(3)] for i in xrange(len(mesh.indexList))]
+
+def mesh_volume(mesh):
+    """ The volume of a closed mesh, from the tetrahedra joining its triangles to its center. """
+    center = mesh.pointList.getCenter()
+    result = 0
+    for t in triangles(mesh):
+        a, b, c = [mesh.pointList[i] - center for i in t]
+        result += dot(a, cross(b, c))
+    return abs(result) / 6
+
+def assert_closed(mesh):
+    """ Each edge is shared by two triangles that use it in opposite directions. """
+    edges = {}
+    for t in triangles(mesh):
+        for j in xrange(3):
+            edge = (t[j], t[(j+1) % 3])
+            assert not edge in edges
+            edges[edge] = True
+    for a, b in edges:
+        assert (b, a) in edges
+    # Euler characteristic of a sphere
+    assert len(mesh.pointList) - len(edges) / 2 + len(mesh.indexList) == 2
+
+def assert_convex_hull(mesh, points, eps = 1e-9):
+    """ The triangles face outward and all the points are behind each of them. """
+    scale = max([norm(p) for p in points])
+    for t in triangles(mesh):
+        a, b, c = [mesh.pointList[i] for i in t]
+        normal = cross(b - a, c - a)
+        assert norm(normal) > 0
+        normal /= norm(normal)
+        for p in points:
+            assert dot(normal, p - a) <= eps * scale
+
+def test_quickhull_random():
+    rng = Random(11)
+    for nb in [4, 5, 10, 100, 1000]:
+        for scale in [1e-3, 1, 1e3]:
+            points = random_points(rng, nb, scale)
+            hull = builtin_hull(points)
+            assert isinstance(hull, TriangleSet)
+            assert_closed(hull)
+            assert_convex_hull(hull, points)
+            # the vertices of the hull are input points
+            for p in hull.pointList:
+                assert p in points
+
+def test_quickhull_known_volumes():
+    rng = Random(12)
+    # the corners of a cube with random points inside
+    points = [Vector3(x,y,z) for x in (-1,1) for y in (-1,1) for z in (-1,1)]
+    points += [Vector3(rng.uniform(-1,1),rng.uniform(-1,1),rng.uniform(-1,1)) for i in xrange(200)]
+    rng.shuffle(points)
+    hull = builtin_hull(Point3Array(points))
+    assert len(hull.pointList) == 8
+    assert abs(volume(hull) - 8) < 1e-9 and abs(surface(hull) - 24) < 1e-9
+    # the points of a convex mesh
+    discretizer = Discretizer()
+    assert Sphere(1, 16, 16).apply(discretizer)
+    sphere = discretizer.result
+    points = list(sphere.pointList) + [p * rng.uniform(0,0.9) for p in sphere.pointList]
+    rng.shuffle(points)
+    hull = builtin_hull(Point3Array(points))
+    assert_closed(hull)
+    assert abs(volume(hull) - mesh_volume(sphere)) < 1e-9
+    assert abs(surface(hull) - surface(sphere)) < 1e-9
+
+def test_quickhull_degenerated():
+    rng = Random(13)
+    # coplanar and aligned points have no hull
+    assert builtin_hull(Point3Array([Vector3(rng.uniform(-1,1),rng.uniform(-1,1),0) for i in xrange(50)])) is None
+    assert builtin_hull(Point3Array([Vector3(1,2,3) * rng.uniform(-1,1) for i in xrange(50)])) is None
+    assert builtin_hull(Point3Array([Vector3(1,2,3)] * 10)) is None
+    # a grid has many coplanar points on each face of its hull
+    points = Point3Array([Vector3(x,y,z) for x in xrange(5) for y in xrange(5) for z in xrange(5)])
+    hull = builtin_hull(points)
+    assert_closed(hull)
+    assert_convex_hull(hull, points)
+    assert abs(volume(hull) - 64) < 1e-9 and abs(surface(hull) - 96) < 1e-9
+    # duplicated points and a tetrahedron
+    points = Point3Array([Vector3(0,0,0), Vector3(1,0,0), Vector3(0,1,0), Vector3(0,0,1)] * 3)
+    hull = builtin_hull(points)
+    assert_closed(hull)
+    assert len(hull.indexList) == 4 and abs(volume(hull) - 1./6) < 1e-9
+
+def test_quickhull_vs_qhull():
+    fit = Fit()
+    fit.qhullUse = True
+    if not fit.qhullUse:
+        import warnings
+        warnings.warn("PlantGL is built without qhull. Skip comparison.")
+        return
+    rng = Random(14)
+    for nb in [10, 100, 1000]:
+        points = random_points(rng, nb)
+        fit = Fit(points)
+        reference = fit.convexHull()
+        hull = builtin_hull(points)
+        assert abs(volume(hull) - volume(reference)) < 1e-6 * volume(reference)
+        assert abs(surface(hull) - surface(reference)) < 1e-6 * surface(reference)
+
+def random_groups(rng, nbpoints, nbgroups):
+    groups = [rng.sample(xrange(nbpoints), rng.randint(4, 50)) for i in xrange(nbgroups)]
+    # an empty group and a coplanar one cannot be fitted
+    return IndexArray([Index(g) for g in groups] + [Index([]), Index([nbpoints, nbpoints+1, nbpoints+2, nbpoints+3])])
+
+def test_batchfit():
+    """ The meshes, volumes and areas are the ones of a Fit of each group. """
+    rng = Random(15)
+    nbpoints = 300
+    points = Point3Array(list(random_points(rng, nbpoints)) + [Vector3(0,0,0), Vector3(1,0,0), Vector3(0,1,0), Vector3(1,1,0)])
+    groups = random_groups(rng, nbpoints, 40)
+    tesselator = Tesselator()
+    # volumes whose meshes are closed
+    for classname in ['CONVEXHULL', 'bsphere', 'BELLIPSOID', 'BBOX']:
+        batch = BatchFit(points, groups)
+        assert batch.fit(classname)
+        assert len(batch) == len(groups)
+        pointoffsets, indexoffsets = batch.getPointOffsets(), batch.getIndexOffsets()
+        assert len(pointoffsets) == len(indexoffsets) == len(groups) + 1
+        assert pointoffsets[-1] == len(batch.getPointList()) and indexoffsets[-1] == len(batch.getIndexList())
+        for g, group in enumerate(groups):
+            fit = Fit(Point3Array([points[i] for i in group]))
+            fit.qhullUse = False
+            geometry = fit.use(classname) if len(group) > 0 else None
+            mesh = batch.getMesh(g)
+            if geometry is None or not geometry.apply(tesselator):
+                assert mesh is None
+                assert pointoffsets[g] == pointoffsets[g+1] and indexoffsets[g] == indexoffsets[g+1]
+                assert batch.getVolumes()[g] == 0 and batch.getAreas()[g] == 0
+                continue
+            reference = tesselator.result
+            assert pointoffsets[g+1] - pointoffsets[g] == len(reference.pointList)
+            assert indexoffsets[g+1] - indexoffsets[g] == len(reference.indexList)
+            assert list(mesh.pointList) == list(reference.pointList)
+            assert triangles(mesh) == triangles(reference)
+            # the triangles of the group refer to its points in the whole list
+            for i in xrange(indexoffsets[g], indexoffsets[g+1]):
+                for j in xrange(3):
+                    assert pointoffsets[g] <= batch.getIndexList()[i][j] < pointoffsets[g+1]
+            assert abs(batch.getVolumes()[g] - mesh_volume(reference)) <= 1e-9 * max(1, mesh_volume(reference))
+            assert abs(batch.getAreas()[g] - surface(reference)) <= 1e-9 * max(1, surface(reference))
+
+def test_batchfit_invalid():
+    points = Point3Array([Vector3(0,0,0), Vector3(1,0,0), Vector3(0,1,0), Vector3(0,0,1)])
+    batch = BatchFit(points, IndexArray([Index([0,1,2,3])]))
+    # not a volume
+    assert not batch.fit('EXTRUSION')
+    # an index out of the points
+    batch = BatchFit(points, IndexArray([Index([0,1,2,4])]))
+    assert not batch.fit('CONVEXHULL')
+    assert len(batch.getPointList()) == 0 and list(batch.getPointOffsets()) == [0]
@@ -0,0 +1,133 @@
+from openalea.plantgl.all import *
+from random import Random
+from math import cos, sin, pi
+
+def outline(corners, step = 0.5):
+    """ The border of the polygon of the given corners, with a point every step. """
+    points = []
+    for i in xrange(len(corners)):
+        a, b = Vector2(*corners[i]), Vector2(*corners[(i+1) % len(corners)])
+        n = int(norm(b - a) / step + 0.5)
+        points += [a + (b - a) * (float(k) / n) for k in xrange(n)]
+    return points
+
+rectangle = outline([(0,0),(10,0),(10,2),(0,2)])
+lshape = outline([(0,0),(10,0),(10,2),(2,2),(2,10),(0,10)])
+
+def star(rng, nb = 200):
+    """ A star shaped polygon, with many reflex vertices. """
+    return [Vector2(cos(2*pi*i/nb), sin(2*pi*i/nb)) * rng.uniform(0.5, 1.5) for i in xrange(nb)]
+
+def orient(a, b, c):
+    return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x)
+
+def polygon_area(points):
+    return sum([points[i-1].x * points[i].y - points[i].x * points[i-1].y for i in xrange(len(points))]) / 2
+
+def circumcircle(a, b, c):
+    ab, ac = b - a, c - a
+    d = 2 * (ab.x * ac.y - ab.y * ac.x)
+    center = a + Vector2((ac.y * normSquared(ab) - ab.y * normSquared(ac)) / d, (ab.x * normSquared(ac) - ac.x * normSquared(ab)) / d)
+    return center, norm(center - a)
+
+def check_triangulation(points):
+    triangulation = FlatSkeleton.getDelaunayConstrained2DTriangulation(Polyline2D(points))
+    vertices = [Vector2(p.x, p.y) for p in triangulation.pointList]
+    assert vertices == points
+    triangles = [[triangulation.indexList[i][j] for j in xrange(3)] for i in xrange(len(triangulation.indexList))]
+    assert len(triangles) == len(points) - 2
+    # the triangles are counter clockwise and cover the polygon
+    area = 0
+    for t in triangles:
+        a = orient(*[vertices[i] for i in t])
+        assert a > 0
+        area += a / 2
+    assert abs(area - abs(polygon_area(points))) < 1e-9 * area
+    # each border edge is in one triangle, each other edge in two
+    edges = {}
+    for k, t in enumerate(triangles):
+        for j in xrange(3):
+            edges[(t[j], t[(j+1) % 3])] = k
+    n = len(points)
+    sign = 1 if polygon_area(points) > 0 else -1
+    for i in xrange(n):
+        border = (i, (i+1) % n) if sign > 0 else ((i+1) % n, i)
+        assert border in edges and not (border[1], border[0]) in edges
+    # the triangulation is Delaunay: no vertex of a neighbor is in the circumcircle of a triangle
+    for (a, b), k in edges.items():
+        if not (b, a) in edges:
+            assert (abs(a - b) == 1 or abs(a - b) == n - 1)
+            continue
+        t, u = triangles[k], triangles[edges[(b, a)]]
+        center, radius = circumcircle(*[vertices[i] for i in t])
+        opposite = [i for i in u if i != a and i != b][0]
+        assert norm(vertices[opposite] - center) >= radius * (1 - 1e-9)
+
+def test_triangulation():
+    rng = Random(21)
+    for points in [rectangle, lshape, star(rng), star(rng, 1000)]:
+        check_triangulation(points)
+        # clockwise outlines
+        check_triangulation(points[::-1])
+
+def inside(p, points):
+    """ Whether p is inside the polygon, by the crossing number. """
+    result = False
+    for i in xrange(len(points)):
+        a, b = points[i-1], points[i]
+        if (a.y > p.y) != (b.y > p.y) and p.x < a.x + (p.y - a.y) * (b.x - a.x) / (b.y - a.y):
+            result = not result
+    return result
+
+def branches(points, areafilter):
+    result = [[Vector2(p.x, p.y) for p in b.pointList] for b in FlatSkeleton.getChordalAxisTransform(Polyline2D(points), areafilter)]
+    for b in result:
+        for p in b:
+            assert inside(p, points)
+    return result
+
+def test_rectangle_cat():
+    # the axis of the rectangle and a branch to each corner
+    cat = branches(rectangle, 0)
+    assert len(cat) == 5
+    assert sorted([len(b) for b in cat])[:4] == [5, 5, 5, 5]
+    # the corners are pruned, leaving the axis
+    cat = branches(rectangle, 3)
+    assert len(cat) == 1
+    axis = cat[0]
+    assert norm(axis[0] - Vector2(1,1)) < 1e-9 and norm(axis[-1] - Vector2(9,1)) < 1e-9
+    assert all([abs(p.y - 1) < 1e-9 for p in axis])
+
+def test_lshape_cat():
+    cat = branches(lshape, 0)
+    assert len(cat) == 7
+    # the two arms remain, joined at the corner of the L
+    cat = branches(lshape, 3)
+    assert len(cat) == 2
+    assert cat[0][0] == cat[1][0] and norm(cat[0][0] - Vector2(1,1)) < 0.5
+    assert sorted([b[-1] for b in cat], key = lambda p : p.x) == [Vector2(1,9), Vector2(9,1)]
+    for b in cat:
+        horizontal = b[-1].x > b[-1].y
+        assert all([abs((p.y if horizontal else p.x) - 1) < 1e-9 for p in b[1:]])
+    skeleton, ends, endtangents, bumpends, bumptangents, bumps = FlatSkeleton.getSkeletonInformation(Polyline2D(lshape), 3)
+    assert len(skeleton) == 2
+    assert sorted(ends, key = lambda p : p.x) == [Vector2(1,9), Vector2(9,1)]
+
+def test_pruning_is_monotonic():
+    rng = Random(22)
+    points = star(rng)
+    counts = [len(branches(points, areafilter)) for areafilter in [0, 0.01, 0.05, 0.2]]
+    assert counts == sorted(counts, reverse = True) and counts[0] > counts[-1]
+
+def test_skeleton_fallback():
+    """ Without CGAL, Skeleton uses FlatSkeleton. """
+    if pgl_support_extension('CGAL'): return
+    for points in [rectangle, lshape]:
+        shape = Polyline2D(points)
+        flat = FlatSkeleton.getDelaunayConstrained2DTriangulation(shape)
+        triangulation = Skeleton.getDelaunayConstrained2DTriangulation(shape)
+        assert list(triangulation.pointList) == list(flat.pointList)
+        assert list(triangulation.indexList) == list(flat.indexList)
+        for areafilter in [0, 3]:
+            cat = [list(b.pointList) for b in Skeleton.getChordalAxisTransform(shape, areafilter)]
+            assert cat == [list(b.pointList) for b in FlatSkeleton.getChordalAxisTransform(shape, areafilter)]
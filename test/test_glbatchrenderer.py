@@ -0,0 +1,49 @@
+from openalea.plantgl.all import *
+
+def batching_scene():
+    box = Box(Vector3(1,2,3))
+    mat1 = Material('mat1', Color3(255,0,0))
+    mat2 = Material('mat2', Color3(0,255,0))
+    scene = Scene()
+    scene += Shape(box, mat1, 1)
+    scene += Shape(Translated(Vector3(5,0,0), Sphere(1, 16, 16)), mat2, 2)
+    scene += Shape(Polyline([(0,0,0),(1,1,1)]), mat1, 3)
+    scene += Shape(Translated(Vector3(0,5,0), box), mat1, 4)
+    return scene
+
+def test_batch_build():
+    """ The batches are built without OpenGL context """
+    scene = batching_scene()
+    nbboxtriangles = len(tesselate(scene[0].geometry).indexList)
+    nbspheretriangles = len(tesselate(scene[1].geometry).indexList)
+    renderer = GLBatchRenderer()
+    assert renderer.build(scene)
+    assert renderer.isBuilt()
+    # the shapes are grouped by appearance, in the order of their first shape
+    batches = renderer.getBatches()
+    assert renderer.getBatchNb() == len(batches) == 2
+    assert [b[0].name for b in batches] == ['mat1', 'mat2']
+    assert batches[0][1:] == (0, 3 * 2 * nbboxtriangles)
+    assert batches[1][1:] == (3 * 2 * nbboxtriangles, 3 * nbspheretriangles)
+    assert renderer.getTriangleNb() == 2 * nbboxtriangles + nbspheretriangles
+    assert renderer.getVertexNb() == len(bake_scene(scene)[0])
+    # the polyline is left to a GLRenderer
+    unbatched = renderer.getUnbatchedShapes()
+    assert len(unbatched) == 1 and unbatched[0].id == 3
+    renderer.clear()
+    assert not renderer.isBuilt() and renderer.getBatchNb() == 0 and renderer.getTriangleNb() == 0
+
+def test_batch_empty_scene():
+    renderer = GLBatchRenderer()
+    assert renderer.build(Scene())
+    assert renderer.getBatchNb() == 0 and len(renderer.getUnbatchedShapes()) == 0
+
+def test_position_codes():
+    # 0 is the background
+    assert GLBatchRenderer.encodePosition(0) == (1, 0, 0, 255)
+    assert GLBatchRenderer.decodePosition((0, 0, 0, 0)) == 4294967295
+    assert GLBatchRenderer.decodePosition((0, 0, 0, 255)) == 4294967295
+    for position in [0, 1, 254, 255, 256, 65535, 65536, 123456, 0xfffffe]:
+        rgba = GLBatchRenderer.encodePosition(position)
+        assert rgba[3] == 255
+        assert GLBatchRenderer.decodePosition(rgba) == position
@@ -0,0 +1,40 @@
+from openalea.plantgl.all import *
+from openalea.vpltk.qt import QtCore, QtGui, QtOpenGL
+
+import warnings
+if not QtCore.QCoreApplication.instance() is None:
+    warnings.warn("A QtGui.QApplication is already running")
+else:
+    app = QtGui.QApplication([])
+
+def gl_context():
+    widget = QtOpenGL.QGLWidget()
+    widget.show()
+    widget.makeCurrent()
+    return widget
+
+def test_retain_shared_display_lists():
+    widget = gl_context()
+    renderer = GLRenderer(Discretizer())
+    renderer.setGLFrame(widget)
+    shared = Sphere(1, 16, 16)
+    other = Box(Vector3(1,1,1))
+    scene1 = Scene([Shape(shared, Material(), 1), Shape(other, Material(), 2)])
+    scene2 = Scene([Shape(Translated(Vector3(2,0,0), shared), Material(), 3)])
+    scene1.apply(renderer)
+    shareddl = renderer.getDisplayList(shared)
+    otherdl = renderer.getDisplayList(other)
+    assert shareddl != 0 and otherdl != 0
+    # swap to a scene that shares the sphere: its display list is kept
+    renderer.retain(scene2)
+    assert renderer.getDisplayList(shared) == shareddl
+    assert renderer.getDisplayList(other) == 0
+    scene2.apply(renderer)
+    assert renderer.getDisplayList(shared) == shareddl
+    # and back
+    renderer.retain(scene1)
+    assert renderer.getDisplayList(shared) == shareddl
+    widget.hide()
+
+if __name__ == '__main__':
+    test_retain_shared_display_lists()
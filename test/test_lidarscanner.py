@@ -0,0 +1,77 @@
+from openalea.plantgl.all import *
+from math import sqrt
+
+def square(lower, upper, z = 0):
+    points = Point3Array([Vector3(lower[0],lower[1],z),Vector3(upper[0],lower[1],z),Vector3(upper[0],upper[1],z),Vector3(lower[0],upper[1],z)])
+    return QuadSet(points, Index4Array([Index4(0,1,2,3)]))
+
+def sphere_scan(rangeNoise = 0, seed = 0):
+    """ Terrestrial scan from the center of a sphere of radius 5. """
+    scene = Scene([Shape(Sphere(5, 64, 64), Material(), 7)])
+    scanner = LidarScanner(0.02, seed)
+    scanner.addTerrestrialScan(Vector3(0,0,0))
+    scanner.rangeNoise = rangeNoise
+    return scanner, scanner.process(scene)
+
+def test_lidarscanner_sphere_ranges():
+    scanner, result = sphere_scan()
+    assert result is not None
+    points, shapeids, intensities, returnnumbers, returncounts = result
+    # every pulse hits the sphere once
+    assert len(points) == scanner.getPulseCount()
+    assert set(shapeids) == set([7])
+    assert set(returnnumbers) == set([1]) and set(returncounts) == set([1])
+    assert set(scanner.getScanIds()) == set([0])
+    # points lie between the sphere and its tesselation
+    for p in points:
+        assert 4.95 < norm(p) < 5 + 1e-6
+    for intensity in intensities:
+        assert 0 < intensity <= 1
+
+def test_lidarscanner_range_noise():
+    scanner, (points, shapeids, intensities, returnnumbers, returncounts) = sphere_scan()
+    noisyscanner, (noisypoints, shapeids, intensities, returnnumbers, returncounts) = sphere_scan(0.05)
+    assert len(noisypoints) == len(points)
+    # the noise only moves the points along their pulse
+    errors = [norm(q) - norm(p) for p, q in zip(points, noisypoints)]
+    for p, q in zip(points, noisypoints):
+        assert norm(cross(p, q)) < 1e-6 * norm(p) * norm(q)
+    mean = sum(errors) / len(errors)
+    sigma = sqrt(sum([(e - mean)**2 for e in errors]) / len(errors))
+    assert abs(mean) < 0.002
+    assert abs(sigma - 0.05) < 0.0025
+
+def test_lidarscanner_reproducibility():
+    points = sphere_scan(0.05, 1)[1][0]
+    samepoints = sphere_scan(0.05, 1)[1][0]
+    otherpoints = sphere_scan(0.05, 2)[1][0]
+    assert len(points) == len(samepoints) == len(otherpoints)
+    assert all([p == q for p, q in zip(points, samepoints)])
+    assert not all([p == q for p, q in zip(points, otherpoints)])
+
+def test_lidarscanner_multiple_returns():
+    """ An airborne scan over a ground and a plate covering its half x > 0, 2 units above. """
+    scene = Scene([Shape(square((-50,-50),(50,50),0), Material(), 1), Shape(square((0,-50),(50,50),2), Material(), 2)])
+    scanner = LidarScanner(0.005)
+    scanner.addAirborneScan(Vector3(-20,0,100), Vector3(20,0,100), 0.3, 0.5)
+    scanner.beamDivergence = 0.01
+    scanner.beamSampleCount = 32
+    scanner.returnSeparation = 0.5
+    points, shapeids, intensities, returnnumbers, returncounts = scanner.process(scene)
+    heights = { 1 : 0, 2 : 2 }
+    for p, shapeid in zip(points, shapeids):
+        assert abs(p.z - heights[shapeid]) < 0.3
+    # the beams on the edge of the plate give a return on the plate then on the ground
+    nbmultiple = 0
+    i = 0
+    while i < len(points):
+        count = returncounts[i]
+        assert list(returnnumbers[i:i+count]) == range(1, count+1)
+        assert all([c == count for c in returncounts[i:i+count]])
+        assert sum(intensities[i:i+count]) <= 1 + 1e-6
+        if count > 1:
+            assert count == 2
+            assert list(shapeids[i:i+count]) == [2, 1]
+            nbmultiple += 1
+        i += count
+    assert nbmultiple > 0
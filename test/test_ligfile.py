@@ -0,0 +1,80 @@
+from openalea.plantgl.all import *
+from struct import pack
+import os
+
+ligfile = 'test_linetree.lig'
+dtafile = 'test_linetree.dta'
+
+def write_linetree(nbrecords = 10, nbsymbols = 3):
+    """ Write a Linetree of cylinders along x. Symbols are not defined in the dta file 
+        so the default geometry is used. """
+    dta = open(dtafile,'w')
+    dta.write('0\n')
+    dta.close()
+    lig = open(ligfile,'wb')
+    lig.write(b'\0'*80)
+    for i in range(nbrecords):
+        symbol = (i * 7) % nbsymbols + 1
+        length, radius = 1 + i, 0.1 * (1 + i % 4)
+        # symbol, val1, val2, range, matrix 3x4 by rows, base and top diameters, entity number
+        matrix = [length, 0, 0, 0, 
+                  0, 1, 0, i, 
+                  0, 0, 1, 0]
+        lig.write(pack('>4i12f2fi', symbol, 0, 0, 0, *(matrix + [2*radius, 2*radius, i])))
+    lig.close()
+    return nbrecords
+
+def remove_linetree():
+    os.remove(ligfile)
+    os.remove(dtafile)
+
+def test_read_by_chunks():
+    nbrecords = write_linetree()
+    ref = readLineTree(ligfile, dtafile, '.')
+    assert len(ref) == nbrecords
+    for chunksize in [1, 3, 4, 100]:
+        sc = readLineTreeByChunks(ligfile, dtafile, '.', chunkSize = chunksize)
+        assert len(sc) == nbrecords
+        assert [sh.id for sh in sc] == [sh.id for sh in ref]
+        assert [sh.id for sh in sc] == list(range(nbrecords))
+    remove_linetree()
+
+def test_scene_reader():
+    nbrecords = write_linetree()
+    reader = LigSceneReader(ligfile, dtafile, '.', chunkSize = 4)
+    assert reader.isValid()
+    assert len(reader) == nbrecords
+    ids = []
+    sizes = []
+    sc = reader.nextScene()
+    while sc:
+        ids += [sh.id for sh in sc]
+        sizes.append(len(sc))
+        sc = reader.nextScene()
+    assert reader.atEnd()
+    assert sizes == [4, 4, 2]
+    assert ids == list(range(nbrecords))
+    remove_linetree()
+
+def test_statistics():
+    nbrecords = write_linetree()
+    ref = readLineTree(ligfile, dtafile, '.')
+    stats = computeLineTreeStatistics(ligfile, dtafile, '.', chunkSize = 3)
+    assert sum([s.count for s in stats]) == nbrecords
+    assert [s.symbol for s in stats] == [1, 2, 3]
+    for s in stats:
+        assert s.invalid == 0
+        # shape i uses the symbol (i * 7) % 3 + 1
+        shapes = [sh for sh in ref if (sh.id * 7) % 3 + 1 == s.symbol]
+        assert s.count == len(shapes)
+        refsurface = sum([surface(sh.geometry) for sh in shapes])
+        assert abs(s.surface - refsurface) < 1e-3 * refsurface, (s.surface, refsurface)
+        bbox = BoundingBox(Scene(shapes))
+        assert norm(s.bbox.lowerLeftCorner - bbox.lowerLeftCorner) < 1e-5
+        assert norm(s.bbox.upperRightCorner - bbox.upperRightCorner) < 1e-5
+    remove_linetree()
+
+if __name__ == '__main__':
+    test_read_by_chunks()
+    test_scene_reader()
+    test_statistics()
@@ -0,0 +1,58 @@
+from openalea.plantgl.all import *
+from math import pi
+
+def single_direction_sky(light, direction):
+    light.setSky(Point3Array([direction]), RealArray([1.]))
+
+def square(lower, upper, z = 0):
+    points = Point3Array([Vector3(lower[0],lower[1],z),Vector3(upper[0],lower[1],z),Vector3(upper[0],upper[1],z),Vector3(lower[0],upper[1],z)])
+    return QuadSet(points, Index4Array([Index4(0,1,2,3)]))
+
+def test_lightinterception_horizontal_disc():
+    """ A horizontal disc intercepts its area, whatever the sky. """
+    scene = Scene([Shape(Disc(1, 64), Material(), 1)])
+    light = LightInterception(0.01)
+    assert len(light.getSkyDirections()) == 46
+    assert abs(sum(light.getSkyWeights()) - 1) < 1e-6
+    assert light.process(scene)
+    area = light.getShapeAreas()[0]
+    assert abs(area - pi) < 0.01
+    assert list(light.getShapeIds()) == [1]
+    energy = light.getShapeEnergies()[0]
+    assert abs(energy - area) < 0.01 * area
+    assert abs(light.getShapeIrradiances()[0] - energy / area) < 1e-6
+    assert abs(light.getIncidentEnergy() - light.getTransmittedEnergy() - energy) < 1e-6
+
+def test_lightinterception_sphere():
+    """ A sphere intercepts its projected area pi r^2 divided by the sine of the elevation. """
+    scene = Scene([Shape(Sphere(1, 64, 64), Material(), 1)])
+    light = LightInterception(0.005)
+    single_direction_sky(light, Vector3(0,0,1))
+    assert light.process(scene)
+    assert abs(light.getShapeEnergies()[0] - pi) < 0.01 * pi
+    direction = Vector3(1,0.5,0.5)
+    single_direction_sky(light, direction)
+    assert light.process(scene)
+    expected = pi / (direction[2] / norm(direction))
+    assert abs(light.getShapeEnergies()[0] - expected) < 0.01 * expected
+
+def test_lightinterception_periodic_plate():
+    """ A plate covering a periodic domain intercepts the area of the domain, even if it overhangs it. """
+    light = LightInterception(0.02)
+    light.setPeriodicDomain(Vector2(0,0), Vector2(2,2))
+    assert light.isPeriodic()
+    for lower, upper in [((0,0),(2,2)), ((1,0.5),(3,2.5))]:
+        scene = Scene([Shape(square(lower, upper), Material(), 1)])
+        assert light.process(scene)
+        assert abs(light.getShapeEnergies()[0] - 4) < 1e-3
+        assert light.getTransmittedEnergy() < 1e-3
+    light.unsetPeriodicDomain()
+    assert not light.isPeriodic()
+
+def test_lightinterception_reproducibility():
+    scene = Scene([Shape(Sphere(1, 16, 16), Material(), 1)])
+    light = LightInterception(0.05, 3)
+    assert light.process(scene)
+    energy = light.getShapeEnergies()[0]
+    assert light.process(scene)
+    assert light.getShapeEnergies()[0] == energy
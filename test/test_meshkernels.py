@@ -0,0 +1,84 @@
+from openalea.plantgl.all import *
+from random import Random
+
+def random_points(rng, nb):
+    return Point3Array([Vector3(rng.uniform(-1,1),rng.uniform(-1,1),rng.uniform(-1,1)) for i in xrange(nb)])
+
+def random_meshes(seed = 5, nbpoints = 200, nbfaces = 300):
+    """ A TriangleSet, a QuadSet with non planar quads and a FaceSet with polygons of 3 to 7 points. """
+    rng = Random(seed)
+    points = random_points(rng, nbpoints)
+    face = lambda n : [rng.randint(0, nbpoints-1) for j in xrange(n)]
+    triangles = TriangleSet(points, Index3Array([Index3(*face(3)) for i in xrange(nbfaces)]), solid = True)
+    quads = QuadSet(points, Index4Array([Index4(*face(4)) for i in xrange(nbfaces)]), solid = True)
+    polygons = FaceSet(points, IndexArray([Index(face(rng.randint(3,7))) for i in xrange(nbfaces)]), solid = True)
+    return triangles, quads, polygons
+
+def faces(mesh):
+    return [[mesh.pointList[index[j]] for j in xrange(len(index))] for index in mesh.indexList]
+
+def triangle_surface(a, b, c):
+    return norm(cross(b-a, c-a)) / 2
+
+def scalar_surface(mesh):
+    """ The surface computed face by face, as SurfComputer did before the mesh kernels. """
+    result = 0
+    for f in faces(mesh):
+        if len(f) == 4:
+            # a quad is split along its diagonal 0-2
+            result += triangle_surface(f[0], f[1], f[2]) + triangle_surface(f[0], f[2], f[3])
+        else:
+            for j in xrange(1, len(f)-1):
+                result += triangle_surface(f[0], f[j], f[j+1])
+    return result
+
+def scalar_volume(mesh):
+    """ The volume computed face by face, as VolComputer did before the mesh kernels. """
+    center = mesh.pointList.getCenter()
+    result = 0
+    for f in faces(mesh):
+        for j in xrange(1, len(f)-1):
+            result += abs(dot(center - f[0], cross(f[j] - f[0], f[j+1] - f[0]))) / 6
+    return result
+
+def test_mesh_surfaces_and_volumes():
+    for mesh in random_meshes():
+        ref = scalar_surface(mesh)
+        assert abs(surface(mesh) - ref) < 1e-9 * ref
+        ref = scalar_volume(mesh)
+        assert abs(volume(mesh) - ref) < 1e-9 * ref
+
+def bbox_of(geometry):
+    bboxcomputer = BBoxComputer(Discretizer())
+    assert geometry.apply(bboxcomputer)
+    return bboxcomputer.result
+
+def assert_bounds(bbox, bounds, eps = 1e-9):
+    assert norm(bbox.lowerLeftCorner - bounds[0]) < eps
+    assert norm(bbox.upperRightCorner - bounds[1]) < eps
+
+def test_mesh_bounds():
+    for mesh in random_meshes():
+        assert_bounds(bbox_of(mesh), mesh.pointList.getBounds())
+
+def test_transformed_mesh_bounds():
+    transformations = [lambda g : AxisRotated(Vector3(1,2,0.5), 0.7, g),
+                       lambda g : EulerRotated(0.3, -0.8, 1.2, g),
+                       lambda g : Oriented(Vector3(1,1,0), Vector3(-1,1,1), g)]
+    for mesh in random_meshes():
+        childbbox = bbox_of(mesh)
+        corners = PointSet([Vector3(x,y,z) for x in (childbbox.lowerLeftCorner.x, childbbox.upperRightCorner.x)
+                                           for y in (childbbox.lowerLeftCorner.y, childbbox.upperRightCorner.y)
+                                           for z in (childbbox.lowerLeftCorner.z, childbbox.upperRightCorner.z)])
+        for transformation in transformations:
+            geometry = transformation(mesh)
+            bbox = bbox_of(geometry)
+            # the bounds of the transformed points
+            discretizer = Discretizer()
+            assert geometry.apply(discretizer)
+            assert_bounds(bbox, discretizer.result.pointList.getBounds())
+            # which are inside the transformed bounding box of the mesh, used before
+            transformedbox = bbox_of(transformation(corners))
+            for i in xrange(3):
+                assert transformedbox.lowerLeftCorner[i] - 1e-9 <= bbox.lowerLeftCorner[i]
+                assert bbox.upperRightCorner[i] <= transformedbox.upperRightCorner[i] + 1e-9
@@ -0,0 +1,104 @@
+from openalea.plantgl.all import *
+from random import Random
+from math import atan2
+
+def random_meshes(rng, nbpoints = 100, nbfaces = 150):
+    """ A TriangleSet, a QuadSet with non planar quads and a FaceSet with polygons of 3 to 7 points.
+        The last point is not used by any face. """
+    def points():
+        return Point3Array([Vector3(rng.uniform(-1,1),rng.uniform(-1,1),rng.uniform(-1,1)) for i in xrange(nbpoints)]+[Vector3(5,5,5)])
+    face = lambda n : rng.sample(xrange(nbpoints), n)
+    triangles = TriangleSet(points(), Index3Array([Index3(*face(3)) for i in xrange(nbfaces)]))
+    quads = QuadSet(points(), Index4Array([Index4(*face(4)) for i in xrange(nbfaces)]))
+    polygons = FaceSet(points(), IndexArray([Index(face(rng.randint(3,7))) for i in xrange(nbfaces)]))
+    return triangles, quads, polygons
+
+def face_points(mesh, f):
+    return [mesh.pointList[mesh.indexList[f][j]] for j in xrange(len(mesh.indexList[f]))]
+
+def area_vector(points):
+    """ Twice the vector area of a polygon, summed over its edges. """
+    result = Vector3(0,0,0)
+    for i in xrange(len(points)):
+        result += cross(points[i], points[(i+1) % len(points)])
+    return result
+
+def unit(v):
+    if norm(v) > 0: return v / norm(v)
+    return Vector3(0,0,1)
+
+def brute_force_face_normals(mesh):
+    sign = 1 if mesh.ccw else -1
+    return [unit(area_vector(face_points(mesh, f))) * sign for f in xrange(len(mesh.indexList))]
+
+def brute_force_vertex_normals(mesh, weighting):
+    sums = [Vector3(0,0,0) for i in xrange(len(mesh.pointList))]
+    used = [False for i in xrange(len(mesh.pointList))]
+    sign = 1 if mesh.ccw else -1
+    for f in xrange(len(mesh.indexList)):
+        points = face_points(mesh, f)
+        area = area_vector(points) * sign
+        n = len(points)
+        for j in xrange(n):
+            v = mesh.indexList[f][j]
+            used[v] = True
+            if weighting == MeshNormalComputer.AREA_WEIGHTING:
+                sums[v] += area
+            elif weighting == MeshNormalComputer.ANGLE_WEIGHTING:
+                a, b = points[j-1] - points[j], points[(j+1) % n] - points[j]
+                sums[v] += unit(area) * atan2(norm(cross(a,b)), dot(a,b))
+            else:
+                sums[v] += unit(area)
+    return [unit(s) if u else Vector3(1,0,0) for s, u in zip(sums, used)]
+
+def assert_normals(normals, expected):
+    assert len(normals) == len(expected)
+    for n, e in zip(normals, expected):
+        assert norm(n - e) < 1e-9
+
+weightings = [MeshNormalComputer.AREA_WEIGHTING, MeshNormalComputer.ANGLE_WEIGHTING, MeshNormalComputer.UNIFORM_WEIGHTING]
+
+def test_triangle_normals_unchanged():
+    """ Triangle normals are the ones computed by Mesh before MeshNormalComputer. """
+    triangles = random_meshes(Random(3))[0]
+    for ccw in [True, False]:
+        triangles.ccw = ccw
+        old = []
+        for f in xrange(len(triangles.indexList)):
+            p = face_points(triangles, f)
+            old.append(unit(cross(p[1] - p[0], p[2] - p[0]) if ccw else cross(p[2] - p[0], p[1] - p[0])))
+        triangles.normalPerVertex = False
+        triangles.computeNormalList()
+        assert_normals(triangles.normalList, old)
+        # vertex normals were the sum of the unnormalized normals of the faces
+        triangles.normalPerVertex = True
+        triangles.computeNormalList()
+        assert_normals(triangles.normalList, brute_force_vertex_normals(triangles, MeshNormalComputer.AREA_WEIGHTING))
+
+def test_face_normals():
+    """ Quads and polygons get the normal of their vector area. """
+    for mesh in random_meshes(Random(3)):
+        assert_normals(MeshNormalComputer(mesh).computeFaceNormals(), brute_force_face_normals(mesh))
+
+def test_vertex_normals_weightings():
+    for mesh in random_meshes(Random(3)):
+        for weighting in weightings:
+            computer = MeshNormalComputer(mesh, weighting)
+            assert_normals(computer.computeVertexNormals(), brute_force_vertex_normals(mesh, weighting))
+
+def test_normals_update():
+    """ Normals updated after a few points moved, then after most of them moved. """
+    rng = Random(4)
+    for mesh in random_meshes(Random(3)):
+        for weighting in weightings:
+            computer = MeshNormalComputer(mesh, weighting)
+            computer.computeFaceNormals()
+            computer.computeVertexNormals()
+            # more than a quarter of the points triggers a full computation
+            for nbchanged in [40, 5]:
+                changed = rng.sample(xrange(len(mesh.pointList)-1), nbchanged)
+                for i in changed:
+                    mesh.pointList[i] = mesh.pointList[i] + Vector3(rng.uniform(-1,1),rng.uniform(-1,1),rng.uniform(-1,1)) * 0.3
+                computer.update(Index(changed))
+                assert_normals(computer.getFaceNormals(), brute_force_face_normals(mesh))
+                assert_normals(computer.getVertexNormals(), brute_force_vertex_normals(mesh, weighting))
@@ -0,0 +1,110 @@
+from openalea.plantgl.all import *
+from random import Random
+
+def discretize(geometry):
+    discretizer = Discretizer()
+    assert geometry.apply(discretizer)
+    return discretizer.result
+
+def nb_distinct_points(points, tolerance):
+    distinct = []
+    for p in points:
+        if all([norm(p - q) > tolerance for q in distinct]): distinct.append(p)
+    return len(distinct)
+
+def face_list(mesh):
+    return [[mesh.indexList[i][j] for j in xrange(len(mesh.indexList[i]))] for i in xrange(len(mesh.indexList))]
+
+def soup(mesh, jitter, rng):
+    """ The faces of mesh with their own points, moved randomly by at most jitter along each axis. """
+    points, indices = [], []
+    for face in face_list(mesh):
+        indices.append(range(len(points), len(points)+len(face)))
+        points += [mesh.pointList[i] + Vector3(rng.uniform(-jitter,jitter),rng.uniform(-jitter,jitter),rng.uniform(-jitter,jitter)) for i in face]
+    if isinstance(mesh, TriangleSet):
+        return TriangleSet(Point3Array(points), Index3Array([Index3(*f) for f in indices]))
+    elif isinstance(mesh, QuadSet):
+        return QuadSet(Point3Array(points), Index4Array([Index4(*f) for f in indices]))
+    return FaceSet(Point3Array(points), IndexArray([Index(f) for f in indices]))
+
+def test_weld_discretized_soups():
+    rng = Random(1)
+    for geometry in [Box(Vector3(1,2,3)), Cylinder(1, 2, True, 12)]:
+        mesh = discretize(geometry)
+        expected = nb_distinct_points(mesh.pointList, 1e-6)
+        welded, stats = weld_vertices(soup(mesh, 1e-4, rng), 1e-3)
+        assert stats.inputFaces == stats.outputFaces == len(mesh.indexList)
+        assert stats.outputPoints == len(welded.pointList) == expected
+        assert abs(surface(welded) - surface(mesh)) < 1e-2
+        # the welded faces use the points of the original faces
+        for face, weldedface in zip(face_list(mesh), face_list(welded)):
+            for i, j in zip(face, weldedface):
+                assert norm(mesh.pointList[i] - welded.pointList[j]) < 1e-3
+
+def test_weld_points_tolerance():
+    points = Point3Array([Vector3(0,0,0), Vector3(0.05,0,0), Vector3(1,0,0), Vector3(1,0.2,0), Vector3(0,0,0)])
+    welded, remap = weld_points(points, 0.1)
+    assert list(remap) == [0, 0, 1, 2, 0]
+    assert len(welded) == 3
+    welded, remap = weld_points(points, 0)
+    assert list(remap) == [0, 1, 2, 3, 0]
+
+def test_weld_degenerated_faces():
+    points = Point3Array([Vector3(0,0,0), Vector3(1,0,0), Vector3(0,1,0), Vector3(1,1,0), Vector3(1,1e-4,0)])
+    mesh = TriangleSet(points, Index3Array([Index3(0,1,2), Index3(1,3,2), Index3(0,1,4)]))
+    welded, stats = weld_vertices(mesh, 1e-3)
+    assert stats.inputFaces == 3 and stats.outputFaces == 2
+    assert len(welded.pointList) == 4
+    # a degenerated quad is removed
+    quads = QuadSet(points, Index4Array([Index4(0,1,3,2), Index4(0,1,4,3)]))
+    welded, stats = weld_vertices(quads, 1e-3)
+    assert stats.outputFaces == 1 and len(welded.pointList) == 4
+    # the merged corners of a polygon are collapsed
+    polygons = FaceSet(points, IndexArray([Index([0,1,4,3,2])]))
+    welded, stats = weld_vertices(polygons, 1e-3)
+    assert stats.outputFaces == 1 and face_list(welded) == [[0,1,3,2]]
+    # nothing remains
+    welded, stats = weld_vertices(TriangleSet(points, Index3Array([Index3(0,1,4)])), 1e-3)
+    assert welded is None and stats.outputFaces == 0
+
+def two_quads(texcoords):
+    """ Two unit quads side by side, each with its own points. """
+    points = Point3Array([Vector3(0,0,0), Vector3(1,0,0), Vector3(1,1,0), Vector3(0,1,0),
+                          Vector3(1,0,0), Vector3(2,0,0), Vector3(2,1,0), Vector3(1,1,0)])
+    return QuadSet(points, Index4Array([Index4(0,1,2,3), Index4(4,5,6,7)]), texCoordList = Point2Array(texcoords))
+
+def test_weld_texcoord_seams():
+    # coincident texture coordinates are merged
+    mesh = two_quads([Vector2(0,0), Vector2(0.5,0), Vector2(0.5,1), Vector2(0,1),
+                      Vector2(0.5,0), Vector2(1,0), Vector2(1,1), Vector2(0.5,1)])
+    welded, stats = weld_vertices(mesh)
+    assert len(welded.pointList) == 6
+    assert welded.texCoordIndexList is None and len(welded.texCoordList) == 6
+    for face, weldedface in zip(face_list(mesh), face_list(welded)):
+        for i, j in zip(face, weldedface):
+            assert mesh.texCoordList[i] == welded.texCoordList[j]
+    # a seam keeps the texture coordinates of the original points
+    mesh = two_quads([Vector2(0,0), Vector2(1,0), Vector2(1,1), Vector2(0,1),
+                      Vector2(0,0), Vector2(1,0), Vector2(1,1), Vector2(0,1)])
+    welded, stats = weld_vertices(mesh)
+    assert len(welded.pointList) == 6
+    assert welded.texCoordIndexList is not None
+    for f in xrange(2):
+        for j in xrange(4):
+            assert welded.texCoordList[welded.texCoordIndexList[f][j]] == mesh.texCoordList[mesh.indexList[f][j]]
+
+def test_weld_incomplete_attributes():
+    """ Normals or colors per vertex without an entry for each point are dropped. """
+    points = Point3Array([Vector3(0,0,0), Vector3(1,0,0), Vector3(0,1,0), Vector3(1,0,0)])
+    indices = Index3Array([Index3(0,1,2), Index3(2,3,0)])
+    mesh = TriangleSet(points, indices, normalList = Point3Array([Vector3(0,0,1)]*2), normalPerVertex = True,
+                       colorList = Color4Array([Color4(255,0,0,0)]*2), colorPerVertex = True)
+    welded, stats = weld_vertices(mesh)
+    assert welded.normalList is None and welded.colorList is None
+    # given per face, they are kept for the remaining faces
+    mesh = TriangleSet(points, Index3Array([Index3(0,1,2), Index3(0,1,3)]),
+                       normalList = Point3Array([Vector3(0,0,1), Vector3(0,1,0)]), normalPerVertex = False,
+                       colorList = Color4Array([Color4(255,0,0,0), Color4(0,255,0,0)]), colorPerVertex = False)
+    welded, stats = weld_vertices(mesh)
+    assert stats.outputFaces == 1
+    assert list(welded.normalList) == [Vector3(0,0,1)] and list(welded.colorList) == [Color4(255,0,0,0)]
@@ -0,0 +1,107 @@
+from openalea.plantgl.all import *
+from random import Random
+from math import floor, sqrt
+
+def random_points(rng, nb, extent):
+    return Point3Array([Vector3(rng.uniform(0,extent), rng.uniform(-extent,0), rng.gauss(0,extent/4.)) for i in xrange(nb)])
+
+def voxel_cells(points, voxelsize):
+    """ The cell of each point in a grid of cubic voxels over the bounding box of the points, and the dimensions of the grid. """
+    lower = [min([p[i] for p in points]) for i in xrange(3)]
+    upper = [max([p[i] for p in points]) for i in xrange(3)]
+    dims = [int(floor((upper[i] - lower[i]) / voxelsize)) + 1 for i in xrange(3)]
+    return [[min(int((p[i] - lower[i]) / voxelsize), dims[i] - 1) for i in xrange(3)] for p in points], dims
+
+def brute_force_voxels(points, voxelsize):
+    """ The points of each voxel, sorted by voxel key. """
+    cells, dims = voxel_cells(points, voxelsize)
+    voxels = {}
+    for pid, c in enumerate(cells):
+        voxels.setdefault(c[0] + dims[0] * (c[1] + dims[1] * c[2]), []).append(pid)
+    return [voxels[key] for key in sorted(voxels.keys())]
+
+def test_voxel_downsample():
+    rng = Random(45)
+    # more points than a thread processes and more voxels than a digit of the radix sort
+    points = random_points(rng, 10000, 100)
+    colors = Color4Array([Color4(rng.randint(0,255), rng.randint(0,255), rng.randint(0,255), rng.randint(0,255)) for i in xrange(len(points))])
+    for voxelsize in [0.5, 7, 1000]:
+        voxels = brute_force_voxels(points, voxelsize)
+        assert [list(g) for g in voxel_groups(points, voxelsize)] == voxels
+        indices, meanpoints, counts, meancolors = voxel_downsample(points, voxelsize, True, colors)
+        assert list(voxel_downsample(points, voxelsize)) == list(indices)
+        assert len(indices) == len(meanpoints) == len(counts) == len(meancolors) == len(voxels)
+        for v, voxel in enumerate(voxels):
+            assert counts[v] == len(voxel)
+            mean = sum([points[i] for i in voxel], Vector3(0,0,0)) / len(voxel)
+            assert norm(meanpoints[v] - mean) <= 1e-9 * max(1, norm(mean))
+            # the representative is the point of the voxel closest to the mean
+            assert indices[v] in voxel
+            assert normSquared(points[indices[v]] - mean) <= min([normSquared(points[i] - mean) for i in voxel]) + 1e-9
+            for component in ['red', 'green', 'blue', 'alpha']:
+                total = sum([getattr(colors[i], component) for i in voxel])
+                assert getattr(meancolors[v], component) == (total + len(voxel) / 2) / len(voxel)
+    # colors of another size are ignored
+    result = voxel_downsample(points, 7, True, Color4Array([Color4(0,0,0,0)]))
+    assert len(result) == 3 and list(result[0]) == list(voxel_downsample(points, 7))
+    assert len(voxel_downsample(Point3Array(), 1)) == 0
+    assert len(voxel_downsample(points, 0)) == 0
+
+def brute_force_poisson_disk(points, radius):
+    """ The points are tested by phases of cells, cells by key and points by index. """
+    cells, dims = voxel_cells(points, radius)
+    phase = lambda voxel : sum([(cells[voxel[0]][i] % 3) * 3 ** i for i in xrange(3)])
+    samples = []
+    for voxel in sorted(brute_force_voxels(points, radius), key = phase):
+        for pid in voxel:
+            if all([normSquared(points[pid] - points[s]) >= radius * radius for s in samples]):
+                samples.append(pid)
+    return sorted(samples)
+
+def test_poisson_disk_subsample():
+    rng = Random(46)
+    points = random_points(rng, 2000, 10)
+    for radius in [0.7, 3]:
+        samples = poisson_disk_subsample(points, radius)
+        assert list(samples) == brute_force_poisson_disk(points, radius)
+        # the samples are apart and every point is close to one of them
+        for i in xrange(len(samples)):
+            for j in xrange(i):
+                assert norm(points[samples[i]] - points[samples[j]]) >= radius
+        for p in points:
+            assert min([norm(p - points[s]) for s in samples]) < radius
+    assert len(poisson_disk_subsample(Point3Array(), 1)) == 0
+
+def noisy_points(rng, nb = 1000, nboutliers = 20):
+    """ Points of a unit cube, with outliers far from it. """
+    points = [Vector3(rng.uniform(0,1), rng.uniform(0,1), rng.uniform(0,1)) for i in xrange(nb)]
+    points += [Vector3(rng.uniform(3,5), rng.uniform(-5,-3), rng.uniform(3,5)) for i in xrange(nboutliers)]
+    rng.shuffle(points)
+    return Point3Array(points)
+
+def brute_force_mean_distances(points, k):
+    return [sum(sorted([norm(q - p) for j, q in enumerate(points) if j != i])[:k]) / min(k, len(points) - 1) for i, p in enumerate(points)]
+
+def test_statistical_outlier_filter():
+    rng = Random(47)
+    points = noisy_points(rng)
+    for k, stdratio in [(8, 1), (3, 2), (20, 0.5)]:
+        reference = brute_force_mean_distances(points, k)
+        mean = sum(reference) / len(reference)
+        deviation = sqrt(sum([d * d for d in reference]) / len(reference) - mean * mean)
+        indices, meandistances = statistical_outlier_filter(points, k, stdratio, True)
+        assert all([abs(meandistances[i] - reference[i]) <= 1e-9 for i in xrange(len(points))])
+        assert list(indices) == [i for i, d in enumerate(reference) if d <= mean + stdratio * deviation]
+        assert list(statistical_outlier_filter(points, k, stdratio)) == list(indices)
+    # the points far from the cube are removed
+    indices = statistical_outlier_filter(points, 8, 1)
+    assert all([max(points[i].x, -points[i].y, points[i].z) <= 1 for i in indices])
+    assert len(statistical_outlier_filter(Point3Array(), 8)) == 0
+
+def test_radius_outlier_filter():
+    rng = Random(48)
+    points = noisy_points(rng)
+    for radius, minneighbors in [(0.1, 1), (0.2, 5), (2, 15), (1, 0)]:
+        counts = [len([q for j, q in enumerate(points) if j != i and normSquared(q - p) < radius * radius]) for i, p in enumerate(points)]
+        assert list(radius_outlier_filter(points, radius, minneighbors)) == [i for i, c in enumerate(counts) if c >= minneighbors]
+    assert len(radius_outlier_filter(Point3Array(), 1, 2)) == 0
@@ -35,6 +35,258 @@ def test_median_point():
    
    
   
+from random import Random
+
+def small_skeleton():
+    """ A trunk with two branches. Node 0 is the root. """
+    nodes = Point3Array([Vector3(0,0,0), Vector3(0,0,10), Vector3(0,0,20), Vector3(10,0,30), Vector3(-6,1,27)])
+    parents = Uint32Array1([0,0,1,2,2])
+    radii = RealArray([3,2,1,0.5,0.25])
+    return nodes, parents, radii
+
+def skeleton_points(nb = 300):
+    rng = Random(42)
+    return Point3Array([Vector3(rng.uniform(-15,15),rng.uniform(-5,5),rng.uniform(-5,35)) for i in xrange(nb)])
+
+def segment_projection(p, a, b):
+    """ Position u in [0,1] of the projection of p on [a,b] and distance of p to [a,b]. """
+    ab = b - a
+    l2 = dot(ab,ab)
+    u = 0.
+    if l2 > 0: u = max(0., min(1., dot(p - a, ab) / l2))
+    return u, norm(p - (a + ab * u))
+
+def brute_force_capsules(p, nodes, parents, radii = None):
+    """ (axis distance, signed distance, u, node) for the capsule of each node, going to its parent. """
+    result = []
+    for i in xrange(len(nodes)):
+        u, d = segment_projection(p, nodes[i], nodes[parents[i]])
+        r = 0
+        if radii: r = radii[i] + (radii[parents[i]] - radii[i]) * u
+        result.append((d, d - r, u, i))
+    return result
+
+def test_distances_to_skeleton():
+    nodes, parents, radii = small_skeleton()
+    points = skeleton_points()
+    axisdists = [min([c[0] for c in brute_force_capsules(p, nodes, parents)]) for p in points]
+    signeddists = [min([c[1] for c in brute_force_capsules(p, nodes, parents, radii)]) for p in points]
+    absdists = [min([abs(c[1]) for c in brute_force_capsules(p, nodes, parents, radii)]) for p in points]
+    # maxclosestnodes is ignored: results are exact even with a single node
+    for maxclosestnodes in [1, 10]:
+        assert abs(average_radius(points, nodes, parents, maxclosestnodes) - sum(axisdists)/len(points)) < 1e-5
+        assert abs(average_distance_to_shape(points, nodes, parents, radii, maxclosestnodes) - sum(signeddists)/len(points)) < 1e-5
+        dists = distance_to_shape(points, nodes, parents, radii, maxclosestnodes)
+        assert len(dists) == len(points)
+        for d, ref in zip(dists, absdists):
+            assert abs(d - ref) < 1e-5
+
+def test_distances_to_skeleton_without_points():
+    nodes, parents, radii = small_skeleton()
+    points = Point3Array([])
+    assert average_radius(points, nodes, parents) == 0
+    assert average_distance_to_shape(points, nodes, parents, radii) == 0
+    assert len(distance_to_shape(points, nodes, parents, radii)) == 0
+    assert list(estimate_radii_from_points(points, nodes, parents)) == [0]*len(nodes)
+
+def test_points_at_distance_from_skeleton():
+    nodes, parents, radii = small_skeleton()
+    points = skeleton_points()
+    distance = 4
+    axisdists = [min([c[0] for c in brute_force_capsules(p, nodes, parents)]) for p in points]
+    below = [i for i, d in enumerate(axisdists) if d <= distance]
+    above = [i for i, d in enumerate(axisdists) if d > distance]
+    assert sorted(points_at_distance_from_skeleton(points, nodes, parents, distance, 1)) == below
+    assert sorted(points_at_distance_from_skeleton(points, nodes, parents, -distance, 1)) == above
+
+def test_estimate_radii_from_points():
+    nodes, parents, radii = small_skeleton()
+    points = skeleton_points()
+    # each point contributes to the nearest extremity of its closest capsule
+    sums, counts, maxs = [0]*len(nodes), [0]*len(nodes), [0]*len(nodes)
+    for p in points:
+        d, signed, u, i = min(brute_force_capsules(p, nodes, parents))
+        if u > 0.5: i = parents[i]
+        sums[i] += d
+        counts[i] += 1
+        maxs[i] = max(maxs[i], d)
+    means = [s/c if c > 0 else 0 for s, c in zip(sums, counts)]
+    for r, ref in zip(estimate_radii_from_points(points, nodes, parents, False, 1), means):
+        assert abs(r - ref) < 1e-5
+    for r, ref in zip(estimate_radii_from_points(points, nodes, parents, True, 1), maxs):
+        assert abs(r - ref) < 1e-5
+
+def brute_force_closest_centroid(p, centroids):
+    return min([(norm(p-c),i) for i,c in enumerate(centroids)])[1]
+
+def test_points_clusters():
+    rng = Random(7)
+    points = Point3Array([Vector3(rng.uniform(0,100),rng.uniform(0,100),rng.uniform(0,100)) for i in xrange(1000)])
+    # the last centroid is far from all points and gets none
+    centroids = Point3Array([Vector3(rng.uniform(0,100),rng.uniform(0,100),rng.uniform(0,100)) for i in xrange(20)]+[Vector3(1000,1000,1000)])
+    assignments = [brute_force_closest_centroid(p, centroids) for p in points]
+    assert list(points_clusters(points, centroids)) == assignments
+    clusters = cluster_points(points, centroids)
+    assert len(clusters) == len(centroids)
+    for cid, cluster in enumerate(clusters):
+        assert list(cluster) == [pid for pid, a in enumerate(assignments) if a == cid]
+    assert len(clusters[-1]) == 0
+
+def test_points_clusters_without_centroid_or_point():
+    points = Point3Array([Vector3(0,0,0), Vector3(1,0,0)])
+    centroids = Point3Array([Vector3(0,0,0), Vector3(1,1,1)])
+    assert len(cluster_points(points, Point3Array([]))) == 0
+    assert list(points_clusters(points, Point3Array([]))) == [0, 0]
+    clusters = cluster_points(Point3Array([]), centroids)
+    assert len(clusters) == 2 and len(clusters[0]) == 0 and len(clusters[1]) == 0
+    assert len(points_clusters(Point3Array([]), centroids)) == 0
+
+def delaunay_points(nb = 12):
+    rng = Random(11)
+    return Point3Array([Vector3(rng.uniform(0,10),rng.uniform(0,10),rng.uniform(0,10)) for i in xrange(nb)])
+
+def brute_force_delaunay_tetrahedra(points):
+    from itertools import combinations
+    tetrahedra = []
+    for a, b, c, d in combinations(range(len(points)), 4):
+        u, v, w = points[b]-points[a], points[c]-points[a], points[d]-points[a]
+        det = 2 * dot(u, cross(v, w))
+        if abs(det) < 1e-8: continue
+        center = points[a] + (normSquared(u)*cross(v, w) + normSquared(v)*cross(w, u) + normSquared(w)*cross(u, v)) / det
+        radius = normSquared(points[a]-center)
+        if all([normSquared(p-center) >= radius - 1e-8 for i, p in enumerate(points) if i not in (a, b, c, d)]):
+            tetrahedra.append((a, b, c, d))
+    return tetrahedra
+
+def brute_force_delaunay_facets(points):
+    from itertools import combinations
+    return set([f for t in brute_force_delaunay_tetrahedra(points) for f in combinations(t, 3)])
+
+def test_delaunay_triangulation3D():
+    if not 'delaunay_triangulation3D' in globals(): return
+    points = delaunay_points()
+    facets = brute_force_delaunay_facets(points)
+    result = delaunay_triangulation3D(points)
+    # the facets follow one Index3(0,0,0) per point
+    assert len(result) == len(points) + len(facets)
+    assert all([result[i] == Index3(0,0,0) for i in xrange(len(points))])
+    assert set([tuple(sorted([f[0], f[1], f[2]])) for f in list(result)[len(points):]]) == facets
+
+def test_delaunay_point_connection():
+    if not 'delaunay_point_connection' in globals(): return
+    from itertools import combinations
+    points = delaunay_points()
+    edges = set([e for f in brute_force_delaunay_facets(points) for e in combinations(f, 2)])
+    connections = delaunay_point_connection(points)
+    assert len(connections) == len(points)
+    for i, neighbors in enumerate(connections):
+        assert list(neighbors) == sorted([j for e in edges for j in e if i in e and j != i])
+    offsets, neighbors = delaunay_point_connection_csr(points)
+    assert list(offsets) == [sum([len(c) for c in connections][:i]) for i in xrange(len(points)+1)]
+    assert list(neighbors) == [j for c in connections for j in c]
+
+def plane_points(rng, nb = 100):
+    """ Points of the plane z = 0.3 x - 0.2 y + 1. """
+    return [Vector3(x, y, 0.3 * x - 0.2 * y + 1) for x, y in [(rng.uniform(-5,5), rng.uniform(-5,5)) for i in xrange(nb)]]
+
+def parallel(u, v, eps = 1e-6):
+    return norm(cross(u, v)) <= eps * norm(u) * norm(v)
+
+def test_pointset_normal_and_orientation():
+    rng = Random(41)
+    points = Point3Array(plane_points(rng))
+    normal = pointset_normal(points, Index(range(len(points))))
+    assert abs(norm(normal) - 1) < 1e-9 and parallel(normal, Vector3(-0.3, 0.2, 1))
+    direction = Vector3(1, 2, -2) / 3
+    points = Point3Array([Vector3(1,1,1) + direction * rng.uniform(-10,10) for i in xrange(100)])
+    orientation = pointset_orientation(points, Index(range(len(points))))
+    assert abs(norm(orientation) - 1) < 1e-9 and parallel(orientation, direction)
+    assert pointset_normal(points, Index([])) == Vector3(0,0,0)
+    assert pointset_orientation(points, Index([])) == Vector3(0,0,0)
+
+def check_eigen(matrix, values, vectors, eps = 1e-9):
+    """ The vectors are orthonormal eigenvectors of the matrix, with decreasing eigenvalues. """
+    scale = max(1, abs(values[0]), abs(values[2]))
+    assert values[0] >= values[1] >= values[2]
+    for i in xrange(3):
+        assert abs(norm(vectors[i]) - 1) < eps
+        assert norm(matrix * vectors[i] - vectors[i] * values[i]) < eps * scale
+        for j in xrange(i):
+            assert abs(dot(vectors[i], vectors[j])) < eps
+
+def test_symmetric_eigen_diagonal():
+    ex, ey, ez = Vector3(1,0,0), Vector3(0,1,0), Vector3(0,0,1)
+    matrix = Matrix3(1,0,0, 0,3,0, 0,0,2)
+    values, vectors = symmetric_eigen(matrix)
+    check_eigen(matrix, values, vectors)
+    assert norm(values - Vector3(3,2,1)) < 1e-12
+    assert parallel(vectors[0], ey) and parallel(vectors[1], ez) and parallel(vectors[2], ex)
+    # repeated eigenvalues: any orthonormal basis of their eigenspace
+    matrix = Matrix3(2,0,0, 0,2,0, 0,0,1)
+    values, vectors = symmetric_eigen(matrix)
+    check_eigen(matrix, values, vectors)
+    assert norm(values - Vector3(2,2,1)) < 1e-12
+    assert parallel(vectors[2], ez) and abs(vectors[0].z) < 1e-9 and abs(vectors[1].z) < 1e-9
+    matrix = Matrix3(1,0,0, 0,2,0, 0,0,2)
+    values, vectors = symmetric_eigen(matrix)
+    check_eigen(matrix, values, vectors)
+    assert parallel(vectors[2], ex)
+    for value in [1, 0]:
+        matrix = Matrix3(value,0,0, 0,value,0, 0,0,value)
+        values, vectors = symmetric_eigen(matrix)
+        check_eigen(matrix, values, vectors)
+        assert values == Vector3(value,value,value)
+
+def test_symmetric_eigen_rotated():
+    rng = Random(42)
+    for i in xrange(100):
+        axis = Vector3(rng.gauss(0,1), rng.gauss(0,1), rng.gauss(0,1))
+        rotation = Matrix3.axisRotation(axis / norm(axis), rng.uniform(0, 6.28))
+        diagonal = [rng.uniform(-10,10) for j in xrange(3)]
+        if i % 2: diagonal[1] = diagonal[0]
+        matrix = rotation * Matrix3(diagonal[0],0,0, 0,diagonal[1],0, 0,0,diagonal[2]) * rotation.transpose()
+        values, vectors = symmetric_eigen(matrix)
+        check_eigen(matrix, values, vectors)
+        assert norm(values - Vector3(*sorted(diagonal, reverse = True))) < 1e-9 * max(1, max([abs(d) for d in diagonal]))
+
+def brute_force_covariance(points):
+    return [[sum([p[i] * p[j] for p in points]) / len(points) for j in xrange(3)] for i in xrange(3)]
+
+def test_pointset_covariance():
+    """ The covariance summed by chunks is the one summed point by point. """
+    rng = Random(43)
+    points = Point3Array([Vector3(rng.gauss(1,2), rng.gauss(-3,1), rng.uniform(0,10)) for i in xrange(10000)])
+    subset = Index(rng.sample(xrange(len(points)), 5000))
+    for group, selection in [(Index(), list(points)), (subset, [points[i] for i in subset]), (Index([7]), [points[7]])]:
+        covariance = pointset_covariance(points, group)
+        reference = brute_force_covariance(selection)
+        for i in xrange(3):
+            for j in xrange(3):
+                assert abs(covariance[i,j] - reference[i][j]) <= 1e-9 * max(1, abs(reference[i][j]))
+    assert pointset_covariance(Point3Array()) == Matrix3(0,0,0,0,0,0,0,0,0)
+
+def test_pointsets_normals():
+    """ The normals and orientations are computed per group, whatever the number of points. """
+    rng = Random(44)
+    points = Point3Array(plane_points(rng) + [Vector3(rng.gauss(0,1), rng.gauss(0,1), rng.gauss(0,1)) for i in xrange(50)])
+    nb = len(points)
+    for nbgroups in [300, 20]:
+        groups = IndexArray([Index(range(100))] + [Index(rng.sample(xrange(nb), rng.randint(3, 30))) for i in xrange(nbgroups)] + [Index([])])
+        normals = pointsets_normals(points, groups)
+        orientations, features = pointsets_orientations(points, groups, True)
+        eigenvalues, majoraxes, minoraxes, allfeatures = pointsets_principal_axes(points, groups)
+        assert len(normals) == len(orientations) == len(features) == len(eigenvalues) == len(groups)
+        assert list(normals) == list(minoraxes) and list(orientations) == list(majoraxes)
+        assert list(features) == list(allfeatures)
+        assert parallel(normals[0], Vector3(-0.3, 0.2, 1))
+        for i, group in enumerate(list(groups)[:-1]):
+            assert parallel(normals[i], pointset_normal(points, group))
+            assert parallel(orientations[i], pointset_orientation(points, group))
+            assert abs(sum([features[i][j] for j in xrange(3)]) - 1) < 1e-9
+        # an empty group has no axis
+        assert normals[-1] == orientations[-1] == features[-1] == Vector3(0,0,0)
+
+
 if __name__ == '__main__':
     for i in xrange(50):
         test_median_point()
@@ -0,0 +1,114 @@
+from openalea.plantgl.all import *
+from random import Random
+from math import ceil, pi
+
+def sampling_scene():
+    scene = Scene()
+    scene += Shape(Box(Vector3(1,2,3)), Material(), 1)
+    scene += Shape(Translated(Vector3(5,0,0), Sphere(1, 16, 16)), Material(), 2)
+    scene += Shape(Polyline([(0,0,0),(1,1,1)]), Material(), 3)
+    scene += Shape(Translated(Vector3(0,6,0), Scaled(Vector3(2,1,0.5), Cylinder(1, 4, True, 12))), Material(), 4)
+    return scene
+
+def baked_triangles(scene):
+    """ The vertices of the baked triangles, their areas and the shape of each triangle. """
+    points, normals, triangles, shapeindices, shapeids, offsets = bake_scene(scene)
+    vertices = [[points[j] for j in triangle] for triangle in triangles]
+    areas = [surface(p0, p1, p2) for p0, p1, p2 in vertices]
+    return vertices, areas, [shapeids[i] for i in shapeindices], offsets
+
+def test_reproducible():
+    scene = sampling_scene()
+    # more points than a thread samples
+    points = random_points_on_scene(scene, 10000, 50)
+    assert len(points) == 10000
+    assert list(random_points_on_scene(scene, 10000, 50)) == list(points)
+    assert list(random_points_on_scene(scene, 10000, 51)) != list(points)
+    assert list(random_points_on_scene(scene, 10000, 50, True)[0]) == list(points)
+    samples = poisson_disk_points_on_scene(scene, 0.3, 50)
+    assert list(poisson_disk_points_on_scene(scene, 0.3, 50)) == list(samples)
+    assert list(poisson_disk_points_on_scene(scene, 0.3, 51)) != list(samples)
+
+def test_counts_proportional_to_area():
+    """ The samples are stratified along the area, so each triangle and each shape gets its share of samples within 2. """
+    scene = sampling_scene()
+    vertices, areas, triangleshapes, offsets = baked_triangles(scene)
+    total = sum(areas)
+    shapeindices = dict([(sh.id, i) for i, sh in enumerate(scene)])
+    for nb in [100, 10000]:
+        points, normals, shapeids, triangleindices, barycentrics = random_points_on_scene(scene, nb, 52, True)
+        trianglecounts = [0] * len(areas)
+        for i in xrange(nb):
+            trianglecounts[offsets[shapeindices[shapeids[i]]] + triangleindices[i]] += 1
+        assert all([abs(trianglecounts[t] - nb * areas[t] / total) < 2 for t in xrange(len(areas))])
+        for sh in scene:
+            shapearea = sum([areas[t] for t in xrange(len(areas)) if triangleshapes[t] == sh.id])
+            assert abs(len([s for s in shapeids if s == sh.id]) - nb * shapearea / total) < 2
+    # the polyline has no surface
+    assert not 3 in random_points_on_scene(scene, 1000, 52, True)[2]
+
+def check_on_triangles(scene, points, normals, shapeids, triangleindices, barycentrics):
+    vertices, areas, triangleshapes, offsets = baked_triangles(scene)
+    shapeindices = dict([(sh.id, i) for i, sh in enumerate(scene)])
+    for i in xrange(len(points)):
+        t = offsets[shapeindices[shapeids[i]]] + triangleindices[i]
+        assert t < offsets[shapeindices[shapeids[i]] + 1]
+        p0, p1, p2 = vertices[t]
+        a, b, c = barycentrics[i]
+        assert min(a, b, c) >= 0 and abs(a + b + c - 1) < 1e-9
+        # the sampler bakes the scene in single precision
+        assert norm(p0 * a + p1 * b + p2 * c - points[i]) < 1e-5
+        assert abs(norm(normals[i]) - 1) < 1e-9
+        assert dot(normals[i], cross(p1 - p0, p2 - p0)) > 0
+
+def test_points_on_triangles():
+    scene = sampling_scene()
+    check_on_triangles(scene, *random_points_on_scene(scene, 5000, 53, True))
+    assert len(random_points_on_scene(Scene(), 10, 53)) == 0
+    assert all([len(a) == 0 for a in random_points_on_scene(Scene([Shape(Polyline([(0,0,0),(1,1,1)]))]), 10, 53, True)])
+
+def test_poisson_disk_points():
+    scene = sampling_scene()
+    total = sum(baked_triangles(scene)[1])
+    for radius, oversampling in [(0.3, 4), (1.1, 2)]:
+        result = poisson_disk_points_on_scene(scene, radius, 54, oversampling, True)
+        samples = result[0]
+        assert list(poisson_disk_points_on_scene(scene, radius, 54, oversampling)) == list(samples)
+        check_on_triangles(scene, *result)
+        for i in xrange(len(samples)):
+            for j in xrange(i):
+                assert norm(samples[i] - samples[j]) >= radius
+        # the samples are the Poisson disk subsample of the uniform samples
+        candidates = random_points_on_scene(scene, int(ceil(oversampling * total / (pi * radius * radius))), 54)
+        assert list(samples) == [candidates[i] for i in poisson_disk_subsample(candidates, radius)]
+        assert all([min([norm(p - s) for s in samples]) < radius for p in candidates])
+    assert len(poisson_disk_points_on_scene(scene, 0)) == 0
+
+def tetrahedron_coordinates(p, p0, p1, p2, p3):
+    """ The barycentric coordinates of p in the tetrahedron as ratios of volumes. """
+    volume = lambda a, b, c, d : dot(b - a, cross(c - a, d - a))
+    total = volume(p0, p1, p2, p3)
+    return [volume(p, p1, p2, p3) / total, volume(p0, p, p2, p3) / total, volume(p0, p1, p, p3) / total, volume(p0, p1, p2, p) / total]
+
+def test_random_points_in_tetrahedra():
+    rng = Random(55)
+    # no tetrahedron contains the origin, so the slots left to their default value would be outside
+    points = Point3Array([Vector3(rng.uniform(1,10), rng.uniform(1,10), rng.uniform(1,10)) for i in xrange(40)])
+    tetrahedra = Index4Array([Index4(*rng.sample(xrange(len(points)), 4)) for i in xrange(300)])
+    for nb in [1, 30]:
+        for seed in [None, 56]:
+            samples = random_points_in_tetrahedra(nb, points, tetrahedra, seed)
+            assert len(samples) == nb * len(tetrahedra)
+            for t, tetrahedron in enumerate(tetrahedra):
+                vertices = [points[j] for j in tetrahedron]
+                for i in xrange(nb):
+                    assert min(tetrahedron_coordinates(samples[t * nb + i], *vertices)) > -1e-9
+                if nb > 1:
+                    assert len(set([(samples[t * nb + i].x, samples[t * nb + i].y, samples[t * nb + i].z) for i in xrange(nb)])) == nb
+    assert list(random_points_in_tetrahedra(30, points, tetrahedra, 56)) == list(random_points_in_tetrahedra(30, points, tetrahedra, 56))
+    assert list(random_points_in_tetrahedra(30, points, tetrahedra, 56)) != list(random_points_in_tetrahedra(30, points, tetrahedra, 57))
+    # the samples are uniform: their mean is the centroid of the tetrahedron
+    vertices = [Vector3(0,0,0), Vector3(1,0,0), Vector3(0,2,0), Vector3(0,0,3)]
+    samples = random_points_in_tetrahedra(20000, Point3Array(vertices), Index4Array([Index4(0,1,2,3)]), 58)
+    mean = sum(samples, Vector3(0,0,0)) / len(samples)
+    assert norm(mean - sum(vertices, Vector3(0,0,0)) / 4) < 0.02
@@ -0,0 +1,49 @@
+from openalea.plantgl.all import *
+
+def baking_scene():
+    box = Box(Vector3(1,2,3))
+    scene = Scene()
+    scene += Shape(box, Material(), 1)
+    scene += Shape(Translated(Vector3(5,0,0), Sphere(1, 16, 16)), Material(), 2)
+    scene += Shape(Polyline([(0,0,0),(1,1,1)]), Material(), 3)
+    scene += Shape(Translated(Vector3(0,5,0), box), Material(), 4)
+    return scene
+
+def test_bake_scene():
+    scene = baking_scene()
+    points, normals, triangles, shapeindices, shapeids, offsets = bake_scene(scene)
+    assert list(shapeids) == [1, 2, 3, 4]
+    assert len(offsets) == len(scene) + 1
+    assert offsets[0] == 0 and offsets[-1] == len(triangles)
+    assert len(shapeindices) == len(triangles)
+    assert len(normals) == len(points)
+    # polylines are not triangulated
+    assert offsets[2] == offsets[3]
+    for i, sh in enumerate(scene):
+        if i == 2 : continue
+        mesh = tesselate(sh.geometry)
+        assert offsets[i+1] - offsets[i] == len(mesh.indexList)
+        bakedsurface = 0
+        for t in range(offsets[i], offsets[i+1]):
+            assert shapeindices[t] == i
+            p0, p1, p2 = [points[j] for j in triangles[t]]
+            bakedsurface += surface(p0, p1, p2)
+            # triangles are counter clockwise with respect to the normals of their vertices
+            facenormal = cross(p1 - p0, p2 - p0)
+            for j in triangles[t]:
+                assert abs(norm(normals[j]) - 1) < 1e-5
+                assert dot(facenormal, normals[j]) > 0
+        assert abs(bakedsurface - surface(mesh)) < 1e-5 * bakedsurface, (bakedsurface, surface(mesh))
+    # the translated box is baked at its place
+    box0 = BoundingBox(PointSet([points[j] for t in range(offsets[0], offsets[1]) for j in triangles[t]]))
+    box3 = BoundingBox(PointSet([points[j] for t in range(offsets[3], offsets[4]) for j in triangles[t]]))
+    assert norm(box3.getCenter() - box0.getCenter() - Vector3(0,5,0)) < 1e-5
+
+def test_bake_scene_without_normals():
+    points, normals, triangles, shapeindices, shapeids, offsets = bake_scene(baking_scene(), False)
+    assert normals is None
+    assert len(triangles) > 0
+
+if __name__ == '__main__':
+    test_bake_scene()
+    test_bake_scene_without_normals()
@@ -0,0 +1,149 @@
+from openalea.plantgl.all import *
+from random import Random
+
+def spheres_scene():
+    """ Three spheres of radius 1 centered at x = 0, 3 and 6. """
+    scene = Scene()
+    for i in range(3):
+        scene += Shape(Translated(Vector3(3*i,0,0), Sphere(1, 16, 16)), Material(), 10+i)
+    return scene
+
+def box_frustum(lower, upper):
+    """ A frustum made of the faces of the box [lower, upper]. """
+    frustum = ViewFrustum()
+    frustum.setPlane(0, Vector4( 1, 0, 0, -lower[0]))
+    frustum.setPlane(1, Vector4(-1, 0, 0,  upper[0]))
+    frustum.setPlane(2, Vector4( 0, 1, 0, -lower[1]))
+    frustum.setPlane(3, Vector4( 0,-1, 0,  upper[1]))
+    frustum.setPlane(4, Vector4( 0, 0, 1, -lower[2]))
+    frustum.setPlane(5, Vector4( 0, 0,-1,  upper[2]))
+    return frustum
+
+# BBoxComputer does not keep its discretizer alive.
+discretizer = Discretizer()
+bboxcomputer = BBoxComputer(discretizer)
+
+def build_bvh(scene):
+    bvh = SceneBVH(bboxcomputer)
+    assert bvh.build(scene)
+    assert bvh.isBuilt()
+    return bvh
+
+def test_scenebvh_intersect():
+    bvh = build_bvh(spheres_scene())
+    # the nearest sphere along the ray is returned
+    res = bvh.intersect(Ray(Vector3(-5,0,0), Vector3(1,0,0)))
+    assert res is not None
+    position, distance = res
+    assert position == 0
+    assert abs(distance - 4) < 1e-3
+    res = bvh.intersect(Ray(Vector3(10,0,0), Vector3(-1,0,0)))
+    assert res is not None and res[0] == 2 and abs(res[1] - 3) < 1e-3
+    # from above the middle sphere, the pole is hit
+    res = bvh.intersect(Ray(Vector3(3,0,5), Vector3(0,0,-1)))
+    assert res is not None and res[0] == 1 and abs(res[1] - 4) < 1e-3
+    # between the spheres and beside them, nothing is hit
+    assert bvh.intersect(Ray(Vector3(1.5,0,5), Vector3(0,0,-1))) is None
+    assert bvh.intersect(Ray(Vector3(-5,3,0), Vector3(1,0,0))) is None
+
+def test_scenebvh_select():
+    bvh = build_bvh(spheres_scene())
+    select = lambda lower, upper : sorted(bvh.select(box_frustum(lower, upper)))
+    assert select((-1.5,-2,-2),(1.5,2,2)) == [0]
+    assert select((2.5,-2,-2),(10,2,2)) == [1, 2]
+    assert select((-10,-10,-10),(10,10,10)) == [0, 1, 2]
+    # a box between two spheres selects nothing
+    assert select((1.2,-2,-2),(1.8,2,2)) == []
+    # a box overlapping the side of two spheres selects both
+    assert select((0.9,-0.1,-0.1),(2.1,0.1,0.1)) == [0, 1]
+    # the bounding boxes overlap this box but not the spheres
+    assert select((0.8,0.8,-0.1),(2.2,1.5,0.1)) == []
+
+def test_scenebvh_clear():
+    bvh = build_bvh(spheres_scene())
+    bvh.clear()
+    assert not bvh.isBuilt()
+    assert bvh.intersect(Ray(Vector3(-5,0,0), Vector3(1,0,0))) is None
+
+def brute_force_location(frustum, lower, upper):
+    """ The location of a box from the signed distances of its corners to the planes of the frustum. """
+    result = ViewFrustum.Inside
+    for i in xrange(6):
+        plane = frustum.getPlane(i)
+        distances = [plane.x * x + plane.y * y + plane.z * z + plane.w for x in (lower[0], upper[0])
+                                                                          for y in (lower[1], upper[1])
+                                                                          for z in (lower[2], upper[2])]
+        if max(distances) < 0: return ViewFrustum.Outside
+        if min(distances) < 0: result = ViewFrustum.Intersecting
+    return result
+
+def tilted_frustum():
+    frustum = ViewFrustum()
+    planes = [(1,0.2,0.1,-0.5), (-1,0.3,-0.2,6.2), (0.1,1,0,-0.7), (0.2,-1,0.3,5.9), (-0.3,0.1,1,-0.4), (0,0.2,-1,6.1)]
+    for i, plane in enumerate(planes):
+        frustum.setPlane(i, Vector4(*plane))
+    return frustum
+
+def random_box(rng):
+    lower = Vector3(rng.uniform(-2,8),rng.uniform(-2,8),rng.uniform(-2,8))
+    return lower, lower + Vector3(rng.uniform(0,3),rng.uniform(0,3),rng.uniform(0,3))
+
+def test_viewfrustum_locate():
+    rng = Random(7)
+    for frustum in [box_frustum((1.3,0.6,2.1),(5.7,4.4,6.3)), tilted_frustum()]:
+        locations = set()
+        for i in xrange(500):
+            lower, upper = random_box(rng)
+            location = frustum.locate(lower, upper)
+            assert location == brute_force_location(frustum, lower, upper)
+            locations.add(location)
+        assert locations == set([ViewFrustum.Outside, ViewFrustum.Intersecting, ViewFrustum.Inside])
+    # the default frustum contains everything
+    assert ViewFrustum().locate(Vector3(-1e5,-1e5,-1e5), Vector3(1e5,1e5,1e5)) == ViewFrustum.Inside
+
+def grid_scene(n = 8):
+    """ Spheres of radius 0.4 centered on the points of a n x n x n grid of step 1. """
+    scene = Scene()
+    for i in xrange(n):
+        for j in xrange(n):
+            for k in xrange(n):
+                scene += Shape(Translated(Vector3(i,j,k), Sphere(0.4, 8, 8)), Material(), len(scene))
+    return scene
+
+def test_scenebvh_cull():
+    """ The shapes kept by the culling are the ones whose bounding box is not out of the frustum. """
+    scene = grid_scene()
+    bvh = build_bvh(scene)
+    bboxes = []
+    for sh in scene:
+        assert sh.apply(bboxcomputer)
+        bboxes.append(bboxcomputer.result)
+    for frustum in [box_frustum((1.3,0.6,2.1),(5.7,4.4,6.3)), tilted_frustum()]:
+        expected = [i for i, bbox in enumerate(bboxes)
+                    if brute_force_location(frustum, bbox.lowerLeftCorner, bbox.upperRightCorner) != ViewFrustum.Outside]
+        culled = sorted(bvh.cull(frustum))
+        assert culled == expected
+        assert 0 < len(culled) < len(scene)
+        # the selection tests the shapes themselves, the culling only their boxes
+        assert set(bvh.select(frustum)) <= set(culled)
+    assert sorted(bvh.cull(ViewFrustum())) == range(len(scene))
+    assert bvh.cull(box_frustum((20,20,20),(30,30,30))) == []
+
+def test_scenebvh_occlusion_cull():
+    """ A wall in front of the grid hides it in an orthographic view of [-10,10]^3 looking toward +z. """
+    clip = Matrix4(Matrix3.scaling(Vector3(0.1,0.1,0.1)))
+    frustum = ViewFrustum(clip)
+    for z, hidden in [(-8, True), (9, False)]:
+        scene = grid_scene(5)
+        wall = len(scene)
+        scene += Shape(Translated(Vector3(2,2,z), Box(Vector3(8,8,0.5))), Material(), wall)
+        bvh = build_bvh(scene)
+        occlusion = OcclusionBuffer()
+        occlusion.setClipMatrix(clip)
+        culled = sorted(bvh.cull(frustum, occlusion))
+        assert wall in culled
+        if hidden:
+            # the test is conservative: the spheres of the nodes visited before the wall are kept
+            assert len(culled) < len(scene) / 4
+        else:
+            assert culled == range(len(scene))
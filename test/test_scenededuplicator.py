@@ -0,0 +1,118 @@
+from openalea.plantgl.all import *
+
+def distinct_ids(objects):
+    return len(set([o.getId() for o in objects]))
+
+def test_shared_materials():
+    """ Identical unnamed materials and geometries are shared, whatever the names computed by the shapes. """
+    scene = Scene()
+    for i in xrange(10):
+        scene += Shape(Box(Vector3(1,2,3)), Material(Color3(255,0,0)), i)
+    scene += Shape(Box(Vector3(1,2,3)), Material(Color3(0,255,0)), 10)
+    deduplicator = SceneDeduplicator()
+    assert deduplicator.deduplicate(scene) == 19
+    assert deduplicator.visitedNb == 22 and deduplicator.duplicateNb == 19
+    assert deduplicator.savedMemory > 0
+    assert distinct_ids([sh.geometry for sh in scene]) == 1
+    assert distinct_ids([sh.appearance for sh in scene]) == 2
+    assert scene[9].appearance.getId() == scene[0].appearance.getId()
+    assert scene[10].appearance.ambient == Color3(0,255,0)
+    # the shapes keep their identity
+    assert [sh.id for sh in scene] == range(11)
+
+def test_cross_sections():
+    """ The cross sections of extrusions are shared, the extrusions along different axes are not. """
+    section = lambda width : Polyline2D(Point2Array([Vector2(-1,0), Vector2(0,1), Vector2(1,0)]), width)
+    axis = lambda length : Polyline(Point3Array([Vector3(0,0,0), Vector3(0,0,length)]))
+    scene = Scene()
+    scene += Shape(Extrusion(axis(1), section(1)), Material(), 1)
+    scene += Shape(Extrusion(axis(2), section(1)), Material(), 2)
+    scene += Shape(Extrusion(axis(1), section(2)), Material(), 3)
+    scene += Shape(Extrusion(axis(1), section(1)), Material(), 4)
+    deduplicator = SceneDeduplicator()
+    deduplicator.deduplicate(scene)
+    sections = [sh.geometry.crossSection for sh in scene]
+    assert sections[0].getId() == sections[1].getId() == sections[3].getId()
+    assert sections[2].getId() != sections[0].getId() and sections[2].width == 2
+    assert scene[0].geometry.axis.getId() == scene[2].geometry.axis.getId()
+    # the extrusions differ by their axis or their section, except the last one
+    assert distinct_ids([sh.geometry for sh in scene]) == 3
+    assert scene[3].geometry.getId() == scene[0].geometry.getId()
+
+def named(geometry, name):
+    geometry.name = name
+    return geometry
+
+def test_names():
+    """ Objects named differently are kept apart, unless names are ignored. """
+    def named_scene():
+        scene = Scene()
+        scene += Shape(named(Sphere(1), 'ball'), Material('red', Color3(255,0,0)), 1)
+        scene += Shape(named(Sphere(1), 'ball'), Material('crimson', Color3(255,0,0)), 2)
+        scene += Shape(named(Sphere(1), 'bead'), Material('red', Color3(255,0,0)), 3)
+        return scene
+    scene = named_scene()
+    assert SceneDeduplicator().deduplicate(scene) == 2
+    assert scene[0].geometry.getId() == scene[1].geometry.getId() != scene[2].geometry.getId()
+    assert scene[0].appearance.getId() == scene[2].appearance.getId() != scene[1].appearance.getId()
+    scene = named_scene()
+    deduplicator = SceneDeduplicator(True)
+    assert deduplicator.ignoreNames
+    assert deduplicator.deduplicate(scene) == 4
+    assert distinct_ids([sh.geometry for sh in scene]) == 1 and distinct_ids([sh.appearance for sh in scene]) == 1
+
+def test_successive_scenes():
+    """ The objects of a scene are replaced by the canonical instances of the previous scenes. """
+    deduplicator = SceneDeduplicator()
+    first = Scene([Shape(Cylinder(1, 2), Material(Color3(0,0,255)), i) for i in xrange(3)])
+    assert deduplicator.deduplicate(first) == 4
+    second = Scene([Shape(Cylinder(1, 2), Material(Color3(0,0,255)), i) for i in xrange(2)])
+    assert deduplicator.deduplicate(second) == 4
+    assert second[0].geometry.getId() == first[0].geometry.getId()
+    assert second[1].appearance.getId() == first[0].appearance.getId()
+    # the canonical instances are not duplicates of themselves
+    assert deduplicator.deduplicate(first) == 0
+    assert deduplicator.deduplicate(first[0].geometry).getId() == first[0].geometry.getId()
+    deduplicator.clear()
+    assert deduplicator.visitedNb == 0 and deduplicator.duplicateNb == 0
+    third = Scene([Shape(Cylinder(1, 2), Material(Color3(0,0,255)), 0)])
+    assert deduplicator.deduplicate(third) == 0
+    assert third[0].geometry.getId() != first[0].geometry.getId()
+
+def test_released_duplicates():
+    """ New objects allocated where released duplicates were are not taken for them. """
+    deduplicator = SceneDeduplicator()
+    for i in xrange(20):
+        boxes = Scene([Shape(Box(Vector3(1,1,1)), Material(Color3(255,0,0)), j) for j in xrange(50)])
+        deduplicator.deduplicate(boxes)
+        spheres = Scene([Shape(Sphere(1 + j + 100 * i), Material(Color3(0,j,i)), j) for j in xrange(50)])
+        assert deduplicator.deduplicate(spheres) == 0
+        for j, sh in enumerate(spheres):
+            assert isinstance(sh.geometry, Sphere) and sh.geometry.radius == 1 + j + 100 * i
+            assert isinstance(sh.appearance, Material) and sh.appearance.ambient == Color3(0,j,i)
+
+DUPLICATED_GEOM = """
+Shape { Id 1 Geometry Box { Size <1.5,2,3> } Appearance Material { Ambient <255,0,0> } }
+Shape { Id 2 Geometry Box { Size <1.5,2,3> } Appearance Material { Ambient <255,0,0> } }
+Shape { Id 3 Geometry Box { Size <1.5,2,3> } Appearance Material { Ambient <0,255,0> } }
+"""
+
+def test_read_process():
+    fname = './data/test_deduplication.geom'
+    stream = open(fname, 'w')
+    stream.write(DUPLICATED_GEOM)
+    stream.close()
+    factory = SceneFactory.get()
+    assert not factory.isReadProcessEnabled('Deduplication')
+    scene = Scene(fname)
+    assert len(scene) == 3 and distinct_ids([sh.geometry for sh in scene]) == 3
+    assert factory.setReadProcessEnabled('Deduplication', True)
+    try:
+        assert factory.isReadProcessEnabled('Deduplication')
+        scene = Scene(fname)
+    finally:
+        factory.setReadProcessEnabled('Deduplication', False)
+    assert len(scene) == 3 and [sh.id for sh in scene] == [1, 2, 3]
+    assert distinct_ids([sh.geometry for sh in scene]) == 1
+    assert distinct_ids([sh.appearance for sh in scene]) == 2
+    assert not factory.setReadProcessEnabled('NoSuchProcess', True)
@@ -0,0 +1,117 @@
+from openalea.plantgl.all import *
+from random import Random
+from math import floor
+
+def random_triangles_scene(nbshapes = 2, nbtriangles = 10):
+    """ Shapes of random triangles in [0.1,3.9]^3, and one triangle going out of [0,4]^3. """
+    rng = Random(3)
+    rpoint = lambda : Vector3(rng.uniform(0.1,3.9),rng.uniform(0.1,3.9),rng.uniform(0.1,3.9))
+    scene = Scene()
+    for s in xrange(nbshapes):
+        points = Point3Array([rpoint() for i in xrange(3*nbtriangles)])
+        indices = Index3Array([Index3(3*i,3*i+1,3*i+2) for i in xrange(nbtriangles)])
+        scene += Shape(TriangleSet(points, indices), Material(), 10+s)
+    outside = TriangleSet(Point3Array([Vector3(3.2,3.3,3.4),Vector3(6,3.3,3.4),Vector3(3.2,6,5)]), Index3Array([Index3(0,1,2)]))
+    scene += Shape(outside, Material(), 10+nbshapes)
+    return scene
+
+def polygon_area(polygon):
+    if len(polygon) < 3: return 0
+    normal = Vector3(0,0,0)
+    for i in xrange(1,len(polygon)-1):
+        normal += cross(polygon[i]-polygon[0], polygon[i+1]-polygon[0])
+    return norm(normal) / 2
+
+def clip_polygon(polygon, axis, value, below):
+    """ Keep the part of polygon below (or above) the plane of coordinate value along axis. """
+    sign = 1 if below else -1
+    result = []
+    for i, a in enumerate(polygon):
+        b = polygon[(i+1) % len(polygon)]
+        da, db = sign * (a[axis] - value), sign * (b[axis] - value)
+        if da <= 0: result.append(a)
+        if (da < 0 and db > 0) or (da > 0 and db < 0):
+            result.append(a + (b-a) * (da / (da - db)))
+    return result
+
+def brute_force_voxel_areas(scene, origin, voxelsize, dimensions):
+    """ Clip each triangle against each voxel box. Returns the area of each voxel and of each (voxel, shape). """
+    areas, shapeareas = {}, {}
+    nx, ny, nz = dimensions
+    for sh in scene:
+        for triangle in sh.geometry.indexList:
+            points = [sh.geometry.pointList[triangle[i]] for i in xrange(3)]
+            # range of the voxels of the box of the triangle
+            ranges = []
+            for axis in xrange(3):
+                coords = [(p[axis] - origin[axis]) / voxelsize[axis] for p in points]
+                ranges.append(xrange(max(0, int(floor(min(coords)))), min(dimensions[axis], int(floor(max(coords))) + 1)))
+            for z in ranges[2]:
+                for y in ranges[1]:
+                    for x in ranges[0]:
+                        polygon = points
+                        for axis, c in enumerate((x, y, z)):
+                            polygon = clip_polygon(polygon, axis, origin[axis] + c * voxelsize[axis], False)
+                            polygon = clip_polygon(polygon, axis, origin[axis] + (c+1) * voxelsize[axis], True)
+                        area = polygon_area(polygon)
+                        if area > 0:
+                            voxel = x + nx * (y + ny * z)
+                            areas[voxel] = areas.get(voxel, 0) + area
+                            shapeareas[(voxel, sh.id)] = shapeareas.get((voxel, sh.id), 0) + area
+    return areas, shapeareas
+
+def test_scenevoxelizer_areas():
+    scene = random_triangles_scene()
+    voxelizer = SceneVoxelizer(Vector3(1,1,1), 3, 4)
+    voxelizer.setBoundingBox(Vector3(0,0,0), Vector3(4,4,4))
+    assert voxelizer.process(scene)
+    assert voxelizer.getDimensions() == (4,4,4)
+    assert voxelizer.getTriangleCount() == 21
+    areas, shapeareas = brute_force_voxel_areas(scene, Vector3(0,0,0), Vector3(1,1,1), (4,4,4))
+    indices = list(voxelizer.getVoxelIndices())
+    assert indices == sorted(indices)
+    assert set(indices) == set([v for v, a in areas.items() if a > 1e-8])
+    offsets, shapeids, vshapeareas = voxelizer.getShapeOffsets(), voxelizer.getShapeIds(), voxelizer.getShapeAreas()
+    histograms = voxelizer.getOrientationHistograms()
+    for i, (voxel, area, density) in enumerate(zip(indices, voxelizer.getAreas(), voxelizer.getAreaDensities())):
+        assert abs(area - areas[voxel]) < 1e-4
+        assert abs(density - area) < 1e-6
+        assert abs(sum(histograms.getRow(i)) - area) < 1e-6
+        for e in xrange(offsets[i], offsets[i+1]):
+            assert abs(vshapeareas[e] - shapeareas[(voxel, shapeids[e])]) < 1e-4
+    # the part of the last triangle outside of the box is ignored
+    inside = sum(areas.values())
+    total = sum([polygon_area([sh.geometry.pointList[triangle[i]] for i in xrange(3)]) for sh in scene for triangle in sh.geometry.indexList])
+    assert inside < total - 1
+    assert abs(sum(voxelizer.getAreas()) - inside) < 1e-4
+
+def test_scenevoxelizer_scene_bounds():
+    scene = random_triangles_scene()
+    voxelizer = SceneVoxelizer(Vector3(0.7,0.7,0.7))
+    assert voxelizer.process(scene)
+    bbox = BoundingBox(scene)
+    origin = voxelizer.getOrigin()
+    assert norm(origin - bbox.lowerLeftCorner) < 1e-5
+    dimensions = voxelizer.getDimensions()
+    assert dimensions == tuple([int((bbox.upperRightCorner[i] - bbox.lowerLeftCorner[i]) / 0.7) + 1 for i in xrange(3)])
+    areas, shapeareas = brute_force_voxel_areas(scene, origin, Vector3(0.7,0.7,0.7), dimensions)
+    for voxel, area in zip(voxelizer.getVoxelIndices(), voxelizer.getAreas()):
+        assert abs(area - areas[voxel]) < 1e-4
+    total = sum([polygon_area([sh.geometry.pointList[triangle[i]] for i in xrange(3)]) for sh in scene for triangle in sh.geometry.indexList])
+    assert abs(sum(voxelizer.getAreas()) - total) < 1e-4
+
+def test_scenevoxelizer_orientations():
+    # a horizontal triangle in the voxel (0,0,0) and a vertical one facing x in the voxel (1,0,0)
+    points = Point3Array([Vector3(0.2,0.2,0.5),Vector3(0.8,0.2,0.5),Vector3(0.2,0.8,0.5),
+                          Vector3(1.5,0.2,0.2),Vector3(1.5,0.8,0.2),Vector3(1.5,0.2,0.8)])
+    scene = Scene([Shape(TriangleSet(points, Index3Array([Index3(0,1,2),Index3(3,4,5)])), Material(), 1)])
+    voxelizer = SceneVoxelizer(Vector3(1,1,1), 3, 4)
+    voxelizer.setBoundingBox(Vector3(0,0,0), Vector3(2,1,1))
+    assert voxelizer.process(scene)
+    assert list(voxelizer.getVoxelIndices()) == [0, 1]
+    histograms = voxelizer.getOrientationHistograms()
+    assert abs(histograms[0,0] - 0.18) < 1e-6 and abs(sum(histograms.getRow(0)) - 0.18) < 1e-6
+    # inclination class 2 and azimuth class 0
+    assert abs(histograms[1,8] - 0.18) < 1e-6 and abs(sum(histograms.getRow(1)) - 0.18) < 1e-6
+    centers = voxelizer.getVoxelCenters()
+    assert norm(centers[0] - Vector3(0.5,0.5,0.5)) < 1e-6 and norm(centers[1] - Vector3(1.5,0.5,0.5)) < 1e-6
@@ -0,0 +1,116 @@
+from openalea.plantgl.all import *
+from random import Random
+
+def noisy_segments(rng, segments, nb, noise = 0.2):
+    """ Points along the segments, starting with the origin of the first one. """
+    points = [segments[0][0]]
+    for i in xrange(nb - 1):
+        a, b = segments[i % len(segments)]
+        points.append(a + (b - a) * rng.uniform(0,1) + Vector3(rng.gauss(0,noise), rng.gauss(0,noise), rng.gauss(0,noise)))
+    return Point3Array(points)
+
+def branching_cloud(rng, nb = 300):
+    """ A trunk with two branches. """
+    return noisy_segments(rng, [(Vector3(0,0,0), Vector3(0,0,10)), (Vector3(0,0,5), Vector3(4,0,9)), (Vector3(0,0,7), Vector3(-3,2,10))], nb)
+
+def disconnected_cloud(rng, nb = 300):
+    """ Three separated pieces of a trunk. """
+    return noisy_segments(rng, [(Vector3(0,0,0), Vector3(0,0,3)), (Vector3(0,0,5), Vector3(0,0,8)), (Vector3(0,1,10), Vector3(3,1,12))], nb, 0.1)
+
+def brute_force_k_closest(points, k, symmetric):
+    n = len(points)
+    adjacencies = [sorted([j for j in xrange(n) if j != i], key = lambda j : normSquared(points[j] - points[i]))[:k] for i in xrange(n)]
+    if symmetric:
+        for i in xrange(n):
+            for j in list(adjacencies[i]):
+                if not i in adjacencies[j]: adjacencies[j].append(i)
+    return adjacencies
+
+def reachable(adjacencies, root):
+    result = set([root])
+    stack = [root]
+    while stack:
+        for j in adjacencies[stack.pop()]:
+            if not j in result:
+                result.add(j)
+                stack.append(j)
+    return result
+
+def brute_force_connect(points, adjacencies):
+    """ Connect iteratively the closest point not reachable from the first point to the reachable ones. """
+    adjacencies = [list(a) for a in adjacencies]
+    connected = reachable(adjacencies, 0)
+    nbconnections = 0
+    while len(connected) < len(points):
+        d, a, b = min([(normSquared(points[a] - points[b]), a, b) for a in connected for b in xrange(len(points)) if not b in connected])
+        adjacencies[a].append(b)
+        adjacencies[b].append(a)
+        connected = reachable(adjacencies, 0)
+        nbconnections += 1
+    return adjacencies, nbconnections
+
+def neighborhoods(points, k, connect):
+    """ The graph of the points as built by k_closest_points_from_ann and connect_all_connex_components. """
+    reference = brute_force_k_closest(points, k, connect)
+    if connect: reference, nbconnections = brute_force_connect(points, reference)
+    if not 'k_closest_points_from_ann' in globals(): return reference
+    adjacencies = k_closest_points_from_ann(points, k, connect)
+    if connect: adjacencies = connect_all_connex_components(points, adjacencies)
+    assert [sorted(a) for a in adjacencies] == [sorted(a) for a in reference]
+    return adjacencies
+
+def python_chain(points, root, binsize, k, connect, averageradius = 0):
+    adjacencies = IndexArray([Index(a) for a in neighborhoods(points, k, connect)])
+    parents, distances = points_dijkstra_shortest_path(points, adjacencies, root)
+    groups = quotient_points_from_adjacency_graph(binsize, points, adjacencies, distances)
+    gadjacencies = quotient_adjacency_graph(adjacencies, groups)
+    nodes = centroids_of_groups(points, groups)
+    gparents, gdistances = points_dijkstra_shortest_path(nodes, gadjacencies, 0)
+    if averageradius <= 0: averageradius = average_radius(points, nodes, gparents)
+    radii = estimate_radii_from_pipemodel(nodes, gparents, carried_length(nodes, gparents), averageradius)
+    return groups, nodes, gparents, radii
+
+def check_pipeline(points, root, binsize, k, connect, averageradius = 0):
+    pipeline = SkeletonPipeline(binsize, k, connect)
+    pipeline.averageRadius = averageradius
+    nodes, parents, radii = pipeline.process(points, root)
+    groups, refnodes, refparents, refradii = python_chain(points, root, binsize, k, connect, averageradius)
+    assert [sorted(g) for g in pipeline.getGroups()] == [sorted(g) for g in groups]
+    assert len(nodes) == len(refnodes)
+    assert all([norm(nodes[i] - refnodes[i]) < 1e-9 for i in xrange(len(nodes))])
+    assert list(parents) == list(refparents)
+    assert all([abs(radii[i] - refradii[i]) <= 1e-9 * refradii[i] for i in xrange(len(radii))])
+    pointgroups = pipeline.getPointGroups()
+    for gid, group in enumerate(groups):
+        assert all([pointgroups[i] == gid for i in group])
+    assert sorted(pipeline.getStageTimes().keys()) == sorted(['neighborhoods', 'connection', 'distances to root', 'quotient',
+                                                             'quotient adjacency', 'centroids', 'spanning tree', 'radii'])
+    return pipeline
+
+def test_pipeline_vs_python_chain():
+    points = branching_cloud(Random(43))
+    for binsize, k in [(0.5, 7), (1, 4)]:
+        check_pipeline(points, 0, binsize, k, True)
+        check_pipeline(points, 0, binsize, k, True, 0.3)
+    pipeline = check_pipeline(points, 17, 1, 7, False)
+    assert pipeline.getPointGroups()[17] == 0
+
+def test_pipeline_disconnected_components():
+    points = disconnected_cloud(Random(44))
+    graph, nbconnections = brute_force_connect(points, brute_force_k_closest(points, 5, True))
+    assert nbconnections >= 2
+    pipeline = check_pipeline(points, 0, 0.5, 5, True)
+    # all the components are connected to the root
+    assert all([g != 4294967295 for g in pipeline.getPointGroups()])
+    # without connection, only the component of the root is grouped
+    pipeline = check_pipeline(points, 0, 0.5, 5, False)
+    grouped = set([i for i, g in enumerate(pipeline.getPointGroups()) if g != 4294967295])
+    assert grouped == reachable(brute_force_k_closest(points, 5, False), 0)
+    assert len(grouped) < len(points)
+
+def test_pipeline_invalid():
+    pipeline = SkeletonPipeline(1)
+    assert pipeline.process(Point3Array(), 0) is None
+    assert pipeline.process(Point3Array([Vector3(0,0,0)]), 1) is None
+    pipeline.binsize = 0
+    assert pipeline.process(Point3Array([Vector3(0,0,0), Vector3(1,0,0)]), 0) is None
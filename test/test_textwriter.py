@@ -0,0 +1,84 @@
+from openalea.plantgl.all import *
+from random import Random
+
+def special_values():
+    return [0., -0., 1., -1., 0.5, 0.1, -0.1, 1./3, 2./3, 2.5, 0.125, 1234.5, 9.5, 0.95, 9.9999995, 99999.95,
+            123456789., 1e15, 1e16, 1e17, 1e22, 1e23, 1e-5, 1e-4, 0.00012345, 0.30000000000000004,
+            5e-324, 2.2250738585072014e-308, 1.7976931348623157e308, float('inf'), float('-inf')]
+
+def random_values(rng, nb = 2000):
+    values = []
+    for i in xrange(nb):
+        # any magnitude, and decimals of a few digits which are close to rounding ties
+        values.append(rng.uniform(-1,1) * 10 ** rng.randint(-30, 30))
+        values.append(rng.randint(1, 10 ** rng.randint(1, 17)) / 10. ** rng.randint(0, 20))
+    return values
+
+def test_format_real():
+    """ The reals are written as printf('%.*g'). """
+    for value in special_values() + random_values(Random(39)):
+        for precision in xrange(1, 18):
+            assert format_real(value, precision) == '%.*g' % (precision, value), (value, precision)
+
+def significant_digits(text):
+    return len(text.split('e')[0].lstrip('-').replace('.','').strip('0'))
+
+def test_format_real_shortest():
+    """ The shortest text reads back and has the fewest digits of the texts that read back. """
+    for value in special_values() + random_values(Random(40)):
+        text = format_real_shortest(value)
+        assert float(text) == value, (value, text)
+        if value == 0 or value - value != 0: continue
+        shortest = min([p for p in xrange(1, 18) if float('%.*g' % (p, value)) == value])
+        assert significant_digits(text) == shortest, (value, text)
+
+def large_mesh(rng, nb = 20000):
+    """ A mesh with more points and triangles than the threshold from which arrays are written in parallel. """
+    points = Point3Array([Vector3(rng.uniform(-1,1), rng.gauss(0,1e3), rng.uniform(0,1e-3) * 10 ** rng.randint(-5,5)) for i in xrange(nb)])
+    indices = Index3Array([Index3(rng.randrange(nb), rng.randrange(nb), rng.randrange(nb)) for i in xrange(nb+1)])
+    return TriangleSet(points, indices)
+
+def geom_field(text, field, values):
+    """ A field of values as written one by one on the stream before the arrays were written in bulk. """
+    line = [l for l in text.split('\n') if l.strip().startswith(field + ' [')][0]
+    indent = line[:len(line) - len(line.lstrip())]
+    return indent + field + ' [ \n' + indent + '    ' + (', \n' + indent + '    ').join(values) + '\n' + indent + ']\n'
+
+def test_geom_large_arrays():
+    mesh = large_mesh(Random(41))
+    mesh.name = 'largemesh'
+    printer = PglStrPrinter()
+    mesh.apply(printer)
+    text = printer.str()
+    assert geom_field(text, 'PointList', ['<%g,%g,%g>' % (p.x, p.y, p.z) for p in mesh.pointList]) in text
+    assert geom_field(text, 'IndexList', ['[%i,%i,%i]' % (i[0], i[1], i[2]) for i in mesh.indexList]) in text
+    # the shortest texts read back exactly
+    printer = PglStrPrinter()
+    printer.arrayPrecision = 0
+    mesh.apply(printer)
+    b = isPglParserVerbose()
+    pglParserVerbose(False)
+    sc, dic = pgl_read(printer.str())
+    pglParserVerbose(b)
+    assert list(dic['largemesh'].pointList) == list(mesh.pointList)
+    assert list(dic['largemesh'].indexList) == list(mesh.indexList)
+
+def test_python_large_arrays():
+    mesh = large_mesh(Random(42))
+    mesh.name = 'largemesh'
+    printer = PyStrPrinter()
+    mesh.apply(printer)
+    code = printer.str()
+    assert 'Point3Array([' + ','.join(['(%g, %g, %g)' % (p.x, p.y, p.z) for p in mesh.pointList]) + '])' in code
+    assert 'Index3Array([' + ','.join(['(%i,%i,%i)' % (i[0], i[1], i[2]) for i in mesh.indexList]) + '])' in code
+    for precision in [0, 10]:
+        printer = PyStrPrinter()
+        printer.arrayPrecision = precision
+        mesh.apply(printer)
+        code = printer.str()
+        if precision > 0:
+            assert 'Point3Array([' + ','.join(['(%.10g, %.10g, %.10g)' % (p.x, p.y, p.z) for p in mesh.pointList]) + '])' in code
+        else:
+            dic = {}
+            exec(code, globals(), dic)
+            assert list(dic['largemesh'].pointList) == list(mesh.pointList)
@@ -15,5 +15,80 @@ def test_turtle_gc_gen():
     p.stopGC()
     assert len(p.getScene()) == 2
 
+def turtle_lists(turtle):
+    params = turtle.getParameters()
+    return list(params.pointList), list(params.leftList), list(params.radiusList)
+
+def test_turtle_gc_branch_keeps_parent():
+    """ A branch drawn inside a generalized cylinder does not modify the points of its parent """
+    p = PglTurtle()
+    p.startGC()
+    p.setWidth(0.5)
+    p.F(1)
+    p.left(30)
+    p.F(1)
+    before = turtle_lists(p)
+    assert len(before[0]) == len(before[1]) == len(before[2]) == 3
+    p.push()
+    p.left(40)
+    p.setWidth(0.2)
+    p.F(1)
+    p.F(1)
+    p.push()
+    p.F(1)
+    p.pop()
+    # the branch starts at the last point of its parent
+    points, lefts, radii = turtle_lists(p)
+    assert len(points) == 3 and points[0] == before[0][-1]
+    assert radii == [0.2, 0.2, 0.2]
+    p.pop()
+    assert turtle_lists(p) == before
+    p.F(1)
+    points, lefts, radii = turtle_lists(p)
+    assert points[:3] == before[0] and lefts[:3] == before[1] and radii == [0.5]*4
+    p.stopGC()
+    assert len(p.getScene()) == 3
+
+def test_turtle_polygon_branch_keeps_gc_parent():
+    """ A polygon drawn in a branch of a generalized cylinder does not modify its points """
+    p = PglTurtle()
+    p.startGC()
+    p.setWidth(0.5)
+    p.F(1)
+    p.F(1)
+    before = turtle_lists(p)
+    p.push()
+    p.left(90)
+    p.startPolygon()
+    p.F(1)
+    p.left(90)
+    p.F(1)
+    p.left(90)
+    p.F(1)
+    p.stopPolygon()
+    p.pop()
+    assert turtle_lists(p) == before
+    p.stopGC()
+    assert len(p.getScene()) == 2
+
+def test_turtle_polygon_branch_shares_points():
+    """ The points of a polygon are shared with its branches, as before copy on write """
+    p = PglTurtle()
+    p.startPolygon()
+    p.F(1)
+    p.left(90)
+    p.F(1)
+    before = turtle_lists(p)[0]
+    p.push()
+    p.left(45)
+    p.F(1)
+    branchpoints = turtle_lists(p)[0]
+    p.pop()
+    assert turtle_lists(p)[0] == branchpoints
+    assert branchpoints[:len(before)] == before and len(branchpoints) == len(before) + 1
+
 if __name__ == '__main__':
     test_turtle_gc_gen()
+    test_turtle_gc_branch_keeps_parent()
+    test_turtle_polygon_branch_keeps_gc_parent()
+    test_turtle_polygon_branch_shares_points()
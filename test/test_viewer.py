@@ -33,6 +33,22 @@ def test_update():
     s[0].geometry = Box()
     Viewer.update()
 
+def test_display_modified_in_place():
+    """ A geometry modified in place is rebuilt when its scene is displayed again """
+    sphere = Sphere(1, 16, 16)
+    scene = Scene([Shape(sphere, Material())])
+    Viewer.display(scene)
+    distance = norm(Viewer.camera.getPosition()[0])
+    Viewer.camera.lookAt(Vector3(0,-10,0), Vector3(0,0,0))
+    size = Viewer.getProjectionSize()[0]
+    sphere.radius = 2
+    Viewer.display(scene)
+    # the camera is fitted to the new bounding box
+    assert abs(norm(Viewer.camera.getPosition()[0]) - 2 * distance) < 0.05 * distance, "Bounding box of a modified geometry not updated"
+    # and the new tesselation is rendered
+    Viewer.camera.lookAt(Vector3(0,-10,0), Vector3(0,0,0))
+    assert Viewer.getProjectionSize()[0] > 3 * size, "Tesselation of a modified geometry not updated"
+
 def test_selection():
     Viewer.display(Scene([Shape(Sphere(),Material(),1),Shape(Box(),Material(),2)]))
     assert len(Viewer.selection) == 0, "Invalid Viewer.selection"
@@ -162,6 +178,7 @@ if __name__=='__main__':
         test_display()
         test_add()
         test_update()
+        test_display_modified_in_place()
         test_selection()
         test_scene_interaction()
         test_camera_lookat()